@@ -586,6 +586,17 @@ FLINT_DLL void fmpq_mpoly_add(fmpq_mpoly_t A, const fmpq_mpoly_t B,
 FLINT_DLL void fmpq_mpoly_sub(fmpq_mpoly_t A, const fmpq_mpoly_t B,
                              const fmpq_mpoly_t C, const fmpq_mpoly_ctx_t ctx);
 
+FLINT_DLL void fmpq_mpoly_sum(fmpq_mpoly_t A, fmpq_mpoly_struct * const * B,
+                                         slong n, const fmpq_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpq_mpoly_sum_threaded(fmpq_mpoly_t A,
+                                 fmpq_mpoly_struct * const * B, slong n,
+                                const fmpq_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void _fmpq_mpoly_sum_threaded(fmpq_mpoly_t A,
+           fmpq_mpoly_struct * const * B, slong n, const fmpq_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 
 /* Scalar operations *********************************************************/
 
@@ -664,6 +675,16 @@ FLINT_DLL void fmpq_mpoly_compose_fmpq_mpoly(fmpq_mpoly_t A,
 FLINT_DLL void fmpq_mpoly_mul(fmpq_mpoly_t A, const fmpq_mpoly_t B,
                              const fmpq_mpoly_t C, const fmpq_mpoly_ctx_t ctx);
 
+FLINT_DLL void fmpq_mpoly_mul_threaded(fmpq_mpoly_t A, const fmpq_mpoly_t B,
+       const fmpq_mpoly_t C, const fmpq_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void fmpq_mpoly_product(fmpq_mpoly_t A,
+      fmpq_mpoly_struct * const * B, slong n, const fmpq_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpq_mpoly_product_threaded(fmpq_mpoly_t A,
+                                 fmpq_mpoly_struct * const * B, slong n,
+                                const fmpq_mpoly_ctx_t ctx, slong thread_limit);
+
 /* Powering ******************************************************************/
 
 FLINT_DLL void fmpq_mpoly_pow_fmpz(fmpq_mpoly_t A, const fmpq_mpoly_t B,
@@ -678,6 +699,10 @@ FLINT_DLL int fmpq_mpoly_divides(fmpq_mpoly_t poly1,
                   const fmpq_mpoly_t poly2, const fmpq_mpoly_t poly3,
                                                    const fmpq_mpoly_ctx_t ctx);
 
+FLINT_DLL int fmpq_mpoly_divides_threaded(fmpq_mpoly_t poly1,
+                  const fmpq_mpoly_t poly2, const fmpq_mpoly_t poly3,
+                              const fmpq_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void fmpq_mpoly_div(fmpq_mpoly_t q,
                      const fmpq_mpoly_t poly2, const fmpq_mpoly_t poly3,
                                                    const fmpq_mpoly_ctx_t ctx);
@@ -705,6 +730,9 @@ FLINT_DLL void fmpq_mpoly_term_content(fmpq_mpoly_t M, const fmpq_mpoly_t A,
 FLINT_DLL int fmpq_mpoly_gcd(fmpq_mpoly_t G, const fmpq_mpoly_t A,
                              const fmpq_mpoly_t B, const fmpq_mpoly_ctx_t ctx);
 
+FLINT_DLL int fmpq_mpoly_gcd_threaded(fmpq_mpoly_t G, const fmpq_mpoly_t A,
+       const fmpq_mpoly_t B, const fmpq_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void fmpq_mpoly_inflate(fmpq_mpoly_t A, const fmpq_mpoly_t B,
           const fmpz * shift, const fmpz * stride, const fmpq_mpoly_ctx_t ctx);
 
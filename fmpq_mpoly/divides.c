@@ -13,15 +13,15 @@
 
 
 /* return 1 if quotient is exact */
-int fmpq_mpoly_divides(fmpq_mpoly_t Q,
+int fmpq_mpoly_divides_threaded(fmpq_mpoly_t Q,
                   const fmpq_mpoly_t A, const fmpq_mpoly_t B,
-                                                    const fmpq_mpoly_ctx_t ctx)
+                              const fmpq_mpoly_ctx_t ctx, slong thread_limit)
 {
     int res;
 
     if (fmpq_mpoly_is_zero(B, ctx))
     {
-        flint_throw(FLINT_DIVZERO, "Divide by zero in fmpq_mpoly_divides");
+        flint_throw(FLINT_DIVZERO, "Divide by zero in fmpq_mpoly_divides_threaded");
     }
 
     if (fmpq_mpoly_is_zero(A, ctx))
@@ -30,7 +30,8 @@ int fmpq_mpoly_divides(fmpq_mpoly_t Q,
         return 1;
     }
 
-    res = fmpz_mpoly_divides(Q->zpoly, A->zpoly, B->zpoly, ctx->zctx);
+    res = fmpz_mpoly_divides_threaded(Q->zpoly, A->zpoly, B->zpoly, ctx->zctx,
+                                                                thread_limit);
     if (!res)
     {
         fmpq_mpoly_zero(Q, ctx);
@@ -40,3 +41,11 @@ int fmpq_mpoly_divides(fmpq_mpoly_t Q,
     fmpq_div(Q->content, A->content, B->content);
     return 1;
 }
+
+int fmpq_mpoly_divides(fmpq_mpoly_t Q,
+                  const fmpq_mpoly_t A, const fmpq_mpoly_t B,
+                                                    const fmpq_mpoly_ctx_t ctx)
+{
+    return fmpq_mpoly_divides_threaded(Q, A, B, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+}
@@ -12,8 +12,9 @@
 #include "fmpq_mpoly.h"
 
 
-int fmpq_mpoly_gcd(fmpq_mpoly_t G, const fmpq_mpoly_t A,
-                          const fmpq_mpoly_t B, const fmpq_mpoly_ctx_t ctx)
+int fmpq_mpoly_gcd_threaded(fmpq_mpoly_t G, const fmpq_mpoly_t A,
+                          const fmpq_mpoly_t B, const fmpq_mpoly_ctx_t ctx,
+                                                          slong thread_limit)
 {
     int success;
 
@@ -23,7 +24,8 @@ int fmpq_mpoly_gcd(fmpq_mpoly_t G, const fmpq_mpoly_t A,
         return 1;
     }
 
-    success = fmpz_mpoly_gcd(G->zpoly, A->zpoly, B->zpoly, ctx->zctx);
+    success = fmpz_mpoly_gcd_threaded(G->zpoly, A->zpoly, B->zpoly,
+                                                    ctx->zctx, thread_limit);
     if (success)
     {
         _fmpq_mpoly_make_monic_inplace(G, ctx);
@@ -31,3 +33,9 @@ int fmpq_mpoly_gcd(fmpq_mpoly_t G, const fmpq_mpoly_t A,
 
     return success;
 }
+
+int fmpq_mpoly_gcd(fmpq_mpoly_t G, const fmpq_mpoly_t A,
+                          const fmpq_mpoly_t B, const fmpq_mpoly_ctx_t ctx)
+{
+    return fmpq_mpoly_gcd_threaded(G, A, B, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+}
@@ -12,8 +12,9 @@
 #include "fmpq_mpoly.h"
 
 
-void fmpq_mpoly_mul(fmpq_mpoly_t A, const fmpq_mpoly_t B,
-                              const fmpq_mpoly_t C, const fmpq_mpoly_ctx_t ctx)
+void fmpq_mpoly_mul_threaded(fmpq_mpoly_t A, const fmpq_mpoly_t B,
+                              const fmpq_mpoly_t C, const fmpq_mpoly_ctx_t ctx,
+                                                          slong thread_limit)
 {
     if (fmpq_mpoly_is_zero(B, ctx) || fmpq_mpoly_is_zero(C, ctx))
     {
@@ -22,5 +23,12 @@ void fmpq_mpoly_mul(fmpq_mpoly_t A, const fmpq_mpoly_t B,
     }
 
     fmpq_mul(A->content, B->content, C->content);
-    fmpz_mpoly_mul(A->zpoly, B->zpoly, C->zpoly, ctx->zctx);
+    fmpz_mpoly_mul_threaded(A->zpoly, B->zpoly, C->zpoly, ctx->zctx,
+                                                                thread_limit);
+}
+
+void fmpq_mpoly_mul(fmpq_mpoly_t A, const fmpq_mpoly_t B,
+                              const fmpq_mpoly_t C, const fmpq_mpoly_ctx_t ctx)
+{
+    fmpq_mpoly_mul_threaded(A, B, C, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
 }
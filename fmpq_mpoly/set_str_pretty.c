@@ -292,7 +292,18 @@ int fmpq_mpoly_set_str_pretty(fmpq_mpoly_t A, const char * str,
             flint_sprintf(x[i], "x%wd", i + 1);
         }
     }
-    ret = _fmpq_mpoly_parse_pretty(A, str, strlen(str), x, ctx);
+    if (strchr(str, '/') == NULL)
+    {
+        /* integer input: use the integer parser and its fast paths */
+        ret = _fmpz_mpoly_set_str_pretty(A->zpoly, str, strlen(str), x,
+                                                                   ctx->zctx);
+        fmpq_one(A->content);
+        fmpq_mpoly_reduce(A, ctx);
+    }
+    else
+    {
+        ret = _fmpq_mpoly_parse_pretty(A, str, strlen(str), x, ctx);
+    }
     TMP_END;
     return ret;
 }
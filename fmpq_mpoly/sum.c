@@ -0,0 +1,149 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "fmpq_mpoly.h"
+
+/* A = sum of B[i] for 0 <= i < n, A may alias any B[i] */
+static void _sum_geobucket(fmpq_mpoly_t A, fmpq_mpoly_struct * const * B,
+                                          slong n, const fmpq_mpoly_ctx_t ctx)
+{
+    slong i;
+    fmpq_mpoly_geobucket_t G;
+
+    fmpq_mpoly_geobucket_init(G, ctx);
+    for (i = 0; i < n; i++)
+        fmpq_mpoly_geobucket_add(G, B[i], ctx);
+    fmpq_mpoly_geobucket_empty(A, G, ctx);
+    fmpq_mpoly_geobucket_clear(G, ctx);
+}
+
+void fmpq_mpoly_sum(fmpq_mpoly_t A, fmpq_mpoly_struct * const * B, slong n,
+                                                    const fmpq_mpoly_ctx_t ctx)
+{
+    if (n < 3)
+    {
+        if (n == 2)
+            fmpq_mpoly_add(A, B[0], B[1], ctx);
+        else if (n == 1)
+            fmpq_mpoly_set(A, B[0], ctx);
+        else
+            fmpq_mpoly_zero(A, ctx);
+        return;
+    }
+
+    _sum_geobucket(A, B, n, ctx);
+}
+
+typedef struct
+{
+    fmpq_mpoly_struct S[1];
+    fmpq_mpoly_struct * const * B;
+    slong n;
+    const fmpq_mpoly_ctx_struct * ctx;
+}
+_sum_arg_struct;
+
+static void _sum_worker(void * varg)
+{
+    _sum_arg_struct * arg = (_sum_arg_struct *) varg;
+    _sum_geobucket(arg->S, arg->B, arg->n, arg->ctx);
+}
+
+/*
+    The inputs are split into one contiguous range per thread, each range is
+    summed in a geobucket by its thread, and the partial sums are added.
+*/
+void _fmpq_mpoly_sum_threaded(fmpq_mpoly_t A, fmpq_mpoly_struct * const * B,
+                                          slong n, const fmpq_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, start, stop, num_workers;
+    _sum_arg_struct * args;
+    fmpq_mpoly_struct ** partial;
+
+    num_workers = FLINT_MIN(num_handles + 1, n/2);
+    if (num_workers < 2)
+    {
+        fmpq_mpoly_sum(A, B, n, ctx);
+        return;
+    }
+
+    args = (_sum_arg_struct *) flint_malloc(num_workers
+                                                     *sizeof(_sum_arg_struct));
+    partial = (fmpq_mpoly_struct **) flint_malloc(num_workers
+                                                 *sizeof(fmpq_mpoly_struct *));
+    start = 0;
+    for (i = 0; i < num_workers; i++)
+    {
+        stop = n*(i + 1)/num_workers;
+        fmpq_mpoly_init(args[i].S, ctx);
+        args[i].B = B + start;
+        args[i].n = stop - start;
+        args[i].ctx = ctx;
+        partial[i] = args[i].S;
+        start = stop;
+    }
+
+    for (i = 0; i + 1 < num_workers; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                      _sum_worker, &args[i]);
+    }
+    _sum_worker(&args[num_workers - 1]);
+    for (i = 0; i + 1 < num_workers; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    fmpq_mpoly_sum(A, partial, num_workers, ctx);
+
+    for (i = 0; i < num_workers; i++)
+        fmpq_mpoly_clear(args[i].S, ctx);
+
+    flint_free(partial);
+    flint_free(args);
+}
+
+void fmpq_mpoly_sum_threaded(fmpq_mpoly_t A, fmpq_mpoly_struct * const * B,
+                       slong n, const fmpq_mpoly_ctx_t ctx, slong thread_limit)
+{
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    handles = NULL;
+    num_handles = 0;
+    if (thread_limit > 1 && global_thread_pool_initialized && n > 3)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _fmpq_mpoly_sum_threaded(A, B, n, ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
@@ -76,6 +76,60 @@ main(void)
         fmpq_mpoly_ctx_clear(ctx);
     }
 
+    /* Check f*g/g = f using the threaded version */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpq_mpoly_ctx_t ctx;
+        fmpq_mpoly_t f, g, h, k;
+        slong len1, len2;
+        flint_bitcnt_t coeff_bits, exp_bits1, exp_bits2;
+
+        fmpq_mpoly_ctx_init_rand(ctx, state, 20);
+
+        fmpq_mpoly_init(f, ctx);
+        fmpq_mpoly_init(g, ctx);
+        fmpq_mpoly_init(h, ctx);
+        fmpq_mpoly_init(k, ctx);
+
+        len1 = n_randint(state, 50);
+        len2 = n_randint(state, 50) + 1;
+
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        coeff_bits = n_randint(state, 200);
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpq_mpoly_randtest_bits(f, state, len1, coeff_bits, exp_bits1, ctx);
+            do {
+                fmpq_mpoly_randtest_bits(g, state, len2, coeff_bits + 1, exp_bits2, ctx);
+            } while (fmpq_mpoly_is_zero(g, ctx));
+
+            flint_set_num_threads(n_randint(state, 5) + 1);
+
+            fmpq_mpoly_mul(h, f, g, ctx);
+            fmpq_mpoly_assert_canonical(h, ctx);
+            ok1 = fmpq_mpoly_divides_threaded(k, h, g, ctx,
+                                                      n_randint(state, 5) + 1);
+            fmpq_mpoly_assert_canonical(k, ctx);
+            result = (ok1 && fmpq_mpoly_equal(f, k, ctx));
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f using the threaded version\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fmpq_mpoly_clear(f, ctx);
+        fmpq_mpoly_clear(g, ctx);
+        fmpq_mpoly_clear(h, ctx);
+        fmpq_mpoly_clear(k, ctx);
+        fmpq_mpoly_ctx_clear(ctx);
+    }
+
     /* Check random polys don't divide */
     for (i = 0; i < 10 * flint_test_multiplier(); i++)
     {
@@ -123,6 +123,69 @@ main(void)
         fmpq_clear(lc);
     }
 
+    /* Check gcd_threaded matches gcd */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpq_mpoly_ctx_t ctx;
+        fmpq_mpoly_t a, b, g1, g2, t;
+        slong len, len1, len2;
+        slong degbound;
+        slong coeff_bits;
+        int res1, res2;
+
+        fmpq_mpoly_ctx_init_rand(ctx, state, 5);
+
+        fmpq_mpoly_init(g1, ctx);
+        fmpq_mpoly_init(g2, ctx);
+        fmpq_mpoly_init(a, ctx);
+        fmpq_mpoly_init(b, ctx);
+        fmpq_mpoly_init(t, ctx);
+
+        len = n_randint(state, 20) + 1;
+        len1 = n_randint(state, 30);
+        len2 = n_randint(state, 30);
+
+        degbound = 20/(1 + ctx->zctx->minfo->nvars);
+
+        coeff_bits = n_randint(state, 20);
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpq_mpoly_randtest_bound(t, state, len, coeff_bits + 1, degbound, ctx);
+            fmpq_mpoly_randtest_bound(a, state, len1, coeff_bits, degbound, ctx);
+            fmpq_mpoly_randtest_bound(b, state, len2, coeff_bits, degbound, ctx);
+
+            fmpq_mpoly_mul(a, a, t, ctx);
+            fmpq_mpoly_mul(b, b, t, ctx);
+
+            flint_set_num_threads(n_randint(state, 5) + 1);
+
+            res1 = fmpq_mpoly_gcd(g1, a, b, ctx);
+            res2 = fmpq_mpoly_gcd_threaded(g2, a, b, ctx,
+                                                      n_randint(state, 5) + 1);
+            if (!res1 || !res2)
+            {
+                continue;
+            }
+
+            fmpq_mpoly_assert_canonical(g2, ctx);
+
+            if (!fmpq_mpoly_equal(g1, g2, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check gcd_threaded matches gcd\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fmpq_mpoly_clear(g1, ctx);
+        fmpq_mpoly_clear(g2, ctx);
+        fmpq_mpoly_clear(a, ctx);
+        fmpq_mpoly_clear(b, ctx);
+        fmpq_mpoly_clear(t, ctx);
+        fmpq_mpoly_ctx_clear(ctx);
+    }
+
 
     printf("PASS\n");
     FLINT_TEST_CLEANUP(state);
@@ -88,6 +88,57 @@ main(void)
         fmpq_mpoly_ctx_clear(ctx);
     }
 
+    /* Check mul_threaded matches mul */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpq_mpoly_ctx_t ctx;
+        fmpq_mpoly_t f, g, h1, h2;
+        slong len1, len2;
+        flint_bitcnt_t coeff_bits, exp_bits1, exp_bits2;
+
+        fmpq_mpoly_ctx_init_rand(ctx, state, 20);
+
+        fmpq_mpoly_init(f, ctx);
+        fmpq_mpoly_init(g, ctx);
+        fmpq_mpoly_init(h1, ctx);
+        fmpq_mpoly_init(h2, ctx);
+
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        coeff_bits = n_randint(state, 200);
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpq_mpoly_randtest_bits(f, state, len1, coeff_bits, exp_bits1, ctx);
+            fmpq_mpoly_randtest_bits(g, state, len2, coeff_bits, exp_bits2, ctx);
+
+            flint_set_num_threads(n_randint(state, 5) + 1);
+
+            fmpq_mpoly_mul(h1, f, g, ctx);
+            fmpq_mpoly_assert_canonical(h1, ctx);
+            fmpq_mpoly_mul_threaded(h2, f, g, ctx, n_randint(state, 5) + 1);
+            fmpq_mpoly_assert_canonical(h2, ctx);
+            result = fmpq_mpoly_equal(h1, h2, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check mul_threaded matches mul\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fmpq_mpoly_clear(f, ctx);
+        fmpq_mpoly_clear(g, ctx);
+        fmpq_mpoly_clear(h1, ctx);
+        fmpq_mpoly_clear(h2, ctx);
+        fmpq_mpoly_ctx_clear(ctx);
+    }
+
     /* Check aliasing first argument */
     for (i = 0; i < 10 * flint_test_multiplier(); i++)
     {
@@ -0,0 +1,146 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpq_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, k, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("sum_product....");
+    fflush(stdout);
+
+    /* Check against repeated addition and multiplication */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpq_mpoly_ctx_t ctx;
+        fmpq_mpoly_struct * B, ** Bptr;
+        fmpq_mpoly_t f, g;
+        slong n, m, len, nvars;
+        ulong exp_bound;
+        flint_bitcnt_t coeff_bits;
+
+        fmpq_mpoly_ctx_init_rand(ctx, state, 5);
+        nvars = ctx->zctx->minfo->nvars;
+
+        fmpq_mpoly_init(f, ctx);
+        fmpq_mpoly_init(g, ctx);
+
+        n = n_randint(state, 40);
+        B = (fmpq_mpoly_struct *) flint_malloc((n + 1)
+                                                   *sizeof(fmpq_mpoly_struct));
+        Bptr = (fmpq_mpoly_struct **) flint_malloc((n + 1)
+                                                 *sizeof(fmpq_mpoly_struct *));
+        for (k = 0; k < n + 1; k++)
+        {
+            fmpq_mpoly_init(B + k, ctx);
+            Bptr[k] = B + k;
+        }
+
+        for (j = 0; j < 4; j++)
+        {
+            len = n_randint(state, 5) + 1;
+            exp_bound = n_randint(state, 2 + 4/nvars) + 1;
+            coeff_bits = n_randint(state, 50);
+
+            for (k = 0; k < n; k++)
+                fmpq_mpoly_randtest_bound(B + k, state, len, coeff_bits,
+                                                              exp_bound, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpq_mpoly_zero(f, ctx);
+            for (k = 0; k < n; k++)
+                fmpq_mpoly_add(f, f, B + k, ctx);
+
+            fmpq_mpoly_sum(g, Bptr, n, ctx);
+            fmpq_mpoly_assert_canonical(g, ctx);
+            if (!fmpq_mpoly_equal(f, g, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check sum\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            fmpq_mpoly_sum_threaded(g, Bptr, n, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpq_mpoly_assert_canonical(g, ctx);
+            if (!fmpq_mpoly_equal(f, g, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check sum_threaded\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* the output may be one of the inputs */
+            k = n_randint(state, n + 1);
+            fmpq_mpoly_sum_threaded(B + k, Bptr, n, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpq_mpoly_assert_canonical(B + k, ctx);
+            if (!fmpq_mpoly_equal(f, B + k, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check sum aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            for (k = 0; k < n; k++)
+                fmpq_mpoly_randtest_bound(B + k, state, len, coeff_bits,
+                                                              exp_bound, ctx);
+            /* keep the products small */
+            m = FLINT_MIN(n, 10);
+
+            fmpq_mpoly_one(f, ctx);
+            for (k = 0; k < m; k++)
+                fmpq_mpoly_mul(f, f, B + k, ctx);
+
+            fmpq_mpoly_product(g, Bptr, m, ctx);
+            fmpq_mpoly_assert_canonical(g, ctx);
+            if (!fmpq_mpoly_equal(f, g, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check product\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            k = n_randint(state, m + 1);
+            fmpq_mpoly_product_threaded(B + k, Bptr, m, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpq_mpoly_assert_canonical(B + k, ctx);
+            if (!fmpq_mpoly_equal(f, B + k, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check product aliasing\ni = %wd, j = %wd\n",
+                                                                         i, j);
+                flint_abort();
+            }
+        }
+
+        for (k = 0; k < n + 1; k++)
+            fmpq_mpoly_clear(B + k, ctx);
+        flint_free(B);
+        flint_free(Bptr);
+
+        fmpq_mpoly_clear(f, ctx);
+        fmpq_mpoly_clear(g, ctx);
+        fmpq_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,252 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#ifndef FMPZ_MOD_MAT_H
+#define FMPZ_MOD_MAT_H
+
+#ifdef FMPZ_MOD_MAT_INLINES_C
+#define FMPZ_MOD_MAT_INLINE FLINT_DLL
+#else
+#define FMPZ_MOD_MAT_INLINE static __inline__
+#endif
+
+#undef ulong
+#define ulong ulongxx /* interferes with system includes */
+#include <stdlib.h>
+#undef ulong
+#include <gmp.h>
+#define ulong mp_limb_t
+
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_mat.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+    Matrices over Z/nZ for multiprecision n. The entries are stored as an
+    fmpz_mat with every entry reduced to [0, n).
+*/
+typedef struct
+{
+    fmpz_mat_t mat;
+    fmpz_t mod;
+}
+fmpz_mod_mat_struct;
+
+typedef fmpz_mod_mat_struct fmpz_mod_mat_t[1];
+
+#define fmpz_mod_mat_entry(M, i, j) fmpz_mat_entry((M)->mat, i, j)
+
+FMPZ_MOD_MAT_INLINE
+slong fmpz_mod_mat_nrows(const fmpz_mod_mat_t mat)
+{
+    return fmpz_mat_nrows(mat->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+slong fmpz_mod_mat_ncols(const fmpz_mod_mat_t mat)
+{
+    return fmpz_mat_ncols(mat->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+const fmpz * fmpz_mod_mat_modulus(const fmpz_mod_mat_t mat)
+{
+    return mat->mod;
+}
+
+FMPZ_MOD_MAT_INLINE
+void fmpz_mod_mat_get_entry(fmpz_t x, const fmpz_mod_mat_t mat,
+                                                             slong i, slong j)
+{
+    fmpz_set(x, fmpz_mod_mat_entry(mat, i, j));
+}
+
+FMPZ_MOD_MAT_INLINE
+void fmpz_mod_mat_set_entry(fmpz_mod_mat_t mat, slong i, slong j,
+                                                               const fmpz_t x)
+{
+    fmpz_mod(fmpz_mod_mat_entry(mat, i, j), x, mat->mod);
+}
+
+/* Memory management */
+
+FLINT_DLL void fmpz_mod_mat_init(fmpz_mod_mat_t mat, slong rows, slong cols,
+                                                               const fmpz_t n);
+
+FLINT_DLL void fmpz_mod_mat_init_set(fmpz_mod_mat_t mat,
+                                                   const fmpz_mod_mat_t src);
+
+FLINT_DLL void fmpz_mod_mat_clear(fmpz_mod_mat_t mat);
+
+FMPZ_MOD_MAT_INLINE
+void fmpz_mod_mat_swap(fmpz_mod_mat_t mat1, fmpz_mod_mat_t mat2)
+{
+    if (mat1 != mat2)
+    {
+        fmpz_mod_mat_struct t = *mat1;
+        *mat1 = *mat2;
+        *mat2 = t;
+    }
+}
+
+FLINT_DLL void fmpz_mod_mat_window_init(fmpz_mod_mat_t window,
+      const fmpz_mod_mat_t mat, slong r1, slong c1, slong r2, slong c2);
+
+FLINT_DLL void fmpz_mod_mat_window_clear(fmpz_mod_mat_t window);
+
+/* Basic manipulation */
+
+FLINT_DLL void _fmpz_mod_mat_reduce(fmpz_mod_mat_t mat);
+
+FLINT_DLL void fmpz_mod_mat_set(fmpz_mod_mat_t B, const fmpz_mod_mat_t A);
+
+FLINT_DLL void fmpz_mod_mat_set_fmpz_mat(fmpz_mod_mat_t A,
+                                                        const fmpz_mat_t B);
+
+FMPZ_MOD_MAT_INLINE
+void fmpz_mod_mat_get_fmpz_mat(fmpz_mat_t B, const fmpz_mod_mat_t A)
+{
+    fmpz_mat_set(B, A->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+void fmpz_mod_mat_zero(fmpz_mod_mat_t mat)
+{
+    fmpz_mat_zero(mat->mat);
+}
+
+FLINT_DLL void fmpz_mod_mat_one(fmpz_mod_mat_t mat);
+
+FMPZ_MOD_MAT_INLINE
+int fmpz_mod_mat_is_zero(const fmpz_mod_mat_t mat)
+{
+    return fmpz_mat_is_zero(mat->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+int fmpz_mod_mat_is_empty(const fmpz_mod_mat_t mat)
+{
+    return fmpz_mat_is_empty(mat->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+int fmpz_mod_mat_is_square(const fmpz_mod_mat_t mat)
+{
+    return fmpz_mat_is_square(mat->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+int fmpz_mod_mat_equal(const fmpz_mod_mat_t mat1, const fmpz_mod_mat_t mat2)
+{
+    return fmpz_equal(mat1->mod, mat2->mod) &&
+                                             fmpz_mat_equal(mat1->mat, mat2->mat);
+}
+
+FMPZ_MOD_MAT_INLINE
+void fmpz_mod_mat_transpose(fmpz_mod_mat_t B, const fmpz_mod_mat_t A)
+{
+    fmpz_mat_transpose(B->mat, A->mat);
+}
+
+/* Random generation */
+
+FLINT_DLL void fmpz_mod_mat_randtest(fmpz_mod_mat_t mat, flint_rand_t state);
+
+/* Input and output */
+
+FLINT_DLL void fmpz_mod_mat_print_pretty(const fmpz_mod_mat_t mat);
+
+/* Arithmetic */
+
+FLINT_DLL void fmpz_mod_mat_add(fmpz_mod_mat_t C, const fmpz_mod_mat_t A,
+                                                     const fmpz_mod_mat_t B);
+
+FLINT_DLL void fmpz_mod_mat_sub(fmpz_mod_mat_t C, const fmpz_mod_mat_t A,
+                                                     const fmpz_mod_mat_t B);
+
+FLINT_DLL void fmpz_mod_mat_neg(fmpz_mod_mat_t B, const fmpz_mod_mat_t A);
+
+FLINT_DLL void fmpz_mod_mat_scalar_mul_fmpz(fmpz_mod_mat_t B,
+                                     const fmpz_mod_mat_t A, const fmpz_t c);
+
+FLINT_DLL void fmpz_mod_mat_mul(fmpz_mod_mat_t C, const fmpz_mod_mat_t A,
+                                                     const fmpz_mod_mat_t B);
+
+FLINT_DLL void fmpz_mod_mat_mul_strassen(fmpz_mod_mat_t C,
+                            const fmpz_mod_mat_t A, const fmpz_mod_mat_t B);
+
+FLINT_DLL void fmpz_mod_mat_submul(fmpz_mod_mat_t D, const fmpz_mod_mat_t C,
+                            const fmpz_mod_mat_t A, const fmpz_mod_mat_t B);
+
+/* LU decomposition */
+
+FLINT_DLL slong fmpz_mod_mat_lu_classical(slong * P, fmpz_mod_mat_t A,
+                                                              int rank_check);
+
+FLINT_DLL slong fmpz_mod_mat_lu_recursive(slong * P, fmpz_mod_mat_t A,
+                                                              int rank_check);
+
+FLINT_DLL slong fmpz_mod_mat_lu(slong * P, fmpz_mod_mat_t A, int rank_check);
+
+/* Triangular solving */
+
+FLINT_DLL void fmpz_mod_mat_solve_tril_classical(fmpz_mod_mat_t X,
+            const fmpz_mod_mat_t L, const fmpz_mod_mat_t B, int unit);
+
+FLINT_DLL void fmpz_mod_mat_solve_tril_recursive(fmpz_mod_mat_t X,
+            const fmpz_mod_mat_t L, const fmpz_mod_mat_t B, int unit);
+
+FLINT_DLL void fmpz_mod_mat_solve_tril(fmpz_mod_mat_t X,
+            const fmpz_mod_mat_t L, const fmpz_mod_mat_t B, int unit);
+
+FLINT_DLL void fmpz_mod_mat_solve_triu_classical(fmpz_mod_mat_t X,
+            const fmpz_mod_mat_t U, const fmpz_mod_mat_t B, int unit);
+
+FLINT_DLL void fmpz_mod_mat_solve_triu_recursive(fmpz_mod_mat_t X,
+            const fmpz_mod_mat_t U, const fmpz_mod_mat_t B, int unit);
+
+FLINT_DLL void fmpz_mod_mat_solve_triu(fmpz_mod_mat_t X,
+            const fmpz_mod_mat_t U, const fmpz_mod_mat_t B, int unit);
+
+/* Solving, inverse and row echelon form */
+
+FLINT_DLL int fmpz_mod_mat_solve(fmpz_mod_mat_t X, const fmpz_mod_mat_t A,
+                                                     const fmpz_mod_mat_t B);
+
+FLINT_DLL int fmpz_mod_mat_inv(fmpz_mod_mat_t B, const fmpz_mod_mat_t A);
+
+FLINT_DLL slong fmpz_mod_mat_rref(fmpz_mod_mat_t A);
+
+FLINT_DLL slong fmpz_mod_mat_rank(const fmpz_mod_mat_t A);
+
+/* Tuning parameters *********************************************************/
+
+/* Size above which fmpz_mod_mat_mul uses multimodular multiplication */
+#define FMPZ_MOD_MAT_MUL_MULTI_MOD_CUTOFF 10
+
+/* Size below which fmpz_mod_mat_mul_strassen uses fmpz_mod_mat_mul */
+#define FMPZ_MOD_MAT_MUL_STRASSEN_CUTOFF 16
+
+/* Size below which fmpz_mod_mat_lu uses classical elimination */
+#define FMPZ_MOD_MAT_LU_RECURSIVE_CUTOFF 4
+
+/* Sizes below which triangular solving is done classically */
+#define FMPZ_MOD_MAT_SOLVE_TRI_ROWS_CUTOFF 16
+#define FMPZ_MOD_MAT_SOLVE_TRI_COLS_CUTOFF 16
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,30 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_add(fmpz_mod_mat_t C, const fmpz_mod_mat_t A,
+                                                       const fmpz_mod_mat_t B)
+{
+    slong i, j;
+
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++)
+    {
+        for (j = 0; j < fmpz_mod_mat_ncols(A); j++)
+        {
+            fmpz * c = fmpz_mod_mat_entry(C, i, j);
+
+            fmpz_add(c, fmpz_mod_mat_entry(A, i, j),
+                                               fmpz_mod_mat_entry(B, i, j));
+            if (fmpz_cmp(c, C->mod) >= 0)
+                fmpz_sub(c, c, C->mod);
+        }
+    }
+}
@@ -0,0 +1,18 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_init(fmpz_mod_mat_t mat, slong rows, slong cols,
+                                                                const fmpz_t n)
+{
+    fmpz_mat_init(mat->mat, rows, cols);
+    fmpz_init_set(mat->mod, n);
+}
@@ -0,0 +1,48 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+int fmpz_mod_mat_inv(fmpz_mod_mat_t B, const fmpz_mod_mat_t A)
+{
+    fmpz_mod_mat_t I;
+    slong dim;
+    int result;
+
+    dim = fmpz_mod_mat_nrows(A);
+
+    switch (dim)
+    {
+        case 0:
+            result = 1;
+            break;
+
+        case 1:
+            if (fmpz_is_zero(fmpz_mod_mat_entry(A, 0, 0)))
+            {
+                result = 0;
+            }
+            else
+            {
+                fmpz_invmod(fmpz_mod_mat_entry(B, 0, 0),
+                                       fmpz_mod_mat_entry(A, 0, 0), B->mod);
+                result = 1;
+            }
+            break;
+
+        default:
+            fmpz_mod_mat_init(I, dim, dim, B->mod);
+            fmpz_mod_mat_one(I);
+            result = fmpz_mod_mat_solve(B, A, I);
+            fmpz_mod_mat_clear(I);
+    }
+
+    return result;
+}
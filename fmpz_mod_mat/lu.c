@@ -0,0 +1,17 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+slong
+fmpz_mod_mat_lu(slong * P, fmpz_mod_mat_t A, int rank_check)
+{
+    return fmpz_mod_mat_lu_recursive(P, A, rank_check);
+}
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+static __inline__ int
+fmpz_mod_mat_pivot(fmpz_mod_mat_t A, slong * P, slong start_row, slong col)
+{
+    slong j, t;
+    fmpz * u;
+
+    if (!fmpz_is_zero(fmpz_mod_mat_entry(A, start_row, col)))
+        return 1;
+
+    for (j = start_row + 1; j < fmpz_mod_mat_nrows(A); j++)
+    {
+        if (!fmpz_is_zero(fmpz_mod_mat_entry(A, j, col)))
+        {
+            u = A->mat->rows[j];
+            A->mat->rows[j] = A->mat->rows[start_row];
+            A->mat->rows[start_row] = u;
+
+            t = P[j];
+            P[j] = P[start_row];
+            P[start_row] = t;
+
+            return -1;
+        }
+    }
+    return 0;
+}
+
+slong
+fmpz_mod_mat_lu_classical(slong * P, fmpz_mod_mat_t A, int rank_check)
+{
+    fmpz_t d, e;
+    fmpz ** a;
+    slong i, j, m, n, rank, row, col;
+
+    m = fmpz_mod_mat_nrows(A);
+    n = fmpz_mod_mat_ncols(A);
+    a = A->mat->rows;
+
+    rank = row = col = 0;
+
+    for (i = 0; i < m; i++)
+        P[i] = i;
+
+    fmpz_init(d);
+    fmpz_init(e);
+
+    while (row < m && col < n)
+    {
+        if (fmpz_mod_mat_pivot(A, P, row, col) == 0)
+        {
+            if (rank_check)
+            {
+                rank = 0;
+                break;
+            }
+            col++;
+            continue;
+        }
+
+        rank++;
+
+        fmpz_invmod(d, a[row] + col, A->mod);
+
+        for (i = row + 1; i < m; i++)
+        {
+            fmpz_mul(e, a[i] + col, d);
+            fmpz_mod(e, e, A->mod);
+
+            for (j = col + 1; j < n; j++)
+            {
+                fmpz_submul(a[i] + j, e, a[row] + j);
+                fmpz_mod(a[i] + j, a[i] + j, A->mod);
+            }
+
+            fmpz_zero(a[i] + col);
+            fmpz_swap(a[i] + rank - 1, e);
+        }
+        row++;
+        col++;
+    }
+
+    fmpz_clear(d);
+    fmpz_clear(e);
+
+    return rank;
+}
@@ -0,0 +1,36 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+/*
+    The entries of A and B are reduced, so the bit size of the unreduced
+    product is known in advance. For large moduli the product is computed
+    with the multimodular algorithm directly, without fmpz_mat_mul scanning
+    the inputs for their size, and reduced once at the end.
+*/
+void fmpz_mod_mat_mul(fmpz_mod_mat_t C, const fmpz_mod_mat_t A,
+                                                       const fmpz_mod_mat_t B)
+{
+    slong dim;
+    flint_bitcnt_t bits;
+
+    dim = FLINT_MIN(fmpz_mod_mat_nrows(A), fmpz_mod_mat_ncols(A));
+    dim = FLINT_MIN(dim, fmpz_mod_mat_ncols(B));
+
+    bits = 2*fmpz_bits(C->mod) + FLINT_BIT_COUNT(fmpz_mod_mat_ncols(A)) + 1;
+
+    if (dim > FMPZ_MOD_MAT_MUL_MULTI_MOD_CUTOFF && bits > FLINT_BITS - 2)
+        _fmpz_mat_mul_multi_mod(C->mat, A->mat, B->mat, bits);
+    else
+        fmpz_mat_mul(C->mat, A->mat, B->mat);
+
+    _fmpz_mod_mat_reduce(C);
+}
@@ -0,0 +1,28 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_neg(fmpz_mod_mat_t B, const fmpz_mod_mat_t A)
+{
+    slong i, j;
+
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++)
+    {
+        for (j = 0; j < fmpz_mod_mat_ncols(A); j++)
+        {
+            if (fmpz_is_zero(fmpz_mod_mat_entry(A, i, j)))
+                fmpz_zero(fmpz_mod_mat_entry(B, i, j));
+            else
+                fmpz_sub(fmpz_mod_mat_entry(B, i, j), B->mod,
+                                               fmpz_mod_mat_entry(A, i, j));
+        }
+    }
+}
@@ -0,0 +1,19 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_one(fmpz_mod_mat_t mat)
+{
+    fmpz_mat_one(mat->mat);
+
+    if (fmpz_is_one(mat->mod))
+        fmpz_mat_zero(mat->mat);
+}
@@ -0,0 +1,21 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_print_pretty(const fmpz_mod_mat_t mat)
+{
+    flint_printf("<%wd x %wd matrix mod ",
+                        fmpz_mod_mat_nrows(mat), fmpz_mod_mat_ncols(mat));
+    fmpz_print(mat->mod);
+    flint_printf(">\n");
+    fmpz_mat_print_pretty(mat->mat);
+    flint_printf("\n");
+}
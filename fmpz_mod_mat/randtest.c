@@ -0,0 +1,20 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_randtest(fmpz_mod_mat_t mat, flint_rand_t state)
+{
+    slong i, j;
+
+    for (i = 0; i < fmpz_mod_mat_nrows(mat); i++)
+        for (j = 0; j < fmpz_mod_mat_ncols(mat); j++)
+            fmpz_randm(fmpz_mod_mat_entry(mat, i, j), state, mat->mod);
+}
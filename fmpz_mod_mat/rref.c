@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mat.h"
+#include "perm.h"
+
+static slong
+_fmpz_mod_mat_rref(fmpz_mod_mat_t A, slong * pivots_nonpivots, slong * P)
+{
+    slong i, j, k, n, rank;
+    slong * pivots;
+    slong * nonpivots;
+
+    fmpz_mod_mat_t U, V;
+
+    n = fmpz_mod_mat_ncols(A);
+
+    rank = fmpz_mod_mat_lu(P, A, 0);
+
+    if (rank == 0)
+    {
+        for (i = 0; i < n; i++)
+            pivots_nonpivots[i] = i;
+        return rank;
+    }
+
+    /* Clear L */
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++)
+        for (j = 0; j < FLINT_MIN(i, rank); j++)
+            fmpz_zero(fmpz_mod_mat_entry(A, i, j));
+
+    /* We now reorder U to proper upper triangular form U | V
+       with U full-rank triangular, set V = U^(-1) V, and then
+       put the column back in the original order.
+
+       An improvement for some matrices would be to compress V by
+       discarding columns containing nothing but zeros. */
+
+    fmpz_mod_mat_init(U, rank, rank, A->mod);
+    fmpz_mod_mat_init(V, rank, n - rank, A->mod);
+
+    pivots = pivots_nonpivots;
+    nonpivots = pivots_nonpivots + rank;
+
+    for (i = j = k = 0; i < rank; i++)
+    {
+        while (fmpz_is_zero(fmpz_mod_mat_entry(A, i, j)))
+        {
+            nonpivots[k] = j;
+            k++;
+            j++;
+        }
+        pivots[i] = j;
+        j++;
+    }
+    while (k < n - rank)
+    {
+        nonpivots[k] = j;
+        k++;
+        j++;
+    }
+
+    for (i = 0; i < rank; i++)
+    {
+        for (j = 0; j <= i; j++)
+            fmpz_set(fmpz_mod_mat_entry(U, j, i),
+                     fmpz_mod_mat_entry(A, j, pivots[i]));
+    }
+
+    for (i = 0; i < n - rank; i++)
+    {
+        for (j = 0; j < rank; j++)
+            fmpz_set(fmpz_mod_mat_entry(V, j, i),
+                     fmpz_mod_mat_entry(A, j, nonpivots[i]));
+    }
+
+    fmpz_mod_mat_solve_triu(V, U, V, 0);
+
+    /* Clear pivot columns */
+    for (i = 0; i < rank; i++)
+    {
+        for (j = 0; j <= i; j++)
+            fmpz_set_ui(fmpz_mod_mat_entry(A, j, pivots[i]), i == j);
+    }
+
+    /* Write back the actual content */
+    for (i = 0; i < n - rank; i++)
+    {
+        for (j = 0; j < rank; j++)
+            fmpz_set(fmpz_mod_mat_entry(A, j, nonpivots[i]),
+                     fmpz_mod_mat_entry(V, j, i));
+    }
+
+    fmpz_mod_mat_clear(U);
+    fmpz_mod_mat_clear(V);
+
+    return rank;
+}
+
+slong
+fmpz_mod_mat_rref(fmpz_mod_mat_t A)
+{
+    slong rank, * pivots_nonpivots, * P;
+    pivots_nonpivots = flint_malloc(sizeof(slong) * fmpz_mod_mat_ncols(A));
+    P = _perm_init(fmpz_mod_mat_nrows(A));
+
+    rank = _fmpz_mod_mat_rref(A, pivots_nonpivots, P);
+
+    flint_free(pivots_nonpivots);
+    _perm_clear(P);
+
+    return rank;
+}
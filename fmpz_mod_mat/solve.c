@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+int
+fmpz_mod_mat_solve(fmpz_mod_mat_t X, const fmpz_mod_mat_t A,
+                                                       const fmpz_mod_mat_t B)
+{
+    slong i, rank, *perm;
+    fmpz_mod_mat_t LU;
+    int result;
+
+    if (fmpz_mod_mat_nrows(A) == 0 || fmpz_mod_mat_ncols(B) == 0)
+        return 1;
+
+    fmpz_mod_mat_init_set(LU, A);
+    perm = flint_malloc(sizeof(slong) * fmpz_mod_mat_nrows(A));
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++)
+        perm[i] = i;
+
+    rank = fmpz_mod_mat_lu(perm, LU, 1);
+
+    if (rank == fmpz_mod_mat_nrows(A))
+    {
+        fmpz_mod_mat_t PB;
+        fmpz_mod_mat_window_init(PB, B, 0, 0, fmpz_mod_mat_nrows(B),
+                                                        fmpz_mod_mat_ncols(B));
+        for (i = 0; i < fmpz_mod_mat_nrows(A); i++)
+            PB->mat->rows[i] = B->mat->rows[perm[i]];
+
+        fmpz_mod_mat_solve_tril(X, LU, PB, 1);
+        fmpz_mod_mat_solve_triu(X, LU, X, 0);
+
+        fmpz_mod_mat_window_clear(PB);
+        result = 1;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    fmpz_mod_mat_clear(LU);
+    flint_free(perm);
+
+    return result;
+}
@@ -0,0 +1,26 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void
+fmpz_mod_mat_solve_triu(fmpz_mod_mat_t X, const fmpz_mod_mat_t U,
+                                            const fmpz_mod_mat_t B, int unit)
+{
+    if (fmpz_mod_mat_nrows(B) < FMPZ_MOD_MAT_SOLVE_TRI_ROWS_CUTOFF ||
+        fmpz_mod_mat_ncols(B) < FMPZ_MOD_MAT_SOLVE_TRI_COLS_CUTOFF)
+    {
+        fmpz_mod_mat_solve_triu_classical(X, U, B, unit);
+    }
+    else
+    {
+        fmpz_mod_mat_solve_triu_recursive(X, U, B, unit);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_vec.h"
+#include "fmpz_mod_mat.h"
+
+/* dot products are accumulated unreduced and reduced once per entry */
+void
+fmpz_mod_mat_solve_triu_classical(fmpz_mod_mat_t X, const fmpz_mod_mat_t U,
+                                            const fmpz_mod_mat_t B, int unit)
+{
+    slong i, j, n, m;
+    fmpz * inv, * tmp;
+    fmpz_t s;
+
+    n = fmpz_mod_mat_nrows(U);
+    m = fmpz_mod_mat_ncols(B);
+
+    if (!unit)
+    {
+        inv = _fmpz_vec_init(n);
+        for (i = 0; i < n; i++)
+            fmpz_invmod(inv + i, fmpz_mod_mat_entry(U, i, i), U->mod);
+    }
+    else
+        inv = NULL;
+
+    tmp = _fmpz_vec_init(n);
+    fmpz_init(s);
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = n - 1; j >= 0; j--)
+        {
+            _fmpz_vec_dot(s, U->mat->rows[j] + j + 1, tmp + j + 1,
+                                                                  n - j - 1);
+            fmpz_sub(s, fmpz_mod_mat_entry(B, j, i), s);
+            if (!unit)
+                fmpz_mul(s, s, inv + j);
+            fmpz_mod(tmp + j, s, U->mod);
+        }
+
+        for (j = 0; j < n; j++)
+            fmpz_set(fmpz_mod_mat_entry(X, j, i), tmp + j);
+    }
+
+    fmpz_clear(s);
+    _fmpz_vec_clear(tmp, n);
+    if (!unit)
+        _fmpz_vec_clear(inv, n);
+}
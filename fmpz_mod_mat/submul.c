@@ -0,0 +1,23 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mat.h"
+
+void fmpz_mod_mat_submul(fmpz_mod_mat_t D, const fmpz_mod_mat_t C,
+                              const fmpz_mod_mat_t A, const fmpz_mod_mat_t B)
+{
+    fmpz_mod_mat_t T;
+
+    fmpz_mod_mat_init(T, fmpz_mod_mat_nrows(A), fmpz_mod_mat_ncols(B),
+                                                                      A->mod);
+    fmpz_mod_mat_mul(T, A, B);
+    fmpz_mod_mat_sub(D, C, T);
+    fmpz_mod_mat_clear(T);
+}
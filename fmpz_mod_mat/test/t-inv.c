@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mat.h"
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("inv....");
+    fflush(stdout);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mat_t A, B, C, I;
+        fmpz_t p;
+        slong m;
+        int result;
+
+        m = n_randint(state, 30);
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, 2 + n_randint(state, 200), 0);
+
+        fmpz_mod_mat_init(A, m, m, p);
+        fmpz_mod_mat_init(B, m, m, p);
+        fmpz_mod_mat_init(C, m, m, p);
+        fmpz_mod_mat_init(I, m, m, p);
+
+        fmpz_mod_mat_randtest(A, state);
+        fmpz_mod_mat_one(I);
+
+        result = fmpz_mod_mat_inv(B, A);
+
+        if (result != (fmpz_mod_mat_rank(A) == m))
+        {
+            flint_printf("FAIL: wrong return value\n");
+            fmpz_mod_mat_print_pretty(A);
+            abort();
+        }
+
+        if (result)
+        {
+            fmpz_mod_mat_mul(C, A, B);
+
+            if (!fmpz_mod_mat_equal(C, I))
+            {
+                flint_printf("FAIL: A*A^-1 != 1\n");
+                fmpz_mod_mat_print_pretty(A);
+                fmpz_mod_mat_print_pretty(B);
+                abort();
+            }
+
+            /* aliasing */
+            fmpz_mod_mat_inv(A, A);
+
+            if (!fmpz_mod_mat_equal(A, B))
+            {
+                flint_printf("FAIL: aliasing\n");
+                abort();
+            }
+        }
+
+        fmpz_mod_mat_clear(A);
+        fmpz_mod_mat_clear(B);
+        fmpz_mod_mat_clear(C);
+        fmpz_mod_mat_clear(I);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mat.h"
+
+void perm(fmpz_mod_mat_t A, slong * P)
+{
+    slong i;
+    fmpz ** tmp;
+
+    if (fmpz_mod_mat_ncols(A) == 0 || fmpz_mod_mat_nrows(A) == 0)
+        return;
+
+    tmp = flint_malloc(sizeof(fmpz *) * fmpz_mod_mat_nrows(A));
+
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++) tmp[P[i]] = A->mat->rows[i];
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++) A->mat->rows[i] = tmp[i];
+
+    flint_free(tmp);
+}
+
+void check(slong * P, fmpz_mod_mat_t LU, const fmpz_mod_mat_t A, slong rank)
+{
+    fmpz_mod_mat_t B, L, U;
+    slong m, n, i, j;
+
+    m = fmpz_mod_mat_nrows(A);
+    n = fmpz_mod_mat_ncols(A);
+
+    fmpz_mod_mat_init(B, m, n, A->mod);
+    fmpz_mod_mat_init(L, m, m, A->mod);
+    fmpz_mod_mat_init(U, m, n, A->mod);
+
+    for (i = rank; i < FLINT_MIN(m, n); i++)
+    {
+        for (j = i; j < n; j++)
+        {
+            if (!fmpz_is_zero(fmpz_mod_mat_entry(LU, i, j)))
+            {
+                flint_printf("FAIL: wrong shape!\n");
+                abort();
+            }
+        }
+    }
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < FLINT_MIN(i, n); j++)
+            fmpz_set(fmpz_mod_mat_entry(L, i, j),
+                                              fmpz_mod_mat_entry(LU, i, j));
+        if (i < rank)
+            fmpz_one(fmpz_mod_mat_entry(L, i, i));
+        for (j = i; j < n; j++)
+            fmpz_set(fmpz_mod_mat_entry(U, i, j),
+                                              fmpz_mod_mat_entry(LU, i, j));
+    }
+
+    fmpz_mod_mat_mul(B, L, U);
+    perm(B, P);
+
+    if (!fmpz_mod_mat_equal(A, B))
+    {
+        flint_printf("FAIL\n");
+        flint_printf("A:\n");
+        fmpz_mod_mat_print_pretty(A);
+        flint_printf("LU:\n");
+        fmpz_mod_mat_print_pretty(LU);
+        flint_printf("B:\n");
+        fmpz_mod_mat_print_pretty(B);
+        abort();
+    }
+
+    fmpz_mod_mat_clear(B);
+    fmpz_mod_mat_clear(L);
+    fmpz_mod_mat_clear(U);
+}
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("lu....");
+    fflush(stdout);
+
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mat_t A, X, Y, LU;
+        fmpz_t p;
+        slong m, n, r, rank;
+        slong * P;
+
+        m = n_randint(state, 20);
+        n = n_randint(state, 20);
+        r = n_randint(state, FLINT_MIN(m, n) + 1);
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, 20 + n_randint(state, 200), 0);
+
+        /* A = X*Y has rank r with high probability */
+        fmpz_mod_mat_init(A, m, n, p);
+        fmpz_mod_mat_init(X, m, r, p);
+        fmpz_mod_mat_init(Y, r, n, p);
+        fmpz_mod_mat_randtest(X, state);
+        fmpz_mod_mat_randtest(Y, state);
+        fmpz_mod_mat_mul(A, X, Y);
+
+        fmpz_mod_mat_init_set(LU, A);
+        P = flint_malloc(sizeof(slong) * m);
+
+        if (n_randint(state, 2))
+            rank = fmpz_mod_mat_lu_classical(P, LU, 0);
+        else
+            rank = fmpz_mod_mat_lu_recursive(P, LU, 0);
+
+        if (r != rank || rank != fmpz_mod_mat_rank(A))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("wrong rank!\n");
+            fmpz_mod_mat_print_pretty(A);
+            abort();
+        }
+
+        check(P, LU, A, rank);
+
+        fmpz_mod_mat_clear(A);
+        fmpz_mod_mat_clear(X);
+        fmpz_mod_mat_clear(Y);
+        fmpz_mod_mat_clear(LU);
+        flint_free(P);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mat.h"
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_strassen....");
+    fflush(stdout);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mat_t A, B, C;
+        fmpz_mat_t D;
+        fmpz_t p;
+        slong m, k, n;
+
+        m = n_randint(state, 40);
+        k = n_randint(state, 40);
+        n = n_randint(state, 40);
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, 2 + n_randint(state, 300), 0);
+
+        fmpz_mod_mat_init(A, m, k, p);
+        fmpz_mod_mat_init(B, k, n, p);
+        fmpz_mod_mat_init(C, m, n, p);
+        fmpz_mat_init(D, m, n);
+
+        fmpz_mod_mat_randtest(A, state);
+        fmpz_mod_mat_randtest(B, state);
+        fmpz_mod_mat_randtest(C, state);
+
+        fmpz_mod_mat_mul_strassen(C, A, B);
+
+        fmpz_mat_mul(D, A->mat, B->mat);
+        fmpz_mat_scalar_mod_fmpz(D, D, p);
+
+        if (!fmpz_mat_equal(C->mat, D))
+        {
+            flint_printf("FAIL: results not equal\n");
+            fmpz_mod_mat_print_pretty(A);
+            fmpz_mod_mat_print_pretty(B);
+            fmpz_mod_mat_print_pretty(C);
+            abort();
+        }
+
+        if (m == k && k == n)
+        {
+            /* aliasing */
+            fmpz_mod_mat_mul_strassen(A, A, B);
+
+            if (!fmpz_mat_equal(A->mat, D))
+            {
+                flint_printf("FAIL: aliasing failed\n");
+                abort();
+            }
+        }
+
+        fmpz_mod_mat_clear(A);
+        fmpz_mod_mat_clear(B);
+        fmpz_mod_mat_clear(C);
+        fmpz_mat_clear(D);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
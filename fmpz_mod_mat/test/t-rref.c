@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mat.h"
+
+/* pivots are ones, pivot columns are otherwise zero, zero rows come last */
+int check_rref_form(const fmpz_mod_mat_t A, slong rank)
+{
+    slong i, j, k, prev_pivot = -1;
+
+    for (i = 0; i < fmpz_mod_mat_nrows(A); i++)
+    {
+        for (j = 0; j < fmpz_mod_mat_ncols(A); j++)
+            if (!fmpz_is_zero(fmpz_mod_mat_entry(A, i, j)))
+                break;
+
+        if (j == fmpz_mod_mat_ncols(A))
+        {
+            if (i < rank)
+                return 0;
+            continue;
+        }
+
+        if (i >= rank || j <= prev_pivot)
+            return 0;
+
+        if (!fmpz_is_one(fmpz_mod_mat_entry(A, i, j)))
+            return 0;
+
+        for (k = 0; k < fmpz_mod_mat_nrows(A); k++)
+            if (k != i && !fmpz_is_zero(fmpz_mod_mat_entry(A, k, j)))
+                return 0;
+
+        prev_pivot = j;
+    }
+
+    return 1;
+}
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("rref....");
+    fflush(stdout);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mat_t A, B, S, X, Y;
+        fmpz_t p;
+        slong m, n, r, rank1, rank2;
+
+        m = n_randint(state, 20);
+        n = n_randint(state, 20);
+        r = n_randint(state, FLINT_MIN(m, n) + 1);
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, 20 + n_randint(state, 200), 0);
+
+        fmpz_mod_mat_init(A, m, n, p);
+        fmpz_mod_mat_init(B, m, n, p);
+        fmpz_mod_mat_init(S, m, m, p);
+        fmpz_mod_mat_init(X, m, r, p);
+        fmpz_mod_mat_init(Y, r, n, p);
+
+        fmpz_mod_mat_randtest(X, state);
+        fmpz_mod_mat_randtest(Y, state);
+        fmpz_mod_mat_mul(A, X, Y);
+
+        /* B = S*A has the same reduced row echelon form */
+        fmpz_mod_mat_randtest(S, state);
+        fmpz_mod_mat_mul(B, S, A);
+
+        rank1 = fmpz_mod_mat_rref(A);
+        rank2 = fmpz_mod_mat_rref(B);
+
+        if (rank1 != r || !check_rref_form(A, rank1))
+        {
+            flint_printf("FAIL: not in rref form\n");
+            fmpz_mod_mat_print_pretty(A);
+            abort();
+        }
+
+        if (fmpz_mod_mat_rank(S) == m &&
+                           (rank1 != rank2 || !fmpz_mod_mat_equal(A, B)))
+        {
+            flint_printf("FAIL: rref not unique\n");
+            fmpz_mod_mat_print_pretty(A);
+            fmpz_mod_mat_print_pretty(B);
+            abort();
+        }
+
+        fmpz_mod_mat_clear(A);
+        fmpz_mod_mat_clear(B);
+        fmpz_mod_mat_clear(S);
+        fmpz_mod_mat_clear(X);
+        fmpz_mod_mat_clear(Y);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mat.h"
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("solve....");
+    fflush(stdout);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mat_t A, X, B, AX;
+        fmpz_t p;
+        slong m, n;
+        int solved;
+
+        m = n_randint(state, 40);
+        n = n_randint(state, 40);
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, 2 + n_randint(state, 200), 0);
+
+        fmpz_mod_mat_init(A, m, m, p);
+        fmpz_mod_mat_init(B, m, n, p);
+        fmpz_mod_mat_init(X, m, n, p);
+        fmpz_mod_mat_init(AX, m, n, p);
+
+        fmpz_mod_mat_randtest(A, state);
+        fmpz_mod_mat_randtest(B, state);
+
+        /* make A singular now and then */
+        if (m > 1 && n_randint(state, 4) == 0)
+        {
+            slong j;
+            for (j = 0; j < m; j++)
+                fmpz_set(fmpz_mod_mat_entry(A, m - 1, j),
+                                                fmpz_mod_mat_entry(A, 0, j));
+        }
+
+        solved = fmpz_mod_mat_solve(X, A, B);
+
+        if (n > 0 && solved != (fmpz_mod_mat_rank(A) == m))
+        {
+            flint_printf("FAIL: wrong return value\n");
+            fmpz_mod_mat_print_pretty(A);
+            abort();
+        }
+
+        if (solved)
+        {
+            fmpz_mod_mat_mul(AX, A, X);
+
+            if (!fmpz_mod_mat_equal(AX, B))
+            {
+                flint_printf("FAIL: A*X != B\n");
+                fmpz_mod_mat_print_pretty(A);
+                fmpz_mod_mat_print_pretty(B);
+                fmpz_mod_mat_print_pretty(X);
+                abort();
+            }
+        }
+
+        fmpz_mod_mat_clear(A);
+        fmpz_mod_mat_clear(B);
+        fmpz_mod_mat_clear(X);
+        fmpz_mod_mat_clear(AX);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
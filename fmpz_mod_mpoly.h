@@ -0,0 +1,465 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FMPZ_MOD_MPOLY_H
+#define FMPZ_MOD_MPOLY_H
+
+#ifdef FMPZ_MOD_MPOLY_INLINES_C
+#define FMPZ_MOD_MPOLY_INLINE FLINT_DLL
+#else
+#define FMPZ_MOD_MPOLY_INLINE static __inline__
+#endif
+
+#undef ulong
+#define ulong ulongxx /* interferes with system includes */
+#include <stdio.h>
+#undef ulong
+
+#include <gmp.h>
+#define ulong mp_limb_t
+
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mod.h"
+#include "fmpz_mod_poly.h"
+#include "mpoly.h"
+#include "fmpz_mpoly.h"
+#include "thread_pool.h"
+
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+
+/*  Type definitions *********************************************************/
+
+/*
+    context object for fmpz_mod_mpoly
+*/
+typedef struct
+{
+    mpoly_ctx_t minfo;
+    fmpz_mod_ctx_t ffinfo;
+} fmpz_mod_mpoly_ctx_struct;
+
+typedef fmpz_mod_mpoly_ctx_struct fmpz_mod_mpoly_ctx_t[1];
+
+/*
+    fmpz_mod_mpoly_t
+    sparse multivariates with coeffs in [0, p) for the modulus p of the ctx
+*/
+typedef struct
+{
+    fmpz * coeffs; /* alloc fmpzs */
+    ulong * exps;
+    slong alloc;
+    slong length;
+    flint_bitcnt_t bits;     /* number of bits per exponent */
+} fmpz_mod_mpoly_struct;
+
+typedef fmpz_mod_mpoly_struct fmpz_mod_mpoly_t[1];
+
+
+/*  Context object ***********************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_ctx_init(fmpz_mod_mpoly_ctx_t ctx,
+                          slong nvars, const ordering_t ord, const fmpz_t p);
+
+FLINT_DLL void fmpz_mod_mpoly_ctx_init_rand(fmpz_mod_mpoly_ctx_t ctx,
+                       flint_rand_t state, slong max_nvars, const fmpz_t p);
+
+FLINT_DLL void fmpz_mod_mpoly_ctx_clear(fmpz_mod_mpoly_ctx_t ctx);
+
+FMPZ_MOD_MPOLY_INLINE
+slong fmpz_mod_mpoly_ctx_nvars(const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return ctx->minfo->nvars;
+}
+
+FMPZ_MOD_MPOLY_INLINE
+ordering_t fmpz_mod_mpoly_ctx_ord(const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return ctx->minfo->ord;
+}
+
+FMPZ_MOD_MPOLY_INLINE
+const fmpz * fmpz_mod_mpoly_ctx_modulus(const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return fmpz_mod_ctx_modulus(ctx->ffinfo);
+}
+
+
+/*  Memory management ********************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_init(fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_init2(fmpz_mod_mpoly_t A, slong alloc,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_init3(fmpz_mod_mpoly_t A, slong alloc,
+                         flint_bitcnt_t bits, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_realloc(fmpz_mod_mpoly_t A, slong alloc,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_fit_length(fmpz_mod_mpoly_t A, slong len,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_clear(fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FMPZ_MOD_MPOLY_INLINE
+void _fmpz_mod_mpoly_set_length(fmpz_mod_mpoly_t A, slong newlen,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    if (A->length > newlen)
+    {
+        slong i;
+        for (i = newlen; i < A->length; i++)
+            _fmpz_demote(A->coeffs + i);
+    }
+    A->length = newlen;
+}
+
+FMPZ_MOD_MPOLY_INLINE
+void fmpz_mod_mpoly_truncate(fmpz_mod_mpoly_t A, slong newlen,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    if (A->length > newlen)
+    {
+        slong i;
+        for (i = newlen; i < A->length; i++)
+            _fmpz_demote(A->coeffs + i);
+        A->length = newlen;
+    }
+}
+
+FMPZ_MOD_MPOLY_INLINE
+void fmpz_mod_mpoly_fit_bits(fmpz_mod_mpoly_t A, flint_bitcnt_t bits,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    if (A->bits < bits)
+    {
+        if (A->alloc != 0)
+        {
+            slong N = mpoly_words_per_exp(bits, ctx->minfo);
+            ulong * t = (ulong *) flint_malloc(N*A->alloc*sizeof(ulong));
+            mpoly_repack_monomials(t, bits, A->exps, A->bits, A->length,
+                                                                  ctx->minfo);
+            flint_free(A->exps);
+            A->exps = t;
+        }
+
+        A->bits = bits;
+    }
+}
+
+
+/* Input/output **************************************************************/
+
+FLINT_DLL char * fmpz_mod_mpoly_get_str_pretty(const fmpz_mod_mpoly_t A,
+                              const char ** x, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL int fmpz_mod_mpoly_fprint_pretty(FILE * file,
+                             const fmpz_mod_mpoly_t A, const char ** x,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FMPZ_MOD_MPOLY_INLINE
+int fmpz_mod_mpoly_print_pretty(const fmpz_mod_mpoly_t A,
+                               const char ** x, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return fmpz_mod_mpoly_fprint_pretty(stdout, A, x, ctx);
+}
+
+
+/*  Basic manipulation *******************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_gen(fmpz_mod_mpoly_t A, slong var,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_set(fmpz_mod_mpoly_t A,
+                   const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL int fmpz_mod_mpoly_equal(const fmpz_mod_mpoly_t A,
+                   const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_ctx_t ctx);
+
+FMPZ_MOD_MPOLY_INLINE
+void fmpz_mod_mpoly_swap(fmpz_mod_mpoly_t A, fmpz_mod_mpoly_t B,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    fmpz_mod_mpoly_struct t = *A;
+    *A = *B;
+    *B = t;
+}
+
+
+/* Constants *****************************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_set_fmpz(fmpz_mod_mpoly_t A, const fmpz_t c,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_set_ui(fmpz_mod_mpoly_t A, ulong c,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FMPZ_MOD_MPOLY_INLINE
+void fmpz_mod_mpoly_zero(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    _fmpz_mod_mpoly_set_length(A, 0, ctx);
+}
+
+FMPZ_MOD_MPOLY_INLINE
+void fmpz_mod_mpoly_one(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    fmpz_mod_mpoly_set_ui(A, UWORD(1), ctx);
+}
+
+FMPZ_MOD_MPOLY_INLINE
+int fmpz_mod_mpoly_is_zero(const fmpz_mod_mpoly_t A,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return A->length == 0;
+}
+
+FLINT_DLL int fmpz_mod_mpoly_is_one(const fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+
+/* Degrees *******************************************************************/
+
+FMPZ_MOD_MPOLY_INLINE
+void fmpz_mod_mpoly_degrees_si(slong * degs, const fmpz_mod_mpoly_t A,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    mpoly_degrees_si(degs, A->exps, A->length, A->bits, ctx->minfo);
+}
+
+FMPZ_MOD_MPOLY_INLINE
+slong fmpz_mod_mpoly_degree_si(const fmpz_mod_mpoly_t A, slong var,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return mpoly_degree_si(A->exps, A->length, A->bits, var, ctx->minfo);
+}
+
+FMPZ_MOD_MPOLY_INLINE
+slong fmpz_mod_mpoly_total_degree_si(const fmpz_mod_mpoly_t A,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return mpoly_total_degree_si(A->exps, A->length, A->bits, ctx->minfo);
+}
+
+
+/* Coefficients **************************************************************/
+
+FMPZ_MOD_MPOLY_INLINE
+fmpz * fmpz_mod_mpoly_leadcoeff(const fmpz_mod_mpoly_t A)
+{
+    FLINT_ASSERT(A->length > 0);
+    return A->coeffs + 0;
+}
+
+
+/* container operations ******************************************************/
+
+FLINT_DLL int fmpz_mod_mpoly_is_canonical(const fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_assert_canonical(const fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FMPZ_MOD_MPOLY_INLINE
+slong fmpz_mod_mpoly_length(const fmpz_mod_mpoly_t A,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return A->length;
+}
+
+FLINT_DLL void _fmpz_mod_mpoly_push_exp_ui(fmpz_mod_mpoly_t A,
+                         const ulong * exp, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void _fmpz_mod_mpoly_push_exp_ffmpz(fmpz_mod_mpoly_t A,
+                          const fmpz * exp, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_push_term_fmpz_ui(fmpz_mod_mpoly_t A,
+                                      const fmpz_t c, const ulong * exp,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_push_term_ui_ui(fmpz_mod_mpoly_t A,
+                ulong c, const ulong * exp, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_sort_terms(fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_combine_like_terms(fmpz_mod_mpoly_t A,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL int fmpz_mod_mpoly_repack_bits(fmpz_mod_mpoly_t A,
+                                const fmpz_mod_mpoly_t B, flint_bitcnt_t Abits,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+
+/* Random generation *********************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_randtest_bound(fmpz_mod_mpoly_t A,
+                       flint_rand_t state, slong length, ulong exp_bound,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_randtest_bits(fmpz_mod_mpoly_t A,
+                flint_rand_t state, slong length, flint_bitcnt_t exp_bits,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+
+/* Addition/Subtraction ******************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_add(fmpz_mod_mpoly_t A,
+                           const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_sub(fmpz_mod_mpoly_t A,
+                           const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL slong _fmpz_mod_mpoly_add(fmpz * Acoeff, ulong * Aexp,
+                 const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                 const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+          slong N, const ulong * cmpmask, const fmpz_mod_ctx_t fpctx);
+
+FLINT_DLL slong _fmpz_mod_mpoly_sub(fmpz * Acoeff, ulong * Aexp,
+                 const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                 const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+          slong N, const ulong * cmpmask, const fmpz_mod_ctx_t fpctx);
+
+
+/* Scalar operations *********************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_neg(fmpz_mod_mpoly_t A,
+                   const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_scalar_mul_fmpz(fmpz_mod_mpoly_t A,
+                            const fmpz_mod_mpoly_t B, const fmpz_t c,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_make_monic(fmpz_mod_mpoly_t A,
+                   const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_ctx_t ctx);
+
+
+/* Multiplication ************************************************************/
+
+FLINT_DLL void fmpz_mod_mpoly_mul(fmpz_mod_mpoly_t A,
+                           const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_mul_threaded(fmpz_mod_mpoly_t A,
+                           const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                           const fmpz_mod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void fmpz_mod_mpoly_mul_johnson(fmpz_mod_mpoly_t A,
+                           const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mod_mpoly_mul_heap_threaded(fmpz_mod_mpoly_t A,
+                           const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                           const fmpz_mod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL slong _fmpz_mod_mpoly_mul_johnson(
+                       fmpz ** Acoeff, ulong ** Aexp, slong * Aalloc,
+                       const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                       const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                          flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                                   const fmpz_mod_ctx_t fpctx);
+
+FLINT_DLL void _fmpz_mod_mpoly_mul_heap_threaded(fmpz_mod_mpoly_t A,
+                       const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                       const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                          flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                                    const fmpz_mod_ctx_t fpctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+
+/* Division ******************************************************************/
+
+FLINT_DLL int fmpz_mod_mpoly_divides(fmpz_mod_mpoly_t Q,
+                           const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL int fmpz_mod_mpoly_divides_monagan_pearce(fmpz_mod_mpoly_t Q,
+                           const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL slong _fmpz_mod_mpoly_divides_monagan_pearce(
+                       fmpz ** Qcoeff, ulong ** Qexp, slong * Qalloc,
+                       const fmpz * Acoeff, const ulong * Aexp, slong Alen,
+                       const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                          flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                                   const fmpz_mod_ctx_t fpctx);
+
+
+/* GCD ***********************************************************************/
+
+FLINT_DLL int fmpz_mod_mpoly_gcd(fmpz_mod_mpoly_t G,
+                           const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                               const fmpz_mod_mpoly_ctx_t ctx);
+
+FLINT_DLL int fmpz_mod_mpoly_gcd_threaded(fmpz_mod_mpoly_t G,
+                           const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                           const fmpz_mod_mpoly_ctx_t ctx, slong thread_limit);
+
+
+/******************************************************************************
+
+   Internal functions (guaranteed to change without notice)
+
+******************************************************************************/
+
+/*
+    The heap kernels accumulate products of coefficients without reduction.
+    A coefficient in [0, p) is read as s = fmpz_size(p) limbs, and a sum of
+    products is kept in 2*s + 1 limbs until it is reduced once for its term.
+*/
+
+FLINT_DLL void _fmpz_mod_mpoly_get_limbs(mp_limb_t * a, const fmpz * c,
+                                                         slong len, slong s);
+
+FLINT_DLL void _fmpz_mod_mpoly_reduce_limbs(fmpz_t c, const mp_limb_t * acc,
+                                       slong s, const fmpz_mod_ctx_t fpctx);
+
+/* acc += a*b with t as scratch space of 2*s limbs */
+FMPZ_MOD_MPOLY_INLINE
+void _fmpz_mod_mpoly_addmul_limbs(mp_limb_t * acc, const mp_limb_t * a,
+                                 const mp_limb_t * b, slong s, mp_limb_t * t)
+{
+    if (s == 1)
+    {
+        umul_ppmm(t[1], t[0], a[0], b[0]);
+        add_sssaaaaaa(acc[2], acc[1], acc[0], acc[2], acc[1], acc[0],
+                                                        UWORD(0), t[1], t[0]);
+    }
+    else
+    {
+        mpn_mul_n(t, a, b, s);
+        acc[2*s] += mpn_add_n(acc, acc, t, 2*s);
+    }
+}
+
+/* acc += a */
+FMPZ_MOD_MPOLY_INLINE
+void _fmpz_mod_mpoly_add_limbs(mp_limb_t * acc, const mp_limb_t * a, slong s)
+{
+    acc[2*s] += mpn_add(acc, acc, 2*s, a, s);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
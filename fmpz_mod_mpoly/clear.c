@@ -0,0 +1,26 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_clear(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    if (A->coeffs != NULL)
+    {
+        slong i;
+
+        for (i = 0; i < A->alloc; i++)
+            _fmpz_demote(A->coeffs + i);
+
+        flint_free(A->coeffs);
+        flint_free(A->exps);
+    }
+}
@@ -0,0 +1,18 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_ctx_clear(fmpz_mod_mpoly_ctx_t ctx)
+{
+    mpoly_ctx_clear(ctx->minfo);
+    fmpz_mod_ctx_clear(ctx->ffinfo);
+}
@@ -0,0 +1,19 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_ctx_init_rand(fmpz_mod_mpoly_ctx_t ctx,
+                         flint_rand_t state, slong max_nvars, const fmpz_t p)
+{
+    mpoly_ctx_init_rand(ctx->minfo, state, max_nvars);
+    fmpz_mod_ctx_init(ctx->ffinfo, p);
+}
@@ -0,0 +1,442 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+/*
+    Set Q to A/B using the Monagan-Pearce heap method and return the length
+    of Q, or return 0 if the division is not exact. The exponent vectors take
+    N words and the output is reallocated as needed.
+
+    Each term of the quotient is found by accumulating p - a for the term a
+    of A and the products of terms of B and Q in 2*s + 1 limbs, followed by
+    one reduction and one multiplication by -1/lc(B).
+*/
+slong _fmpz_mod_mpoly_divides_monagan_pearce(
+                       fmpz ** Qcoeff, ulong ** Qexp, slong * Qalloc,
+                       const fmpz * Acoeff, const ulong * Aexp, slong Alen,
+                       const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                          flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                                    const fmpz_mod_ctx_t fpctx)
+{
+    int lt_divides;
+    slong i, j, q_len, s;
+    slong next_loc, heap_len;
+    mpoly_heap_s * heap;
+    mpoly_heap_t * chain;
+    slong * store, * store_base;
+    mpoly_heap_t * x;
+    fmpz * q_coeff = *Qcoeff;
+    ulong * q_exp = *Qexp;
+    ulong * exp, * exps;
+    ulong ** exp_list;
+    slong exp_next;
+    ulong mask;
+    slong * hind;
+    slong nlimbs = fmpz_size(fmpz_mod_ctx_modulus(fpctx));
+    slong Qlimbs_alloc;
+    mp_limb_t * Alimbs, * Blimbs, * Qlimbs, * acc, * t;
+    fmpz_t lc_minus_inv;
+    TMP_INIT;
+
+    TMP_START;
+
+    fmpz_init(lc_minus_inv);
+
+    /* alloc array of heap nodes which can be chained together */
+    next_loc = Blen + 4;   /* something bigger than heap can ever be */
+    heap = (mpoly_heap_s *) TMP_ALLOC((Blen + 1)*sizeof(mpoly_heap_s));
+    chain = (mpoly_heap_t *) TMP_ALLOC(Blen*sizeof(mpoly_heap_t));
+    store = store_base = (slong *) TMP_ALLOC(2*Blen*sizeof(slong));
+
+    /* array of exponent vectors, each of "N" words */
+    exps = (ulong *) TMP_ALLOC(Blen*N*sizeof(ulong));
+    /* list of pointers to available exponent vectors */
+    exp_list = (ulong **) TMP_ALLOC(Blen*sizeof(ulong *));
+    /* set up list of available exponent vectors */
+    exp_next = 0;
+    for (i = 0; i < Blen; i++)
+        exp_list[i] = exps + i*N;
+
+    /* space for flagged heap indicies */
+    hind = (slong *) TMP_ALLOC(Blen*sizeof(slong));
+    for (i = 0; i < Blen; i++)
+        hind[i] = 1;
+
+    /* the terms of A are negated so that every contribution is an addition */
+    Alimbs = (mp_limb_t *) flint_malloc(nlimbs*(Alen + Blen)
+                                                         *sizeof(mp_limb_t));
+    Blimbs = Alimbs + nlimbs*Alen;
+    for (i = 0; i < Alen; i++)
+    {
+        fmpz_mod_neg(lc_minus_inv, Acoeff + i, fpctx);
+        _fmpz_mod_mpoly_get_limbs(Alimbs + nlimbs*i, lc_minus_inv, 1, nlimbs);
+    }
+    _fmpz_mod_mpoly_get_limbs(Blimbs, Bcoeff, Blen, nlimbs);
+
+    Qlimbs_alloc = 16;
+    Qlimbs = (mp_limb_t *) flint_malloc(nlimbs*Qlimbs_alloc
+                                                         *sizeof(mp_limb_t));
+    acc = (mp_limb_t *) TMP_ALLOC((4*nlimbs + 1)*sizeof(mp_limb_t));
+    t = acc + 2*nlimbs + 1;
+
+    /* mask with high bit set in each field of exponent vector */
+    mask = 0;
+    if (bits <= FLINT_BITS)
+    {
+        for (i = 0; i < FLINT_BITS/bits; i++)
+            mask = (mask << bits) + (UWORD(1) << (bits - 1));
+    }
+
+    q_len = WORD(0);
+
+    /* s is the number of terms * (latest quotient) we should put into heap */
+    s = Blen;
+
+    /* insert (-1, 0, Aexp[0]) into heap */
+    heap_len = 2;
+    x = chain + 0;
+    x->i = -WORD(1);
+    x->j = 0;
+    x->next = NULL;
+    heap[1].next = x;
+    heap[1].exp = exp_list[exp_next++];
+    mpoly_monomial_set(heap[1].exp, Aexp, N);
+
+    /* precompute leading cofficient info */
+    fmpz_mod_inv(lc_minus_inv, Bcoeff + 0, fpctx);
+    fmpz_mod_neg(lc_minus_inv, lc_minus_inv, fpctx);
+
+    while (heap_len > 1)
+    {
+        exp = heap[1].exp;
+
+        if (bits <= FLINT_BITS)
+        {
+            if (mpoly_monomial_overflows(exp, N, mask))
+                goto not_exact_division;
+        }
+        else
+        {
+            if (mpoly_monomial_overflows_mp(exp, N, bits))
+                goto not_exact_division;
+        }
+
+        _fmpz_mpoly_fit_length(&q_coeff, &q_exp, Qalloc, q_len + 1, N);
+        if (q_len + 1 > Qlimbs_alloc)
+        {
+            Qlimbs_alloc = FLINT_MAX(q_len + 1, 2*Qlimbs_alloc);
+            Qlimbs = (mp_limb_t *) flint_realloc(Qlimbs,
+                                      nlimbs*Qlimbs_alloc*sizeof(mp_limb_t));
+        }
+
+        if (bits <= FLINT_BITS)
+            lt_divides = mpoly_monomial_divides(q_exp + q_len*N,
+                                                        exp, Bexp, N, mask);
+        else
+            lt_divides = mpoly_monomial_divides_mp(q_exp + q_len*N,
+                                                        exp, Bexp, N, bits);
+
+        flint_mpn_zero(acc, 2*nlimbs + 1);
+        do
+        {
+            exp_list[--exp_next] = heap[1].exp;
+            x = _mpoly_heap_pop(heap, &heap_len, N, cmpmask);
+            do
+            {
+                *store++ = x->i;
+                *store++ = x->j;
+                if (x->i != -WORD(1))
+                    hind[x->i] |= WORD(1);
+
+                if (x->i == -WORD(1))
+                    _fmpz_mod_mpoly_add_limbs(acc, Alimbs + nlimbs*x->j,
+                                                                       nlimbs);
+                else
+                    _fmpz_mod_mpoly_addmul_limbs(acc, Blimbs + nlimbs*x->i,
+                                              Qlimbs + nlimbs*x->j, nlimbs, t);
+            } while ((x = x->next) != NULL);
+        } while (heap_len > 1 && mpoly_monomial_equal(heap[1].exp, exp, N));
+
+        _fmpz_mod_mpoly_reduce_limbs(q_coeff + q_len, acc, nlimbs, fpctx);
+
+        /* process nodes taken from the heap */
+        while (store > store_base)
+        {
+            j = *--store;
+            i = *--store;
+
+            if (i == -WORD(1))
+            {
+                /* take next dividend term */
+                if (j + 1 < Alen)
+                {
+                    x = chain + 0;
+                    x->i = i;
+                    x->j = j + 1;
+                    x->next = NULL;
+                    mpoly_monomial_set(exp_list[exp_next], Aexp + x->j*N, N);
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+                }
+            }
+            else
+            {
+                /* should we go right? */
+                if (i + 1 < Blen && hind[i + 1] == 2*j + 1)
+                {
+                    x = chain + i + 1;
+                    x->i = i + 1;
+                    x->j = j;
+                    x->next = NULL;
+                    hind[x->i] = 2*(x->j + 1) + 0;
+
+                    if (bits <= FLINT_BITS)
+                        mpoly_monomial_add(exp_list[exp_next], Bexp + x->i*N,
+                                                          q_exp + x->j*N, N);
+                    else
+                        mpoly_monomial_add_mp(exp_list[exp_next],
+                                          Bexp + x->i*N, q_exp + x->j*N, N);
+
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+                }
+
+                /* should we go up? */
+                if (j + 1 == q_len)
+                {
+                    s++;
+                }
+                else if ((hind[i] & 1) == 1 &&
+                                  (i == 1 || hind[i - 1] >= 2*(j + 2) + 1))
+                {
+                    x = chain + i;
+                    x->i = i;
+                    x->j = j + 1;
+                    x->next = NULL;
+                    hind[x->i] = 2*(x->j + 1) + 0;
+
+                    if (bits <= FLINT_BITS)
+                        mpoly_monomial_add(exp_list[exp_next], Bexp + x->i*N,
+                                                          q_exp + x->j*N, N);
+                    else
+                        mpoly_monomial_add_mp(exp_list[exp_next],
+                                          Bexp + x->i*N, q_exp + x->j*N, N);
+
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+                }
+            }
+        }
+
+        if (fmpz_is_zero(q_coeff + q_len))
+            continue;
+
+        fmpz_mod_mul(q_coeff + q_len, q_coeff + q_len, lc_minus_inv, fpctx);
+
+        if (!lt_divides ||
+                mpoly_monomial_gt(Aexp + N*(Alen - 1), exp, N, cmpmask))
+        {
+            goto not_exact_division;
+        }
+
+        _fmpz_mod_mpoly_get_limbs(Qlimbs + nlimbs*q_len, q_coeff + q_len,
+                                                                   1, nlimbs);
+
+        if (s > 1)
+        {
+            i = 1;
+            x = chain + i;
+            x->i = i;
+            x->j = q_len;
+            x->next = NULL;
+            hind[x->i] = 2*(x->j + 1) + 0;
+
+            if (bits <= FLINT_BITS)
+                mpoly_monomial_add(exp_list[exp_next], Bexp + x->i*N,
+                                                          q_exp + x->j*N, N);
+            else
+                mpoly_monomial_add_mp(exp_list[exp_next], Bexp + x->i*N,
+                                                          q_exp + x->j*N, N);
+
+            exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+        }
+        s = 1;
+        q_len++;
+    }
+
+cleanup:
+
+    *Qcoeff = q_coeff;
+    *Qexp = q_exp;
+
+    flint_free(Alimbs);
+    flint_free(Qlimbs);
+    fmpz_clear(lc_minus_inv);
+
+    TMP_END;
+
+    return q_len;
+
+not_exact_division:
+
+    /* keep the coefficients past the returned length demoted */
+    for (i = 0; i <= q_len && i < *Qalloc; i++)
+        _fmpz_demote(q_coeff + i);
+    q_len = 0;
+    goto cleanup;
+}
+
+int fmpz_mod_mpoly_divides_monagan_pearce(fmpz_mod_mpoly_t Q,
+                          const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong i, N, Qlen = 0;
+    flint_bitcnt_t Qbits;
+    fmpz * maxAfields, * maxBfields;
+    ulong * cmpmask;
+    ulong * Aexp = A->exps, * Bexp = B->exps, * expq;
+    int easy_exit, freeAexp = 0, freeBexp = 0;
+    ulong mask = 0;
+    fmpz_mod_mpoly_struct * P, T[1];
+    TMP_INIT;
+
+    if (B->length == 0)
+    {
+        flint_throw(FLINT_DIVZERO,
+                 "Divide by zero in fmpz_mod_mpoly_divides_monagan_pearce");
+    }
+
+    if (A->length == 0)
+    {
+        fmpz_mod_mpoly_zero(Q, ctx);
+        return 1;
+    }
+
+    TMP_START;
+
+    maxAfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxAfields + i);
+        fmpz_init(maxBfields + i);
+    }
+
+    mpoly_max_fields_fmpz(maxAfields, A->exps, A->length, A->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+
+    /*
+        cannot be exact division if any max field from A
+        is less than corresponding max field from B
+    */
+    easy_exit = 0;
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        if (fmpz_cmp(maxAfields + i, maxBfields + i) < 0)
+            easy_exit = 1;
+    }
+
+    Qbits = _fmpz_vec_max_bits(maxAfields, ctx->minfo->nfields);
+    Qbits = FLINT_MAX(MPOLY_MIN_BITS, Qbits + 1);
+    Qbits = FLINT_MAX(Qbits, A->bits);
+    Qbits = FLINT_MAX(Qbits, B->bits);
+    Qbits = mpoly_fix_bits(Qbits, ctx->minfo);
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxAfields + i);
+        fmpz_clear(maxBfields + i);
+    }
+
+    if (easy_exit)
+        goto cleanup;
+
+    N = mpoly_words_per_exp(Qbits, ctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, Qbits, ctx->minfo);
+
+    /* temporary space to check leading monomials divide */
+    expq = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+
+    /* ensure input exponents packed to same size as output exponents */
+    if (Qbits > A->bits)
+    {
+        freeAexp = 1;
+        Aexp = (ulong *) flint_malloc(N*A->length*sizeof(ulong));
+        mpoly_repack_monomials(Aexp, Qbits, A->exps, A->bits,
+                                                        A->length, ctx->minfo);
+    }
+
+    if (Qbits > B->bits)
+    {
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Qbits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
+    }
+
+    /* check leading monomial divides exactly */
+    if (Qbits <= FLINT_BITS)
+    {
+        /* mask with high bit of each exponent vector field set */
+        for (i = 0; i < FLINT_BITS/Qbits; i++)
+            mask = (mask << Qbits) + (UWORD(1) << (Qbits - 1));
+
+        if (!mpoly_monomial_divides(expq, Aexp, Bexp, N, mask))
+            goto cleanup;
+    }
+    else
+    {
+        if (!mpoly_monomial_divides_mp(expq, Aexp, Bexp, N, Qbits))
+            goto cleanup;
+    }
+
+    /* deal with aliasing and divide polynomials */
+    if (Q == A || Q == B)
+    {
+        fmpz_mod_mpoly_init(T, ctx);
+        P = T;
+    }
+    else
+    {
+        P = Q;
+    }
+
+    fmpz_mod_mpoly_fit_length(P, A->length/B->length + 1, ctx);
+    fmpz_mod_mpoly_fit_bits(P, Qbits, ctx);
+    P->bits = Qbits;
+
+    Qlen = _fmpz_mod_mpoly_divides_monagan_pearce(&P->coeffs, &P->exps,
+                           &P->alloc, A->coeffs, Aexp, A->length,
+                           B->coeffs, Bexp, B->length, Qbits, N, cmpmask,
+                                                                 ctx->ffinfo);
+    if (Q == A || Q == B)
+    {
+        fmpz_mod_mpoly_swap(Q, T, ctx);
+        fmpz_mod_mpoly_clear(T, ctx);
+    }
+
+cleanup:
+
+    _fmpz_mod_mpoly_set_length(Q, Qlen, ctx);
+
+    if (freeAexp)
+        flint_free(Aexp);
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    TMP_END;
+
+    /* division is exact if Qlen is nonzero */
+    return Qlen != 0;
+}
@@ -0,0 +1,56 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mpoly.h"
+
+int fmpz_mod_mpoly_equal(const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    ulong * Aexp = A->exps, * Bexp = B->exps;
+    flint_bitcnt_t bits;
+    slong N;
+    int r, freeA = 0, freeB = 0;
+
+    if (A == B)
+        return 1;
+
+    if (A->length != B->length)
+        return 0;
+
+    bits = FLINT_MAX(A->bits, B->bits);
+    N = mpoly_words_per_exp(bits, ctx->minfo);
+
+    if (bits > A->bits)
+    {
+        freeA = 1;
+        Aexp = (ulong *) flint_malloc(N*A->length*sizeof(ulong));
+        mpoly_repack_monomials(Aexp, bits, A->exps, A->bits,
+                                                        A->length, ctx->minfo);
+    }
+
+    if (bits > B->bits)
+    {
+        freeB = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, bits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
+    }
+
+    r = _fmpz_mpoly_equal(A->coeffs, Aexp, B->coeffs, Bexp, B->length, N);
+
+    if (freeA)
+        flint_free(Aexp);
+
+    if (freeB)
+        flint_free(Bexp);
+
+    return r;
+}
@@ -0,0 +1,24 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_fit_length(fmpz_mod_mpoly_t A, slong len,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    if (len > A->alloc)
+    {
+        /* At least double number of allocated coeffs */
+        if (len < 2*A->alloc)
+            len = 2*A->alloc;
+        fmpz_mod_mpoly_realloc(A, len, ctx);
+    }
+}
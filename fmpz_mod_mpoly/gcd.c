@@ -0,0 +1,745 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "thread_pool.h"
+#include "fmpz_mod_mpoly.h"
+
+/*
+    The gcd is computed with Brown's dense algorithm in a LEX context. At
+    level k the inputs only involve x_0, ..., x_k. They are viewed as
+    polynomials in x_0, ..., x_{k-1} with coefficients in F_p[x_k], images
+    are computed by evaluating x_k at distinct points and calling the level
+    k - 1, and the images are interpolated in x_k. The images at the top
+    level are independent and are shared between threads.
+*/
+
+/*
+    A polynomial in x_0, ..., x_{k-1} with coefficients in F_p[x_k]. The
+    exponent vectors are those of a LEX fmpz_mod_mpoly with the field of x_k
+    cleared, so that the terms are sorted.
+*/
+typedef struct
+{
+    fmpz_mod_poly_struct * coeffs;
+    ulong * exps;
+    slong alloc;
+    slong length;
+}
+_mpolyn_struct;
+
+typedef _mpolyn_struct _mpolyn_t[1];
+
+static void _mpolyn_init(_mpolyn_t A)
+{
+    A->coeffs = NULL;
+    A->exps = NULL;
+    A->alloc = 0;
+    A->length = 0;
+}
+
+static void _mpolyn_clear(_mpolyn_t A)
+{
+    slong i;
+    for (i = 0; i < A->alloc; i++)
+        fmpz_mod_poly_clear(A->coeffs + i);
+    if (A->alloc > 0)
+    {
+        flint_free(A->coeffs);
+        flint_free(A->exps);
+    }
+}
+
+static void _mpolyn_swap(_mpolyn_t A, _mpolyn_t B)
+{
+    _mpolyn_struct t = *A;
+    *A = *B;
+    *B = t;
+}
+
+static void _mpolyn_fit_length(_mpolyn_t A, slong len, slong N,
+                                                               const fmpz_t p)
+{
+    slong i, new_alloc;
+
+    if (len <= A->alloc)
+        return;
+
+    new_alloc = FLINT_MAX(len, 2*A->alloc);
+    A->coeffs = (fmpz_mod_poly_struct *) flint_realloc(A->coeffs,
+                                      new_alloc*sizeof(fmpz_mod_poly_struct));
+    A->exps = (ulong *) flint_realloc(A->exps, new_alloc*N*sizeof(ulong));
+    for (i = A->alloc; i < new_alloc; i++)
+        fmpz_mod_poly_init(A->coeffs + i, p);
+    A->alloc = new_alloc;
+}
+
+static void _mpolyn_set(_mpolyn_t A, const _mpolyn_t B, slong N,
+                                                               const fmpz_t p)
+{
+    slong i;
+    _mpolyn_fit_length(A, B->length, N, p);
+    for (i = 0; i < B->length; i++)
+        fmpz_mod_poly_set(A->coeffs + i, B->coeffs + i);
+    mpoly_copy_monomials(A->exps, B->exps, B->length, N);
+    A->length = B->length;
+}
+
+/* x_k is the field at offset off and shift shift */
+static void _mpolyn_set_mpoly(_mpolyn_t A, const fmpz_mod_mpoly_t B,
+                                             slong off, slong shift, slong N,
+                                                 const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong i;
+    ulong e, fieldmask = (-UWORD(1)) >> (FLINT_BITS - B->bits);
+    ulong * Aexp;
+
+    A->length = 0;
+    for (i = 0; i < B->length; i++)
+    {
+        _mpolyn_fit_length(A, A->length + 1, N,
+                                              fmpz_mod_mpoly_ctx_modulus(ctx));
+        Aexp = A->exps + N*A->length;
+        mpoly_monomial_set(Aexp, B->exps + N*i, N);
+        e = (Aexp[off] >> shift) & fieldmask;
+        Aexp[off] &= ~(fieldmask << shift);
+
+        if (A->length > 0 && mpoly_monomial_equal(Aexp - N, Aexp, N))
+        {
+            fmpz_mod_poly_set_coeff_fmpz(A->coeffs + A->length - 1, e,
+                                                                B->coeffs + i);
+        }
+        else
+        {
+            fmpz_mod_poly_zero(A->coeffs + A->length);
+            fmpz_mod_poly_set_coeff_fmpz(A->coeffs + A->length, e,
+                                                                B->coeffs + i);
+            A->length++;
+        }
+    }
+}
+
+static void _mpolyn_get_mpoly(fmpz_mod_mpoly_t A, const _mpolyn_t B,
+                      slong off, slong shift, slong N, flint_bitcnt_t bits,
+                                                 const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong i, e, Alen = 0;
+
+    FLINT_ASSERT(A->bits == bits);
+
+    for (i = 0; i < B->length; i++)
+    {
+        const fmpz_mod_poly_struct * b = B->coeffs + i;
+        for (e = b->length - 1; e >= 0; e--)
+        {
+            if (fmpz_is_zero(b->coeffs + e))
+                continue;
+
+            fmpz_mod_mpoly_fit_length(A, Alen + 1, ctx);
+            mpoly_monomial_set(A->exps + N*Alen, B->exps + N*i, N);
+            (A->exps + N*Alen)[off] += ((ulong) e) << shift;
+            fmpz_set(A->coeffs + Alen, b->coeffs + e);
+            Alen++;
+        }
+    }
+
+    _fmpz_mod_mpoly_set_length(A, Alen, ctx);
+}
+
+/* A = B(x_k = alpha) */
+static void _mpolyn_evaluate(fmpz_mod_mpoly_t A, const _mpolyn_t B,
+                                           const fmpz_t alpha, slong N,
+                                                 const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong i, Alen = 0;
+
+    for (i = 0; i < B->length; i++)
+    {
+        fmpz_mod_mpoly_fit_length(A, Alen + 1, ctx);
+        fmpz_mod_poly_evaluate_fmpz(A->coeffs + Alen, B->coeffs + i, alpha);
+        mpoly_monomial_set(A->exps + N*Alen, B->exps + N*i, N);
+        Alen += !fmpz_is_zero(A->coeffs + Alen);
+    }
+
+    _fmpz_mod_mpoly_set_length(A, Alen, ctx);
+}
+
+static slong _mpolyn_degree(const _mpolyn_t A)
+{
+    slong i, deg = -WORD(1);
+    for (i = 0; i < A->length; i++)
+        deg = FLINT_MAX(deg, fmpz_mod_poly_degree(A->coeffs + i));
+    return deg;
+}
+
+/* c = monic gcd of the coefficients of A */
+static void _mpolyn_content(fmpz_mod_poly_t c, const _mpolyn_t A)
+{
+    slong i;
+
+    fmpz_mod_poly_zero(c);
+    for (i = 0; i < A->length; i++)
+    {
+        fmpz_mod_poly_gcd(c, c, A->coeffs + i);
+        if (fmpz_mod_poly_degree(c) == 0)
+            break;
+    }
+}
+
+static void _mpolyn_divexact_poly(_mpolyn_t A, const fmpz_mod_poly_t c,
+                                                         fmpz_mod_poly_t t)
+{
+    slong i;
+
+    if (fmpz_mod_poly_degree(c) == 0)
+        return;
+
+    for (i = 0; i < A->length; i++)
+    {
+        fmpz_mod_poly_div_basecase(t, A->coeffs + i, c);
+        fmpz_mod_poly_swap(t, A->coeffs + i);
+    }
+}
+
+/* A = B as a polynomial with constant coefficients */
+static void _mpolyn_set_const_coeffs(_mpolyn_t A, const fmpz_mod_mpoly_t B,
+                                                 slong N, const fmpz_t p)
+{
+    slong i;
+    _mpolyn_fit_length(A, B->length, N, p);
+    for (i = 0; i < B->length; i++)
+        fmpz_mod_poly_set_fmpz(A->coeffs + i, B->coeffs + i);
+    mpoly_copy_monomials(A->exps, B->exps, B->length, N);
+    A->length = B->length;
+}
+
+/*
+    Update A so that it reduces to its old value modulo the modulus M and to
+    B modulo x_k - alpha. Ms is M/M(alpha).
+*/
+static void _mpolyn_interp_crt(_mpolyn_t A, const fmpz_mod_mpoly_t B,
+                    const fmpz_mod_poly_t Ms, const fmpz_t alpha, slong N,
+                           const ulong * cmpmask, const fmpz_mod_ctx_t fpctx)
+{
+    slong i = 0, j = 0;
+    int cmp;
+    fmpz_t v;
+    fmpz_mod_poly_t t;
+    _mpolyn_t T;
+
+    fmpz_init(v);
+    fmpz_mod_poly_init(t, fmpz_mod_ctx_modulus(fpctx));
+    _mpolyn_init(T);
+
+    while (i < A->length || j < B->length)
+    {
+        fmpz_mod_poly_struct * Tc;
+
+        _mpolyn_fit_length(T, T->length + 1, N, fmpz_mod_ctx_modulus(fpctx));
+        Tc = T->coeffs + T->length;
+
+        if (j >= B->length)
+            cmp = 1;
+        else if (i >= A->length)
+            cmp = -1;
+        else
+            cmp = mpoly_monomial_cmp(A->exps + N*i, B->exps + N*j, N, cmpmask);
+
+        if (cmp > 0)
+        {
+            /* the coefficient of B is zero */
+            fmpz_mod_poly_evaluate_fmpz(v, A->coeffs + i, alpha);
+            fmpz_mod_neg(v, v, fpctx);
+            fmpz_mod_poly_scalar_mul_fmpz(t, Ms, v);
+            fmpz_mod_poly_add(Tc, A->coeffs + i, t);
+            mpoly_monomial_set(T->exps + N*T->length, A->exps + N*i, N);
+            i++;
+        }
+        else if (cmp < 0)
+        {
+            /* the coefficient of A is zero */
+            fmpz_mod_poly_scalar_mul_fmpz(Tc, Ms, B->coeffs + j);
+            mpoly_monomial_set(T->exps + N*T->length, B->exps + N*j, N);
+            j++;
+        }
+        else
+        {
+            fmpz_mod_poly_evaluate_fmpz(v, A->coeffs + i, alpha);
+            fmpz_mod_sub(v, B->coeffs + j, v, fpctx);
+            fmpz_mod_poly_scalar_mul_fmpz(t, Ms, v);
+            fmpz_mod_poly_add(Tc, A->coeffs + i, t);
+            mpoly_monomial_set(T->exps + N*T->length, A->exps + N*i, N);
+            i++;
+            j++;
+        }
+
+        T->length += !fmpz_mod_poly_is_zero(Tc);
+    }
+
+    _mpolyn_swap(A, T);
+
+    _mpolyn_clear(T);
+    fmpz_mod_poly_clear(t);
+    fmpz_clear(v);
+}
+
+
+static int _gcd_brown(fmpz_mod_mpoly_t G, const fmpz_mod_mpoly_t A,
+                          const fmpz_mod_mpoly_t B, slong k,
+                                                const fmpz_mod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+/* one image of the gcd at the point alpha */
+typedef struct
+{
+    fmpz_t alpha;
+    fmpz_mod_mpoly_struct Ga[1];
+    int success;
+    const _mpolyn_struct * An;
+    const _mpolyn_struct * Bn;
+    const fmpz_mod_poly_struct * gamma;
+    slong k;
+    flint_bitcnt_t bits;
+    slong N;
+    const fmpz_mod_mpoly_ctx_struct * ctx;
+}
+_image_arg_struct;
+
+static void _image_worker(void * varg)
+{
+    _image_arg_struct * arg = (_image_arg_struct *) varg;
+    const fmpz_mod_mpoly_ctx_struct * ctx = arg->ctx;
+    flint_bitcnt_t bits = arg->bits;
+    fmpz_mod_mpoly_t Ae, Be;
+    fmpz_t g;
+
+    fmpz_init(g);
+    fmpz_mod_mpoly_init3(Ae, 0, bits, ctx);
+    fmpz_mod_mpoly_init3(Be, 0, bits, ctx);
+
+    _mpolyn_evaluate(Ae, arg->An, arg->alpha, arg->N, ctx);
+    _mpolyn_evaluate(Be, arg->Bn, arg->alpha, arg->N, ctx);
+
+    arg->success = _gcd_brown(arg->Ga, Ae, Be, arg->k - 1, ctx, NULL, 0);
+    if (arg->success)
+    {
+        /* normalize the image to have leading coefficient gamma(alpha) */
+        fmpz_mod_poly_evaluate_fmpz(g, arg->gamma, arg->alpha);
+        fmpz_mod_mpoly_make_monic(arg->Ga, arg->Ga, ctx);
+        fmpz_mod_mpoly_scalar_mul_fmpz(arg->Ga, arg->Ga, g, ctx);
+    }
+
+    fmpz_mod_mpoly_clear(Ae, ctx);
+    fmpz_mod_mpoly_clear(Be, ctx);
+    fmpz_clear(g);
+}
+
+/*
+    G = gcd(A, B) up to a unit, where A and B are nonzero, only involve
+    x_0, ..., x_k and have the same number of bits.
+    Return 1 for success and 0 if the evaluation points ran out.
+*/
+static int _gcd_brown(fmpz_mod_mpoly_t G, const fmpz_mod_mpoly_t A,
+                          const fmpz_mod_mpoly_t B, slong k,
+                                                const fmpz_mod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    int success;
+    flint_bitcnt_t bits = A->bits;
+    slong N = mpoly_words_per_exp_sp(bits, ctx->minfo);
+    slong i, off, shift, degA, degB, bound, nimages;
+    const fmpz * p = fmpz_mod_mpoly_ctx_modulus(ctx);
+    ulong * cmpmask;
+    fmpz_t alpha, v;
+    fmpz_mod_poly_t cA, cB, c, gamma, M, Ms, t;
+    fmpz_mod_mpoly_t Ap, Bp, Hm, Q;
+    _mpolyn_t An, Bn, H, Hp;
+    _image_arg_struct * images;
+    TMP_INIT;
+
+    FLINT_ASSERT(A->length > 0 && B->length > 0);
+    FLINT_ASSERT(A->bits == B->bits);
+
+    TMP_START;
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, bits, ctx->minfo);
+    mpoly_gen_offset_shift_sp(&off, &shift, k, bits, ctx->minfo);
+
+    fmpz_init(alpha);
+    fmpz_init(v);
+    fmpz_mod_poly_init(cA, p);
+    fmpz_mod_poly_init(cB, p);
+    fmpz_mod_poly_init(c, p);
+    fmpz_mod_poly_init(gamma, p);
+    fmpz_mod_poly_init(M, p);
+    fmpz_mod_poly_init(Ms, p);
+    fmpz_mod_poly_init(t, p);
+    fmpz_mod_mpoly_init3(Ap, 0, bits, ctx);
+    fmpz_mod_mpoly_init3(Bp, 0, bits, ctx);
+    fmpz_mod_mpoly_init3(Hm, 0, bits, ctx);
+    fmpz_mod_mpoly_init3(Q, 0, bits, ctx);
+    _mpolyn_init(An);
+    _mpolyn_init(Bn);
+    _mpolyn_init(H);
+    _mpolyn_init(Hp);
+
+    fmpz_mod_mpoly_fit_bits(G, bits, ctx);
+    G->bits = bits;
+
+    _mpolyn_set_mpoly(An, A, off, shift, N, ctx);
+    _mpolyn_set_mpoly(Bn, B, off, shift, N, ctx);
+
+    /* the content in F_p[x_k] */
+    _mpolyn_content(cA, An);
+    _mpolyn_content(cB, Bn);
+    fmpz_mod_poly_gcd(c, cA, cB);
+
+    if (k == 0)
+    {
+        /* univariate: An and Bn are constant in x_0, ..., x_{k-1} */
+        _mpolyn_fit_length(H, 1, N, p);
+        fmpz_mod_poly_swap(H->coeffs + 0, c);
+        mpoly_monomial_zero(H->exps + 0, N);
+        H->length = 1;
+        _mpolyn_get_mpoly(G, H, off, shift, N, bits, ctx);
+        success = 1;
+        goto cleanup;
+    }
+
+    _mpolyn_divexact_poly(An, cA, t);
+    _mpolyn_divexact_poly(Bn, cB, t);
+
+    /* H holds the content as a polynomial for the final multiplication */
+    _mpolyn_fit_length(H, 1, N, p);
+    fmpz_mod_poly_set(H->coeffs + 0, c);
+    mpoly_monomial_zero(H->exps + 0, N);
+    H->length = 1;
+    _mpolyn_get_mpoly(Q, H, off, shift, N, bits, ctx);
+    H->length = 0;
+
+    degA = _mpolyn_degree(An);
+    degB = _mpolyn_degree(Bn);
+
+    if (degA == 0 && degB == 0)
+    {
+        /* the primitive parts do not involve x_k */
+        fmpz_zero(alpha);
+        _mpolyn_evaluate(Ap, An, alpha, N, ctx);
+        _mpolyn_evaluate(Bp, Bn, alpha, N, ctx);
+        success = _gcd_brown(Hm, Ap, Bp, k - 1, ctx, handles, num_handles);
+        if (success)
+            fmpz_mod_mpoly_mul(G, Hm, Q, ctx);
+        goto cleanup;
+    }
+
+    _mpolyn_get_mpoly(Ap, An, off, shift, N, bits, ctx);
+    _mpolyn_get_mpoly(Bp, Bn, off, shift, N, bits, ctx);
+
+    fmpz_mod_poly_gcd(gamma, An->coeffs + 0, Bn->coeffs + 0);
+    bound = FLINT_MIN(degA, degB) + fmpz_mod_poly_degree(gamma);
+
+    nimages = num_handles + 1;
+    images = (_image_arg_struct *) flint_malloc(nimages
+                                                  *sizeof(_image_arg_struct));
+    for (i = 0; i < nimages; i++)
+    {
+        fmpz_init(images[i].alpha);
+        fmpz_mod_mpoly_init3(images[i].Ga, 0, bits, ctx);
+        images[i].An = An;
+        images[i].Bn = Bn;
+        images[i].gamma = gamma;
+        images[i].k = k;
+        images[i].bits = bits;
+        images[i].N = N;
+        images[i].ctx = ctx;
+    }
+
+    fmpz_mod_poly_set_ui(M, 1);
+    fmpz_zero(alpha);
+
+    while (1)
+    {
+        slong n;
+
+        /* choose the next points where the leading coefficients survive */
+        for (n = 0; n < nimages; n++)
+        {
+            do {
+                fmpz_add_ui(alpha, alpha, 1);
+                if (fmpz_cmp(alpha, p) >= 0)
+                    break;
+                fmpz_mod_poly_evaluate_fmpz(v, An->coeffs + 0, alpha);
+                if (fmpz_is_zero(v))
+                    continue;
+                fmpz_mod_poly_evaluate_fmpz(v, Bn->coeffs + 0, alpha);
+            } while (fmpz_is_zero(v));
+
+            if (fmpz_cmp(alpha, p) >= 0)
+                break;
+
+            fmpz_set(images[n].alpha, alpha);
+        }
+
+        if (n == 0)
+        {
+            success = 0;
+            goto cleanup_images;
+        }
+
+        /* compute the images */
+        for (i = 0; i + 1 < n; i++)
+        {
+            thread_pool_wake(global_thread_pool, handles[i],
+                                                   _image_worker, images + i);
+        }
+        _image_worker(images + n - 1);
+        for (i = 0; i + 1 < n; i++)
+        {
+            thread_pool_wait(global_thread_pool, handles[i]);
+        }
+
+        /* combine the images in order */
+        for (i = 0; i < n; i++)
+        {
+            fmpz_mod_mpoly_struct * Ga = images[i].Ga;
+            int cmp;
+
+            if (!images[i].success)
+            {
+                success = 0;
+                goto cleanup_images;
+            }
+
+            if (Ga->length == 1 && mpoly_monomial_is_zero(Ga->exps + 0, N))
+            {
+                /* the primitive parts are coprime */
+                fmpz_mod_mpoly_swap(G, Q, ctx);
+                success = 1;
+                goto cleanup_images;
+            }
+
+            cmp = (H->length == 0) ? -1 :
+                   mpoly_monomial_cmp(Ga->exps + 0, H->exps + 0, N, cmpmask);
+
+            if (cmp > 0)
+            {
+                /* unlucky point */
+                continue;
+            }
+            else if (cmp < 0)
+            {
+                /* all previous points were unlucky */
+                _mpolyn_set_const_coeffs(H, Ga, N, p);
+                fmpz_mod_poly_zero(M);
+                fmpz_mod_poly_set_coeff_ui(M, 1, 1);
+                fmpz_mod_neg(v, images[i].alpha, ctx->ffinfo);
+                fmpz_mod_poly_set_coeff_fmpz(M, 0, v);
+            }
+            else
+            {
+                fmpz_mod_poly_evaluate_fmpz(v, M, images[i].alpha);
+                fmpz_mod_inv(v, v, ctx->ffinfo);
+                fmpz_mod_poly_scalar_mul_fmpz(Ms, M, v);
+                _mpolyn_interp_crt(H, Ga, Ms, images[i].alpha, N, cmpmask,
+                                                                  ctx->ffinfo);
+                fmpz_mod_poly_zero(t);
+                fmpz_mod_poly_set_coeff_ui(t, 1, 1);
+                fmpz_mod_neg(v, images[i].alpha, ctx->ffinfo);
+                fmpz_mod_poly_set_coeff_fmpz(t, 0, v);
+                fmpz_mod_poly_mul(M, M, t);
+            }
+
+            if (fmpz_mod_poly_degree(M) <= bound)
+                continue;
+
+            /* the primitive part of H is a candidate for the gcd */
+            _mpolyn_set(Hp, H, N, p);
+            _mpolyn_content(t, Hp);
+            _mpolyn_divexact_poly(Hp, t, Ms);
+            if (_mpolyn_degree(Hp) > FLINT_MIN(degA, degB))
+                continue;
+
+            _mpolyn_get_mpoly(Hm, Hp, off, shift, N, bits, ctx);
+            if (fmpz_mod_mpoly_divides(G, Ap, Hm, ctx) &&
+                fmpz_mod_mpoly_divides(G, Bp, Hm, ctx))
+            {
+                fmpz_mod_mpoly_mul(G, Hm, Q, ctx);
+                success = 1;
+                goto cleanup_images;
+            }
+        }
+    }
+
+cleanup_images:
+
+    for (i = 0; i < nimages; i++)
+    {
+        fmpz_clear(images[i].alpha);
+        fmpz_mod_mpoly_clear(images[i].Ga, ctx);
+    }
+    flint_free(images);
+
+cleanup:
+
+    /* the images are compared as exponent vectors of the same size */
+    if (success && G->bits != bits)
+        fmpz_mod_mpoly_repack_bits(G, G, bits, ctx);
+
+    fmpz_clear(alpha);
+    fmpz_clear(v);
+    fmpz_mod_poly_clear(cA);
+    fmpz_mod_poly_clear(cB);
+    fmpz_mod_poly_clear(c);
+    fmpz_mod_poly_clear(gamma);
+    fmpz_mod_poly_clear(M);
+    fmpz_mod_poly_clear(Ms);
+    fmpz_mod_poly_clear(t);
+    fmpz_mod_mpoly_clear(Ap, ctx);
+    fmpz_mod_mpoly_clear(Bp, ctx);
+    fmpz_mod_mpoly_clear(Hm, ctx);
+    fmpz_mod_mpoly_clear(Q, ctx);
+    _mpolyn_clear(An);
+    _mpolyn_clear(Bn);
+    _mpolyn_clear(H);
+    _mpolyn_clear(Hp);
+
+    TMP_END;
+
+    return success;
+}
+
+/* A = B with the exponents repacked into Abits under the ordering of Actx */
+static void _convert_ordering(fmpz_mod_mpoly_t A, flint_bitcnt_t Abits,
+                   const fmpz_mod_mpoly_ctx_t Actx, const fmpz_mod_mpoly_t B,
+                                                const fmpz_mod_mpoly_ctx_t Bctx)
+{
+    slong i, NA, NB;
+    ulong * exp;
+    TMP_INIT;
+
+    TMP_START;
+    exp = (ulong *) TMP_ALLOC(Bctx->minfo->nvars*sizeof(ulong));
+
+    NA = mpoly_words_per_exp(Abits, Actx->minfo);
+    NB = mpoly_words_per_exp(B->bits, Bctx->minfo);
+
+    fmpz_mod_mpoly_fit_length(A, B->length, Actx);
+    fmpz_mod_mpoly_fit_bits(A, Abits, Actx);
+    A->bits = Abits;
+
+    for (i = 0; i < B->length; i++)
+    {
+        fmpz_set(A->coeffs + i, B->coeffs + i);
+        mpoly_get_monomial_ui(exp, B->exps + NB*i, B->bits, Bctx->minfo);
+        mpoly_set_monomial_ui(A->exps + NA*i, exp, Abits, Actx->minfo);
+    }
+    _fmpz_mod_mpoly_set_length(A, B->length, Actx);
+
+    fmpz_mod_mpoly_sort_terms(A, Actx);
+
+    TMP_END;
+}
+
+int fmpz_mod_mpoly_gcd_threaded(fmpz_mod_mpoly_t G,
+                          const fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                            const fmpz_mod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    int success;
+    slong i, nvars = ctx->minfo->nvars;
+    flint_bitcnt_t bits, lbits;
+    fmpz_mod_mpoly_ctx_t lctx;
+    fmpz_mod_mpoly_t Al, Bl, Gl;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    if (A->length == 0)
+    {
+        if (B->length == 0)
+            fmpz_mod_mpoly_zero(G, ctx);
+        else
+            fmpz_mod_mpoly_make_monic(G, B, ctx);
+        return 1;
+    }
+
+    if (B->length == 0)
+    {
+        fmpz_mod_mpoly_make_monic(G, A, ctx);
+        return 1;
+    }
+
+    if (A->bits > FLINT_BITS || B->bits > FLINT_BITS)
+        return 0;
+
+    if (nvars < 1)
+    {
+        fmpz_mod_mpoly_one(G, ctx);
+        return 1;
+    }
+
+    fmpz_mod_mpoly_ctx_init(lctx, nvars, ORD_LEX,
+                                              fmpz_mod_mpoly_ctx_modulus(ctx));
+
+    /* the packing must be valid for lctx, which may have fewer fields */
+    bits = FLINT_MAX(A->bits, B->bits);
+    lbits = mpoly_fix_bits(bits, lctx->minfo);
+    fmpz_mod_mpoly_init3(Al, 0, lbits, lctx);
+    fmpz_mod_mpoly_init3(Bl, 0, lbits, lctx);
+    fmpz_mod_mpoly_init3(Gl, 0, lbits, lctx);
+
+    _convert_ordering(Al, lbits, lctx, A, ctx);
+    _convert_ordering(Bl, lbits, lctx, B, ctx);
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    success = _gcd_brown(Gl, Al, Bl, nvars - 1, lctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+    if (success)
+    {
+        /* the gcd divides A, so its exponents fit into bits */
+        _convert_ordering(G, bits, ctx, Gl, lctx);
+        fmpz_mod_mpoly_make_monic(G, G, ctx);
+    }
+
+    fmpz_mod_mpoly_clear(Al, lctx);
+    fmpz_mod_mpoly_clear(Bl, lctx);
+    fmpz_mod_mpoly_clear(Gl, lctx);
+    fmpz_mod_mpoly_ctx_clear(lctx);
+
+    return success;
+}
+
+int fmpz_mod_mpoly_gcd(fmpz_mod_mpoly_t G, const fmpz_mod_mpoly_t A,
+                     const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    return fmpz_mod_mpoly_gcd_threaded(G, A, B, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+}
@@ -0,0 +1,25 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_mul_threaded(fmpz_mod_mpoly_t A,
+                          const fmpz_mod_mpoly_t B, const fmpz_mod_mpoly_t C,
+                            const fmpz_mod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    /* the heap method falls back to Johnson's method without helpers */
+    fmpz_mod_mpoly_mul_heap_threaded(A, B, C, ctx, thread_limit);
+}
+
+void fmpz_mod_mpoly_mul(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                     const fmpz_mod_mpoly_t C, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    fmpz_mod_mpoly_mul_threaded(A, B, C, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+}
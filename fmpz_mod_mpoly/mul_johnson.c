@@ -0,0 +1,412 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+/*
+    Set A to B*C using Johnson's heap method. The output is reallocated as
+    needed and the length of the product is returned. The exponent vectors
+    are assumed to fit in a single word. Assumes B and C are nonzero.
+
+    The coefficients are converted to arrays of s limbs once, and the sum of
+    products for each output term is accumulated in 2*s + 1 limbs without any
+    reduction until the term is complete.
+*/
+static slong _fmpz_mod_mpoly_mul_johnson1(
+                       fmpz ** Acoeff, ulong ** Aexp, slong * Aalloc,
+                       const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                       const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                                     ulong maskhi, const fmpz_mod_ctx_t fpctx)
+{
+    slong i, j, k;
+    slong next_loc;
+    slong Q_len = 0, heap_len = 2; /* heap zero index unused */
+    mpoly_heap1_s * heap;
+    mpoly_heap_t * chain;
+    slong * Q;
+    mpoly_heap_t * x;
+    fmpz * p1 = *Acoeff;
+    ulong * e1 = *Aexp;
+    slong * hind;
+    ulong exp;
+    slong s = fmpz_size(fmpz_mod_ctx_modulus(fpctx));
+    mp_limb_t * Blimbs, * Climbs, * acc, * t;
+    TMP_INIT;
+
+    TMP_START;
+
+    next_loc = Blen + 4;   /* something bigger than heap can ever be */
+    heap = (mpoly_heap1_s *) TMP_ALLOC((Blen + 1)*sizeof(mpoly_heap1_s));
+    chain = (mpoly_heap_t *) TMP_ALLOC(Blen*sizeof(mpoly_heap_t));
+    Q = (slong *) TMP_ALLOC(2*Blen*sizeof(slong));
+    hind = (slong *) TMP_ALLOC(Blen*sizeof(slong));
+    for (i = 0; i < Blen; i++)
+        hind[i] = 1;
+
+    Blimbs = (mp_limb_t *) flint_malloc(s*(Blen + Clen)*sizeof(mp_limb_t));
+    Climbs = Blimbs + s*Blen;
+    _fmpz_mod_mpoly_get_limbs(Blimbs, Bcoeff, Blen, s);
+    _fmpz_mod_mpoly_get_limbs(Climbs, Ccoeff, Clen, s);
+    acc = (mp_limb_t *) TMP_ALLOC((4*s + 1)*sizeof(mp_limb_t));
+    t = acc + 2*s + 1;
+
+    /* put (0, 0, Bexp[0] + Cexp[0]) on heap */
+    x = chain + 0;
+    x->i = 0;
+    x->j = 0;
+    x->next = NULL;
+
+    HEAP_ASSIGN(heap[1], Bexp[0] + Cexp[0], x);
+    hind[0] = 2*1 + 0;
+
+    k = -WORD(1);
+
+    while (heap_len > 1)
+    {
+        exp = heap[1].exp;
+
+        k++;
+        _fmpz_mpoly_fit_length(&p1, &e1, Aalloc, k + 1, 1);
+        e1[k] = exp;
+
+        flint_mpn_zero(acc, 2*s + 1);
+
+        while (heap_len > 1 && heap[1].exp == exp)
+        {
+            x = _mpoly_heap_pop1(heap, &heap_len, maskhi);
+
+            do {
+                _fmpz_mod_mpoly_addmul_limbs(acc, Blimbs + s*x->i,
+                                                     Climbs + s*x->j, s, t);
+                hind[x->i] |= WORD(1);
+                Q[Q_len++] = x->i;
+                Q[Q_len++] = x->j;
+            } while ((x = x->next) != NULL);
+        }
+
+        while (Q_len > 0)
+        {
+            j = Q[--Q_len];
+            i = Q[--Q_len];
+
+            /* should we go right? */
+            if (i + 1 < Blen && hind[i + 1] == 2*j + 1)
+            {
+                x = chain + i + 1;
+                x->i = i + 1;
+                x->j = j;
+                x->next = NULL;
+                hind[x->i] = 2*(x->j + 1) + 0;
+                _mpoly_heap_insert1(heap, Bexp[x->i] + Cexp[x->j], x,
+                                                 &next_loc, &heap_len, maskhi);
+            }
+
+            /* should we go up? */
+            if (j + 1 < Clen && (hind[i] & 1) == 1 &&
+                               (i == 0 || hind[i - 1] >= 2*(j + 2) + 1))
+            {
+                x = chain + i;
+                x->i = i;
+                x->j = j + 1;
+                x->next = NULL;
+                hind[x->i] = 2*(x->j + 1) + 0;
+                _mpoly_heap_insert1(heap, Bexp[x->i] + Cexp[x->j], x,
+                                                 &next_loc, &heap_len, maskhi);
+            }
+        }
+
+        _fmpz_mod_mpoly_reduce_limbs(p1 + k, acc, s, fpctx);
+        k -= fmpz_is_zero(p1 + k);
+    }
+
+    k++;
+
+    (*Acoeff) = p1;
+    (*Aexp) = e1;
+
+    flint_free(Blimbs);
+
+    TMP_END;
+
+    return k;
+}
+
+/* the exponent vectors take N words */
+slong _fmpz_mod_mpoly_mul_johnson(
+                       fmpz ** Acoeff, ulong ** Aexp, slong * Aalloc,
+                       const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                       const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                          flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                                    const fmpz_mod_ctx_t fpctx)
+{
+    slong i, j, k;
+    slong next_loc;
+    slong Q_len = 0, heap_len = 2; /* heap zero index unused */
+    mpoly_heap_s * heap;
+    mpoly_heap_t * chain;
+    slong * Q;
+    mpoly_heap_t * x;
+    fmpz * p1 = *Acoeff;
+    ulong * e1 = *Aexp;
+    ulong * exp, * exps;
+    ulong ** exp_list;
+    slong exp_next;
+    slong * hind;
+    slong s = fmpz_size(fmpz_mod_ctx_modulus(fpctx));
+    mp_limb_t * Blimbs, * Climbs, * acc, * t;
+    TMP_INIT;
+
+    if (N == 1)
+        return _fmpz_mod_mpoly_mul_johnson1(Acoeff, Aexp, Aalloc,
+                    Bcoeff, Bexp, Blen, Ccoeff, Cexp, Clen, cmpmask[0], fpctx);
+
+    TMP_START;
+
+    next_loc = Blen + 4;   /* something bigger than heap can ever be */
+    heap = (mpoly_heap_s *) TMP_ALLOC((Blen + 1)*sizeof(mpoly_heap_s));
+    chain = (mpoly_heap_t *) TMP_ALLOC(Blen*sizeof(mpoly_heap_t));
+    Q = (slong *) TMP_ALLOC(2*Blen*sizeof(slong));
+    exps = (ulong *) TMP_ALLOC(Blen*N*sizeof(ulong));
+    exp_list = (ulong **) TMP_ALLOC(Blen*sizeof(ulong *));
+    for (i = 0; i < Blen; i++)
+        exp_list[i] = exps + i*N;
+    hind = (slong *) TMP_ALLOC(Blen*sizeof(slong));
+    for (i = 0; i < Blen; i++)
+        hind[i] = 1;
+
+    Blimbs = (mp_limb_t *) flint_malloc(s*(Blen + Clen)*sizeof(mp_limb_t));
+    Climbs = Blimbs + s*Blen;
+    _fmpz_mod_mpoly_get_limbs(Blimbs, Bcoeff, Blen, s);
+    _fmpz_mod_mpoly_get_limbs(Climbs, Ccoeff, Clen, s);
+    acc = (mp_limb_t *) TMP_ALLOC((4*s + 1)*sizeof(mp_limb_t));
+    t = acc + 2*s + 1;
+
+    exp_next = 0;
+
+    /* put (0, 0, Bexp[0] + Cexp[0]) on heap */
+    x = chain + 0;
+    x->i = 0;
+    x->j = 0;
+    x->next = NULL;
+
+    heap[1].next = x;
+    heap[1].exp = exp_list[exp_next++];
+
+    if (bits <= FLINT_BITS)
+        mpoly_monomial_add(heap[1].exp, Bexp, Cexp, N);
+    else
+        mpoly_monomial_add_mp(heap[1].exp, Bexp, Cexp, N);
+
+    hind[0] = 2*1 + 0;
+
+    k = -WORD(1);
+
+    while (heap_len > 1)
+    {
+        exp = heap[1].exp;
+
+        k++;
+        _fmpz_mpoly_fit_length(&p1, &e1, Aalloc, k + 1, N);
+        mpoly_monomial_set(e1 + k*N, exp, N);
+
+        flint_mpn_zero(acc, 2*s + 1);
+
+        while (heap_len > 1 && mpoly_monomial_equal(heap[1].exp, exp, N))
+        {
+            exp_list[--exp_next] = heap[1].exp;
+
+            x = _mpoly_heap_pop(heap, &heap_len, N, cmpmask);
+
+            do {
+                _fmpz_mod_mpoly_addmul_limbs(acc, Blimbs + s*x->i,
+                                                     Climbs + s*x->j, s, t);
+                hind[x->i] |= WORD(1);
+                Q[Q_len++] = x->i;
+                Q[Q_len++] = x->j;
+            } while ((x = x->next) != NULL);
+        }
+
+        while (Q_len > 0)
+        {
+            j = Q[--Q_len];
+            i = Q[--Q_len];
+
+            /* should we go right? */
+            if (i + 1 < Blen && hind[i + 1] == 2*j + 1)
+            {
+                x = chain + i + 1;
+                x->i = i + 1;
+                x->j = j;
+                x->next = NULL;
+                hind[x->i] = 2*(x->j + 1) + 0;
+
+                if (bits <= FLINT_BITS)
+                    mpoly_monomial_add(exp_list[exp_next], Bexp + x->i*N,
+                                                           Cexp + x->j*N, N);
+                else
+                    mpoly_monomial_add_mp(exp_list[exp_next], Bexp + x->i*N,
+                                                           Cexp + x->j*N, N);
+
+                exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+            }
+
+            /* should we go up? */
+            if (j + 1 < Clen && (hind[i] & 1) == 1 &&
+                               (i == 0 || hind[i - 1] >= 2*(j + 2) + 1))
+            {
+                x = chain + i;
+                x->i = i;
+                x->j = j + 1;
+                x->next = NULL;
+                hind[x->i] = 2*(x->j + 1) + 0;
+
+                if (bits <= FLINT_BITS)
+                    mpoly_monomial_add(exp_list[exp_next], Bexp + x->i*N,
+                                                           Cexp + x->j*N, N);
+                else
+                    mpoly_monomial_add_mp(exp_list[exp_next], Bexp + x->i*N,
+                                                           Cexp + x->j*N, N);
+
+                exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+            }
+        }
+
+        _fmpz_mod_mpoly_reduce_limbs(p1 + k, acc, s, fpctx);
+        k -= fmpz_is_zero(p1 + k);
+    }
+
+    k++;
+
+    (*Acoeff) = p1;
+    (*Aexp) = e1;
+
+    flint_free(Blimbs);
+
+    TMP_END;
+
+    return k;
+}
+
+void fmpz_mod_mpoly_mul_johnson(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                     const fmpz_mod_mpoly_t C, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong i, N, Alen;
+    flint_bitcnt_t Abits;
+    fmpz * maxBfields, * maxCfields;
+    ulong * cmpmask;
+    ulong * Bexp, * Cexp;
+    int freeBexp, freeCexp;
+    fmpz_mod_mpoly_struct * P, T[1];
+    TMP_INIT;
+
+    if (B->length == 0 || C->length == 0)
+    {
+        fmpz_mod_mpoly_zero(A, ctx);
+        return;
+    }
+
+    TMP_START;
+
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxCfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxBfields + i);
+        fmpz_init(maxCfields + i);
+    }
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
+    _fmpz_vec_add(maxBfields, maxBfields, maxCfields, ctx->minfo->nfields);
+
+    Abits = _fmpz_vec_max_bits(maxBfields, ctx->minfo->nfields);
+    Abits = FLINT_MAX(MPOLY_MIN_BITS, Abits + 1);
+    Abits = FLINT_MAX(Abits, B->bits);
+    Abits = FLINT_MAX(Abits, C->bits);
+    Abits = mpoly_fix_bits(Abits, ctx->minfo);
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxBfields + i);
+        fmpz_clear(maxCfields + i);
+    }
+
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
+
+    /* ensure input exponents are packed into same sized fields as output */
+    freeBexp = 0;
+    Bexp = B->exps;
+    if (Abits > B->bits)
+    {
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
+    }
+
+    freeCexp = 0;
+    Cexp = C->exps;
+    if (Abits > C->bits)
+    {
+        freeCexp = 1;
+        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits,
+                                                        C->length, ctx->minfo);
+    }
+
+    if (A == B || A == C)
+    {
+        fmpz_mod_mpoly_init(T, ctx);
+        P = T;
+    }
+    else
+    {
+        P = A;
+    }
+
+    fmpz_mod_mpoly_fit_length(P, B->length + C->length - 1, ctx);
+    fmpz_mod_mpoly_fit_bits(P, Abits, ctx);
+    P->bits = Abits;
+
+    /* algorithm more efficient if smaller poly first */
+    if (B->length > C->length)
+    {
+        Alen = _fmpz_mod_mpoly_mul_johnson(&P->coeffs, &P->exps, &P->alloc,
+                                        C->coeffs, Cexp, C->length,
+                                        B->coeffs, Bexp, B->length,
+                                             Abits, N, cmpmask, ctx->ffinfo);
+    }
+    else
+    {
+        Alen = _fmpz_mod_mpoly_mul_johnson(&P->coeffs, &P->exps, &P->alloc,
+                                        B->coeffs, Bexp, B->length,
+                                        C->coeffs, Cexp, C->length,
+                                             Abits, N, cmpmask, ctx->ffinfo);
+    }
+
+    if (A == B || A == C)
+    {
+        fmpz_mod_mpoly_swap(A, T, ctx);
+        fmpz_mod_mpoly_clear(T, ctx);
+    }
+
+    _fmpz_mod_mpoly_set_length(A, Alen, ctx);
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    if (freeCexp)
+        flint_free(Cexp);
+
+    TMP_END;
+}
@@ -0,0 +1,31 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_neg(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong i;
+
+    if (A != B)
+    {
+        slong N = mpoly_words_per_exp(B->bits, ctx->minfo);
+        fmpz_mod_mpoly_fit_length(A, B->length, ctx);
+        fmpz_mod_mpoly_fit_bits(A, B->bits, ctx);
+        A->bits = B->bits;
+        mpoly_copy_monomials(A->exps, B->exps, B->length, N);
+    }
+
+    for (i = 0; i < B->length; i++)
+        fmpz_mod_neg(A->coeffs + i, B->coeffs + i, ctx->ffinfo);
+
+    _fmpz_mod_mpoly_set_length(A, B->length, ctx);
+}
@@ -0,0 +1,46 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_realloc(fmpz_mod_mpoly_t A, slong alloc,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong N;
+
+    if (alloc == 0)             /* Clear up, reinitialise */
+    {
+        fmpz_mod_mpoly_clear(A, ctx);
+        fmpz_mod_mpoly_init(A, ctx);
+        return;
+    }
+
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+
+    if (A->alloc != 0)          /* Realloc */
+    {
+        fmpz_mod_mpoly_truncate(A, alloc, ctx);
+
+        A->coeffs = (fmpz *) flint_realloc(A->coeffs, alloc*sizeof(fmpz));
+        A->exps = (ulong *) flint_realloc(A->exps, alloc*N*sizeof(ulong));
+
+        if (alloc > A->alloc)
+            memset(A->coeffs + A->alloc, 0, (alloc - A->alloc)*sizeof(fmpz));
+    }
+    else                        /* Nothing allocated already so do it now */
+    {
+        A->coeffs = (fmpz *) flint_calloc(alloc, sizeof(fmpz));
+        A->exps   = (ulong *) flint_malloc(alloc*N*sizeof(ulong));
+    }
+
+    A->alloc = alloc;
+}
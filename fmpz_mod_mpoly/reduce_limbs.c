@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_vec.h"
+#include "fmpz_mod_mpoly.h"
+
+/* a[s*i, s*i + s) = c[i] for 0 <= i < len, each c[i] fits in s limbs */
+void _fmpz_mod_mpoly_get_limbs(mp_limb_t * a, const fmpz * c,
+                                                          slong len, slong s)
+{
+    slong i;
+
+    if (s == 1)
+    {
+        for (i = 0; i < len; i++)
+            a[i] = fmpz_get_ui(c + i);
+        return;
+    }
+
+    for (i = 0; i < len; i++)
+        fmpz_get_ui_array(a + s*i, s, c + i);
+}
+
+/* c = acc mod p, where acc has 2*s + 1 limbs and p has s limbs */
+void _fmpz_mod_mpoly_reduce_limbs(fmpz_t c, const mp_limb_t * acc,
+                                        slong s, const fmpz_mod_ctx_t fpctx)
+{
+    mp_limb_t * q, * r;
+    const fmpz * p = fmpz_mod_ctx_modulus(fpctx);
+    TMP_INIT;
+
+    if (s == 1)
+    {
+        mp_limb_t hi, lo;
+        NMOD_RED(hi, acc[2], fpctx->mod);
+        NMOD_RED3(lo, hi, acc[1], acc[0], fpctx->mod);
+        fmpz_set_ui(c, lo);
+        return;
+    }
+
+    TMP_START;
+    q = (mp_limb_t *) TMP_ALLOC((s + 2)*sizeof(mp_limb_t));
+    r = (mp_limb_t *) TMP_ALLOC(s*sizeof(mp_limb_t));
+    mpn_tdiv_qr(q, r, 0, acc, 2*s + 1, COEFF_TO_PTR(*p)->_mp_d, s);
+    fmpz_set_ui_array(c, r, s);
+    TMP_END;
+}
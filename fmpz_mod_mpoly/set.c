@@ -0,0 +1,28 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_set(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong N = mpoly_words_per_exp(B->bits, ctx->minfo);
+
+    if (A == B)
+        return;
+
+    fmpz_mod_mpoly_fit_length(A, B->length, ctx);
+    fmpz_mod_mpoly_fit_bits(A, B->bits, ctx);
+    A->bits = B->bits;
+
+    _fmpz_mpoly_set(A->coeffs, A->exps, B->coeffs, B->exps, B->length, N);
+    _fmpz_mod_mpoly_set_length(A, B->length, ctx);
+}
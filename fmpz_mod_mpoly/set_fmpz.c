@@ -0,0 +1,38 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+void fmpz_mod_mpoly_set_fmpz(fmpz_mod_mpoly_t A, const fmpz_t c,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong N = mpoly_words_per_exp(A->bits, ctx->minfo);
+
+    fmpz_mod_mpoly_fit_length(A, 1, ctx);
+    fmpz_mod(A->coeffs + 0, c, fmpz_mod_mpoly_ctx_modulus(ctx));
+
+    if (fmpz_is_zero(A->coeffs + 0))
+    {
+        _fmpz_mod_mpoly_set_length(A, 0, ctx);
+        return;
+    }
+
+    mpoly_monomial_zero(A->exps + N*0, N);
+    _fmpz_mod_mpoly_set_length(A, 1, ctx);
+}
+
+void fmpz_mod_mpoly_set_ui(fmpz_mod_mpoly_t A, ulong c,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    fmpz_t t;
+    fmpz_init_set_ui(t, c);
+    fmpz_mod_mpoly_set_fmpz(A, t, ctx);
+    fmpz_clear(t);
+}
@@ -0,0 +1,49 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+/*
+    sort the terms in A by exponent
+    assuming that the exponents are valid (other than being in order)
+*/
+void fmpz_mod_mpoly_sort_terms(fmpz_mod_mpoly_t A,
+                                                const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong N, ndigits;
+    ulong * cmpmask, * vary;
+    slong * digits, * stack;
+    TMP_INIT;
+
+    if (A->length < 2)
+        return;
+
+    TMP_START;
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    vary = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    digits = (slong *) TMP_ALLOC(N*(FLINT_BITS/8)*sizeof(slong));
+    mpoly_get_cmpmask(cmpmask, N, A->bits, ctx->minfo);
+
+    mpoly_monomial_zero(vary, N);
+    mpoly_monomials_varying_bits(vary, A->exps, A->length, A->exps, N);
+    ndigits = mpoly_radix_sort_digits(digits, vary, N);
+
+    /* the coefficients are fmpz's, so the fmpz_mpoly sort applies */
+    if (ndigits > 0)
+    {
+        stack = (slong *) flint_malloc(256*(ndigits + 1)*sizeof(slong));
+        _fmpz_mpoly_radix_sort_bytes(A->coeffs, A->exps, 0, A->length,
+                                      digits, 0, ndigits, N, cmpmask, stack);
+        flint_free(stack);
+    }
+
+    TMP_END;
+}
@@ -0,0 +1,132 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "fmpz_mod_mpoly.h"
+
+slong _fmpz_mod_mpoly_sub(fmpz * Acoeff, ulong * Aexp,
+                 const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                 const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+           slong N, const ulong * cmpmask, const fmpz_mod_ctx_t fpctx)
+{
+    slong i = 0, j = 0, k = 0;
+
+    while (i < Blen && j < Clen)
+    {
+        int cmp = mpoly_monomial_cmp(Bexp + N*i, Cexp + N*j, N, cmpmask);
+
+        if (cmp > 0)
+        {
+            fmpz_set(Acoeff + k, Bcoeff + i);
+            mpoly_monomial_set(Aexp + N*k, Bexp + N*i, N);
+            i++;
+            k++;
+        }
+        else if (cmp == 0)
+        {
+            fmpz_mod_sub(Acoeff + k, Bcoeff + i, Ccoeff + j, fpctx);
+            mpoly_monomial_set(Aexp + N*k, Bexp + N*i, N);
+            k += !fmpz_is_zero(Acoeff + k);
+            i++;
+            j++;
+        }
+        else
+        {
+            fmpz_mod_neg(Acoeff + k, Ccoeff + j, fpctx);
+            mpoly_monomial_set(Aexp + N*k, Cexp + N*j, N);
+            j++;
+            k++;
+        }
+    }
+
+    while (i < Blen)
+    {
+        fmpz_set(Acoeff + k, Bcoeff + i);
+        mpoly_monomial_set(Aexp + N*k, Bexp + N*i, N);
+        i++;
+        k++;
+    }
+
+    while (j < Clen)
+    {
+        fmpz_mod_neg(Acoeff + k, Ccoeff + j, fpctx);
+        mpoly_monomial_set(Aexp + N*k, Cexp + N*j, N);
+        j++;
+        k++;
+    }
+
+    return k;
+}
+
+void fmpz_mod_mpoly_sub(fmpz_mod_mpoly_t A, const fmpz_mod_mpoly_t B,
+                     const fmpz_mod_mpoly_t C, const fmpz_mod_mpoly_ctx_t ctx)
+{
+    slong Alen;
+    flint_bitcnt_t Abits;
+    slong N;
+    ulong * Bexp = B->exps, * Cexp = C->exps;
+    ulong * cmpmask;
+    int freeBexp = 0, freeCexp = 0;
+    TMP_INIT;
+
+    Abits = FLINT_MAX(B->bits, C->bits);
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+
+    TMP_START;
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
+
+    if (Abits != B->bits)
+    {
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
+    }
+
+    if (Abits != C->bits)
+    {
+        freeCexp = 1;
+        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits,
+                                                        C->length, ctx->minfo);
+    }
+
+    if (A == B || A == C)
+    {
+        fmpz_mod_mpoly_t T;
+        fmpz_mod_mpoly_init3(T, B->length + C->length, Abits, ctx);
+        Alen = _fmpz_mod_mpoly_sub(T->coeffs, T->exps,
+                                B->coeffs, Bexp, B->length,
+                                C->coeffs, Cexp, C->length,
+                                                   N, cmpmask, ctx->ffinfo);
+        fmpz_mod_mpoly_swap(T, A, ctx);
+        fmpz_mod_mpoly_clear(T, ctx);
+    }
+    else
+    {
+        fmpz_mod_mpoly_fit_length(A, B->length + C->length, ctx);
+        fmpz_mod_mpoly_fit_bits(A, Abits, ctx);
+        A->bits = Abits;
+        Alen = _fmpz_mod_mpoly_sub(A->coeffs, A->exps,
+                                B->coeffs, Bexp, B->length,
+                                C->coeffs, Cexp, C->length,
+                                                   N, cmpmask, ctx->ffinfo);
+    }
+
+    _fmpz_mod_mpoly_set_length(A, Alen, ctx);
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    if (freeCexp)
+        flint_free(Cexp);
+
+    TMP_END;
+}
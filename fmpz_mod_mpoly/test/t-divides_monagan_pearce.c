@@ -0,0 +1,110 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("divides_monagan_pearce....");
+    fflush(stdout);
+
+    /* Check f*g/g = f and divisibility of random polynomials */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mpoly_ctx_t ctx;
+        fmpz_mod_mpoly_t f, g, h, k, q;
+        fmpz_t p;
+        slong len, len1, len2;
+        flint_bitcnt_t exp_bits, exp_bits1, exp_bits2;
+        int divides;
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, n_randint(state, 300) + 2, 0);
+        fmpz_mod_mpoly_ctx_init_rand(ctx, state, 10, p);
+
+        fmpz_mod_mpoly_init(f, ctx);
+        fmpz_mod_mpoly_init(g, ctx);
+        fmpz_mod_mpoly_init(h, ctx);
+        fmpz_mod_mpoly_init(k, ctx);
+        fmpz_mod_mpoly_init(q, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 50);
+        len2 = n_randint(state, 50) + 1;
+
+        exp_bits = n_randint(state, 200) + 2;
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            do {
+                fmpz_mod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            } while (fmpz_mod_mpoly_is_zero(g, ctx));
+            fmpz_mod_mpoly_randtest_bits(q, state, len, exp_bits, ctx);
+
+            fmpz_mod_mpoly_mul(h, f, g, ctx);
+            divides = fmpz_mod_mpoly_divides_monagan_pearce(q, h, g, ctx);
+            fmpz_mod_mpoly_assert_canonical(q, ctx);
+            if (!divides || !fmpz_mod_mpoly_equal(q, f, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* aliasing */
+            divides = fmpz_mod_mpoly_divides(h, h, g, ctx);
+            fmpz_mod_mpoly_assert_canonical(h, ctx);
+            if (!divides || !fmpz_mod_mpoly_equal(h, f, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* a reported quotient must be exact */
+            fmpz_mod_mpoly_randtest_bound(h, state, len1, 10, ctx);
+            do {
+                fmpz_mod_mpoly_randtest_bound(g, state, len2, 5, ctx);
+            } while (fmpz_mod_mpoly_is_zero(g, ctx));
+            divides = fmpz_mod_mpoly_divides_monagan_pearce(q, h, g, ctx);
+            fmpz_mod_mpoly_assert_canonical(q, ctx);
+            fmpz_mod_mpoly_mul(k, q, g, ctx);
+            if (divides != fmpz_mod_mpoly_equal(k, h, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check random division\ni = %wd, j = %wd\n",
+                                                                         i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mod_mpoly_clear(f, ctx);
+        fmpz_mod_mpoly_clear(g, ctx);
+        fmpz_mod_mpoly_clear(h, ctx);
+        fmpz_mod_mpoly_clear(k, ctx);
+        fmpz_mod_mpoly_clear(q, ctx);
+        fmpz_mod_mpoly_ctx_clear(ctx);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpz_mod_mpoly.h"
+
+void gcd_check(fmpz_mod_mpoly_t g, fmpz_mod_mpoly_t a, fmpz_mod_mpoly_t b,
+                 const fmpz_mod_mpoly_ctx_t ctx, slong i, slong j,
+                                                            const char * name)
+{
+    int res;
+    fmpz_mod_mpoly_t ca, cb, cg;
+
+    fmpz_mod_mpoly_init(ca, ctx);
+    fmpz_mod_mpoly_init(cb, ctx);
+    fmpz_mod_mpoly_init(cg, ctx);
+
+    res = fmpz_mod_mpoly_gcd_threaded(g, a, b, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+    fmpz_mod_mpoly_assert_canonical(g, ctx);
+
+    if (!res)
+        goto cleanup;
+
+    if (fmpz_mod_mpoly_is_zero(g, ctx))
+    {
+        if (!fmpz_mod_mpoly_is_zero(a, ctx) || !fmpz_mod_mpoly_is_zero(b, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check zero gcd only results from zero inputs\n"
+                                       "i = %wd, j = %wd, %s\n", i, j, name);
+            flint_abort();
+        }
+        goto cleanup;
+    }
+
+    if (!fmpz_is_one(g->coeffs + 0))
+    {
+        printf("FAIL\n");
+        flint_printf("Check gcd is monic\ni = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+    res = 1;
+    res = res && fmpz_mod_mpoly_divides(ca, a, g, ctx);
+    res = res && fmpz_mod_mpoly_divides(cb, b, g, ctx);
+    if (!res)
+    {
+        printf("FAIL\n");
+        flint_printf("Check divisibility\ni = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+    res = fmpz_mod_mpoly_gcd_threaded(cg, ca, cb, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+    fmpz_mod_mpoly_assert_canonical(cg, ctx);
+
+    if (res && !fmpz_mod_mpoly_is_one(cg, ctx))
+    {
+        printf("FAIL\n");
+        flint_printf("Check gcd of cofactors is one\n"
+                                       "i = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+cleanup:
+
+    fmpz_mod_mpoly_clear(ca, ctx);
+    fmpz_mod_mpoly_clear(cb, ctx);
+    fmpz_mod_mpoly_clear(cg, ctx);
+}
+
+int
+main(void)
+{
+    slong i, j, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("gcd....");
+    fflush(stdout);
+
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mpoly_ctx_t ctx;
+        fmpz_mod_mpoly_t a, b, g, t;
+        fmpz_t p;
+        slong len, len1, len2;
+        ulong degbound;
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, n_randint(state, 200) + 20, 0);
+        fmpz_mod_mpoly_ctx_init_rand(ctx, state, 5, p);
+
+        fmpz_mod_mpoly_init(g, ctx);
+        fmpz_mod_mpoly_init(a, ctx);
+        fmpz_mod_mpoly_init(b, ctx);
+        fmpz_mod_mpoly_init(t, ctx);
+
+        len = n_randint(state, 10) + 1;
+        len1 = n_randint(state, 15);
+        len2 = n_randint(state, 15);
+
+        degbound = 30/(2*ctx->minfo->nvars - 1) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            do {
+                fmpz_mod_mpoly_randtest_bound(t, state, len, degbound, ctx);
+            } while (fmpz_mod_mpoly_is_zero(t, ctx));
+            fmpz_mod_mpoly_randtest_bound(a, state, len1, degbound, ctx);
+            fmpz_mod_mpoly_randtest_bound(b, state, len2, degbound, ctx);
+            fmpz_mod_mpoly_mul(a, a, t, ctx);
+            fmpz_mod_mpoly_mul(b, b, t, ctx);
+
+            fmpz_mod_mpoly_randtest_bits(g, state, len, FLINT_BITS, ctx);
+
+            gcd_check(g, a, b, ctx, i, j, "random");
+
+            /* the known factor divides the gcd */
+            if (!fmpz_mod_mpoly_is_zero(a, ctx) &&
+                !fmpz_mod_mpoly_is_zero(b, ctx) &&
+                !fmpz_mod_mpoly_divides(a, g, t, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check known factor divides gcd\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        /* one input zero */
+        fmpz_mod_mpoly_randtest_bound(a, state, len1, degbound, ctx);
+        fmpz_mod_mpoly_zero(b, ctx);
+        gcd_check(g, a, b, ctx, i, 0, "zero");
+
+        /* aliasing */
+        fmpz_mod_mpoly_randtest_bound(t, state, len, degbound, ctx);
+        fmpz_mod_mpoly_randtest_bound(a, state, len1, degbound, ctx);
+        fmpz_mod_mpoly_randtest_bound(b, state, len2, degbound, ctx);
+        fmpz_mod_mpoly_mul(a, a, t, ctx);
+        fmpz_mod_mpoly_mul(b, b, t, ctx);
+        if (fmpz_mod_mpoly_gcd(g, a, b, ctx) &&
+            fmpz_mod_mpoly_gcd(a, a, b, ctx) &&
+            !fmpz_mod_mpoly_equal(a, g, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check aliasing\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        fmpz_mod_mpoly_clear(g, ctx);
+        fmpz_mod_mpoly_clear(a, ctx);
+        fmpz_mod_mpoly_clear(b, ctx);
+        fmpz_mod_mpoly_clear(t, ctx);
+        fmpz_mod_mpoly_ctx_clear(ctx);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpz_mod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_heap_threaded....");
+    fflush(stdout);
+
+    /* Check mul_heap_threaded matches mul_johnson */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mpoly_ctx_t ctx;
+        fmpz_mod_mpoly_t f, g, h, k;
+        fmpz_t p;
+        slong len1, len2;
+        flint_bitcnt_t exp_bits1, exp_bits2;
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, n_randint(state, 300) + 2, 0);
+        fmpz_mod_mpoly_ctx_init_rand(ctx, state, 10, p);
+
+        fmpz_mod_mpoly_init(f, ctx);
+        fmpz_mod_mpoly_init(g, ctx);
+        fmpz_mod_mpoly_init(h, ctx);
+        fmpz_mod_mpoly_init(k, ctx);
+
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            fmpz_mod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            fmpz_mod_mpoly_randtest_bits(k, state, len1, exp_bits1, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mod_mpoly_mul_johnson(h, f, g, ctx);
+            fmpz_mod_mpoly_mul_heap_threaded(k, f, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mod_mpoly_assert_canonical(k, ctx);
+
+            if (!fmpz_mod_mpoly_equal(h, k, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check mul_heap_threaded matches mul_johnson\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* aliasing */
+            fmpz_mod_mpoly_mul_threaded(f, f, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mod_mpoly_assert_canonical(f, ctx);
+            if (!fmpz_mod_mpoly_equal(h, f, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mod_mpoly_clear(f, ctx);
+        fmpz_mod_mpoly_clear(g, ctx);
+        fmpz_mod_mpoly_clear(h, ctx);
+        fmpz_mod_mpoly_clear(k, ctx);
+        fmpz_mod_mpoly_ctx_clear(ctx);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
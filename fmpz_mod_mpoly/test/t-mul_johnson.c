@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_johnson....");
+    fflush(stdout);
+
+    /* Check f*(g + h) = f*g + f*h */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_mod_mpoly_ctx_t ctx;
+        fmpz_mod_mpoly_t f, g, h, k1, k2, t1, t2;
+        fmpz_t p;
+        slong len, len1, len2;
+        flint_bitcnt_t exp_bits, exp_bits1, exp_bits2;
+
+        fmpz_init(p);
+        fmpz_randprime(p, state, n_randint(state, 300) + 2, 0);
+        fmpz_mod_mpoly_ctx_init_rand(ctx, state, 20, p);
+
+        fmpz_mod_mpoly_init(f, ctx);
+        fmpz_mod_mpoly_init(g, ctx);
+        fmpz_mod_mpoly_init(h, ctx);
+        fmpz_mod_mpoly_init(k1, ctx);
+        fmpz_mod_mpoly_init(k2, ctx);
+        fmpz_mod_mpoly_init(t1, ctx);
+        fmpz_mod_mpoly_init(t2, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 50);
+        len2 = n_randint(state, 50);
+
+        exp_bits = n_randint(state, 200) + 2;
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mod_mpoly_randtest_bits(f, state, len, exp_bits, ctx);
+            fmpz_mod_mpoly_randtest_bits(g, state, len1, exp_bits1, ctx);
+            fmpz_mod_mpoly_randtest_bits(h, state, len2, exp_bits2, ctx);
+            fmpz_mod_mpoly_randtest_bits(k1, state, len, exp_bits, ctx);
+
+            fmpz_mod_mpoly_add(t1, g, h, ctx);
+            fmpz_mod_mpoly_mul_johnson(k1, f, t1, ctx);
+            fmpz_mod_mpoly_assert_canonical(k1, ctx);
+            fmpz_mod_mpoly_mul_johnson(t1, f, g, ctx);
+            fmpz_mod_mpoly_assert_canonical(t1, ctx);
+            fmpz_mod_mpoly_mul_johnson(t2, f, h, ctx);
+            fmpz_mod_mpoly_assert_canonical(t2, ctx);
+            fmpz_mod_mpoly_add(k2, t1, t2, ctx);
+
+            if (!fmpz_mod_mpoly_equal(k1, k2, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*(g + h) = f*g + f*h\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* aliasing with either input */
+            fmpz_mod_mpoly_set(t1, f, ctx);
+            fmpz_mod_mpoly_mul_johnson(t1, t1, g, ctx);
+            fmpz_mod_mpoly_mul_johnson(t2, g, f, ctx);
+            fmpz_mod_mpoly_set(k1, g, ctx);
+            fmpz_mod_mpoly_mul_johnson(k1, f, k1, ctx);
+            fmpz_mod_mpoly_assert_canonical(t1, ctx);
+            fmpz_mod_mpoly_assert_canonical(k1, ctx);
+            if (!fmpz_mod_mpoly_equal(t1, t2, ctx) ||
+                !fmpz_mod_mpoly_equal(k1, t2, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mod_mpoly_clear(f, ctx);
+        fmpz_mod_mpoly_clear(g, ctx);
+        fmpz_mod_mpoly_clear(h, ctx);
+        fmpz_mod_mpoly_clear(k1, ctx);
+        fmpz_mod_mpoly_clear(k2, ctx);
+        fmpz_mod_mpoly_clear(t1, ctx);
+        fmpz_mod_mpoly_clear(t2, ctx);
+        fmpz_mod_mpoly_ctx_clear(ctx);
+        fmpz_clear(p);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -219,6 +219,30 @@ void fmpz_mpoly_fit_bits(fmpz_mpoly_t A,
 FLINT_DLL int fmpz_mpoly_set_str_pretty(fmpz_mpoly_t A, const char * str,
                                   const char ** x, const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL int fmpz_mpoly_fread_pretty(FILE * file, fmpz_mpoly_t A,
+                                  const char ** x, const fmpz_mpoly_ctx_t ctx);
+
+/* strings with fewer characters per thread are parsed by one thread */
+#define FMPZ_MPOLY_PARSE_THREADED_CUTOFF 65536
+
+FLINT_DLL int _fmpz_mpoly_set_str_pretty(fmpz_mpoly_t A, const char * s,
+                             slong sn, char ** x, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL int _fmpz_mpoly_parse_pretty(fmpz_mpoly_t A, const char * s,
+                             slong sn, char ** x, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL int _fmpz_mpoly_push_str_monomials(fmpz_mpoly_t A, const char * s,
+                       slong sn, char * const * x, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL int _fmpz_mpoly_push_str_monomials_threaded(fmpz_mpoly_t A,
+         const char * s, slong sn, char * const * x, const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL slong _fmpz_mpoly_str_next_term(const char * s, slong start,
+                                                                     slong sn);
+
+FLINT_DLL int _fmpz_mpoly_str_names_splittable(char * const * x, slong nvars);
+
 FLINT_DLL char * _fmpz_mpoly_get_str_pretty(const fmpz * poly,
                           const ulong * exps, slong len, const char ** x, 
                                            slong bits, const mpoly_ctx_t mctx);
@@ -248,6 +272,12 @@ int fmpz_mpoly_print_pretty(const fmpz_mpoly_t A,
    return fmpz_mpoly_fprint_pretty(stdout, A, x, ctx);
 }
 
+FLINT_DLL size_t fmpz_mpoly_out_raw(FILE * file, const fmpz_mpoly_t A,
+                                                   const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL size_t fmpz_mpoly_inp_raw(fmpz_mpoly_t A, FILE * file,
+                                                   const fmpz_mpoly_ctx_t ctx);
+
 
 /*  Basic manipulation *******************************************************/
 
@@ -556,6 +586,12 @@ FLINT_DLL void fmpz_mpoly_sort_terms(fmpz_mpoly_t A, const fmpz_mpoly_ctx_t ctx)
 FLINT_DLL void fmpz_mpoly_combine_like_terms(fmpz_mpoly_t A,
                                                    const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL void fmpz_mpoly_sort_terms_threaded(fmpz_mpoly_t A,
+                               const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void fmpz_mpoly_combine_like_terms_threaded(fmpz_mpoly_t A,
+                               const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void fmpz_mpoly_reverse(fmpz_mpoly_t A, const fmpz_mpoly_t B,
                                                    const fmpz_mpoly_ctx_t ctx);
 
@@ -568,6 +604,18 @@ FLINT_DLL void _fmpz_mpoly_radix_sort1(fmpz_mpoly_t A, slong left, slong right,
 FLINT_DLL void _fmpz_mpoly_radix_sort(fmpz_mpoly_t A, slong left, slong right,
                                     flint_bitcnt_t pos, slong N, ulong * cmpmask);
 
+FLINT_DLL void _fmpz_mpoly_radix_sort_bytes(fmpz * Acoeff, ulong * Aexp,
+                       slong left, slong right, const slong * digits, slong k,
+                 slong ndigits, slong N, const ulong * cmpmask, slong * stack);
+
+FLINT_DLL void _fmpz_mpoly_sort_terms_threaded(fmpz_mpoly_t A,
+                                const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _fmpz_mpoly_combine_like_terms_threaded(fmpz_mpoly_t A,
+                                const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL void _fmpz_mpoly_push_exp_ffmpz(fmpz_mpoly_t A,
                                  const fmpz * exp, const fmpz_mpoly_ctx_t ctx);
 
@@ -629,6 +677,17 @@ FLINT_DLL slong _fmpz_mpoly_sub(fmpz * poly1, ulong * exps1,
                  const fmpz * poly3, const ulong * exps3, slong len3, slong N,
                                                         const ulong * cmpmask);
 
+FLINT_DLL void fmpz_mpoly_sum(fmpz_mpoly_t A, fmpz_mpoly_struct * const * B,
+                                         slong n, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_sum_threaded(fmpz_mpoly_t A,
+                                 fmpz_mpoly_struct * const * B, slong n,
+                                const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void _fmpz_mpoly_sum_threaded(fmpz_mpoly_t A,
+           fmpz_mpoly_struct * const * B, slong n, const fmpz_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 
 /* Scalar operations *********************************************************/
 
@@ -681,6 +740,43 @@ FLINT_DLL void fmpz_mpoly_evaluate_one_fmpz(fmpz_mpoly_t A,
                            const fmpz_mpoly_t B, slong var, const fmpz_t val,
                                                    const fmpz_mpoly_ctx_t ctx);
 
+/*
+    A compiled evaluation plan holds a copy of a polynomial together with a
+    straight line program in Horner form for evaluating it. The program is
+    only valid if the exponents of the polynomial fit into a word.
+*/
+typedef struct
+{
+    fmpz_mpoly_struct poly;
+    mpoly_slp_struct slp;
+    int compiled;
+} fmpz_mpoly_eval_plan_struct;
+
+typedef fmpz_mpoly_eval_plan_struct fmpz_mpoly_eval_plan_t[1];
+
+FLINT_DLL void fmpz_mpoly_eval_plan_init(fmpz_mpoly_eval_plan_t P,
+                              const fmpz_mpoly_t A, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_eval_plan_clear(fmpz_mpoly_eval_plan_t P,
+                                                   const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_eval_plan_evaluate_fmpz(fmpz_t ev,
+                       const fmpz_mpoly_eval_plan_t P, fmpz * const * vals,
+                                                   const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_eval_plan_evaluate_vec_fmpz(fmpz * ev,
+                           const fmpz_mpoly_eval_plan_t P, const fmpz * vals,
+                                        slong num, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void _fmpz_mpoly_eval_plan_evaluate_vec_fmpz_threaded(fmpz * ev,
+                           const fmpz_mpoly_eval_plan_t P, const fmpz * vals,
+                                         slong num, const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void fmpz_mpoly_eval_plan_evaluate_vec_fmpz_threaded(fmpz * ev,
+                           const fmpz_mpoly_eval_plan_t P, const fmpz * vals,
+                    slong num, const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void fmpz_mpoly_compose_fmpz_poly(fmpz_poly_t A,
                          const fmpz_mpoly_t B, fmpz_poly_struct * const * C,
                                                   const fmpz_mpoly_ctx_t ctxB);
@@ -689,6 +785,20 @@ FLINT_DLL void fmpz_mpoly_compose_fmpz_mpoly(fmpz_mpoly_t A,
                    const fmpz_mpoly_t B, fmpz_mpoly_struct * const * C,
                     const fmpz_mpoly_ctx_t ctxB, const fmpz_mpoly_ctx_t ctxAC);
 
+FLINT_DLL void _fmpz_mpoly_compose_fmpz_mpoly(fmpz_mpoly_t A,
+                   const fmpz_mpoly_t B, fmpz_mpoly_struct * const * C,
+                    const fmpz_mpoly_ctx_t ctxB, const fmpz_mpoly_ctx_t ctxAC);
+
+FLINT_DLL void fmpz_mpoly_compose_fmpz_mpoly_threaded(fmpz_mpoly_t A,
+                   const fmpz_mpoly_t B, fmpz_mpoly_struct * const * C,
+                   const fmpz_mpoly_ctx_t ctxB, const fmpz_mpoly_ctx_t ctxAC,
+                                                           slong thread_limit);
+
+FLINT_DLL void _fmpz_mpoly_compose_fmpz_mpoly_threaded(fmpz_mpoly_t A,
+                   const fmpz_mpoly_t B, fmpz_mpoly_struct * const * C,
+                   const fmpz_mpoly_ctx_t ctxB, const fmpz_mpoly_ctx_t ctxAC,
+                        const thread_pool_handle * handles, slong num_handles);
+
 
 /* Multiplication ************************************************************/
 
@@ -706,6 +816,20 @@ FLINT_DLL void fmpz_mpoly_mul_heap_threaded(fmpz_mpoly_t A,
        const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx,
                                                            slong thread_limit);
 
+FLINT_DLL void fmpz_mpoly_mul_hash(fmpz_mpoly_t A,
+       const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_mul_hash_threaded(fmpz_mpoly_t A,
+       const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
+FLINT_DLL void fmpz_mpoly_mul_multimod(fmpz_mpoly_t A,
+       const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_mul_multimod_threaded(fmpz_mpoly_t A,
+       const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
 FLINT_DLL int fmpz_mpoly_mul_array(fmpz_mpoly_t A, 
        const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx);
 
@@ -716,6 +840,10 @@ FLINT_DLL int fmpz_mpoly_mul_array_threaded(fmpz_mpoly_t A,
 FLINT_DLL int fmpz_mpoly_mul_dense(fmpz_mpoly_t A, 
        const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL int fmpz_mpoly_mul_dense_threaded(fmpz_mpoly_t A,
+       const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
 FLINT_DLL slong _fmpz_mpoly_mul_johnson(fmpz ** poly1, ulong ** exp1, slong * alloc,
                  const fmpz * poly2, const ulong * exp2, slong len2,
                  const fmpz * poly3, const ulong * exp3, slong len3,
@@ -731,6 +859,32 @@ FLINT_DLL void _fmpz_mpoly_mul_heap_threaded_maxfields(fmpz_mpoly_t A,
            const fmpz_mpoly_t C, fmpz * maxCfields, const fmpz_mpoly_ctx_t ctx,
                         const thread_pool_handle * handles, slong num_handles);
 
+FLINT_DLL slong _fmpz_mpoly_mul_hash(fmpz ** A_coeff, ulong ** A_exp,
+                 slong * A_alloc,
+                 const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                 const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                          flint_bitcnt_t bits, slong N, slong which, slong num);
+
+FLINT_DLL void _fmpz_mpoly_mul_hash_maxfields(fmpz_mpoly_t A,
+                                 const fmpz_mpoly_t B, fmpz * maxBfields,
+                                 const fmpz_mpoly_t C, fmpz * maxCfields,
+                                                   const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void _fmpz_mpoly_mul_hash_threaded(fmpz_mpoly_t A,
+                 const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                 const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                 flint_bitcnt_t bits, slong N, const fmpz_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _fmpz_mpoly_mul_hash_threaded_maxfields(fmpz_mpoly_t A,
+           const fmpz_mpoly_t B, fmpz * maxBfields,
+           const fmpz_mpoly_t C, fmpz * maxCfields, const fmpz_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _fmpz_mpoly_mul_multimod_threaded(fmpz_mpoly_t A,
+       const fmpz_mpoly_t B, const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL int _fmpz_mpoly_mul_array_DEG(fmpz_mpoly_t A,
                                  const fmpz_mpoly_t B, fmpz * maxBfields,
                                  const fmpz_mpoly_t C, fmpz * maxCfields,
@@ -756,6 +910,19 @@ FLINT_DLL int _fmpz_mpoly_mul_dense(fmpz_mpoly_t P,
                                  const fmpz_mpoly_t B, fmpz * maxBfields,
                                                    const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL int _fmpz_mpoly_mul_dense_threaded(fmpz_mpoly_t P,
+                                 const fmpz_mpoly_t A, fmpz * maxAfields,
+                                 const fmpz_mpoly_t B, fmpz * maxBfields,
+                                                    const fmpz_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void fmpz_mpoly_product(fmpz_mpoly_t A,
+      fmpz_mpoly_struct * const * B, slong n, const fmpz_mpoly_ctx_t ctx);
+
+FLINT_DLL void fmpz_mpoly_product_threaded(fmpz_mpoly_t A,
+                                 fmpz_mpoly_struct * const * B, slong n,
+                                const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
 /* Powering ******************************************************************/
 
 FLINT_DLL void fmpz_mpoly_pow_fmpz(fmpz_mpoly_t A, const fmpz_mpoly_t B,
@@ -767,6 +934,9 @@ FLINT_DLL void fmpz_mpoly_pow_ui(fmpz_mpoly_t A, const fmpz_mpoly_t B,
 FLINT_DLL void fmpz_mpoly_pow_fps(fmpz_mpoly_t A, const fmpz_mpoly_t B,
                                           ulong k, const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL void fmpz_mpoly_pow_ui_threaded(fmpz_mpoly_t A, const fmpz_mpoly_t B,
+                        ulong k, const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL slong _fmpz_mpoly_pow_fps(fmpz ** poly1, ulong ** exp1,
                 slong * alloc, const fmpz * poly2, const ulong * exp2, 
         slong len2, ulong k, flint_bitcnt_t bits, slong N, const ulong * cmpmask);
@@ -806,12 +976,21 @@ FLINT_DLL int mpoly_divides_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
                                 slong nworkers, ulong * Aexp, slong Alen,
                                    ulong * Bexp, slong Blen, flint_bitcnt_t bits);
 
+FLINT_DLL void mpoly_divrem_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
+                                slong nworkers, ulong * Aexp, slong Alen,
+                                   ulong * Bexp, slong Blen, flint_bitcnt_t bits);
+
 FLINT_DLL slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1,
                       ulong ** exp1, slong * alloc, const fmpz * poly2,
                     const ulong * exp2, slong len2, const fmpz * poly3,
                     const ulong * exp3, slong len3, flint_bitcnt_t bits, slong N,
                                                         const ulong * cmpmask);
 
+FLINT_DLL slong _fmpz_mpoly_divides_monagan_pearce_varbits(fmpz ** poly1,
+                      ulong ** exp1, slong * alloc, const fmpz * poly2,
+                    const ulong * exp2, slong len2, const fmpz * poly3,
+                    const ulong * exp3, slong len3, const mpoly_varbits_t V);
+
 FLINT_DLL void fmpz_mpoly_divrem(fmpz_mpoly_t Q, fmpz_mpoly_t R,
        const fmpz_mpoly_t A, const fmpz_mpoly_t B, const fmpz_mpoly_ctx_t ctx);
 
@@ -891,6 +1070,19 @@ fmpz_mpoly_quasidivrem_ideal_heap(fmpz_t scale,
                 const fmpz_mpoly_t poly2, fmpz_mpoly_struct * const * poly3,
                                         slong len, const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL void fmpz_mpoly_divrem_heap_threaded(fmpz_mpoly_t Q, fmpz_mpoly_t R,
+       const fmpz_mpoly_t A, const fmpz_mpoly_t B, const fmpz_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
+FLINT_DLL void fmpz_mpoly_divrem_ideal_heap_threaded(fmpz_mpoly_struct ** Q,
+     fmpz_mpoly_t R, const fmpz_mpoly_t A, fmpz_mpoly_struct * const * B,
+                     slong len, const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void _fmpz_mpoly_divrem_ideal_heap_threaded(fmpz_mpoly_struct ** Q,
+     fmpz_mpoly_t R, const fmpz_mpoly_t A, fmpz_mpoly_struct * const * B,
+                                        slong len, const fmpz_mpoly_ctx_t ctx,
+                              thread_pool_handle * handles, slong num_handles);
+
 /* GCD ***********************************************************************/
 
 FLINT_DLL void fmpz_mpoly_term_content(fmpz_mpoly_t M, const fmpz_mpoly_t A,
@@ -937,6 +1129,10 @@ FLINT_DLL int fmpz_mpoly_gcd_brown(fmpz_mpoly_t G,
 FLINT_DLL int fmpz_mpoly_gcd_zippel(fmpz_mpoly_t G,
        const fmpz_mpoly_t A, const fmpz_mpoly_t B, const fmpz_mpoly_ctx_t ctx);
 
+FLINT_DLL int fmpz_mpoly_gcd_zippel_threaded(fmpz_mpoly_t G,
+                                const fmpz_mpoly_t A, const fmpz_mpoly_t B,
+                               const fmpz_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL int fmpz_mpoly_gcd_berlekamp_massey(fmpz_mpoly_t G,
        const fmpz_mpoly_t A, const fmpz_mpoly_t B, const fmpz_mpoly_ctx_t ctx);
 
@@ -983,6 +1179,51 @@ typedef struct _fmpz_mpoly_stripe_struct
 
 typedef fmpz_mpoly_stripe_struct fmpz_mpoly_stripe_t[1];
 
+/*
+    a thread safe mpoly supports three mutating operations
+    - init from an array of terms
+    - append an array of terms
+    - clear out contents to a normal mpoly
+*/
+typedef struct _fmpz_mpoly_ts_struct
+{
+    fmpz * volatile coeffs; /* this is coeff_array[idx] */
+    ulong * volatile exps;       /* this is exp_array[idx] */
+    volatile slong length;
+    slong alloc;
+    flint_bitcnt_t bits;
+    flint_bitcnt_t idx;
+    ulong * exp_array[FLINT_BITS];
+    fmpz * coeff_array[FLINT_BITS];
+} fmpz_mpoly_ts_struct;
+
+typedef fmpz_mpoly_ts_struct fmpz_mpoly_ts_t[1];
+
+FLINT_DLL void fmpz_mpoly_ts_init(fmpz_mpoly_ts_t A,
+                              fmpz * Bcoeff, ulong * Bexp, slong Blen,
+                                                  flint_bitcnt_t bits, slong N);
+
+FLINT_DLL void fmpz_mpoly_ts_clear(fmpz_mpoly_ts_t A);
+
+FLINT_DLL void fmpz_mpoly_ts_clear_poly(fmpz_mpoly_t Q, fmpz_mpoly_ts_t A);
+
+FLINT_DLL void fmpz_mpoly_ts_append(fmpz_mpoly_ts_t A,
+                        fmpz * Bcoeff, ulong * Bexps, slong Blen, slong N);
+
+FLINT_DLL slong _fmpz_mpoly_mulsub_stripe1(fmpz ** A_coeff, ulong ** A_exp,
+                                                              slong * A_alloc,
+                         const fmpz * Dcoeff, const ulong * Dexp, slong Dlen, int saveD,
+                         const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                         const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                                                   const fmpz_mpoly_stripe_t S);
+
+FLINT_DLL slong _fmpz_mpoly_mulsub_stripe(fmpz ** A_coeff, ulong ** A_exp,
+                                                              slong * A_alloc,
+                         const fmpz * Dcoeff, const ulong * Dexp, slong Dlen, int saveD,
+                         const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+                         const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+                                                   const fmpz_mpoly_stripe_t S);
+
 
 /* Univariates ***************************************************************/
 
@@ -1170,6 +1411,11 @@ FLINT_DLL int fmpz_mpolyu_gcdm_zippel(fmpz_mpolyu_t G,
                  fmpz_mpolyu_t A, fmpz_mpolyu_t B, const fmpz_mpoly_ctx_t ctx,
                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate);
 
+FLINT_DLL int fmpz_mpolyu_gcdm_zippel_threaded(fmpz_mpolyu_t G,
+              fmpz_mpolyu_t A, fmpz_mpolyu_t B, const fmpz_mpoly_ctx_t ctx,
+                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate,
+                        const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL int fmpz_mpolyuu_gcd_berlekamp_massey(fmpz_mpolyu_t G,
     const fmpz_mpolyu_t A, const fmpz_mpolyu_t B, const fmpz_mpoly_t Gamma,
                                                    const fmpz_mpoly_ctx_t ctx);
@@ -12,26 +12,6 @@
 #include "thread_pool.h"
 #include "fmpz_mpoly.h"
 
-/*
-    a thread safe mpoly supports three mutating operations
-    - init from an array of terms
-    - append an array of terms
-    - clear out contents to a normal mpoly
-*/
-typedef struct _fmpz_mpoly_ts_struct
-{
-    fmpz * volatile coeffs; /* this is coeff_array[idx] */
-    ulong * volatile exps;       /* this is exp_array[idx] */
-    volatile slong length;
-    slong alloc;
-    flint_bitcnt_t bits;
-    flint_bitcnt_t idx;    
-    ulong * exp_array[FLINT_BITS];
-    fmpz * coeff_array[FLINT_BITS];
-} fmpz_mpoly_ts_struct;
-
-typedef fmpz_mpoly_ts_struct fmpz_mpoly_ts_t[1];
-
 /* Bcoeff is changed */
 void fmpz_mpoly_ts_init(fmpz_mpoly_ts_t A,
                               fmpz * Bcoeff, ulong * Bexp, slong Blen,
@@ -16,7 +16,7 @@
    Set poly1 to poly2/poly3 if the division is exact, and return the length
    of the quotient. Otherwise return 0. This version of the function assumes
    the exponent vectors all fit in a single word. The exponent vectors are
-   assumed to have fields with the given number of bits. Assumes input polys
+   assumed to have fields whose top bits are given by mask. Assumes input polys
    are nonzero. Implements "Polynomial division using dynamic arrays, heaps
    and packed exponents" by Michael Monagan and Roman Pearce [1], except that
    we divide from right to left and use a heap with smallest exponent at head.
@@ -24,7 +24,7 @@
 */
 slong _fmpz_mpoly_divides_monagan_pearce1(fmpz ** poly1, ulong ** exp1,
          slong * alloc, const fmpz * poly2, const ulong * exp2, slong len2,
-                const fmpz * poly3, const ulong * exp3, slong len3, slong bits,
+                const fmpz * poly3, const ulong * exp3, slong len3, ulong mask,
                                                                   ulong maskhi)
 {
     slong i, j, k, s;
@@ -36,7 +36,7 @@ slong _fmpz_mpoly_divides_monagan_pearce1(fmpz ** poly1, ulong ** exp1,
     fmpz * p1 = *poly1;
     ulong * e1 = *exp1;
     slong * hind;
-    ulong mask, exp, maxexp = exp2[len2 - 1];
+    ulong exp, maxexp = exp2[len2 - 1];
     fmpz_t r, acc_lg;
     ulong acc_sm[3];
     int lt_divides, small;
@@ -67,11 +67,6 @@ slong _fmpz_mpoly_divides_monagan_pearce1(fmpz ** poly1, ulong ** exp1,
     for (i = 0; i < len3; i++)
         hind[i] = 1;
 
-    /* mask with high bit set in each field of exponent vector */
-    mask = 0;
-    for (i = 0; i < FLINT_BITS/bits; i++)
-        mask = (mask << bits) + (UWORD(1) << (bits - 1));
-
     /* output poly index starts at -1, will be immediately updated to 0 */
     k = -WORD(1);
 
@@ -294,10 +289,16 @@ not_exact_division:
 }
 
 
-slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
+/*
+    As above with exponent vectors of N words. When bits <= FLINT_BITS the
+    word i of masks has the top bit of each field in word i of an exponent
+    vector set, so that the fields need not be of uniform width.
+*/
+static slong _divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
          slong * alloc, const fmpz * poly2, const ulong * exp2, slong len2,
-       const fmpz * poly3, const ulong * exp3, slong len3, flint_bitcnt_t bits, slong N,
-                                                         const ulong * cmpmask)
+                const fmpz * poly3, const ulong * exp3, slong len3,
+            flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                                           const ulong * masks)
 {
     slong i, j, k, s;
     slong next_loc;
@@ -313,7 +314,6 @@ slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
     slong exp_next;
     fmpz_t r, acc_lg;
     ulong acc_sm[3];
-    ulong mask;
     slong * hind;
     int lt_divides, small;
     slong bits2, bits3;
@@ -323,7 +323,7 @@ slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
     /* if exponent vectors are all one word, call specialised version */
     if (N == 1)
         return _fmpz_mpoly_divides_monagan_pearce1(poly1, exp1, alloc,
-                       poly2, exp2, len2, poly3, exp3, len3, bits, cmpmask[0]);
+                   poly2, exp2, len2, poly3, exp3, len3, masks[0], cmpmask[0]);
 
     TMP_START;
 
@@ -357,11 +357,6 @@ slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
     for (i = 0; i < len3; i++)
         hind[i] = 1;
 
-    /* mask with high bit set in each word of each field of exponent vector */
-    mask = 0;
-    for (i = 0; i < FLINT_BITS/bits; i++)
-        mask = (mask << bits) + (UWORD(1) << (bits - 1));
-
     /* output poly index starts at -1, will be immediately updated to 0 */
     k = -WORD(1);
 
@@ -392,7 +387,7 @@ slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
 
         if (bits <= FLINT_BITS)
         {
-            if (mpoly_monomial_overflows(exp, N, mask))
+            if (mpoly_monomial_overflows_varbits(exp, N, masks))
                 goto not_exact_division;
         } else
         {
@@ -404,7 +399,8 @@ slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
         _fmpz_mpoly_fit_length(&p1, &e1, alloc, k + 1, N);
 
         if (bits <= FLINT_BITS)
-            lt_divides = mpoly_monomial_divides(e1 + k*N, exp, exp3, N, mask);
+            lt_divides = mpoly_monomial_divides_varbits(e1 + k*N, exp, exp3,
+                                                                    N, masks);
         else
             lt_divides = mpoly_monomial_divides_mp(e1 + k*N, exp, exp3, N, bits);
 
@@ -622,6 +618,109 @@ not_exact_division:
     goto cleanup;
 }
 
+slong _fmpz_mpoly_divides_monagan_pearce(fmpz ** poly1, ulong ** exp1,
+         slong * alloc, const fmpz * poly2, const ulong * exp2, slong len2,
+       const fmpz * poly3, const ulong * exp3, slong len3, flint_bitcnt_t bits, slong N,
+                                                         const ulong * cmpmask)
+{
+    slong i, len;
+    ulong mask, * masks = NULL;
+    TMP_INIT;
+
+    TMP_START;
+
+    if (bits <= FLINT_BITS)
+    {
+        /* mask with high bit set in each field of exponent vector */
+        mask = 0;
+        for (i = 0; i < FLINT_BITS/bits; i++)
+            mask = (mask << bits) + (UWORD(1) << (bits - 1));
+
+        masks = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+        for (i = 0; i < N; i++)
+            masks[i] = mask;
+    }
+
+    len = _divides_monagan_pearce(poly1, exp1, alloc, poly2, exp2, len2,
+                                 poly3, exp3, len3, bits, N, cmpmask, masks);
+    TMP_END;
+
+    return len;
+}
+
+/*
+    Exponent vectors are packed as described by V, see mpoly_varbits_init.
+*/
+slong _fmpz_mpoly_divides_monagan_pearce_varbits(fmpz ** poly1, ulong ** exp1,
+         slong * alloc, const fmpz * poly2, const ulong * exp2, slong len2,
+                const fmpz * poly3, const ulong * exp3, slong len3,
+                                                       const mpoly_varbits_t V)
+{
+    return _divides_monagan_pearce(poly1, exp1, alloc, poly2, exp2, len2,
+             poly3, exp3, len3, FLINT_BITS, V->N, V->cmpmask, V->overflow_mask);
+}
+
+/*
+    Set Q to A/B using the packing V for the computation and return the length
+    of the quotient, or 0 if the division is not exact. The output is packed
+    into bits.
+*/
+static slong _divides_varbits(fmpz_mpoly_t Q, const fmpz_mpoly_t A,
+                    const fmpz_mpoly_t B, flint_bitcnt_t bits,
+                           const mpoly_varbits_t V, const fmpz_mpoly_ctx_t ctx)
+{
+    slong len, Talloc;
+    slong N = mpoly_words_per_exp_sp(bits, ctx->minfo);
+    ulong * Aexps, * Bexps, * Texps, * expq;
+    fmpz * Tcoeffs;
+    fmpz_mpoly_t T;
+    TMP_INIT;
+
+    TMP_START;
+
+    Aexps = (ulong *) flint_malloc(V->N*A->length*sizeof(ulong));
+    Bexps = (ulong *) flint_malloc(V->N*B->length*sizeof(ulong));
+    mpoly_varbits_pack(Aexps, A->exps, A->bits, A->length, V, ctx->minfo);
+    mpoly_varbits_pack(Bexps, B->exps, B->bits, B->length, V, ctx->minfo);
+
+    /* check leading monomial divides exactly */
+    expq = (ulong *) TMP_ALLOC(V->N*sizeof(ulong));
+    if (!mpoly_monomial_divides_varbits(expq, Aexps, Bexps, V->N,
+                                                             V->overflow_mask))
+    {
+        len = 0;
+        goto cleanup;
+    }
+
+    Talloc = A->length/B->length + 1;
+    Tcoeffs = (fmpz *) flint_calloc(Talloc, sizeof(fmpz));
+    Texps = (ulong *) flint_malloc(Talloc*V->N*sizeof(ulong));
+
+    len = _fmpz_mpoly_divides_monagan_pearce_varbits(&Tcoeffs, &Texps, &Talloc,
+                               A->coeffs, Aexps, A->length,
+                               B->coeffs, Bexps, B->length, V);
+
+    fmpz_mpoly_init3(T, 0, bits, ctx);
+    T->coeffs = Tcoeffs;
+    T->alloc = Talloc;
+    T->exps = (ulong *) flint_malloc(Talloc*N*sizeof(ulong));
+    mpoly_varbits_unpack(T->exps, bits, Texps, len, V, ctx->minfo);
+    T->length = len;
+    flint_free(Texps);
+
+    fmpz_mpoly_swap(Q, T, ctx);
+    fmpz_mpoly_clear(T, ctx);
+
+cleanup:
+
+    flint_free(Aexps);
+    flint_free(Bexps);
+
+    TMP_END;
+
+    return len;
+}
+
 /* return 1 if quotient is exact */
 int fmpz_mpoly_divides_monagan_pearce(fmpz_mpoly_t poly1,
                   const fmpz_mpoly_t poly2, const fmpz_mpoly_t poly3,
@@ -632,8 +731,9 @@ int fmpz_mpoly_divides_monagan_pearce(fmpz_mpoly_t poly1,
     fmpz * max_fields2, * max_fields3;
     ulong * cmpmask;
     ulong * exp2 = poly2->exps, * exp3 = poly3->exps, * expq;
-    int easy_exit, free2 = 0, free3 = 0;
+    int easy_exit, use_varbits, free2 = 0, free3 = 0;
     ulong mask = 0;
+    mpoly_varbits_t V;
     TMP_INIT;
 
    /* check divisor is nonzero */
@@ -680,6 +780,19 @@ int fmpz_mpoly_divides_monagan_pearce(fmpz_mpoly_t poly1,
     exp_bits = FLINT_MAX(exp_bits, poly3->bits);
     exp_bits = mpoly_fix_bits(exp_bits, ctx->minfo);
 
+    /*
+        If the fields have very different sizes, a packing with a width
+        for each field may need fewer words than exp_bits for every field.
+    */
+    use_varbits = 0;
+    if (!easy_exit && exp_bits <= FLINT_BITS)
+    {
+        mpoly_varbits_init(V, max_fields2, ctx->minfo);
+        use_varbits = V->N < mpoly_words_per_exp_sp(exp_bits, ctx->minfo);
+        if (!use_varbits)
+            mpoly_varbits_clear(V);
+    }
+
     for (i = 0; i < ctx->minfo->nfields; i++)
     {
         fmpz_clear(max_fields2 + i);
@@ -692,6 +805,13 @@ int fmpz_mpoly_divides_monagan_pearce(fmpz_mpoly_t poly1,
         goto cleanup;
     }
 
+    if (use_varbits)
+    {
+        len = _divides_varbits(poly1, poly2, poly3, exp_bits, V, ctx);
+        mpoly_varbits_clear(V);
+        goto cleanup;
+    }
+
     N = mpoly_words_per_exp(exp_bits, ctx->minfo);
     cmpmask = (ulong*) TMP_ALLOC(N*sizeof(ulong));
     mpoly_get_cmpmask(cmpmask, N, exp_bits, ctx->minfo);
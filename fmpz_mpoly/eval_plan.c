@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mpoly.h"
+
+
+void fmpz_mpoly_eval_plan_init(fmpz_mpoly_eval_plan_t P,
+                               const fmpz_mpoly_t A, const fmpz_mpoly_ctx_t ctx)
+{
+    fmpz_mpoly_init(&P->poly, ctx);
+    fmpz_mpoly_set(&P->poly, A, ctx);
+    mpoly_slp_init(&P->slp, ctx->minfo->nvars);
+    P->compiled = mpoly_slp_compile(&P->slp, P->poly.exps, P->poly.length,
+                                                    P->poly.bits, ctx->minfo);
+}
+
+
+void fmpz_mpoly_eval_plan_clear(fmpz_mpoly_eval_plan_t P,
+                                                    const fmpz_mpoly_ctx_t ctx)
+{
+    fmpz_mpoly_clear(&P->poly, ctx);
+    mpoly_slp_clear(&P->slp);
+}
+
+/*
+    Run the program with the values of the variables already in the first
+    nvars registers. t is temporary space.
+*/
+static void _eval_plan_run(fmpz_t ev, const fmpz_mpoly_eval_plan_t P,
+                                                      fmpz * regs, fmpz_t t)
+{
+    const mpoly_slp_struct * slp = &P->slp;
+    const fmpz * coeffs = P->poly.coeffs;
+    const fmpz * a, * b, * c;
+    fmpz * d;
+    slong j;
+
+    for (j = 0; j < slp->length; j++)
+    {
+        const mpoly_slp_instr_struct * in = slp->instrs + j;
+
+        d = regs + in->dst;
+        a = in->a >= 0 ? regs + in->a : coeffs + ~in->a;
+        b = in->b >= 0 ? regs + in->b : coeffs + ~in->b;
+        c = in->c >= 0 ? regs + in->c : coeffs + ~in->c;
+
+        switch (in->op)
+        {
+            case MPOLY_SLP_MUL:
+                fmpz_mul(d, a, b);
+                break;
+
+            case MPOLY_SLP_ADD:
+                fmpz_add(d, a, b);
+                break;
+
+            default:
+                FLINT_ASSERT(in->op == MPOLY_SLP_MULADD);
+                if (d == c)
+                {
+                    fmpz_addmul(d, a, b);
+                }
+                else
+                {
+                    fmpz_mul(t, a, b);
+                    fmpz_add(d, t, c);
+                }
+        }
+    }
+
+    fmpz_set(ev, slp->result >= 0 ? regs + slp->result
+                                  : coeffs + ~slp->result);
+}
+
+
+void fmpz_mpoly_eval_plan_evaluate_fmpz(fmpz_t ev,
+                   const fmpz_mpoly_eval_plan_t P, fmpz * const * vals,
+                                                    const fmpz_mpoly_ctx_t ctx)
+{
+    slong j;
+    fmpz * regs;
+    fmpz_t t;
+
+    if (P->poly.length == 0)
+    {
+        fmpz_zero(ev);
+        return;
+    }
+
+    if (!P->compiled)
+    {
+        fmpz_mpoly_evaluate_all_fmpz(ev, &P->poly, vals, ctx);
+        return;
+    }
+
+    fmpz_init(t);
+    regs = _fmpz_vec_init(P->slp.nregs);
+    for (j = 0; j < P->slp.nvars; j++)
+        fmpz_set(regs + j, vals[j]);
+
+    _eval_plan_run(ev, P, regs, t);
+
+    _fmpz_vec_clear(regs, P->slp.nregs);
+    fmpz_clear(t);
+}
+
+/*
+    Set ev + i to the value of P at the point
+    (vals + nvars*i + 0, ..., vals + nvars*i + nvars - 1) for 0 <= i < num.
+*/
+void fmpz_mpoly_eval_plan_evaluate_vec_fmpz(fmpz * ev,
+                     const fmpz_mpoly_eval_plan_t P, const fmpz * vals,
+                                       slong num, const fmpz_mpoly_ctx_t ctx)
+{
+    slong i, j, nvars = ctx->minfo->nvars;
+    fmpz * regs;
+    fmpz_t t;
+
+    if (P->poly.length == 0)
+    {
+        _fmpz_vec_zero(ev, num);
+        return;
+    }
+
+    if (!P->compiled)
+    {
+        fmpz ** v = (fmpz **) flint_malloc(FLINT_MAX(nvars, 1)*sizeof(fmpz *));
+        for (i = 0; i < num; i++)
+        {
+            for (j = 0; j < nvars; j++)
+                v[j] = (fmpz *) vals + nvars*i + j;
+            fmpz_mpoly_evaluate_all_fmpz(ev + i, &P->poly, v, ctx);
+        }
+        flint_free(v);
+        return;
+    }
+
+    fmpz_init(t);
+    regs = _fmpz_vec_init(P->slp.nregs);
+
+    for (i = 0; i < num; i++)
+    {
+        for (j = 0; j < nvars; j++)
+            fmpz_set(regs + j, vals + nvars*i + j);
+
+        _eval_plan_run(ev + i, P, regs, t);
+    }
+
+    _fmpz_vec_clear(regs, P->slp.nregs);
+    fmpz_clear(t);
+}
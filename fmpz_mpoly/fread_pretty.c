@@ -0,0 +1,194 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+/* number of characters read from the file at a time */
+#define FREAD_CHUNK_SIZE (WORD(1) << 20)
+
+/* return the position of the last sign in [0, sn) that starts a term */
+static slong _last_term(const char * s, slong sn)
+{
+    slong i, j;
+
+    for (i = sn - 1; i > 0; i--)
+    {
+        if (s[i] != '+' && s[i] != '-')
+            continue;
+
+        for (j = i - 1; j > 0 && s[j] == ' '; j--)
+            ;
+
+        if (('0' <= s[j] && s[j] <= '9') || ('a' <= s[j] && s[j] <= 'z')
+                         || ('A' <= s[j] && s[j] <= 'Z') || s[j] == '_')
+            return i;
+    }
+
+    return 0;
+}
+
+/*
+    The file is read in chunks. As long as the text is a sum of monomials,
+    each chunk is cut after its last complete term, the terms before the
+    cut are pushed onto A, and only the tail is kept for the next chunk.
+    Since the cut is at a top level sign, the value of the whole text is the
+    sum of the value of the consumed terms and the value of the rest. Once
+    some piece is not a sum of monomials, the rest of the file is collected
+    and handed to the general parser.
+*/
+static int _fmpz_mpoly_fread_pretty(FILE * file, fmpz_mpoly_t A, char ** x,
+                                                const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    int ret, split, slow, consumed, eof;
+    slong i, n, p, len, alloc;
+    char * buf;
+
+    fmpz_mpoly_zero(A, ctx);
+
+    split = _fmpz_mpoly_str_names_splittable(x, ctx->minfo->nvars);
+    slow = 0;
+    consumed = 0;
+    eof = 0;
+    len = 0;
+    alloc = FREAD_CHUNK_SIZE;
+    buf = (char *) flint_malloc(alloc*sizeof(char));
+
+    while (!eof)
+    {
+        if (len + FREAD_CHUNK_SIZE > alloc)
+        {
+            alloc = FLINT_MAX(len + FREAD_CHUNK_SIZE, 2*alloc);
+            buf = (char *) flint_realloc(buf, alloc*sizeof(char));
+        }
+
+        n = fread(buf + len, sizeof(char), FREAD_CHUNK_SIZE, file);
+        eof = (n < FREAD_CHUNK_SIZE);
+
+        for (i = len; i < len + n; i++)
+        {
+            if (buf[i] == '\n' || buf[i] == '\r' || buf[i] == '\t'
+                               || buf[i] == '\v' || buf[i] == '\f')
+            {
+                buf[i] = ' ';
+            }
+        }
+        len += n;
+
+        if (slow || !split || eof)
+            continue;
+
+        p = _last_term(buf, len);
+        if (p < 1)
+            continue;
+
+        if (_fmpz_mpoly_push_str_monomials_threaded(A, buf, p, x, ctx,
+                                                         handles, num_handles))
+        {
+            memmove(buf, buf + p, (len - p)*sizeof(char));
+            len -= p;
+            consumed = 1;
+        }
+        else
+        {
+            slow = 1;
+        }
+    }
+
+    if (!slow && _fmpz_mpoly_push_str_monomials_threaded(A, buf, len, x, ctx,
+                                                         handles, num_handles))
+    {
+        _fmpz_mpoly_sort_terms_threaded(A, ctx, handles, num_handles);
+        _fmpz_mpoly_combine_like_terms_threaded(A, ctx, handles, num_handles);
+        ret = 0;
+    }
+    else if (!consumed)
+    {
+        ret = _fmpz_mpoly_parse_pretty(A, buf, len, x, ctx);
+    }
+    else
+    {
+        fmpz_mpoly_t T;
+        fmpz_mpoly_init(T, ctx);
+        ret = _fmpz_mpoly_parse_pretty(T, buf, len, x, ctx);
+        if (ret == 0)
+        {
+            _fmpz_mpoly_sort_terms_threaded(A, ctx, handles, num_handles);
+            _fmpz_mpoly_combine_like_terms_threaded(A, ctx,
+                                                         handles, num_handles);
+            fmpz_mpoly_add(A, A, T, ctx);
+        }
+        else
+        {
+            fmpz_mpoly_zero(A, ctx);
+        }
+        fmpz_mpoly_clear(T, ctx);
+    }
+
+    flint_free(buf);
+
+    return ret;
+}
+
+int fmpz_mpoly_fread_pretty(FILE * file, fmpz_mpoly_t A,
+                                 const char ** x_in, const fmpz_mpoly_ctx_t ctx)
+{
+    int ret;
+    slong i, nvars = ctx->minfo->nvars;
+    char ** x = (char **) x_in;
+    thread_pool_handle * handles;
+    slong num_handles;
+    TMP_INIT;
+
+    TMP_START;
+    if (x == NULL)
+    {
+        x = (char **) TMP_ALLOC(nvars*sizeof(char *));
+        for (i = 0; i < nvars; i++)
+        {
+            x[i] = (char *) TMP_ALLOC(22*sizeof(char));
+            flint_sprintf(x[i], "x%wd", i + 1);
+        }
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(MPOLY_DEFAULT_THREAD_LIMIT - 1,
+                                                              max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    ret = _fmpz_mpoly_fread_pretty(file, A, x, ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+    TMP_END;
+    return ret;
+}
@@ -80,7 +80,9 @@ static int _try_zippel(
     const ulong * Bmin_exp,
     const slong * Bmax_exp_count,
     const slong * Bmin_exp_count,
-    const fmpz_mpoly_ctx_t ctx)
+    const fmpz_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
 {
     slong i, j, k;
     slong n, m;
@@ -296,7 +298,8 @@ static int _try_zippel(
     /* after removing content, degree bounds in zinfo are still valid bounds */
 
     /* compute GCD */
-    success = fmpz_mpolyu_gcdm_zippel(Gbar, Abar, Bbar, uctx, zinfo, randstate);
+    success = fmpz_mpolyu_gcdm_zippel_threaded(Gbar, Abar, Bbar, uctx, zinfo,
+                                               randstate, handles, num_handles);
     if (!success)
         goto cleanup;
 
@@ -1337,7 +1340,8 @@ int _fmpz_mpoly_gcd(
 
     success = _try_zippel(G, Gbits, Gstride,
                    A, Amax_exp, Amin_exp, Amax_exp_count, Amin_exp_count,
-                   B, Bmax_exp, Bmin_exp, Bmax_exp_count, Bmin_exp_count, ctx);
+                   B, Bmax_exp, Bmin_exp, Bmax_exp_count, Bmin_exp_count, ctx,
+                                                         handles, num_handles);
 
 cleanup:
 
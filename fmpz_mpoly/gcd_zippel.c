@@ -11,6 +11,7 @@
 
 #include "nmod_mpoly.h"
 #include "fmpz_mpoly.h"
+#include "thread_pool.h"
 
 
 void nmod_mpoly_ctx_change_modulus(nmod_mpoly_ctx_t ctx, mp_limb_t modulus)
@@ -100,13 +101,15 @@ flint_bitcnt_t fmpz_mpolyu_gcd_bitbound(const fmpz_t gcdlc,
     return r;
 }
 
-int fmpz_mpolyu_gcdm_zippel(
+int fmpz_mpolyu_gcdm_zippel_threaded(
     fmpz_mpolyu_t G,
     fmpz_mpolyu_t A,
     fmpz_mpolyu_t B,
     const fmpz_mpoly_ctx_t ctx,
     mpoly_zipinfo_t zinfo,
-    flint_rand_t randstate)
+    flint_rand_t randstate,
+    const thread_pool_handle * handles,
+    slong num_handles)
 {
     flint_bitcnt_t coeffbitbound;
     flint_bitcnt_t coeffbits;
@@ -171,8 +174,8 @@ choose_prime_outer:
     if (Ap->length == 0 || Bp->length == 0)
         goto choose_prime_outer;
 
-    success = nmod_mpolyu_gcdp_zippel(Gp, Ap, Bp, ctx->minfo->nvars - 1,
-                                                       ctxp, zinfo, randstate);
+    success = nmod_mpolyu_gcdp_zippel_threaded(Gp, Ap, Bp,
+           ctx->minfo->nvars - 1, ctxp, zinfo, randstate, handles, num_handles);
     if (!success || Gp->exps[0] > degbound)
         goto choose_prime_outer;
     degbound = Gp->exps[0];
@@ -220,8 +223,9 @@ choose_prime_inner:
     if (Ap->length == 0 || Bp->length == 0)
         goto choose_prime_inner;
 
-    switch (nmod_mpolyu_gcds_zippel(Gp, Ap, Bp, Gform, ctx->minfo->nvars,
-                                                   ctxp, randstate, &degbound))
+    switch (nmod_mpolyu_gcds_zippel_threaded(Gp, Ap, Bp, Gform,
+                               ctx->minfo->nvars, ctxp, randstate, &degbound,
+                                                         handles, num_handles))
     {
         default:
             FLINT_ASSERT(0);
@@ -284,13 +288,27 @@ cleanup:
     return success;
 }
 
+int fmpz_mpolyu_gcdm_zippel(
+    fmpz_mpolyu_t G,
+    fmpz_mpolyu_t A,
+    fmpz_mpolyu_t B,
+    const fmpz_mpoly_ctx_t ctx,
+    mpoly_zipinfo_t zinfo,
+    flint_rand_t randstate)
+{
+    return fmpz_mpolyu_gcdm_zippel_threaded(G, A, B, ctx, zinfo, randstate,
+                                                                      NULL, 0);
+}
+
 
 int _fmpz_mpoly_gcd_zippel(fmpz_mpoly_t G, const fmpz_mpoly_t A,
      const fmpz_mpoly_t B, const fmpz_mpoly_ctx_t ctx, flint_rand_t randstate);
 
-int fmpz_mpolyu_gcd_zippel(fmpz_mpolyu_t G,
+/* the content is found serially, only the final gcdm uses the handles */
+static int _fmpz_mpolyu_gcd_zippel_threaded(fmpz_mpolyu_t G,
                     fmpz_mpolyu_t A, fmpz_mpolyu_t B, fmpz_mpoly_ctx_t ctx,
-                                mpoly_zipinfo_t zinfo, flint_rand_t randstate)
+                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate,
+                         const thread_pool_handle * handles, slong num_handles)
 {
     int success = 0;
     slong i;
@@ -334,7 +352,8 @@ int fmpz_mpolyu_gcd_zippel(fmpz_mpolyu_t G,
     fmpz_mpolyu_shift_right(Abar, Abar->exps[Abar->length - 1]);
     fmpz_mpolyu_shift_right(Bbar, Bbar->exps[Bbar->length - 1]);
 
-    success = fmpz_mpolyu_gcdm_zippel(Gbar, Abar, Bbar, ctx, zinfo, randstate);
+    success = fmpz_mpolyu_gcdm_zippel_threaded(Gbar, Abar, Bbar, ctx, zinfo,
+                                               randstate, handles, num_handles);
     if (!success)
         goto finished;
 
@@ -353,6 +372,14 @@ finished:
     return 1;
 }
 
+int fmpz_mpolyu_gcd_zippel(fmpz_mpolyu_t G,
+                    fmpz_mpolyu_t A, fmpz_mpolyu_t B, fmpz_mpoly_ctx_t ctx,
+                                mpoly_zipinfo_t zinfo, flint_rand_t randstate)
+{
+    return _fmpz_mpolyu_gcd_zippel_threaded(G, A, B, ctx, zinfo, randstate,
+                                                                      NULL, 0);
+}
+
 
 /* like fmpz_mpoly_gcd_zippel, but G and A and B all have the same bits */
 int _fmpz_mpoly_gcd_zippel(fmpz_mpoly_t G, const fmpz_mpoly_t A,
@@ -445,11 +472,12 @@ cleanup1:
 }
 
 
-int fmpz_mpoly_gcd_zippel(
+int fmpz_mpoly_gcd_zippel_threaded(
     fmpz_mpoly_t G,
     const fmpz_mpoly_t A,
     const fmpz_mpoly_t B,
-    const fmpz_mpoly_ctx_t ctx)
+    const fmpz_mpoly_ctx_t ctx,
+    slong thread_limit)
 {
     slong i;
     flint_bitcnt_t new_bits;
@@ -459,6 +487,8 @@ int fmpz_mpoly_gcd_zippel(
     fmpz_mpoly_ctx_t uctx;
     fmpz_mpolyu_t Au, Bu, Gu;
     ulong * shift, * stride;
+    thread_pool_handle * handles;
+    slong num_handles;
 
     if (fmpz_mpoly_is_zero(A, ctx))
     {
@@ -548,7 +578,30 @@ int fmpz_mpoly_gcd_zippel(
     fmpz_mpoly_to_mpolyu_perm_deflate(Bu, uctx, B, ctx,
                                     zinfo->perm, shift, stride, NULL, NULL, 0);
 
-    success = fmpz_mpolyu_gcd_zippel(Gu, Au, Bu, uctx, zinfo, randstate);
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    success = _fmpz_mpolyu_gcd_zippel_threaded(Gu, Au, Bu, uctx, zinfo,
+                                               randstate, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles)
+        flint_free(handles);
+
     if (!success)
         goto cleanup;
 
@@ -575,3 +628,12 @@ cleanup1:
 
     return success;
 }
+
+int fmpz_mpoly_gcd_zippel(
+    fmpz_mpoly_t G,
+    const fmpz_mpoly_t A,
+    const fmpz_mpoly_t B,
+    const fmpz_mpoly_ctx_t ctx)
+{
+    return fmpz_mpoly_gcd_zippel_threaded(G, A, B, ctx, 1);
+}
@@ -0,0 +1,61 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mpoly.h"
+
+/*
+    The exponents are read in one block straight into A, and the
+    coefficients are then streamed one at a time, so that no intermediate
+    copy of the polynomial is ever held in memory.
+*/
+size_t fmpz_mpoly_inp_raw(fmpz_mpoly_t A, FILE * file,
+                                                    const fmpz_mpoly_ctx_t ctx)
+{
+    slong i, N, length;
+    flint_bitcnt_t bits;
+    size_t r, size;
+    ulong header[MPOLY_RAW_HEADER_LENGTH];
+
+    fmpz_mpoly_zero(A, ctx);
+
+    r = fread(header, sizeof(ulong), MPOLY_RAW_HEADER_LENGTH, file);
+    if (r != MPOLY_RAW_HEADER_LENGTH)
+        return 0;
+    if (!mpoly_raw_header_get(&bits, &length, header, 0, ctx->minfo))
+        return 0;
+    size = MPOLY_RAW_HEADER_LENGTH*sizeof(ulong);
+
+    N = mpoly_words_per_exp(bits, ctx->minfo);
+
+    fmpz_mpoly_fit_length(A, length, ctx);
+    fmpz_mpoly_fit_bits(A, bits, ctx);
+    A->bits = bits;
+
+    r = fread(A->exps, sizeof(ulong), N*length, file);
+    if (r != (size_t) (N*length))
+        return 0;
+    size += N*length*sizeof(ulong);
+
+    for (i = 0; i < length; i++)
+    {
+        r = fmpz_inp_raw(A->coeffs + i, file);
+        if (r == 0 || fmpz_is_zero(A->coeffs + i))
+        {
+            _fmpz_vec_zero(A->coeffs, i + 1);
+            return 0;
+        }
+        size += r;
+    }
+
+    _fmpz_mpoly_set_length(A, length, ctx);
+
+    return size;
+}
@@ -9,6 +9,7 @@
     (at your option) any later version.  See <http://www.gnu.org/licenses/>.
 */
 
+#include "thread_pool.h"
 #include "fmpz_mpoly.h"
 
 
@@ -239,13 +240,182 @@ void fmpz_mpoly_consume_fmpz_mpolyd_clear(fmpz_mpoly_t A, fmpz_mpolyd_t B,
 
 
 
-int _fmpz_mpoly_mul_dense(fmpz_mpoly_t P,
+/*
+    The Kronecker substitution of the dense product is split along the
+    outermost variable: the longer factor is cut into one run of consecutive
+    outer slices (each of length "stride") per thread and each run is
+    multiplied by the full other factor. The partial products overlap, so in
+    a second pass each thread sums the pieces landing in its own disjoint
+    slab of the output.
+*/
+typedef struct
+{
+    fmpz_poly_struct * P;
+    const fmpz_poly_struct * A;
+    const fmpz_poly_struct * B;
+    fmpz_poly_struct * T;
+    slong * Toff;
+    slong num_chunks;
+    slong num_slices;
+    slong stride;
+}
+_chunked_base_struct;
+
+typedef _chunked_base_struct _chunked_base_t[1];
+
+typedef struct
+{
+    _chunked_base_struct * base;
+    slong idx;
+}
+_chunked_arg_struct;
+
+static void _chunked_mul_worker(void * varg)
+{
+    _chunked_arg_struct * arg = (_chunked_arg_struct *) varg;
+    _chunked_base_struct * base = arg->base;
+    slong i = arg->idx, K = base->num_chunks;
+    slong start, stop;
+    const fmpz * Acoeffs = base->A->coeffs;
+    fmpz_poly_struct a[1];
+
+    start = base->stride*(base->num_slices*i/K);
+    stop = base->stride*(base->num_slices*(i + 1)/K);
+    stop = FLINT_MIN(stop, base->A->length);
+
+    while (start < stop && fmpz_is_zero(Acoeffs + start))
+        start++;
+    while (stop > start && fmpz_is_zero(Acoeffs + stop - 1))
+        stop--;
+
+    base->Toff[i] = start;
+    if (start >= stop)
+    {
+        fmpz_poly_zero(base->T + i);
+        return;
+    }
+
+    /* let a borrow the run of A */
+    a->coeffs = (fmpz *) Acoeffs + start;
+    a->alloc = stop - start;
+    a->length = stop - start;
+
+    fmpz_poly_mul(base->T + i, a, base->B);
+}
+
+static void _chunked_merge_worker(void * varg)
+{
+    _chunked_arg_struct * arg = (_chunked_arg_struct *) varg;
+    _chunked_base_struct * base = arg->base;
+    slong i, j = arg->idx, K = base->num_chunks;
+    slong lo, hi, s, e, Plen = base->P->length;
+    fmpz * Pcoeffs = base->P->coeffs;
+
+    lo = Plen*j/K;
+    hi = Plen*(j + 1)/K;
+
+    _fmpz_vec_zero(Pcoeffs + lo, hi - lo);
+
+    for (i = 0; i < K; i++)
+    {
+        s = FLINT_MAX(lo, base->Toff[i]);
+        e = FLINT_MIN(hi, base->Toff[i] + base->T[i].length);
+        if (s < e)
+            _fmpz_vec_add(Pcoeffs + s, Pcoeffs + s,
+                              base->T[i].coeffs + s - base->Toff[i], e - s);
+    }
+}
+
+/* P = A*B where A and B are Kronecker substitutions with outer slices of
+   length stride; P should not alias A or B */
+static void _fmpz_poly_mul_chunked(fmpz_poly_t P,
+                            const fmpz_poly_t A, const fmpz_poly_t B,
+     slong stride, const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, K;
+    _chunked_base_t base;
+    _chunked_arg_struct * args;
+
+    if (A->length == 0 || B->length == 0)
+    {
+        fmpz_poly_zero(P);
+        return;
+    }
+
+    /* cut the longer factor */
+    if (A->length < B->length)
+    {
+        const fmpz_poly_struct * t = A;
+        A = B;
+        B = t;
+    }
+
+    base->num_slices = (A->length + stride - 1)/stride;
+    K = FLINT_MIN(num_handles + 1, base->num_slices);
+    if (K < 2)
+    {
+        fmpz_poly_mul(P, A, B);
+        return;
+    }
+
+    base->P = P;
+    base->A = A;
+    base->B = B;
+    base->num_chunks = K;
+    base->stride = stride;
+    base->Toff = (slong *) flint_malloc(K*sizeof(slong));
+    base->T = (fmpz_poly_struct *) flint_malloc(K*sizeof(fmpz_poly_struct));
+    args = (_chunked_arg_struct *) flint_malloc(K*sizeof(_chunked_arg_struct));
+    for (i = 0; i < K; i++)
+    {
+        fmpz_poly_init(base->T + i);
+        args[i].base = base;
+        args[i].idx = i;
+    }
+
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                _chunked_mul_worker, &args[i]);
+    }
+    _chunked_mul_worker(&args[K - 1]);
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    fmpz_poly_fit_length(P, A->length + B->length - 1);
+    P->length = A->length + B->length - 1;
+
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                              _chunked_merge_worker, &args[i]);
+    }
+    _chunked_merge_worker(&args[K - 1]);
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    _fmpz_poly_normalise(P);
+
+    for (i = 0; i < K; i++)
+        fmpz_poly_clear(base->T + i);
+    flint_free(base->T);
+    flint_free(base->Toff);
+    flint_free(args);
+}
+
+
+int _fmpz_mpoly_mul_dense_threaded(fmpz_mpoly_t P,
                                  const fmpz_mpoly_t A, fmpz * maxAfields,
                                  const fmpz_mpoly_t B, fmpz * maxBfields,
-                                                    const fmpz_mpoly_ctx_t ctx)
+                                                    const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
 {
     int success, P_is_stolen;
-    slong i;
+    slong i, stride;
     slong nvars = ctx->minfo->nvars;
     fmpz_mpolyd_t Ad, Bd, Pd;
     fmpz_poly_t Au, Bu, Pu;
@@ -336,7 +506,12 @@ int _fmpz_mpoly_mul_dense(fmpz_mpoly_t P,
     Pu->coeffs = Pd->coeffs;
     Pu->length = 0;
 
-    fmpz_poly_mul(Pu, Au, Bu);
+    /* length of a slice of the outermost variable */
+    stride = 1;
+    for (i = 1; i < nvars; i++)
+        stride *= Pbounds[i];
+
+    _fmpz_poly_mul_chunked(Pu, Au, Bu, stride, handles, num_handles);
 
     /* manually move Pu to P */
     Pd->coeff_alloc = Pu->alloc;
@@ -369,12 +544,23 @@ failed_stage1:
 
 
 
-int fmpz_mpoly_mul_dense(fmpz_mpoly_t A, const fmpz_mpoly_t B,
-                              const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx)
+int _fmpz_mpoly_mul_dense(fmpz_mpoly_t P,
+                                 const fmpz_mpoly_t A, fmpz * maxAfields,
+                                 const fmpz_mpoly_t B, fmpz * maxBfields,
+                                                    const fmpz_mpoly_ctx_t ctx)
+{
+    return _fmpz_mpoly_mul_dense_threaded(P, A, maxAfields, B, maxBfields,
+                                                                  ctx, NULL, 0);
+}
+
+int fmpz_mpoly_mul_dense_threaded(fmpz_mpoly_t A, const fmpz_mpoly_t B,
+       const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx, slong thread_limit)
 {
     slong i;
     int success;
     fmpz * maxBfields, * maxCfields;
+    thread_pool_handle * handles;
+    slong num_handles;
     TMP_INIT;
 
     if (B->length == 0 || C->length == 0)
@@ -400,7 +586,33 @@ int fmpz_mpoly_mul_dense(fmpz_mpoly_t A, const fmpz_mpoly_t B,
     mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
     mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
 
-    success = _fmpz_mpoly_mul_dense(A, B, maxBfields, C, maxCfields, ctx);
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    success = _fmpz_mpoly_mul_dense_threaded(A, B, maxBfields, C, maxCfields,
+                                                    ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
 
     for (i = 0; i < ctx->minfo->nfields; i++)
     {
@@ -411,3 +623,9 @@ int fmpz_mpoly_mul_dense(fmpz_mpoly_t A, const fmpz_mpoly_t B,
     TMP_END;
     return success;
 }
+
+int fmpz_mpoly_mul_dense(fmpz_mpoly_t A, const fmpz_mpoly_t B,
+                              const fmpz_mpoly_t C, const fmpz_mpoly_ctx_t ctx)
+{
+    return fmpz_mpoly_mul_dense_threaded(A, B, C, ctx, 1);
+}
@@ -0,0 +1,323 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "fmpz_mpoly.h"
+
+
+/*
+    Each slot of the table holds S = N + 4 words:
+        [0]             hash of the monomial with the top bit set, 0 if empty
+        [1, N + 1)      the monomial
+        [N + 1, N + 4)  three word accumulator for the coefficient if the
+                        inputs are small, otherwise an fmpz in [N + 1]
+    so that a probe touches only one place in memory.
+*/
+static ulong * _hash_table_grow(ulong * table, ulong * mask, slong S)
+{
+    slong i;
+    ulong loc, newmask = 2*(*mask) + 1;
+    ulong * newtable;
+
+    newtable = (ulong *) flint_calloc(S*(newmask + 1), sizeof(ulong));
+
+    for (i = 0; i <= *mask; i++)
+    {
+        if (table[S*i] == 0)
+            continue;
+
+        loc = table[S*i] & newmask;
+        while (newtable[S*loc] != 0)
+            loc = (loc + 1) & newmask;
+        memcpy(newtable + S*loc, table + S*i, S*sizeof(ulong));
+    }
+
+    flint_free(table);
+    *mask = newmask;
+    return newtable;
+}
+
+/* how far ahead in a row the table slots are prefetched */
+#define PREFETCH_DISTANCE 8
+
+/*
+    Set (*A_coeff, *A_exp) to the sum of the products B[i]*C[j] whose
+    monomial hash h satisfies floor(h*num/2^FLINT_BITS) = which.
+    The exponents are assumed packed into bits with no overflow possible.
+    The output is not sorted, but it has no repeated monomials and no zero
+    coefficients. The return is the length of the output.
+*/
+slong _fmpz_mpoly_mul_hash(
+    fmpz ** A_coeff, ulong ** A_exp, slong * A_alloc,
+    const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+    const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+    flint_bitcnt_t bits, slong N,
+    slong which, slong num)
+{
+    slong i, j, Alen, S = N + 4;
+    ulong h, hi, lo, loc, mask, cy;
+    ulong p[2];
+    ulong * table, * t, * e, * rowexps, * rowhashes;
+    fmpz * Acoeff = *A_coeff;
+    ulong * Aexp = *A_exp;
+    int small;
+
+    FLINT_ASSERT(Blen > 0);
+    FLINT_ASSERT(Clen > 0);
+    FLINT_ASSERT(0 <= which && which < num);
+
+    /* whether input coeffs are small, thus output coeffs fit in three words */
+    small = _fmpz_mpoly_fits_small(Bcoeff, Blen) &&
+                                         _fmpz_mpoly_fits_small(Ccoeff, Clen);
+
+    /* the table is grown as needed */
+    mask = 255;
+    while (mask < 2*(Blen + Clen)/num)
+        mask = 2*mask + 1;
+    table = (ulong *) flint_calloc(S*(mask + 1), sizeof(ulong));
+
+    rowexps = (ulong *) flint_malloc(N*Clen*sizeof(ulong));
+    rowhashes = (ulong *) flint_malloc(Clen*sizeof(ulong));
+
+    Alen = 0;
+    for (i = 0; i < Blen; i++)
+    {
+        /* monomials and hashes of this row of products */
+        for (j = 0; j < Clen; j++)
+        {
+            e = rowexps + N*j;
+            if (bits <= FLINT_BITS)
+                mpoly_monomial_add(e, Bexp + N*i, Cexp + N*j, N);
+            else
+                mpoly_monomial_add_mp(e, Bexp + N*i, Cexp + N*j, N);
+
+            /* a zero marks products that belong to other threads */
+            h = mpoly_monomial_hash(e, N);
+            rowhashes[j] = 0;
+            if (num > 1)
+            {
+                umul_ppmm(hi, lo, h, (ulong) num);
+                if (hi != (ulong) which)
+                    continue;
+            }
+            rowhashes[j] = h | (UWORD(1) << (FLINT_BITS - 1));
+        }
+
+        for (j = 0; j < Clen; j++)
+        {
+            if (j + PREFETCH_DISTANCE < Clen)
+                MPOLY_PREFETCH(table + S*(rowhashes[j + PREFETCH_DISTANCE]
+                                                                     & mask));
+            h = rowhashes[j];
+            if (h == 0)
+                continue;
+
+            e = rowexps + N*j;
+            loc = h & mask;
+            t = table + S*loc;
+            while (t[0] != 0 && (t[0] != h ||
+                                          !mpoly_monomial_equal(t + 1, e, N)))
+            {
+                loc = (loc + 1) & mask;
+                t = table + S*loc;
+            }
+
+            if (t[0] == 0)
+            {
+                t[0] = h;
+                mpoly_monomial_set(t + 1, e, N);
+                if (small)
+                {
+                    smul_ppmm(t[N + 2], t[N + 1], Bcoeff[i], Ccoeff[j]);
+                    t[N + 3] = -(t[N + 2] >> (FLINT_BITS - 1));
+                }
+                else
+                {
+                    fmpz_mul((fmpz *) (t + N + 1), Bcoeff + i, Ccoeff + j);
+                }
+
+                Alen++;
+                if (2*Alen > mask)
+                    table = _hash_table_grow(table, &mask, S);
+            }
+            else
+            {
+                t += N + 1;
+                if (small)
+                {
+                    smul_ppmm(p[1], p[0], Bcoeff[i], Ccoeff[j]);
+                    add_sssaaaaaa(cy, t[1], t[0], 0, t[1], t[0], 0, p[1], p[0]);
+                    t[2] += (0 <= (slong) p[1]) ? cy : cy - 1;
+                }
+                else
+                {
+                    fmpz_addmul((fmpz *) t, Bcoeff + i, Ccoeff + j);
+                }
+            }
+        }
+    }
+
+    /* write out the nonzero terms */
+    _fmpz_mpoly_fit_length(&Acoeff, &Aexp, A_alloc, Alen, N);
+    Alen = 0;
+    for (i = 0; i <= mask; i++)
+    {
+        t = table + S*i;
+        if (t[0] == 0)
+            continue;
+
+        if (small)
+        {
+            fmpz_set_signed_uiuiui(Acoeff + Alen, t[N + 3], t[N + 2],
+                                                                    t[N + 1]);
+        }
+        else
+        {
+            fmpz_swap(Acoeff + Alen, (fmpz *) (t + N + 1));
+            fmpz_clear((fmpz *) (t + N + 1));
+        }
+
+        if (!fmpz_is_zero(Acoeff + Alen))
+        {
+            mpoly_monomial_set(Aexp + N*Alen, t + 1, N);
+            Alen++;
+        }
+    }
+
+    flint_free(table);
+    flint_free(rowexps);
+    flint_free(rowhashes);
+
+    *A_coeff = Acoeff;
+    *A_exp = Aexp;
+
+    return Alen;
+}
+
+
+void _fmpz_mpoly_mul_hash_maxfields(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B, fmpz * maxBfields,
+    const fmpz_mpoly_t C, fmpz * maxCfields,
+    const fmpz_mpoly_ctx_t ctx)
+{
+    slong N, Alen;
+    flint_bitcnt_t Abits;
+    ulong * Bexp, * Cexp;
+    int freeBexp, freeCexp;
+    fmpz_mpoly_t T;
+    fmpz_mpoly_struct * P;
+
+    _fmpz_vec_add(maxBfields, maxBfields, maxCfields, ctx->minfo->nfields);
+
+    Abits = _fmpz_vec_max_bits(maxBfields, ctx->minfo->nfields);
+    Abits = FLINT_MAX(MPOLY_MIN_BITS, Abits + 1);
+    Abits = FLINT_MAX(Abits, B->bits);
+    Abits = FLINT_MAX(Abits, C->bits);
+    Abits = mpoly_fix_bits(Abits, ctx->minfo);
+
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+
+    /* ensure input exponents are packed into same sized fields as output */
+    freeBexp = 0;
+    Bexp = B->exps;
+    if (Abits > B->bits)
+    {
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
+    }
+
+    freeCexp = 0;
+    Cexp = C->exps;
+    if (Abits > C->bits)
+    {
+        freeCexp = 1;
+        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits,
+                                                        C->length, ctx->minfo);
+    }
+
+    /* deal with aliasing and do multiplication */
+    if (A == B || A == C)
+    {
+        fmpz_mpoly_init(T, ctx);
+        P = T;
+    }
+    else
+    {
+        P = A;
+    }
+
+    fmpz_mpoly_fit_length(P, B->length + C->length - 1, ctx);
+    fmpz_mpoly_fit_bits(P, Abits, ctx);
+    P->bits = Abits;
+
+    Alen = _fmpz_mpoly_mul_hash(&P->coeffs, &P->exps, &P->alloc,
+                                             B->coeffs, Bexp, B->length,
+                                             C->coeffs, Cexp, C->length,
+                                                               Abits, N, 0, 1);
+    _fmpz_mpoly_set_length(P, Alen, ctx);
+    fmpz_mpoly_sort_terms(P, ctx);
+
+    if (P == T)
+    {
+        fmpz_mpoly_swap(T, A, ctx);
+        fmpz_mpoly_clear(T, ctx);
+    }
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    if (freeCexp)
+        flint_free(Cexp);
+}
+
+
+void fmpz_mpoly_mul_hash(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B,
+    const fmpz_mpoly_t C,
+    const fmpz_mpoly_ctx_t ctx)
+{
+    slong i;
+    fmpz * maxBfields, * maxCfields;
+    TMP_INIT;
+
+    if (B->length == 0 || C->length == 0)
+    {
+        fmpz_mpoly_zero(A, ctx);
+        return;
+    }
+
+    TMP_START;
+
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxCfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxBfields + i);
+        fmpz_init(maxCfields + i);
+    }
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
+
+    _fmpz_mpoly_mul_hash_maxfields(A, B, maxBfields, C, maxCfields, ctx);
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxBfields + i);
+        fmpz_clear(maxCfields + i);
+    }
+
+    TMP_END;
+}
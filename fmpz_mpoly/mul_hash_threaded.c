@@ -0,0 +1,309 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+typedef struct
+{
+    slong nthreads;
+    fmpz * Acoeff;
+    ulong * Aexp;
+    const fmpz * Bcoeff;
+    const ulong * Bexp;
+    slong Blen;
+    const fmpz * Ccoeff;
+    const ulong * Cexp;
+    slong Clen;
+    slong N;
+    flint_bitcnt_t bits;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    slong idx;
+    _base_struct * base;
+    slong Aoffset;
+    slong Alen;
+    slong Aalloc;
+    ulong * Aexp;
+    fmpz * Acoeff;
+}
+_worker_arg_struct;
+
+/* each worker owns the monomials whose hash falls into its range */
+static void _hash_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+
+    arg->Alen = _fmpz_mpoly_mul_hash(&arg->Acoeff, &arg->Aexp, &arg->Aalloc,
+                                   base->Bcoeff, base->Bexp, base->Blen,
+                                   base->Ccoeff, base->Cexp, base->Clen,
+                              base->bits, base->N, arg->idx, base->nthreads);
+}
+
+/* move the terms of each worker into place */
+static void _join_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong i, N = base->N;
+
+    for (i = 0; i < arg->Alen; i++)
+        fmpz_swap(base->Acoeff + arg->Aoffset + i, arg->Acoeff + i);
+
+    if (arg->Alen > 0)
+    {
+        memcpy(base->Aexp + N*arg->Aoffset, arg->Aexp,
+                                                 N*arg->Alen*sizeof(ulong));
+    }
+}
+
+/*
+    Set A to B*C. The exponents of B and C are packed into Abits with no
+    overflow possible and A has been set to this bit count.
+*/
+void _fmpz_mpoly_mul_hash_threaded(
+    fmpz_mpoly_t A,
+    const fmpz * Bcoeff, const ulong * Bexp, slong Blen,
+    const fmpz * Ccoeff, const ulong * Cexp, slong Clen,
+    flint_bitcnt_t bits,
+    slong N,
+    const fmpz_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong i, j, Alen;
+    _base_t base;
+    _worker_arg_struct * args;
+
+    base->nthreads = num_handles + 1;
+    base->Bcoeff = Bcoeff;
+    base->Bexp = Bexp;
+    base->Blen = Blen;
+    base->Ccoeff = Ccoeff;
+    base->Cexp = Cexp;
+    base->Clen = Clen;
+    base->N = N;
+    base->bits = bits;
+
+    args = (_worker_arg_struct *) flint_malloc(base->nthreads
+                                                  *sizeof(_worker_arg_struct));
+
+    for (i = 0; i < base->nthreads; i++)
+    {
+        args[i].idx = i;
+        args[i].base = base;
+        args[i].Aalloc = 0;
+        args[i].Acoeff = NULL;
+        args[i].Aexp = NULL;
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                       _hash_worker, &args[i]);
+    }
+    _hash_worker(&args[num_handles]);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    Alen = 0;
+    for (i = 0; i < base->nthreads; i++)
+    {
+        args[i].Aoffset = Alen;
+        Alen += args[i].Alen;
+    }
+
+    fmpz_mpoly_fit_length(A, Alen, ctx);
+    base->Acoeff = A->coeffs;
+    base->Aexp = A->exps;
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                       _join_worker, &args[i]);
+    }
+    _join_worker(&args[num_handles]);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    for (i = 0; i < base->nthreads; i++)
+    {
+        for (j = 0; j < args[i].Aalloc; j++)
+            fmpz_clear(args[i].Acoeff + j);
+        if (args[i].Acoeff != NULL)
+            flint_free(args[i].Acoeff);
+        if (args[i].Aexp != NULL)
+            flint_free(args[i].Aexp);
+    }
+
+    flint_free(args);
+
+    _fmpz_mpoly_set_length(A, Alen, ctx);
+    _fmpz_mpoly_sort_terms_threaded(A, ctx, handles, num_handles);
+}
+
+
+void _fmpz_mpoly_mul_hash_threaded_maxfields(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B, fmpz * maxBfields,
+    const fmpz_mpoly_t C, fmpz * maxCfields,
+    const fmpz_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong N;
+    flint_bitcnt_t Abits;
+    ulong * Bexp, * Cexp;
+    int freeBexp, freeCexp;
+    fmpz_mpoly_t T;
+    fmpz_mpoly_struct * P;
+
+    _fmpz_vec_add(maxBfields, maxBfields, maxCfields, ctx->minfo->nfields);
+
+    Abits = _fmpz_vec_max_bits(maxBfields, ctx->minfo->nfields);
+    Abits = FLINT_MAX(MPOLY_MIN_BITS, Abits + 1);
+    Abits = FLINT_MAX(Abits, B->bits);
+    Abits = FLINT_MAX(Abits, C->bits);
+    Abits = mpoly_fix_bits(Abits, ctx->minfo);
+
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+
+    /* ensure input exponents are packed into same sized fields as output */
+    freeBexp = 0;
+    Bexp = B->exps;
+    if (Abits > B->bits)
+    {
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
+    }
+
+    freeCexp = 0;
+    Cexp = C->exps;
+    if (Abits > C->bits)
+    {
+        freeCexp = 1;
+        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits,
+                                                        C->length, ctx->minfo);
+    }
+
+    /* deal with aliasing and do multiplication */
+    if (A == B || A == C)
+    {
+        fmpz_mpoly_init(T, ctx);
+        P = T;
+    }
+    else
+    {
+        P = A;
+    }
+
+    fmpz_mpoly_fit_bits(P, Abits, ctx);
+    P->bits = Abits;
+
+    _fmpz_mpoly_mul_hash_threaded(P, B->coeffs, Bexp, B->length,
+                                     C->coeffs, Cexp, C->length,
+                                        Abits, N, ctx, handles, num_handles);
+
+    if (P == T)
+    {
+        fmpz_mpoly_swap(T, A, ctx);
+        fmpz_mpoly_clear(T, ctx);
+    }
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    if (freeCexp)
+        flint_free(Cexp);
+}
+
+
+void fmpz_mpoly_mul_hash_threaded(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B,
+    const fmpz_mpoly_t C,
+    const fmpz_mpoly_ctx_t ctx,
+    slong thread_limit)
+{
+    slong i;
+    fmpz * maxBfields, * maxCfields;
+    thread_pool_handle * handles;
+    slong num_handles;
+    TMP_INIT;
+
+    if (B->length == 0 || C->length == 0)
+    {
+        fmpz_mpoly_zero(A, ctx);
+        return;
+    }
+
+    TMP_START;
+
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxCfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxBfields + i);
+        fmpz_init(maxCfields + i);
+    }
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _fmpz_mpoly_mul_hash_threaded_maxfields(A, B, maxBfields, C, maxCfields,
+                                                    ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxBfields + i);
+        fmpz_clear(maxCfields + i);
+    }
+
+    TMP_END;
+}
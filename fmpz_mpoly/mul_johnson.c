@@ -460,6 +460,60 @@ slong _fmpz_mpoly_mul_johnson(fmpz ** poly1, ulong ** exp1, slong * alloc,
    return k;
 }
 
+/*
+    Set A to B*C using the packing V for the computation. The output is
+    packed into Abits.
+*/
+static void _mul_johnson_varbits(fmpz_mpoly_t A, const fmpz_mpoly_t B,
+                     const fmpz_mpoly_t C, flint_bitcnt_t Abits,
+                           const mpoly_varbits_t V, const fmpz_mpoly_ctx_t ctx)
+{
+    slong Alen, Talloc;
+    slong N = mpoly_words_per_exp_sp(Abits, ctx->minfo);
+    ulong * Bexp, * Cexp, * Texp;
+    fmpz * Tcoeff;
+    fmpz_mpoly_t T;
+
+    Bexp = (ulong *) flint_malloc(V->N*B->length*sizeof(ulong));
+    Cexp = (ulong *) flint_malloc(V->N*C->length*sizeof(ulong));
+    mpoly_varbits_pack(Bexp, B->exps, B->bits, B->length, V, ctx->minfo);
+    mpoly_varbits_pack(Cexp, C->exps, C->bits, C->length, V, ctx->minfo);
+
+    Talloc = B->length + C->length - 1;
+    Tcoeff = (fmpz *) flint_calloc(Talloc, sizeof(fmpz));
+    Texp = (ulong *) flint_malloc(Talloc*V->N*sizeof(ulong));
+
+    /* algorithm more efficient if smaller poly first */
+    if (B->length > C->length)
+    {
+        Alen = _fmpz_mpoly_mul_johnson(&Tcoeff, &Texp, &Talloc,
+                                      C->coeffs, Cexp, C->length,
+                                      B->coeffs, Bexp, B->length,
+                                           FLINT_BITS, V->N, V->cmpmask);
+    }
+    else
+    {
+        Alen = _fmpz_mpoly_mul_johnson(&Tcoeff, &Texp, &Talloc,
+                                      B->coeffs, Bexp, B->length,
+                                      C->coeffs, Cexp, C->length,
+                                           FLINT_BITS, V->N, V->cmpmask);
+    }
+
+    flint_free(Bexp);
+    flint_free(Cexp);
+
+    fmpz_mpoly_init3(T, 0, Abits, ctx);
+    T->coeffs = Tcoeff;
+    T->alloc = Talloc;
+    T->exps = (ulong *) flint_malloc(Talloc*N*sizeof(ulong));
+    mpoly_varbits_unpack(T->exps, Abits, Texp, Alen, V, ctx->minfo);
+    T->length = Alen;
+    flint_free(Texp);
+
+    fmpz_mpoly_swap(T, A, ctx);
+    fmpz_mpoly_clear(T, ctx);
+}
+
 /* maxBfields gets clobbered */
 void _fmpz_mpoly_mul_johnson_maxfields(
     fmpz_mpoly_t A,
@@ -485,6 +539,25 @@ void _fmpz_mpoly_mul_johnson_maxfields(
     Abits = mpoly_fix_bits(Abits, ctx->minfo);
 
     N = mpoly_words_per_exp(Abits, ctx->minfo);
+
+    /*
+        If the fields have very different sizes, a packing with a width
+        for each field may need fewer words than Abits for every field.
+    */
+    if (Abits <= FLINT_BITS)
+    {
+        mpoly_varbits_t V;
+        mpoly_varbits_init(V, maxBfields, ctx->minfo);
+        if (V->N < N)
+        {
+            _mul_johnson_varbits(A, B, C, Abits, V, ctx);
+            mpoly_varbits_clear(V);
+            TMP_END;
+            return;
+        }
+        mpoly_varbits_clear(V);
+    }
+
     cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
     mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
 
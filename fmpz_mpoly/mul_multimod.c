@@ -0,0 +1,366 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+typedef struct
+{
+    slong nthreads;
+    slong num_primes;
+    nmod_mpoly_ctx_struct * pctx;
+    nmod_mpoly_struct * images;
+    const fmpz_mpoly_struct * B;
+    const fmpz_mpoly_struct * C;
+    const fmpz_mpoly_ctx_struct * ctx;
+    /* for the reconstruction */
+    const fmpz_multi_crt_struct * CRT;
+    const ulong * residues;
+    fmpz * Acoeffs;
+    slong Alen;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    slong idx;
+    _base_struct * base;
+}
+_worker_arg_struct;
+
+/* Ap = A mod p with the same exponents as A */
+static void _reduce_mod_p(nmod_mpoly_t Ap, const fmpz_mpoly_t A,
+                        const nmod_mpoly_ctx_t pctx, const fmpz_mpoly_ctx_t ctx)
+{
+    slong i, k, N = mpoly_words_per_exp(A->bits, ctx->minfo);
+
+    nmod_mpoly_fit_length(Ap, A->length, pctx);
+    nmod_mpoly_fit_bits(Ap, A->bits, pctx);
+    Ap->bits = A->bits;
+
+    k = 0;
+    for (i = 0; i < A->length; i++)
+    {
+        Ap->coeffs[k] = fmpz_fdiv_ui(A->coeffs + i, pctx->ffinfo->mod.n);
+        if (Ap->coeffs[k] == 0)
+            continue;
+        mpoly_monomial_set(Ap->exps + N*k, A->exps + N*i, N);
+        k++;
+    }
+    Ap->length = k;
+}
+
+/* worker idx computes the images for the primes idx, idx + nthreads, ... */
+static void _image_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong k;
+    nmod_mpoly_t Bp, Cp;
+
+    for (k = arg->idx; k < base->num_primes; k += base->nthreads)
+    {
+        nmod_mpoly_ctx_struct * pctx = base->pctx + k;
+
+        nmod_mpoly_init(Bp, pctx);
+        nmod_mpoly_init(Cp, pctx);
+
+        _reduce_mod_p(Bp, base->B, pctx, base->ctx);
+        _reduce_mod_p(Cp, base->C, pctx, base->ctx);
+        nmod_mpoly_mul_threaded(base->images + k, Bp, Cp, pctx, 1);
+
+        nmod_mpoly_clear(Bp, pctx);
+        nmod_mpoly_clear(Cp, pctx);
+    }
+}
+
+/* worker idx reconstructs the idx-th chunk of coefficients */
+static void _crt_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong i, k, n = base->num_primes;
+    slong start = arg->idx*base->Alen/base->nthreads;
+    slong stop = (arg->idx + 1)*base->Alen/base->nthreads;
+    slong localsize = _fmpz_multi_crt_local_size(base->CRT);
+    fmpz * inputs, * outputs;
+
+    inputs = _fmpz_vec_init(n);
+    outputs = _fmpz_vec_init(localsize);
+
+    for (i = start; i < stop; i++)
+    {
+        for (k = 0; k < n; k++)
+            fmpz_set_ui(inputs + k, base->residues[n*i + k]);
+
+        _fmpz_multi_crt_run(outputs, base->CRT, inputs);
+        fmpz_swap(base->Acoeffs + i, outputs + 0);
+    }
+
+    _fmpz_vec_clear(inputs, n);
+    _fmpz_vec_clear(outputs, localsize);
+}
+
+/*
+    Set A to B*C by multiplying images modulo enough word primes to recover
+    the coefficients of B*C from their symmetric remainders. The images are
+    computed in parallel, one prime per thread at a time, and so is the
+    reconstruction of the coefficients.
+*/
+void _fmpz_mpoly_mul_multimod_threaded(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B,
+    const fmpz_mpoly_t C,
+    const fmpz_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong i, k, n, N, Alen, Aalloc;
+    flint_bitcnt_t Abits, bound;
+    slong * start;
+    ulong * cmpmask, * residues;
+    fmpz * moduli;
+    mp_limb_t p;
+    fmpz_multi_crt_t CRT;
+    _base_t base;
+    _worker_arg_struct * args;
+    int success;
+
+    FLINT_ASSERT(B->length > 0);
+    FLINT_ASSERT(C->length > 0);
+
+    /* |coefficients of B*C| < 2^bound */
+    bound = FLINT_ABS(_fmpz_vec_max_bits(B->coeffs, B->length))
+          + FLINT_ABS(_fmpz_vec_max_bits(C->coeffs, C->length))
+          + FLINT_BIT_COUNT(FLINT_MIN(B->length, C->length));
+
+    /* each prime exceeds 2^(FLINT_BITS - 1); their product, 2^(bound + 1) */
+    n = (bound + 1 + FLINT_BITS - 2)/(FLINT_BITS - 1);
+
+    base->nthreads = num_handles + 1;
+    base->num_primes = n;
+    base->pctx = (nmod_mpoly_ctx_struct *) flint_malloc(
+                                           n*sizeof(nmod_mpoly_ctx_struct));
+    base->images = (nmod_mpoly_struct *) flint_malloc(
+                                               n*sizeof(nmod_mpoly_struct));
+    base->B = B;
+    base->C = C;
+    base->ctx = ctx;
+
+    moduli = _fmpz_vec_init(n);
+    p = UWORD(1) << (FLINT_BITS - 1);
+    for (k = 0; k < n; k++)
+    {
+        p = n_nextprime(p, 1);
+        fmpz_set_ui(moduli + k, p);
+        nmod_mpoly_ctx_init(base->pctx + k, ctx->minfo->nvars,
+                                                         ctx->minfo->ord, p);
+        nmod_mpoly_init(base->images + k, base->pctx + k);
+    }
+
+    args = (_worker_arg_struct *) flint_malloc(base->nthreads
+                                                 *sizeof(_worker_arg_struct));
+    for (i = 0; i < base->nthreads; i++)
+    {
+        args[i].idx = i;
+        args[i].base = base;
+    }
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wake(global_thread_pool, handles[i], _image_worker,
+                                                                 &args[i]);
+    _image_worker(&args[num_handles]);
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wait(global_thread_pool, handles[i]);
+
+    /* the images might have been packed differently */
+    Abits = MPOLY_MIN_BITS;
+    for (k = 0; k < n; k++)
+        Abits = FLINT_MAX(Abits, base->images[k].bits);
+
+    for (k = 0; k < n; k++)
+    {
+        success = nmod_mpoly_repack_bits(base->images + k,
+                                   base->images + k, Abits, base->pctx + k);
+        FLINT_ASSERT(success);
+    }
+
+    /*
+        Merge the images: the terms of A are the union of the terms of the
+        images, and a term missing from an image has a residue of zero.
+    */
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+    cmpmask = (ulong *) flint_malloc(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
+
+    start = (slong *) flint_calloc(n, sizeof(slong));
+    Aalloc = 1;
+    for (k = 0; k < n; k++)
+        Aalloc = FLINT_MAX(Aalloc, base->images[k].length);
+
+    fmpz_mpoly_fit_length(A, Aalloc, ctx);
+    fmpz_mpoly_fit_bits(A, Abits, ctx);
+    A->bits = Abits;
+    residues = (ulong *) flint_malloc(n*Aalloc*sizeof(ulong));
+
+    Alen = 0;
+    while (1)
+    {
+        const ulong * e = NULL;
+
+        for (k = 0; k < n; k++)
+        {
+            nmod_mpoly_struct * I = base->images + k;
+            if (start[k] >= I->length)
+                continue;
+            if (e == NULL || mpoly_monomial_cmp(I->exps + N*start[k], e,
+                                                            N, cmpmask) > 0)
+            {
+                e = I->exps + N*start[k];
+            }
+        }
+
+        if (e == NULL)
+            break;
+
+        if (Alen >= Aalloc)
+        {
+            Aalloc = 2*Aalloc;
+            fmpz_mpoly_fit_length(A, Aalloc, ctx);
+            residues = (ulong *) flint_realloc(residues,
+                                                  n*Aalloc*sizeof(ulong));
+        }
+
+        mpoly_monomial_set(A->exps + N*Alen, e, N);
+        for (k = 0; k < n; k++)
+        {
+            nmod_mpoly_struct * I = base->images + k;
+            residues[n*Alen + k] = 0;
+            if (start[k] >= I->length)
+                continue;
+            if (mpoly_monomial_equal(I->exps + N*start[k],
+                                                     A->exps + N*Alen, N))
+            {
+                residues[n*Alen + k] = I->coeffs[start[k]];
+                start[k]++;
+            }
+        }
+        Alen++;
+    }
+
+    /* reconstruct the coefficients */
+    if (n > 1)
+    {
+        fmpz_multi_crt_init(CRT);
+        success = fmpz_multi_crt_precompute(CRT, moduli, n);
+        FLINT_ASSERT(success);
+
+        base->CRT = CRT;
+        base->residues = residues;
+        base->Acoeffs = A->coeffs;
+        base->Alen = Alen;
+
+        for (i = 0; i < num_handles; i++)
+            thread_pool_wake(global_thread_pool, handles[i], _crt_worker,
+                                                                 &args[i]);
+        _crt_worker(&args[num_handles]);
+        for (i = 0; i < num_handles; i++)
+            thread_pool_wait(global_thread_pool, handles[i]);
+
+        fmpz_multi_crt_clear(CRT);
+    }
+    else
+    {
+        for (i = 0; i < Alen; i++)
+            fmpz_set_ui_smod(A->coeffs + i, residues[i], fmpz_get_ui(moduli));
+    }
+
+    /* a term with a nonzero residue has a nonzero coefficient */
+    _fmpz_mpoly_set_length(A, Alen, ctx);
+
+    for (k = 0; k < n; k++)
+    {
+        nmod_mpoly_clear(base->images + k, base->pctx + k);
+        nmod_mpoly_ctx_clear(base->pctx + k);
+    }
+
+    flint_free(base->images);
+    flint_free(base->pctx);
+    flint_free(args);
+    flint_free(start);
+    flint_free(cmpmask);
+    flint_free(residues);
+    _fmpz_vec_clear(moduli, n);
+}
+
+
+void fmpz_mpoly_mul_multimod_threaded(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B,
+    const fmpz_mpoly_t C,
+    const fmpz_mpoly_ctx_t ctx,
+    slong thread_limit)
+{
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    if (B->length == 0 || C->length == 0)
+    {
+        fmpz_mpoly_zero(A, ctx);
+        return;
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _fmpz_mpoly_mul_multimod_threaded(A, B, C, ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
+
+
+void fmpz_mpoly_mul_multimod(
+    fmpz_mpoly_t A,
+    const fmpz_mpoly_t B,
+    const fmpz_mpoly_t C,
+    const fmpz_mpoly_ctx_t ctx)
+{
+    if (B->length == 0 || C->length == 0)
+    {
+        fmpz_mpoly_zero(A, ctx);
+        return;
+    }
+
+    _fmpz_mpoly_mul_multimod_threaded(A, B, C, ctx, NULL, 0);
+}
@@ -0,0 +1,43 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz_mpoly.h"
+
+size_t fmpz_mpoly_out_raw(FILE * file, const fmpz_mpoly_t A,
+                                                    const fmpz_mpoly_ctx_t ctx)
+{
+    slong i, N;
+    size_t r, size;
+    ulong header[MPOLY_RAW_HEADER_LENGTH];
+
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+
+    mpoly_raw_header_set(header, A->bits, A->length, 0, ctx->minfo);
+    r = fwrite(header, sizeof(ulong), MPOLY_RAW_HEADER_LENGTH, file);
+    if (r != MPOLY_RAW_HEADER_LENGTH)
+        return 0;
+    size = MPOLY_RAW_HEADER_LENGTH*sizeof(ulong);
+
+    r = fwrite(A->exps, sizeof(ulong), N*A->length, file);
+    if (r != (size_t) (N*A->length))
+        return 0;
+    size += N*A->length*sizeof(ulong);
+
+    for (i = 0; i < A->length; i++)
+    {
+        r = fmpz_out_raw(file, A->coeffs + i);
+        if (r == 0)
+            return 0;
+        size += r;
+    }
+
+    return size;
+}
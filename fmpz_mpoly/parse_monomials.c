@@ -0,0 +1,348 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+/* coefficients with at most this many digits are read into a word */
+#define PARSE_WORD_DIGITS 18
+
+static const char * _parse_ui(const char * s, const char * end,
+                                                            ulong * e, int * ok)
+{
+    ulong r = 0, d;
+
+    *ok = 1;
+    while (s < end && '0' <= *s && *s <= '9')
+    {
+        d = *s++ - '0';
+        if (r > (UWORD_MAX - d)/10)
+            *ok = 0;
+        r = 10*r + d;
+    }
+    *e = r;
+    return s;
+}
+
+static const char * _parse_fmpz(const char * s, const char * end, fmpz_t c)
+{
+    const char * t = s;
+    char * buffer;
+    slong n;
+
+    while (t < end && '0' <= *t && *t <= '9')
+        t++;
+
+    n = t - s;
+    if (n <= PARSE_WORD_DIGITS)
+    {
+        ulong r = 0;
+        while (s < t)
+            r = 10*r + (*s++ - '0');
+        fmpz_set_ui(c, r);
+    }
+    else
+    {
+        buffer = (char *) flint_malloc((n + 1)*sizeof(char));
+        memcpy(buffer, s, n);
+        buffer[n] = '\0';
+        fmpz_set_str(c, buffer, 10);
+        flint_free(buffer);
+    }
+
+    return t;
+}
+
+/*
+    Push the terms in [s, s + sn) onto A assuming the string is a sum of
+    monomials, each a product of integers and powers of variables with
+    unsigned word exponents, in the syntax of fmpz_mpoly_set_str_pretty.
+    The terms are not sorted or combined. Return 1 if the whole string had
+    this form. Otherwise, return 0 with A restored to its original length:
+    the string may still be valid, but needs the general parser.
+*/
+int _fmpz_mpoly_push_str_monomials(fmpz_mpoly_t A, const char * s,
+                    slong sn, char * const * x, const fmpz_mpoly_ctx_t ctx)
+{
+    int success = 0, ok;
+    slong k, var, matched, nvars = ctx->minfo->nvars;
+    slong old_length = A->length, nterms = 0;
+    const char * end = s + sn;
+    slong * xlen;
+    ulong * exp;
+    ulong e;
+    fmpz_t c, t;
+    TMP_INIT;
+
+    TMP_START;
+    fmpz_init(c);
+    fmpz_init(t);
+    xlen = (slong *) TMP_ALLOC(nvars*sizeof(slong));
+    exp = (ulong *) TMP_ALLOC(nvars*sizeof(ulong));
+    for (k = 0; k < nvars; k++)
+        xlen[k] = strlen(x[k]);
+
+    while (1)
+    {
+        while (s < end && *s == ' ')
+            s++;
+
+        if (s >= end)
+            break;
+
+        if (*s == '+' || *s == '-')
+        {
+            fmpz_set_si(c, *s == '-' ? -1 : 1);
+            s++;
+            while (s < end && *s == ' ')
+                s++;
+        }
+        else if (nterms == 0)
+        {
+            fmpz_one(c);
+        }
+        else
+        {
+            goto cleanup;
+        }
+
+        for (k = 0; k < nvars; k++)
+            exp[k] = 0;
+
+        /* read the factors of one monomial */
+        while (1)
+        {
+            if (s >= end)
+                goto cleanup;
+
+            if ('0' <= *s && *s <= '9')
+            {
+                s = _parse_fmpz(s, end, t);
+                fmpz_mul(c, c, t);
+            }
+            else
+            {
+                var = -WORD(1);
+                matched = -WORD(1);
+                for (k = 0; k < nvars; k++)
+                {
+                    if (end - s >= xlen[k] && xlen[k] > matched
+                                        && strncmp(s, x[k], xlen[k]) == 0)
+                    {
+                        var = k;
+                        matched = xlen[k];
+                    }
+                }
+
+                if (var < 0)
+                    goto cleanup;
+
+                s += matched;
+
+                e = 1;
+                if (s < end && *s == '^')
+                {
+                    s++;
+                    if (s >= end || *s < '0' || *s > '9')
+                        goto cleanup;
+                    s = _parse_ui(s, end, &e, &ok);
+                    if (!ok)
+                        goto cleanup;
+                }
+
+                exp[var] += e;
+                if (exp[var] < e)
+                    goto cleanup;
+            }
+
+            while (s < end && *s == ' ')
+                s++;
+
+            if (s < end && *s == '*')
+            {
+                s++;
+                while (s < end && *s == ' ')
+                    s++;
+                continue;
+            }
+
+            break;
+        }
+
+        if (s < end && *s != '+' && *s != '-')
+            goto cleanup;
+
+        fmpz_mpoly_push_term_fmpz_ui(A, c, exp, ctx);
+        nterms++;
+    }
+
+    success = (nterms > 0);
+
+cleanup:
+
+    if (!success)
+        _fmpz_mpoly_set_length(A, old_length, ctx);
+
+    fmpz_clear(c);
+    fmpz_clear(t);
+    TMP_END;
+
+    return success;
+}
+
+/*
+    Return the position of the first sign at or after start that separates
+    two terms, or sn if there is none. Such a sign follows the digit or
+    variable name ending the previous term.
+*/
+slong _fmpz_mpoly_str_next_term(const char * s, slong start, slong sn)
+{
+    slong i, j;
+
+    for (i = FLINT_MAX(start, 1); i < sn; i++)
+    {
+        if (s[i] != '+' && s[i] != '-')
+            continue;
+
+        for (j = i - 1; j > 0 && s[j] == ' '; j--)
+            ;
+
+        if (('0' <= s[j] && s[j] <= '9') || ('a' <= s[j] && s[j] <= 'z')
+                         || ('A' <= s[j] && s[j] <= 'Z') || s[j] == '_')
+            return i;
+    }
+
+    return sn;
+}
+
+/*
+    The strings can only be split at signs if no variable name could contain
+    one, or a space before one.
+*/
+int _fmpz_mpoly_str_names_splittable(char * const * x, slong nvars)
+{
+    slong k;
+
+    for (k = 0; k < nvars; k++)
+    {
+        if (strchr(x[k], '+') || strchr(x[k], '-') || strchr(x[k], ' '))
+            return 0;
+    }
+
+    return 1;
+}
+
+typedef struct
+{
+    fmpz_mpoly_struct poly[1];
+    const char * s;
+    slong sn;
+    char * const * x;
+    const fmpz_mpoly_ctx_struct * ctx;
+    int success;
+}
+_worker_arg_struct;
+
+static void _parse_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+
+    arg->success = arg->sn == 0 || _fmpz_mpoly_push_str_monomials(arg->poly,
+                                           arg->s, arg->sn, arg->x, arg->ctx);
+}
+
+/*
+    Same as _fmpz_mpoly_push_str_monomials, but the string is split between
+    terms into one piece per thread. The pieces are parsed into separate
+    polynomials, which are then appended to A in order.
+*/
+int _fmpz_mpoly_push_str_monomials_threaded(fmpz_mpoly_t A, const char * s,
+                      slong sn, char * const * x, const fmpz_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    int success;
+    slong i, j, stop, nthreads, N, Alen;
+    flint_bitcnt_t bits;
+    _worker_arg_struct * args;
+
+    nthreads = FLINT_MIN(num_handles + 1,
+                                       sn/FMPZ_MPOLY_PARSE_THREADED_CUTOFF);
+
+    if (nthreads < 2 ||
+                    !_fmpz_mpoly_str_names_splittable(x, ctx->minfo->nvars))
+    {
+        return _fmpz_mpoly_push_str_monomials(A, s, sn, x, ctx);
+    }
+
+    args = (_worker_arg_struct *) flint_malloc(nthreads
+                                                  *sizeof(_worker_arg_struct));
+    j = 0;
+    for (i = 0; i < nthreads; i++)
+    {
+        stop = (i + 1 < nthreads) ? _fmpz_mpoly_str_next_term(s,
+                                    FLINT_MAX(j, sn*(i + 1)/nthreads), sn) : sn;
+        fmpz_mpoly_init(args[i].poly, ctx);
+        args[i].s = s + j;
+        args[i].sn = stop - j;
+        args[i].x = x;
+        args[i].ctx = ctx;
+        j = stop;
+    }
+
+    for (i = 0; i + 1 < nthreads; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                      _parse_worker, &args[i]);
+    }
+    _parse_worker(&args[nthreads - 1]);
+    for (i = 0; i + 1 < nthreads; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    success = 1;
+    bits = A->bits;
+    Alen = A->length;
+    for (i = 0; i < nthreads; i++)
+    {
+        success = success && args[i].success;
+        bits = FLINT_MAX(bits, args[i].poly->bits);
+        Alen += args[i].poly->length;
+    }
+
+    if (success)
+    {
+        fmpz_mpoly_fit_bits(A, bits, ctx);
+        fmpz_mpoly_fit_length(A, Alen, ctx);
+        N = mpoly_words_per_exp(bits, ctx->minfo);
+
+        Alen = A->length;
+        for (i = 0; i < nthreads; i++)
+        {
+            fmpz_mpoly_struct * T = args[i].poly;
+
+            fmpz_mpoly_fit_bits(T, bits, ctx);
+            for (j = 0; j < T->length; j++)
+                fmpz_swap(A->coeffs + Alen + j, T->coeffs + j);
+            memcpy(A->exps + N*Alen, T->exps, N*T->length*sizeof(ulong));
+            Alen += T->length;
+        }
+        _fmpz_mpoly_set_length(A, Alen, ctx);
+    }
+
+    for (i = 0; i < nthreads; i++)
+        fmpz_mpoly_clear(args[i].poly, ctx);
+
+    flint_free(args);
+
+    return success;
+}
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include "thread_pool.h"
 #include "fmpz_mpoly.h"
 
 
@@ -273,6 +274,62 @@ failed:
 }
 
 
+/*
+    Sums of monomials are parsed term by term and sorted once at the end.
+    Anything else goes through the operator stack in _fmpz_mpoly_parse_pretty.
+*/
+int _fmpz_mpoly_set_str_pretty(fmpz_mpoly_t poly, const char * s, slong sn,
+                                         char ** x, const fmpz_mpoly_ctx_t ctx)
+{
+    int ret;
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized &&
+                                   sn >= 2*FMPZ_MPOLY_PARSE_THREADED_CUTOFF)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(MPOLY_DEFAULT_THREAD_LIMIT - 1,
+                                                              max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    fmpz_mpoly_zero(poly, ctx);
+    if (_fmpz_mpoly_push_str_monomials_threaded(poly, s, sn, x, ctx,
+                                                         handles, num_handles))
+    {
+        _fmpz_mpoly_sort_terms_threaded(poly, ctx, handles, num_handles);
+        _fmpz_mpoly_combine_like_terms_threaded(poly, ctx,
+                                                         handles, num_handles);
+        ret = 0;
+    }
+    else
+    {
+        ret = _fmpz_mpoly_parse_pretty(poly, s, sn, x, ctx);
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+    return ret;
+}
+
 int fmpz_mpoly_set_str_pretty(fmpz_mpoly_t poly, const char * str,
                                  const char** x_in, const fmpz_mpoly_ctx_t ctx)
 {
@@ -292,7 +349,7 @@ int fmpz_mpoly_set_str_pretty(fmpz_mpoly_t poly, const char * str,
             flint_sprintf(x[i], "x%wd", i + 1);
         }
     }
-    ret = _fmpz_mpoly_parse_pretty(poly, str, strlen(str), x, ctx);
+    ret = _fmpz_mpoly_set_str_pretty(poly, str, strlen(str), x, ctx);
     TMP_END;
     return ret;
 }
@@ -19,10 +19,14 @@
     This function is used by {fmpz|nmod}_mpoly_divides_heap_threaded, and
     must be placed in the fmpz_mpoly module becuase it uses an fmpz_mpoly_t
     to accumulate and sort the exponents.
+
+    If exact = 0, the division is allowed to have a remainder: shifted
+    exponents of B that do not make sense are skipped instead of causing
+    failure, and nothing above the leading exponent of A is selected.
 */
-int mpoly_divides_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
+static int _mpoly_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
                              slong nworkers, ulong * Aexp, slong Alen,
-                                    ulong * Bexp, slong Blen, flint_bitcnt_t bits)
+                  ulong * Bexp, slong Blen, flint_bitcnt_t bits, int exact)
 {
     int failure;
     ulong mask;
@@ -32,13 +36,16 @@ int mpoly_divides_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
     slong nA = 30 + 8*nworkers;     /* number of division of A */
     slong nB = (1 + nworkers)/2;    /* number of division of B */
     slong tot;
-    ulong * T0, * T1;
+    ulong * T0, * T1, * cmpmask;
+    int skip0, skip1;
     slong i, j, N;
     TMP_INIT;
 
     TMP_START;
 
     N = mpoly_words_per_exp(bits, zctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, bits, zctx->minfo);
 
     mask = 0; /* mask will be unused if bits > FLINT_BITS*/
     for (i = 0; i < FLINT_BITS/bits; i++)
@@ -90,23 +97,20 @@ int mpoly_divides_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
     mpoly_monomial_sub_mp(T1, Aexp + N*(Alen - 1), Bexp + N*(Blen - 1), N);
     if (bits <= FLINT_BITS)
     {
-        if (   mpoly_monomial_overflows(T0, N, mask)
-            || mpoly_monomial_overflows(T1, N, mask))
-        {
-            failure = 1;
-            goto cleanup;
-        }
+        skip0 = mpoly_monomial_overflows(T0, N, mask);
+        skip1 = mpoly_monomial_overflows(T1, N, mask);
     }
     else
     {
-        if (   mpoly_monomial_overflows_mp(T0, N, bits)
-            || mpoly_monomial_overflows_mp(T1, N, bits))
-        {
-            failure = 1;
-            goto cleanup;
-        }
+        skip0 = mpoly_monomial_overflows_mp(T0, N, bits);
+        skip1 = mpoly_monomial_overflows_mp(T1, N, bits);
     }
 
+    if (exact && (skip0 || skip1))
+    {
+        failure = 1;
+        goto cleanup;
+    }
 
     for (i = 1; i < nB; i++)
     {
@@ -116,21 +120,29 @@ int mpoly_divides_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
         j = FLINT_MAX(j, WORD(0));
         j = FLINT_MIN(j, Blen - 1);
 
-        mpoly_monomial_sub_mp(Sexp + N*Slen, Aexp + N*0, Bexp + N*0, N);
-        mpoly_monomial_add_mp(Sexp + N*Slen, Sexp + N*Slen, Bexp + N*j, N);
-        fmpz_one(Scoeff + Slen);
-        if (bits <= FLINT_BITS)
-            Slen += !(mpoly_monomial_overflows(Sexp + N*Slen, N, mask));
-        else
-            Slen += !(mpoly_monomial_overflows_mp(Sexp + N*Slen, N, bits));
+        if (!skip0)
+        {
+            mpoly_monomial_add_mp(Sexp + N*Slen, T0, Bexp + N*j, N);
+            fmpz_one(Scoeff + Slen);
+            if (bits <= FLINT_BITS)
+                Slen += !(mpoly_monomial_overflows(Sexp + N*Slen, N, mask));
+            else
+                Slen += !(mpoly_monomial_overflows_mp(Sexp + N*Slen, N, bits));
+        }
 
-        mpoly_monomial_sub_mp(Sexp + N*Slen, Aexp + N*(Alen - 1), Bexp + N*(Blen - 1), N);
-        mpoly_monomial_add_mp(Sexp + N*Slen, Sexp + N*Slen, Bexp + N*j, N);
-        fmpz_one(Scoeff + Slen);
-        if (bits <= FLINT_BITS)
-            Slen += !(mpoly_monomial_overflows(Sexp + N*Slen, N, mask));
-        else
-            Slen += !(mpoly_monomial_overflows_mp(Sexp + N*Slen, N, bits));
+        if (!skip1)
+        {
+            mpoly_monomial_add_mp(Sexp + N*Slen, T1, Bexp + N*j, N);
+            fmpz_one(Scoeff + Slen);
+            if (bits <= FLINT_BITS)
+                Slen += !(mpoly_monomial_overflows(Sexp + N*Slen, N, mask))
+                     && (exact || !mpoly_monomial_gt(Sexp + N*Slen,
+                                                       Aexp + N*0, N, cmpmask));
+            else
+                Slen += !(mpoly_monomial_overflows_mp(Sexp + N*Slen, N, bits))
+                     && (exact || !mpoly_monomial_gt(Sexp + N*Slen,
+                                                       Aexp + N*0, N, cmpmask));
+        }
     }
 
     /* get a lower bound on the exponents of A */
@@ -152,3 +164,22 @@ cleanup:
     TMP_END;
     return failure;
 }
+
+int mpoly_divides_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
+                             slong nworkers, ulong * Aexp, slong Alen,
+                                    ulong * Bexp, slong Blen, flint_bitcnt_t bits)
+{
+    return _mpoly_select_exps(S, zctx, nworkers, Aexp, Alen,
+                                                     Bexp, Blen, bits, 1);
+}
+
+/*
+    Select exponent ranges for the parallel division with remainder A/B.
+    This never fails.
+*/
+void mpoly_divrem_select_exps(fmpz_mpoly_t S, fmpz_mpoly_ctx_t zctx,
+                             slong nworkers, ulong * Aexp, slong Alen,
+                                    ulong * Bexp, slong Blen, flint_bitcnt_t bits)
+{
+    _mpoly_select_exps(S, zctx, nworkers, Aexp, Alen, Bexp, Blen, bits, 0);
+}
@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, v, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("compose_fmpz_mpoly_threaded....");
+    fflush(stdout);
+
+    /* Check against compose_fmpz_mpoly */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        ordering_t ord1, ord2;
+        fmpz_mpoly_ctx_t ctx1, ctx2;
+        fmpz_mpoly_t f, g, h;
+        fmpz_mpoly_struct ** vals1;
+        slong nvars1, nvars2;
+        slong len1, len2;
+        slong exp_bound1, exp_bound2;
+        slong coeff_bits;
+
+        ord1 = mpoly_ordering_randtest(state);
+        ord2 = mpoly_ordering_randtest(state);
+        nvars1 = n_randint(state, 10) + 1;
+        nvars2 = n_randint(state, 10) + 1;
+        fmpz_mpoly_ctx_init(ctx1, nvars1, ord1);
+        fmpz_mpoly_ctx_init(ctx2, nvars2, ord2);
+
+        fmpz_mpoly_init(f, ctx1);
+        fmpz_mpoly_init(g, ctx2);
+        fmpz_mpoly_init(h, ctx2);
+
+        len1 = n_randint(state, 80/nvars1 + 1);
+        len2 = n_randint(state, 30/nvars2 + 1);
+        exp_bound1 = n_randint(state, 15/nvars1 + 2) + 1;
+        exp_bound2 = n_randint(state, 15/nvars2 + 2) + 1;
+        coeff_bits = n_randint(state, 10);
+
+        vals1 = (fmpz_mpoly_struct **) flint_malloc(nvars1
+                                                * sizeof(fmpz_mpoly_struct *));
+        for (v = 0; v < nvars1; v++)
+        {
+            vals1[v] = (fmpz_mpoly_struct *) flint_malloc(
+                                                    sizeof(fmpz_mpoly_struct));
+            fmpz_mpoly_init(vals1[v], ctx2);
+        }
+
+        for (j = 0; j < 4; j++)
+        {
+            for (v = 0; v < nvars1; v++)
+                fmpz_mpoly_randtest_bound(vals1[v], state, len2,
+                                                 coeff_bits, exp_bound2, ctx2);
+
+            fmpz_mpoly_randtest_bound(f, state, len1, coeff_bits,
+                                                             exp_bound1, ctx1);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_compose_fmpz_mpoly(g, f, vals1, ctx1, ctx2);
+            fmpz_mpoly_compose_fmpz_mpoly_threaded(h, f, vals1, ctx1, ctx2,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(h, ctx2);
+
+            if (!fmpz_mpoly_equal(g, h, ctx2))
+            {
+                printf("FAIL\n");
+                flint_printf("Check against compose_fmpz_mpoly\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* the output may alias a substituted polynomial */
+            fmpz_mpoly_compose_fmpz_mpoly_threaded(vals1[0], f, vals1,
+                                      ctx1, ctx2, MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(vals1[0], ctx2);
+
+            if (!fmpz_mpoly_equal(g, vals1[0], ctx2))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        for (v = 0; v < nvars1; v++)
+        {
+            fmpz_mpoly_clear(vals1[v], ctx2);
+            flint_free(vals1[v]);
+        }
+        flint_free(vals1);
+
+        fmpz_mpoly_clear(f, ctx1);
+        fmpz_mpoly_clear(g, ctx2);
+        fmpz_mpoly_clear(h, ctx2);
+        fmpz_mpoly_ctx_clear(ctx1);
+        fmpz_mpoly_ctx_clear(ctx2);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -20,7 +20,7 @@
 int
 main(void)
 {
-    int i, j, result, ok1, ok2;
+    int i, j, v, result, ok1, ok2;
     FLINT_TEST_INIT(state);
 
     flint_printf("divides_monagan_pearce....");
@@ -111,6 +111,84 @@ main(void)
         fmpz_mpoly_ctx_clear(ctx);
     }
 
+    /* Check f*g/g = f with one variable of much larger degree */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h, k, l;
+        slong len1, len2, nvars;
+        flint_bitcnt_t coeff_bits;
+        ulong * bounds;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        nvars = ctx->minfo->nvars;
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+        fmpz_mpoly_init(k, ctx);
+        fmpz_mpoly_init(l, ctx);
+
+        bounds = (ulong *) flint_malloc(nvars*sizeof(ulong));
+
+        len1 = n_randint(state, 20);
+        len2 = n_randint(state, 20) + 1;
+        coeff_bits = n_randint(state, 100);
+
+        for (j = 0; j < 4; j++)
+        {
+            for (v = 0; v < nvars; v++)
+                bounds[v] = n_randint(state, 8) + 1;
+            bounds[n_randint(state, nvars)] = UWORD(1) << n_randint(state, 40);
+
+            fmpz_mpoly_randtest_bounds(f, state, len1, coeff_bits, bounds, ctx);
+            do {
+                fmpz_mpoly_randtest_bounds(g, state, len2, coeff_bits + 1,
+                                                                  bounds, ctx);
+            } while (g->length == 0);
+
+            fmpz_mpoly_mul_johnson(h, f, g, ctx);
+            fmpz_mpoly_assert_canonical(h, ctx);
+            fmpz_mpoly_mul_heap_threaded(k, f, g, ctx, 1);
+            if (!fmpz_mpoly_equal(h, k, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f with one variable of much "
+                          "larger degree\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+
+            ok1 = fmpz_mpoly_divides_monagan_pearce(k, h, g, ctx);
+            fmpz_mpoly_assert_canonical(k, ctx);
+            result = (ok1 && fmpz_mpoly_equal(f, k, ctx));
+
+            /* h + f is divisible by g iff f is */
+            fmpz_mpoly_add(h, h, f, ctx);
+            ok1 = fmpz_mpoly_divides_monagan_pearce(k, h, g, ctx);
+            fmpz_mpoly_assert_canonical(k, ctx);
+            ok2 = fmpz_mpoly_divides_heap_threaded(l, h, g, ctx, 1);
+            result = result && (ok1 == ok2) &&
+                               (ok1 == 0 || fmpz_mpoly_equal(k, l, ctx));
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f with one variable of much "
+                          "larger degree\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        flint_free(bounds);
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_clear(k, ctx);
+        fmpz_mpoly_clear(l, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
     /* Check random polys don't divide */
     for (i = 0; i < 50 * flint_test_multiplier(); i++)
     {
@@ -0,0 +1,394 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+/*
+    Check that each term of r is reduced: for the last divisor whose leading
+    monomial divides the term, the floor quotient by its leading coefficient
+    must be zero.
+*/
+static int _is_reduced(const fmpz_mpoly_t r, fmpz_mpoly_struct * const * B,
+                                        slong len, const fmpz_mpoly_ctx_t ctx)
+{
+    int reduced = 1;
+    slong i, w, last;
+    fmpz_mpoly_t m, t, q;
+    fmpz_t c, qc;
+
+    fmpz_mpoly_init(m, ctx);
+    fmpz_mpoly_init(t, ctx);
+    fmpz_mpoly_init(q, ctx);
+    fmpz_init(c);
+    fmpz_init(qc);
+
+    for (i = 0; i < r->length && reduced; i++)
+    {
+        fmpz_mpoly_get_term_monomial(m, r, i, ctx);
+
+        last = -1;
+        for (w = 0; w < len; w++)
+        {
+            fmpz_mpoly_get_term_monomial(t, B[w], 0, ctx);
+            if (fmpz_mpoly_divides(q, m, t, ctx))
+                last = w;
+        }
+
+        if (last >= 0)
+        {
+            fmpz_mpoly_get_term_coeff_fmpz(c, r, i, ctx);
+            fmpz_fdiv_q(qc, c, B[last]->coeffs + 0);
+            reduced = fmpz_is_zero(qc);
+        }
+    }
+
+    fmpz_mpoly_clear(m, ctx);
+    fmpz_mpoly_clear(t, ctx);
+    fmpz_mpoly_clear(q, ctx);
+    fmpz_clear(c);
+    fmpz_clear(qc);
+
+    return reduced;
+}
+
+int
+main(void)
+{
+    slong i, j, w, max_threads = 5, tmul = 15;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("divrem_ideal_heap_threaded....");
+    fflush(stdout);
+
+    /* Check f*g/g = f with zero remainder */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h, k, r;
+        slong len1, len2;
+        flint_bitcnt_t exp_bits1, exp_bits2, coeff_bits;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+        fmpz_mpoly_init(k, ctx);
+        fmpz_mpoly_init(r, ctx);
+
+        len1 = n_randint(state, 50);
+        len2 = n_randint(state, 50) + 1;
+
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        coeff_bits = n_randint(state, 200) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mpoly_randtest_bits(f, state, len1, coeff_bits, exp_bits1, ctx);
+            do {
+                fmpz_mpoly_randtest_bits(g, state, len2, coeff_bits, exp_bits2, ctx);
+            } while (g->length == 0);
+            fmpz_mpoly_randtest_bits(k, state, len1, coeff_bits, exp_bits1, ctx);
+            fmpz_mpoly_randtest_bits(r, state, len1, coeff_bits, exp_bits1, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_mul(h, f, g, ctx);
+            fmpz_mpoly_divrem_heap_threaded(k, r, h, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(k, ctx);
+            fmpz_mpoly_assert_canonical(r, ctx);
+
+            if (!fmpz_mpoly_equal(f, k, ctx) || !fmpz_mpoly_is_zero(r, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f with zero remainder\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_clear(k, ctx);
+        fmpz_mpoly_clear(r, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check f = g1*q1 + ... + gn*qn + r with r reduced */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, r, t, s;
+        fmpz_mpoly_struct * g, * q;
+        fmpz_mpoly_struct * qarr[5], * darr[5];
+        slong len, len1, num;
+        slong nvars, exp_bound, exp_bound1;
+        flint_bitcnt_t coeff_bits;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        nvars = ctx->minfo->nvars;
+
+        num = n_randint(state, 5) + 1;
+        g = (fmpz_mpoly_struct *) flint_malloc(num*sizeof(fmpz_mpoly_struct));
+        q = (fmpz_mpoly_struct *) flint_malloc(num*sizeof(fmpz_mpoly_struct));
+        for (w = 0; w < num; w++)
+        {
+            fmpz_mpoly_init(g + w, ctx);
+            darr[w] = g + w;
+            fmpz_mpoly_init(q + w, ctx);
+            qarr[w] = q + w;
+        }
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(r, ctx);
+        fmpz_mpoly_init(t, ctx);
+        fmpz_mpoly_init(s, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 10) + 1;
+
+        exp_bound = n_randint(state, 2 + 175/nvars/nvars) + 1;
+        exp_bound1 = n_randint(state, 2 + 175/nvars/nvars) + 1;
+
+        coeff_bits = n_randint(state, 100) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            for (w = 0; w < num; w++)
+            {
+                do {
+                    fmpz_mpoly_randtest_bound(darr[w], state, len1,
+                                                 coeff_bits, exp_bound1, ctx);
+                } while (darr[w]->length == 0);
+                fmpz_mpoly_randtest_bound(qarr[w], state, len1, coeff_bits,
+                                                             exp_bound1, ctx);
+            }
+            fmpz_mpoly_randtest_bound(f, state, len, coeff_bits,
+                                                              exp_bound, ctx);
+            fmpz_mpoly_randtest_bound(r, state, len, coeff_bits,
+                                                              exp_bound, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_divrem_ideal_heap_threaded(qarr, r, f, darr, num, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(r, ctx);
+
+            fmpz_mpoly_set(s, r, ctx);
+            for (w = 0; w < num; w++)
+            {
+                fmpz_mpoly_assert_canonical(qarr[w], ctx);
+                fmpz_mpoly_mul(t, qarr[w], darr[w], ctx);
+                fmpz_mpoly_add(s, s, t, ctx);
+            }
+
+            if (!fmpz_mpoly_equal(f, s, ctx) || !_is_reduced(r, darr, num, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f = g1*q1 + ... + gn*qn + r with r "
+                                       "reduced\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        for (w = 0; w < num; w++)
+        {
+            fmpz_mpoly_clear(q + w, ctx);
+            fmpz_mpoly_clear(g + w, ctx);
+        }
+        flint_free(g);
+        flint_free(q);
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(r, ctx);
+        fmpz_mpoly_clear(t, ctx);
+        fmpz_mpoly_clear(s, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check against monagan_pearce with unit leading coefficients */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, r1, r2;
+        fmpz_mpoly_struct * g, * q1, * q2;
+        fmpz_mpoly_struct * q1arr[5], * q2arr[5], * darr[5];
+        slong len, len1, num;
+        slong nvars, exp_bound, exp_bound1;
+        flint_bitcnt_t coeff_bits;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        nvars = ctx->minfo->nvars;
+
+        num = n_randint(state, 5) + 1;
+        g = (fmpz_mpoly_struct *) flint_malloc(num*sizeof(fmpz_mpoly_struct));
+        q1 = (fmpz_mpoly_struct *) flint_malloc(num*sizeof(fmpz_mpoly_struct));
+        q2 = (fmpz_mpoly_struct *) flint_malloc(num*sizeof(fmpz_mpoly_struct));
+        for (w = 0; w < num; w++)
+        {
+            fmpz_mpoly_init(g + w, ctx);
+            darr[w] = g + w;
+            fmpz_mpoly_init(q1 + w, ctx);
+            q1arr[w] = q1 + w;
+            fmpz_mpoly_init(q2 + w, ctx);
+            q2arr[w] = q2 + w;
+        }
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(r1, ctx);
+        fmpz_mpoly_init(r2, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 10) + 1;
+
+        exp_bound = n_randint(state, 2 + 175/nvars/nvars) + 1;
+        exp_bound1 = n_randint(state, 2 + 175/nvars/nvars) + 1;
+
+        coeff_bits = n_randint(state, 100) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            for (w = 0; w < num; w++)
+            {
+                do {
+                    fmpz_mpoly_randtest_bound(darr[w], state, len1,
+                                                 coeff_bits, exp_bound1, ctx);
+                } while (darr[w]->length == 0);
+                fmpz_set_si(darr[w]->coeffs + 0, n_randint(state, 2) ? 1 : -1);
+            }
+            fmpz_mpoly_randtest_bound(f, state, len, coeff_bits,
+                                                              exp_bound, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_divrem_ideal_monagan_pearce(q1arr, r1, f, darr, num,
+                                                                         ctx);
+            fmpz_mpoly_divrem_ideal_heap_threaded(q2arr, r2, f, darr, num,
+                                              ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(r2, ctx);
+
+            for (w = 0; w < num; w++)
+            {
+                fmpz_mpoly_assert_canonical(q2arr[w], ctx);
+                if (!fmpz_mpoly_equal(q1arr[w], q2arr[w], ctx))
+                    break;
+            }
+
+            if (w < num || !fmpz_mpoly_equal(r1, r2, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check against monagan_pearce with unit leading "
+                                   "coefficients\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        for (w = 0; w < num; w++)
+        {
+            fmpz_mpoly_clear(q1 + w, ctx);
+            fmpz_mpoly_clear(q2 + w, ctx);
+            fmpz_mpoly_clear(g + w, ctx);
+        }
+        flint_free(g);
+        flint_free(q1);
+        flint_free(q2);
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(r1, ctx);
+        fmpz_mpoly_clear(r2, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check aliasing of quotient and remainder with the dividend */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h, q1, r1;
+        slong len, len1;
+        slong nvars, exp_bound, exp_bound1;
+        flint_bitcnt_t coeff_bits;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        nvars = ctx->minfo->nvars;
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+        fmpz_mpoly_init(q1, ctx);
+        fmpz_mpoly_init(r1, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 10) + 1;
+
+        exp_bound = n_randint(state, 2 + 175/nvars/nvars) + 1;
+        exp_bound1 = n_randint(state, 2 + 175/nvars/nvars) + 1;
+
+        coeff_bits = n_randint(state, 100) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mpoly_randtest_bound(f, state, len, coeff_bits,
+                                                              exp_bound, ctx);
+            do {
+                fmpz_mpoly_randtest_bound(g, state, len1, coeff_bits,
+                                                             exp_bound1, ctx);
+            } while (g->length == 0);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_divrem_heap_threaded(q1, r1, f, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+
+            fmpz_mpoly_set(h, f, ctx);
+            fmpz_mpoly_divrem_heap_threaded(h, r1, h, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(h, ctx);
+            if (!fmpz_mpoly_equal(h, q1, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing of quotient with dividend\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            fmpz_mpoly_set(h, f, ctx);
+            fmpz_mpoly_divrem_heap_threaded(q1, h, h, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(h, ctx);
+            if (!fmpz_mpoly_equal(h, r1, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing of remainder with dividend\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_clear(q1, ctx);
+        fmpz_mpoly_clear(r1, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, k, v, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("eval_plan....");
+    fflush(stdout);
+
+    /* Check plan evaluation matches evaluate_all */
+    for (i = 0; i < 40 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f;
+        fmpz_mpoly_eval_plan_t P;
+        fmpz_t e, e1;
+        fmpz * ev1, * ev2, * vals;
+        fmpz ** valp;
+        slong nvars, len, num;
+        flint_bitcnt_t exp_bits, coeff_bits;
+        int small;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        nvars = ctx->minfo->nvars;
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_init(e);
+        fmpz_init(e1);
+
+        len = n_randint(state, 100);
+        num = n_randint(state, 50);
+        coeff_bits = n_randint(state, 100) + 1;
+
+        /* large exponents are only evaluated at 0 and +-1 */
+        small = n_randint(state, 2);
+        exp_bits = small ? n_randint(state, 200) + 1 : n_randint(state, 8) + 1;
+
+        vals = _fmpz_vec_init(nvars*num + 1);
+        valp = (fmpz **) flint_malloc((nvars + 1)*sizeof(fmpz *));
+        ev1 = _fmpz_vec_init(num + 1);
+        ev2 = _fmpz_vec_init(num + 1);
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mpoly_randtest_bits(f, state, len, coeff_bits, exp_bits, ctx);
+
+            for (k = 0; k < nvars*num; k++)
+            {
+                if (small)
+                    fmpz_set_si(vals + k, n_randint(state, UWORD(3)) - WORD(1));
+                else
+                    fmpz_randtest(vals + k, state, 10);
+            }
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_eval_plan_init(P, f, ctx);
+            fmpz_mpoly_eval_plan_evaluate_vec_fmpz(ev1, P, vals, num, ctx);
+            fmpz_mpoly_eval_plan_evaluate_vec_fmpz_threaded(ev2, P, vals, num,
+                                             ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+
+            for (k = 0; k < num; k++)
+            {
+                for (v = 0; v < nvars; v++)
+                    valp[v] = vals + nvars*k + v;
+
+                fmpz_mpoly_evaluate_all_fmpz(e, f, valp, ctx);
+                fmpz_mpoly_eval_plan_evaluate_fmpz(e1, P, valp, ctx);
+
+                if (!fmpz_equal(e, ev1 + k) || !fmpz_equal(e, ev2 + k) ||
+                    !fmpz_equal(e, e1))
+                {
+                    printf("FAIL\n");
+                    flint_printf("Check plan evaluation matches "
+                         "evaluate_all\ni = %wd, j = %wd, k = %wd\n", i, j, k);
+                    flint_abort();
+                }
+            }
+
+            fmpz_mpoly_eval_plan_clear(P, ctx);
+        }
+
+        _fmpz_vec_clear(vals, nvars*num + 1);
+        flint_free(valp);
+        _fmpz_vec_clear(ev1, num + 1);
+        _fmpz_vec_clear(ev2, num + 1);
+
+        fmpz_clear(e);
+        fmpz_clear(e1);
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check aliasing of the output with the points */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f;
+        fmpz_mpoly_eval_plan_t P;
+        fmpz_t e;
+        fmpz ** valp;
+        slong nvars, len;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        nvars = ctx->minfo->nvars;
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_init(e);
+
+        len = n_randint(state, 50);
+        fmpz_mpoly_randtest_bits(f, state, len, n_randint(state, 100) + 1,
+                                                 n_randint(state, 6) + 1, ctx);
+
+        valp = (fmpz **) flint_malloc((nvars + 1)*sizeof(fmpz *));
+        for (v = 0; v < nvars; v++)
+        {
+            valp[v] = (fmpz *) flint_malloc(sizeof(fmpz));
+            fmpz_init(valp[v]);
+            fmpz_randtest(valp[v], state, 10);
+        }
+
+        fmpz_mpoly_evaluate_all_fmpz(e, f, valp, ctx);
+
+        if (nvars > 0)
+        {
+            fmpz_mpoly_eval_plan_init(P, f, ctx);
+            fmpz_mpoly_eval_plan_evaluate_fmpz(valp[0], P, valp, ctx);
+            fmpz_mpoly_eval_plan_clear(P, ctx);
+
+            if (!fmpz_equal(e, valp[0]))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing of the output with the points\n"
+                                                              "i = %wd\n", i);
+                flint_abort();
+            }
+        }
+
+        for (v = 0; v < nvars; v++)
+        {
+            fmpz_clear(valp[v]);
+            flint_free(valp[v]);
+        }
+        flint_free(valp);
+
+        fmpz_clear(e);
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
+
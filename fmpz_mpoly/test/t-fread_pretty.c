@@ -0,0 +1,222 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, k;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("fread_pretty....");
+    fflush(stdout);
+
+    /* Check reading inverts printing */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g;
+        slong len;
+        flint_bitcnt_t coeff_bits, exp_bits;
+        const char * vars[] = {"x","xy","y","yx","z","zz"};
+        FILE * file;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 6);
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+
+        len = n_randint(state, 200);
+        coeff_bits = n_randint(state, 200);
+        exp_bits = n_randint(state, 100) + 1;
+        fmpz_mpoly_randtest_bits(f, state, len, coeff_bits, exp_bits, ctx);
+
+        flint_set_num_threads(n_randint(state, 5) + 1);
+
+        file = tmpfile();
+        if (file == NULL)
+        {
+            printf("FAIL\n");
+            flint_printf("Could not open temporary file\n");
+            flint_abort();
+        }
+
+        fmpz_mpoly_fprint_pretty(file, f, vars, ctx);
+        fputc('\n', file);
+        rewind(file);
+
+        if (fmpz_mpoly_fread_pretty(file, g, vars, ctx) != 0)
+        {
+            printf("FAIL\n");
+            flint_printf("Check reading inverts printing: failed to read\n"
+                                                               "i = %wd\n", i);
+            flint_abort();
+        }
+        fmpz_mpoly_assert_canonical(g, ctx);
+
+        if (!fmpz_mpoly_equal(f, g, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check reading inverts printing\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        fclose(file);
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check unsorted sums of monomials against the general parser */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g;
+        slong len, nvars;
+        char * vars[] = {"x","xy","y","yx","z","zz"};
+        char * str, * s;
+        ulong e;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 6);
+        nvars = ctx->minfo->nvars;
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+
+        len = n_randint(state, 50);
+        str = (char *) flint_malloc((len*(nvars + 2)*50 + 1)*sizeof(char));
+        s = str;
+        for (j = 0; j < len; j++)
+        {
+            if (j > 0 || n_randint(state, 2))
+                s += sprintf(s, n_randint(state, 2) ? " + " : "-");
+            s += sprintf(s, "%d", (int) n_randint(state, 5));
+            for (k = 0; k < nvars; k++)
+            {
+                if (n_randint(state, 2))
+                    continue;
+                e = n_randint(state, 4);
+                if (n_randint(state, 2))
+                    s += sprintf(s, " * %s", vars[k]);
+                else
+                    s += sprintf(s, "*%s^%d", vars[k], (int) e);
+            }
+            if (n_randint(state, 2))
+                s += sprintf(s, "*%s", vars[n_randint(state, nvars)]);
+        }
+        *s = '\0';
+
+        flint_set_num_threads(n_randint(state, 5) + 1);
+
+        if (fmpz_mpoly_set_str_pretty(f, str, (const char **) vars, ctx) !=
+                              _fmpz_mpoly_parse_pretty(g, str, s - str, vars, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check sum of monomials: return value\n"
+                                              "i = %wd\nstr: %s\n", i, str);
+            flint_abort();
+        }
+        fmpz_mpoly_assert_canonical(f, ctx);
+
+        if (!fmpz_mpoly_equal(f, g, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check sum of monomials\ni = %wd\nstr: %s\n", i, str);
+            flint_abort();
+        }
+
+        flint_free(str);
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check a long sum of monomials followed by a general expression */
+    for (i = 0; i < 2; i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h;
+        const char * vars[] = {"x","y","z"};
+        const char * tail = " + (x + 2*y)^3 - 7*z*(x - 1)";
+        char * str;
+        FILE * file;
+
+        fmpz_mpoly_ctx_init(ctx, 3, ORD_DEGREVLEX);
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+
+        fmpz_mpoly_randtest_bound(f, state, 200000, 20, 100, ctx);
+
+        flint_set_num_threads(i == 0 ? 1 : 4);
+
+        file = tmpfile();
+        if (file == NULL)
+        {
+            printf("FAIL\n");
+            flint_printf("Could not open temporary file\n");
+            flint_abort();
+        }
+
+        fmpz_mpoly_fprint_pretty(file, f, vars, ctx);
+        fputs(tail, file);
+        fputc('\n', file);
+        rewind(file);
+
+        if (fmpz_mpoly_fread_pretty(file, g, vars, ctx) != 0)
+        {
+            printf("FAIL\n");
+            flint_printf("Check long input: failed to read\ni = %wd\n", i);
+            flint_abort();
+        }
+        fmpz_mpoly_assert_canonical(g, ctx);
+
+        if (fmpz_mpoly_set_str_pretty(h, tail, vars, ctx) != 0)
+        {
+            printf("FAIL\n");
+            flint_printf("Check long input: failed to parse tail\n");
+            flint_abort();
+        }
+        fmpz_mpoly_add(h, h, f, ctx);
+        if (!fmpz_mpoly_equal(g, h, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check long input\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        str = fmpz_mpoly_get_str_pretty(f, vars, ctx);
+        if (fmpz_mpoly_set_str_pretty(g, str, vars, ctx) != 0 ||
+                                                   !fmpz_mpoly_equal(g, f, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check long string\ni = %wd\n", i);
+            flint_abort();
+        }
+        flint_free(str);
+
+        fclose(file);
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
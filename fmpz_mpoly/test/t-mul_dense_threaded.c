@@ -0,0 +1,150 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, max_threads = 5;
+    int result, success;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_dense_threaded....");
+    fflush(stdout);
+
+    /* Check mul_dense_threaded matches mul_johnson */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h, k;
+        slong len, len1, len2;
+        flint_bitcnt_t coeff_bits;
+        slong max_bound, exp_bound, exp_bound1, exp_bound2;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 6);
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+        fmpz_mpoly_init(k, ctx);
+
+        len = n_randint(state, 200);
+        len1 = n_randint(state, 200);
+        len2 = n_randint(state, 200);
+
+        max_bound = 1 + 100/ctx->minfo->nvars/ctx->minfo->nvars;
+        exp_bound = UWORD(1) << (FLINT_BITS - 1);
+        exp_bound1 = n_randint(state, max_bound) + 1;
+        exp_bound2 = n_randint(state, max_bound) + 1;
+
+        coeff_bits = n_randint(state, 100);
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mpoly_randtest_bound(f, state, len1, coeff_bits, exp_bound1, ctx);
+            fmpz_mpoly_randtest_bound(g, state, len2, coeff_bits, exp_bound2, ctx);
+            fmpz_mpoly_randtest_bound(h, state, len, coeff_bits, exp_bound, ctx);
+            fmpz_mpoly_randtest_bound(k, state, len, coeff_bits, exp_bound, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_mul_johnson(h, f, g, ctx);
+            fmpz_mpoly_assert_canonical(h, ctx);
+            success = fmpz_mpoly_mul_dense_threaded(k, f, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            if (!success)
+                continue;
+            fmpz_mpoly_assert_canonical(k, ctx);
+            result = fmpz_mpoly_equal(h, k, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check mul_dense_threaded matches mul_johnson\n"
+                                                "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_clear(k, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check aliasing */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h;
+        slong len1, len2;
+        flint_bitcnt_t coeff_bits;
+        slong max_bound, exp_bound1, exp_bound2;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 6);
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+
+        len1 = n_randint(state, 200);
+        len2 = n_randint(state, 200);
+
+        max_bound = 1 + 100/ctx->minfo->nvars/ctx->minfo->nvars;
+        exp_bound1 = n_randint(state, max_bound) + 1;
+        exp_bound2 = n_randint(state, max_bound) + 1;
+
+        coeff_bits = n_randint(state, 100);
+
+        for (j = 0; j < 4; j++)
+        {
+            fmpz_mpoly_randtest_bound(f, state, len1, coeff_bits, exp_bound1, ctx);
+            fmpz_mpoly_randtest_bound(g, state, len2, coeff_bits, exp_bound2, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_mul_johnson(h, f, g, ctx);
+            fmpz_mpoly_assert_canonical(h, ctx);
+            if (n_randint(state, 2))
+                success = fmpz_mpoly_mul_dense_threaded(f, f, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            else
+                success = fmpz_mpoly_mul_dense_threaded(f, g, f, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            if (!success)
+                continue;
+            fmpz_mpoly_assert_canonical(f, ctx);
+            result = fmpz_mpoly_equal(h, f, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
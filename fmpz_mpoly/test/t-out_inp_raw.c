@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, k, n = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("out_raw/inp_raw....");
+    fflush(stdout);
+
+    /* Check a sequence of polynomials survives a round trip */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx, ctx2;
+        fmpz_mpoly_struct a[5];
+        fmpz_mpoly_t b;
+        slong len;
+        flint_bitcnt_t coeff_bits, exp_bits;
+        size_t r, total;
+        FILE * file;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 20);
+        fmpz_mpoly_ctx_init(ctx2, ctx->minfo->nvars + 1, ctx->minfo->ord);
+
+        for (j = 0; j < n; j++)
+        {
+            fmpz_mpoly_init(a + j, ctx);
+            len = n_randint(state, 100);
+            exp_bits = n_randint(state, 200) + 1;
+            coeff_bits = n_randint(state, 200);
+            fmpz_mpoly_randtest_bits(a + j, state, len, coeff_bits,
+                                                                exp_bits, ctx);
+        }
+        fmpz_mpoly_init(b, ctx);
+
+        file = tmpfile();
+        if (file == NULL)
+        {
+            printf("FAIL\n");
+            flint_printf("Could not open temporary file\n");
+            flint_abort();
+        }
+
+        total = 0;
+        for (j = 0; j < n; j++)
+        {
+            r = fmpz_mpoly_out_raw(file, a + j, ctx);
+            if (r == 0)
+            {
+                printf("FAIL\n");
+                flint_printf("Write error\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+            total += r;
+        }
+
+        if ((size_t) ftell(file) != total)
+        {
+            printf("FAIL\n");
+            flint_printf("Check size written\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        rewind(file);
+        for (j = 0; j < n; j++)
+        {
+            r = fmpz_mpoly_inp_raw(b, file, ctx);
+            fmpz_mpoly_assert_canonical(b, ctx);
+            if (r == 0 || !fmpz_mpoly_equal(b, a + j, ctx)
+                       || b->bits != a[j].bits)
+            {
+                printf("FAIL\n");
+                flint_printf("Check round trip\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        if (fmpz_mpoly_inp_raw(b, file, ctx) != 0
+                                                || !fmpz_mpoly_is_zero(b, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check read past end\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        rewind(file);
+        {
+            fmpz_mpoly_t c;
+            fmpz_mpoly_init(c, ctx2);
+            if (fmpz_mpoly_inp_raw(c, file, ctx2) != 0
+                                               || !fmpz_mpoly_is_zero(c, ctx2))
+            {
+                printf("FAIL\n");
+                flint_printf("Check context mismatch\ni = %wd\n", i);
+                flint_abort();
+            }
+            fmpz_mpoly_clear(c, ctx2);
+        }
+
+        fclose(file);
+
+        for (k = 0; k < n; k++)
+            fmpz_mpoly_clear(a + k, ctx);
+        fmpz_mpoly_clear(b, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+        fmpz_mpoly_ctx_clear(ctx2);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
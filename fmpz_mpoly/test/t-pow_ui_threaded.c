@@ -0,0 +1,102 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("pow_ui_threaded....");
+    fflush(stdout);
+
+    /* Check against pow_ui */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h;
+        slong len, nvars;
+        ulong pow, exp_bound;
+        flint_bitcnt_t coeff_bits;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 4);
+        nvars = ctx->minfo->nvars;
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+
+        coeff_bits = n_randint(state, 100);
+
+        for (j = 0; j < 4; j++)
+        {
+            /* alternate between dense and sparse input */
+            if (j % 2 == 0)
+            {
+                len = n_randint(state, 20);
+                exp_bound = n_randint(state, 4) + 1;
+                pow = n_randint(state, 2 + 12/nvars);
+            }
+            else
+            {
+                len = n_randint(state, 10);
+                exp_bound = n_randint(state, 50) + 1;
+                pow = n_randint(state, 2 + 40/(len + 2));
+            }
+
+            fmpz_mpoly_randtest_bound(f, state, len, coeff_bits,
+                                                             exp_bound, ctx);
+            fmpz_mpoly_randtest_bound(g, state, len, coeff_bits,
+                                                             exp_bound, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fmpz_mpoly_pow_ui(h, f, pow, ctx);
+            fmpz_mpoly_pow_ui_threaded(g, f, pow, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(g, ctx);
+
+            if (!fmpz_mpoly_equal(g, h, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check against pow_ui\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            fmpz_mpoly_set(g, f, ctx);
+            fmpz_mpoly_pow_ui_threaded(g, g, pow, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(g, ctx);
+
+            if (!fmpz_mpoly_equal(g, h, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, result, max_threads = 5;
+    slong tmul = 10;
+    FLINT_TEST_INIT(state);
+#ifdef _WIN32
+    tmul = 2;
+#endif
+
+    flint_printf("sort_terms_threaded....");
+    fflush(stdout);
+
+    /* Check scramble and sort */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g;
+        slong len;
+        flint_bitcnt_t coeff_bits, exp_bits;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 10);
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+
+        len = n_randint(state, 2) ? n_randint(state, 200)
+                                  : n_randint(state, 40000);
+        exp_bits = n_randint(state, 200) + 1;
+        coeff_bits = n_randint(state, 100);
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        for (j = 0; j < 2; j++)
+        {
+            slong N, k;
+
+            fmpz_mpoly_randtest_bits(f, state, len, coeff_bits, exp_bits, ctx);
+            fmpz_mpoly_set(g, f, ctx);
+
+            N = mpoly_words_per_exp(f->bits, ctx->minfo);
+            for (k = WORD(0); k < f->length; k++)
+            {
+                ulong a, b;
+                a = n_randint(state, f->length);
+                b = n_randint(state, f->length);
+                fmpz_swap(f->coeffs + a, f->coeffs + b);
+                mpoly_monomial_swap(f->exps + N*a, f->exps + N*b, N);
+            }
+
+            fmpz_mpoly_sort_terms_threaded(f, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(f, ctx);
+            result = fmpz_mpoly_equal(f, g, ctx);
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check scramble and sort\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check sort and combine of f, -f, f, g matches f + g */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fmpz_mpoly_ctx_t ctx;
+        fmpz_mpoly_t f, g, h, k;
+        slong len1, len2;
+        flint_bitcnt_t coeff_bits, exp_bits1, exp_bits2;
+
+        fmpz_mpoly_ctx_init_rand(ctx, state, 10);
+
+        fmpz_mpoly_init(f, ctx);
+        fmpz_mpoly_init(g, ctx);
+        fmpz_mpoly_init(h, ctx);
+        fmpz_mpoly_init(k, ctx);
+
+        len1 = n_randint(state, 2) ? n_randint(state, 200)
+                                   : n_randint(state, 20000);
+        len2 = n_randint(state, 2) ? n_randint(state, 200)
+                                   : n_randint(state, 20000);
+        exp_bits1 = n_randint(state, 200) + 1;
+        exp_bits2 = n_randint(state, 200) + 1;
+        coeff_bits = n_randint(state, 100);
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        for (j = 0; j < 2; j++)
+        {
+            slong N, l, t;
+            flint_bitcnt_t bits;
+
+            fmpz_mpoly_randtest_bits(f, state, len1, coeff_bits,
+                                                           exp_bits1, ctx);
+            fmpz_mpoly_randtest_bits(g, state, len2, coeff_bits,
+                                                           exp_bits2, ctx);
+            fmpz_mpoly_add(h, f, g, ctx);
+
+            bits = FLINT_MAX(f->bits, g->bits);
+            fmpz_mpoly_repack_bits(f, f, bits, ctx);
+            fmpz_mpoly_repack_bits(g, g, bits, ctx);
+            N = mpoly_words_per_exp(bits, ctx->minfo);
+
+            fmpz_mpoly_fit_length(k, 3*f->length + g->length, ctx);
+            fmpz_mpoly_fit_bits(k, bits, ctx);
+            k->bits = bits;
+            l = 0;
+            for (t = 0; t < f->length; t++, l++)
+            {
+                fmpz_set(k->coeffs + l, f->coeffs + t);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < f->length; t++, l++)
+            {
+                fmpz_neg(k->coeffs + l, f->coeffs + t);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < f->length; t++, l++)
+            {
+                fmpz_set(k->coeffs + l, f->coeffs + t);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < g->length; t++, l++)
+            {
+                fmpz_set(k->coeffs + l, g->coeffs + t);
+                mpoly_monomial_set(k->exps + N*l, g->exps + N*t, N);
+            }
+            _fmpz_mpoly_set_length(k, l, ctx);
+
+            for (t = 0; t < k->length; t++)
+            {
+                ulong a, b;
+                a = n_randint(state, k->length);
+                b = n_randint(state, k->length);
+                fmpz_swap(k->coeffs + a, k->coeffs + b);
+                mpoly_monomial_swap(k->exps + N*a, k->exps + N*b, N);
+            }
+
+            fmpz_mpoly_sort_terms_threaded(k, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_combine_like_terms_threaded(k, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fmpz_mpoly_assert_canonical(k, ctx);
+            result = fmpz_mpoly_equal(k, h, ctx);
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check sort and combine\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fmpz_mpoly_clear(f, ctx);
+        fmpz_mpoly_clear(g, ctx);
+        fmpz_mpoly_clear(h, ctx);
+        fmpz_mpoly_clear(k, ctx);
+        fmpz_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -19,7 +19,16 @@ TEMPLATE(T, mat_mul) (TEMPLATE(T, mat_t) C,
                       const TEMPLATE(T, mat_t) B, const TEMPLATE(T, ctx_t) ctx)
 {
     if (TEMPLATE(CAP_T, MAT_MUL_KS_CUTOFF) (A->r, B->c, ctx))
+    {
+#ifdef USE_MAT_MUL_SPLIT
+        if (TEMPLATE(CAP_T, MAT_MUL_SPLIT_CUTOFF) (A->r, A->c, B->c, ctx))
+        {
+            TEMPLATE(T, mat_mul_split) (C, A, B, ctx);
+            return;
+        }
+#endif
         TEMPLATE(T, mat_mul_KS) (C, A, B, ctx);
+    }
     else
         TEMPLATE(T, mat_mul_classical) (C, A, B, ctx);
 }
@@ -20,6 +20,7 @@
 #define FQ_NMOD_MAT_INLINE static __inline__
 #endif
 
+#include "nmod_mat.h"
 #include "fq_nmod.h"
 #include "fq_nmod_vec.h"
 
@@ -41,10 +42,38 @@ int FQ_NMOD_MAT_MUL_KS_CUTOFF(slong r, slong c, const fq_nmod_ctx_t ctx)
         return 0;
 }
 
+/*
+    Whether to multiply through products of nmod_mat coefficient matrices
+    rather than Kronecker substitution. Evaluation and interpolation need
+    2d - 1 products, while Kronecker substitution packs 2d - 1 coefficients
+    of 2*log2(p) + log2(k) bits into integer matrices multiplied modulo
+    primes of NMOD_MAT_OPTIMAL_MODULUS_BITS bits; the interpolation costs
+    O(d^2) per entry.
+*/
+FQ_NMOD_MAT_INLINE
+int FQ_NMOD_MAT_MUL_SPLIT_CUTOFF(slong r, slong k, slong c,
+                                                   const fq_nmod_ctx_t ctx)
+{
+    slong d = fq_nmod_ctx_degree(ctx);
+    slong bits, primes;
+
+    if (ctx->mod.n < (mp_limb_t) (2*d - 1) || FLINT_MIN(r, c) < 2*d)
+        return 0;
+
+    bits = (2*d - 1)*(2*FLINT_BIT_COUNT(ctx->mod.n) + FLINT_BIT_COUNT(k));
+    primes = (bits + NMOD_MAT_OPTIMAL_MODULUS_BITS - 1)/
+                                               NMOD_MAT_OPTIMAL_MODULUS_BITS;
+
+    return 2*d - 1 <= primes + 1;
+}
+
 #define T fq_nmod
 #define CAP_T FQ_NMOD
 #include "fq_mat_templates.h"
 #undef CAP_T
 #undef T
 
+FLINT_DLL void fq_nmod_mat_mul_split(fq_nmod_mat_t C, const fq_nmod_mat_t A,
+                              const fq_nmod_mat_t B, const fq_nmod_ctx_t ctx);
+
 #endif
@@ -17,6 +17,8 @@
 
 #define T fq_nmod
 #define CAP_T FQ_NMOD
+#define USE_MAT_MUL_SPLIT 1
 #include "fq_mat_templates/mul.c"
+#undef USE_MAT_MUL_SPLIT
 #undef CAP_T
 #undef T
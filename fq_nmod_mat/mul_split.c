@@ -0,0 +1,247 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_mat.h"
+#include "fq_nmod_mat.h"
+
+/* A = sum_i Ai[i]*x^i with the Ai[i] over Z/pZ */
+static void
+_split(nmod_mat_struct * Ai, const fq_nmod_mat_t A)
+{
+    slong i, j, t;
+
+    for (i = 0; i < A->r; i++)
+    {
+        for (j = 0; j < A->c; j++)
+        {
+            const fq_nmod_struct * a = fq_nmod_mat_entry(A, i, j);
+
+            for (t = 0; t < a->length; t++)
+                nmod_mat_entry(Ai + t, i, j) = a->coeffs[t];
+        }
+    }
+}
+
+/*
+    Set C[0], ..., C[2*len - 2] to the coefficients of the product of the
+    matrix polynomials A and B of length len, using Karatsuba's algorithm
+    on the coefficient index. The C[i] must be zero on input.
+*/
+static void
+_mat_poly_mul_karatsuba(nmod_mat_struct * C, const nmod_mat_struct * A,
+                                         const nmod_mat_struct * B, slong len)
+{
+    slong i, h, h2, m, k, n;
+    mp_limb_t p;
+    nmod_mat_struct * SA, * SB, * T;
+
+    if (len == 1)
+    {
+        nmod_mat_mul(C + 0, A + 0, B + 0);
+        return;
+    }
+
+    m = A->r;
+    k = A->c;
+    n = B->c;
+    p = A->mod.n;
+
+    h = len/2;
+    h2 = len - h;
+
+    SA = (nmod_mat_struct *) flint_malloc(h2*sizeof(nmod_mat_struct));
+    SB = (nmod_mat_struct *) flint_malloc(h2*sizeof(nmod_mat_struct));
+    T = (nmod_mat_struct *) flint_malloc((2*h2 - 1)*sizeof(nmod_mat_struct));
+
+    for (i = 0; i < h2; i++)
+    {
+        nmod_mat_init(SA + i, m, k, p);
+        nmod_mat_init(SB + i, k, n, p);
+        nmod_mat_set(SA + i, A + h + i);
+        nmod_mat_set(SB + i, B + h + i);
+        if (i < h)
+        {
+            nmod_mat_add(SA + i, SA + i, A + i);
+            nmod_mat_add(SB + i, SB + i, B + i);
+        }
+    }
+
+    for (i = 0; i < 2*h2 - 1; i++)
+        nmod_mat_init(T + i, m, n, p);
+
+    /* middle product (A0 + A1)*(B0 + B1) into T */
+    _mat_poly_mul_karatsuba(T, SA, SB, h2);
+
+    /* C = A0*B0 + A1*B1*x^(2h) does not overlap */
+    _mat_poly_mul_karatsuba(C, A, B, h);
+    _mat_poly_mul_karatsuba(C + 2*h, A + h, B + h, h2);
+
+    for (i = 0; i < 2*h - 1; i++)
+        nmod_mat_sub(T + i, T + i, C + i);
+    for (i = 0; i < 2*h2 - 1; i++)
+        nmod_mat_sub(T + i, T + i, C + 2*h + i);
+    for (i = 0; i < 2*h2 - 1; i++)
+        nmod_mat_add(C + h + i, C + h + i, T + i);
+
+    for (i = 0; i < h2; i++)
+    {
+        nmod_mat_clear(SA + i);
+        nmod_mat_clear(SB + i);
+    }
+    for (i = 0; i < 2*h2 - 1; i++)
+        nmod_mat_clear(T + i);
+
+    flint_free(SA);
+    flint_free(SB);
+    flint_free(T);
+}
+
+/*
+    Write A = sum A_i x^i and B = sum B_i x^i where the A_i and B_i are
+    matrices over Z/pZ and x is the generator of the field. The 2d - 1
+    coefficients of the product A(x)*B(x) are computed with nmod_mat
+    products, by evaluation at 0, 1, ..., 2d - 2 and interpolation if
+    p >= 2d - 1 and by Karatsuba's algorithm otherwise, and every entry
+    of the result is then reduced once by the defining polynomial.
+*/
+void
+fq_nmod_mat_mul_split(fq_nmod_mat_t C, const fq_nmod_mat_t A,
+                              const fq_nmod_mat_t B, const fq_nmod_ctx_t ctx)
+{
+    slong d, len, m, k, n, i, j, t;
+    mp_limb_t p;
+    nmod_mat_struct * Ai, * Bi, * Ci;
+    nmod_mat_t V, Vinv;
+    mp_ptr vals, coeffs;
+    int eval, nlimbs;
+
+    m = A->r;
+    k = A->c;
+    n = B->c;
+
+    if (k == 0)
+    {
+        fq_nmod_mat_zero(C, ctx);
+        return;
+    }
+
+    if (m == 0 || n == 0)
+        return;
+
+    d = fq_nmod_ctx_degree(ctx);
+    p = ctx->mod.n;
+    len = 2*d - 1;
+    eval = (p >= (mp_limb_t) len);
+
+    Ai = (nmod_mat_struct *) flint_malloc(d*sizeof(nmod_mat_struct));
+    Bi = (nmod_mat_struct *) flint_malloc(d*sizeof(nmod_mat_struct));
+    Ci = (nmod_mat_struct *) flint_malloc(len*sizeof(nmod_mat_struct));
+
+    for (i = 0; i < d; i++)
+    {
+        nmod_mat_init(Ai + i, m, k, p);
+        nmod_mat_init(Bi + i, k, n, p);
+    }
+    for (i = 0; i < len; i++)
+        nmod_mat_init(Ci + i, m, n, p);
+
+    _split(Ai, A);
+    _split(Bi, B);
+
+    if (eval)
+    {
+        nmod_mat_t EA, EB;
+
+        nmod_mat_init(EA, m, k, p);
+        nmod_mat_init(EB, k, n, p);
+        nmod_mat_init(V, len, len, p);
+        nmod_mat_init(Vinv, len, len, p);
+
+        /* Ci[j] = A(j)*B(j) */
+        for (j = 0; j < len; j++)
+        {
+            nmod_mat_set(EA, Ai + d - 1);
+            nmod_mat_set(EB, Bi + d - 1);
+            for (i = d - 2; i >= 0; i--)
+            {
+                nmod_mat_scalar_mul_add(EA, Ai + i, j, EA);
+                nmod_mat_scalar_mul_add(EB, Bi + i, j, EB);
+            }
+
+            nmod_mat_mul(Ci + j, EA, EB);
+
+            nmod_mat_entry(V, j, 0) = 1;
+            for (t = 1; t < len; t++)
+                nmod_mat_entry(V, j, t) = nmod_mul(nmod_mat_entry(V, j, t - 1),
+                                                                   j, ctx->mod);
+        }
+
+        nmod_mat_inv(Vinv, V);
+
+        nmod_mat_clear(EA);
+        nmod_mat_clear(EB);
+        nmod_mat_clear(V);
+    }
+    else
+    {
+        _mat_poly_mul_karatsuba(Ci, Ai, Bi, d);
+    }
+
+    for (i = 0; i < d; i++)
+    {
+        nmod_mat_clear(Ai + i);
+        nmod_mat_clear(Bi + i);
+    }
+    flint_free(Ai);
+    flint_free(Bi);
+
+    vals = _nmod_vec_init(len);
+    coeffs = _nmod_vec_init(len);
+    nlimbs = _nmod_vec_dot_bound_limbs(len, ctx->mod);
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            fq_nmod_struct * c = fq_nmod_mat_entry(C, i, j);
+
+            for (t = 0; t < len; t++)
+                vals[t] = nmod_mat_entry(Ci + t, i, j);
+
+            if (eval)
+            {
+                for (t = 0; t < len; t++)
+                    coeffs[t] = _nmod_vec_dot(Vinv->rows[t], vals, len,
+                                                            ctx->mod, nlimbs);
+            }
+            else
+            {
+                _nmod_vec_set(coeffs, vals, len);
+            }
+
+            _fq_nmod_reduce(coeffs, len, ctx);
+
+            nmod_poly_fit_length(c, d);
+            _nmod_vec_set(c->coeffs, coeffs, d);
+            c->length = d;
+            _nmod_poly_normalise(c);
+        }
+    }
+
+    if (eval)
+        nmod_mat_clear(Vinv);
+
+    for (i = 0; i < len; i++)
+        nmod_mat_clear(Ci + i);
+    flint_free(Ci);
+
+    _nmod_vec_clear(vals);
+    _nmod_vec_clear(coeffs);
+}
@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fq_nmod_mat.h"
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_split....");
+    fflush(stdout);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fq_nmod_ctx_t ctx;
+        fq_nmod_mat_t A, B, C, D;
+        slong m, k, n;
+
+        /* small primes exercise the Karatsuba path */
+        if (n_randint(state, 2))
+        {
+            fmpz_t p;
+            fmpz_init_set_ui(p, n_randint(state, 2) ? 2 : 3);
+            fq_nmod_ctx_init(ctx, p, 1 + n_randint(state, 12), "a");
+            fmpz_clear(p);
+        }
+        else
+        {
+            fq_nmod_ctx_randtest(ctx, state);
+        }
+
+        m = n_randint(state, 20);
+        k = n_randint(state, 20);
+        n = n_randint(state, 20);
+
+        fq_nmod_mat_init(A, m, k, ctx);
+        fq_nmod_mat_init(B, k, n, ctx);
+        fq_nmod_mat_init(C, m, n, ctx);
+        fq_nmod_mat_init(D, m, n, ctx);
+
+        fq_nmod_mat_randtest(A, state, ctx);
+        fq_nmod_mat_randtest(B, state, ctx);
+        fq_nmod_mat_randtest(C, state, ctx);  /* noise in output */
+
+        fq_nmod_mat_mul_split(C, A, B, ctx);
+        fq_nmod_mat_mul_classical(D, A, B, ctx);
+
+        if (!fq_nmod_mat_equal(C, D, ctx))
+        {
+            flint_printf("FAIL: results not equal\n");
+            fq_nmod_mat_print(A, ctx);
+            fq_nmod_mat_print(B, ctx);
+            fq_nmod_mat_print(C, ctx);
+            fq_nmod_mat_print(D, ctx);
+            abort();
+        }
+
+        if (k == n)
+        {
+            fq_nmod_mat_mul_split(A, A, B, ctx);
+
+            if (!fq_nmod_mat_equal(A, D, ctx))
+            {
+                flint_printf("FAIL: aliasing failed\n");
+                abort();
+            }
+        }
+
+        fq_nmod_mat_clear(A, ctx);
+        fq_nmod_mat_clear(B, ctx);
+        fq_nmod_mat_clear(C, ctx);
+        fq_nmod_mat_clear(D, ctx);
+        fq_nmod_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -580,6 +580,12 @@ FLINT_DLL void fq_nmod_mpoly_sort_terms(fq_nmod_mpoly_t A,
 FLINT_DLL void fq_nmod_mpoly_combine_like_terms(fq_nmod_mpoly_t A,
                                                 const fq_nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL void fq_nmod_mpoly_sort_terms_threaded(fq_nmod_mpoly_t A,
+                            const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void fq_nmod_mpoly_combine_like_terms_threaded(fq_nmod_mpoly_t A,
+                            const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void fq_nmod_mpoly_reverse(fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
                                                 const fq_nmod_mpoly_ctx_t ctx);
 
@@ -592,6 +598,18 @@ FLINT_DLL void _fq_nmod_mpoly_radix_sort1(fq_nmod_mpoly_t A, slong left,
 FLINT_DLL void _fq_nmod_mpoly_radix_sort(fq_nmod_mpoly_t A, slong left,
                        slong right, flint_bitcnt_t pos, slong N, ulong * cmpmask);
 
+FLINT_DLL void _fq_nmod_mpoly_radix_sort_bytes(fq_nmod_struct * Acoeff,
+          ulong * Aexp, slong left, slong right, const slong * digits, slong k,
+                 slong ndigits, slong N, const ulong * cmpmask, slong * stack);
+
+FLINT_DLL void _fq_nmod_mpoly_sort_terms_threaded(fq_nmod_mpoly_t A,
+                                const fq_nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _fq_nmod_mpoly_combine_like_terms_threaded(fq_nmod_mpoly_t A,
+                                const fq_nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL void _fq_nmod_mpoly_push_exp_ffmpz(fq_nmod_mpoly_t A,
                               const fmpz * exp, const fq_nmod_mpoly_ctx_t ctx);
 
@@ -666,6 +684,32 @@ FLINT_DLL slong _fq_nmod_mpoly_mul_johnson(
              const fq_nmod_struct * coeff3, const ulong * exp3, slong len3,
   flint_bitcnt_t bits, slong N, const ulong * cmpmask, const fq_nmod_ctx_t fqctx);
 
+FLINT_DLL void _fq_nmod_mpoly_mul_johnson_maxfields(fq_nmod_mpoly_t A,
+                                 const fq_nmod_mpoly_t B, fmpz * maxBfields,
+                                 const fq_nmod_mpoly_t C, fmpz * maxCfields,
+                                                const fq_nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void fq_nmod_mpoly_mul_threaded(fq_nmod_mpoly_t A,
+                     const fq_nmod_mpoly_t B, const fq_nmod_mpoly_t C,
+                                const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void fq_nmod_mpoly_mul_heap_threaded(fq_nmod_mpoly_t A,
+                     const fq_nmod_mpoly_t B, const fq_nmod_mpoly_t C,
+                                const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void _fq_nmod_mpoly_mul_heap_threaded(fq_nmod_mpoly_t A,
+             const fq_nmod_struct * Bcoeff, const ulong * Bexp, slong Blen,
+             const fq_nmod_struct * Ccoeff, const ulong * Cexp, slong Clen,
+                 flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                                const fq_nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _fq_nmod_mpoly_mul_heap_threaded_maxfields(fq_nmod_mpoly_t A,
+                                 const fq_nmod_mpoly_t B, fmpz * maxBfields,
+                                 const fq_nmod_mpoly_t C, fmpz * maxCfields,
+                                 const fq_nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
 
 /* Powering ******************************************************************/
 
@@ -721,15 +765,33 @@ FLINT_DLL slong _fq_nmod_mpoly_divides_monagan_pearce(
              const fq_nmod_struct * coeff3, const ulong * exp3, slong len3,
   flint_bitcnt_t bits, slong N, const ulong * cmpmask, const fq_nmod_ctx_t fqctx);
 
+FLINT_DLL int fq_nmod_mpoly_divides_threaded(fq_nmod_mpoly_t Q,
+                         const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
+                             const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL int fq_nmod_mpoly_divides_heap_threaded(fq_nmod_mpoly_t Q,
+                         const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
+                             const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL int _fq_nmod_mpoly_divides_heap_threaded(fq_nmod_mpoly_t Q,
+                         const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
+                                                 const fq_nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
 
 /* GCD ***********************************************************************/
 
 FLINT_DLL int fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
                        const fq_nmod_mpoly_t B, const fq_nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL int fq_nmod_mpoly_gcd_threaded(fq_nmod_mpoly_t G,
+                            const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
+                           const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL int _fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits,
                             const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
-                                                const fq_nmod_mpoly_ctx_t ctx);
+                                                const fq_nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
 
 FLINT_DLL int _fq_nmod_mpoly_gcd_monomial(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits,
                              const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
@@ -749,6 +811,10 @@ FLINT_DLL int fq_nmod_mpoly_gcd_brown(fq_nmod_mpoly_t G,
                             const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
                                                 const fq_nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL int fq_nmod_mpoly_gcd_brown_threaded(fq_nmod_mpoly_t G,
+                            const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
+                           const fq_nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL int fq_nmod_mpoly_gcd_brownnew(fq_nmod_mpoly_t G,
                             const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
                                                 const fq_nmod_mpoly_ctx_t ctx);
@@ -789,6 +855,27 @@ FLINT_DLL void fq_nmod_mpoly_ctx_change_modulus(fq_nmod_mpoly_ctx_t ctx,
                                                                     slong deg);
 
 
+/* data is passed to the threaded mul/div functions via a stripe struct */
+
+typedef struct _fq_nmod_mpoly_stripe_struct
+{
+    char * big_mem;
+    slong big_mem_alloc;
+    const fq_nmod_mpoly_ctx_struct * ctx;
+    slong N;
+    flint_bitcnt_t bits;
+    const fq_nmod_struct * lc_minus_inv;
+    const ulong * cmpmask;
+    slong * startidx;
+    slong * endidx;
+    ulong * emin;
+    ulong * emax;
+    int upperclosed;
+} fq_nmod_mpoly_stripe_struct;
+
+typedef fq_nmod_mpoly_stripe_struct fq_nmod_mpoly_stripe_t[1];
+
+
 /* univar ********************************************************************/
 
 FLINT_DLL void fq_nmod_mpoly_univar_init(fq_nmod_mpoly_univar_t A,
@@ -1071,6 +1158,15 @@ FLINT_DLL void _fq_nmod_mpoly_to_mpolyun_perm_deflate(
                 const fq_nmod_mpoly_t B, const fq_nmod_mpoly_ctx_t ctx,
                 const slong * perm, const ulong * shift, const ulong * stride);
 
+FLINT_DLL void _fq_nmod_mpoly_to_mpolyun_perm_deflate_threaded(
+              fq_nmod_mpolyun_t An, fq_nmod_mpolyun_t Bn,
+              const fq_nmod_mpoly_ctx_t uctx,
+              const fq_nmod_mpoly_t A, const ulong * Ashift,
+              const fq_nmod_mpoly_t B, const ulong * Bshift,
+              const fq_nmod_mpoly_ctx_t ctx,
+              const slong * perm, const ulong * stride,
+              const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL void _fq_nmod_mpoly_from_mpolyun_perm_inflate(
     fq_nmod_mpoly_t A, flint_bitcnt_t Abits, const fq_nmod_mpoly_ctx_t ctx,
                       fq_nmod_mpolyun_t B, const fq_nmod_mpoly_ctx_t uctx,
@@ -1162,6 +1258,17 @@ FLINT_DLL int fq_nmod_mpolyun_gcd_brown_smprime(
     slong var,
     const fq_nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL int fq_nmod_mpolyun_gcd_brown_smprime_threaded(
+    fq_nmod_mpolyun_t G,
+    fq_nmod_mpolyun_t Abar,
+    fq_nmod_mpolyun_t Bbar,
+    fq_nmod_mpolyun_t A,
+    fq_nmod_mpolyun_t B,
+    slong var,
+    const fq_nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles);
+
 FLINT_DLL int fq_nmod_mpolyun_gcd_brown_lgprime_bivar(
     fq_nmod_mpolyun_t G,
     fq_nmod_mpolyun_t Abar,
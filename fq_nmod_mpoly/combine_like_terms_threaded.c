@@ -0,0 +1,174 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "fq_nmod_mpoly.h"
+
+/* polynomials with fewer terms per thread are combined by one thread */
+#define COMBINE_THREADED_CUTOFF 4096
+
+typedef struct
+{
+    fq_nmod_struct * coeffs;
+    ulong * exps;
+    slong N;
+    slong start;
+    slong stop;
+    slong length;
+    const fq_nmod_ctx_struct * fqctx;
+}
+_worker_arg_struct;
+
+/* combine the terms in [start, stop) into a prefix of this range */
+static void _combine_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    fq_nmod_struct * coeffs = arg->coeffs;
+    ulong * exps = arg->exps;
+    slong in, out, N = arg->N;
+
+    out = arg->start - 1;
+
+    for (in = arg->start; in < arg->stop; in++)
+    {
+        FLINT_ASSERT(in > out);
+
+        if (out >= arg->start &&
+                     mpoly_monomial_equal(exps + N*out, exps + N*in, N))
+        {
+            fq_nmod_add(coeffs + out, coeffs + out, coeffs + in,
+                                                                  arg->fqctx);
+        }
+        else
+        {
+            if (out < arg->start || !fq_nmod_is_zero(coeffs + out, arg->fqctx))
+                out++;
+
+            if (out != in)
+            {
+                mpoly_monomial_set(exps + N*out, exps + N*in, N);
+                fq_nmod_swap(coeffs + out, coeffs + in, arg->fqctx);
+            }
+        }
+    }
+
+    if (out < arg->start || !fq_nmod_is_zero(coeffs + out, arg->fqctx))
+        out++;
+
+    arg->length = out - arg->start;
+}
+
+/*
+    The terms are split into ranges that do not separate like terms.
+    Each range is combined by one thread and the results are then moved
+    together.
+*/
+void _fq_nmod_mpoly_combine_like_terms_threaded(fq_nmod_mpoly_t A,
+                                const fq_nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, j, Alen, nthreads, N;
+    _worker_arg_struct * args;
+
+    if (num_handles < 1 ||
+                    A->length < (num_handles + 1)*COMBINE_THREADED_CUTOFF)
+    {
+        fq_nmod_mpoly_combine_like_terms(A, ctx);
+        return;
+    }
+
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+    nthreads = num_handles + 1;
+
+    args = (_worker_arg_struct *) flint_malloc(nthreads
+                                                  *sizeof(_worker_arg_struct));
+    j = 0;
+    for (i = 0; i < nthreads; i++)
+    {
+        args[i].coeffs = A->coeffs;
+        args[i].exps = A->exps;
+        args[i].N = N;
+        args[i].fqctx = ctx->fqctx;
+        args[i].start = j;
+        j = FLINT_MAX(j, A->length*(i + 1)/nthreads);
+        while (0 < j && j < A->length &&
+                 mpoly_monomial_equal(A->exps + N*(j - 1), A->exps + N*j, N))
+        {
+            j++;
+        }
+        args[i].stop = j;
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                    _combine_worker, &args[i]);
+    }
+    _combine_worker(&args[num_handles]);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    /* move the combined ranges together in order */
+    Alen = args[0].length;
+    for (i = 1; i < nthreads; i++)
+    {
+        for (j = 0; j < args[i].length; j++)
+        {
+            fq_nmod_swap(A->coeffs + Alen + j, A->coeffs + args[i].start + j,
+                                                                   ctx->fqctx);
+            mpoly_monomial_set(A->exps + N*(Alen + j),
+                                        A->exps + N*(args[i].start + j), N);
+        }
+        Alen += args[i].length;
+    }
+
+    flint_free(args);
+
+    A->length = Alen;
+}
+
+
+void fq_nmod_mpoly_combine_like_terms_threaded(fq_nmod_mpoly_t A,
+                            const fq_nmod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _fq_nmod_mpoly_combine_like_terms_threaded(A, ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
@@ -10,11 +10,76 @@
 */
 
 #include "fq_nmod_mpoly.h"
+#include "thread_pool.h"
 
-int fq_nmod_mpoly_divides(fq_nmod_mpoly_t Q,
-                        const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
-                                                 const fq_nmod_mpoly_ctx_t ctx)
+int fq_nmod_mpoly_divides_threaded(
+    fq_nmod_mpoly_t Q,
+    const fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_ctx_t ctx,
+    slong thread_limit)
 {
-    /* nothing fancy here */
-    return fq_nmod_mpoly_divides_monagan_pearce(Q, A, B, ctx);
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+    int divides;
+
+    if (B->length == 0)
+    {
+        flint_throw(FLINT_DIVZERO, "Exception in fq_nmod_mpoly_divides_threaded: "
+                                                   "Cannot divide by zero.\n");
+    }
+
+    /* the threaded division needs at least two terms in A and B */
+    if (A->length < 2 || B->length < 2)
+    {
+        return fq_nmod_mpoly_divides_monagan_pearce(Q, A, B, ctx);
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (thread_limit > 1 && global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    if (num_handles > 0)
+    {
+        divides = _fq_nmod_mpoly_divides_heap_threaded(Q, A, B, ctx,
+                                                         handles, num_handles);
+    }
+    else
+    {
+        divides = fq_nmod_mpoly_divides_monagan_pearce(Q, A, B, ctx);
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+    return divides;
+}
+
+int fq_nmod_mpoly_divides(
+    fq_nmod_mpoly_t Q,
+    const fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_ctx_t ctx)
+{
+    return fq_nmod_mpoly_divides_threaded(Q, A, B, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
 }
@@ -33,13 +33,14 @@ static int _try_missing_var(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, slong var,
         goto cleanup;
 
     FLINT_ASSERT(Ax->length > 0);
-    success = _fq_nmod_mpoly_gcd(tG, Gbits, B, Ax->coeffs + 0, ctx);
+    success = _fq_nmod_mpoly_gcd(tG, Gbits, B, Ax->coeffs + 0, ctx, NULL, 0);
     if (!success)
         goto cleanup;
 
     for (i = 1; i < Ax->length; i++)
     {
-        success = _fq_nmod_mpoly_gcd(tG, Gbits, tG, Ax->coeffs + i, ctx);
+        success = _fq_nmod_mpoly_gcd(tG, Gbits, tG, Ax->coeffs + i,
+                                                               ctx, NULL, 0);
         if (!success)
             goto cleanup;
     }
@@ -267,7 +268,7 @@ static int _try_zippel(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, ulong * Gstride,
 
     /* compute content of A */
     success = _fq_nmod_mpoly_gcd(Acontent, ABbits, Au->coeffs + 0,
-                                                  Au->coeffs + 1, uctx);
+                                        Au->coeffs + 1, uctx, NULL, 0);
     if (!success)
         goto cleanup;
     FLINT_ASSERT(Acontent->bits == ABbits);
@@ -275,7 +276,7 @@ static int _try_zippel(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, ulong * Gstride,
     for (i = 2; i < Au->length; i++)
     {
         success = _fq_nmod_mpoly_gcd(Acontent, ABbits, Acontent,
-                                                      Au->coeffs + i, uctx);
+                                        Au->coeffs + i, uctx, NULL, 0);
         if (!success)
             goto cleanup;
         FLINT_ASSERT(Acontent->bits == ABbits);
@@ -283,14 +284,14 @@ static int _try_zippel(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, ulong * Gstride,
 
     /* compute content of B */
     success = _fq_nmod_mpoly_gcd(Bcontent, ABbits, Bu->coeffs + 0,
-                                                  Bu->coeffs + 1, uctx);
+                                        Bu->coeffs + 1, uctx, NULL, 0);
     if (!success)
         goto cleanup;
     FLINT_ASSERT(Bcontent->bits == ABbits);
     for (i = 2; i < Bu->length; i++)
     {
         success = _fq_nmod_mpoly_gcd(Bcontent, ABbits, Bcontent,
-                                                      Bu->coeffs + i, uctx);
+                                        Bu->coeffs + i, uctx, NULL, 0);
         if (!success)
             goto cleanup;
         FLINT_ASSERT(Bcontent->bits == ABbits);
@@ -308,7 +309,8 @@ static int _try_zippel(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, ulong * Gstride,
         goto cleanup;
 
     /* put back content */
-    success = _fq_nmod_mpoly_gcd(Acontent, ABbits, Acontent, Bcontent, uctx);
+    success = _fq_nmod_mpoly_gcd(Acontent, ABbits, Acontent, Bcontent,
+                                                             uctx, NULL, 0);
     if (!success)
         goto cleanup;
 
@@ -354,7 +356,8 @@ cleanup:
 static int _try_brown(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, ulong * Gstride,
       const fq_nmod_mpoly_t A, const ulong * Amax_exp, const ulong * Amin_exp,
       const fq_nmod_mpoly_t B, const ulong * Bmax_exp, const ulong * Bmin_exp,
-                                                 const fq_nmod_mpoly_ctx_t ctx)
+                                                const fq_nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles)
 {
     int success;
     slong j;
@@ -439,12 +442,11 @@ static int _try_brown(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits, ulong * Gstride,
     fq_nmod_mpolyun_init(Abarn, ABbits, uctx);
     fq_nmod_mpolyun_init(Bbarn, ABbits, uctx);
 
-    _fq_nmod_mpoly_to_mpolyun_perm_deflate(An, uctx, A, ctx,
-                                                      perm, Amin_exp, Gstride);
-    _fq_nmod_mpoly_to_mpolyun_perm_deflate(Bn, uctx, B, ctx,
-                                                      perm, Bmin_exp, Gstride);
-    success = fq_nmod_mpolyun_gcd_brown_smprime(Gn, Abarn, Bbarn, An, Bn,
-                                                                  m - 2, uctx);
+    _fq_nmod_mpoly_to_mpolyun_perm_deflate_threaded(An, Bn, uctx,
+                                        A, Amin_exp, B, Bmin_exp, ctx,
+                                        perm, Gstride, handles, num_handles);
+    success = fq_nmod_mpolyun_gcd_brown_smprime_threaded(Gn, Abarn, Bbarn,
+                                     An, Bn, m - 2, uctx, handles, num_handles);
     if (!success)
     {
         _fq_nmod_mpoly_to_mpolyun_perm_deflate(An, uctx, A, ctx,
@@ -487,7 +489,8 @@ cleanup1:
 */
 int _fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits,
                             const fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
-                                                 const fq_nmod_mpoly_ctx_t ctx)
+                                                const fq_nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles)
 {
     int success;
     slong v_in_both;
@@ -669,7 +672,7 @@ int _fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, flint_bitcnt_t Gbits,
                   B->exps, B->bits, B->length, Bmax_exp, Bmin_exp, ctx->minfo);
 
     success = _try_brown(G, Gbits, Gstride, A, Amax_exp, Amin_exp,
-                                            B, Bmax_exp, Bmin_exp, ctx);
+                              B, Bmax_exp, Bmin_exp, ctx, handles, num_handles);
     if (success)
         goto cleanup;
 
@@ -684,10 +687,15 @@ cleanup:
 }
 
 
-int fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
-                       const fq_nmod_mpoly_t B, const fq_nmod_mpoly_ctx_t ctx)
+int fq_nmod_mpoly_gcd_threaded(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
+                         const fq_nmod_mpoly_t B, const fq_nmod_mpoly_ctx_t ctx,
+                                                           slong thread_limit)
 {
+    slong i;
     flint_bitcnt_t Gbits;
+    int success;
+    thread_pool_handle * handles;
+    slong num_handles;
 
     if (fq_nmod_mpoly_is_zero(A, ctx))
     {
@@ -709,7 +717,35 @@ int fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
     if (A->bits <= FLINT_BITS && B->bits <= FLINT_BITS)
     {
         /* usual gcd's go right down here */
-        return _fq_nmod_mpoly_gcd(G, Gbits, A, B, ctx);
+
+        /* get workers */
+        handles = NULL;
+        num_handles = 0;
+        if (global_thread_pool_initialized)
+        {
+            slong max_num_handles = thread_pool_get_size(global_thread_pool);
+            max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+            if (max_num_handles > 0)
+            {
+                handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+                num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+            }
+        }
+
+        success = _fq_nmod_mpoly_gcd(G, Gbits, A, B, ctx, handles, num_handles);
+
+        for (i = 0; i < num_handles; i++)
+        {
+            thread_pool_give_back(global_thread_pool, handles[i]);
+        }
+        if (handles)
+        {
+            flint_free(handles);
+        }
+
+        return success;
     }
 
     if (A->length == 1)
@@ -732,7 +768,6 @@ int fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
             Then, try deflation as a last resort.
         */
 
-        int success;
         int useAnew = 0;
         int useBnew = 0;
         slong k;
@@ -760,7 +795,7 @@ int fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
         }
 
         success = _fq_nmod_mpoly_gcd(G, FLINT_BITS, useAnew ? Anew : A,
-                                                    useBnew ? Bnew : B, ctx);
+                                           useBnew ? Bnew : B, ctx, NULL, 0);
         goto cleanup;
 
 could_not_repack:
@@ -801,7 +836,7 @@ could_not_repack:
                 goto deflate_cleanup;
         }
 
-        success = _fq_nmod_mpoly_gcd(G, FLINT_BITS, Anew, Bnew, ctx);
+        success = _fq_nmod_mpoly_gcd(G, FLINT_BITS, Anew, Bnew, ctx, NULL, 0);
 
         if (success)
         {
@@ -826,3 +861,9 @@ cleanup:
         return success;
     }
 }
+
+int fq_nmod_mpoly_gcd(fq_nmod_mpoly_t G, const fq_nmod_mpoly_t A,
+                       const fq_nmod_mpoly_t B, const fq_nmod_mpoly_ctx_t ctx)
+{
+    return fq_nmod_mpoly_gcd_threaded(G, A, B, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+}
@@ -0,0 +1,1222 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "fq_nmod_mpoly.h"
+#include "thread_pool.h"
+
+/*
+    Data for crt'ing in Fq[X] wrt coprime moduli m[0], ..., m[count - 1]:
+    prods[k] = m[0]*...*m[k-1] and invs[k] = prods[k]^-1 mod m[k]
+*/
+typedef struct
+{
+    const fq_nmod_poly_struct * const * moduli;
+    fq_nmod_poly_struct * prods;
+    fq_nmod_poly_struct * invs;
+    slong count;
+}
+_crt_struct;
+
+typedef _crt_struct _crt_t[1];
+
+static void _crt_init(
+    _crt_t C,
+    const fq_nmod_poly_struct * const * moduli,
+    slong count,
+    const fq_nmod_ctx_t fqctx)
+{
+    slong k;
+    fq_nmod_poly_t g, t, r;
+
+    fq_nmod_poly_init(g, fqctx);
+    fq_nmod_poly_init(t, fqctx);
+    fq_nmod_poly_init(r, fqctx);
+
+    C->moduli = moduli;
+    C->count = count;
+    C->prods = (fq_nmod_poly_struct *) flint_malloc(
+                                         count*sizeof(fq_nmod_poly_struct));
+    C->invs = (fq_nmod_poly_struct *) flint_malloc(
+                                         count*sizeof(fq_nmod_poly_struct));
+    for (k = 0; k < count; k++)
+    {
+        fq_nmod_poly_init(C->prods + k, fqctx);
+        fq_nmod_poly_init(C->invs + k, fqctx);
+        if (k == 0)
+        {
+            fq_nmod_poly_one(C->prods + k, fqctx);
+            fq_nmod_poly_one(C->invs + k, fqctx);
+            continue;
+        }
+
+        fq_nmod_poly_mul(C->prods + k, C->prods + k - 1, moduli[k - 1], fqctx);
+        fq_nmod_poly_rem(r, C->prods + k, moduli[k], fqctx);
+        FLINT_ASSERT(!fq_nmod_poly_is_zero(r, fqctx));
+        if (fq_nmod_poly_degree(r, fqctx) == 0)
+        {
+            fq_nmod_poly_fit_length(C->invs + k, 1, fqctx);
+            fq_nmod_inv(C->invs[k].coeffs + 0, r->coeffs + 0, fqctx);
+            _fq_nmod_poly_set_length(C->invs + k, 1, fqctx);
+        }
+        else
+        {
+            fq_nmod_poly_xgcd(g, C->invs + k, t, r, moduli[k], fqctx);
+            FLINT_ASSERT(fq_nmod_poly_is_one(g, fqctx));
+        }
+    }
+
+    fq_nmod_poly_clear(g, fqctx);
+    fq_nmod_poly_clear(t, fqctx);
+    fq_nmod_poly_clear(r, fqctx);
+}
+
+static void _crt_clear(_crt_t C, const fq_nmod_ctx_t fqctx)
+{
+    slong k;
+    for (k = 0; k < C->count; k++)
+    {
+        fq_nmod_poly_clear(C->prods + k, fqctx);
+        fq_nmod_poly_clear(C->invs + k, fqctx);
+    }
+    flint_free(C->prods);
+    flint_free(C->invs);
+}
+
+/*
+    A = crt(B[0], ..., B[count - 1]) using Garner's mixed radix form
+        A = B[0] + prods[1]*c[1] + ... + prods[count-1]*c[count-1]
+    The B[k] are assumed reduced mod moduli[k].
+*/
+static void _crt_run(
+    fq_nmod_poly_t A,
+    const _crt_t C,
+    fq_nmod_poly_struct * const * B,
+    fq_nmod_poly_t t1,              /* temp space */
+    fq_nmod_poly_t t2,              /* temp space */
+    const fq_nmod_ctx_t fqctx)
+{
+    slong k;
+
+    fq_nmod_poly_set(A, B[0], fqctx);
+    for (k = 1; k < C->count; k++)
+    {
+        fq_nmod_poly_sub(t1, B[k], A, fqctx);
+        fq_nmod_poly_rem(t2, t1, C->moduli[k], fqctx);
+        if (fq_nmod_poly_is_zero(t2, fqctx))
+            continue;
+        fq_nmod_poly_mul(t1, t2, C->invs + k, fqctx);
+        fq_nmod_poly_rem(t2, t1, C->moduli[k], fqctx);
+        fq_nmod_poly_mul(t1, t2, C->prods + k, fqctx);
+        fq_nmod_poly_add(A, A, t1, fqctx);
+    }
+}
+
+/*
+    A = crt(B[0], ...., B[count-1]) wrt to C
+    This functions takes some preallocated temp space.
+*/
+static slong _fq_nmod_mpolyn_crt(
+    const _crt_t C,
+    fq_nmod_mpolyn_t A,
+    fq_nmod_mpolyn_struct * const * B,
+    slong count,
+    fq_nmod_poly_struct ** input,   /* temp space */
+    slong * start,                  /* temp space */
+    fq_nmod_poly_t output,          /* temp space */
+    fq_nmod_poly_t t1,              /* temp space */
+    fq_nmod_poly_t t2,              /* temp space */
+    const fq_nmod_mpoly_ctx_t ctx)
+{
+    int cmp;
+    slong N = mpoly_words_per_exp_sp(A->bits, ctx->minfo);
+    slong lastdegree;
+    slong Ai;
+    slong j, k;
+    fq_nmod_poly_t zero;
+
+    fq_nmod_poly_init(zero, ctx->fqctx);
+
+    /* start[k] is the next available term in B[k] */
+    for (k = 0; k < count; k++)
+    {
+        start[k] = 0;
+    }
+
+    Ai = 0;
+    lastdegree = -WORD(1);
+    while (1)
+    {
+        fq_nmod_mpolyn_fit_length(A, Ai + 1, ctx);
+
+        k = 0;
+        do
+        {
+            input[k] = zero;
+            if (start[k] < B[k]->length)
+            {
+                goto found_max;
+            }
+        } while (++k < count);
+
+        break; /* all B[k] have been scanned completely */
+
+    found_max:
+
+        input[k] = B[k]->coeffs + start[k];
+        mpoly_monomial_set(A->exps + N*Ai, B[k]->exps + N*start[k], N);
+        start[k]++;
+
+        for (k++; k < count; k++)
+        {
+            input[k] = zero;
+            if (start[k] >= B[k]->length)
+            {
+                continue;
+            }
+
+            cmp = mpoly_monomial_cmp_nomask(B[k]->exps + N*start[k],
+                                                           A->exps + N*Ai, N);
+            if (cmp == 0)
+            {
+                input[k] = B[k]->coeffs + start[k];
+                start[k]++;
+            }
+            else if (cmp > 0)
+            {
+                /* undo previous max's */
+                for (j = 0; j < k; j++)
+                {
+                    start[j] -= (input[j] != zero);
+                    input[j] = zero;
+                }
+                goto found_max;
+            }
+        }
+
+        _crt_run(output, C, input, t1, t2, ctx->fqctx);
+        fq_nmod_poly_swap(A->coeffs + Ai, output, ctx->fqctx);
+        lastdegree = FLINT_MAX(lastdegree,
+                             fq_nmod_poly_degree(A->coeffs + Ai, ctx->fqctx));
+        Ai += !fq_nmod_poly_is_zero(A->coeffs + Ai, ctx->fqctx);
+    }
+    A->length = Ai;
+
+    fq_nmod_poly_clear(zero, ctx->fqctx);
+    return lastdegree;
+}
+
+/*
+    Append to A the result of crt'ing the coeff of X^exp wrt C of the B's
+    This functions takes some preallocated temp space.
+    A and the B's are in Fq[X][x_0, ..., x_(var-1)][x_var]
+*/
+static slong _fq_nmod_mpolyun_crt_exp(
+    const _crt_t C,
+    fq_nmod_mpolyun_t A,
+    ulong exp,
+    fq_nmod_mpolyun_struct * const * B,
+    slong count,
+    fq_nmod_mpolyn_struct ** Bcoeffs,   /* temp space */
+    fq_nmod_poly_struct ** input,       /* temp space */
+    slong * start,                      /* temp space */
+    fq_nmod_poly_t output,              /* temp space */
+    fq_nmod_poly_t t1,                  /* temp space */
+    fq_nmod_poly_t t2,                  /* temp space */
+    const fq_nmod_mpoly_ctx_t ctx)
+{
+    slong j, k;
+    slong Ai;
+    slong lastdegree;
+    fq_nmod_mpolyn_t zero;
+
+    fq_nmod_mpolyn_init(zero, A->bits, ctx);
+
+    for (k = 0; k < count; k++)
+    {
+        Bcoeffs[k] = zero;
+        for (j = 0; j < B[k]->length; j++)
+        {
+            if (B[k]->exps[j] == exp)
+            {
+                Bcoeffs[k] = B[k]->coeffs + j;
+                break;
+            }
+        }
+    }
+
+    Ai = A->length;
+    fq_nmod_mpolyun_fit_length(A, Ai + 1, ctx);
+    A->exps[Ai] = exp;
+    lastdegree = _fq_nmod_mpolyn_crt(C, A->coeffs + Ai, Bcoeffs, count,
+                                          input, start, output, t1, t2, ctx);
+    A->length += (A->coeffs + Ai)->length != 0;
+
+    fq_nmod_mpolyn_clear(zero, ctx);
+    return lastdegree;
+}
+
+
+typedef struct
+{
+    volatile int gcd_is_one;
+    fq_nmod_poly_struct * gamma;
+    const fq_nmod_mpoly_ctx_struct * ctx;
+    fq_nmod_mpolyun_struct * A, * B;
+    ulong num_threads;
+    slong var;
+}
+_splitbase_struct;
+
+typedef _splitbase_struct _splitbase_t[1];
+
+typedef struct
+{
+    slong idx;
+    _splitbase_struct * base;
+    fq_nmod_mpolyun_t G, Abar, Bbar;
+    fq_nmod_poly_t modulus;
+    fq_nmod_t alpha;
+    ulong step;
+    int exhausted;
+    slong required_images;
+}
+_splitworker_arg_struct;
+
+/*
+    Advance the evaluation point of arg. Thread idx uses the points numbered
+    idx + 1 + k*num_threads in the enumeration of fq_nmod_next, so that the
+    threads never share points and zero is never used.
+*/
+static int _next_point(_splitworker_arg_struct * arg,
+                                                const fq_nmod_ctx_t fqctx)
+{
+    ulong i;
+
+    if (arg->exhausted)
+        return 0;
+
+    for (i = 0; i < arg->step; i++)
+    {
+        if (fq_nmod_next(arg->alpha, fqctx) == 0)
+        {
+            arg->exhausted = 1;
+            return 0;
+        }
+    }
+
+    arg->step = arg->base->num_threads;
+    return 1;
+}
+
+static void _splitworker_bivar(void * varg)
+{
+    _splitworker_arg_struct * arg = (_splitworker_arg_struct *) varg;
+    _splitbase_struct * base = arg->base;
+    const fq_nmod_mpoly_ctx_struct * ctx = base->ctx;
+    flint_bitcnt_t bits = base->A->bits;
+    fq_nmod_poly_t Aeval, Beval, Geval, Abareval, Bbareval, trem, tempmod;
+    fq_nmod_mpolyun_t T;
+    fq_nmod_t gammaeval, temp;
+    slong ldeg;
+
+    fq_nmod_poly_init(Aeval, ctx->fqctx);
+    fq_nmod_poly_init(Beval, ctx->fqctx);
+    fq_nmod_poly_init(Geval, ctx->fqctx);
+    fq_nmod_poly_init(Abareval, ctx->fqctx);
+    fq_nmod_poly_init(Bbareval, ctx->fqctx);
+    fq_nmod_poly_init(trem, ctx->fqctx);
+    fq_nmod_poly_init(tempmod, ctx->fqctx);
+    fq_nmod_poly_gen(tempmod, ctx->fqctx);
+    fq_nmod_poly_neg(tempmod, tempmod, ctx->fqctx);
+    fq_nmod_mpolyun_init(T, bits, ctx);
+    fq_nmod_init(gammaeval, ctx->fqctx);
+    fq_nmod_init(temp, ctx->fqctx);
+
+    fq_nmod_poly_one(arg->modulus, ctx->fqctx);
+    while (fq_nmod_poly_degree(arg->modulus, ctx->fqctx) < arg->required_images)
+    {
+        /* get evaluation point */
+        if (!_next_point(arg, ctx->fqctx))
+        {
+            break;
+        }
+
+        /* make sure evaluation point does not kill both lc(A) and lc(B) */
+        fq_nmod_poly_evaluate_fq_nmod(gammaeval, base->gamma, arg->alpha,
+                                                                  ctx->fqctx);
+        if (fq_nmod_is_zero(gammaeval, ctx->fqctx))
+        {
+            continue;
+        }
+
+        /* evaluation point should kill neither A nor B */
+        fq_nmod_mpolyun_intp_reduce_sm_poly(Aeval, base->A, arg->alpha, ctx);
+        fq_nmod_mpolyun_intp_reduce_sm_poly(Beval, base->B, arg->alpha, ctx);
+        FLINT_ASSERT(Aeval->length > 0);
+        FLINT_ASSERT(Beval->length > 0);
+
+        fq_nmod_poly_gcd(Geval, Aeval, Beval, ctx->fqctx);
+        fq_nmod_poly_divrem(Abareval, trem, Aeval, Geval, ctx->fqctx);
+        FLINT_ASSERT(fq_nmod_poly_is_zero(trem, ctx->fqctx));
+        fq_nmod_poly_divrem(Bbareval, trem, Beval, Geval, ctx->fqctx);
+        FLINT_ASSERT(fq_nmod_poly_is_zero(trem, ctx->fqctx));
+
+        /* check up */
+        if (base->gcd_is_one)
+        {
+            break;
+        }
+
+        if (fq_nmod_poly_degree(Geval, ctx->fqctx) == 0)
+        {
+            base->gcd_is_one = 1;
+            break;
+        }
+
+        if (fq_nmod_poly_degree(arg->modulus, ctx->fqctx) > 0)
+        {
+            FLINT_ASSERT(arg->G->length > 0);
+            if (fq_nmod_poly_degree(Geval, ctx->fqctx) > arg->G->exps[0])
+            {
+                continue;
+            }
+            else if (fq_nmod_poly_degree(Geval, ctx->fqctx) < arg->G->exps[0])
+            {
+                fq_nmod_poly_one(arg->modulus, ctx->fqctx);
+            }
+        }
+
+        /* update interpolants */
+        fq_nmod_poly_scalar_mul_fq_nmod(Geval, Geval, gammaeval, ctx->fqctx);
+        if (fq_nmod_poly_degree(arg->modulus, ctx->fqctx) > 0)
+        {
+            fq_nmod_poly_evaluate_fq_nmod(temp, arg->modulus, arg->alpha,
+                                                                  ctx->fqctx);
+            fq_nmod_inv(temp, temp, ctx->fqctx);
+            fq_nmod_poly_scalar_mul_fq_nmod(arg->modulus, arg->modulus, temp,
+                                                                  ctx->fqctx);
+            fq_nmod_mpolyun_intp_crt_sm_poly(&ldeg, arg->G, T, Geval,
+                                               arg->modulus, arg->alpha, ctx);
+            fq_nmod_mpolyun_intp_crt_sm_poly(&ldeg, arg->Abar, T, Abareval,
+                                               arg->modulus, arg->alpha, ctx);
+            fq_nmod_mpolyun_intp_crt_sm_poly(&ldeg, arg->Bbar, T, Bbareval,
+                                               arg->modulus, arg->alpha, ctx);
+        }
+        else
+        {
+            fq_nmod_mpolyun_intp_lift_sm_poly(arg->G, Geval, ctx);
+            fq_nmod_mpolyun_intp_lift_sm_poly(arg->Abar, Abareval, ctx);
+            fq_nmod_mpolyun_intp_lift_sm_poly(arg->Bbar, Bbareval, ctx);
+        }
+        fq_nmod_poly_set_coeff(tempmod, 0, arg->alpha, ctx->fqctx);
+        fq_nmod_poly_mul(arg->modulus, arg->modulus, tempmod, ctx->fqctx);
+    }
+
+    fq_nmod_poly_clear(Aeval, ctx->fqctx);
+    fq_nmod_poly_clear(Beval, ctx->fqctx);
+    fq_nmod_poly_clear(Geval, ctx->fqctx);
+    fq_nmod_poly_clear(Abareval, ctx->fqctx);
+    fq_nmod_poly_clear(Bbareval, ctx->fqctx);
+    fq_nmod_poly_clear(trem, ctx->fqctx);
+    fq_nmod_poly_clear(tempmod, ctx->fqctx);
+    fq_nmod_mpolyun_clear(T, ctx);
+    fq_nmod_clear(gammaeval, ctx->fqctx);
+    fq_nmod_clear(temp, ctx->fqctx);
+}
+
+
+static void _splitworker(void * varg)
+{
+    _splitworker_arg_struct * arg = (_splitworker_arg_struct *) varg;
+    _splitbase_struct * base = arg->base;
+    const fq_nmod_mpoly_ctx_struct * ctx = base->ctx;
+    flint_bitcnt_t bits = base->A->bits;
+    slong var = base->var;
+    slong N = mpoly_words_per_exp_sp(bits, ctx->minfo);
+    slong offset, shift;
+    fq_nmod_mpolyun_t Aeval, Beval, Geval, Abareval, Bbareval;
+    fq_nmod_mpolyun_t T;
+    fq_nmod_poly_t tempmod;
+    fq_nmod_t gammaeval, temp;
+    slong ldeg;
+    int success;
+
+    FLINT_ASSERT(var > 0);
+
+    mpoly_gen_offset_shift_sp(&offset, &shift, var - 1, bits, ctx->minfo);
+
+    fq_nmod_mpolyun_init(Aeval, bits, ctx);
+    fq_nmod_mpolyun_init(Beval, bits, ctx);
+    fq_nmod_mpolyun_init(Geval, bits, ctx);
+    fq_nmod_mpolyun_init(Abareval, bits, ctx);
+    fq_nmod_mpolyun_init(Bbareval, bits, ctx);
+    fq_nmod_mpolyun_init(T, bits, ctx);
+    fq_nmod_poly_init(tempmod, ctx->fqctx);
+    fq_nmod_poly_gen(tempmod, ctx->fqctx);
+    fq_nmod_poly_neg(tempmod, tempmod, ctx->fqctx);
+    fq_nmod_init(gammaeval, ctx->fqctx);
+    fq_nmod_init(temp, ctx->fqctx);
+
+    fq_nmod_poly_one(arg->modulus, ctx->fqctx);
+    while (fq_nmod_poly_degree(arg->modulus, ctx->fqctx) < arg->required_images)
+    {
+        /* get evaluation point */
+        if (!_next_point(arg, ctx->fqctx))
+        {
+            break;
+        }
+
+        /* make sure evaluation point does not kill both lc(A) and lc(B) */
+        fq_nmod_poly_evaluate_fq_nmod(gammaeval, base->gamma, arg->alpha,
+                                                                  ctx->fqctx);
+        if (fq_nmod_is_zero(gammaeval, ctx->fqctx))
+        {
+            continue;
+        }
+
+        /* evaluation point should kill neither A nor B */
+        fq_nmod_mpolyun_intp_reduce_sm_mpolyun(Aeval, base->A, var,
+                                                             arg->alpha, ctx);
+        fq_nmod_mpolyun_intp_reduce_sm_mpolyun(Beval, base->B, var,
+                                                             arg->alpha, ctx);
+        FLINT_ASSERT(Aeval->length > 0);
+        FLINT_ASSERT(Beval->length > 0);
+
+        success = fq_nmod_mpolyun_gcd_brown_smprime(Geval, Abareval, Bbareval,
+                                                   Aeval, Beval, var - 1, ctx);
+        if (success == 0)
+        {
+            continue;
+        }
+
+        FLINT_ASSERT(Geval->length > 0);
+        FLINT_ASSERT(Abareval->length > 0);
+        FLINT_ASSERT(Bbareval->length > 0);
+
+        /* check up */
+        if (base->gcd_is_one)
+        {
+            break;
+        }
+
+        if (fq_nmod_mpolyun_is_nonzero_fq_nmod(Geval, ctx))
+        {
+            base->gcd_is_one = 1;
+            break;
+        }
+
+        if (fq_nmod_poly_degree(arg->modulus, ctx->fqctx) > 0)
+        {
+            int cmp = 0;
+            FLINT_ASSERT(arg->G->length > 0);
+            if (arg->G->exps[0] != Geval->exps[0])
+            {
+                cmp = arg->G->exps[0] > Geval->exps[0] ? 1 : -1;
+            }
+            if (cmp == 0)
+            {
+                slong k = fq_nmod_poly_degree((Geval->coeffs + 0)->coeffs + 0,
+                                                                  ctx->fqctx);
+                cmp = mpoly_monomial_cmp_nomask_extra(
+                       (arg->G->coeffs + 0)->exps + N*0,
+                       (Geval->coeffs + 0)->exps + N*0, N, offset, k << shift);
+            }
+
+            if (cmp < 0)
+            {
+                continue;
+            }
+            else if (cmp > 0)
+            {
+                fq_nmod_poly_one(arg->modulus, ctx->fqctx);
+            }
+        }
+
+        /* update interpolants */
+        fq_nmod_inv(temp, fq_nmod_mpolyn_leadcoeff(Geval->coeffs + 0, ctx),
+                                                                  ctx->fqctx);
+        fq_nmod_mul(temp, temp, gammaeval, ctx->fqctx);
+        fq_nmod_mpolyun_scalar_mul_fq_nmod(Geval, temp, ctx);
+        if (fq_nmod_poly_degree(arg->modulus, ctx->fqctx) > 0)
+        {
+            fq_nmod_poly_evaluate_fq_nmod(temp, arg->modulus, arg->alpha,
+                                                                  ctx->fqctx);
+            fq_nmod_inv(temp, temp, ctx->fqctx);
+            fq_nmod_poly_scalar_mul_fq_nmod(arg->modulus, arg->modulus, temp,
+                                                                  ctx->fqctx);
+            fq_nmod_mpolyun_intp_crt_sm_mpolyun(&ldeg, arg->G, T, Geval, var,
+                                               arg->modulus, arg->alpha, ctx);
+            fq_nmod_mpolyun_intp_crt_sm_mpolyun(&ldeg, arg->Abar, T, Abareval,
+                                          var, arg->modulus, arg->alpha, ctx);
+            fq_nmod_mpolyun_intp_crt_sm_mpolyun(&ldeg, arg->Bbar, T, Bbareval,
+                                          var, arg->modulus, arg->alpha, ctx);
+        }
+        else
+        {
+            fq_nmod_mpolyun_intp_lift_sm_mpolyun(arg->G, Geval, var, ctx);
+            fq_nmod_mpolyun_intp_lift_sm_mpolyun(arg->Abar, Abareval, var, ctx);
+            fq_nmod_mpolyun_intp_lift_sm_mpolyun(arg->Bbar, Bbareval, var, ctx);
+        }
+        fq_nmod_poly_set_coeff(tempmod, 0, arg->alpha, ctx->fqctx);
+        fq_nmod_poly_mul(arg->modulus, arg->modulus, tempmod, ctx->fqctx);
+    }
+
+    fq_nmod_mpolyun_clear(Aeval, ctx);
+    fq_nmod_mpolyun_clear(Beval, ctx);
+    fq_nmod_mpolyun_clear(Geval, ctx);
+    fq_nmod_mpolyun_clear(Abareval, ctx);
+    fq_nmod_mpolyun_clear(Bbareval, ctx);
+    fq_nmod_mpolyun_clear(T, ctx);
+    fq_nmod_poly_clear(tempmod, ctx->fqctx);
+    fq_nmod_clear(gammaeval, ctx->fqctx);
+    fq_nmod_clear(temp, ctx->fqctx);
+}
+
+
+typedef struct
+{
+    volatile slong G_exp, Abar_exp, Bbar_exp;
+    pthread_mutex_t mutex;
+    const fq_nmod_mpoly_ctx_struct * ctx;
+    _crt_t CRT;
+    fq_nmod_mpolyun_struct ** gptrs, ** abarptrs, ** bbarptrs;
+    ulong num_threads;
+}
+_joinbase_struct;
+
+typedef _joinbase_struct _joinbase_t[1];
+
+typedef struct
+{
+    _joinbase_struct * base;
+    fq_nmod_mpolyun_t G, Abar, Bbar;
+    slong G_lastdeg, Abar_lastdeg, Bbar_lastdeg;
+}
+_joinworker_arg_struct;
+
+/* Join the images of G, Abar, and Bbar in each of the split threads */
+static void _joinworker(void * varg)
+{
+    _joinworker_arg_struct * arg = (_joinworker_arg_struct *) varg;
+    _joinbase_struct * base = arg->base;
+    const fq_nmod_mpoly_ctx_struct * ctx = base->ctx;
+    slong t, our_G_exp, our_Abar_exp, our_Bbar_exp;
+    slong count = base->num_threads;
+    fq_nmod_mpolyn_struct ** coeffs;
+    fq_nmod_poly_struct ** input;
+    slong * start;
+    fq_nmod_poly_t output, t1, t2;
+
+    /* should already be zero, but just make sure */
+    arg->G->length = 0;
+    arg->Abar->length = 0;
+    arg->Bbar->length = 0;
+
+    /* some temp space */
+    coeffs = (fq_nmod_mpolyn_struct **) flint_malloc(
+                                     count*sizeof(fq_nmod_mpolyn_struct *));
+    input = (fq_nmod_poly_struct **) flint_malloc(
+                                       count*sizeof(fq_nmod_poly_struct *));
+    start = (slong *) flint_malloc(count*sizeof(slong));
+    fq_nmod_poly_init(output, ctx->fqctx);
+    fq_nmod_poly_init(t1, ctx->fqctx);
+    fq_nmod_poly_init(t2, ctx->fqctx);
+
+    while (1)
+    {
+        /* get exponent of either G, Abar, or Bbar to start working on */
+        pthread_mutex_lock(&base->mutex);
+        our_G_exp = base->G_exp;
+        our_Abar_exp = base->Abar_exp;
+        our_Bbar_exp = base->Bbar_exp;
+        if (our_G_exp >= 0)
+        {
+            base->G_exp = our_G_exp - 1;
+        }
+        else if (our_Abar_exp >= 0)
+        {
+            base->Abar_exp = our_Abar_exp - 1;
+        }
+        else if (our_Bbar_exp >= 0)
+        {
+            base->Bbar_exp = our_Bbar_exp - 1;
+        }
+        pthread_mutex_unlock(&base->mutex);
+
+        if (our_G_exp >= 0)
+        {
+            t = _fq_nmod_mpolyun_crt_exp(base->CRT, arg->G, our_G_exp,
+                                base->gptrs, count, coeffs, input, start,
+                                                       output, t1, t2, ctx);
+            arg->G_lastdeg = FLINT_MAX(arg->G_lastdeg, t);
+        }
+        else if (our_Abar_exp >= 0)
+        {
+            t = _fq_nmod_mpolyun_crt_exp(base->CRT, arg->Abar, our_Abar_exp,
+                             base->abarptrs, count, coeffs, input, start,
+                                                       output, t1, t2, ctx);
+            arg->Abar_lastdeg = FLINT_MAX(arg->Abar_lastdeg, t);
+        }
+        else if (our_Bbar_exp >= 0)
+        {
+            t = _fq_nmod_mpolyun_crt_exp(base->CRT, arg->Bbar, our_Bbar_exp,
+                             base->bbarptrs, count, coeffs, input, start,
+                                                       output, t1, t2, ctx);
+            arg->Bbar_lastdeg = FLINT_MAX(arg->Bbar_lastdeg, t);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    fq_nmod_poly_clear(output, ctx->fqctx);
+    fq_nmod_poly_clear(t1, ctx->fqctx);
+    fq_nmod_poly_clear(t2, ctx->fqctx);
+    flint_free(coeffs);
+    flint_free(input);
+    flint_free(start);
+}
+
+/*
+    A = B[0] + ... + B[num_threads - 1]
+    A and the B[i] are in Fq[X][x_0, ..., x_(var-1)][var]
+    The B[i] have distinct exponents on X, so this is just a top level merge.
+    The inputs B[i] are clobbered.
+*/
+static void _final_join(
+    fq_nmod_mpolyun_t A,
+    fq_nmod_mpolyun_struct ** B,
+    slong num_threads,
+    const fq_nmod_mpoly_ctx_t ctx)
+{
+    slong i, Ai, total_length;
+    slong * starts;
+    TMP_INIT;
+
+    TMP_START;
+    starts = (slong *) TMP_ALLOC(num_threads*sizeof(slong));
+    total_length = 0;
+    for (i = 0; i < num_threads; i++)
+    {
+        starts[i] = 0;
+        total_length += B[i]->length;
+    }
+
+    fq_nmod_mpolyun_fit_length(A, total_length, ctx);
+    Ai = 0;
+    while (1)
+    {
+        slong max_pos = -WORD(1);
+        slong max_exp = -WORD(1);
+        for (i = 0; i < num_threads; i++)
+        {
+            if (starts[i] < B[i]->length
+                          && (slong)(B[i]->exps[starts[i]]) > max_exp)
+            {
+                max_pos = i;
+                max_exp = B[i]->exps[starts[i]];
+            }
+        }
+        if (max_pos < 0)
+        {
+            break;
+        }
+        A->exps[Ai] = max_exp;
+        fq_nmod_mpolyn_swap(A->coeffs + Ai,
+                                        B[max_pos]->coeffs + starts[max_pos]);
+        starts[max_pos]++;
+        Ai++;
+    }
+    A->length = Ai;
+    FLINT_ASSERT(Ai == total_length);
+    FLINT_ASSERT(fq_nmod_mpolyun_is_canonical(A, ctx));
+
+    TMP_END;
+}
+
+/*
+    Do same as fq_nmod_mpolyun_gcd_brown_smprime but use the threads in
+        handles[0], ..., handles[num_handles - 1]
+    num_handles is allowed to be zero.
+*/
+int fq_nmod_mpolyun_gcd_brown_smprime_threaded(
+    fq_nmod_mpolyun_t G,
+    fq_nmod_mpolyun_t Abar,
+    fq_nmod_mpolyun_t Bbar,
+    fq_nmod_mpolyun_t A,
+    fq_nmod_mpolyun_t B,
+    slong var,
+    const fq_nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong i;
+    flint_bitcnt_t bits = A->bits;
+    slong N = mpoly_words_per_exp_sp(bits, ctx->minfo);
+    ulong num_threads;
+    int success;
+    ulong bound;
+    slong deggamma, ldegGs, ldegAbars, ldegBbars, ldegA, ldegB;
+    fq_nmod_poly_t cA, cB, cG, cAbar, cBbar, gamma, trem;
+    fq_nmod_poly_t cGs;
+    slong Gexp0, Abarexp0, Bbarexp0;
+    const fq_nmod_poly_struct ** mptrs;
+    fq_nmod_mpolyun_struct ** gptrs, ** abarptrs, ** bbarptrs;
+    _splitworker_arg_struct * splitargs;
+    _splitbase_t splitbase;
+    _joinworker_arg_struct * joinargs;
+    _joinbase_t joinbase;
+
+    if (num_handles < 1)
+    {
+        return fq_nmod_mpolyun_gcd_brown_smprime(G, Abar, Bbar, A, B, var, ctx);
+    }
+
+    fq_nmod_poly_init(cA, ctx->fqctx);
+    fq_nmod_poly_init(cB, ctx->fqctx);
+    fq_nmod_mpolyun_content_poly(cA, A, ctx);
+    fq_nmod_mpolyun_content_poly(cB, B, ctx);
+    fq_nmod_mpolyun_divexact_poly(A, A, cA, ctx);
+    fq_nmod_mpolyun_divexact_poly(B, B, cB, ctx);
+
+    fq_nmod_poly_init(cG, ctx->fqctx);
+    fq_nmod_poly_gcd(cG, cA, cB, ctx->fqctx);
+
+    fq_nmod_poly_init(cAbar, ctx->fqctx);
+    fq_nmod_poly_init(cBbar, ctx->fqctx);
+    fq_nmod_poly_init(trem, ctx->fqctx);
+    fq_nmod_poly_divrem(cAbar, trem, cA, cG, ctx->fqctx);
+    FLINT_ASSERT(fq_nmod_poly_is_zero(trem, ctx->fqctx));
+    fq_nmod_poly_divrem(cBbar, trem, cB, cG, ctx->fqctx);
+    FLINT_ASSERT(fq_nmod_poly_is_zero(trem, ctx->fqctx));
+
+    fq_nmod_poly_init(gamma, ctx->fqctx);
+    fq_nmod_poly_gcd(gamma, fq_nmod_mpolyun_leadcoeff_poly(A, ctx),
+                            fq_nmod_mpolyun_leadcoeff_poly(B, ctx), ctx->fqctx);
+
+    ldegA = fq_nmod_mpolyun_lastdeg(A, ctx);
+    ldegB = fq_nmod_mpolyun_lastdeg(B, ctx);
+    deggamma = fq_nmod_poly_degree(gamma, ctx->fqctx);
+    bound = 1 + deggamma + FLINT_MAX(ldegA, ldegB);
+
+    num_threads = num_handles + 1;
+    gptrs = (fq_nmod_mpolyun_struct **) flint_malloc(
+                                 num_threads*sizeof(fq_nmod_mpolyun_struct *));
+    abarptrs = (fq_nmod_mpolyun_struct **) flint_malloc(
+                                 num_threads*sizeof(fq_nmod_mpolyun_struct *));
+    bbarptrs = (fq_nmod_mpolyun_struct **) flint_malloc(
+                                 num_threads*sizeof(fq_nmod_mpolyun_struct *));
+    mptrs = (const fq_nmod_poly_struct **) flint_malloc(
+                                    num_threads*sizeof(fq_nmod_poly_struct *));
+    splitargs = (_splitworker_arg_struct *) flint_malloc(
+                                  num_threads*sizeof(_splitworker_arg_struct));
+    splitbase->num_threads = num_threads;
+    splitbase->A = A;
+    splitbase->B = B;
+    splitbase->ctx = ctx;
+    splitbase->gamma = gamma;
+    splitbase->var = var;
+    for (i = 0; i < num_threads; i++)
+    {
+        fq_nmod_mpolyun_init(splitargs[i].G, bits, ctx);
+        fq_nmod_mpolyun_init(splitargs[i].Abar, bits, ctx);
+        fq_nmod_mpolyun_init(splitargs[i].Bbar, bits, ctx);
+        fq_nmod_poly_init(splitargs[i].modulus, ctx->fqctx);
+        fq_nmod_init(splitargs[i].alpha, ctx->fqctx);
+        fq_nmod_zero(splitargs[i].alpha, ctx->fqctx);
+        splitargs[i].idx = i;
+        splitargs[i].base = splitbase;
+        splitargs[i].step = i + 1;
+        splitargs[i].exhausted = 0;
+        /*
+            ri = max(1, bound / num_threads + (i < (bound % num_threads)))
+            is also possible, but there is no need to live on the edge.
+        */
+        splitargs[i].required_images = bound/num_threads + 1;
+    }
+
+compute_split:
+
+    splitbase->gcd_is_one = 0;
+
+    for (i = 0; i + 1 < num_threads; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                  var == 0 ? _splitworker_bivar : _splitworker, &splitargs[i]);
+    }
+    (var == 0 ? _splitworker_bivar : _splitworker)(&splitargs[num_threads - 1]);
+    for (i = 0; i + 1 < num_threads; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    if (splitbase->gcd_is_one)
+    {
+        fq_nmod_mpolyun_one(G, ctx);
+        fq_nmod_mpolyun_swap(Abar, A);
+        fq_nmod_mpolyun_swap(Bbar, B);
+        goto successful_put_content;
+    }
+
+    for (i = 0; i < num_threads; i++)
+    {
+        gptrs[i] = splitargs[i].G;
+        abarptrs[i] = splitargs[i].Abar;
+        bbarptrs[i] = splitargs[i].Bbar;
+        mptrs[i] = splitargs[i].modulus;
+        if (fq_nmod_poly_degree(splitargs[i].modulus, ctx->fqctx)
+                                                < splitargs[i].required_images)
+        {
+            /* not enough evaluation points - must fail */
+            success = 0;
+            goto cleanup_split;
+        }
+        FLINT_ASSERT(gptrs[i]->length > 0);
+        FLINT_ASSERT(abarptrs[i]->length > 0);
+        FLINT_ASSERT(bbarptrs[i]->length > 0);
+    }
+
+    /*
+        Check for consistency in the leading monomial. All args have at least
+        one image, so G, Abar, Bbar are defined and nonzero for each.
+    */
+    Gexp0 = gptrs[0]->exps[0];
+    Abarexp0 = A->exps[0] - Gexp0;
+    Bbarexp0 = B->exps[0] - Gexp0;
+    for (i = 0; i < num_threads; i++)
+    {
+        if (gptrs[i]->exps[0] != Gexp0
+                      || !mpoly_monomial_equal(
+                                  (gptrs[i]->coeffs + 0)->exps + N*0,
+                                  (gptrs[0]->coeffs + 0)->exps + N*0, N))
+        {
+            /* very unlucky - try again with new points */
+            goto compute_split;
+        }
+        FLINT_ASSERT(splitargs[i].Abar->exps[0] == Abarexp0);
+        FLINT_ASSERT(splitargs[i].Bbar->exps[0] == Bbarexp0);
+    }
+
+    _crt_init(joinbase->CRT, mptrs, num_threads, ctx->fqctx);
+
+    joinbase->num_threads = num_threads;
+    joinbase->gptrs = gptrs;
+    joinbase->abarptrs = abarptrs;
+    joinbase->bbarptrs = bbarptrs;
+    joinbase->G_exp = Gexp0;
+    joinbase->Abar_exp = Abarexp0;
+    joinbase->Bbar_exp = Bbarexp0;
+    joinbase->ctx = ctx;
+    pthread_mutex_init(&joinbase->mutex, NULL);
+
+    joinargs = (_joinworker_arg_struct *) flint_malloc(
+                                   num_threads*sizeof(_joinworker_arg_struct));
+
+    for (i = 0; i < num_threads; i++)
+    {
+        joinargs[i].base = joinbase;
+        joinargs[i].G_lastdeg = -WORD(1);
+        joinargs[i].Abar_lastdeg = -WORD(1);
+        joinargs[i].Bbar_lastdeg = -WORD(1);
+        fq_nmod_mpolyun_init(joinargs[i].G, bits, ctx);
+        fq_nmod_mpolyun_init(joinargs[i].Abar, bits, ctx);
+        fq_nmod_mpolyun_init(joinargs[i].Bbar, bits, ctx);
+    }
+    for (i = 0; i + 1 < num_threads; i++)
+    {
+        thread_pool_wake(global_thread_pool,
+                                        handles[i], _joinworker, joinargs + i);
+    }
+    _joinworker(joinargs + num_threads - 1);
+    for (i = 0; i + 1 < num_threads; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+    pthread_mutex_destroy(&joinbase->mutex);
+
+    ldegGs = ldegAbars = ldegBbars = -WORD(1);
+    for (i = 0; i < num_threads; i++)
+    {
+        ldegGs = FLINT_MAX(ldegGs, joinargs[i].G_lastdeg);
+        ldegAbars = FLINT_MAX(ldegAbars, joinargs[i].Abar_lastdeg);
+        ldegBbars = FLINT_MAX(ldegBbars, joinargs[i].Bbar_lastdeg);
+    }
+
+    /* reuse gptrs, abarpts, bbarpts for final trivial join */
+    for (i = 0; i < num_threads; i++)
+    {
+        gptrs[i] = joinargs[i].G;
+        abarptrs[i] = joinargs[i].Abar;
+        bbarptrs[i] = joinargs[i].Bbar;
+    }
+    _final_join(G, gptrs, num_threads, ctx);
+    _final_join(Abar, abarptrs, num_threads, ctx);
+    _final_join(Bbar, bbarptrs, num_threads, ctx);
+
+    /* free join data */
+    _crt_clear(joinbase->CRT, ctx->fqctx);
+    for (i = 0; i < num_threads; i++)
+    {
+        fq_nmod_mpolyun_clear(joinargs[i].G, ctx);
+        fq_nmod_mpolyun_clear(joinargs[i].Abar, ctx);
+        fq_nmod_mpolyun_clear(joinargs[i].Bbar, ctx);
+    }
+    flint_free(joinargs);
+
+    if (   deggamma + ldegA == ldegGs + ldegAbars
+        && deggamma + ldegB == ldegGs + ldegBbars)
+    {
+        goto successful;
+    }
+
+    /* divisibility test failed - try again with new points */
+    goto compute_split;
+
+successful:
+
+    fq_nmod_poly_init(cGs, ctx->fqctx);
+    fq_nmod_mpolyun_content_poly(cGs, G, ctx);
+    fq_nmod_mpolyun_divexact_poly(G, G, cGs, ctx);
+    fq_nmod_mpolyun_divexact_poly(Abar, Abar,
+                                   fq_nmod_mpolyun_leadcoeff_poly(G, ctx), ctx);
+    fq_nmod_mpolyun_divexact_poly(Bbar, Bbar,
+                                   fq_nmod_mpolyun_leadcoeff_poly(G, ctx), ctx);
+    fq_nmod_poly_clear(cGs, ctx->fqctx);
+
+successful_put_content:
+
+    fq_nmod_mpolyun_mul_poly(G, G, cG, ctx);
+    fq_nmod_mpolyun_mul_poly(Abar, Abar, cAbar, ctx);
+    fq_nmod_mpolyun_mul_poly(Bbar, Bbar, cBbar, ctx);
+
+    success = 1;
+
+cleanup_split:
+
+    for (i = 0; i < num_threads; i++)
+    {
+        fq_nmod_mpolyun_clear(splitargs[i].G, ctx);
+        fq_nmod_mpolyun_clear(splitargs[i].Abar, ctx);
+        fq_nmod_mpolyun_clear(splitargs[i].Bbar, ctx);
+        fq_nmod_poly_clear(splitargs[i].modulus, ctx->fqctx);
+        fq_nmod_clear(splitargs[i].alpha, ctx->fqctx);
+    }
+
+    flint_free(gptrs);
+    flint_free(abarptrs);
+    flint_free(bbarptrs);
+    flint_free(mptrs);
+    flint_free(splitargs);
+
+    fq_nmod_poly_clear(cA, ctx->fqctx);
+    fq_nmod_poly_clear(cB, ctx->fqctx);
+    fq_nmod_poly_clear(cG, ctx->fqctx);
+    fq_nmod_poly_clear(cAbar, ctx->fqctx);
+    fq_nmod_poly_clear(cBbar, ctx->fqctx);
+    fq_nmod_poly_clear(gamma, ctx->fqctx);
+    fq_nmod_poly_clear(trem, ctx->fqctx);
+
+    return success;
+}
+
+
+typedef struct
+{
+    fq_nmod_mpolyun_struct * Pn;
+    const fq_nmod_mpoly_ctx_struct * uctx;
+    const fq_nmod_mpoly_struct * P;
+    const fq_nmod_mpoly_ctx_struct * ctx;
+    const slong * perm;
+    const ulong * shift;
+    const ulong * stride;
+}
+_convertn_arg_struct;
+
+typedef _convertn_arg_struct _convertn_arg_t[1];
+
+static void _worker_convertn(void * varg)
+{
+    _convertn_arg_struct * arg = (_convertn_arg_struct *) varg;
+
+    _fq_nmod_mpoly_to_mpolyun_perm_deflate(arg->Pn, arg->uctx, arg->P,
+                                 arg->ctx, arg->perm, arg->shift, arg->stride);
+}
+
+/*
+    Convert A and B to An and Bn. If there is a thread available, B is
+    converted there while the calling thread converts A.
+*/
+void _fq_nmod_mpoly_to_mpolyun_perm_deflate_threaded(
+    fq_nmod_mpolyun_t An,
+    fq_nmod_mpolyun_t Bn,
+    const fq_nmod_mpoly_ctx_t uctx,
+    const fq_nmod_mpoly_t A,
+    const ulong * Ashift,
+    const fq_nmod_mpoly_t B,
+    const ulong * Bshift,
+    const fq_nmod_mpoly_ctx_t ctx,
+    const slong * perm,
+    const ulong * stride,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    if (num_handles > 0)
+    {
+        _convertn_arg_t arg;
+
+        arg->Pn = Bn;
+        arg->uctx = uctx;
+        arg->P = B;
+        arg->ctx = ctx;
+        arg->perm = perm;
+        arg->shift = Bshift;
+        arg->stride = stride;
+
+        thread_pool_wake(global_thread_pool, handles[0], _worker_convertn, arg);
+        _fq_nmod_mpoly_to_mpolyun_perm_deflate(An, uctx, A, ctx,
+                                                        perm, Ashift, stride);
+        thread_pool_wait(global_thread_pool, handles[0]);
+    }
+    else
+    {
+        _fq_nmod_mpoly_to_mpolyun_perm_deflate(An, uctx, A, ctx,
+                                                        perm, Ashift, stride);
+        _fq_nmod_mpoly_to_mpolyun_perm_deflate(Bn, uctx, B, ctx,
+                                                        perm, Bshift, stride);
+    }
+}
+
+
+int fq_nmod_mpoly_gcd_brown_threaded(
+    fq_nmod_mpoly_t G,
+    const fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_ctx_t ctx,
+    slong thread_limit)
+{
+    int success;
+    slong * perm;
+    ulong * shift, * stride;
+    slong i;
+    flint_bitcnt_t new_bits;
+    fq_nmod_mpoly_ctx_t uctx;
+    fq_nmod_mpolyun_t An, Bn, Gn, Abarn, Bbarn;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    if (fq_nmod_mpoly_is_zero(A, ctx))
+    {
+        if (fq_nmod_mpoly_is_zero(B, ctx))
+        {
+            fq_nmod_mpoly_zero(G, ctx);
+        }
+        else
+        {
+            fq_nmod_mpoly_make_monic(G, B, ctx);
+        }
+        return 1;
+    }
+
+    if (fq_nmod_mpoly_is_zero(B, ctx))
+    {
+        fq_nmod_mpoly_make_monic(G, A, ctx);
+        return 1;
+    }
+
+    if (A->bits > FLINT_BITS || B->bits > FLINT_BITS)
+    {
+        return 0;
+    }
+
+    if (ctx->minfo->nvars == 1)
+    {
+        return fq_nmod_mpoly_gcd_brown(G, A, B, ctx);
+    }
+
+    perm = (slong *) flint_malloc(ctx->minfo->nvars*sizeof(slong));
+    shift = (ulong *) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+    stride = (ulong *) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+    for (i = 0; i < ctx->minfo->nvars; i++)
+    {
+        perm[i] = i;
+        shift[i] = 0;
+        stride[i] = 1;
+    }
+
+    new_bits = FLINT_MAX(A->bits, B->bits);
+
+    fq_nmod_mpoly_ctx_init(uctx, ctx->minfo->nvars - 1, ORD_LEX, ctx->fqctx);
+    fq_nmod_mpolyun_init(An, new_bits, uctx);
+    fq_nmod_mpolyun_init(Bn, new_bits, uctx);
+    fq_nmod_mpolyun_init(Gn, new_bits, uctx);
+    fq_nmod_mpolyun_init(Abarn, new_bits, uctx);
+    fq_nmod_mpolyun_init(Bbarn, new_bits, uctx);
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                               max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                 handles, max_num_handles);
+        }
+    }
+
+    _fq_nmod_mpoly_to_mpolyun_perm_deflate_threaded(An, Bn, uctx,
+                   A, shift, B, shift, ctx, perm, stride, handles, num_handles);
+
+    success = fq_nmod_mpolyun_gcd_brown_smprime_threaded(Gn, Abarn, Bbarn,
+                  An, Bn, uctx->minfo->nvars - 1, uctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+
+    if (handles)
+        flint_free(handles);
+
+    if (!success)
+    {
+        _fq_nmod_mpoly_to_mpolyun_perm_deflate(An, uctx, A, ctx,
+                                                         perm, shift, stride);
+        _fq_nmod_mpoly_to_mpolyun_perm_deflate(Bn, uctx, B, ctx,
+                                                         perm, shift, stride);
+        success = fq_nmod_mpolyun_gcd_brown_lgprime(Gn, Abarn, Bbarn,
+                                         An, Bn, uctx->minfo->nvars - 1, uctx);
+    }
+
+    if (success)
+    {
+        _fq_nmod_mpoly_from_mpolyun_perm_inflate(G, new_bits, ctx,
+                                                Gn, uctx, perm, shift, stride);
+        fq_nmod_mpoly_make_monic(G, G, ctx);
+    }
+
+    fq_nmod_mpolyun_clear(An, uctx);
+    fq_nmod_mpolyun_clear(Bn, uctx);
+    fq_nmod_mpolyun_clear(Gn, uctx);
+    fq_nmod_mpolyun_clear(Abarn, uctx);
+    fq_nmod_mpolyun_clear(Bbarn, uctx);
+    fq_nmod_mpoly_ctx_clear(uctx);
+
+    flint_free(perm);
+    flint_free(shift);
+    flint_free(stride);
+
+    return success;
+}
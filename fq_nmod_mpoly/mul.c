@@ -11,9 +11,104 @@
 
 #include "fq_nmod_mpoly.h"
 
-void fq_nmod_mpoly_mul(fq_nmod_mpoly_t A, const fq_nmod_mpoly_t B,
-                        const fq_nmod_mpoly_t C, const fq_nmod_mpoly_ctx_t ctx)
+void fq_nmod_mpoly_mul_threaded(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_t C,
+    const fq_nmod_mpoly_ctx_t ctx,
+    slong thread_limit)
 {
-    /* nothing fancy for now */
-    fq_nmod_mpoly_mul_johnson(A, B, C, ctx);
+    slong i;
+    fmpz * maxBfields, * maxCfields;
+    thread_pool_handle * handles;
+    slong num_handles;
+    TMP_INIT;
+
+    if (B->length == 0 || C->length == 0)
+    {
+        fq_nmod_mpoly_zero(A, ctx);
+        return;
+    }
+
+    TMP_START;
+
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxCfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxBfields + i);
+        fmpz_init(maxCfields + i);
+    }
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
+
+    /*
+        If one polynomial is tiny or if both polynomials are small,
+        the serial heap method is fine.
+    */
+    if (   B->length < 20
+        || C->length < 20
+        || (B->length < 50 && C->length < 50)
+       )
+    {
+        _fq_nmod_mpoly_mul_johnson_maxfields(A, B, maxBfields,
+                                                       C, maxCfields, ctx);
+        goto cleanup;
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    if (num_handles > 0)
+    {
+        _fq_nmod_mpoly_mul_heap_threaded_maxfields(A,
+                      B, maxBfields, C, maxCfields, ctx, handles, num_handles);
+    }
+    else
+    {
+        _fq_nmod_mpoly_mul_johnson_maxfields(A, B, maxBfields,
+                                                       C, maxCfields, ctx);
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+cleanup:
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxBfields + i);
+        fmpz_clear(maxCfields + i);
+    }
+
+    TMP_END;
+}
+
+
+void fq_nmod_mpoly_mul(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_t C,
+    const fq_nmod_mpoly_ctx_t ctx)
+{
+    fq_nmod_mpoly_mul_threaded(A, B, C, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
 }
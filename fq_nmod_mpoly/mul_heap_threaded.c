@@ -0,0 +1,754 @@
+/*
+    Copyright (C) 2017-2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <gmp.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "fq_nmod_mpoly.h"
+
+
+/*
+    set A = the part of B*C with exps in [start, end)
+    this functions reallocates A and returns the length of A
+*/
+static slong _fq_nmod_mpoly_mul_heap_part(
+              fq_nmod_struct ** A_coeff, ulong ** A_exp, slong * A_alloc,
+              const fq_nmod_struct * Bcoeff, const ulong * Bexp, slong Blen,
+              const fq_nmod_struct * Ccoeff, const ulong * Cexp, slong Clen,
+      slong * start, slong * end, slong * hind, const fq_nmod_mpoly_stripe_t S)
+{
+    flint_bitcnt_t bits = S->bits;
+    slong N = S->N;
+    const ulong * cmpmask = S->cmpmask;
+    const fq_nmod_ctx_struct * fqctx = S->ctx->fqctx;
+    slong i, j;
+    slong next_loc;
+    slong heap_len;
+    ulong * exp, * exps;
+    ulong ** exp_list;
+    slong exp_next;
+    mpoly_heap_t * x;
+    mpoly_heap_s * heap;
+    mpoly_heap_t * chain;
+    slong * store, * store_base;
+    slong Alen;
+    ulong * Aexp = *A_exp;
+    slong Aalloc = *A_alloc;
+    fq_nmod_struct * Acoeff = *A_coeff;
+    fq_nmod_t pp;
+
+    fq_nmod_init(pp, fqctx);
+
+    /* tmp allocs from S->big_mem */
+    i = 0;
+    store = store_base = (slong *) (S->big_mem + i);
+    i += 2*Blen*sizeof(slong);
+    exp_list = (ulong **) (S->big_mem + i);
+    i += Blen*sizeof(ulong *);
+    exps = (ulong *) (S->big_mem + i);
+    i += Blen*N*sizeof(ulong);
+    heap = (mpoly_heap_s *) (S->big_mem + i);
+    i += (Blen + 1)*sizeof(mpoly_heap_s);
+    chain = (mpoly_heap_t *) (S->big_mem + i);
+    i += Blen*sizeof(mpoly_heap_t);
+    FLINT_ASSERT(i <= S->big_mem_alloc);
+
+    /* put all the starting nodes on the heap */
+    heap_len = 1; /* heap zero index unused */
+    next_loc = Blen + 4;   /* something bigger than heap can ever be */
+    exp_next = 0;
+    for (i = 0; i < Blen; i++)
+        exp_list[i] = exps + N*i;
+    for (i = 0; i < Blen; i++)
+        hind[i] = 2*start[i] + 1;
+    for (i = 0; i < Blen; i++)
+    {
+        if (  (start[i] < end[i])
+           && (  (i == 0)
+              || (start[i] < start[i - 1])
+              )
+           )
+        {
+            x = chain + i;
+            x->i = i;
+            x->j = start[i];
+            x->next = NULL;
+            hind[x->i] = 2*(x->j + 1) + 0;
+
+            if (bits <= FLINT_BITS)
+                mpoly_monomial_add(exp_list[exp_next], Bexp + N*x->i,
+                                                       Cexp + N*x->j, N);
+            else
+                mpoly_monomial_add_mp(exp_list[exp_next], Bexp + N*x->i,
+                                                          Cexp + N*x->j, N);
+
+            exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+        }
+    }
+
+    Alen = 0;
+    while (heap_len > 1)
+    {
+        exp = heap[1].exp;
+
+        _fq_nmod_mpoly_fit_length(&Acoeff, &Aexp, &Aalloc, Alen + 1, N, fqctx);
+
+        mpoly_monomial_set(Aexp + N*Alen, exp, N);
+
+        fq_nmod_zero(Acoeff + Alen, fqctx);
+        do
+        {
+            exp_list[--exp_next] = heap[1].exp;
+
+            x = _mpoly_heap_pop(heap, &heap_len, N, cmpmask);
+
+            hind[x->i] |= WORD(1);
+            *store++ = x->i;
+            *store++ = x->j;
+            fq_nmod_mul(pp, Bcoeff + x->i, Ccoeff + x->j, fqctx);
+            fq_nmod_add(Acoeff + Alen, Acoeff + Alen, pp, fqctx);
+
+            while ((x = x->next) != NULL)
+            {
+                hind[x->i] |= WORD(1);
+                *store++ = x->i;
+                *store++ = x->j;
+                fq_nmod_mul(pp, Bcoeff + x->i, Ccoeff + x->j, fqctx);
+                fq_nmod_add(Acoeff + Alen, Acoeff + Alen, pp, fqctx);
+            }
+        } while (heap_len > 1 && mpoly_monomial_equal(heap[1].exp, exp, N));
+
+        Alen += !fq_nmod_is_zero(Acoeff + Alen, fqctx);
+
+        /* for each node temporarily stored */
+        while (store > store_base)
+        {
+            j = *--store;
+            i = *--store;
+
+            /* should we go right? */
+            if (  (i + 1 < Blen)
+               && (j + 0 < end[i + 1])
+               && (hind[i + 1] == 2*j + 1)
+               )
+            {
+                x = chain + i + 1;
+                x->i = i + 1;
+                x->j = j;
+                x->next = NULL;
+
+                hind[x->i] = 2*(x->j + 1) + 0;
+
+                if (bits <= FLINT_BITS)
+                    mpoly_monomial_add(exp_list[exp_next], Bexp + N*x->i,
+                                                           Cexp + N*x->j, N);
+                else
+                    mpoly_monomial_add_mp(exp_list[exp_next], Bexp + N*x->i,
+                                                              Cexp + N*x->j, N);
+
+                exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+            }
+
+            /* should we go up? */
+            if (  (j + 1 < end[i + 0])
+               && ((hind[i] & 1) == 1)
+               && (  (i == 0)
+                  || (hind[i - 1] >= 2*(j + 2) + 1)
+                  )
+               )
+            {
+                x = chain + i;
+                x->i = i;
+                x->j = j + 1;
+                x->next = NULL;
+
+                hind[x->i] = 2*(x->j + 1) + 0;
+
+                if (bits <= FLINT_BITS)
+                    mpoly_monomial_add(exp_list[exp_next], Bexp + N*x->i,
+                                                           Cexp + N*x->j, N);
+                else
+                    mpoly_monomial_add_mp(exp_list[exp_next], Bexp + N*x->i,
+                                                              Cexp + N*x->j, N);
+
+                exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+            }
+        }
+    }
+
+    *A_coeff = Acoeff;
+    *A_exp = Aexp;
+    *A_alloc = Aalloc;
+
+    fq_nmod_clear(pp, fqctx);
+
+    return Alen;
+}
+
+
+/*
+    The workers calculate product terms from 4*n divisions, where n is the
+    number of threads.
+*/
+
+typedef struct
+{
+    volatile int idx;
+    pthread_mutex_t mutex;
+    slong nthreads;
+    slong ndivs;
+    const fq_nmod_mpoly_ctx_struct * ctx;
+    fq_nmod_struct * Acoeff;
+    ulong * Aexp;
+    const fq_nmod_struct * Bcoeff;
+    const ulong * Bexp;
+    slong Blen;
+    const fq_nmod_struct * Ccoeff;
+    const ulong * Cexp;
+    slong Clen;
+    slong N;
+    flint_bitcnt_t bits;
+    const ulong * cmpmask;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    slong lower;
+    slong upper;
+    slong thread_idx;
+    slong Aoffset;
+    slong Alen;
+    slong Aalloc;
+    ulong * Aexp;
+    fq_nmod_struct * Acoeff;
+}
+_div_struct;
+
+typedef struct
+{
+    fq_nmod_mpoly_stripe_t S;
+    slong idx;
+    slong time;
+    _base_struct * base;
+    _div_struct * divs;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    slong * t1, * t2, * t3, * t4;
+    ulong * exp;
+}
+_worker_arg_struct;
+
+
+/*
+    The workers simply take the next available division and calculate all
+    product terms in this division.
+*/
+
+#define SWAP_PTRS(xx, yy) \
+   do { \
+      tt = xx; \
+      xx = yy; \
+      yy = tt; \
+   } while (0)
+
+static void _fq_nmod_mpoly_mul_heap_threaded_worker(void * arg_ptr)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) arg_ptr;
+    fq_nmod_mpoly_stripe_struct * S = arg->S;
+    _div_struct * divs = arg->divs;
+    _base_struct * base = arg->base;
+    slong Blen = base->Blen;
+    slong N = base->N;
+    slong i, j;
+    ulong * exp;
+    slong score;
+    slong * start, * end, * t1, * t2, * t3, * t4, * tt;
+
+    exp = (ulong *) flint_malloc(N*sizeof(ulong));
+    t1 = (slong *) flint_malloc(Blen*sizeof(slong));
+    t2 = (slong *) flint_malloc(Blen*sizeof(slong));
+    t3 = (slong *) flint_malloc(Blen*sizeof(slong));
+    t4 = (slong *) flint_malloc(Blen*sizeof(slong));
+
+    S->N = N;
+    S->bits = base->bits;
+    S->cmpmask = base->cmpmask;
+    S->ctx = base->ctx;
+
+    S->big_mem_alloc = 0;
+    S->big_mem_alloc += 2*Blen*sizeof(slong);
+    S->big_mem_alloc += (Blen + 1)*sizeof(mpoly_heap_s);
+    S->big_mem_alloc += Blen*sizeof(mpoly_heap_t);
+    S->big_mem_alloc += Blen*S->N*sizeof(ulong);
+    S->big_mem_alloc += Blen*sizeof(ulong *);
+    S->big_mem = (char *) flint_malloc(S->big_mem_alloc);
+
+    /* get index to start working on */
+    if (arg->idx + 1 < base->nthreads)
+    {
+        pthread_mutex_lock(&base->mutex);
+        i = base->idx - 1;
+        base->idx = i;
+        pthread_mutex_unlock(&base->mutex);
+    }
+    else
+    {
+        i = base->ndivs - 1;
+    }
+
+    while (i >= 0)
+    {
+        FLINT_ASSERT(divs[i].thread_idx == -WORD(1));
+        divs[i].thread_idx = arg->idx;
+
+        /* calculate start */
+        if (i + 1 < base-> ndivs)
+        {
+            mpoly_search_monomials(
+                &start, exp, &score, t1, t2, t3,
+                            divs[i].lower, divs[i].lower,
+                            base->Bexp, base->Blen, base->Cexp, base->Clen,
+                                          base->N, base->cmpmask);
+            if (start == t2)
+            {
+                SWAP_PTRS(t1, t2);
+            }
+            else if (start == t3)
+            {
+                SWAP_PTRS(t1, t3);
+            }
+        }
+        else
+        {
+            start = t1;
+            for (j = 0; j < base->Blen; j++)
+                start[j] = 0;
+        }
+
+        /* calculate end */
+        if (i > 0)
+        {
+            mpoly_search_monomials(
+                &end, exp, &score, t2, t3, t4,
+                            divs[i - 1].lower, divs[i - 1].lower,
+                            base->Bexp, base->Blen, base->Cexp, base->Clen,
+                                          base->N, base->cmpmask);
+
+            if (end == t3)
+            {
+                SWAP_PTRS(t2, t3);
+            }
+            else if (end == t4)
+            {
+                SWAP_PTRS(t2, t4);
+            }
+        }
+        else
+        {
+            end = t2;
+            for (j = 0; j < base->Blen; j++)
+                end[j] = base->Clen;
+        }
+        /* t3 and t4 are free for workspace at this point */
+
+        /* calculate products in [start, end) */
+        _fq_nmod_mpoly_fit_length(&divs[i].Acoeff, &divs[i].Aexp,
+                                  &divs[i].Aalloc, 256, N, base->ctx->fqctx);
+        divs[i].Alen = _fq_nmod_mpoly_mul_heap_part(
+                         &divs[i].Acoeff, &divs[i].Aexp, &divs[i].Aalloc,
+                                      base->Bcoeff,  base->Bexp,  base->Blen,
+                                      base->Ccoeff,  base->Cexp,  base->Clen,
+                                                            start, end, t3, S);
+
+        /* get next index to work on */
+        pthread_mutex_lock(&base->mutex);
+        i = base->idx - 1;
+        base->idx = i;
+        pthread_mutex_unlock(&base->mutex);
+    }
+
+    /* clean up */
+    flint_free(S->big_mem);
+    flint_free(t4);
+    flint_free(t3);
+    flint_free(t2);
+    flint_free(t1);
+    flint_free(exp);
+}
+
+
+/*
+    The coefficients of a lower division are moved into the final answer
+    by a shallow copy, so that only the unused tail of the division needs
+    to be cleared.
+*/
+static void _join_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _div_struct * divs = arg->divs;
+    _base_struct * base = arg->base;
+    slong N = base->N;
+    slong i, j;
+
+    for (i = base->ndivs - 2; i >= 0; i--)
+    {
+        FLINT_ASSERT(divs[i].thread_idx != -WORD(1));
+
+        if (divs[i].thread_idx != arg->idx)
+            continue;
+
+        FLINT_ASSERT(divs[i].Acoeff != NULL);
+        FLINT_ASSERT(divs[i].Aexp != NULL);
+
+        memcpy(base->Acoeff + divs[i].Aoffset, divs[i].Acoeff,
+                                          divs[i].Alen*sizeof(fq_nmod_struct));
+
+        memcpy(base->Aexp + N*divs[i].Aoffset, divs[i].Aexp,
+                                                 N*divs[i].Alen*sizeof(ulong));
+
+        for (j = divs[i].Alen; j < divs[i].Aalloc; j++)
+            fq_nmod_clear(divs[i].Acoeff + j, base->ctx->fqctx);
+
+        flint_free(divs[i].Acoeff);
+        flint_free(divs[i].Aexp);
+    }
+}
+
+void _fq_nmod_mpoly_mul_heap_threaded(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_struct * Bcoeff, const ulong * Bexp, slong Blen,
+    const fq_nmod_struct * Ccoeff, const ulong * Cexp, slong Clen,
+    flint_bitcnt_t bits,
+    slong N,
+    const ulong * cmpmask,
+    const fq_nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong i;
+    slong BClen, hi;
+    _base_t base;
+    _div_struct * divs;
+    _worker_arg_struct * args;
+    slong Aalloc;
+    slong Alen;
+    fq_nmod_struct * Acoeff;
+    ulong * Aexp;
+
+    /* bail if product of lengths overflows a word */
+    umul_ppmm(hi, BClen, Blen, Clen);
+    if (hi != 0 || BClen < 0)
+    {
+        A->length = _fq_nmod_mpoly_mul_johnson(&A->coeffs, &A->exps, &A->alloc,
+                                               Bcoeff, Bexp, Blen,
+                                               Ccoeff, Cexp, Clen,
+                                               bits, N, cmpmask, ctx->fqctx);
+        return;
+    }
+
+    base->nthreads = num_handles + 1;
+    base->ndivs    = base->nthreads*4;  /* number of divisons */
+    base->Bcoeff = Bcoeff;
+    base->Bexp = Bexp;
+    base->Blen = Blen;
+    base->Ccoeff = Ccoeff;
+    base->Cexp = Cexp;
+    base->Clen = Clen;
+    base->bits = bits;
+    base->N = N;
+    base->cmpmask = cmpmask;
+    base->idx = base->ndivs - 1;    /* decremented by worker threads */
+    base->ctx = ctx;
+
+    divs = (_div_struct *) flint_malloc(base->ndivs*sizeof(_div_struct));
+    args = (_worker_arg_struct *) flint_malloc(base->nthreads
+                                                  *sizeof(_worker_arg_struct));
+
+    /* allocate space and set the boundary for each division */
+    FLINT_ASSERT(BClen/Blen == Clen);
+    for (i = base->ndivs - 1; i >= 0; i--)
+    {
+        double d = (double)(i + 1) / (double)(base->ndivs);
+
+        /* divisions decrease in size so that no worker finishes too early */
+        divs[i].lower = (d * d) * BClen;
+        divs[i].lower = FLINT_MIN(divs[i].lower, BClen);
+        divs[i].lower = FLINT_MAX(divs[i].lower, WORD(0));
+        divs[i].upper = divs[i].lower;
+        divs[i].Aoffset = -WORD(1);
+        divs[i].thread_idx = -WORD(1);
+
+        divs[i].Alen = 0;
+        if (i == base->ndivs - 1)
+        {
+            /* highest division writes to original poly */
+            divs[i].Aalloc = A->alloc;
+            divs[i].Aexp = A->exps;
+            divs[i].Acoeff = A->coeffs;
+        }
+        else
+        {
+            /* lower divisions write to a new worker poly */
+            divs[i].Aalloc = 0;
+            divs[i].Aexp = NULL;
+            divs[i].Acoeff = NULL;
+        }
+    }
+
+    /* compute each chunk in parallel */
+    pthread_mutex_init(&base->mutex, NULL);
+    for (i = 0; i < num_handles; i++)
+    {
+        args[i].idx = i;
+        args[i].base = base;
+        args[i].divs = divs;
+        thread_pool_wake(global_thread_pool, handles[i],
+                            _fq_nmod_mpoly_mul_heap_threaded_worker, &args[i]);
+    }
+    i = num_handles;
+    args[i].idx = i;
+    args[i].base = base;
+    args[i].divs = divs;
+    _fq_nmod_mpoly_mul_heap_threaded_worker(&args[i]);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    /* calculate and allocate space for final answer */
+    i = base->ndivs - 1;
+    Alen = divs[i].Alen;
+    Acoeff = divs[i].Acoeff;
+    Aexp = divs[i].Aexp;
+    Aalloc = divs[i].Aalloc;
+    for (i = base->ndivs - 2; i >= 0; i--)
+    {
+        divs[i].Aoffset = Alen;
+        Alen += divs[i].Alen;
+    }
+
+    /* the slots receiving the lower divisions are overwritten shallowly */
+    for (i = divs[base->ndivs - 1].Alen; i < FLINT_MIN(Alen, Aalloc); i++)
+        fq_nmod_clear(Acoeff + i, ctx->fqctx);
+
+    if (Alen > Aalloc)
+    {
+        Acoeff = (fq_nmod_struct *) flint_realloc(Acoeff,
+                                                  Alen*sizeof(fq_nmod_struct));
+        Aexp = (ulong *) flint_realloc(Aexp, Alen*N*sizeof(ulong));
+        Aalloc = Alen;
+    }
+    base->Acoeff = Acoeff;
+    base->Aexp = Aexp;
+
+    /* join answers */
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i], _join_worker, &args[i]);
+    }
+    _join_worker(&args[num_handles]);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    pthread_mutex_destroy(&base->mutex);
+
+    flint_free(args);
+    flint_free(divs);
+
+    A->coeffs = Acoeff;
+    A->exps = Aexp;
+    A->alloc = Aalloc;
+    A->length = Alen;
+}
+
+
+/* maxBfields gets clobbered */
+void _fq_nmod_mpoly_mul_heap_threaded_maxfields(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B, fmpz * maxBfields,
+    const fq_nmod_mpoly_t C, fmpz * maxCfields,
+    const fq_nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong N;
+    flint_bitcnt_t Abits;
+    ulong * cmpmask;
+    ulong * Bexp, * Cexp;
+    int freeBexp, freeCexp;
+    TMP_INIT;
+
+    TMP_START;
+
+    _fmpz_vec_add(maxBfields, maxBfields, maxCfields, ctx->minfo->nfields);
+
+    Abits = _fmpz_vec_max_bits(maxBfields, ctx->minfo->nfields);
+    Abits = FLINT_MAX(MPOLY_MIN_BITS, Abits + 1);
+    Abits = FLINT_MAX(Abits, B->bits);
+    Abits = FLINT_MAX(Abits, C->bits);
+    Abits = mpoly_fix_bits(Abits, ctx->minfo);
+
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+    cmpmask = (ulong*) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
+
+    /* ensure input exponents are packed into same sized fields as output */
+    freeBexp = 0;
+    Bexp = B->exps;
+    if (Abits > B->bits)
+    {
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits, B->length, ctx->minfo);
+    }
+
+    freeCexp = 0;
+    Cexp = C->exps;
+    if (Abits > C->bits)
+    {
+        freeCexp = 1;
+        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits, C->length, ctx->minfo);
+    }
+
+    /* deal with aliasing and do multiplication */
+    if (A == B || A == C)
+    {
+        fq_nmod_mpoly_t T;
+        fq_nmod_mpoly_init2(T, B->length + C->length, ctx);
+        fq_nmod_mpoly_fit_bits(T, Abits, ctx);
+        T->bits = Abits;
+
+        /* algorithm more efficient if smaller poly first */
+        if (B->length > C->length)
+        {
+            _fq_nmod_mpoly_mul_heap_threaded(T, C->coeffs, Cexp, C->length,
+                                                B->coeffs, Bexp, B->length,
+                                 Abits, N, cmpmask, ctx, handles, num_handles);
+        }
+        else
+        {
+            _fq_nmod_mpoly_mul_heap_threaded(T, B->coeffs, Bexp, B->length,
+                                                C->coeffs, Cexp, C->length,
+                                 Abits, N, cmpmask, ctx, handles, num_handles);
+        }
+
+        fq_nmod_mpoly_swap(T, A, ctx);
+        fq_nmod_mpoly_clear(T, ctx);
+    }
+    else
+    {
+        fq_nmod_mpoly_fit_length(A, B->length + C->length, ctx);
+        fq_nmod_mpoly_fit_bits(A, Abits, ctx);
+        A->bits = Abits;
+
+        /* algorithm more efficient if smaller poly first */
+        if (B->length > C->length)
+        {
+            _fq_nmod_mpoly_mul_heap_threaded(A, C->coeffs, Cexp, C->length,
+                                                B->coeffs, Bexp, B->length,
+                                 Abits, N, cmpmask, ctx, handles, num_handles);
+        }
+        else
+        {
+            _fq_nmod_mpoly_mul_heap_threaded(A, B->coeffs, Bexp, B->length,
+                                                C->coeffs, Cexp, C->length,
+                                 Abits, N, cmpmask, ctx, handles, num_handles);
+        }
+    }
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    if (freeCexp)
+        flint_free(Cexp);
+
+    TMP_END;
+}
+
+
+void fq_nmod_mpoly_mul_heap_threaded(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_t C,
+    const fq_nmod_mpoly_ctx_t ctx,
+    slong thread_limit)
+{
+    slong i;
+    fmpz * maxBfields, * maxCfields;
+    thread_pool_handle * handles;
+    slong num_handles;
+    TMP_INIT;
+
+    if (B->length == 0 || C->length == 0)
+    {
+        fq_nmod_mpoly_zero(A, ctx);
+        return;
+    }
+
+    TMP_START;
+
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxCfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxBfields + i);
+        fmpz_init(maxCfields + i);
+    }
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _fq_nmod_mpoly_mul_heap_threaded_maxfields(A, B, maxBfields, C, maxCfields,
+                                                    ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxBfields + i);
+        fmpz_clear(maxCfields + i);
+    }
+
+    TMP_END;
+}
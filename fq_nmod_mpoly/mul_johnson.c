@@ -166,124 +166,147 @@ slong _fq_nmod_mpoly_mul_johnson(fq_nmod_struct ** coeff1, ulong ** exp1, slong
     return len1;
 }
 
-void fq_nmod_mpoly_mul_johnson(fq_nmod_mpoly_t poly1, const fq_nmod_mpoly_t poly2,
-                          const fq_nmod_mpoly_t poly3, const fq_nmod_mpoly_ctx_t ctx)
+/* maxBfields gets clobbered */
+void _fq_nmod_mpoly_mul_johnson_maxfields(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B, fmpz * maxBfields,
+    const fq_nmod_mpoly_t C, fmpz * maxCfields,
+    const fq_nmod_mpoly_ctx_t ctx)
 {
-    slong i, N, len1 = 0;
-    flint_bitcnt_t exp_bits;
-    fmpz * max_fields2, * max_fields3;
+    slong N;
+    flint_bitcnt_t Abits;
     ulong * cmpmask;
-    ulong * exp2 = poly2->exps, * exp3 = poly3->exps;
-    int free2 = 0, free3 = 0;
+    ulong * Bexp, * Cexp;
+    int freeBexp, freeCexp;
     TMP_INIT;
 
-    if (poly2->length == 0 || poly3->length == 0)
-    {
-        fq_nmod_mpoly_zero(poly1, ctx);
-        return;
-    }
-
     TMP_START;
 
-    max_fields2 = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
-    max_fields3 = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
-    for (i = 0; i < ctx->minfo->nfields; i++)
-    {
-        fmpz_init(max_fields2 + i);
-        fmpz_init(max_fields3 + i);
-    }
-    mpoly_max_fields_fmpz(max_fields2, poly2->exps, poly2->length,
-                                                      poly2->bits, ctx->minfo);
-    mpoly_max_fields_fmpz(max_fields3, poly3->exps, poly3->length,
-                                                      poly3->bits, ctx->minfo);
-    _fmpz_vec_add(max_fields2, max_fields2, max_fields3, ctx->minfo->nfields);
-
-    exp_bits = _fmpz_vec_max_bits(max_fields2, ctx->minfo->nfields);
-    exp_bits = FLINT_MAX(MPOLY_MIN_BITS, exp_bits + 1);
-    exp_bits = FLINT_MAX(exp_bits, poly2->bits);
-    exp_bits = FLINT_MAX(exp_bits, poly3->bits);
-    exp_bits = mpoly_fix_bits(exp_bits, ctx->minfo);
+    _fmpz_vec_add(maxBfields, maxBfields, maxCfields, ctx->minfo->nfields);
 
-    for (i = 0; i < ctx->minfo->nfields; i++)
-    {
-        fmpz_clear(max_fields2 + i);
-        fmpz_clear(max_fields3 + i);
-    }
+    Abits = _fmpz_vec_max_bits(maxBfields, ctx->minfo->nfields);
+    Abits = FLINT_MAX(MPOLY_MIN_BITS, Abits + 1);
+    Abits = FLINT_MAX(Abits, B->bits);
+    Abits = FLINT_MAX(Abits, C->bits);
+    Abits = mpoly_fix_bits(Abits, ctx->minfo);
 
-    N = mpoly_words_per_exp(exp_bits, ctx->minfo);
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
     cmpmask = (ulong*) TMP_ALLOC(N*sizeof(ulong));
-    mpoly_get_cmpmask(cmpmask, N, exp_bits, ctx->minfo);
+    mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
 
     /* ensure input exponents are packed into same sized fields as output */
-    if (exp_bits > poly2->bits)
+    freeBexp = 0;
+    Bexp = B->exps;
+    if (Abits > B->bits)
     {
-        free2 = 1;
-        exp2 = (ulong *) flint_malloc(N*poly2->length*sizeof(ulong));
-        mpoly_repack_monomials(exp2, exp_bits, poly2->exps, poly2->bits,
-                                                    poly2->length, ctx->minfo);
+        freeBexp = 1;
+        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits,
+                                                        B->length, ctx->minfo);
     }
 
-    if (exp_bits > poly3->bits)
+    freeCexp = 0;
+    Cexp = C->exps;
+    if (Abits > C->bits)
     {
-        free3 = 1;
-        exp3 = (ulong *) flint_malloc(N*poly3->length*sizeof(ulong));
-        mpoly_repack_monomials(exp3, exp_bits, poly3->exps, poly3->bits,
-                                                    poly3->length, ctx->minfo);
+        freeCexp = 1;
+        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits,
+                                                        C->length, ctx->minfo);
     }
 
     /* deal with aliasing and do multiplication */
-    if (poly1 == poly2 || poly1 == poly3)
+    if (A == B || A == C)
     {
-        fq_nmod_mpoly_t temp;
+        fq_nmod_mpoly_t T;
+        fq_nmod_mpoly_init2(T, B->length + C->length - 1, ctx);
+        fq_nmod_mpoly_fit_bits(T, Abits, ctx);
+        T->bits = Abits;
 
-        fq_nmod_mpoly_init2(temp, poly2->length + poly3->length - 1, ctx);
-        fq_nmod_mpoly_fit_bits(temp, exp_bits, ctx);
-        temp->bits = exp_bits;
-
-        if (poly2->length >= poly3->length)
+        if (B->length >= C->length)
         {
-            len1 = _fq_nmod_mpoly_mul_johnson(&temp->coeffs, &temp->exps, &temp->alloc,
-                                      poly3->coeffs, exp3, poly3->length,
-                                      poly2->coeffs, exp2, poly2->length,
-                                          exp_bits, N, cmpmask, ctx->fqctx);
-        } else
+            T->length = _fq_nmod_mpoly_mul_johnson(&T->coeffs, &T->exps,
+                                  &T->alloc, C->coeffs, Cexp, C->length,
+                                             B->coeffs, Bexp, B->length,
+                                               Abits, N, cmpmask, ctx->fqctx);
+        }
+        else
         {
-            len1 = _fq_nmod_mpoly_mul_johnson(&temp->coeffs, &temp->exps, &temp->alloc,
-                                      poly2->coeffs, exp2, poly2->length,
-                                      poly3->coeffs, exp3, poly3->length,
-                                          exp_bits, N, cmpmask, ctx->fqctx);
+            T->length = _fq_nmod_mpoly_mul_johnson(&T->coeffs, &T->exps,
+                                  &T->alloc, B->coeffs, Bexp, B->length,
+                                             C->coeffs, Cexp, C->length,
+                                               Abits, N, cmpmask, ctx->fqctx);
         }
 
-        fq_nmod_mpoly_swap(temp, poly1, ctx);
-        fq_nmod_mpoly_clear(temp, ctx);
-   } else
-   {
-        fq_nmod_mpoly_fit_length(poly1, poly2->length + poly3->length - 1, ctx);
-        fq_nmod_mpoly_fit_bits(poly1, exp_bits, ctx);
-        poly1->bits = exp_bits;
+        fq_nmod_mpoly_swap(T, A, ctx);
+        fq_nmod_mpoly_clear(T, ctx);
+    }
+    else
+    {
+        fq_nmod_mpoly_fit_length(A, B->length + C->length - 1, ctx);
+        fq_nmod_mpoly_fit_bits(A, Abits, ctx);
+        A->bits = Abits;
 
-        if (poly2->length > poly3->length)
+        if (B->length > C->length)
         {
-            len1 = _fq_nmod_mpoly_mul_johnson(&poly1->coeffs, &poly1->exps, &poly1->alloc,
-                                      poly3->coeffs, exp3, poly3->length,
-                                      poly2->coeffs, exp2, poly2->length,
-                                          exp_bits, N, cmpmask, ctx->fqctx);
-        } else
+            A->length = _fq_nmod_mpoly_mul_johnson(&A->coeffs, &A->exps,
+                                  &A->alloc, C->coeffs, Cexp, C->length,
+                                             B->coeffs, Bexp, B->length,
+                                               Abits, N, cmpmask, ctx->fqctx);
+        }
+        else
         {
-            len1 = _fq_nmod_mpoly_mul_johnson(&poly1->coeffs, &poly1->exps, &poly1->alloc,
-                                      poly2->coeffs, exp2, poly2->length,
-                                      poly3->coeffs, exp3, poly3->length,
-                                          exp_bits, N, cmpmask, ctx->fqctx);
+            A->length = _fq_nmod_mpoly_mul_johnson(&A->coeffs, &A->exps,
+                                  &A->alloc, B->coeffs, Bexp, B->length,
+                                             C->coeffs, Cexp, C->length,
+                                               Abits, N, cmpmask, ctx->fqctx);
         }
-   }
+    }
+
+    if (freeBexp)
+        flint_free(Bexp);
+
+    if (freeCexp)
+        flint_free(Cexp);
 
-   if (free2)
-      flint_free(exp2);
+    TMP_END;
+}
+
+void fq_nmod_mpoly_mul_johnson(
+    fq_nmod_mpoly_t A,
+    const fq_nmod_mpoly_t B,
+    const fq_nmod_mpoly_t C,
+    const fq_nmod_mpoly_ctx_t ctx)
+{
+    slong i;
+    fmpz * maxBfields, * maxCfields;
+    TMP_INIT;
 
-   if (free3)
-      flint_free(exp3);
+    if (B->length == 0 || C->length == 0)
+    {
+        fq_nmod_mpoly_zero(A, ctx);
+        return;
+    }
 
-   _fq_nmod_mpoly_set_length(poly1, len1, ctx);
+    TMP_START;
 
-   TMP_END;
+    maxBfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    maxCfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_init(maxBfields + i);
+        fmpz_init(maxCfields + i);
+    }
+    mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
+    mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
+
+    _fq_nmod_mpoly_mul_johnson_maxfields(A, B, maxBfields, C, maxCfields, ctx);
+
+    for (i = 0; i < ctx->minfo->nfields; i++)
+    {
+        fmpz_clear(maxBfields + i);
+        fmpz_clear(maxCfields + i);
+    }
+
+    TMP_END;
 }
@@ -127,47 +127,139 @@ void _fq_nmod_mpoly_radix_sort(fq_nmod_mpoly_t A, slong left, slong right,
 }
 
 
+/* ranges at most this long are finished by insertion sort */
+#define RADIX_SORT_CUTOFF 32
+
+static void _insertion_sort(fq_nmod_struct * Acoeff, ulong * Aexp, slong left,
+                                 slong right, slong N, const ulong * cmpmask)
+{
+    slong i, j;
+
+    for (i = left + 1; i < right; i++)
+    {
+        for (j = i; j > left && mpoly_monomial_gt(Aexp + N*j,
+                                          Aexp + N*(j - 1), N, cmpmask); j--)
+        {
+            fq_nmod_swap(Acoeff + j, Acoeff + j - 1, NULL);
+            mpoly_monomial_swap(Aexp + N*j, Aexp + N*(j - 1), N);
+        }
+    }
+}
+
 /*
-    sort the terms in A by exponent
-    assuming that the exponents are valid (other than being in order)
+    sort terms in [left, right) by exponent
+    assuming that the exponents already agree in the bytes at the bit
+    positions digits[0], ..., digits[k - 1] and that all other bytes
+    not in digits[k], ..., digits[ndigits - 1] are constant
+    stack has room for 256*(ndigits + 1) counts
 */
-void fq_nmod_mpoly_sort_terms(fq_nmod_mpoly_t A, const fq_nmod_mpoly_ctx_t ctx)
+void _fq_nmod_mpoly_radix_sort_bytes(fq_nmod_struct * Acoeff,
+          ulong * Aexp, slong left, slong right, const slong * digits, slong k,
+                 slong ndigits, slong N, const ulong * cmpmask, slong * stack)
 {
-    slong i, msb, N;
-    ulong himask, * ptempexp;
-    TMP_INIT;
+    slong i, j, b, d, pos;
+    slong * next = stack, * end;
 
-    TMP_START;
-    N = mpoly_words_per_exp(A->bits, ctx->minfo);
-    ptempexp = (ulong *) TMP_ALLOC(N*sizeof(ulong));
-    mpoly_get_cmpmask(ptempexp, N, A->bits, ctx->minfo);
+    FLINT_ASSERT(left <= right);
+    FLINT_ASSERT(k < ndigits);
 
-    himask = 0;
-    for (i = 0; i < A->length; i++)
+    /* skip the bytes on which all of the terms agree */
+    while (1)
     {
-        himask |= (A->exps + N*i)[N - 1];
-    }
+        if (right - left <= RADIX_SORT_CUTOFF)
+        {
+            _insertion_sort(Acoeff, Aexp, left, right, N, cmpmask);
+            return;
+        }
 
-    if (himask != 0)
-    {
-        count_leading_zeros(msb, himask);
-        msb = (FLINT_BITS - 1)^msb;
+        pos = digits[k];
+        end = stack + 256*(k + 1);
+        for (b = 0; b < 256; b++)
+            end[b] = 0;
+        for (i = left; i < right; i++)
+            end[mpoly_radix_sort_digit(Aexp + N*i, pos, cmpmask)]++;
+
+        d = mpoly_radix_sort_digit(Aexp + N*left, pos, cmpmask);
+        if (end[d] != right - left)
+            break;
+
+        if (++k >= ndigits)
+            return;
     }
-    else
+
+    /* turn the counts into bucket ends and move each term into its bucket */
+    j = left;
+    for (b = 0; b < 256; b++)
     {
-        msb = -WORD(1);
+        next[b] = j;
+        j += end[b];
+        end[b] = j;
     }
 
-    if (N == 1)
+    for (b = 0; b < 256; b++)
     {
-        if (msb >= 0)
+        while (next[b] < end[b])
         {
-            _fq_nmod_mpoly_radix_sort1(A, 0, A->length, msb, ptempexp[0], himask);
+            d = mpoly_radix_sort_digit(Aexp + N*next[b], pos, cmpmask);
+            if (d == b)
+            {
+                next[b]++;
+            }
+            else
+            {
+                fq_nmod_swap(Acoeff + next[b], Acoeff + next[d], NULL);
+                mpoly_monomial_swap(Aexp + N*next[b], Aexp + N*next[d], N);
+                next[d]++;
+            }
         }
     }
-    else
+
+    /* the terms in a bucket agree on this byte */
+    if (k + 1 >= ndigits)
+        return;
+
+    j = left;
+    for (b = 0; b < 256; b++)
+    {
+        if (end[b] - j > 1)
+            _fq_nmod_mpoly_radix_sort_bytes(Acoeff, Aexp, j, end[b],
+                                   digits, k + 1, ndigits, N, cmpmask, stack);
+        j = end[b];
+    }
+}
+
+
+/*
+    sort the terms in A by exponent
+    assuming that the exponents are valid (other than being in order)
+*/
+void fq_nmod_mpoly_sort_terms(fq_nmod_mpoly_t A, const fq_nmod_mpoly_ctx_t ctx)
+{
+    slong N, ndigits;
+    ulong * cmpmask, * vary;
+    slong * digits, * stack;
+    TMP_INIT;
+
+    if (A->length < 2)
+        return;
+
+    TMP_START;
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    vary = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    digits = (slong *) TMP_ALLOC(N*(FLINT_BITS/8)*sizeof(slong));
+    mpoly_get_cmpmask(cmpmask, N, A->bits, ctx->minfo);
+
+    mpoly_monomial_zero(vary, N);
+    mpoly_monomials_varying_bits(vary, A->exps, A->length, A->exps, N);
+    ndigits = mpoly_radix_sort_digits(digits, vary, N);
+
+    if (ndigits > 0)
     {
-        _fq_nmod_mpoly_radix_sort(A, 0, A->length, (N - 1)*FLINT_BITS + msb, N, ptempexp);
+        stack = (slong *) flint_malloc(256*(ndigits + 1)*sizeof(slong));
+        _fq_nmod_mpoly_radix_sort_bytes(A->coeffs, A->exps, 0, A->length,
+                                      digits, 0, ndigits, N, cmpmask, stack);
+        flint_free(stack);
     }
 
     TMP_END;
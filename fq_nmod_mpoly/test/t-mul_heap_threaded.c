@@ -0,0 +1,176 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fq_nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, result, max_threads = 5;
+    slong tmul = 10;
+    FLINT_TEST_INIT(state);
+#ifdef _WIN32
+    tmul = 2;
+#endif
+
+    flint_printf("mul_heap_threaded....");
+    fflush(stdout);
+
+    {
+        fq_nmod_mpoly_ctx_t ctx;
+        fq_nmod_mpoly_t f, g, h1, h2;
+        const char * vars[] = {"x","y","z","t","u"};
+
+        fq_nmod_mpoly_ctx_init_deg(ctx, 5, ORD_LEX, 1009, 3);
+        fq_nmod_mpoly_init(f, ctx);
+        fq_nmod_mpoly_init(g, ctx);
+        fq_nmod_mpoly_init(h1, ctx);
+        fq_nmod_mpoly_init(h2, ctx);
+
+        fq_nmod_mpoly_set_str_pretty(f, "(1+x+y+2*z^2+3*t^3+5*u^5)^4", vars, ctx);
+        fq_nmod_mpoly_set_str_pretty(g, "(1+u+t+2*z^2+3*y^3+5*x^5)^4", vars, ctx);
+
+        fq_nmod_mpoly_mul_johnson(h1, f, g, ctx);
+        flint_set_num_threads(2);
+        fq_nmod_mpoly_mul_heap_threaded(h2, f, g, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+
+        if (!fq_nmod_mpoly_equal(h1, h2, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check simple example\n");
+            flint_abort();
+        }
+
+        fq_nmod_mpoly_clear(f, ctx);
+        fq_nmod_mpoly_clear(g, ctx);
+        fq_nmod_mpoly_clear(h1, ctx);
+        fq_nmod_mpoly_clear(h2, ctx);
+        fq_nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check mul_heap_threaded matches mul_johnson */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fq_nmod_mpoly_ctx_t ctx;
+        fq_nmod_mpoly_t f, g, h, k;
+        slong len, len1, len2;
+        flint_bitcnt_t exp_bits, exp_bits1, exp_bits2;
+
+        fq_nmod_mpoly_ctx_init_rand(ctx, state, 10, FLINT_BITS, 5);
+
+        fq_nmod_mpoly_init(f, ctx);
+        fq_nmod_mpoly_init(g, ctx);
+        fq_nmod_mpoly_init(h, ctx);
+        fq_nmod_mpoly_init(k, ctx);
+
+        len = n_randint(state, 100);
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits = n_randint(state, 200) + 2;
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            fq_nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            fq_nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            fq_nmod_mpoly_randtest_bits(h, state, len, exp_bits, ctx);
+            fq_nmod_mpoly_randtest_bits(k, state, len, exp_bits, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fq_nmod_mpoly_mul_johnson(h, f, g, ctx);
+            fq_nmod_mpoly_assert_canonical(h, ctx);
+            fq_nmod_mpoly_mul_heap_threaded(k, f, g, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            fq_nmod_mpoly_assert_canonical(k, ctx);
+            result = fq_nmod_mpoly_equal(h, k, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check mul_heap_threaded matches mul_johnson\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fq_nmod_mpoly_clear(f, ctx);
+        fq_nmod_mpoly_clear(g, ctx);
+        fq_nmod_mpoly_clear(h, ctx);
+        fq_nmod_mpoly_clear(k, ctx);
+
+        fq_nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check aliasing first and second arguments */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fq_nmod_mpoly_ctx_t ctx;
+        fq_nmod_mpoly_t f, g, h;
+        slong len1, len2;
+        flint_bitcnt_t exp_bits1, exp_bits2;
+
+        fq_nmod_mpoly_ctx_init_rand(ctx, state, 10, FLINT_BITS, 5);
+
+        fq_nmod_mpoly_init(f, ctx);
+        fq_nmod_mpoly_init(g, ctx);
+        fq_nmod_mpoly_init(h, ctx);
+
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            fq_nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            fq_nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            fq_nmod_mpoly_mul_johnson(h, f, g, ctx);
+            fq_nmod_mpoly_assert_canonical(h, ctx);
+            if (j & 1)
+            {
+                fq_nmod_mpoly_mul_heap_threaded(f, f, g, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+                fq_nmod_mpoly_assert_canonical(f, ctx);
+                result = fq_nmod_mpoly_equal(h, f, ctx);
+            }
+            else
+            {
+                fq_nmod_mpoly_mul_heap_threaded(g, f, g, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+                fq_nmod_mpoly_assert_canonical(g, ctx);
+                result = fq_nmod_mpoly_equal(h, g, ctx);
+            }
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fq_nmod_mpoly_clear(f, ctx);
+        fq_nmod_mpoly_clear(g, ctx);
+        fq_nmod_mpoly_clear(h, ctx);
+
+        fq_nmod_mpoly_ctx_clear(ctx);
+    }
+
+    printf("PASS\n");
+    FLINT_TEST_CLEANUP(state);
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fq_nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, result, max_threads = 5;
+    slong tmul = 10;
+    FLINT_TEST_INIT(state);
+#ifdef _WIN32
+    tmul = 2;
+#endif
+
+    flint_printf("sort_terms_threaded....");
+    fflush(stdout);
+
+    /* Check scramble and sort */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fq_nmod_mpoly_ctx_t ctx;
+        fq_nmod_mpoly_t f, g;
+        slong len;
+        flint_bitcnt_t exp_bits;
+
+        fq_nmod_mpoly_ctx_init_rand(ctx, state, 10, FLINT_BITS, 10);
+
+        fq_nmod_mpoly_init(f, ctx);
+        fq_nmod_mpoly_init(g, ctx);
+
+        len = n_randint(state, 2) ? n_randint(state, 200)
+                                  : n_randint(state, 10000);
+        exp_bits = n_randint(state, 200) + 1;
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        for (j = 0; j < 2; j++)
+        {
+            slong N, k;
+
+            fq_nmod_mpoly_randtest_bits(f, state, len, exp_bits, ctx);
+            fq_nmod_mpoly_set(g, f, ctx);
+
+            N = mpoly_words_per_exp(f->bits, ctx->minfo);
+            for (k = WORD(0); k < f->length; k++)
+            {
+                ulong a, b;
+                a = n_randint(state, f->length);
+                b = n_randint(state, f->length);
+                fq_nmod_swap(f->coeffs + a, f->coeffs + b, ctx->fqctx);
+                mpoly_monomial_swap(f->exps + N*a, f->exps + N*b, N);
+            }
+
+            fq_nmod_mpoly_sort_terms_threaded(f, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fq_nmod_mpoly_assert_canonical(f, ctx);
+            result = fq_nmod_mpoly_equal(f, g, ctx);
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check scramble and sort\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fq_nmod_mpoly_clear(f, ctx);
+        fq_nmod_mpoly_clear(g, ctx);
+        fq_nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check sort and combine of f, -f, f, g matches f + g */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        fq_nmod_mpoly_ctx_t ctx;
+        fq_nmod_mpoly_t f, g, h, k;
+        slong len1, len2;
+        flint_bitcnt_t exp_bits1, exp_bits2;
+
+        fq_nmod_mpoly_ctx_init_rand(ctx, state, 10, FLINT_BITS, 10);
+
+        fq_nmod_mpoly_init(f, ctx);
+        fq_nmod_mpoly_init(g, ctx);
+        fq_nmod_mpoly_init(h, ctx);
+        fq_nmod_mpoly_init(k, ctx);
+
+        len1 = n_randint(state, 2) ? n_randint(state, 200)
+                                   : n_randint(state, 10000);
+        len2 = n_randint(state, 2) ? n_randint(state, 200)
+                                   : n_randint(state, 10000);
+        exp_bits1 = n_randint(state, 200) + 1;
+        exp_bits2 = n_randint(state, 200) + 1;
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        for (j = 0; j < 2; j++)
+        {
+            slong N, l, t;
+            flint_bitcnt_t bits;
+
+            fq_nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            fq_nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            fq_nmod_mpoly_add(h, f, g, ctx);
+
+            bits = FLINT_MAX(f->bits, g->bits);
+            fq_nmod_mpoly_repack_bits(f, f, bits, ctx);
+            fq_nmod_mpoly_repack_bits(g, g, bits, ctx);
+            N = mpoly_words_per_exp(bits, ctx->minfo);
+
+            fq_nmod_mpoly_fit_length(k, 3*f->length + g->length, ctx);
+            fq_nmod_mpoly_fit_bits(k, bits, ctx);
+            k->bits = bits;
+            l = 0;
+            for (t = 0; t < f->length; t++, l++)
+            {
+                fq_nmod_set(k->coeffs + l, f->coeffs + t, ctx->fqctx);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < f->length; t++, l++)
+            {
+                fq_nmod_neg(k->coeffs + l, f->coeffs + t, ctx->fqctx);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < f->length; t++, l++)
+            {
+                fq_nmod_set(k->coeffs + l, f->coeffs + t, ctx->fqctx);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < g->length; t++, l++)
+            {
+                fq_nmod_set(k->coeffs + l, g->coeffs + t, ctx->fqctx);
+                mpoly_monomial_set(k->exps + N*l, g->exps + N*t, N);
+            }
+            _fq_nmod_mpoly_set_length(k, l, ctx);
+
+            for (t = 0; t < k->length; t++)
+            {
+                ulong a, b;
+                a = n_randint(state, k->length);
+                b = n_randint(state, k->length);
+                fq_nmod_swap(k->coeffs + a, k->coeffs + b, ctx->fqctx);
+                mpoly_monomial_swap(k->exps + N*a, k->exps + N*b, N);
+            }
+
+            fq_nmod_mpoly_sort_terms_threaded(k, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fq_nmod_mpoly_combine_like_terms_threaded(k, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            fq_nmod_mpoly_assert_canonical(k, ctx);
+            result = fq_nmod_mpoly_equal(k, h, ctx);
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check sort and combine\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        fq_nmod_mpoly_clear(f, ctx);
+        fq_nmod_mpoly_clear(g, ctx);
+        fq_nmod_mpoly_clear(h, ctx);
+        fq_nmod_mpoly_clear(k, ctx);
+        fq_nmod_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -43,6 +43,11 @@
 
 #define MPOLY_DEFAULT_THREAD_LIMIT (WORD(9999))
 
+/* binary format written by the *_mpoly_out_raw functions */
+#define MPOLY_RAW_MAGIC (UWORD(0x6d706f6c))     /* "mpol" */
+#define MPOLY_RAW_VERSION (UWORD(1))
+#define MPOLY_RAW_HEADER_LENGTH 7
+
 /* choose m so that (m + 1)/(n - m) ~= la/lb, i.e. m = (n*la - lb)/(la + lb) */
 MPOLY_INLINE slong mpoly_divide_threads(slong n, double la, double lb)
 {
@@ -208,6 +213,79 @@ FLINT_DLL mpoly_rbnode_struct * mpoly_rbtree_get(int * new_node,
 FLINT_DLL mpoly_rbnode_struct * mpoly_rbtree_get_fmpz(int * new_node,
                                         struct mpoly_rbtree *tree, fmpz_t rcx);
 
+/* straight line programs ***************************************************/
+
+#define MPOLY_SLP_MUL       0   /* dst = a*b     */
+#define MPOLY_SLP_ADD       1   /* dst = a + b   */
+#define MPOLY_SLP_MULADD    2   /* dst = a*b + c */
+
+/*
+    An operand is a register if it is nonnegative, otherwise it is the
+    constant at index ~operand. Registers [0, nvars) hold the values of the
+    variables on entry.
+*/
+typedef struct
+{
+    int op;
+    slong dst;
+    slong a;
+    slong b;
+    slong c;
+} mpoly_slp_instr_struct;
+
+typedef struct
+{
+    mpoly_slp_instr_struct * instrs;
+    slong length;
+    slong alloc;
+    slong nvars;
+    slong nregs;    /* number of registers used, including the variables */
+    slong result;   /* operand holding the final value */
+} mpoly_slp_struct;
+
+typedef mpoly_slp_struct mpoly_slp_t[1];
+
+FLINT_DLL void mpoly_slp_init(mpoly_slp_t P, slong nvars);
+
+FLINT_DLL void mpoly_slp_clear(mpoly_slp_t P);
+
+FLINT_DLL int mpoly_slp_compile(mpoly_slp_t P, const ulong * Aexps,
+                       slong Alen, flint_bitcnt_t Abits, const mpoly_ctx_t mctx);
+
+/* per-field packing *******************************************************/
+
+/*
+    Exponent vectors packed with a separate width for each field. The fields
+    are laid out in the same order as the uniform packing, starting a new
+    word whenever a field would straddle two words, so that comparison and
+    addition are still done a word at a time. Each width includes one guard
+    bit, whose position is recorded in overflow_mask.
+*/
+typedef struct
+{
+    slong nfields;
+    slong N;                    /* words per exponent vector */
+    flint_bitcnt_t * fbits;     /* width of each field */
+    slong * offsets;            /* bit offset of each field */
+    ulong * cmpmask;            /* N words */
+    ulong * overflow_mask;      /* N words */
+} mpoly_varbits_struct;
+
+typedef mpoly_varbits_struct mpoly_varbits_t[1];
+
+FLINT_DLL void mpoly_varbits_init(mpoly_varbits_t V, const fmpz * maxfields,
+                                                       const mpoly_ctx_t mctx);
+
+FLINT_DLL void mpoly_varbits_clear(mpoly_varbits_t V);
+
+FLINT_DLL void mpoly_varbits_pack(ulong * Vexps, const ulong * exps,
+                           flint_bitcnt_t bits, slong len,
+                           const mpoly_varbits_t V, const mpoly_ctx_t mctx);
+
+FLINT_DLL void mpoly_varbits_unpack(ulong * exps, flint_bitcnt_t bits,
+                           const ulong * Vexps, slong len,
+                           const mpoly_varbits_t V, const mpoly_ctx_t mctx);
+
 /* Orderings *****************************************************************/
 
 MPOLY_INLINE
@@ -458,6 +536,36 @@ int mpoly_monomial_divides(ulong * exp_ptr, const ulong * exp2,
    return 1;
 }
 
+/* as above, but with a possibly different mask for each word */
+MPOLY_INLINE
+int mpoly_monomial_overflows_varbits(const ulong * exp2, slong N,
+                                                          const ulong * masks)
+{
+   slong i;
+   for (i = 0; i < N; i++)
+   {
+      if ((exp2[i] & masks[i]) != 0)
+         return 1;
+   }
+   return 0;
+}
+
+MPOLY_INLINE
+int mpoly_monomial_divides_varbits(ulong * exp_ptr, const ulong * exp2,
+                              const ulong * exp3, slong N, const ulong * masks)
+{
+   slong i;
+   for (i = 0; i < N; i++)
+   {
+      exp_ptr[i] = exp2[i] - exp3[i];
+
+      if ((exp_ptr[i] & masks[i]) != 0)
+         return 0;
+   }
+
+   return 1;
+}
+
 MPOLY_INLINE
 int mpoly_monomial_divides_mp(ulong * exp_ptr, const ulong * exp2,
                                  const ulong * exp3, slong N, flint_bitcnt_t bits)
@@ -619,6 +727,34 @@ int mpoly_monomial_equal_extra(const ulong * exp2, const ulong * exp3,
    return 1;
 }
 
+#if defined(__GNUC__)
+#define MPOLY_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define MPOLY_PREFETCH(addr) ((void) (addr))
+#endif
+
+/*
+    Hash of an N word monomial for open addressing. Both the low bits (for
+    the table index) and the high bits (for partitioning) are well mixed.
+*/
+#if FLINT64
+#define MPOLY_HASH_MULTIPLIER UWORD(0x9e3779b97f4a7c15)
+#else
+#define MPOLY_HASH_MULTIPLIER UWORD(0x9e3779b9)
+#endif
+
+MPOLY_INLINE
+ulong mpoly_monomial_hash(const ulong * exp, slong N)
+{
+   slong i;
+   ulong h = exp[0]*MPOLY_HASH_MULTIPLIER;
+
+   for (i = 1; i < N; i++)
+      h = (h ^ exp[i])*MPOLY_HASH_MULTIPLIER;
+
+   return h ^ (h >> (FLINT_BITS/2 - 3));
+}
+
 MPOLY_INLINE
 int mpoly_monomial_cmp1(ulong a, ulong b, ulong cmpmask)
 {
@@ -851,6 +987,25 @@ FLINT_DLL void mpoly_get_cmpmask(ulong * cmpmask, slong N, slong bits,
 FLINT_DLL void mpoly_get_ovfmask(ulong * ovfmask, slong N, slong bits,
                                                        const mpoly_ctx_t mctx);
 
+FLINT_DLL void mpoly_monomials_varying_bits(ulong * vary, const ulong * exps,
+                                        slong len, const ulong * ref, slong N);
+
+FLINT_DLL slong mpoly_radix_sort_digits(slong * digits, const ulong * vary,
+                                                                      slong N);
+
+/*
+    The byte of exp at bit position pos as a radix sort digit: terms with
+    smaller digits come first in the ordering given by cmpmask.
+*/
+MPOLY_INLINE
+ulong mpoly_radix_sort_digit(const ulong * exp, slong pos,
+                                                         const ulong * cmpmask)
+{
+    slong w = pos/FLINT_BITS;
+    ulong e = (exp[w] ^ cmpmask[w]) >> (pos%FLINT_BITS);
+    return UWORD(255) - (e & UWORD(255));
+}
+
 FLINT_DLL flint_bitcnt_t mpoly_exp_bits_required_ui(const ulong * user_exp,
                                                        const mpoly_ctx_t mctx);
 FLINT_DLL flint_bitcnt_t mpoly_exp_bits_required_ffmpz(const fmpz * user_exp,
@@ -1003,6 +1158,12 @@ FLINT_DLL int mpoly_monomials_inorder_test(ulong * exps, slong len, slong bits,
 
 FLINT_DLL void mpoly_reverse(ulong * Aexp, const ulong * Bexp, slong len, slong N);
 
+FLINT_DLL void mpoly_raw_header_set(ulong * header, flint_bitcnt_t bits,
+                           slong length, ulong modulus, const mpoly_ctx_t mctx);
+
+FLINT_DLL int mpoly_raw_header_get(flint_bitcnt_t * bits, slong * length,
+                   const ulong * header, ulong modulus, const mpoly_ctx_t mctx);
+
 FLINT_DLL void mpoly_monomials_deflation(fmpz * shift, fmpz * stride,
                         const ulong * Aexps, flint_bitcnt_t Abits, slong Alength,
                                                        const mpoly_ctx_t mctx);
@@ -0,0 +1,42 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "mpoly.h"
+
+/*
+    or into vary the bits in which the len exponents differ from ref
+*/
+void mpoly_monomials_varying_bits(ulong * vary, const ulong * exps,
+                                       slong len, const ulong * ref, slong N)
+{
+    slong i, j;
+
+    for (i = 0; i < len; i++)
+        for (j = 0; j < N; j++)
+            vary[j] |= exps[N*i + j] ^ ref[j];
+}
+
+/*
+    Set digits to the bit positions of the bytes of an exponent vector that
+    are nonzero in vary, from most significant to least significant.
+    The return is the number of such bytes, at most N*FLINT_BITS/8.
+*/
+slong mpoly_radix_sort_digits(slong * digits, const ulong * vary, slong N)
+{
+    slong j, k, n = 0;
+
+    for (j = N - 1; j >= 0; j--)
+        for (k = FLINT_BITS - 8; k >= 0; k -= 8)
+            if (((vary[j] >> k) & UWORD(255)) != 0)
+                digits[n++] = j*FLINT_BITS + k;
+
+    return n;
+}
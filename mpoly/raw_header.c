@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "mpoly.h"
+
+/*
+    The raw format of a polynomial is a header of MPOLY_RAW_HEADER_LENGTH
+    words, followed by the length*N packed exponent words, followed by the
+    coefficients. The header words are
+
+        magic, version, nvars, ord, bits, length, modulus
+
+    where modulus is zero for integer coefficients. Everything is stored as
+    native words, so that a file written with a different word size or byte
+    order is rejected by the magic check.
+*/
+void mpoly_raw_header_set(ulong * header, flint_bitcnt_t bits,
+                            slong length, ulong modulus, const mpoly_ctx_t mctx)
+{
+    header[0] = MPOLY_RAW_MAGIC;
+    header[1] = MPOLY_RAW_VERSION;
+    header[2] = mctx->nvars;
+    header[3] = mctx->ord;
+    header[4] = bits;
+    header[5] = length;
+    header[6] = modulus;
+}
+
+/*
+    Return 1 if the header matches mctx and modulus and describes a valid
+    exponent packing, in which case bits and length are set. Return 0
+    otherwise.
+*/
+int mpoly_raw_header_get(flint_bitcnt_t * bits, slong * length,
+                    const ulong * header, ulong modulus, const mpoly_ctx_t mctx)
+{
+    slong N;
+    flint_bitcnt_t Abits = header[4];
+    slong Alength = header[5];
+
+    if (header[0] != MPOLY_RAW_MAGIC || header[1] != MPOLY_RAW_VERSION)
+        return 0;
+
+    if (header[2] != (ulong) mctx->nvars || header[3] != (ulong) mctx->ord
+                                                     || header[6] != modulus)
+        return 0;
+
+    if (Abits < 1 || (Abits > FLINT_BITS && (Abits % FLINT_BITS) != 0))
+        return 0;
+
+    if (Abits > FLINT_BITS && Abits/FLINT_BITS > WORD_MAX/(mctx->nfields + 1))
+        return 0;
+
+    N = mpoly_words_per_exp(Abits, mctx);
+    if (Alength < 0 || (N > 0 && Alength > WORD_MAX/N/(slong) sizeof(ulong)))
+        return 0;
+
+    *bits = Abits;
+    *length = Alength;
+    return 1;
+}
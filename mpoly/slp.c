@@ -0,0 +1,356 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include "mpoly.h"
+
+
+void mpoly_slp_init(mpoly_slp_t P, slong nvars)
+{
+    P->instrs = NULL;
+    P->length = 0;
+    P->alloc = 0;
+    P->nvars = nvars;
+    P->nregs = nvars;
+    P->result = 0;
+}
+
+
+void mpoly_slp_clear(mpoly_slp_t P)
+{
+    if (P->instrs != NULL)
+        flint_free(P->instrs);
+}
+
+/* append an instruction writing to a new register and return the register */
+static slong _slp_push(mpoly_slp_struct * P, int op, slong a, slong b, slong c)
+{
+    mpoly_slp_instr_struct * in;
+
+    if (P->length >= P->alloc)
+    {
+        P->alloc = FLINT_MAX(WORD(16), 2*P->alloc);
+        P->instrs = (mpoly_slp_instr_struct *) flint_realloc(P->instrs,
+                                      P->alloc*sizeof(mpoly_slp_instr_struct));
+    }
+
+    in = P->instrs + P->length;
+    in->op = op;
+    in->dst = P->nregs;
+    in->a = a;
+    in->b = b;
+    in->c = c;
+    P->length++;
+
+    return P->nregs++;
+}
+
+
+typedef struct
+{
+    ulong key;
+    slong idx;
+}
+_sort_entry_struct;
+
+static int _sort_entry_cmp(const void * x, const void * y)
+{
+    const _sort_entry_struct * a = (const _sort_entry_struct *) x;
+    const _sort_entry_struct * b = (const _sort_entry_struct *) y;
+
+    if (a->key != b->key)
+        return a->key < b->key ? 1 : -1;
+
+    return a->idx < b->idx ? -1 : a->idx > b->idx;
+}
+
+
+typedef struct
+{
+    mpoly_slp_struct * P;
+    const ulong * exps;             /* unpacked exponents, nvars per term */
+    slong nvars;
+    mpoly_rbtree_struct * powers;   /* for each variable: power -> register */
+    slong * squares;                /* register holding x^(2^i) or -1 */
+    _sort_entry_struct * entries;
+}
+_compile_struct;
+
+static slong _square(_compile_struct * C, slong v, slong i)
+{
+    slong * s = C->squares + FLINT_BITS*v + i;
+
+    if (*s < 0)
+    {
+        if (i == 0)
+        {
+            *s = v;
+        }
+        else
+        {
+            slong t = _square(C, v, i - 1);
+            *s = _slp_push(C->P, MPOLY_SLP_MUL, t, t, 0);
+        }
+    }
+
+    return *s;
+}
+
+/* register holding x_v^g for g > 0, shared among all of its uses */
+static slong _power(_compile_struct * C, slong v, ulong g)
+{
+    int new;
+    slong i, r;
+    mpoly_rbnode_struct * node;
+
+    FLINT_ASSERT(g > 0);
+
+    node = mpoly_rbtree_get(&new, C->powers + v, (slong) g);
+    if (!new)
+        return (slong) node->data;
+
+    r = -WORD(1);
+    for (i = 0; i < FLINT_BITS && (g >> i) != 0; i++)
+    {
+        if (((g >> i) & 1) != 0)
+        {
+            slong s = _square(C, v, i);
+            r = (r < 0) ? s : _slp_push(C->P, MPOLY_SLP_MUL, r, s, 0);
+        }
+    }
+
+    node->data = (void *) r;
+    return r;
+}
+
+/*
+    Return an operand holding the sum of the terms idx[0], ..., idx[len - 1]
+    evaluated in the variables v, v + 1, ..., nvars - 1, which are the only
+    ones in which they may differ. The terms are written in Horner form in
+    the variable v with the coefficients recursively in Horner form in the
+    remaining variables.
+*/
+static slong _compile(_compile_struct * C, slong * idx, slong len, slong v)
+{
+    slong i, j, acc, t, nvars = C->nvars;
+    const ulong * exps = C->exps;
+    ulong d, dprev;
+    _sort_entry_struct * E = C->entries;
+
+    FLINT_ASSERT(len > 0);
+
+    /* skip the variables that do not appear */
+    for ( ; v < nvars; v++)
+    {
+        for (i = 0; i < len; i++)
+            if (exps[nvars*idx[i] + v] != 0)
+                break;
+        if (i < len)
+            break;
+    }
+
+    if (v >= nvars)
+    {
+        acc = ~idx[0];
+        for (i = 1; i < len; i++)
+            acc = _slp_push(C->P, MPOLY_SLP_ADD, acc, ~idx[i], 0);
+        return acc;
+    }
+
+    /* sort by the exponent of x_v in decreasing order */
+    for (i = 0; i < len; i++)
+    {
+        E[i].key = exps[nvars*idx[i] + v];
+        E[i].idx = idx[i];
+    }
+    qsort(E, len, sizeof(_sort_entry_struct), _sort_entry_cmp);
+    for (i = 0; i < len; i++)
+        idx[i] = E[i].idx;
+
+    acc = -WORD(1);
+    dprev = 0;
+    for (i = 0; i < len; i = j)
+    {
+        d = exps[nvars*idx[i] + v];
+        for (j = i + 1; j < len && exps[nvars*idx[j] + v] == d; j++)
+            ;
+
+        t = _compile(C, idx + i, j - i, v + 1);
+
+        if (i == 0)
+            acc = t;
+        else
+            acc = _slp_push(C->P, MPOLY_SLP_MULADD, acc,
+                                              _power(C, v, dprev - d), t);
+        dprev = d;
+    }
+
+    if (dprev > 0)
+        acc = _slp_push(C->P, MPOLY_SLP_MUL, acc, _power(C, v, dprev), 0);
+
+    return acc;
+}
+
+/*
+    Each instruction writes a new register. Map these onto as few registers
+    as possible by reusing a register once its value has been used for the
+    last time. Since all operations are performed elementwise, the
+    destination of an instruction may be the same as one of its sources.
+*/
+static void _allocate_registers(mpoly_slp_struct * P)
+{
+    slong i, j, k, nfree, nregs, nvars = P->nvars;
+    slong * lastuse, * map, * freed;
+    slong src[3];
+    mpoly_slp_instr_struct * in;
+
+    lastuse = (slong *) flint_malloc(P->nregs*sizeof(slong));
+    map = (slong *) flint_malloc(P->nregs*sizeof(slong));
+    freed = (slong *) flint_malloc(P->nregs*sizeof(slong));
+
+    for (i = 0; i < P->nregs; i++)
+    {
+        lastuse[i] = -WORD(1);
+        map[i] = i;
+    }
+
+    for (i = 0; i < P->length; i++)
+    {
+        in = P->instrs + i;
+        if (in->a >= 0)
+            lastuse[in->a] = i;
+        if (in->b >= 0)
+            lastuse[in->b] = i;
+        if (in->op == MPOLY_SLP_MULADD && in->c >= 0)
+            lastuse[in->c] = i;
+    }
+
+    if (P->result >= 0)
+        lastuse[P->result] = P->length;
+
+    nregs = nvars;
+    nfree = 0;
+    for (i = 0; i < P->length; i++)
+    {
+        in = P->instrs + i;
+
+        k = 0;
+        src[k++] = in->a;
+        src[k++] = in->b;
+        if (in->op == MPOLY_SLP_MULADD)
+            src[k++] = in->c;
+
+        if (in->a >= 0)
+            in->a = map[in->a];
+        if (in->b >= 0)
+            in->b = map[in->b];
+        if (in->op == MPOLY_SLP_MULADD && in->c >= 0)
+            in->c = map[in->c];
+        else if (in->op != MPOLY_SLP_MULADD)
+            in->c = 0;
+
+        /* release the sources that are not used again */
+        for (j = 0; j < k; j++)
+        {
+            if (src[j] >= nvars && lastuse[src[j]] == i &&
+                          (j < 1 || src[j] != src[0]) &&
+                          (j < 2 || src[j] != src[1]))
+            {
+                freed[nfree++] = map[src[j]];
+            }
+        }
+
+        map[in->dst] = (nfree > 0) ? freed[--nfree] : nregs++;
+        in->dst = map[in->dst];
+    }
+
+    if (P->result >= 0)
+        P->result = map[P->result];
+
+    P->nregs = nregs;
+
+    flint_free(lastuse);
+    flint_free(map);
+    flint_free(freed);
+}
+
+/*
+    Compile the sum of the monomials of A with coefficient i in the
+    constant at index i. The return is 0 if some exponent of A does not fit
+    into a word, in which case nothing is compiled.
+*/
+int mpoly_slp_compile(mpoly_slp_t P, const ulong * Aexps, slong Alen,
+                                 flint_bitcnt_t Abits, const mpoly_ctx_t mctx)
+{
+    slong i, v, N, nvars = mctx->nvars;
+    slong * idx;
+    ulong * exps;
+    _compile_struct C;
+
+    P->length = 0;
+    P->nvars = nvars;
+    P->nregs = nvars;
+    P->result = 0;
+
+    if (Alen < 1)
+        return 1;
+
+    if (Abits > FLINT_BITS)
+    {
+        for (i = 0; i < Alen; i++)
+            if (!mpoly_term_exp_fits_ui((ulong *) Aexps, Abits, i, mctx))
+                return 0;
+    }
+
+    N = mpoly_words_per_exp(Abits, mctx);
+    exps = (ulong *) flint_malloc(nvars*Alen*sizeof(ulong));
+    idx = (slong *) flint_malloc(Alen*sizeof(slong));
+    for (i = 0; i < Alen; i++)
+    {
+        mpoly_get_monomial_ui(exps + nvars*i, Aexps + N*i, Abits, mctx);
+        idx[i] = i;
+    }
+
+    C.P = P;
+    C.exps = exps;
+    C.nvars = nvars;
+    C.powers = (mpoly_rbtree_struct *) flint_malloc(
+                                         nvars*sizeof(mpoly_rbtree_struct));
+    C.squares = (slong *) flint_malloc(nvars*FLINT_BITS*sizeof(slong));
+    C.entries = (_sort_entry_struct *) flint_malloc(
+                                            Alen*sizeof(_sort_entry_struct));
+    for (v = 0; v < nvars; v++)
+        mpoly_rbtree_init(C.powers + v);
+    for (i = 0; i < nvars*FLINT_BITS; i++)
+        C.squares[i] = -WORD(1);
+
+    P->result = _compile(&C, idx, Alen, 0);
+
+    for (v = 0; v < nvars; v++)
+    {
+        slong size = FLINT_MAX(C.powers[v].size, WORD(1));
+        void ** data = (void **) flint_malloc(size*sizeof(void *));
+        slong * keys = (slong *) flint_malloc(size*sizeof(slong));
+        mpoly_rbtree_clear(C.powers + v, data, keys);
+        flint_free(data);
+        flint_free(keys);
+    }
+
+    flint_free(C.powers);
+    flint_free(C.squares);
+    flint_free(C.entries);
+    flint_free(exps);
+    flint_free(idx);
+
+    _allocate_registers(P);
+
+    return 1;
+}
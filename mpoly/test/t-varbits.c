@@ -0,0 +1,134 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz_vec.h"
+#include "mpoly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    slong k, i, j, length, nfields, bits, N, VN;
+    ulong * a, * b, * c, * Va, * cmpmask;
+    fmpz * maxfields;
+    ulong max_length, max_fields;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("varbits....");
+    fflush(stdout);
+
+    max_length = 50;
+    max_fields = 21;
+
+    a  = (ulong *) flint_malloc(max_length*max_fields*sizeof(ulong));
+    b  = (ulong *) flint_malloc(max_length*max_fields*sizeof(ulong));
+    c  = (ulong *) flint_malloc(max_length*max_fields*sizeof(ulong));
+    Va = (ulong *) flint_malloc(max_length*max_fields*sizeof(ulong));
+    cmpmask = (ulong *) flint_malloc(max_fields*sizeof(ulong));
+    maxfields = _fmpz_vec_init(max_fields);
+
+    /*
+        pack into uniform bits, repack into per-field widths and back,
+        and check that comparisons agree with the uniform packing
+    */
+    for (k = 0; k < 1000 * flint_test_multiplier(); k++)
+    {
+        mpoly_ctx_t mctx;
+        mpoly_varbits_t V;
+        int cmp1, cmp2;
+
+        mpoly_ctx_init_rand(mctx, state, max_fields - 1);
+        nfields = mctx->nfields;
+        length = n_randint(state, max_length) + 1;
+        bits = n_randint(state, FLINT_BITS - MPOLY_MIN_BITS) + MPOLY_MIN_BITS;
+        bits = mpoly_fix_bits(bits, mctx);
+        if (bits > FLINT_BITS)
+            bits = FLINT_BITS;
+        N = mpoly_words_per_exp_sp(bits, mctx);
+
+        for (i = 0; i < nfields; i++)
+        {
+            flint_bitcnt_t fb = n_randint(state, bits);
+            c[i] = fb == 0 ? 0 : n_randbits(state, fb);
+        }
+
+        for (j = 0; j < length; j++)
+            for (i = 0; i < nfields; i++)
+                a[nfields*j + i] = n_randint(state, c[i] + 1);
+
+        for (i = 0; i < nfields; i++)
+            fmpz_set_ui(maxfields + i, c[i]);
+
+        mpoly_pack_vec_ui(b, a, bits, nfields, length);
+
+        mpoly_varbits_init(V, maxfields, mctx);
+        VN = V->N;
+
+        if (VN > max_fields)
+        {
+            printf("FAIL\n");
+            flint_printf("too many words\n");
+            flint_abort();
+        }
+
+        mpoly_varbits_pack(Va, b, bits, length, V, mctx);
+        mpoly_varbits_unpack(c, bits, Va, length, V, mctx);
+
+        for (i = 0; i < N*length; i++)
+        {
+            if (b[i] != c[i])
+            {
+                printf("FAIL\n");
+                flint_printf("check pack/unpack\nbits = %wd, nfields = %wd\n",
+                                                                bits, nfields);
+                flint_abort();
+            }
+        }
+
+        mpoly_get_cmpmask(cmpmask, N, bits, mctx);
+
+        for (j = 0; j + 1 < length; j++)
+        {
+            cmp1 = mpoly_monomial_cmp(b + N*j, b + N*(j + 1), N, cmpmask);
+            cmp2 = mpoly_monomial_cmp(Va + VN*j, Va + VN*(j + 1), VN,
+                                                                   V->cmpmask);
+            if (cmp1 != cmp2 ||
+                mpoly_monomial_overflows_varbits(Va + VN*j, VN,
+                                                             V->overflow_mask))
+            {
+                printf("FAIL\n");
+                flint_printf("check comparison\nbits = %wd, nfields = %wd\n",
+                                                                bits, nfields);
+                flint_abort();
+            }
+        }
+
+        mpoly_varbits_clear(V);
+        mpoly_ctx_clear(mctx);
+    }
+
+    _fmpz_vec_clear(maxfields, max_fields);
+    flint_free(cmpmask);
+    flint_free(Va);
+    flint_free(c);
+    flint_free(b);
+    flint_free(a);
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
+
@@ -0,0 +1,147 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "mpoly.h"
+
+/*
+    Set up a packing in which field i can hold values up to maxfields[i],
+    with one extra guard bit. All of the maxfields must fit in FLINT_BITS - 1
+    bits.
+*/
+void mpoly_varbits_init(mpoly_varbits_t V, const fmpz * maxfields,
+                                                        const mpoly_ctx_t mctx)
+{
+    slong i, w, nfields = mctx->nfields;
+    ulong pos, fmask;
+
+    V->nfields = nfields;
+    V->fbits = (flint_bitcnt_t *) flint_malloc(FLINT_MAX(nfields, 1)
+                                                    *sizeof(flint_bitcnt_t));
+    V->offsets = (slong *) flint_malloc(FLINT_MAX(nfields, 1)*sizeof(slong));
+
+    pos = 0;
+    for (i = 0; i < nfields; i++)
+    {
+        w = fmpz_bits(maxfields + i) + 1;
+        FLINT_ASSERT(w <= FLINT_BITS);
+
+        /* do not straddle words */
+        if (pos%FLINT_BITS + w > FLINT_BITS)
+            pos += FLINT_BITS - pos%FLINT_BITS;
+
+        V->fbits[i] = w;
+        V->offsets[i] = pos;
+        pos += w;
+    }
+
+    V->N = FLINT_MAX((pos + FLINT_BITS - 1)/FLINT_BITS, WORD(1));
+
+    V->cmpmask = (ulong *) flint_calloc(V->N, sizeof(ulong));
+    V->overflow_mask = (ulong *) flint_calloc(V->N, sizeof(ulong));
+
+    for (i = 0; i < nfields; i++)
+    {
+        slong word = V->offsets[i]/FLINT_BITS;
+        slong shift = V->offsets[i]%FLINT_BITS;
+
+        w = V->fbits[i];
+        V->overflow_mask[word] |= UWORD(1) << (shift + w - 1);
+
+        /* DEGREVLEX reverses every field but the total degree at the top */
+        if (mctx->ord == ORD_DEGREVLEX && i + 1 < nfields)
+        {
+            fmask = (w < FLINT_BITS) ? (UWORD(1) << w) - 1 : -UWORD(1);
+            V->cmpmask[word] |= fmask << shift;
+        }
+    }
+}
+
+
+void mpoly_varbits_clear(mpoly_varbits_t V)
+{
+    flint_free(V->fbits);
+    flint_free(V->offsets);
+    flint_free(V->cmpmask);
+    flint_free(V->overflow_mask);
+}
+
+/*
+    Repack len exponent vectors from the uniform packing with bits <=
+    FLINT_BITS into V. Each field must fit the width V gives it.
+*/
+void mpoly_varbits_pack(ulong * Vexps, const ulong * exps,
+                           flint_bitcnt_t bits, slong len,
+                           const mpoly_varbits_t V, const mpoly_ctx_t mctx)
+{
+    slong i, j, k;
+    slong N = mpoly_words_per_exp_sp(bits, mctx);
+    slong VN = V->N, nfields = V->nfields;
+    ulong * t;
+    TMP_INIT;
+
+    FLINT_ASSERT(bits <= FLINT_BITS);
+
+    TMP_START;
+    t = (ulong *) TMP_ALLOC(FLINT_MAX(nfields, 1)*sizeof(ulong));
+
+    for (i = 0; i < len; i++)
+    {
+        ulong * v = Vexps + VN*i;
+
+        mpoly_unpack_vec_ui(t, exps + N*i, bits, nfields, 1);
+
+        for (k = 0; k < VN; k++)
+            v[k] = 0;
+
+        for (j = 0; j < nfields; j++)
+        {
+            FLINT_ASSERT(V->fbits[j] == FLINT_BITS ||
+                                       (t[j] >> (V->fbits[j] - 1)) == 0);
+            v[V->offsets[j]/FLINT_BITS] |= t[j] << (V->offsets[j]%FLINT_BITS);
+        }
+    }
+
+    TMP_END;
+}
+
+/* inverse of mpoly_varbits_pack */
+void mpoly_varbits_unpack(ulong * exps, flint_bitcnt_t bits,
+                           const ulong * Vexps, slong len,
+                           const mpoly_varbits_t V, const mpoly_ctx_t mctx)
+{
+    slong i, j;
+    slong N = mpoly_words_per_exp_sp(bits, mctx);
+    slong VN = V->N, nfields = V->nfields;
+    ulong * t, fmask;
+    TMP_INIT;
+
+    FLINT_ASSERT(bits <= FLINT_BITS);
+
+    TMP_START;
+    t = (ulong *) TMP_ALLOC(FLINT_MAX(nfields, 1)*sizeof(ulong));
+
+    for (i = 0; i < len; i++)
+    {
+        const ulong * v = Vexps + VN*i;
+
+        for (j = 0; j < nfields; j++)
+        {
+            fmask = (V->fbits[j] < FLINT_BITS) ?
+                           (UWORD(1) << V->fbits[j]) - 1 : -UWORD(1);
+            t[j] = (v[V->offsets[j]/FLINT_BITS] >>
+                                          (V->offsets[j]%FLINT_BITS)) & fmask;
+        }
+
+        mpoly_pack_vec_ui(exps + N*i, t, bits, nfields, 1);
+    }
+
+    TMP_END;
+}
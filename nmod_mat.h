@@ -297,6 +297,12 @@ FLINT_DLL slong nmod_mat_lu(slong * P, nmod_mat_t A, int rank_check);
 FLINT_DLL slong nmod_mat_lu_classical(slong * P, nmod_mat_t A, int rank_check);
 FLINT_DLL slong nmod_mat_lu_recursive(slong * P, nmod_mat_t A, int rank_check);
 
+/* PLUQ decomposition */
+
+FLINT_DLL slong nmod_mat_pluq(slong * P, slong * Q, nmod_mat_t A);
+FLINT_DLL slong nmod_mat_pluq_classical(slong * P, slong * Q, nmod_mat_t A);
+FLINT_DLL slong nmod_mat_pluq_recursive(slong * P, slong * Q, nmod_mat_t A);
+
 /* Nonsingular solving */
 
 FLINT_DLL int nmod_mat_solve(nmod_mat_t X, const nmod_mat_t A, const nmod_mat_t B);
@@ -348,6 +354,13 @@ FLINT_DLL void nmod_mat_similarity(nmod_mat_t M, slong r, ulong d);
 /* Cutoff between classical and recursive LU decomposition */
 #define NMOD_MAT_LU_RECURSIVE_CUTOFF 4
 
+/* Cutoff between classical and recursive PLUQ decomposition */
+#define NMOD_MAT_PLUQ_RECURSIVE_CUTOFF 16
+
+/* Minimum work and number of columns per thread in PLUQ block updates */
+#define NMOD_MAT_PLUQ_THREADED_CUTOFF 4000000
+#define NMOD_MAT_PLUQ_THREADED_COLS 64
+
 /*
    Suggested initial modulus size for multimodular algorithms. This should
    be chosen so that we get the most number of bits per cycle
@@ -0,0 +1,118 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "nmod_poly.h"
+#include "perm.h"
+
+/*
+    If the Krylov space W of v has dimension d, then in a basis formed by
+    W and unit vectors completing it, A is block upper triangular with a
+    companion block for the minimal polynomial of v. Hence the charpoly
+    is that polynomial times the charpoly of the (m - d) x (m - d) block
+    giving the action of A on the quotient by W, which is computed with a
+    single matrix multiplication.
+*/
+void nmod_mat_charpoly_krylov(nmod_poly_t p, const nmod_mat_t M)
+{
+    slong m = M->r, d, i, j, k;
+    slong * pivots_nonpivots, * P;
+    mp_ptr v;
+    nmod_mat_t A, B, K, R, S;
+    nmod_poly_t f;
+    flint_rand_t state;
+
+    nmod_poly_one(p);
+
+    if (m == 0)
+        return;
+
+    flint_randinit(state);
+
+    nmod_poly_init_preinv(f, M->mod.n, M->mod.ninv);
+    nmod_mat_init_set(A, M);
+    nmod_mat_init(K, 0, 0, M->mod.n);
+    v = _nmod_vec_init(m);
+    pivots_nonpivots = flint_malloc(m*sizeof(slong));
+    P = _perm_init(m);
+
+    while (1)
+    {
+        for (i = 0; i < m; i++)
+            v[i] = n_randint(state, M->mod.n);
+
+        d = _nmod_mat_minpoly_vec(f, K, A, v);
+
+        nmod_poly_mul(p, p, f);
+
+        if (d == m)
+            break;
+
+        /*
+            Rows of rref(K) are a basis of W which is the identity on the
+            pivot coordinates; the other coordinates index the quotient.
+        */
+        _nmod_mat_rref(K, pivots_nonpivots, P);
+
+        /* R = rows of rref(K) on nonpivot coordinates, transposed */
+        nmod_mat_init(R, m - d, d, M->mod.n);
+        nmod_mat_init(S, d, m - d, M->mod.n);
+        nmod_mat_init(B, m - d, m - d, M->mod.n);
+
+        for (i = 0; i < m - d; i++)
+            for (k = 0; k < d; k++)
+                nmod_mat_entry(R, i, k) = nmod_mat_entry(K, k,
+                                                      pivots_nonpivots[d + i]);
+
+        for (k = 0; k < d; k++)
+            for (j = 0; j < m - d; j++)
+                nmod_mat_entry(S, k, j) = nmod_mat_entry(A,
+                                  pivots_nonpivots[k], pivots_nonpivots[d + j]);
+
+        for (i = 0; i < m - d; i++)
+            for (j = 0; j < m - d; j++)
+                nmod_mat_entry(B, i, j) = nmod_mat_entry(A,
+                              pivots_nonpivots[d + i], pivots_nonpivots[d + j]);
+
+        /* the update has rank d, which is usually tiny */
+        if (d < NMOD_MAT_CHARPOLY_KRYLOV_SUBMUL_CUTOFF)
+        {
+            for (i = 0; i < m - d; i++)
+                for (k = 0; k < d; k++)
+                    _nmod_vec_scalar_addmul_nmod(B->rows[i], S->rows[k], m - d,
+                             nmod_neg(nmod_mat_entry(R, i, k), A->mod), A->mod);
+        }
+        else
+        {
+            nmod_mat_submul(B, B, R, S);
+        }
+
+        nmod_mat_swap(A, B);
+        m -= d;
+
+        nmod_mat_clear(B);
+        nmod_mat_clear(R);
+        nmod_mat_clear(S);
+    }
+
+    _nmod_vec_clear(v);
+    flint_free(pivots_nonpivots);
+    _perm_clear(P);
+    nmod_mat_clear(K);
+    nmod_mat_clear(A);
+    nmod_poly_clear(f);
+
+    flint_randclear(state);
+}
@@ -199,5 +199,36 @@ void nmod_mat_minpoly_with_gens(nmod_poly_t p, const nmod_mat_t X, ulong * P)
 
 void nmod_mat_minpoly(nmod_poly_t p, const nmod_mat_t X)
 {
+   slong n = X->r, i;
+
+   /*
+      If a random vector has a Krylov space of full dimension, the minimal
+      polynomial equals the characteristic polynomial and is the minimal
+      polynomial of the vector. This is the generic case.
+   */
+   if (n >= NMOD_MAT_MINPOLY_KRYLOV_CUTOFF && X->r == X->c)
+   {
+      flint_rand_t state;
+      nmod_mat_t K;
+      mp_ptr v;
+      slong d;
+
+      flint_randinit(state);
+      nmod_mat_init(K, 0, 0, X->mod.n);
+      v = _nmod_vec_init(n);
+
+      for (i = 0; i < n; i++)
+         v[i] = n_randint(state, X->mod.n);
+
+      d = _nmod_mat_minpoly_vec(p, K, X, v);
+
+      _nmod_vec_clear(v);
+      nmod_mat_clear(K);
+      flint_randclear(state);
+
+      if (d == n)
+         return;
+   }
+
    nmod_mat_minpoly_with_gens(p, X, NULL);
 }
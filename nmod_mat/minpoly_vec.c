@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "nmod_poly.h"
+#include "perm.h"
+
+/*
+    Set f to the minimal polynomial of the vector v with respect to the
+    square matrix A, i.e. the monic relation satisfied by the first iterate
+    A^d v depending on v, A v, ..., A^(d-1) v. The latter are stored as
+    the rows of K, which is reinitialised to be d x m, and d is returned.
+
+    Iterates are generated in batches of doubling length so that the first
+    dependency is found with a few calls to rref rather than one elimination
+    step per vector, while computing at most twice as many as needed.
+*/
+slong
+_nmod_mat_minpoly_vec(nmod_poly_t f, nmod_mat_t K,
+                                             const nmod_mat_t A, mp_srcptr v)
+{
+    slong m = A->r, c, c_old, i, j, rank, d;
+    slong * pivots_nonpivots, * P;
+    mp_ptr it;
+    int nlimbs;
+    nmod_mat_t T;
+
+    nlimbs = _nmod_vec_dot_bound_limbs(m, A->mod);
+
+    /* iterate j is it + j*m */
+    it = flint_malloc(2*m*sizeof(mp_limb_t));
+    _nmod_vec_set(it, v, m);
+
+    pivots_nonpivots = flint_malloc((m + 1)*sizeof(slong));
+    P = _perm_init(m);
+
+    c_old = 1;
+    for (c = 2; ; c = FLINT_MIN(2*c, m + 1))
+    {
+        if (c > 2)
+            it = flint_realloc(it, c*m*sizeof(mp_limb_t));
+
+        for (j = c_old; j < c; j++)
+            for (i = 0; i < m; i++)
+                it[j*m + i] = _nmod_vec_dot(A->rows[i], it + (j - 1)*m, m,
+                                                            A->mod, nlimbs);
+        c_old = c;
+
+        nmod_mat_init(T, m, c, A->mod.n);
+        for (j = 0; j < c; j++)
+            for (i = 0; i < m; i++)
+                nmod_mat_entry(T, i, j) = it[j*m + i];
+
+        rank = _nmod_mat_rref(T, pivots_nonpivots, P);
+
+        if (rank < c)
+            break;
+
+        nmod_mat_clear(T);
+    }
+
+    /* the first dependent iterate in terms of the ones before it */
+    d = pivots_nonpivots[rank];
+
+    nmod_poly_fit_length(f, d + 1);
+    for (j = 0; j < d; j++)
+        f->coeffs[j] = nmod_neg(nmod_mat_entry(T, j, d), A->mod);
+    f->coeffs[d] = 1;
+    _nmod_poly_set_length(f, d + 1);
+
+    nmod_mat_clear(K);
+    nmod_mat_init(K, d, m, A->mod.n);
+    for (j = 0; j < d; j++)
+        _nmod_vec_set(K->rows[j], it + j*m, m);
+
+    nmod_mat_clear(T);
+    flint_free(it);
+    flint_free(pivots_nonpivots);
+    _perm_clear(P);
+
+    return d;
+}
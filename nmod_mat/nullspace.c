@@ -17,64 +17,36 @@
 slong
 nmod_mat_nullspace(nmod_mat_t X, const nmod_mat_t A)
 {
-    slong i, j, k, m, n, rank, nullity;
-    slong * p;
-    slong * pivots;
-    slong * nonpivots;
+    slong i, j, m, n, rank, nullity;
+    slong * pivots, * nonpivots, * P;
     nmod_mat_t tmp;
 
     m = A->r;
     n = A->c;
 
-    p = flint_malloc(sizeof(slong) * FLINT_MAX(m, n));
+    pivots = flint_malloc(sizeof(slong) * n);
+    P = flint_malloc(sizeof(slong) * m);
 
     nmod_mat_init_set(tmp, A);
-    rank = nmod_mat_rref(tmp);
+    rank = _nmod_mat_rref(tmp, pivots, P);
     nullity = n - rank;
+    nonpivots = pivots + rank;
 
     nmod_mat_zero(X);
 
-    if (rank == 0)
+    for (i = 0; i < nullity; i++)
     {
-        for (i = 0; i < nullity; i++)
-            nmod_mat_entry(X, i, i) = UWORD(1);
-    }
-    else if (nullity)
-    {
-        pivots = p;            /* length = rank */
-        nonpivots = p + rank;  /* length = nullity */
-
-        for (i = j = k = 0; i < rank; i++)
-        {
-            while (nmod_mat_entry(tmp, i, j) == UWORD(0))
-            {
-                nonpivots[k] = j;
-                k++;
-                j++;
-            }
-            pivots[i] = j;
-            j++;
-        }
-        while (k < nullity)
+        for (j = 0; j < rank; j++)
         {
-            nonpivots[k] = j;
-            k++;
-            j++;
+            mp_limb_t c = nmod_mat_entry(tmp, j, nonpivots[i]);
+            nmod_mat_entry(X, pivots[j], i) = nmod_neg(c, A->mod);
         }
 
-        for (i = 0; i < nullity; i++)
-        {
-            for (j = 0; j < rank; j++)
-            {
-                mp_limb_t c = nmod_mat_entry(tmp, j, nonpivots[i]);
-                nmod_mat_entry(X, pivots[j], i) = nmod_neg(c, A->mod);
-            }
-
-            nmod_mat_entry(X, nonpivots[i], i) = UWORD(1);
-        }
+        nmod_mat_entry(X, nonpivots[i], i) = UWORD(1);
     }
 
-    flint_free(p);
+    flint_free(pivots);
+    flint_free(P);
     nmod_mat_clear(tmp);
 
     return nullity;
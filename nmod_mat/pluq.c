@@ -0,0 +1,21 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdlib.h>
+#include "flint.h"
+#include "nmod_mat.h"
+
+slong
+nmod_mat_pluq(slong * P, slong * Q, nmod_mat_t A)
+{
+    return nmod_mat_pluq_recursive(P, Q, A);
+}
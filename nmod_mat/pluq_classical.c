@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdlib.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+
+slong
+nmod_mat_pluq_classical(slong * P, slong * Q, nmod_mat_t A)
+{
+    mp_limb_t d, e, ** a;
+    mp_ptr t;
+    nmod_t mod;
+    slong i, j, k, m, n, rank, nonpivots;
+
+    m = A->r;
+    n = A->c;
+    a = A->rows;
+    mod = A->mod;
+
+    for (i = 0; i < m; i++)
+        P[i] = i;
+
+    rank = nonpivots = 0;
+
+    /*
+        Pivots are written to Q from the front, in increasing order, and
+        nonpivots to the back, in decreasing order, then reversed.
+    */
+    for (j = 0; j < n; j++)
+    {
+        for (i = rank; i < m && a[i][j] == 0; i++) ;
+
+        if (i == m)
+        {
+            Q[n - 1 - nonpivots] = j;
+            nonpivots++;
+            continue;
+        }
+
+        if (i != rank)
+        {
+            t = a[i];
+            a[i] = a[rank];
+            a[rank] = t;
+
+            k = P[i];
+            P[i] = P[rank];
+            P[rank] = k;
+        }
+
+        d = n_invmod(a[rank][j], mod.n);
+
+        for (i = rank + 1; i < m; i++)
+        {
+            if (a[i][j] == 0)
+                continue;
+
+            e = n_mulmod2_preinv(a[i][j], d, mod.n, mod.ninv);
+            a[i][j] = e;
+            if (j + 1 < n)
+                _nmod_vec_scalar_addmul_nmod(a[i] + j + 1, a[rank] + j + 1,
+                                            n - j - 1, nmod_neg(e, mod), mod);
+        }
+
+        Q[rank] = j;
+        rank++;
+    }
+
+    for (i = 0; i < nonpivots/2; i++)
+    {
+        k = Q[rank + i];
+        Q[rank + i] = Q[n - 1 - i];
+        Q[n - 1 - i] = k;
+    }
+
+    /* move the pivot columns to the front */
+    if (rank != 0 && rank != n)
+    {
+        t = _nmod_vec_init(n);
+
+        for (i = 0; i < m; i++)
+        {
+            for (j = 0; j < n; j++)
+                t[j] = a[i][Q[j]];
+            _nmod_vec_set(a[i], t, n);
+        }
+
+        _nmod_vec_clear(t);
+    }
+
+    return rank;
+}
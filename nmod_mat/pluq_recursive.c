@@ -0,0 +1,239 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "thread_pool.h"
+
+static void
+_apply_permutation(slong * AP, nmod_mat_t A, const slong * P,
+                                                       slong n, slong offset)
+{
+    if (n != 0)
+    {
+        mp_ptr * Atmp;
+        slong * APtmp;
+        slong i;
+
+        Atmp = flint_malloc(sizeof(mp_ptr) * n);
+        APtmp = flint_malloc(sizeof(slong) * n);
+
+        for (i = 0; i < n; i++) Atmp[i] = A->rows[P[i] + offset];
+        for (i = 0; i < n; i++) A->rows[i + offset] = Atmp[i];
+
+        for (i = 0; i < n; i++) APtmp[i] = AP[P[i] + offset];
+        for (i = 0; i < n; i++) AP[i + offset] = APtmp[i];
+
+        flint_free(Atmp);
+        flint_free(APtmp);
+    }
+}
+
+/*
+    The block update A01 = L00^-1 A01, A11 = A11 - A10 A01 is independent
+    for each column of A01 and A11, so threads take vertical strips.
+*/
+typedef struct
+{
+    const nmod_mat_struct * A00;
+    const nmod_mat_struct * A10;
+    nmod_mat_struct * A01;
+    nmod_mat_struct * A11;
+    slong c1, c2;
+}
+_update_arg_struct;
+
+static void
+_update_worker(void * varg)
+{
+    _update_arg_struct * arg = (_update_arg_struct *) varg;
+    nmod_mat_t B01, B11;
+
+    if (arg->c1 >= arg->c2)
+        return;
+
+    nmod_mat_window_init(B01, arg->A01, 0, arg->c1, arg->A01->r, arg->c2);
+    nmod_mat_window_init(B11, arg->A11, 0, arg->c1, arg->A11->r, arg->c2);
+
+    nmod_mat_solve_tril(B01, arg->A00, B01, 1);
+    if (B11->r != 0)
+        nmod_mat_submul(B11, B11, arg->A10, B01);
+
+    nmod_mat_window_clear(B01);
+    nmod_mat_window_clear(B11);
+}
+
+static void
+_block_update(const nmod_mat_t A00, const nmod_mat_t A10,
+                                             nmod_mat_t A01, nmod_mat_t A11)
+{
+    slong i, n, thread_limit, num_handles;
+    thread_pool_handle * handles;
+    _update_arg_struct * args;
+
+    n = A01->c;
+
+    thread_limit = flint_get_num_threads();
+    thread_limit = FLINT_MIN(thread_limit, n/NMOD_MAT_PLUQ_THREADED_COLS);
+    if (A01->r*(A01->r + A11->r)*n < NMOD_MAT_PLUQ_THREADED_CUTOFF)
+        thread_limit = 1;
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized && thread_limit > 1)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    args = (_update_arg_struct *) flint_malloc((num_handles + 1)
+                                                 *sizeof(_update_arg_struct));
+
+    for (i = 0; i <= num_handles; i++)
+    {
+        args[i].A00 = A00;
+        args[i].A10 = A10;
+        args[i].A01 = A01;
+        args[i].A11 = A11;
+        args[i].c1 = n*i/(num_handles + 1);
+        args[i].c2 = n*(i + 1)/(num_handles + 1);
+    }
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                     _update_worker, &args[i]);
+
+    _update_worker(&args[num_handles]);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wait(global_thread_pool, handles[i]);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles)
+        flint_free(handles);
+
+    flint_free(args);
+}
+
+/*
+    Split the columns in halves [A0 | A1]. Eliminate A0 recursively, update
+    the Schur complement of its pivot block in A1 and eliminate that
+    recursively. The pivot columns found in A1 are then rotated in front
+    of the nonpivot columns of A0. Rank deficient blocks simply yield
+    smaller pivot blocks, so the work stays in matrix multiplication.
+*/
+slong
+nmod_mat_pluq_recursive(slong * P, slong * Q, nmod_mat_t A)
+{
+    slong i, m, n, n1, r1, r2;
+    slong * P1, * Q1;
+    nmod_mat_t A0, A00, A01, A10, A11;
+
+    m = A->r;
+    n = A->c;
+
+    if (m < NMOD_MAT_PLUQ_RECURSIVE_CUTOFF || n < NMOD_MAT_PLUQ_RECURSIVE_CUTOFF)
+        return nmod_mat_pluq_classical(P, Q, A);
+
+    n1 = n/2;
+
+    for (i = 0; i < m; i++)
+        P[i] = i;
+
+    P1 = flint_malloc(sizeof(slong) * m);
+    Q1 = flint_malloc(sizeof(slong) * (n - n1));
+
+    nmod_mat_window_init(A0, A, 0, 0, m, n1);
+    r1 = nmod_mat_pluq(P1, Q, A0);
+    nmod_mat_window_clear(A0);
+
+    if (r1 != 0)
+        _apply_permutation(P, A, P1, m, 0);
+
+    nmod_mat_window_init(A00, A, 0, 0, r1, r1);
+    nmod_mat_window_init(A10, A, r1, 0, m, r1);
+    nmod_mat_window_init(A01, A, 0, n1, r1, n);
+    nmod_mat_window_init(A11, A, r1, n1, m, n);
+
+    if (r1 != 0)
+        _block_update(A00, A10, A01, A11);
+
+    r2 = nmod_mat_pluq(P1, Q1, A11);
+
+    _apply_permutation(P, A, P1, m - r1, r1);
+
+    for (i = 0; i < n - n1; i++)
+        Q[n1 + i] = n1 + Q1[i];
+
+    /* the rows of U above A11 see the column permutation of A11 */
+    if (r1 != 0 && r2 != 0)
+    {
+        slong j;
+        mp_ptr t = _nmod_vec_init(n - n1);
+
+        for (i = 0; i < r1; i++)
+        {
+            mp_ptr row = A->rows[i] + n1;
+            for (j = 0; j < n - n1; j++)
+                t[j] = row[Q1[j]];
+            _nmod_vec_set(row, t, n - n1);
+        }
+
+        _nmod_vec_clear(t);
+    }
+
+    /* swap the column blocks [r1, n1) and [n1, n1 + r2) */
+    if (r1 != n1 && r2 != 0)
+    {
+        mp_ptr t = _nmod_vec_init(n1 - r1);
+
+        for (i = 0; i < m; i++)
+        {
+            mp_ptr row = A->rows[i];
+            _nmod_vec_set(t, row + r1, n1 - r1);
+            memmove(row + r1, row + n1, r2*sizeof(mp_limb_t));
+            _nmod_vec_set(row + r1 + r2, t, n1 - r1);
+        }
+
+        for (i = 0; i < n1 - r1; i++)
+            Q1[i] = Q[r1 + i];
+        memmove(Q + r1, Q + n1, r2*sizeof(slong));
+        for (i = 0; i < n1 - r1; i++)
+            Q[r1 + r2 + i] = Q1[i];
+
+        _nmod_vec_clear(t);
+    }
+
+    nmod_mat_window_clear(A00);
+    nmod_mat_window_clear(A01);
+    nmod_mat_window_clear(A10);
+    nmod_mat_window_clear(A11);
+
+    flint_free(P1);
+    flint_free(Q1);
+
+    return r1 + r2;
+}
@@ -20,7 +20,7 @@ slong
 nmod_mat_rank(const nmod_mat_t A)
 {
     slong m, n, rank;
-    slong * perm;
+    slong * P, * Q;
     nmod_mat_t tmp;
 
     m = A->r;
@@ -30,11 +30,13 @@ nmod_mat_rank(const nmod_mat_t A)
         return 0;
 
     nmod_mat_init_set(tmp, A);
-    perm = flint_malloc(sizeof(slong) * m);
+    P = flint_malloc(sizeof(slong) * m);
+    Q = flint_malloc(sizeof(slong) * n);
 
-    rank = nmod_mat_lu(perm, tmp, 0);
+    rank = nmod_mat_pluq(P, Q, tmp);
 
-    flint_free(perm);
+    flint_free(P);
+    flint_free(Q);
     nmod_mat_clear(tmp);
     return rank;
 }
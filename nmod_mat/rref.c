@@ -12,94 +12,53 @@
 #include <stdlib.h>
 #include <gmp.h>
 #include "flint.h"
+#include "nmod_vec.h"
 #include "nmod_mat.h"
 #include "perm.h"
 
+/*
+    With P A Q = L [U | V] and U upper triangular, the rows of A span those
+    of [I | U^-1 V] Q^T. The pivot columns found by nmod_mat_pluq are the
+    column rank profile of A in increasing order, so this is the rref.
+*/
 slong
 _nmod_mat_rref(nmod_mat_t A, slong * pivots_nonpivots, slong * P)
 {
-    slong i, j, k, n, rank;
-    slong * pivots;
-    slong * nonpivots;
-
+    slong i, j, m, n, rank;
     nmod_mat_t U, V;
 
+    m = A->r;
     n = A->c;
 
-    rank = nmod_mat_lu(P, A, 0);
+    rank = nmod_mat_pluq(P, pivots_nonpivots, A);
 
     if (rank == 0)
-    {
-        for (i = 0; i < n; i++)
-            pivots_nonpivots[i] = i;
         return rank;
-    }
 
-    /* Clear L */
-    for (i = 0; i < A->r; i++)
-        for (j = 0; j < FLINT_MIN(i, rank); j++)
-            nmod_mat_entry(A, i, j) = UWORD(0);
-
-    /* We now reorder U to proper upper triangular form U | V
-       with U full-rank triangular, set V = U^(-1) V, and then
-       put the column back in the original order.
-
-       An improvement for some matrices would be to compress V by
-       discarding columns containing nothing but zeros. */
-
-    nmod_mat_init(U, rank, rank, A->mod.n);
     nmod_mat_init(V, rank, n - rank, A->mod.n);
 
-    pivots = pivots_nonpivots;
-    nonpivots = pivots_nonpivots + rank;
-
-    for (i = j = k = 0; i < rank; i++)
+    if (rank != n)
     {
-        while (nmod_mat_entry(A, i, j) == UWORD(0))
-        {
-            nonpivots[k] = j;
-            k++;
-            j++;
-        }
-        pivots[i] = j;
-        j++;
-    }
-    while (k < n - rank)
-    {
-        nonpivots[k] = j;
-        k++;
-        j++;
-    }
+        for (i = 0; i < rank; i++)
+            _nmod_vec_set(V->rows[i], A->rows[i] + rank, n - rank);
 
-    for (i = 0; i < rank; i++)
-    {
-        for (j = 0; j <= i; j++)
-            nmod_mat_entry(U, j, i) = nmod_mat_entry(A, j, pivots[i]);
+        nmod_mat_window_init(U, A, 0, 0, rank, rank);
+        nmod_mat_solve_triu(V, U, V, 0);
+        nmod_mat_window_clear(U);
     }
 
-    for (i = 0; i < n - rank; i++)
-    {
-        for (j = 0; j < rank; j++)
-            nmod_mat_entry(V, j, i) = nmod_mat_entry(A, j, nonpivots[i]);
-    }
-
-    nmod_mat_solve_triu(V, U, V, 0);
+    for (i = 0; i < m; i++)
+        _nmod_vec_zero(A->rows[i], n);
 
-    /* Clear pivot columns */
     for (i = 0; i < rank; i++)
     {
-        for (j = 0; j <= i; j++)
-            nmod_mat_entry(A, j, pivots[i]) = (i == j);
-    }
+        nmod_mat_entry(A, i, pivots_nonpivots[i]) = UWORD(1);
 
-    /* Write back the actual content */
-    for (i = 0; i < n - rank; i++)
-    {
-        for (j = 0; j < rank; j++)
-            nmod_mat_entry(A, j, nonpivots[i]) = nmod_mat_entry(V, j, i);
+        for (j = 0; j < n - rank; j++)
+            nmod_mat_entry(A, i, pivots_nonpivots[rank + j]) =
+                                                   nmod_mat_entry(V, i, j);
     }
 
-    nmod_mat_clear(U);
     nmod_mat_clear(V);
 
     return rank;
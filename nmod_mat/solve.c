@@ -20,7 +20,7 @@
 int
 nmod_mat_solve(nmod_mat_t X, const nmod_mat_t A, const nmod_mat_t B)
 {
-    slong i, rank, *perm;
+    slong i, rank, * P, * Q;
     nmod_mat_t LU;
     int result;
 
@@ -28,22 +28,28 @@ nmod_mat_solve(nmod_mat_t X, const nmod_mat_t A, const nmod_mat_t B)
         return 1;
 
     nmod_mat_init_set(LU, A);
-    perm = flint_malloc(sizeof(slong) * A->r);
-    for (i = 0; i < A->r; i++)
-        perm[i] = i;
+    P = flint_malloc(sizeof(slong) * A->r);
+    Q = flint_malloc(sizeof(slong) * A->c);
 
-    rank = nmod_mat_lu(perm, LU, 1);
+    rank = nmod_mat_pluq(P, Q, LU);
 
     if (rank == A->r)
     {
-        nmod_mat_t PB;
+        nmod_mat_t PB, Y;
+
+        /* P A Q = L U, so X = Q U^-1 L^-1 P B */
         nmod_mat_window_init(PB, B, 0, 0, B->r, B->c);
         for (i = 0; i < A->r; i++)
-            PB->rows[i] = B->rows[perm[i]];
+            PB->rows[i] = B->rows[P[i]];
+
+        nmod_mat_init(Y, B->r, B->c, A->mod.n);
+        nmod_mat_solve_tril(Y, LU, PB, 1);
+        nmod_mat_solve_triu(Y, LU, Y, 0);
 
-        nmod_mat_solve_tril(X, LU, PB, 1);
-        nmod_mat_solve_triu(X, LU, X, 0);
+        for (i = 0; i < A->r; i++)
+            _nmod_vec_set(X->rows[Q[i]], Y->rows[i], B->c);
 
+        nmod_mat_clear(Y);
         nmod_mat_window_clear(PB);
         result = 1;
     }
@@ -53,7 +59,8 @@ nmod_mat_solve(nmod_mat_t X, const nmod_mat_t A, const nmod_mat_t B)
     }
 
     nmod_mat_clear(LU);
-    flint_free(perm);
+    flint_free(P);
+    flint_free(Q);
 
     return result;
 }
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_mat.h"
+#include "nmod_poly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    slong n, rep, i, j, b;
+    ulong mod;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("charpoly_krylov....");
+    fflush(stdout);
+
+    for (rep = 0; rep < 1000 * flint_test_multiplier(); rep++)
+    {
+        nmod_mat_t A, B;
+        nmod_poly_t f, g;
+
+        n = n_randint(state, 40);
+
+        if (n_randint(state, 2))
+            mod = n_randprime(state, 2 + n_randint(state, 5), 0);
+        else
+            mod = n_randtest_prime(state, 0);
+
+        nmod_mat_init(A, n, n, mod);
+        nmod_mat_init(B, n, n, mod);
+        nmod_poly_init(f, mod);
+        nmod_poly_init(g, mod);
+
+        switch (n_randint(state, 3))
+        {
+            case 0:
+                nmod_mat_randtest(A, state);
+                break;
+            case 1:
+                /* few distinct eigenvalues, many Jordan and companion blocks */
+                b = 1 + n_randint(state, 4);
+                for (i = 0; i < n; i++)
+                {
+                    nmod_mat_entry(A, i, i) = n_randint(state, b);
+                    if (i + 1 < n && n_randint(state, 2))
+                        nmod_mat_entry(A, i, i + 1) = 1;
+                }
+                for (i = 0; i < 3*n; i++)
+                    nmod_mat_similarity(A, n_randint(state, n),
+                                                        n_randint(state, mod));
+                break;
+            default:
+                /* repeated columns, so low rank */
+                b = 1 + n_randint(state, n + 1);
+                for (i = 0; i < n; i++)
+                    for (j = 0; j < n; j++)
+                        nmod_mat_entry(A, i, j) = (j < b) ?
+                            n_randint(state, mod) : nmod_mat_entry(A, i, j % b);
+                break;
+        }
+
+        nmod_mat_set(B, A);
+        nmod_mat_charpoly_danilevsky(f, B);
+        nmod_mat_charpoly_krylov(g, A);
+
+        if (!nmod_poly_equal(f, g))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("Matrix A:\n"), nmod_mat_print_pretty(A), flint_printf("\n");
+            flint_printf("danilevsky = "), nmod_poly_print_pretty(f, "X"), flint_printf("\n");
+            flint_printf("krylov = "), nmod_poly_print_pretty(g, "X"), flint_printf("\n");
+            abort();
+        }
+
+        nmod_mat_clear(A);
+        nmod_mat_clear(B);
+        nmod_poly_clear(f);
+        nmod_poly_clear(g);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+    
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -115,6 +115,54 @@ main(void)
         nmod_poly_clear(g);
     }
 
+    /* sizes where the Krylov fast path applies */
+    for (rep = 0; rep < 5 * flint_test_multiplier(); rep++)
+    {
+        nmod_mat_t A;
+        nmod_poly_t f, g;
+
+        n = NMOD_MAT_MINPOLY_KRYLOV_CUTOFF + n_randint(state, 20);
+
+        if (n_randint(state, 2))
+            mod = n_randprime(state, 2 + n_randint(state, 5), 0);
+        else
+            mod = n_randtest_prime(state, 0);
+
+        nmod_mat_init(A, n, n, mod);
+        nmod_poly_init(f, mod);
+        nmod_poly_init(g, mod);
+
+        nmod_mat_randtest(A, state);
+
+        if (n_randint(state, 2))
+        {
+           for (i = 0; i < n/2; i++)
+           {
+              for (j = 0; j < n/2; j++)
+              {
+                 A->rows[i + n/2][j] = 0;
+                 A->rows[i][j + n/2] = 0;
+                 A->rows[i + n/2][j + n/2] = A->rows[i][j];
+              }
+           }
+        }
+
+        nmod_mat_minpoly(f, A);
+        nmod_mat_minpoly_with_gens(g, A, NULL);
+
+        if (!nmod_poly_equal(f, g))
+        {
+            flint_printf("FAIL: minpoly(A) != minpoly_with_gens(A).\n");
+            flint_printf("mp(A) = "), nmod_poly_print_pretty(f, "X"), flint_printf("\n");
+            flint_printf("mp_with_gens(A) = "), nmod_poly_print_pretty(g, "X"), flint_printf("\n");
+            abort();
+        }
+
+        nmod_mat_clear(A);
+        nmod_poly_clear(f);
+        nmod_poly_clear(g);
+    }
+
     FLINT_TEST_CLEANUP(state);
     
     flint_printf("PASS\n");
@@ -0,0 +1,204 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "ulong_extras.h"
+
+void check(const slong * P, const slong * Q, const nmod_mat_t LU,
+                                            const nmod_mat_t A, slong rank)
+{
+    nmod_mat_t B, L, U, PAQ;
+    slong m, n, i, j;
+
+    m = A->r;
+    n = A->c;
+
+    nmod_mat_init(B, m, n, A->mod.n);
+    nmod_mat_init(L, m, rank, A->mod.n);
+    nmod_mat_init(U, rank, n, A->mod.n);
+    nmod_mat_init(PAQ, m, n, A->mod.n);
+
+    for (i = rank; i < m; i++)
+    {
+        for (j = rank; j < n; j++)
+        {
+            if (nmod_mat_entry(LU, i, j) != 0)
+            {
+                flint_printf("FAIL: wrong shape!\n");
+                abort();
+            }
+        }
+    }
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < FLINT_MIN(i, rank); j++)
+            nmod_mat_entry(L, i, j) = nmod_mat_entry(LU, i, j);
+        if (i < rank)
+            nmod_mat_entry(L, i, i) = UWORD(1);
+    }
+
+    for (i = 0; i < rank; i++)
+    {
+        if (nmod_mat_entry(LU, i, i) == 0)
+        {
+            flint_printf("FAIL: zero pivot!\n");
+            abort();
+        }
+
+        for (j = i; j < n; j++)
+            nmod_mat_entry(U, i, j) = nmod_mat_entry(LU, i, j);
+    }
+
+    for (i = 0; i < m; i++)
+        for (j = 0; j < n; j++)
+            nmod_mat_entry(PAQ, i, j) = nmod_mat_entry(A, P[i], Q[j]);
+
+    nmod_mat_mul(B, L, U);
+
+    if (!nmod_mat_equal(PAQ, B))
+    {
+        flint_printf("FAIL: PAQ != LU\n");
+        flint_printf("A:\n");
+        nmod_mat_print_pretty(A);
+        flint_printf("LU:\n");
+        nmod_mat_print_pretty(LU);
+        abort();
+    }
+
+    /* the pivot columns are the column rank profile, in order */
+    if (n <= 40)
+    {
+        slong r, k = 0;
+        slong * perm = flint_malloc(sizeof(slong) * m);
+        nmod_mat_t W, C;
+
+        for (j = 0; j < n; j++)
+        {
+            nmod_mat_window_init(W, A, 0, 0, m, j + 1);
+            nmod_mat_init_set(C, W);
+            r = nmod_mat_lu(perm, C, 0);
+            nmod_mat_clear(C);
+            nmod_mat_window_clear(W);
+
+            if (r > k)
+            {
+                if (Q[k] != j)
+                {
+                    flint_printf("FAIL: wrong column rank profile!\n");
+                    abort();
+                }
+                k++;
+            }
+        }
+
+        flint_free(perm);
+    }
+
+    nmod_mat_clear(B);
+    nmod_mat_clear(L);
+    nmod_mat_clear(U);
+    nmod_mat_clear(PAQ);
+}
+
+int
+main(void)
+{
+    slong i;
+
+    FLINT_TEST_INIT(state);
+
+    flint_printf("pluq....");
+    fflush(stdout);
+
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        nmod_mat_t A, LU;
+        mp_limb_t mod;
+        slong m, n, r, d, rank;
+        slong * P, * Q;
+
+        if (i % 50 == 0)
+        {
+            flint_set_num_threads(n_randint(state, 4) + 1);
+            m = n_randint(state, 300);
+            n = n_randint(state, 300);
+        }
+        else
+        {
+            m = n_randint(state, 40);
+            n = n_randint(state, 40);
+        }
+
+        if (n_randint(state, 2))
+            mod = n_randtest_prime(state, 0);
+        else
+            mod = n_randprime(state, 2 + n_randint(state, 3), 0);
+
+        r = n_randint(state, FLINT_MIN(m, n) + 1);
+
+        nmod_mat_init(A, m, n, mod);
+        nmod_mat_randrank(A, state, r);
+
+        if (n_randint(state, 2))
+        {
+            d = n_randint(state, 2*m*n + 1);
+            nmod_mat_randops(A, d, state);
+        }
+
+        nmod_mat_init_set(LU, A);
+        P = flint_malloc(sizeof(slong) * m);
+        Q = flint_malloc(sizeof(slong) * n);
+
+        switch (n_randint(state, 3))
+        {
+            case 0:
+                rank = nmod_mat_pluq_classical(P, Q, LU);
+                break;
+            case 1:
+                rank = nmod_mat_pluq_recursive(P, Q, LU);
+                break;
+            default:
+                rank = nmod_mat_pluq(P, Q, LU);
+        }
+
+        if (r != rank)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("wrong rank!\n");
+            flint_printf("A:");
+            nmod_mat_print_pretty(A);
+            flint_printf("LU:");
+            nmod_mat_print_pretty(LU);
+            abort();
+        }
+
+        check(P, Q, LU, A, rank);
+
+        nmod_mat_clear(A);
+        nmod_mat_clear(LU);
+        flint_free(P);
+        flint_free(Q);
+
+        flint_set_num_threads(1);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -421,6 +421,21 @@ int nmod_mpoly_print_pretty(const nmod_mpoly_t A,
    return nmod_mpoly_fprint_pretty(stdout, A, x, ctx);
 }
 
+FLINT_DLL size_t nmod_mpoly_out_raw(FILE * file, const nmod_mpoly_t A,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL size_t nmod_mpoly_inp_raw(nmod_mpoly_t A, FILE * file,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL size_t nmod_mpoly_raw_window_init(nmod_mpoly_t A, const void * buf,
+                                      size_t size, const nmod_mpoly_ctx_t ctx);
+
+NMOD_MPOLY_INLINE
+void nmod_mpoly_raw_window_clear(nmod_mpoly_t A, const nmod_mpoly_ctx_t ctx)
+{
+   return;
+}
+
 
 /*  Basic manipulation *******************************************************/
 
@@ -650,6 +665,12 @@ FLINT_DLL void nmod_mpoly_sort_terms(nmod_mpoly_t A,
 FLINT_DLL void nmod_mpoly_combine_like_terms(nmod_mpoly_t A,
                                                    const nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL void nmod_mpoly_sort_terms_threaded(nmod_mpoly_t A,
+                               const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void nmod_mpoly_combine_like_terms_threaded(nmod_mpoly_t A,
+                               const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void nmod_mpoly_reverse(nmod_mpoly_t A, const nmod_mpoly_t B,
                                                    const nmod_mpoly_ctx_t ctx);
 
@@ -662,6 +683,18 @@ FLINT_DLL void _nmod_mpoly_radix_sort1(nmod_mpoly_t A, slong left, slong right,
 FLINT_DLL void _nmod_mpoly_radix_sort(nmod_mpoly_t A, slong left, slong right,
                                     flint_bitcnt_t pos, slong N, ulong * cmpmask);
 
+FLINT_DLL void _nmod_mpoly_radix_sort_bytes(mp_limb_t * Acoeff, ulong * Aexp,
+                       slong left, slong right, const slong * digits, slong k,
+                 slong ndigits, slong N, const ulong * cmpmask, slong * stack);
+
+FLINT_DLL void _nmod_mpoly_sort_terms_threaded(nmod_mpoly_t A,
+                                const nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _nmod_mpoly_combine_like_terms_threaded(nmod_mpoly_t A,
+                                const nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL void _nmod_mpoly_push_exp_ffmpz(nmod_mpoly_t A,
                                  const fmpz * exp, const nmod_mpoly_ctx_t ctx);
 
@@ -746,6 +779,17 @@ FLINT_DLL slong _nmod_mpoly_sub(ulong * coeff1,       ulong * exp1,
                     const ulong * coeff3, const ulong * exp3, slong len3,
                        slong N, const ulong * cmpmask, const nmodf_ctx_t fctx);
 
+FLINT_DLL void nmod_mpoly_sum(nmod_mpoly_t A, nmod_mpoly_struct * const * B,
+                                         slong n, const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void nmod_mpoly_sum_threaded(nmod_mpoly_t A,
+                                 nmod_mpoly_struct * const * B, slong n,
+                                const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void _nmod_mpoly_sum_threaded(nmod_mpoly_t A,
+           nmod_mpoly_struct * const * B, slong n, const nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 
 /* Scalar operations *********************************************************/
 
@@ -775,6 +819,46 @@ FLINT_DLL ulong nmod_mpoly_evaluate_all_ui(nmod_mpoly_t A,
 FLINT_DLL void nmod_mpoly_evaluate_one_ui(nmod_mpoly_t A, const nmod_mpoly_t B,
                              slong var, ulong val, const nmod_mpoly_ctx_t ctx);
 
+/*
+    A compiled evaluation plan holds a copy of a polynomial together with a
+    straight line program in Horner form for evaluating it. The program is
+    only valid if the exponents of the polynomial fit into a word.
+*/
+typedef struct
+{
+    nmod_mpoly_struct poly;
+    mpoly_slp_struct slp;
+    int compiled;
+} nmod_mpoly_eval_plan_struct;
+
+typedef nmod_mpoly_eval_plan_struct nmod_mpoly_eval_plan_t[1];
+
+/* number of points on which a plan is run at once */
+#define NMOD_MPOLY_EVAL_PLAN_BLOCK 32
+
+FLINT_DLL void nmod_mpoly_eval_plan_init(nmod_mpoly_eval_plan_t P,
+                              const nmod_mpoly_t A, const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void nmod_mpoly_eval_plan_clear(nmod_mpoly_eval_plan_t P,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL mp_limb_t nmod_mpoly_eval_plan_evaluate_ui(
+                           const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void nmod_mpoly_eval_plan_evaluate_vec_ui(mp_limb_t * ev,
+                           const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                                        slong num, const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void _nmod_mpoly_eval_plan_evaluate_vec_ui_threaded(mp_limb_t * ev,
+                           const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                                         slong num, const nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void nmod_mpoly_eval_plan_evaluate_vec_ui_threaded(mp_limb_t * ev,
+                           const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                    slong num, const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 FLINT_DLL void nmod_mpoly_compose_nmod_poly(nmod_poly_t A,
                         const nmod_mpoly_t B, nmod_poly_struct * const * C,
                                                    const nmod_mpoly_ctx_t ctx);
@@ -783,6 +867,20 @@ FLINT_DLL void nmod_mpoly_compose_nmod_mpoly(nmod_mpoly_t A,
                     const nmod_mpoly_t B, nmod_mpoly_struct * const * C,
                     const nmod_mpoly_ctx_t ctxB, const nmod_mpoly_ctx_t ctxAC);
 
+FLINT_DLL void _nmod_mpoly_compose_nmod_mpoly(nmod_mpoly_t A,
+                   const nmod_mpoly_t B, nmod_mpoly_struct * const * C,
+                    const nmod_mpoly_ctx_t ctxB, const nmod_mpoly_ctx_t ctxAC);
+
+FLINT_DLL void nmod_mpoly_compose_nmod_mpoly_threaded(nmod_mpoly_t A,
+                   const nmod_mpoly_t B, nmod_mpoly_struct * const * C,
+                   const nmod_mpoly_ctx_t ctxB, const nmod_mpoly_ctx_t ctxAC,
+                                                           slong thread_limit);
+
+FLINT_DLL void _nmod_mpoly_compose_nmod_mpoly_threaded(nmod_mpoly_t A,
+                   const nmod_mpoly_t B, nmod_mpoly_struct * const * C,
+                   const nmod_mpoly_ctx_t ctxB, const nmod_mpoly_ctx_t ctxAC,
+                        const thread_pool_handle * handles, slong num_handles);
+
 
 /* Multiplication ************************************************************/
 
@@ -800,6 +898,13 @@ FLINT_DLL void nmod_mpoly_mul_heap_threaded(nmod_mpoly_t A,
        const nmod_mpoly_t B, const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx,
                                                            slong thread_limit);
 
+FLINT_DLL void nmod_mpoly_mul_hash(nmod_mpoly_t A,
+       const nmod_mpoly_t B, const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void nmod_mpoly_mul_hash_threaded(nmod_mpoly_t A,
+       const nmod_mpoly_t B, const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
 FLINT_DLL int nmod_mpoly_mul_array(nmod_mpoly_t A,
        const nmod_mpoly_t B, const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx);
 
@@ -810,6 +915,10 @@ FLINT_DLL int nmod_mpoly_mul_array_threaded(nmod_mpoly_t A,
 FLINT_DLL int nmod_mpoly_mul_dense(nmod_mpoly_t A,
        const nmod_mpoly_t B, const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL int nmod_mpoly_mul_dense_threaded(nmod_mpoly_t A,
+       const nmod_mpoly_t B, const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
 FLINT_DLL slong _nmod_mpoly_mul_johnson(mp_limb_t ** coeff1, ulong ** exp1, slong * alloc,
                  const mp_limb_t * coeff2, const ulong * exp2, slong len2,
                  const mp_limb_t * coeff3, const ulong * exp3, slong len3,
@@ -825,6 +934,29 @@ FLINT_DLL void _nmod_mpoly_mul_heap_threaded_maxfields(nmod_mpoly_t A,
            const nmod_mpoly_t C, fmpz * maxCfields, const nmod_mpoly_ctx_t ctx,
                         const thread_pool_handle * handles, slong num_handles);
 
+FLINT_DLL slong _nmod_mpoly_mul_hash(mp_limb_t ** A_coeff, ulong ** A_exp,
+                 slong * A_alloc,
+                 const mp_limb_t * Bcoeff, const ulong * Bexp, slong Blen,
+                 const mp_limb_t * Ccoeff, const ulong * Cexp, slong Clen,
+                          flint_bitcnt_t bits, slong N, slong which, slong num,
+                                                     const nmodf_ctx_t fctx);
+
+FLINT_DLL void _nmod_mpoly_mul_hash_maxfields(nmod_mpoly_t A,
+                                 const nmod_mpoly_t B, fmpz * maxBfields,
+                                 const nmod_mpoly_t C, fmpz * maxCfields,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void _nmod_mpoly_mul_hash_threaded(nmod_mpoly_t A,
+                 const mp_limb_t * Bcoeff, const ulong * Bexp, slong Blen,
+                 const mp_limb_t * Ccoeff, const ulong * Cexp, slong Clen,
+                 flint_bitcnt_t bits, slong N, const nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void _nmod_mpoly_mul_hash_threaded_maxfields(nmod_mpoly_t A,
+           const nmod_mpoly_t B, fmpz * maxBfields,
+           const nmod_mpoly_t C, fmpz * maxCfields, const nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL int _nmod_mpoly_mul_array_DEG(nmod_mpoly_t A,
                                  const nmod_mpoly_t B, fmpz * maxBfields,
                                  const nmod_mpoly_t C, fmpz * maxCfields,
@@ -850,6 +982,19 @@ FLINT_DLL int _nmod_mpoly_mul_dense(nmod_mpoly_t P,
                                  const nmod_mpoly_t B, fmpz * maxBfields,
                                                    const nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL int _nmod_mpoly_mul_dense_threaded(nmod_mpoly_t P,
+                                 const nmod_mpoly_t A, fmpz * maxAfields,
+                                 const nmod_mpoly_t B, fmpz * maxBfields,
+                                                    const nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void nmod_mpoly_product(nmod_mpoly_t A,
+      nmod_mpoly_struct * const * B, slong n, const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void nmod_mpoly_product_threaded(nmod_mpoly_t A,
+                                 nmod_mpoly_struct * const * B, slong n,
+                                const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 /* Powering ******************************************************************/
 
 FLINT_DLL void nmod_mpoly_pow_fmpz(nmod_mpoly_t A, const nmod_mpoly_t B,
@@ -861,6 +1006,9 @@ FLINT_DLL void nmod_mpoly_pow_ui(nmod_mpoly_t A, const nmod_mpoly_t B,
 FLINT_DLL void nmod_mpoly_pow_rmul(nmod_mpoly_t A, const nmod_mpoly_t B,
                                           ulong k, const nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL void nmod_mpoly_pow_ui_threaded(nmod_mpoly_t A, const nmod_mpoly_t B,
+                        ulong k, const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
 
 /* Division ******************************************************************/
 
@@ -901,6 +1049,12 @@ FLINT_DLL slong _nmod_mpoly_divides_monagan_pearce(
                 const mp_limb_t * coeff3, const ulong * exp3, slong len3,
      flint_bitcnt_t bits, slong N, const ulong * cmpmask, const nmodf_ctx_t fctx);
 
+FLINT_DLL slong _nmod_mpoly_divides_monagan_pearce_varbits(
+                     mp_limb_t ** coeff1,      ulong ** exp1, slong * alloc,
+                const mp_limb_t * coeff2, const ulong * exp2, slong len2,
+                const mp_limb_t * coeff3, const ulong * exp3, slong len3,
+                             const mpoly_varbits_t V, const nmodf_ctx_t fctx);
+
 FLINT_DLL void nmod_mpoly_div_monagan_pearce(nmod_mpoly_t Q,
                                  const nmod_mpoly_t A, const nmod_mpoly_t B,
                                                    const nmod_mpoly_ctx_t ctx);
@@ -926,6 +1080,19 @@ nmod_mpoly_divrem_ideal_monagan_pearce(nmod_mpoly_struct ** q, nmod_mpoly_t r,
     const nmod_mpoly_t poly2, nmod_mpoly_struct * const * poly3, slong len,
                                                    const nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL void nmod_mpoly_divrem_heap_threaded(nmod_mpoly_t Q, nmod_mpoly_t R,
+       const nmod_mpoly_t A, const nmod_mpoly_t B, const nmod_mpoly_ctx_t ctx,
+                                                           slong thread_limit);
+
+FLINT_DLL void nmod_mpoly_divrem_ideal_heap_threaded(nmod_mpoly_struct ** Q,
+     nmod_mpoly_t R, const nmod_mpoly_t A, nmod_mpoly_struct * const * B,
+                     slong len, const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL void _nmod_mpoly_divrem_ideal_heap_threaded(nmod_mpoly_struct ** Q,
+     nmod_mpoly_t R, const nmod_mpoly_t A, nmod_mpoly_struct * const * B,
+                                        slong len, const nmod_mpoly_ctx_t ctx,
+                              thread_pool_handle * handles, slong num_handles);
+
 
 /* GCD ***********************************************************************/
 
@@ -1012,6 +1179,51 @@ typedef struct _nmod_mpoly_stripe_struct
 
 typedef nmod_mpoly_stripe_struct nmod_mpoly_stripe_t[1];
 
+/*
+    a thread safe mpoly supports three mutating operations
+    - init from an array of terms
+    - append an array of terms
+    - clear out contents to a normal mpoly
+*/
+typedef struct _nmod_mpoly_ts_struct
+{
+    mp_limb_t * volatile coeffs; /* this is coeff_array[idx] */
+    ulong * volatile exps;       /* this is exp_array[idx] */
+    volatile slong length;
+    slong alloc;
+    flint_bitcnt_t bits;
+    flint_bitcnt_t idx;
+    mp_limb_t * exp_array[FLINT_BITS];
+    ulong * coeff_array[FLINT_BITS];
+} nmod_mpoly_ts_struct;
+
+typedef nmod_mpoly_ts_struct nmod_mpoly_ts_t[1];
+
+FLINT_DLL void nmod_mpoly_ts_init(nmod_mpoly_ts_t A,
+                              mp_limb_t * Bcoeff, ulong * Bexp, slong Blen,
+                                                  flint_bitcnt_t bits, slong N);
+
+FLINT_DLL void nmod_mpoly_ts_clear(nmod_mpoly_ts_t A);
+
+FLINT_DLL void nmod_mpoly_ts_clear_poly(nmod_mpoly_t Q, nmod_mpoly_ts_t A);
+
+FLINT_DLL void nmod_mpoly_ts_append(nmod_mpoly_ts_t A,
+                        mp_limb_t * Bcoeff, ulong * Bexps, slong Blen, slong N);
+
+FLINT_DLL slong _nmod_mpoly_mulsub_stripe1(mp_limb_t ** A_coeff, ulong ** A_exp,
+                                                              slong * A_alloc,
+                 const mp_limb_t * Dcoeff, const ulong * Dexp, slong Dlen,
+                 const mp_limb_t * Bcoeff, const ulong * Bexp, slong Blen,
+                 const mp_limb_t * Ccoeff, const ulong * Cexp, slong Clen,
+                                                   const nmod_mpoly_stripe_t S);
+
+FLINT_DLL slong _nmod_mpoly_mulsub_stripe(mp_limb_t ** A_coeff, ulong ** A_exp,
+                                                              slong * A_alloc,
+                 const mp_limb_t * Dcoeff, const ulong * Dexp, slong Dlen,
+                 const mp_limb_t * Bcoeff, const ulong * Bexp, slong Blen,
+                 const mp_limb_t * Ccoeff, const ulong * Cexp, slong Clen,
+                                                   const nmod_mpoly_stripe_t S);
+
 
 /* Univariates ***************************************************************/
 
@@ -1242,6 +1454,25 @@ FLINT_DLL int nmod_mpoly_gcd_zippel(nmod_mpoly_t G,
                                 const nmod_mpoly_t A, const nmod_mpoly_t B,
                                                    const nmod_mpoly_ctx_t ctx);
 
+FLINT_DLL int nmod_mpoly_gcd_zippel_threaded(nmod_mpoly_t G,
+                                const nmod_mpoly_t A, const nmod_mpoly_t B,
+                               const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL int nmod_mpoly_gcd_berlekamp_massey(nmod_mpoly_t G,
+                                const nmod_mpoly_t A, const nmod_mpoly_t B,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL int nmod_mpoly_gcd_berlekamp_massey_threaded(nmod_mpoly_t G,
+                                const nmod_mpoly_t A, const nmod_mpoly_t B,
+                               const nmod_mpoly_ctx_t ctx, slong thread_limit);
+
+FLINT_DLL int _nmod_mpoly_gcd_berlekamp_massey(nmod_mpoly_t G,
+        flint_bitcnt_t Gbits, const nmod_mpoly_t A, const ulong * Ashift,
+                                    const nmod_mpoly_t B, const ulong * Bshift,
+              const ulong * Gshift, const ulong * Gstride, const slong * perm,
+                                           slong m, const nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 /* mpolyu ********************************************************************/
 
 FLINT_DLL void nmod_mpolyu_init(nmod_mpolyu_t A, flint_bitcnt_t bits,
@@ -1318,6 +1549,16 @@ FLINT_DLL int nmod_mpolyu_gcdm_zippel(nmod_mpolyu_t G, nmod_mpolyu_t A,
                nmod_mpolyu_t B, nmod_mpoly_ctx_t ctx, mpoly_zipinfo_t zinfo,
                                                        flint_rand_t randstate);
 
+FLINT_DLL int nmod_mpolyu_gcdm_zippel_threaded(nmod_mpolyu_t G,
+                  nmod_mpolyu_t A, nmod_mpolyu_t B, nmod_mpoly_ctx_t ctx,
+                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL int nmod_mpolyu_gcd_berlekamp_massey(nmod_mpolyu_t G,
+                  nmod_mpolyu_t A, nmod_mpolyu_t B, const nmod_mpoly_t Gamma,
+                                                   const nmod_mpoly_ctx_t ctx,
+                        const thread_pool_handle * handles, slong num_handles);
+
 NMOD_MPOLY_INLINE mp_limb_t nmod_mpolyu_leadcoeff(
                                    nmod_mpolyu_t A, const nmod_mpoly_ctx_t ctx)
 {
@@ -1518,11 +1759,36 @@ FLINT_DLL nmod_gcds_ret_t nmod_mpolyu_gcds_zippel(nmod_mpolyu_t G,
                                         slong var, const nmod_mpoly_ctx_t ctx,
                                      flint_rand_t randstate, slong * degbound);
 
+FLINT_DLL nmod_gcds_ret_t nmod_mpolyu_gcds_zippel_threaded(nmod_mpolyu_t G,
+                           nmod_mpolyu_t A, nmod_mpolyu_t B, nmod_mpolyu_t f,
+                                        slong var, const nmod_mpoly_ctx_t ctx,
+                                      flint_rand_t randstate, slong * degbound,
+                        const thread_pool_handle * handles, slong num_handles);
+
 FLINT_DLL int nmod_mpolyu_gcdp_zippel(nmod_mpolyu_t G,
                              nmod_mpolyu_t A, nmod_mpolyu_t B, slong var,
                             const nmod_mpoly_ctx_t ctx, mpoly_zipinfo_t zinfo,
                                                        flint_rand_t randstate);
 
+FLINT_DLL int nmod_mpolyu_gcdp_zippel_threaded(nmod_mpolyu_t G,
+                             nmod_mpolyu_t A, nmod_mpolyu_t B, slong var,
+                            const nmod_mpoly_ctx_t ctx, mpoly_zipinfo_t zinfo,
+                                                        flint_rand_t randstate,
+                        const thread_pool_handle * handles, slong num_handles);
+
+FLINT_DLL void nmod_mpolyu_evalsk(nmod_mpolyu_t A, nmod_mpolyu_t B,
+              slong entries, slong * offs, ulong * masks, mp_limb_t * powers,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL void nmod_mpolyu_mulsk(nmod_mpolyu_t A, nmod_mpolyu_t B,
+                                                   const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL int nmod_mpolyu_evalfromsk(nmod_poly_t e, nmod_mpolyu_t A,
+                                 nmod_mpolyu_t SK, const nmod_mpoly_ctx_t ctx);
+
+FLINT_DLL int nmod_vandsolve(mp_limb_t * x, mp_limb_t * a, mp_limb_t * b,
+                                                          slong n, nmod_t mod);
+
 /* gcd_helpers_eval_interp ***************************************************/
 
 FLINT_DLL void _nmod_poly_eval2_pow(
@@ -0,0 +1,204 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+/*
+    B is cut into blocks of consecutive terms, which are handed out to the
+    workers on demand. Consecutive terms share most of their leading
+    exponents, so the Horner form of each block still shares the powers of
+    the C[i] among its terms. Each worker sums the values of its blocks, and
+    the partial sums are added at the end.
+*/
+
+/* blocks per thread, for load balancing */
+#define COMPOSE_BLOCKS_PER_THREAD 4
+
+typedef struct
+{
+    volatile slong next_block;
+    slong num_blocks;
+    pthread_mutex_t mutex;
+    const nmod_mpoly_struct * B;
+    nmod_mpoly_struct * const * C;
+    const nmod_mpoly_ctx_struct * ctxB;
+    const nmod_mpoly_ctx_struct * ctxAC;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    nmod_mpoly_struct S[1];
+    _base_struct * base;
+}
+_worker_arg_struct;
+
+static void _worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    const nmod_mpoly_struct * B = base->B;
+    const nmod_mpoly_ctx_struct * ctxAC = base->ctxAC;
+    slong i, N, start, stop;
+    nmod_mpoly_struct Bblock[1];
+    nmod_mpoly_t T, U;
+
+    N = mpoly_words_per_exp(B->bits, base->ctxB->minfo);
+
+    nmod_mpoly_init(T, ctxAC);
+    nmod_mpoly_init(U, ctxAC);
+
+    while (1)
+    {
+        pthread_mutex_lock(&base->mutex);
+        i = base->next_block;
+        base->next_block = i + 1;
+        pthread_mutex_unlock(&base->mutex);
+
+        if (i >= base->num_blocks)
+            break;
+
+        start = B->length*i/base->num_blocks;
+        stop = B->length*(i + 1)/base->num_blocks;
+        if (start >= stop)
+            continue;
+
+        /* shallow view of the terms [start, stop) of B */
+        Bblock->coeffs = B->coeffs + start;
+        Bblock->exps = B->exps + N*start;
+        Bblock->length = stop - start;
+        Bblock->bits = B->bits;
+        Bblock->alloc = 0;
+
+        _nmod_mpoly_compose_nmod_mpoly(T, Bblock, base->C, base->ctxB, ctxAC);
+        nmod_mpoly_add(U, arg->S, T, ctxAC);
+        nmod_mpoly_swap(arg->S, U, ctxAC);
+    }
+
+    nmod_mpoly_clear(T, ctxAC);
+    nmod_mpoly_clear(U, ctxAC);
+}
+
+void _nmod_mpoly_compose_nmod_mpoly_threaded(nmod_mpoly_t A,
+                  const nmod_mpoly_t B, nmod_mpoly_struct * const * C,
+                   const nmod_mpoly_ctx_t ctxB, const nmod_mpoly_ctx_t ctxAC,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, num_workers;
+    _base_t base;
+    _worker_arg_struct * args;
+    nmod_mpoly_t T;
+
+    FLINT_ASSERT(B->length > 0);
+
+    num_workers = FLINT_MIN(num_handles + 1, B->length);
+    if (num_workers < 2)
+    {
+        nmod_mpoly_init(T, ctxAC);
+        _nmod_mpoly_compose_nmod_mpoly(T, B, C, ctxB, ctxAC);
+        nmod_mpoly_swap(A, T, ctxAC);
+        nmod_mpoly_clear(T, ctxAC);
+        return;
+    }
+
+    base->next_block = 0;
+    base->num_blocks = FLINT_MIN(B->length,
+                                      COMPOSE_BLOCKS_PER_THREAD*num_workers);
+    base->B = B;
+    base->C = C;
+    base->ctxB = ctxB;
+    base->ctxAC = ctxAC;
+    pthread_mutex_init(&base->mutex, NULL);
+
+    args = (_worker_arg_struct *) flint_malloc(num_workers
+                                                  *sizeof(_worker_arg_struct));
+    for (i = 0; i < num_workers; i++)
+    {
+        nmod_mpoly_init(args[i].S, ctxAC);
+        args[i].base = base;
+    }
+
+    for (i = 0; i + 1 < num_workers; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i], _worker, &args[i]);
+    }
+    _worker(&args[num_workers - 1]);
+    for (i = 0; i + 1 < num_workers; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    pthread_mutex_destroy(&base->mutex);
+
+    /* A may alias some C[i], so it is only written now */
+    nmod_mpoly_init(T, ctxAC);
+    for (i = 1; i < num_workers; i++)
+    {
+        nmod_mpoly_add(T, args[0].S, args[i].S, ctxAC);
+        nmod_mpoly_swap(args[0].S, T, ctxAC);
+    }
+    nmod_mpoly_swap(A, args[0].S, ctxAC);
+    nmod_mpoly_clear(T, ctxAC);
+
+    for (i = 0; i < num_workers; i++)
+        nmod_mpoly_clear(args[i].S, ctxAC);
+
+    flint_free(args);
+}
+
+void nmod_mpoly_compose_nmod_mpoly_threaded(nmod_mpoly_t A,
+                     const nmod_mpoly_t B, nmod_mpoly_struct * const * C,
+                   const nmod_mpoly_ctx_t ctxB, const nmod_mpoly_ctx_t ctxAC,
+                                                            slong thread_limit)
+{
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    FLINT_ASSERT(A != B);
+
+    if (B->length == 0)
+    {
+        nmod_mpoly_zero(A, ctxAC);
+        return;
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (thread_limit > 1 && global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _nmod_mpoly_compose_nmod_mpoly_threaded(A, B, C, ctxB, ctxAC,
+                                                         handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
@@ -69,26 +69,6 @@ static void vec_slong_print(const vec_slong_t v)
 
 
 
-/*
-    a thread safe mpoly supports three mutating operations
-    - init from an array of terms
-    - append an array of terms
-    - clear out contents to a normal mpoly
-*/
-typedef struct _nmod_mpoly_ts_struct
-{
-    mp_limb_t * volatile coeffs; /* this is coeff_array[idx] */
-    ulong * volatile exps;       /* this is exp_array[idx] */
-    volatile slong length;
-    slong alloc;
-    flint_bitcnt_t bits;
-    flint_bitcnt_t idx;    
-    mp_limb_t * exp_array[FLINT_BITS];
-    ulong * coeff_array[FLINT_BITS];
-} nmod_mpoly_ts_struct;
-
-typedef nmod_mpoly_ts_struct nmod_mpoly_ts_t[1];
-
 void nmod_mpoly_ts_init(nmod_mpoly_ts_t A,
                               mp_limb_t * Bcoeff, ulong * Bexp, slong Blen,
                                                     flint_bitcnt_t bits, slong N)
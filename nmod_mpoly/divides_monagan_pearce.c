@@ -15,7 +15,7 @@ slong _nmod_mpoly_divides_monagan_pearce1(
                      mp_limb_t ** coeff1,      ulong ** exp1, slong * alloc,
                 const mp_limb_t * coeff2, const ulong * exp2, slong len2,
                 const mp_limb_t * coeff3, const ulong * exp3, slong len3,
-                              slong bits, ulong maskhi, const nmodf_ctx_t fctx)
+                             ulong mask, ulong maskhi, const nmodf_ctx_t fctx)
 {
     int lt_divides;
     slong i, j, q_len, s;
@@ -27,7 +27,7 @@ slong _nmod_mpoly_divides_monagan_pearce1(
     mp_limb_t * q_coeff = * coeff1;
     ulong * q_exp = * exp1;
     slong * hind;
-    ulong mask, exp, maxexp = exp2[len2 - 1];
+    ulong exp, maxexp = exp2[len2 - 1];
     mp_limb_t lc_minus_inv, acc0, acc1, acc2, pp1, pp0;
     TMP_INIT;
 
@@ -44,11 +44,6 @@ slong _nmod_mpoly_divides_monagan_pearce1(
     for (i = 0; i < len3; i++)
         hind[i] = 1;
 
-    /* mask with high bit set in each field of exponent vector */
-    mask = 0;
-    for (i = 0; i < FLINT_BITS/bits; i++)
-        mask = (mask << bits) + (UWORD(1) << (bits - 1));
-
     q_len = WORD(0);
 
     /* s is the number of terms * (latest quotient) we should put into heap */
@@ -195,11 +190,17 @@ not_exact_division:
 }
 
 
-slong _nmod_mpoly_divides_monagan_pearce(
+/*
+    When bits <= FLINT_BITS the word i of masks has the top bit of each field
+    in word i of an exponent vector set, so that the fields need not be of
+    uniform width.
+*/
+static slong _divides_monagan_pearce(
                      mp_limb_t ** coeff1,      ulong ** exp1, slong * alloc,
                 const mp_limb_t * coeff2, const ulong * exp2, slong len2,
                 const mp_limb_t * coeff3, const ulong * exp3, slong len3,
-     flint_bitcnt_t bits, slong N, const ulong * cmpmask, const nmodf_ctx_t fctx)
+                  flint_bitcnt_t bits, slong N, const ulong * cmpmask,
+                               const ulong * masks, const nmodf_ctx_t fctx)
 {
     int lt_divides;
     slong i, j, q_len, s;
@@ -214,13 +215,12 @@ slong _nmod_mpoly_divides_monagan_pearce(
     ulong ** exp_list;
     slong exp_next;
     mp_limb_t lc_minus_inv, acc0, acc1, acc2, pp1, pp0;
-    ulong mask;
     slong * hind;
     TMP_INIT;
 
     if (N == 1)
         return _nmod_mpoly_divides_monagan_pearce1(coeff1, exp1, alloc,
-               coeff2, exp2, len2, coeff3, exp3, len3, bits, cmpmask[0], fctx);
+           coeff2, exp2, len2, coeff3, exp3, len3, masks[0], cmpmask[0], fctx);
 
     TMP_START;
 
@@ -244,11 +244,6 @@ slong _nmod_mpoly_divides_monagan_pearce(
     for (i = 0; i < len3; i++)
         hind[i] = 1;
 
-    /* mask with high bit set in each word of each field of exponent vector */
-    mask = 0;
-    for (i = 0; i < FLINT_BITS/bits; i++)
-        mask = (mask << bits) + (UWORD(1) << (bits - 1));
-
     q_len = WORD(0);
 
     /* s is the number of terms * (latest quotient) we should put into heap */
@@ -273,7 +268,7 @@ slong _nmod_mpoly_divides_monagan_pearce(
 
         if (bits <= FLINT_BITS)
         {
-            if (mpoly_monomial_overflows(exp, N, mask))
+            if (mpoly_monomial_overflows_varbits(exp, N, masks))
                 goto not_exact_division;
         } else
         {
@@ -284,7 +279,8 @@ slong _nmod_mpoly_divides_monagan_pearce(
         _nmod_mpoly_fit_length(&q_coeff, &q_exp, alloc, q_len + 1, N);
 
         if (bits <= FLINT_BITS)
-            lt_divides = mpoly_monomial_divides(q_exp + q_len*N, exp, exp3, N, mask);
+            lt_divides = mpoly_monomial_divides_varbits(q_exp + q_len*N,
+                                                       exp, exp3, N, masks);
         else
             lt_divides = mpoly_monomial_divides_mp(q_exp + q_len*N, exp, exp3, N, bits);
 
@@ -434,6 +430,111 @@ not_exact_division:
     goto cleanup;
 }
 
+slong _nmod_mpoly_divides_monagan_pearce(
+                     mp_limb_t ** coeff1,      ulong ** exp1, slong * alloc,
+                const mp_limb_t * coeff2, const ulong * exp2, slong len2,
+                const mp_limb_t * coeff3, const ulong * exp3, slong len3,
+     flint_bitcnt_t bits, slong N, const ulong * cmpmask, const nmodf_ctx_t fctx)
+{
+    slong i, len;
+    ulong mask, * masks = NULL;
+    TMP_INIT;
+
+    TMP_START;
+
+    if (bits <= FLINT_BITS)
+    {
+        /* mask with high bit set in each field of exponent vector */
+        mask = 0;
+        for (i = 0; i < FLINT_BITS/bits; i++)
+            mask = (mask << bits) + (UWORD(1) << (bits - 1));
+
+        masks = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+        for (i = 0; i < N; i++)
+            masks[i] = mask;
+    }
+
+    len = _divides_monagan_pearce(coeff1, exp1, alloc, coeff2, exp2, len2,
+                           coeff3, exp3, len3, bits, N, cmpmask, masks, fctx);
+    TMP_END;
+
+    return len;
+}
+
+/*
+    Exponent vectors are packed as described by V, see mpoly_varbits_init.
+*/
+slong _nmod_mpoly_divides_monagan_pearce_varbits(
+                     mp_limb_t ** coeff1,      ulong ** exp1, slong * alloc,
+                const mp_limb_t * coeff2, const ulong * exp2, slong len2,
+                const mp_limb_t * coeff3, const ulong * exp3, slong len3,
+                             const mpoly_varbits_t V, const nmodf_ctx_t fctx)
+{
+    return _divides_monagan_pearce(coeff1, exp1, alloc, coeff2, exp2, len2,
+                             coeff3, exp3, len3, FLINT_BITS, V->N, V->cmpmask,
+                                                      V->overflow_mask, fctx);
+}
+
+/*
+    Set Q to A/B using the packing V for the computation and return the length
+    of the quotient, or 0 if the division is not exact. The output is packed
+    into bits.
+*/
+static slong _divides_varbits(nmod_mpoly_t Q, const nmod_mpoly_t A,
+                    const nmod_mpoly_t B, flint_bitcnt_t bits,
+                           const mpoly_varbits_t V, const nmod_mpoly_ctx_t ctx)
+{
+    slong len, Talloc;
+    slong N = mpoly_words_per_exp_sp(bits, ctx->minfo);
+    ulong * Aexps, * Bexps, * Texps, * expq;
+    nmod_mpoly_t T;
+    TMP_INIT;
+
+    TMP_START;
+
+    Aexps = (ulong *) flint_malloc(V->N*A->length*sizeof(ulong));
+    Bexps = (ulong *) flint_malloc(V->N*B->length*sizeof(ulong));
+    mpoly_varbits_pack(Aexps, A->exps, A->bits, A->length, V, ctx->minfo);
+    mpoly_varbits_pack(Bexps, B->exps, B->bits, B->length, V, ctx->minfo);
+
+    /* check leading monomial divides exactly */
+    expq = (ulong *) TMP_ALLOC(V->N*sizeof(ulong));
+    if (!mpoly_monomial_divides_varbits(expq, Aexps, Bexps, V->N,
+                                                             V->overflow_mask))
+    {
+        len = 0;
+        goto cleanup;
+    }
+
+    nmod_mpoly_init3(T, 0, bits, ctx);
+
+    Talloc = A->length/B->length + 1;
+    T->coeffs = (mp_limb_t *) flint_malloc(Talloc*sizeof(mp_limb_t));
+    Texps = (ulong *) flint_malloc(Talloc*V->N*sizeof(ulong));
+
+    len = _nmod_mpoly_divides_monagan_pearce_varbits(&T->coeffs, &Texps,
+                               &Talloc, A->coeffs, Aexps, A->length,
+                                   B->coeffs, Bexps, B->length, V, ctx->ffinfo);
+
+    T->alloc = Talloc;
+    T->exps = (ulong *) flint_malloc(Talloc*N*sizeof(ulong));
+    mpoly_varbits_unpack(T->exps, bits, Texps, len, V, ctx->minfo);
+    T->length = len;
+    flint_free(Texps);
+
+    nmod_mpoly_swap(Q, T, ctx);
+    nmod_mpoly_clear(T, ctx);
+
+cleanup:
+
+    flint_free(Aexps);
+    flint_free(Bexps);
+
+    TMP_END;
+
+    return len;
+}
+
 /* return 1 if quotient is exact */
 int nmod_mpoly_divides_monagan_pearce(nmod_mpoly_t poly1,
                   const nmod_mpoly_t poly2, const nmod_mpoly_t poly3,
@@ -444,8 +545,9 @@ int nmod_mpoly_divides_monagan_pearce(nmod_mpoly_t poly1,
     fmpz * max_fields2, * max_fields3;
     ulong * cmpmask;
     ulong * exp2 = poly2->exps, * exp3 = poly3->exps, * expq;
-    int easy_exit, free2 = 0, free3 = 0;
+    int easy_exit, use_varbits, free2 = 0, free3 = 0;
     ulong mask = 0;
+    mpoly_varbits_t V;
     TMP_INIT;
 
     if (poly3->length == 0)
@@ -488,6 +590,19 @@ int nmod_mpoly_divides_monagan_pearce(nmod_mpoly_t poly1,
     exp_bits = FLINT_MAX(exp_bits, poly3->bits);
     exp_bits = mpoly_fix_bits(exp_bits, ctx->minfo);
 
+    /*
+        If the fields have very different sizes, a packing with a width
+        for each field may need fewer words than exp_bits for every field.
+    */
+    use_varbits = 0;
+    if (!easy_exit && exp_bits <= FLINT_BITS)
+    {
+        mpoly_varbits_init(V, max_fields2, ctx->minfo);
+        use_varbits = V->N < mpoly_words_per_exp_sp(exp_bits, ctx->minfo);
+        if (!use_varbits)
+            mpoly_varbits_clear(V);
+    }
+
     for (i = 0; i < ctx->minfo->nfields; i++)
     {
         fmpz_clear(max_fields2 + i);
@@ -500,6 +615,13 @@ int nmod_mpoly_divides_monagan_pearce(nmod_mpoly_t poly1,
         goto cleanup;
     }
 
+    if (use_varbits)
+    {
+        len = _divides_varbits(poly1, poly2, poly3, exp_bits, V, ctx);
+        mpoly_varbits_clear(V);
+        goto cleanup;
+    }
+
     N = mpoly_words_per_exp(exp_bits, ctx->minfo);
     cmpmask = (ulong*) TMP_ALLOC(N*sizeof(ulong));
     mpoly_get_cmpmask(cmpmask, N, exp_bits, ctx->minfo);
@@ -0,0 +1,1126 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+#include "fmpz_mpoly.h" /* for mpoly_divrem_select_exps */
+
+/*
+    The division with remainder is organised as in divides_heap_threaded.c:
+    the dividend is split into exponent ranges (chunks) and exactly one chunk
+    at a time is the producer of new quotient and remainder terms. Once all
+    quotient terms above a chunk are known, it becomes the producer. Meanwhile
+    the other workers subtract products of the known quotient terms and the
+    divisors from the chunks below.
+*/
+
+/*
+    a chunk holds an exponent range on the dividend
+*/
+typedef struct _divrem_heap_chunk_struct
+{
+    nmod_mpoly_t polyC;
+    nmod_mpoly_t polyR;
+    struct _divrem_heap_chunk_struct * next;
+    ulong * emin;
+    ulong * emax;
+    slong * startidx;   /* one for each divisor */
+    slong * endidx;
+    slong * mq;
+    int upperclosed;
+    volatile int lock;
+    volatile int producer;
+    volatile int done;
+    int Cinited;
+} divrem_heap_chunk_struct;
+
+typedef divrem_heap_chunk_struct divrem_heap_chunk_t[1];
+
+/*
+    the base struct includes a linked list of chunks
+*/
+typedef struct
+{
+    pthread_mutex_t mutex;
+    divrem_heap_chunk_struct * head;
+    divrem_heap_chunk_struct * tail;
+    divrem_heap_chunk_struct * volatile cur;
+    nmod_mpoly_t polyA;
+    nmod_mpoly_struct * polyB;
+    nmod_mpoly_ts_struct * polyQ;
+    slong len;
+    mp_limb_t * lc_inv;
+    const nmod_mpoly_ctx_struct * ctx;
+    slong length;
+    slong N;
+    flint_bitcnt_t bits;
+    ulong * cmpmask;
+    volatile int failed;
+} divrem_heap_base_struct;
+
+typedef divrem_heap_base_struct divrem_heap_base_t[1];
+
+/*
+    the worker stuct has a big chunk of memory in the stripe_t
+    and polys for work space
+*/
+typedef struct _worker_arg_struct
+{
+    divrem_heap_base_struct * H;
+    nmod_mpoly_stripe_t S;
+    nmod_mpoly_t polyT1;
+    nmod_mpoly_struct * polyT2;    /* one for each divisor */
+} worker_arg_struct;
+
+typedef worker_arg_struct worker_arg_t[1];
+
+
+/*
+    Divide the terms C in the range [emin, emax) by the divisors B, where C
+    already accounts for all quotient terms produced above emax. New quotient
+    terms are written to T[w] and the remainder terms are appended to R.
+    Products that fall below emin are left for the chunks below.
+    Return 0 if an exponent overflow was detected.
+*/
+static int _nmod_mpoly_divrem_ideal_stripe(
+    nmod_mpoly_struct * T,
+    nmod_mpoly_t R,
+    const mp_limb_t * Ccoeff, const ulong * Cexp, slong Clen,
+    const nmod_mpoly_struct * B,
+    slong len,
+    const mp_limb_t * lc_inv,
+    const ulong * emin,
+    const nmod_mpoly_ctx_t ctx)
+{
+    int success;
+    flint_bitcnt_t bits = R->bits;
+    slong N = mpoly_words_per_exp(bits, ctx->minfo);
+    slong i, j, p, w, tot;
+    slong next_loc, heap_len = 1;
+    mpoly_heap_s * heap;
+    mpoly_nheap_t * Cchain, ** chains, * x;
+    slong ** hinds, * hind;
+    slong * s, * store, * store_base;
+    ulong * exp, * exps, * texp, * cmpmask;
+    ulong ** exp_list;
+    slong exp_next;
+    ulong mask;
+    mp_limb_t acc0, acc1, acc2, pp1, pp0, c;
+    nmod_t mod = ctx->ffinfo->mod;
+    TMP_INIT;
+
+    TMP_START;
+
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, bits, ctx->minfo);
+
+    mask = 0;
+    for (i = 0; i < FLINT_BITS/bits; i++)
+        mask = (mask << bits) + (UWORD(1) << (bits - 1));
+
+    tot = 1;
+    for (w = 0; w < len; w++)
+        tot += B[w].length;
+
+    next_loc = tot + 4;   /* something bigger than heap can ever be */
+    heap = (mpoly_heap_s *) TMP_ALLOC((tot + 1)*sizeof(mpoly_heap_s));
+    Cchain = (mpoly_nheap_t *) TMP_ALLOC(sizeof(mpoly_nheap_t));
+    chains = (mpoly_nheap_t **) TMP_ALLOC(len*sizeof(mpoly_nheap_t *));
+    hinds = (slong **) TMP_ALLOC(len*sizeof(slong *));
+    s = (slong *) TMP_ALLOC(len*sizeof(slong));
+    store = store_base = (slong *) TMP_ALLOC(3*tot*sizeof(slong));
+    exps = (ulong *) TMP_ALLOC(tot*N*sizeof(ulong));
+    exp_list = (ulong **) TMP_ALLOC(tot*sizeof(ulong *));
+    exp = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    texp = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+
+    for (w = 0; w < len; w++)
+    {
+        chains[w] = (mpoly_nheap_t *) TMP_ALLOC(B[w].length*
+                                                        sizeof(mpoly_nheap_t));
+        hinds[w] = (slong *) TMP_ALLOC(B[w].length*sizeof(slong));
+        for (i = 0; i < B[w].length; i++)
+            hinds[w][i] = 1;
+
+        /* s is the number of terms * (latest quotient) we should put in heap */
+        s[w] = B[w].length;
+        T[w].length = 0;
+    }
+
+    exp_next = 0;
+    for (i = 0; i < tot; i++)
+        exp_list[i] = exps + i*N;
+
+    /* insert (-1, 0, Cexp[0]) into heap */
+    if (Clen > 0)
+    {
+        x = Cchain;
+        x->i = -WORD(1);
+        x->j = 0;
+        x->p = -WORD(1);
+        x->next = NULL;
+        mpoly_monomial_set(exp_list[exp_next], Cexp + N*0, N);
+        exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+    }
+
+    while (heap_len > 1)
+    {
+        mpoly_monomial_set(exp, heap[1].exp, N);
+
+        if (bits <= FLINT_BITS)
+        {
+            if (mpoly_monomial_overflows(exp, N, mask))
+                goto exp_overflow;
+        }
+        else
+        {
+            if (mpoly_monomial_overflows_mp(exp, N, bits))
+                goto exp_overflow;
+        }
+
+        FLINT_ASSERT(mpoly_monomial_cmp(exp, emin, N, cmpmask) >= 0);
+
+        /* accumulate the negative of the coefficient */
+        acc0 = acc1 = acc2 = 0;
+        do
+        {
+            exp_list[--exp_next] = heap[1].exp;
+            x = _mpoly_heap_pop(heap, &heap_len, N, cmpmask);
+            do
+            {
+                *store++ = x->i;
+                *store++ = x->j;
+                *store++ = x->p;
+
+                if (x->i == -WORD(1))
+                {
+                    add_sssaaaaaa(acc2, acc1, acc0, acc2, acc1, acc0,
+                                   WORD(0), WORD(0), mod.n - Ccoeff[x->j]);
+                }
+                else
+                {
+                    hinds[x->p][x->i] |= WORD(1);
+                    umul_ppmm(pp1, pp0, B[x->p].coeffs[x->i],
+                                                       T[x->p].coeffs[x->j]);
+                    add_sssaaaaaa(acc2, acc1, acc0, acc2, acc1, acc0,
+                                                          WORD(0), pp1, pp0);
+                }
+            } while ((x = x->next) != NULL);
+        } while (heap_len > 1 && mpoly_monomial_equal(heap[1].exp, exp, N));
+
+        NMOD_RED3(c, acc2, acc1, acc0, mod);
+
+        /* process nodes taken from the heap */
+        while (store > store_base)
+        {
+            p = *--store;
+            j = *--store;
+            i = *--store;
+
+            if (i == -WORD(1))
+            {
+                /* take next dividend term */
+                if (j + 1 < Clen)
+                {
+                    x = Cchain;
+                    x->j = j + 1;
+                    x->next = NULL;
+                    mpoly_monomial_set(exp_list[exp_next], Cexp + N*x->j, N);
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next], x,
+                                             &next_loc, &heap_len, N, cmpmask);
+                }
+                continue;
+            }
+
+            hind = hinds[p];
+
+            /* should we go right? */
+            if (  (i + 1 < B[p].length)
+               && (hind[i + 1] == 2*j + 1)
+               )
+            {
+                x = chains[p] + i + 1;
+                x->i = i + 1;
+                x->j = j;
+                x->p = p;
+                x->next = NULL;
+                hind[x->i] = 2*(x->j + 1) + 0;
+
+                mpoly_monomial_add_mp(exp_list[exp_next], B[p].exps + N*x->i,
+                                                         T[p].exps + N*x->j, N);
+
+                if (mpoly_monomial_cmp(exp_list[exp_next], emin, N,
+                                                                 cmpmask) >= 0)
+                {
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next],
+                                          x, &next_loc, &heap_len, N, cmpmask);
+                }
+                else
+                {
+                    hind[x->i] |= 1;
+                }
+            }
+
+            /* should we go up? */
+            if (j + 1 == T[p].length)
+            {
+                s[p]++;
+            }
+            else if (  ((hind[i] & 1) == 1)
+                    && ((i == 1) || (hind[i - 1] >= 2*(j + 2) + 1))
+                    )
+            {
+                x = chains[p] + i;
+                x->i = i;
+                x->j = j + 1;
+                x->p = p;
+                x->next = NULL;
+                hind[x->i] = 2*(x->j + 1) + 0;
+
+                mpoly_monomial_add_mp(exp_list[exp_next], B[p].exps + N*x->i,
+                                                         T[p].exps + N*x->j, N);
+
+                if (mpoly_monomial_cmp(exp_list[exp_next], emin, N,
+                                                                 cmpmask) >= 0)
+                {
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next],
+                                          x, &next_loc, &heap_len, N, cmpmask);
+                }
+                else
+                {
+                    hind[x->i] |= 1;
+                }
+            }
+        }
+
+        if (c == 0)
+            continue;
+
+        c = nmod_neg(c, mod);
+
+        /* the first divisor whose leading term divides takes the term */
+        for (w = 0; w < len; w++)
+        {
+            int lt_divides;
+            slong k;
+
+            if (bits <= FLINT_BITS)
+                lt_divides = mpoly_monomial_divides(texp, exp,
+                                                    B[w].exps + N*0, N, mask);
+            else
+                lt_divides = mpoly_monomial_divides_mp(texp, exp,
+                                                    B[w].exps + N*0, N, bits);
+            if (!lt_divides)
+                continue;
+
+            k = T[w].length;
+            nmod_mpoly_fit_length(T + w, k + 1, ctx);
+            T[w].coeffs[k] = nmod_mul(c, lc_inv[w], mod);
+            mpoly_monomial_set(T[w].exps + N*k, texp, N);
+            T[w].length = k + 1;
+
+            if (s[w] > 1)
+            {
+                i = 1;
+                x = chains[w] + i;
+                x->i = i;
+                x->j = k;
+                x->p = w;
+                x->next = NULL;
+                hinds[w][x->i] = 2*(x->j + 1) + 0;
+
+                mpoly_monomial_add_mp(exp_list[exp_next], B[w].exps + N*x->i,
+                                                         T[w].exps + N*x->j, N);
+
+                if (mpoly_monomial_cmp(exp_list[exp_next], emin, N,
+                                                                 cmpmask) >= 0)
+                {
+                    exp_next += _mpoly_heap_insert(heap, exp_list[exp_next],
+                                          x, &next_loc, &heap_len, N, cmpmask);
+                }
+                else
+                {
+                    hinds[w][x->i] |= 1;
+                }
+            }
+            s[w] = 1;
+            c = 0;
+            break;
+        }
+
+        if (c != 0)
+        {
+            slong k = R->length;
+            nmod_mpoly_fit_length(R, k + 1, ctx);
+            R->coeffs[k] = c;
+            mpoly_monomial_set(R->exps + N*k, exp, N);
+            R->length = k + 1;
+        }
+    }
+
+    success = 1;
+
+cleanup:
+
+    TMP_END;
+
+    return success;
+
+exp_overflow:
+    success = 0;
+    goto cleanup;
+}
+
+
+static void divrem_heap_base_init(divrem_heap_base_t H)
+{
+    H->head = NULL;
+    H->tail = NULL;
+    H->cur = NULL;
+    H->ctx = NULL;
+    H->length = 0;
+    H->N = 0;
+    H->bits = 0;
+    H->cmpmask = NULL;
+}
+
+static void divrem_heap_chunk_clear(divrem_heap_chunk_t L,
+                                                         divrem_heap_base_t H)
+{
+    if (L->Cinited)
+    {
+        nmod_mpoly_clear(L->polyC, H->ctx);
+    }
+    nmod_mpoly_clear(L->polyR, H->ctx);
+    flint_free(L->startidx);
+    flint_free(L->endidx);
+    flint_free(L->mq);
+}
+
+/*
+    Move the quotients to Q and the remainder to R if the computation did not
+    fail. The chunks are always cleared.
+*/
+static int divrem_heap_base_clear(nmod_mpoly_struct ** Q, nmod_mpoly_t R,
+                                                         divrem_heap_base_t H)
+{
+    slong i, Rlen;
+    int success = !H->failed;
+    divrem_heap_chunk_struct * L;
+
+    if (success)
+    {
+        Rlen = 0;
+        for (L = H->head; L != NULL; L = L->next)
+            Rlen += L->polyR->length;
+
+        nmod_mpoly_fit_length(R, Rlen, H->ctx);
+        nmod_mpoly_fit_bits(R, H->bits, H->ctx);
+        R->bits = H->bits;
+
+        Rlen = 0;
+        for (L = H->head; L != NULL; L = L->next)
+        {
+            for (i = 0; i < L->polyR->length; i++)
+            {
+                R->coeffs[Rlen] = L->polyR->coeffs[i];
+                mpoly_monomial_set(R->exps + H->N*Rlen,
+                                           L->polyR->exps + H->N*i, H->N);
+                Rlen++;
+            }
+        }
+        _nmod_mpoly_set_length(R, Rlen, H->ctx);
+    }
+
+    L = H->head;
+    while (L != NULL)
+    {
+        divrem_heap_chunk_struct * nextL = L->next;
+        divrem_heap_chunk_clear(L, H);
+        flint_free(L);
+        L = nextL;
+    }
+
+    for (i = 0; i < H->len; i++)
+    {
+        if (success)
+            nmod_mpoly_ts_clear_poly(Q[i], H->polyQ + i);
+        else
+            nmod_mpoly_ts_clear(H->polyQ + i);
+    }
+
+    H->head = NULL;
+    H->tail = NULL;
+    H->cur = NULL;
+    H->length = 0;
+
+    return success;
+}
+
+static void divrem_heap_base_add_chunk(divrem_heap_base_t H,
+                                                        divrem_heap_chunk_t L)
+{
+    L->next = NULL;
+
+    if (H->tail == NULL)
+    {
+        FLINT_ASSERT(H->head == NULL);
+        H->tail = L;
+        H->head = L;
+    }
+    else
+    {
+        divrem_heap_chunk_struct * tail = H->tail;
+        FLINT_ASSERT(tail->next == NULL);
+        tail->next = L;
+        H->tail = L;
+    }
+    H->length++;
+}
+
+
+static slong chunk_find_exp(ulong * exp, slong a, const divrem_heap_base_t H)
+{
+    slong N = H->N;
+    slong b = H->polyA->length;
+    const ulong * Aexp = H->polyA->exps;
+
+try_again:
+    FLINT_ASSERT(b >= a);
+
+    FLINT_ASSERT(a > 0);
+    FLINT_ASSERT(mpoly_monomial_cmp(Aexp + N*(a - 1), exp, N, H->cmpmask) >= 0);
+    FLINT_ASSERT(b >= H->polyA->length
+                  ||  mpoly_monomial_cmp(Aexp + N*b, exp, N, H->cmpmask) < 0);
+
+    if (b - a < 5)
+    {
+        slong i = a;
+        while (i < b
+                && mpoly_monomial_cmp(Aexp + N*i, exp, N, H->cmpmask) >= 0)
+        {
+            i++;
+        }
+        return i;
+    }
+    else
+    {
+        slong c = a + (b - a)/2;
+        if (mpoly_monomial_cmp(Aexp + N*c, exp, N, H->cmpmask) < 0)
+        {
+            b = c;
+        }
+        else
+        {
+            a = c;
+        }
+        goto try_again;
+    }
+}
+
+static void stripe_fit_length(nmod_mpoly_stripe_struct * S, slong new_len)
+{
+    slong N = S->N;
+    slong new_alloc;
+    new_alloc = 0;
+    if (N == 1)
+    {
+        new_alloc += new_len*sizeof(slong);
+        new_alloc += new_len*sizeof(slong);
+        new_alloc += 2*new_len*sizeof(slong);
+        new_alloc += (new_len + 1)*sizeof(mpoly_heap1_s);
+        new_alloc += new_len*sizeof(mpoly_heap_t);
+    }
+    else
+    {
+        new_alloc += new_len*sizeof(slong);
+        new_alloc += new_len*sizeof(slong);
+        new_alloc += 2*new_len*sizeof(slong);
+        new_alloc += (new_len + 1)*sizeof(mpoly_heap_s);
+        new_alloc += new_len*sizeof(mpoly_heap_t);
+        new_alloc += new_len*N*sizeof(ulong);
+        new_alloc += new_len*sizeof(ulong *);
+        new_alloc += N*sizeof(ulong);
+    }
+
+    if (S->big_mem_alloc >= new_alloc)
+    {
+        return;
+    }
+
+    new_alloc = FLINT_MAX(new_alloc, S->big_mem_alloc + S->big_mem_alloc/4);
+    S->big_mem_alloc = new_alloc;
+
+    if (S->big_mem != NULL)
+    {
+        S->big_mem = (char *) flint_realloc(S->big_mem, new_alloc);
+    }
+    else
+    {
+        S->big_mem = (char *) flint_malloc(new_alloc);
+    }
+}
+
+static void chunk_range(slong * startidx, slong * stopidx,
+                           divrem_heap_chunk_t L, const divrem_heap_base_t H)
+{
+    if (L->upperclosed)
+    {
+        *startidx = 0;
+        *stopidx = chunk_find_exp(L->emin, 1, H);
+    }
+    else
+    {
+        *startidx = chunk_find_exp(L->emax, 1, H);
+        *stopidx = chunk_find_exp(L->emin, *startidx, H);
+    }
+}
+
+/* subtract the products of the new terms of Q[w] and B[w] from the chunk */
+static void chunk_mulsub(worker_arg_t W, divrem_heap_chunk_t L, slong w,
+                                                           slong q_prev_length)
+{
+    divrem_heap_base_struct * H = W->H;
+    slong N = H->N;
+    nmod_mpoly_struct * C = L->polyC;
+    const nmod_mpoly_struct * B = H->polyB + w;
+    const nmod_mpoly_struct * A = H->polyA;
+    nmod_mpoly_ts_struct * Q = H->polyQ + w;
+    nmod_mpoly_struct * T1 = W->polyT1;
+    nmod_mpoly_stripe_struct * S = W->S;
+    const mp_limb_t * Dcoeff;
+    const ulong * Dexp;
+    slong Dlen;
+
+    S->startidx = L->startidx + w;
+    S->endidx = L->endidx + w;
+    S->emin = L->emin;
+    S->emax = L->emax;
+    S->upperclosed = L->upperclosed;
+    FLINT_ASSERT(S->N == N);
+    stripe_fit_length(S, q_prev_length - L->mq[w]);
+
+    if (L->Cinited)
+    {
+        Dcoeff = C->coeffs;
+        Dexp = C->exps;
+        Dlen = C->length;
+    }
+    else
+    {
+        slong startidx, stopidx;
+        chunk_range(&startidx, &stopidx, L, H);
+        Dcoeff = A->coeffs + startidx;
+        Dexp = A->exps + N*startidx;
+        Dlen = stopidx - startidx;
+    }
+
+    if (N == 1)
+    {
+        T1->length = _nmod_mpoly_mulsub_stripe1(
+                &T1->coeffs, &T1->exps, &T1->alloc,
+                Dcoeff, Dexp, Dlen,
+                Q->coeffs + L->mq[w], Q->exps + N*L->mq[w],
+                                                q_prev_length - L->mq[w],
+                B->coeffs, B->exps, B->length, S);
+    }
+    else
+    {
+        T1->length = _nmod_mpoly_mulsub_stripe(
+                &T1->coeffs, &T1->exps, &T1->alloc,
+                Dcoeff, Dexp, Dlen,
+                Q->coeffs + L->mq[w], Q->exps + N*L->mq[w],
+                                                q_prev_length - L->mq[w],
+                B->coeffs, B->exps, B->length, S);
+    }
+
+    if (!L->Cinited)
+    {
+        L->Cinited = 1;
+        nmod_mpoly_init3(C, 0, H->bits, H->ctx);
+    }
+    nmod_mpoly_swap(C, T1, H->ctx);
+
+    L->mq[w] = q_prev_length;
+}
+
+static void trychunk(worker_arg_t W, divrem_heap_chunk_t L)
+{
+    divrem_heap_base_struct * H = W->H;
+    slong w, len = H->len;
+    slong N = H->N;
+    slong new_terms;
+    nmod_mpoly_struct * C = L->polyC;
+    const nmod_mpoly_struct * A = H->polyA;
+    nmod_mpoly_ts_struct * Q = H->polyQ;
+    nmod_mpoly_struct * T2 = W->polyT2;
+
+    /* return if this section has already finished processing */
+    if (L->done)
+    {
+        return;
+    }
+
+    /* process more quotient terms if available */
+    new_terms = 0;
+    for (w = 0; w < len; w++)
+        new_terms += Q[w].length - L->mq[w];
+
+    if (L->producer == 0 && new_terms < 20)
+        return;
+
+    for (w = 0; w < len; w++)
+    {
+        slong q_prev_length = Q[w].length;
+        if (q_prev_length > L->mq[w])
+            chunk_mulsub(W, L, w, q_prev_length);
+    }
+
+    if (L->producer == 1)
+    {
+        divrem_heap_chunk_struct * next;
+        const mp_limb_t * Rcoeff;
+        const ulong * Rexp;
+        slong Rlen;
+
+        /* process the remaining quotient terms */
+        for (w = 0; w < len; w++)
+        {
+            slong q_prev_length = Q[w].length;
+            if (q_prev_length > L->mq[w])
+                chunk_mulsub(W, L, w, q_prev_length);
+        }
+
+        /*
+            only the producer makes new quotient terms, so C is now correct
+            on its range, and the remaining terms can be divided
+        */
+        if (L->Cinited)
+        {
+            Rlen = C->length;
+            Rexp = C->exps;
+            Rcoeff = C->coeffs;
+        }
+        else
+        {
+            slong startidx, stopidx;
+            chunk_range(&startidx, &stopidx, L, H);
+            Rlen = stopidx - startidx;
+            Rcoeff = A->coeffs + startidx;
+            Rexp = A->exps + N*startidx;
+        }
+
+        if (Rlen > 0)
+        {
+            if (!_nmod_mpoly_divrem_ideal_stripe(T2, L->polyR,
+                                     Rcoeff, Rexp, Rlen, H->polyB, len,
+                                       H->lc_inv, L->emin, H->ctx))
+            {
+                H->failed = 1;
+                return;
+            }
+
+            for (w = 0; w < len; w++)
+            {
+                if (T2[w].length > 0)
+                    nmod_mpoly_ts_append(Q + w, T2[w].coeffs, T2[w].exps,
+                                                              T2[w].length, N);
+            }
+        }
+
+        next = L->next;
+        H->length--;
+        H->cur = next;
+
+        if (next != NULL)
+        {
+            next->producer = 1;
+        }
+
+        L->producer = 0;
+        L->done = 1;
+    }
+
+    return;
+}
+
+
+static void worker_loop(void * varg)
+{
+    worker_arg_struct * W = (worker_arg_struct *) varg;
+    divrem_heap_base_struct * H = W->H;
+    nmod_mpoly_stripe_struct * S = W->S;
+    nmod_mpoly_struct * T1 = W->polyT1;
+    nmod_mpoly_struct * T2;
+    slong N = H->N;
+    slong w;
+
+    /* initialize stripe working memory */
+    S->N = N;
+    S->bits = H->bits;
+    S->ctx = H->ctx;
+    S->cmpmask = H->cmpmask;
+    S->mod = H->ctx->ffinfo->mod;
+    S->lc_minus_inv = 0;    /* unused by mulsub */
+    S->big_mem_alloc = 0;
+    S->big_mem = NULL;
+
+    stripe_fit_length(S, 16);
+
+    nmod_mpoly_init3(T1, 16, H->bits, H->ctx);
+    T2 = W->polyT2 = (nmod_mpoly_struct *) flint_malloc(
+                                           H->len*sizeof(nmod_mpoly_struct));
+    for (w = 0; w < H->len; w++)
+        nmod_mpoly_init3(T2 + w, 16, H->bits, H->ctx);
+
+    while (!H->failed)
+    {
+        divrem_heap_chunk_struct * L;
+        L = H->cur;
+
+        if (L == NULL)
+        {
+            break;
+        }
+        while (L != NULL)
+        {
+            pthread_mutex_lock(&H->mutex);
+            if (L->lock != -1)
+            {
+                L->lock = -1;
+                pthread_mutex_unlock(&H->mutex);
+                trychunk(W, L);
+                pthread_mutex_lock(&H->mutex);
+                L->lock = 0;
+                pthread_mutex_unlock(&H->mutex);
+                break;
+            }
+            else
+            {
+                pthread_mutex_unlock(&H->mutex);
+            }
+
+            L = L->next;
+        }
+    }
+
+    nmod_mpoly_clear(T1, H->ctx);
+    for (w = 0; w < H->len; w++)
+        nmod_mpoly_clear(T2 + w, H->ctx);
+    flint_free(T2);
+    flint_free(S->big_mem);
+
+    return;
+}
+
+/*
+    Run the division with exponents packed into exp_bits. Return 0 if an
+    exponent overflow was detected.
+*/
+static int _divrem_ideal_heap_threaded(
+    nmod_mpoly_struct ** Q,
+    nmod_mpoly_t R,
+    const nmod_mpoly_t A,
+    nmod_mpoly_struct * const * B,
+    slong len,
+    flint_bitcnt_t exp_bits,
+    const nmod_mpoly_ctx_t ctx,
+    thread_pool_handle * handles,
+    slong num_handles)
+{
+    int success, freeA, * freeB;
+    fmpz_mpoly_ctx_t zctx;
+    fmpz_mpoly_t S;
+    slong i, w, N, longest;
+    ulong * cmpmask;
+    worker_arg_struct * worker_args;
+    divrem_heap_base_t H;
+    TMP_INIT;
+
+    TMP_START;
+
+    N = mpoly_words_per_exp(exp_bits, ctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    mpoly_get_cmpmask(cmpmask, N, exp_bits, ctx->minfo);
+
+    divrem_heap_base_init(H);
+
+    /* ensure input exponents packed to same size as output exponents */
+    nmod_mpoly_init3(H->polyA, 0, exp_bits, ctx);
+    H->polyA->coeffs = A->coeffs;
+    H->polyA->length = A->length;
+    freeA = exp_bits > A->bits;
+    if (freeA)
+    {
+        H->polyA->exps = (ulong *) flint_malloc(N*A->length*sizeof(ulong));
+        mpoly_repack_monomials(H->polyA->exps, exp_bits, A->exps, A->bits,
+                                                        A->length, ctx->minfo);
+    }
+    else
+    {
+        H->polyA->exps = A->exps;
+    }
+
+    H->len = len;
+    H->polyB = (nmod_mpoly_struct *) TMP_ALLOC(len*sizeof(nmod_mpoly_struct));
+    H->polyQ = (nmod_mpoly_ts_struct *) TMP_ALLOC(len*
+                                                 sizeof(nmod_mpoly_ts_struct));
+    H->lc_inv = (mp_limb_t *) TMP_ALLOC(len*sizeof(mp_limb_t));
+    freeB = (int *) TMP_ALLOC(len*sizeof(int));
+
+    longest = 0;
+    for (w = 0; w < len; w++)
+    {
+        nmod_mpoly_struct * Bw = H->polyB + w;
+
+        Bw->coeffs = B[w]->coeffs;
+        Bw->length = B[w]->length;
+        Bw->alloc = B[w]->alloc;
+        Bw->bits = exp_bits;
+        freeB[w] = exp_bits > B[w]->bits;
+        if (freeB[w])
+        {
+            Bw->exps = (ulong *) flint_malloc(N*B[w]->length*sizeof(ulong));
+            mpoly_repack_monomials(Bw->exps, exp_bits, B[w]->exps,
+                                 B[w]->bits, B[w]->length, ctx->minfo);
+        }
+        else
+        {
+            Bw->exps = B[w]->exps;
+        }
+
+        H->lc_inv[w] = nmod_inv(Bw->coeffs[0], ctx->ffinfo->mod);
+        nmod_mpoly_ts_init(H->polyQ + w, NULL, NULL, 0, exp_bits, N);
+
+        if (Bw->length > H->polyB[longest].length)
+            longest = w;
+    }
+
+    /* split the dividend into exponent ranges */
+    fmpz_mpoly_ctx_init(zctx, ctx->minfo->nvars, ctx->minfo->ord);
+    fmpz_mpoly_init(S, zctx);
+
+    mpoly_divrem_select_exps(S, zctx, num_handles,
+                         H->polyA->exps, A->length, H->polyB[longest].exps,
+                                         H->polyB[longest].length, exp_bits);
+
+    /* a constant dividend gives a single range */
+    if (S->length < 2)
+    {
+        fmpz_mpoly_fit_length(S, 2, zctx);
+        mpoly_monomial_set(S->exps + N*1, S->exps + N*0, N);
+        fmpz_one(S->coeffs + 1);
+        _fmpz_mpoly_set_length(S, 2, zctx);
+    }
+
+    H->ctx = ctx;
+    H->bits = exp_bits;
+    H->N = N;
+    H->cmpmask = cmpmask;
+    H->failed = 0;
+
+    for (i = 0; i + 1 < S->length; i++)
+    {
+        divrem_heap_chunk_struct * L;
+        L = (divrem_heap_chunk_struct *) flint_malloc(
+                                             sizeof(divrem_heap_chunk_struct));
+        L->emax = S->exps + N*i;
+        L->emin = S->exps + N*(i + 1);
+        L->upperclosed = 0;
+        L->startidx = (slong *) flint_malloc(len*sizeof(slong));
+        L->endidx = (slong *) flint_malloc(len*sizeof(slong));
+        L->mq = (slong *) flint_malloc(len*sizeof(slong));
+        for (w = 0; w < len; w++)
+        {
+            L->startidx[w] = H->polyB[w].length;
+            L->endidx[w] = H->polyB[w].length;
+            L->mq[w] = 0;
+        }
+        L->producer = 0;
+        L->done = 0;
+        L->Cinited = 0;
+        L->lock = -2;
+        nmod_mpoly_init3(L->polyR, 0, exp_bits, ctx);
+        divrem_heap_base_add_chunk(H, L);
+    }
+
+    H->head->upperclosed = 1;
+    H->head->producer = 1;
+    H->cur = H->head;
+
+    /* start the workers */
+
+    pthread_mutex_init(&H->mutex, NULL);
+
+    worker_args = (worker_arg_struct *) flint_malloc((num_handles + 1)
+                                                        *sizeof(worker_arg_t));
+
+    for (i = 0; i < num_handles; i++)
+    {
+        (worker_args + i)->H = H;
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                 worker_loop, worker_args + i);
+    }
+    (worker_args + num_handles)->H = H;
+    worker_loop(worker_args + num_handles);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    flint_free(worker_args);
+
+    pthread_mutex_destroy(&H->mutex);
+
+    success = divrem_heap_base_clear(Q, R, H);
+
+    fmpz_mpoly_clear(S, zctx);
+    fmpz_mpoly_ctx_clear(zctx);
+
+    /* A may have been overwritten by one of the quotients */
+    if (freeA)
+        flint_free(H->polyA->exps);
+
+    for (w = 0; w < len; w++)
+    {
+        if (freeB[w])
+            flint_free(H->polyB[w].exps);
+    }
+
+    TMP_END;
+
+    return success;
+}
+
+/* Assumes divisor polys don't alias any output polys */
+void _nmod_mpoly_divrem_ideal_heap_threaded(
+    nmod_mpoly_struct ** Q,
+    nmod_mpoly_t R,
+    const nmod_mpoly_t A,
+    nmod_mpoly_struct * const * B,
+    slong len,
+    const nmod_mpoly_ctx_t ctx,
+    thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong i;
+    flint_bitcnt_t exp_bits;
+    nmod_mpoly_t T;
+
+#if !FLINT_KNOW_STRONG_ORDER
+    nmod_mpoly_divrem_ideal_monagan_pearce(Q, R, A, B, len, ctx);
+    return;
+#endif
+
+    exp_bits = MPOLY_MIN_BITS;
+    exp_bits = FLINT_MAX(exp_bits, A->bits);
+    for (i = 0; i < len; i++)
+        exp_bits = FLINT_MAX(exp_bits, B[i]->bits);
+    exp_bits = mpoly_fix_bits(exp_bits, ctx->minfo);
+
+    /* the remainder is written at the very end, so R may alias A */
+    nmod_mpoly_init(T, ctx);
+
+    while (!_divrem_ideal_heap_threaded(Q, T, A, B, len, exp_bits, ctx,
+                                                        handles, num_handles))
+    {
+        exp_bits = mpoly_fix_bits(exp_bits + 1, ctx->minfo);
+    }
+
+    nmod_mpoly_swap(R, T, ctx);
+    nmod_mpoly_clear(T, ctx);
+}
+
+void nmod_mpoly_divrem_ideal_heap_threaded(
+    nmod_mpoly_struct ** Q,
+    nmod_mpoly_t R,
+    const nmod_mpoly_t A,
+    nmod_mpoly_struct * const * B,
+    slong len,
+    const nmod_mpoly_ctx_t ctx,
+    slong thread_limit)
+{
+    thread_pool_handle * handles;
+    slong num_handles;
+    slong i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (B[i]->length == 0)
+            flint_throw(FLINT_DIVZERO,
+                  "Divide by zero in nmod_mpoly_divrem_ideal_heap_threaded");
+    }
+
+    if (A->length == 0)
+    {
+        for (i = 0; i < len; i++)
+            nmod_mpoly_zero(Q[i], ctx);
+        nmod_mpoly_zero(R, ctx);
+        return;
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (thread_limit > 1 && global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _nmod_mpoly_divrem_ideal_heap_threaded(Q, R, A, B, len, ctx,
+                                                         handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
+
+void nmod_mpoly_divrem_heap_threaded(nmod_mpoly_t Q, nmod_mpoly_t R,
+       const nmod_mpoly_t A, const nmod_mpoly_t B, const nmod_mpoly_ctx_t ctx,
+                                                            slong thread_limit)
+{
+    nmod_mpoly_struct * QQ[1], * BB[1];
+    nmod_mpoly_t T;
+
+    if (B->length == 0)
+    {
+        flint_throw(FLINT_DIVZERO,
+                          "Divide by zero in nmod_mpoly_divrem_heap_threaded");
+    }
+
+    /* the quotient is written before the divisor is finished with */
+    if (Q == B)
+    {
+        nmod_mpoly_init(T, ctx);
+        nmod_mpoly_divrem_heap_threaded(T, R, A, B, ctx, thread_limit);
+        nmod_mpoly_swap(Q, T, ctx);
+        nmod_mpoly_clear(T, ctx);
+        return;
+    }
+
+    QQ[0] = Q;
+    BB[0] = (nmod_mpoly_struct *) B;
+    nmod_mpoly_divrem_ideal_heap_threaded(QQ, R, A, BB, 1, ctx, thread_limit);
+}
@@ -0,0 +1,149 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+
+
+void nmod_mpoly_eval_plan_init(nmod_mpoly_eval_plan_t P,
+                               const nmod_mpoly_t A, const nmod_mpoly_ctx_t ctx)
+{
+    nmod_mpoly_init(&P->poly, ctx);
+    nmod_mpoly_set(&P->poly, A, ctx);
+    mpoly_slp_init(&P->slp, ctx->minfo->nvars);
+    P->compiled = mpoly_slp_compile(&P->slp, P->poly.exps, P->poly.length,
+                                                    P->poly.bits, ctx->minfo);
+}
+
+
+void nmod_mpoly_eval_plan_clear(nmod_mpoly_eval_plan_t P,
+                                                    const nmod_mpoly_ctx_t ctx)
+{
+    nmod_mpoly_clear(&P->poly, ctx);
+    mpoly_slp_clear(&P->slp);
+}
+
+/*
+    Run the program on num <= NMOD_MPOLY_EVAL_PLAN_BLOCK points at once.
+    Register r holds the values at the points in regs[B*r + i], so that each
+    instruction is a loop over independent points.
+*/
+static void _eval_plan_run(mp_limb_t * ev, const nmod_mpoly_eval_plan_t P,
+                       const ulong * vals, slong num, mp_limb_t * regs,
+                                                                 nmod_t mod)
+{
+    const slong B = NMOD_MPOLY_EVAL_PLAN_BLOCK;
+    const mpoly_slp_struct * slp = &P->slp;
+    const mp_limb_t * coeffs = P->poly.coeffs;
+    slong i, j, nvars = slp->nvars;
+    slong sa, sb, sc;
+    const mp_limb_t * a, * b, * c;
+    mp_limb_t * d, hi, lo;
+
+    FLINT_ASSERT(num <= B);
+
+    for (j = 0; j < nvars; j++)
+        for (i = 0; i < num; i++)
+            NMOD_RED(regs[B*j + i], vals[nvars*i + j], mod);
+
+    for (j = 0; j < slp->length; j++)
+    {
+        const mpoly_slp_instr_struct * in = slp->instrs + j;
+
+        d = regs + B*in->dst;
+        sa = in->a >= 0;
+        a = sa ? regs + B*in->a : coeffs + ~in->a;
+        sb = in->b >= 0;
+        b = sb ? regs + B*in->b : coeffs + ~in->b;
+        sc = in->c >= 0;
+        c = sc ? regs + B*in->c : coeffs + ~in->c;
+
+        switch (in->op)
+        {
+            case MPOLY_SLP_MUL:
+                for (i = 0; i < num; i++)
+                    d[i] = nmod_mul(a[sa*i], b[sb*i], mod);
+                break;
+
+            case MPOLY_SLP_ADD:
+                for (i = 0; i < num; i++)
+                    d[i] = nmod_add(a[sa*i], b[sb*i], mod);
+                break;
+
+            default:
+                FLINT_ASSERT(in->op == MPOLY_SLP_MULADD);
+                for (i = 0; i < num; i++)
+                {
+                    umul_ppmm(hi, lo, a[sa*i], b[sb*i]);
+                    add_ssaaaa(hi, lo, hi, lo, UWORD(0), c[sc*i]);
+                    NMOD_RED2(d[i], hi, lo, mod);
+                }
+        }
+    }
+
+    if (slp->result >= 0)
+    {
+        for (i = 0; i < num; i++)
+            ev[i] = regs[B*slp->result + i];
+    }
+    else
+    {
+        for (i = 0; i < num; i++)
+            ev[i] = coeffs[~slp->result];
+    }
+}
+
+/*
+    Set ev[i] to the value of P at the point
+    (vals[nvars*i + 0], ..., vals[nvars*i + nvars - 1]) for 0 <= i < num.
+*/
+void nmod_mpoly_eval_plan_evaluate_vec_ui(mp_limb_t * ev,
+                     const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                                       slong num, const nmod_mpoly_ctx_t ctx)
+{
+    slong i, nvars = ctx->minfo->nvars;
+    mp_limb_t * regs;
+
+    if (P->poly.length == 0)
+    {
+        for (i = 0; i < num; i++)
+            ev[i] = 0;
+        return;
+    }
+
+    if (!P->compiled)
+    {
+        for (i = 0; i < num; i++)
+            ev[i] = nmod_mpoly_evaluate_all_ui((nmod_mpoly_struct *) &P->poly,
+                                                          vals + nvars*i, ctx);
+        return;
+    }
+
+    regs = (mp_limb_t *) flint_malloc(P->slp.nregs
+                                *NMOD_MPOLY_EVAL_PLAN_BLOCK*sizeof(mp_limb_t));
+
+    for (i = 0; i < num; i += NMOD_MPOLY_EVAL_PLAN_BLOCK)
+    {
+        _eval_plan_run(ev + i, P, vals + nvars*i,
+                        FLINT_MIN(num - i, NMOD_MPOLY_EVAL_PLAN_BLOCK), regs,
+                                                            ctx->ffinfo->mod);
+    }
+
+    flint_free(regs);
+}
+
+
+mp_limb_t nmod_mpoly_eval_plan_evaluate_ui(const nmod_mpoly_eval_plan_t P,
+                               const ulong * vals, const nmod_mpoly_ctx_t ctx)
+{
+    mp_limb_t ev;
+    nmod_mpoly_eval_plan_evaluate_vec_ui(&ev, P, vals, 1, ctx);
+    return ev;
+}
@@ -0,0 +1,113 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+typedef struct
+{
+    mp_limb_t * ev;
+    const nmod_mpoly_eval_plan_struct * P;
+    const ulong * vals;
+    slong num;
+    const nmod_mpoly_ctx_struct * ctx;
+}
+_worker_arg_struct;
+
+static void _worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+
+    nmod_mpoly_eval_plan_evaluate_vec_ui(arg->ev, arg->P, arg->vals,
+                                                          arg->num, arg->ctx);
+}
+
+/* the points are split into contiguous ranges of whole blocks */
+void _nmod_mpoly_eval_plan_evaluate_vec_ui_threaded(mp_limb_t * ev,
+                     const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                                       slong num, const nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, start, stop, nblocks, nthreads = num_handles + 1;
+    slong nvars = ctx->minfo->nvars;
+    _worker_arg_struct * args;
+
+    args = (_worker_arg_struct *) flint_malloc(nthreads
+                                                  *sizeof(_worker_arg_struct));
+
+    nblocks = (num + NMOD_MPOLY_EVAL_PLAN_BLOCK - 1)/NMOD_MPOLY_EVAL_PLAN_BLOCK;
+    stop = 0;
+    for (i = 0; i < nthreads; i++)
+    {
+        start = stop;
+        stop = NMOD_MPOLY_EVAL_PLAN_BLOCK*(nblocks*(i + 1)/nthreads);
+        stop = FLINT_MIN(stop, num);
+        args[i].ev = ev + start;
+        args[i].P = P;
+        args[i].vals = vals + nvars*start;
+        args[i].num = stop - start;
+        args[i].ctx = ctx;
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i], _worker, &args[i]);
+    }
+    _worker(&args[num_handles]);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    flint_free(args);
+}
+
+
+void nmod_mpoly_eval_plan_evaluate_vec_ui_threaded(mp_limb_t * ev,
+                     const nmod_mpoly_eval_plan_t P, const ulong * vals,
+                 slong num, const nmod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+    slong nblocks;
+
+    nblocks = (num + NMOD_MPOLY_EVAL_PLAN_BLOCK - 1)/NMOD_MPOLY_EVAL_PLAN_BLOCK;
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        max_num_handles = FLINT_MIN(nblocks - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _nmod_mpoly_eval_plan_evaluate_vec_ui_threaded(ev, P, vals, num, ctx,
+                                                         handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
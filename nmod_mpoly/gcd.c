@@ -79,7 +79,9 @@ static int _try_zippel(
     const ulong * Bmin_exp,
     const slong * Bmax_exp_count,
     const slong * Bmin_exp_count,
-    const nmod_mpoly_ctx_t ctx)
+    const nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
 {
     slong i, j, k;
     slong n, m;
@@ -295,7 +297,8 @@ static int _try_zippel(
     /* after removing content, degree bounds in zinfo are still valid bounds */
 
     /* compute GCD */
-    success = nmod_mpolyu_gcdm_zippel(Gbar, Abar, Bbar, uctx, zinfo, randstate);
+    success = nmod_mpolyu_gcdm_zippel_threaded(Gbar, Abar, Bbar, uctx, zinfo,
+                                               randstate, handles, num_handles);
     if (!success)
         goto cleanup;
 
@@ -544,6 +547,122 @@ cleanup1:
 }
 
 
+/*
+    return 1 for success or 0 for failure
+*/
+static int _try_bma(
+    nmod_mpoly_t G,
+    flint_bitcnt_t Gbits,
+    ulong * Gstride,
+    const nmod_mpoly_t A,
+    const ulong * Amax_exp,
+    const ulong * Amin_exp,
+    const slong * Amax_exp_count,
+    const slong * Amin_exp_count,
+    const nmod_mpoly_t B,
+    const ulong * Bmax_exp,
+    const ulong * Bmin_exp,
+    const slong * Bmax_exp_count,
+    const slong * Bmin_exp_count,
+    const nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    slong i, j;
+    slong m, n = ctx->minfo->nvars;
+    int success;
+    slong * perm;
+    ulong * Gshift;
+    ulong subprod, hi;
+
+    FLINT_ASSERT(A->length > 0);
+    FLINT_ASSERT(B->length > 0);
+
+    Gshift = (ulong *) flint_malloc(n*sizeof(ulong));
+    perm = (slong *) flint_malloc(n*sizeof(slong)); /* only first m entries used */
+
+    m = 0;
+    for (j = 0; j < n; j++)
+    {
+        Gshift[j] = FLINT_MIN(Amin_exp[j], Bmin_exp[j]);
+        if (Amax_exp[j] > Amin_exp[j])
+        {
+            FLINT_ASSERT(Bmax_exp[j] > Bmin_exp[j]);
+            perm[m] = j;
+            m++;
+        }
+    }
+
+    /* need at least 2 variables */
+    if (m < 2)
+    {
+        success = 0;
+        goto cleanup;
+    }
+
+    /* pick the main variable y_0 as in _try_zippel */
+    {
+        slong main_var;
+        ulong count, deg, new_count, new_deg;
+
+        main_var = 0;
+        count = UWORD_MAX;
+        deg = UWORD_MAX;
+        for (i = 0; i < m; i++)
+        {
+            j = perm[i];
+            new_count = FLINT_MIN(Amin_exp_count[j], Amax_exp_count[j]);
+            new_count = FLINT_MIN(new_count, Bmin_exp_count[j]);
+            new_count = FLINT_MIN(new_count, Bmax_exp_count[j]);
+            new_deg = FLINT_MAX(Amax_exp[j] - Amin_exp[j],
+                                Bmax_exp[j] - Bmin_exp[j])/Gstride[j];
+            if (new_count < count || (new_count == count && new_deg < deg))
+            {
+                count = new_count;
+                deg = new_deg;
+                main_var = i;
+            }
+        }
+
+        if (main_var != 0)
+        {
+            slong t = perm[main_var];
+            perm[main_var] = perm[0];
+            perm[0] = t;
+        }
+    }
+
+    /*
+        The Kronecker substitution of y_1, ..., y_{m-1} has to fit into the
+        multiplicative group of Z/pZ. Check this quickly before converting.
+    */
+    subprod = 1;
+    for (i = 1; i < m; i++)
+    {
+        j = perm[i];
+        umul_ppmm(hi, subprod, subprod, 1 + FLINT_MIN(
+                                Amax_exp[j] - Amin_exp[j],
+                                Bmax_exp[j] - Bmin_exp[j])/Gstride[j]);
+        if (hi != 0 || subprod >= ctx->ffinfo->mod.n)
+        {
+            success = 0;
+            goto cleanup;
+        }
+    }
+
+    success = _nmod_mpoly_gcd_berlekamp_massey(G, Gbits, A, Amin_exp,
+                      B, Bmin_exp, Gshift, Gstride, perm, m, ctx,
+                                                         handles, num_handles);
+
+cleanup:
+
+    flint_free(Gshift);
+    flint_free(perm);
+
+    return success;
+}
+
+
 
 /*
     The function must pack its answer into bits = Gbits <= FLINT_BITS
@@ -736,9 +855,18 @@ int _nmod_mpoly_gcd(
     if (success)
         goto cleanup;
 
+    /* the inputs are too sparse for brown: try sparse interpolation */
+    success = _try_bma(G, Gbits, Gstride,
+                   A, Amax_exp, Amin_exp, Amax_exp_count, Amin_exp_count,
+                   B, Bmax_exp, Bmin_exp, Bmax_exp_count, Bmin_exp_count, ctx,
+                                                         handles, num_handles);
+    if (success)
+        goto cleanup;
+
     success = _try_zippel(G, Gbits, Gstride,
                    A, Amax_exp, Amin_exp, Amax_exp_count, Amin_exp_count,
-                   B, Bmax_exp, Bmin_exp, Bmax_exp_count, Bmin_exp_count, ctx);
+                   B, Bmax_exp, Bmin_exp, Bmax_exp_count, Bmin_exp_count, ctx,
+                                                         handles, num_handles);
 
 cleanup:
 
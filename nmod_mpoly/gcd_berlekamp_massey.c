@@ -0,0 +1,917 @@
+/*
+    Copyright (C) 2020 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+#include "thread_pool.h"
+
+/* give up if a discrete log in Fp needs more multiplications than this */
+#define NMOD_MPOLY_GCD_BMA_MAX_DLOG_COST 100000.0
+
+/* give up after this many unlucky evaluation points or candidates */
+#define NMOD_MPOLY_GCD_BMA_MAX_UNLUCKY 6
+
+/*
+    Sparse interpolation of the gcd in Fp[x_0, ..., x_(n-1)][X].
+
+    The variables x_i are substituted by powers of a primitive root omega
+    via the Kronecker substitution x_i = omega^(w_i*k) for k = s, s + 1, ...
+    so that a monomial of H with exponents strictly below degbounds[i]
+    evaluates to the k-th power of the distinct nonzero root omega^(e.w).
+    Each coefficient of X^j in the images of H = Gamma/lc(G)*G is then a
+    linear recurrent sequence whose minimal polynomial is found by the
+    Berlekamp-Massey algorithm. The monomials of H are read off from the
+    discrete logs of the roots of the minimal polynomials.
+*/
+
+/*
+    The coefficients of an mpolyu stored contiguously along with the
+    evaluations of the corresponding monomials at the base point
+    (omega^w_0, ..., omega^w_(n-1)).
+*/
+typedef struct
+{
+    slong length;       /* number of "X" coefficients */
+    slong * starts;     /* length + 1 offsets into coeffs and mons */
+    mp_limb_t * coeffs;
+    mp_limb_t * mons;
+}
+_nmod_skel_struct;
+
+typedef _nmod_skel_struct _nmod_skel_t[1];
+
+static void _nmod_skel_init(
+    _nmod_skel_t S,
+    const nmod_mpoly_struct * Acoeffs,
+    slong Alength,
+    const mp_limb_t * alphas,
+    const nmod_mpoly_ctx_t ctx)
+{
+    slong i, j, k, N, total;
+    slong nvars = ctx->minfo->nvars;
+    ulong * exps;
+    TMP_INIT;
+
+    TMP_START;
+    exps = (ulong *) TMP_ALLOC(nvars*sizeof(ulong));
+
+    S->length = Alength;
+    S->starts = (slong *) flint_malloc((Alength + 1)*sizeof(slong));
+    total = 0;
+    for (i = 0; i < Alength; i++)
+    {
+        S->starts[i] = total;
+        total += Acoeffs[i].length;
+    }
+    S->starts[Alength] = total;
+
+    S->coeffs = (mp_limb_t *) flint_malloc(total*sizeof(mp_limb_t));
+    S->mons = (mp_limb_t *) flint_malloc(total*sizeof(mp_limb_t));
+
+    k = 0;
+    for (i = 0; i < Alength; i++)
+    {
+        const nmod_mpoly_struct * Ai = Acoeffs + i;
+        N = mpoly_words_per_exp(Ai->bits, ctx->minfo);
+        for (j = 0; j < Ai->length; j++)
+        {
+            slong v;
+            mp_limb_t m = 1;
+            mpoly_get_monomial_ui(exps, Ai->exps + N*j, Ai->bits, ctx->minfo);
+            for (v = 0; v < nvars; v++)
+            {
+                m = nmod_mul(m, nmod_pow_ui(alphas[v], exps[v],
+                                     ctx->ffinfo->mod), ctx->ffinfo->mod);
+            }
+            S->coeffs[k] = Ai->coeffs[j];
+            S->mons[k] = m;
+            k++;
+        }
+    }
+
+    TMP_END;
+}
+
+static void _nmod_skel_clear(_nmod_skel_t S)
+{
+    flint_free(S->starts);
+    flint_free(S->coeffs);
+    flint_free(S->mons);
+}
+
+/*
+    Return the evaluation of the coefficient i of S at the point whose
+    monomial evaluations are in cur, and advance cur by inc.
+*/
+static mp_limb_t _nmod_skel_eval_step(
+    const _nmod_skel_t S,
+    slong i,
+    mp_limb_t * cur,
+    const mp_limb_t * inc,
+    nmod_t mod)
+{
+    slong k;
+    mp_limb_t V, V0, V1, V2, p0, p1;
+
+    V0 = V1 = V2 = 0;
+    for (k = S->starts[i]; k < S->starts[i + 1]; k++)
+    {
+        umul_ppmm(p1, p0, S->coeffs[k], cur[k]);
+        add_sssaaaaaa(V2, V1, V0, V2, V1, V0, WORD(0), p1, p0);
+        cur[k] = nmod_mul(cur[k], inc[k], mod);
+    }
+    NMOD_RED3(V, V2, V1, V0, mod);
+    return V;
+}
+
+static void _nmod_skel_set_powers(
+    mp_limb_t * cur,
+    mp_limb_t * inc,
+    const _nmod_skel_t S,
+    ulong curpow,
+    ulong incpow,
+    nmod_t mod)
+{
+    slong k;
+    for (k = 0; k < S->starts[S->length]; k++)
+    {
+        cur[k] = nmod_pow_ui(S->mons[k], curpow, mod);
+        inc[k] = nmod_pow_ui(S->mons[k], incpow, mod);
+    }
+}
+
+/*
+    Everything shared by the workers. The images at the next batch points
+    of the sequence omega^(w*shift), omega^(w*(shift + 1)), ... are written
+    to images[0], ..., images[batch - 1]. Worker idx handles the q with
+    q = idx mod num_workers. Since batch is a multiple of num_workers, each
+    worker keeps incrementing its own monomial evaluations from one batch to
+    the next until reset is set.
+*/
+typedef struct
+{
+    nmod_t mod;
+    slong num_workers;
+    slong batch;
+    ulong shift;
+    int reset;
+    const nmod_mpolyu_struct * A, * B;
+    const _nmod_skel_struct * Askel, * Bskel, * Gammaskel;
+    nmod_poly_struct * images;
+    int * bad;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    _base_struct * w;
+    slong idx;
+    mp_limb_t * Acur, * Ainc;
+    mp_limb_t * Bcur, * Binc;
+    mp_limb_t * Gammacur, * Gammainc;
+    nmod_poly_t a, b;
+}
+_worker_arg_struct;
+
+static void _worker_arg_init(_worker_arg_struct * arg, _base_struct * w,
+                                                                   slong idx)
+{
+    slong Alen = w->Askel->starts[w->Askel->length];
+    slong Blen = w->Bskel->starts[w->Bskel->length];
+    slong Gammalen = w->Gammaskel->starts[w->Gammaskel->length];
+
+    arg->w = w;
+    arg->idx = idx;
+    arg->Acur = (mp_limb_t *) flint_malloc(Alen*sizeof(mp_limb_t));
+    arg->Ainc = (mp_limb_t *) flint_malloc(Alen*sizeof(mp_limb_t));
+    arg->Bcur = (mp_limb_t *) flint_malloc(Blen*sizeof(mp_limb_t));
+    arg->Binc = (mp_limb_t *) flint_malloc(Blen*sizeof(mp_limb_t));
+    arg->Gammacur = (mp_limb_t *) flint_malloc(Gammalen*sizeof(mp_limb_t));
+    arg->Gammainc = (mp_limb_t *) flint_malloc(Gammalen*sizeof(mp_limb_t));
+    nmod_poly_init_mod(arg->a, w->mod);
+    nmod_poly_init_mod(arg->b, w->mod);
+}
+
+static void _worker_arg_clear(_worker_arg_struct * arg)
+{
+    flint_free(arg->Acur);
+    flint_free(arg->Ainc);
+    flint_free(arg->Bcur);
+    flint_free(arg->Binc);
+    flint_free(arg->Gammacur);
+    flint_free(arg->Gammainc);
+    nmod_poly_clear(arg->a);
+    nmod_poly_clear(arg->b);
+}
+
+static void _eval_to_poly(
+    nmod_poly_t a,
+    const nmod_mpolyu_struct * A,
+    const _nmod_skel_struct * Askel,
+    mp_limb_t * cur,
+    const mp_limb_t * inc,
+    nmod_t mod)
+{
+    slong i;
+
+    nmod_poly_zero(a);
+    for (i = 0; i < A->length; i++)
+    {
+        mp_limb_t c = _nmod_skel_eval_step(Askel, i, cur, inc, mod);
+        nmod_poly_set_coeff_ui(a, A->exps[i], c);
+    }
+}
+
+static void _worker_images(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * w = arg->w;
+    slong q;
+    mp_limb_t gammaeval;
+
+    if (w->reset)
+    {
+        _nmod_skel_set_powers(arg->Acur, arg->Ainc, w->Askel,
+                                 w->shift + arg->idx, w->num_workers, w->mod);
+        _nmod_skel_set_powers(arg->Bcur, arg->Binc, w->Bskel,
+                                 w->shift + arg->idx, w->num_workers, w->mod);
+        _nmod_skel_set_powers(arg->Gammacur, arg->Gammainc, w->Gammaskel,
+                                 w->shift + arg->idx, w->num_workers, w->mod);
+    }
+
+    for (q = arg->idx; q < w->batch; q += w->num_workers)
+    {
+        nmod_poly_struct * g = w->images + q;
+
+        _eval_to_poly(arg->a, w->A, w->Askel, arg->Acur, arg->Ainc, w->mod);
+        _eval_to_poly(arg->b, w->B, w->Bskel, arg->Bcur, arg->Binc, w->mod);
+        gammaeval = _nmod_skel_eval_step(w->Gammaskel, 0,
+                                    arg->Gammacur, arg->Gammainc, w->mod);
+
+        /* the evaluation must not kill lc(A) or lc(B) */
+        if (nmod_poly_degree(arg->a) != (slong) w->A->exps[0] ||
+            nmod_poly_degree(arg->b) != (slong) w->B->exps[0])
+        {
+            w->bad[q] = 1;
+            continue;
+        }
+
+        FLINT_ASSERT(gammaeval != 0);
+
+        w->bad[q] = 0;
+        nmod_poly_gcd(g, arg->a, arg->b);
+        nmod_poly_scalar_mul_nmod(g, g, gammaeval);
+    }
+}
+
+/*
+    Construct the coefficient of X^j in H from the Berlekamp-Massey state I
+    of the sequence of its evaluations at omega^(w*(shift + k)), k >= 0.
+    Return 1 for success and 0 if the minimal polynomial does not come from
+    monomials within the degree bounds.
+*/
+static int _nmod_bma_get_mpoly(
+    nmod_mpoly_t A,
+    flint_bitcnt_t Abits,
+    ulong shift,
+    nmod_berlekamp_massey_t I,
+    const slong * degbounds,
+    const nmod_discrete_log_pohlig_hellman_t dlog,
+    const nmod_mpoly_ctx_t ctx)
+{
+    slong i, j, t, N;
+    slong nvars = ctx->minfo->nvars;
+    int success;
+    ulong new_exp;
+    ulong * exps;
+    mp_limb_t * values, * roots;
+    mp_limb_t T, S, V, V0, V1, V2, p0, p1, r;
+    nmod_t mod = ctx->ffinfo->mod;
+    TMP_INIT;
+
+    t = nmod_poly_degree(I->V1);
+    FLINT_ASSERT(I->points->length >= t);
+
+    A->length = 0;
+
+    if (t <= 0)
+        return t == 0;
+
+    TMP_START;
+
+    exps = (ulong *) TMP_ALLOC(nvars*sizeof(ulong));
+    roots = (mp_limb_t *) TMP_ALLOC(t*sizeof(mp_limb_t));
+    values = I->points->coeffs;
+
+    success = nmod_poly_find_distinct_nonzero_roots(roots, I->V1);
+    if (!success)
+        goto cleanup;
+
+    nmod_mpoly_fit_length(A, t, ctx);
+    nmod_mpoly_fit_bits(A, Abits, ctx);
+    A->bits = Abits;
+    N = mpoly_words_per_exp(Abits, ctx->minfo);
+
+    for (i = 0; i < t; i++)
+    {
+        /*
+            coeffs[i] is (coeffs(P).values)/P(roots[i]) =: V/S
+            where P(x) = V1(x)/(x - roots[i])
+        */
+        V0 = V1 = V2 = T = S = 0;
+        r = roots[i];
+        for (j = t; j > 0; j--)
+        {
+            T = nmod_add(nmod_mul(r, T, mod), I->V1->coeffs[j], mod);
+            S = nmod_add(nmod_mul(r, S, mod), T, mod);
+            umul_ppmm(p1, p0, values[j - 1], T);
+            add_sssaaaaaa(V2, V1, V0, V2, V1, V0, WORD(0), p1, p0);
+        }
+        FLINT_ASSERT(nmod_add(nmod_mul(r, T, mod), I->V1->coeffs[0], mod) == 0);
+        NMOD_RED3(V, V2, V1, V0, mod);
+        S = nmod_mul(S, nmod_pow_ui(r, shift, mod), mod);
+        if (S == 0)
+        {
+            success = 0;
+            goto cleanup;
+        }
+        V = nmod_mul(V, nmod_inv(S, mod), mod);
+        if (V == 0)
+        {
+            success = 0;
+            goto cleanup;
+        }
+
+        new_exp = nmod_discrete_log_pohlig_hellman_run(dlog, r);
+        for (j = nvars - 1; j >= 0; j--)
+        {
+            exps[j] = new_exp % degbounds[j];
+            new_exp = new_exp / degbounds[j];
+        }
+        if (new_exp != 0)
+        {
+            success = 0;
+            goto cleanup;
+        }
+
+        A->coeffs[i] = V;
+        mpoly_set_monomial_ui(A->exps + N*i, exps, Abits, ctx->minfo);
+    }
+
+    A->length = t;
+    nmod_mpoly_sort_terms(A, ctx);
+
+    success = 1;
+
+cleanup:
+
+    TMP_END;
+    return success;
+}
+
+/* degs[j] = deg_(x_j)(A), t is temp space */
+static void _nmod_mpolyu_degrees_si(
+    slong * degs,
+    slong * t,
+    const nmod_mpolyu_t A,
+    const nmod_mpoly_ctx_t ctx)
+{
+    slong i, j;
+
+    for (j = 0; j < ctx->minfo->nvars; j++)
+        degs[j] = 0;
+
+    for (i = 0; i < A->length; i++)
+    {
+        nmod_mpoly_degrees_si(t, A->coeffs + i, ctx);
+        for (j = 0; j < ctx->minfo->nvars; j++)
+            degs[j] = FLINT_MAX(degs[j], t[j]);
+    }
+}
+
+/*
+    A and B are primitive with respect to X and Gamma = gcd(lc(A), lc(B)).
+    On success G is set to gcd(A, B) up to a scalar.
+    Return 0 if the interpolation could not be carried out in the
+    coefficient field, in which case the caller should use another algorithm.
+*/
+int nmod_mpolyu_gcd_berlekamp_massey(
+    nmod_mpolyu_t G,
+    nmod_mpolyu_t A,
+    nmod_mpolyu_t B,
+    const nmod_mpoly_t Gamma,
+    const nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    int success, changed;
+    slong i, j, nvars = ctx->minfo->nvars;
+    flint_bitcnt_t bits = A->bits;
+    nmod_t mod = ctx->ffinfo->mod;
+    mp_limb_t p = mod.n;
+    slong * degbounds, * degs, * t;
+    mp_limb_t * alphas;
+    ulong subprod, hi, omega, w;
+    double dlog_cost;
+    nmod_discrete_log_pohlig_hellman_t dlog;
+    _nmod_skel_t Askel, Bskel, Gammaskel;
+    _base_t base;
+    _worker_arg_struct * args;
+    slong num_workers, batch;
+    nmod_berlekamp_massey_struct * seqs;
+    slong bound, seqs_alloc, pointcount, maxpoints;
+    slong unlucky_count, candidate_count;
+    nmod_mpolyu_t H;
+    nmod_mpoly_t Hcontent;
+    flint_rand_t randstate;
+
+    FLINT_ASSERT(nvars > 0);
+    FLINT_ASSERT(A->length > 0 && B->length > 0);
+    FLINT_ASSERT(Gamma->length > 0);
+    FLINT_ASSERT(bits <= FLINT_BITS);
+    FLINT_ASSERT(bits == B->bits);
+
+    if (p < 3)
+        return 0;
+
+    /*
+        Strict degree bounds on H in each x_i:
+            deg_(x_i)(H) <= min(deg_(x_i)(A), deg_(x_i)(B))
+    */
+    degbounds = (slong *) flint_malloc(nvars*sizeof(slong));
+    degs = (slong *) flint_malloc(nvars*sizeof(slong));
+    t = (slong *) flint_malloc(nvars*sizeof(slong));
+    alphas = (mp_limb_t *) flint_malloc(nvars*sizeof(mp_limb_t));
+
+    _nmod_mpolyu_degrees_si(degbounds, t, A, ctx);
+    _nmod_mpolyu_degrees_si(degs, t, B, ctx);
+
+    /* the substitution must be reversible in Fp^* */
+    subprod = 1;
+    for (j = 0; j < nvars; j++)
+    {
+        degbounds[j] = 1 + FLINT_MIN(degbounds[j], degs[j]);
+        umul_ppmm(hi, subprod, subprod, degbounds[j]);
+        if (hi != 0 || subprod > p - 1)
+        {
+            flint_free(degbounds);
+            flint_free(degs);
+            flint_free(t);
+            flint_free(alphas);
+            return 0;
+        }
+    }
+
+    /* discrete logs in Fp must be cheap */
+    nmod_discrete_log_pohlig_hellman_init(dlog);
+    dlog_cost = nmod_discrete_log_pohlig_hellman_precompute_prime(dlog, p);
+    if (dlog_cost > NMOD_MPOLY_GCD_BMA_MAX_DLOG_COST)
+    {
+        nmod_discrete_log_pohlig_hellman_clear(dlog);
+        flint_free(degbounds);
+        flint_free(degs);
+        flint_free(t);
+        flint_free(alphas);
+        return 0;
+    }
+
+    omega = nmod_discrete_log_pohlig_hellman_primitive_root(dlog);
+    w = 1;
+    for (j = nvars - 1; j >= 0; j--)
+    {
+        alphas[j] = nmod_pow_ui(omega, w, mod);
+        w *= degbounds[j];
+    }
+
+    _nmod_skel_init(Askel, A->coeffs, A->length, alphas, ctx);
+    _nmod_skel_init(Bskel, B->coeffs, B->length, alphas, ctx);
+    _nmod_skel_init(Gammaskel, Gamma, 1, alphas, ctx);
+
+    num_workers = num_handles + 1;
+    batch = 2*num_workers;
+
+    base->mod = mod;
+    base->num_workers = num_workers;
+    base->batch = batch;
+    base->shift = 0;
+    base->reset = 1;
+    base->A = A;
+    base->B = B;
+    base->Askel = Askel;
+    base->Bskel = Bskel;
+    base->Gammaskel = Gammaskel;
+    base->images = (nmod_poly_struct *) flint_malloc(
+                                              batch*sizeof(nmod_poly_struct));
+    base->bad = (int *) flint_malloc(batch*sizeof(int));
+    for (i = 0; i < batch; i++)
+        nmod_poly_init_mod(base->images + i, mod);
+
+    args = (_worker_arg_struct *) flint_malloc(
+                                      num_workers*sizeof(_worker_arg_struct));
+    for (i = 0; i < num_workers; i++)
+        _worker_arg_init(args + i, base, i);
+
+    bound = FLINT_MIN(A->exps[0], B->exps[0]);
+    seqs_alloc = bound + 1;
+    seqs = (nmod_berlekamp_massey_struct *) flint_malloc(
+                               seqs_alloc*sizeof(nmod_berlekamp_massey_struct));
+    for (i = 0; i < seqs_alloc; i++)
+        nmod_berlekamp_massey_init(seqs + i, p);
+
+    nmod_mpolyu_init(H, bits, ctx);
+    nmod_mpoly_init3(Hcontent, 0, bits, ctx);
+    flint_randinit(randstate);
+
+    /* each coefficient of H has at most subprod terms */
+    maxpoints = 2*subprod + batch;
+    unlucky_count = 0;
+    candidate_count = 0;
+
+    if (bound == 0)
+        goto gcd_is_one;
+
+new_shift:
+
+    base->shift = 1 + n_urandint(randstate, p - 2);
+    base->reset = 1;
+    for (i = 0; i <= bound; i++)
+        nmod_berlekamp_massey_start_over(seqs + i);
+    pointcount = 0;
+
+next_batch:
+
+    if (pointcount > maxpoints)
+    {
+        success = 0;
+        goto cleanup;
+    }
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i], _worker_images,
+                                                                  args + i + 1);
+    }
+    _worker_images(args + 0);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+    base->reset = 0;
+
+    for (i = 0; i < batch; i++)
+    {
+        nmod_poly_struct * g = base->images + i;
+        slong gdeg;
+
+        if (base->bad[i])
+        {
+            /* the point killed a leading coefficient */
+            if (++unlucky_count > NMOD_MPOLY_GCD_BMA_MAX_UNLUCKY)
+            {
+                success = 0;
+                goto cleanup;
+            }
+            goto new_shift;
+        }
+
+        gdeg = nmod_poly_degree(g);
+        FLINT_ASSERT(gdeg >= 0);
+
+        if (gdeg > bound)
+        {
+            /* this image was unlucky */
+            if (++unlucky_count > NMOD_MPOLY_GCD_BMA_MAX_UNLUCKY)
+            {
+                success = 0;
+                goto cleanup;
+            }
+            goto new_shift;
+        }
+        else if (gdeg < bound)
+        {
+            /* all previous images were unlucky */
+            bound = gdeg;
+            if (bound == 0)
+                goto gcd_is_one;
+            goto new_shift;
+        }
+
+        for (j = 0; j <= bound; j++)
+            nmod_berlekamp_massey_add_point(seqs + j, g->coeffs[j]);
+        pointcount++;
+    }
+
+    /* the leading coefficient of H is Gamma */
+    if (pointcount < 2*Gamma->length)
+        goto next_batch;
+
+    changed = 0;
+    for (j = 0; j <= bound; j++)
+        changed |= nmod_berlekamp_massey_reduce(seqs + j);
+
+    if (changed)
+        goto next_batch;
+
+    /* try to construct H from the minimal polynomials */
+    nmod_mpolyu_fit_length(H, bound + 1, ctx);
+    H->length = 0;
+    for (j = bound; j >= 0; j--)
+    {
+        nmod_mpoly_struct * Hc = H->coeffs + H->length;
+        if (!_nmod_bma_get_mpoly(Hc, bits, base->shift, seqs + j,
+                                                       degbounds, dlog, ctx))
+        {
+            goto next_batch;
+        }
+        if (Hc->length > 0)
+        {
+            H->exps[H->length] = j;
+            H->length++;
+        }
+    }
+
+    if (H->length == 0 || H->exps[0] != (ulong) bound ||
+        !nmod_mpoly_equal(H->coeffs + 0, Gamma, ctx))
+    {
+        goto next_batch;
+    }
+
+    success = nmod_mpolyu_content_mpoly(Hcontent, H, ctx, NULL, 0);
+    if (!success)
+        goto cleanup;
+
+    nmod_mpolyu_divexact_mpoly(G, H, Hcontent, ctx);
+
+    if (nmod_mpolyu_divides(A, G, ctx) && nmod_mpolyu_divides(B, G, ctx))
+    {
+        success = 1;
+        goto cleanup;
+    }
+
+    /* the sequences stabilized too early or the substitution was unlucky */
+    if (++candidate_count > NMOD_MPOLY_GCD_BMA_MAX_UNLUCKY)
+    {
+        success = 0;
+        goto cleanup;
+    }
+
+    goto next_batch;
+
+gcd_is_one:
+
+    nmod_mpolyu_one(G, ctx);
+    success = 1;
+
+cleanup:
+
+    flint_randclear(randstate);
+    nmod_mpolyu_clear(H, ctx);
+    nmod_mpoly_clear(Hcontent, ctx);
+
+    for (i = 0; i < seqs_alloc; i++)
+        nmod_berlekamp_massey_clear(seqs + i);
+    flint_free(seqs);
+
+    for (i = 0; i < num_workers; i++)
+        _worker_arg_clear(args + i);
+    flint_free(args);
+
+    for (i = 0; i < batch; i++)
+        nmod_poly_clear(base->images + i);
+    flint_free(base->images);
+    flint_free(base->bad);
+
+    _nmod_skel_clear(Askel);
+    _nmod_skel_clear(Bskel);
+    _nmod_skel_clear(Gammaskel);
+
+    nmod_discrete_log_pohlig_hellman_clear(dlog);
+    flint_free(degbounds);
+    flint_free(degs);
+    flint_free(t);
+    flint_free(alphas);
+
+    return success;
+}
+
+/*
+    Compute the gcd of A and B after mapping the variables
+        X = x_perm[0]^Gstride[perm[0]], y_k = x_perm[k]^Gstride[perm[k]]
+    for 0 < k < m and removing the shifts Ashift and Bshift from A and B.
+    The answer is put back using Gshift and Gstride.
+*/
+int _nmod_mpoly_gcd_berlekamp_massey(
+    nmod_mpoly_t G,
+    flint_bitcnt_t Gbits,
+    const nmod_mpoly_t A,
+    const ulong * Ashift,
+    const nmod_mpoly_t B,
+    const ulong * Bshift,
+    const ulong * Gshift,
+    const ulong * Gstride,
+    const slong * perm,
+    slong m,
+    const nmod_mpoly_ctx_t ctx,
+    const thread_pool_handle * handles,
+    slong num_handles)
+{
+    int success;
+    flint_bitcnt_t ABbits;
+    nmod_mpoly_ctx_t uctx;
+    nmod_mpolyu_t Au, Bu, Gu, Abar, Bbar, Gbar;
+    nmod_mpoly_t Acontent, Bcontent, Gamma;
+
+    FLINT_ASSERT(m >= 2);
+    FLINT_ASSERT(A->bits <= FLINT_BITS);
+    FLINT_ASSERT(B->bits <= FLINT_BITS);
+
+    ABbits = FLINT_MAX(A->bits, B->bits);
+
+    nmod_mpoly_ctx_init(uctx, m - 1, ORD_LEX, ctx->ffinfo->mod.n);
+    nmod_mpolyu_init(Au, ABbits, uctx);
+    nmod_mpolyu_init(Bu, ABbits, uctx);
+    nmod_mpolyu_init(Gu, ABbits, uctx);
+    nmod_mpolyu_init(Abar, ABbits, uctx);
+    nmod_mpolyu_init(Bbar, ABbits, uctx);
+    nmod_mpolyu_init(Gbar, ABbits, uctx);
+    nmod_mpoly_init3(Acontent, 0, ABbits, uctx);
+    nmod_mpoly_init3(Bcontent, 0, ABbits, uctx);
+    nmod_mpoly_init3(Gamma, 0, ABbits, uctx);
+
+    nmod_mpoly_to_mpolyu_perm_deflate(Au, uctx, A, ctx,
+                              perm, Ashift, Gstride, handles, num_handles);
+    nmod_mpoly_to_mpolyu_perm_deflate(Bu, uctx, B, ctx,
+                              perm, Bshift, Gstride, handles, num_handles);
+
+    FLINT_ASSERT(Au->bits == ABbits);
+    FLINT_ASSERT(Bu->bits == ABbits);
+
+    /* remove content from A and B */
+    success = nmod_mpolyu_content_mpoly(Acontent, Au, uctx, NULL, 0);
+    success = success
+           && nmod_mpolyu_content_mpoly(Bcontent, Bu, uctx, NULL, 0);
+    if (!success)
+        goto cleanup;
+
+    nmod_mpolyu_divexact_mpoly(Abar, Au, Acontent, uctx);
+    nmod_mpolyu_divexact_mpoly(Bbar, Bu, Bcontent, uctx);
+
+    if (Abar->exps[0] == 0 || Bbar->exps[0] == 0)
+    {
+        nmod_mpolyu_one(Gbar, uctx);
+    }
+    else
+    {
+        success = _nmod_mpoly_gcd(Gamma, ABbits, Abar->coeffs + 0,
+                                          Bbar->coeffs + 0, uctx, NULL, 0);
+        if (!success)
+            goto cleanup;
+
+        success = nmod_mpolyu_gcd_berlekamp_massey(Gbar, Abar, Bbar, Gamma,
+                                                   uctx, handles, num_handles);
+        if (!success)
+            goto cleanup;
+    }
+
+    /* put back content */
+    success = _nmod_mpoly_gcd(Acontent, ABbits, Acontent, Bcontent, uctx,
+                                                                      NULL, 0);
+    if (!success)
+        goto cleanup;
+
+    nmod_mpolyu_mul_mpoly(Gu, Gbar, Acontent, uctx);
+    nmod_mpoly_from_mpolyu_perm_inflate(G, Gbits, ctx, Gu, uctx,
+                                                        perm, Gshift, Gstride);
+    nmod_mpoly_make_monic(G, G, ctx);
+
+    success = 1;
+
+cleanup:
+
+    nmod_mpolyu_clear(Au, uctx);
+    nmod_mpolyu_clear(Bu, uctx);
+    nmod_mpolyu_clear(Gu, uctx);
+    nmod_mpolyu_clear(Abar, uctx);
+    nmod_mpolyu_clear(Bbar, uctx);
+    nmod_mpolyu_clear(Gbar, uctx);
+    nmod_mpoly_clear(Acontent, uctx);
+    nmod_mpoly_clear(Bcontent, uctx);
+    nmod_mpoly_clear(Gamma, uctx);
+    nmod_mpoly_ctx_clear(uctx);
+
+    return success;
+}
+
+int nmod_mpoly_gcd_berlekamp_massey_threaded(
+    nmod_mpoly_t G,
+    const nmod_mpoly_t A,
+    const nmod_mpoly_t B,
+    const nmod_mpoly_ctx_t ctx,
+    slong thread_limit)
+{
+    int success;
+    slong i;
+    slong * perm;
+    ulong * shift, * stride;
+    flint_bitcnt_t ABbits;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    if (nmod_mpoly_is_zero(A, ctx))
+    {
+        if (nmod_mpoly_is_zero(B, ctx))
+            nmod_mpoly_zero(G, ctx);
+        else
+            nmod_mpoly_make_monic(G, B, ctx);
+        return 1;
+    }
+
+    if (nmod_mpoly_is_zero(B, ctx))
+    {
+        nmod_mpoly_make_monic(G, A, ctx);
+        return 1;
+    }
+
+    if (A->bits > FLINT_BITS || B->bits > FLINT_BITS)
+        return 0;
+
+    perm = (slong *) flint_malloc(ctx->minfo->nvars*sizeof(slong));
+    shift = (ulong *) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+    stride = (ulong *) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+    for (i = 0; i < ctx->minfo->nvars; i++)
+    {
+        perm[i] = i;
+        shift[i] = 0;
+        stride[i] = 1;
+    }
+
+    ABbits = FLINT_MAX(A->bits, B->bits);
+
+    if (ctx->minfo->nvars == 1)
+    {
+        nmod_poly_t a, b, g;
+        nmod_poly_init_mod(a, ctx->ffinfo->mod);
+        nmod_poly_init_mod(b, ctx->ffinfo->mod);
+        nmod_poly_init_mod(g, ctx->ffinfo->mod);
+        _nmod_mpoly_to_nmod_poly_deflate(a, A, 0, shift, stride, ctx);
+        _nmod_mpoly_to_nmod_poly_deflate(b, B, 0, shift, stride, ctx);
+        nmod_poly_gcd(g, a, b);
+        _nmod_mpoly_from_nmod_poly_inflate(G, ABbits, g, 0, shift, stride, ctx);
+        nmod_poly_clear(a);
+        nmod_poly_clear(b);
+        nmod_poly_clear(g);
+        success = 1;
+        goto cleanup;
+    }
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    success = _nmod_mpoly_gcd_berlekamp_massey(G, ABbits, A, shift, B, shift,
+                                  shift, stride, perm, ctx->minfo->nvars, ctx,
+                                                         handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles)
+        flint_free(handles);
+
+cleanup:
+
+    flint_free(perm);
+    flint_free(shift);
+    flint_free(stride);
+
+    return success;
+}
+
+int nmod_mpoly_gcd_berlekamp_massey(
+    nmod_mpoly_t G,
+    const nmod_mpoly_t A,
+    const nmod_mpoly_t B,
+    const nmod_mpoly_ctx_t ctx)
+{
+    return nmod_mpoly_gcd_berlekamp_massey_threaded(G, A, B, ctx, 1);
+}
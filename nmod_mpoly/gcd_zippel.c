@@ -10,6 +10,7 @@
 */
 
 #include "nmod_mpoly.h"
+#include "thread_pool.h"
 #include "fq_nmod_mpoly.h"
 
 int nmod_mpolyu_gcdm_zippel_bivar(
@@ -219,13 +220,15 @@ finished:
 }
 
 
-int nmod_mpolyu_gcdm_zippel(
+int nmod_mpolyu_gcdm_zippel_threaded(
     nmod_mpolyu_t G,
     nmod_mpolyu_t A,
     nmod_mpolyu_t B,
     nmod_mpoly_ctx_t ctx,
     mpoly_zipinfo_t zinfo,
-    flint_rand_t randstate)
+    flint_rand_t randstate,
+    const thread_pool_handle * handles,
+    slong num_handles)
 {
     slong degbound;
     slong bound;
@@ -241,7 +244,8 @@ int nmod_mpolyu_gcdm_zippel(
     FLINT_ASSERT(G->bits == A->bits);
     FLINT_ASSERT(B->bits == A->bits);
 
-    success = nmod_mpolyu_gcdp_zippel(G, A, B, ctx->minfo->nvars - 1, ctx, zinfo, randstate);
+    success = nmod_mpolyu_gcdp_zippel_threaded(G, A, B, ctx->minfo->nvars - 1,
+                                  ctx, zinfo, randstate, handles, num_handles);
     if (success)
     {
         return 1;
@@ -477,14 +481,28 @@ finished:
 
     return success;
 }
+int nmod_mpolyu_gcdm_zippel(
+    nmod_mpolyu_t G,
+    nmod_mpolyu_t A,
+    nmod_mpolyu_t B,
+    nmod_mpoly_ctx_t ctx,
+    mpoly_zipinfo_t zinfo,
+    flint_rand_t randstate)
+{
+    return nmod_mpolyu_gcdm_zippel_threaded(G, A, B, ctx, zinfo, randstate,
+                                                                      NULL, 0);
+}
+
 
 int _nmod_mpoly_gcd_zippel(nmod_mpoly_t G,
                             const nmod_mpoly_t A, const nmod_mpoly_t B,
                            const nmod_mpoly_ctx_t ctx, flint_rand_t randstate);
 
-int nmod_mpolyu_gcd_zippel(nmod_mpolyu_t G,
+/* the content is found serially, only the final gcdm uses the handles */
+static int _nmod_mpolyu_gcd_zippel_threaded(nmod_mpolyu_t G,
                     nmod_mpolyu_t A, nmod_mpolyu_t B, nmod_mpoly_ctx_t ctx,
-                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate)
+                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate,
+                         const thread_pool_handle * handles, slong num_handles)
 {
     int success = 0;
     slong i;
@@ -529,7 +547,8 @@ int nmod_mpolyu_gcd_zippel(nmod_mpolyu_t G,
     nmod_mpolyu_shift_right(Abar, Abar->exps[Abar->length - 1]);
     nmod_mpolyu_shift_right(Bbar, Bbar->exps[Bbar->length - 1]);
 
-    success = nmod_mpolyu_gcdm_zippel(Gbar, Abar, Bbar, ctx, zinfo, randstate);
+    success = nmod_mpolyu_gcdm_zippel_threaded(Gbar, Abar, Bbar, ctx, zinfo,
+                                               randstate, handles, num_handles);
     if (!success)
         goto finished;
 
@@ -548,6 +567,14 @@ finished:
     return success;
 }
 
+int nmod_mpolyu_gcd_zippel(nmod_mpolyu_t G,
+                    nmod_mpolyu_t A, nmod_mpolyu_t B, nmod_mpoly_ctx_t ctx,
+                                 mpoly_zipinfo_t zinfo, flint_rand_t randstate)
+{
+    return _nmod_mpolyu_gcd_zippel_threaded(G, A, B, ctx, zinfo, randstate,
+                                                                      NULL, 0);
+}
+
 /* like fq_nmod_mpoly_gcd_zippel, but G and A and B all have the same bits */
 int _nmod_mpoly_gcd_zippel(nmod_mpoly_t G,
                             const nmod_mpoly_t A, const nmod_mpoly_t B,
@@ -638,8 +665,8 @@ cleanup1:
 }
 
 
-int nmod_mpoly_gcd_zippel(nmod_mpoly_t G, const nmod_mpoly_t A,
-                              const nmod_mpoly_t B, const nmod_mpoly_ctx_t ctx)
+int nmod_mpoly_gcd_zippel_threaded(nmod_mpoly_t G, const nmod_mpoly_t A,
+       const nmod_mpoly_t B, const nmod_mpoly_ctx_t ctx, slong thread_limit)
 {
     slong i;
     flint_bitcnt_t new_bits;
@@ -649,6 +676,8 @@ int nmod_mpoly_gcd_zippel(nmod_mpoly_t G, const nmod_mpoly_t A,
     nmod_mpoly_ctx_t uctx;
     nmod_mpolyu_t Au, Bu, Gu;
     ulong * shift, * stride;
+    thread_pool_handle * handles;
+    slong num_handles;
 
     if (nmod_mpoly_is_zero(A, ctx))
     {
@@ -725,7 +754,30 @@ int nmod_mpoly_gcd_zippel(nmod_mpoly_t G, const nmod_mpoly_t A,
     nmod_mpoly_to_mpolyu_perm_deflate(Bu, uctx, B, ctx,
                                           zinfo->perm, shift, stride, NULL, 0);
 
-    success = nmod_mpolyu_gcd_zippel(Gu, Au, Bu, uctx, zinfo, randstate);
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    success = _nmod_mpolyu_gcd_zippel_threaded(Gu, Au, Bu, uctx, zinfo,
+                                               randstate, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles)
+        flint_free(handles);
+
     if (!success)
         goto cleanup;
 
@@ -750,3 +802,9 @@ cleanup1:
 
     return success;
 }
+
+int nmod_mpoly_gcd_zippel(nmod_mpoly_t G, const nmod_mpoly_t A,
+                              const nmod_mpoly_t B, const nmod_mpoly_ctx_t ctx)
+{
+    return nmod_mpoly_gcd_zippel_threaded(G, A, B, ctx, 1);
+}
@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+
+size_t nmod_mpoly_inp_raw(nmod_mpoly_t A, FILE * file,
+                                                    const nmod_mpoly_ctx_t ctx)
+{
+    slong i, N, length;
+    flint_bitcnt_t bits;
+    size_t r;
+    ulong header[MPOLY_RAW_HEADER_LENGTH];
+
+    nmod_mpoly_zero(A, ctx);
+
+    r = fread(header, sizeof(ulong), MPOLY_RAW_HEADER_LENGTH, file);
+    if (r != MPOLY_RAW_HEADER_LENGTH)
+        return 0;
+    if (!mpoly_raw_header_get(&bits, &length, header,
+                                              ctx->ffinfo->mod.n, ctx->minfo))
+        return 0;
+
+    N = mpoly_words_per_exp(bits, ctx->minfo);
+
+    nmod_mpoly_fit_length(A, length, ctx);
+    nmod_mpoly_fit_bits(A, bits, ctx);
+    A->bits = bits;
+
+    r = fread(A->exps, sizeof(ulong), N*length, file);
+    if (r != (size_t) (N*length))
+        return 0;
+
+    r = fread(A->coeffs, sizeof(mp_limb_t), length, file);
+    if (r != (size_t) length)
+        return 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (A->coeffs[i] == 0 || A->coeffs[i] >= ctx->ffinfo->mod.n)
+            return 0;
+    }
+
+    _nmod_mpoly_set_length(A, length, ctx);
+
+    return (MPOLY_RAW_HEADER_LENGTH + (N + 1)*length)*sizeof(ulong);
+}
@@ -808,10 +808,11 @@ finished:
 }
 
 
-int nmod_mpolyu_gcdp_zippel(nmod_mpolyu_t G,
+int nmod_mpolyu_gcdp_zippel_threaded(nmod_mpolyu_t G,
                      nmod_mpolyu_t A, nmod_mpolyu_t B, slong var,
                            const nmod_mpoly_ctx_t ctx, mpoly_zipinfo_t zinfo,
-                                                        flint_rand_t randstate)
+                                                        flint_rand_t randstate,
+                         const thread_pool_handle * handles, slong num_handles)
 {
     slong lastdeg;
     slong Alastdeg;
@@ -938,8 +939,8 @@ int nmod_mpolyu_gcdp_zippel(nmod_mpolyu_t G,
             goto outer_continue;
         }
 
-        success = nmod_mpolyu_gcdp_zippel(Geval, Aeval, Beval, var - 1,
-                                                        ctx, zinfo, randstate);
+        success = nmod_mpolyu_gcdp_zippel_threaded(Geval, Aeval, Beval,
+                      var - 1, ctx, zinfo, randstate, handles, num_handles);
         if (!success || Geval->exps[0] > degbound)
         {
             success = 0;
@@ -1032,8 +1033,8 @@ int nmod_mpolyu_gcdp_zippel(nmod_mpolyu_t G,
                 goto inner_continue;
             }
 
-            switch (nmod_mpolyu_gcds_zippel(Geval, Aeval, Beval, Gform, var,
-                                                    ctx, randstate, &degbound))
+            switch (nmod_mpolyu_gcds_zippel_threaded(Geval, Aeval, Beval,
+                  Gform, var, ctx, randstate, &degbound, handles, num_handles))
             {
                 default:
                     FLINT_ASSERT(0);
@@ -1129,3 +1130,12 @@ finished:
 
     return success;
 }
+
+int nmod_mpolyu_gcdp_zippel(nmod_mpolyu_t G,
+                     nmod_mpolyu_t A, nmod_mpolyu_t B, slong var,
+                           const nmod_mpoly_ctx_t ctx, mpoly_zipinfo_t zinfo,
+                                                        flint_rand_t randstate)
+{
+    return nmod_mpolyu_gcdp_zippel_threaded(G, A, B, var, ctx, zinfo,
+                                                         randstate, NULL, 0);
+}
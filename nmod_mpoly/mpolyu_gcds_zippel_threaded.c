@@ -0,0 +1,610 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+#include "thread_pool.h"
+
+/*
+    This is nmod_mpolyu_gcds_zippel with the two expensive loops spread over
+    the thread pool:
+
+    (1) The l univariate images are all independent. Image i is computed
+        from the evaluation of the monomials at alpha^(i + 1), so worker w
+        starts at power w + 1 and steps by the number of workers.
+
+    (2) Once the scale factors are known, the Vandermonde systems for the
+        coefficients of the form are independent and each is solved and
+        checked by one worker.
+
+    The serial steps in between (the nullspace for the scale factors) and
+    the interpretation of the return codes are the same as the serial
+    version, so that both functions make the same decisions.
+*/
+
+/* status of one image or one Vandermonde system */
+#define _GCDS_OK            0
+#define _GCDS_LC_VANISHED   1
+#define _GCDS_DEG_TOO_HIGH  2
+#define _GCDS_DEG_TOO_LOW   3
+#define _GCDS_FORM_WRONG    4
+#define _GCDS_SINGULAR      5
+#define _GCDS_NO_SOLUTION   6
+
+typedef struct
+{
+    nmod_mpolyu_struct * A, * B, * f, * G;
+    nmod_mpolyu_struct * Aevalsk1, * Bevalsk1, * fevalsk1;
+    nmod_mat_struct * M;
+    nmod_mat_struct * Msol;
+    mp_limb_t * W;
+    slong l;
+    slong num_threads;
+    int * image_status;
+    slong * image_degree;
+    int * solve_status;
+    const nmod_mpoly_ctx_struct * ctx;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    _base_struct * base;
+    slong idx;
+}
+_worker_arg_struct;
+
+
+/* set the coefficients of A to the e^th powers of those of B */
+static void _nmod_mpolyu_powsk(nmod_mpolyu_t A, const nmod_mpolyu_t B,
+                                           ulong e, const nmod_mpoly_ctx_t ctx)
+{
+    slong i, j;
+
+    nmod_mpolyu_set(A, B, ctx);
+    for (i = 0; i < A->length; i++)
+    {
+        for (j = 0; j < (A->coeffs + i)->length; j++)
+        {
+            (A->coeffs + i)->coeffs[j] = nmod_pow_ui(
+                          (A->coeffs + i)->coeffs[j], e, ctx->ffinfo->mod);
+        }
+    }
+}
+
+
+static void _worker_images(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * w = arg->base;
+    const nmod_mpoly_ctx_struct * ctx = w->ctx;
+    nmod_mpolyu_struct * f = w->f;
+    slong i, j, k;
+    nmod_mpolyu_t Aevalski, Bevalski, fevalski, Astep, Bstep, fstep;
+    nmod_poly_t Aeval, Beval, Geval;
+
+    nmod_mpolyu_init(Aevalski, f->bits, ctx);
+    nmod_mpolyu_init(Bevalski, f->bits, ctx);
+    nmod_mpolyu_init(fevalski, f->bits, ctx);
+    nmod_mpolyu_init(Astep, f->bits, ctx);
+    nmod_mpolyu_init(Bstep, f->bits, ctx);
+    nmod_mpolyu_init(fstep, f->bits, ctx);
+    nmod_poly_init_mod(Aeval, ctx->ffinfo->mod);
+    nmod_poly_init_mod(Beval, ctx->ffinfo->mod);
+    nmod_poly_init_mod(Geval, ctx->ffinfo->mod);
+
+    _nmod_mpolyu_powsk(Aevalski, w->Aevalsk1, arg->idx + 1, ctx);
+    _nmod_mpolyu_powsk(Bevalski, w->Bevalsk1, arg->idx + 1, ctx);
+    _nmod_mpolyu_powsk(fevalski, w->fevalsk1, arg->idx + 1, ctx);
+    _nmod_mpolyu_powsk(Astep, w->Aevalsk1, w->num_threads, ctx);
+    _nmod_mpolyu_powsk(Bstep, w->Bevalsk1, w->num_threads, ctx);
+    _nmod_mpolyu_powsk(fstep, w->fevalsk1, w->num_threads, ctx);
+
+    for (i = arg->idx; i < w->l; i += w->num_threads)
+    {
+        if (i != arg->idx)
+        {
+            nmod_mpolyu_mulsk(Aevalski, Astep, ctx);
+            nmod_mpolyu_mulsk(Bevalski, Bstep, ctx);
+            nmod_mpolyu_mulsk(fevalski, fstep, ctx);
+        }
+
+        for (j = 0; j < f->length; j++)
+        {
+            for (k = 0; k < (f->coeffs + j)->length; k++)
+            {
+                (w->M + j)->rows[i][k] = (fevalski->coeffs + j)->coeffs[k];
+            }
+        }
+
+        if (   !nmod_mpolyu_evalfromsk(Aeval, w->A, Aevalski, ctx)
+            || !nmod_mpolyu_evalfromsk(Beval, w->B, Bevalski, ctx))
+        {
+            w->image_status[i] = _GCDS_LC_VANISHED;
+            continue;
+        }
+
+        nmod_poly_gcd(Geval, Aeval, Beval);
+        w->image_degree[i] = nmod_poly_degree(Geval);
+
+        if (f->exps[0] < nmod_poly_degree(Geval))
+        {
+            w->image_status[i] = _GCDS_DEG_TOO_HIGH;
+            continue;
+        }
+
+        if (f->exps[0] > nmod_poly_degree(Geval))
+        {
+            w->image_status[i] = _GCDS_DEG_TOO_LOW;
+            continue;
+        }
+
+        w->image_status[i] = _GCDS_OK;
+        k = nmod_poly_length(Geval);
+        j = WORD(0);
+        while ((--k) >= 0)
+        {
+            mp_limb_t ck = nmod_poly_get_coeff_ui(Geval, k);
+            if (ck != UWORD(0))
+            {
+                while (j < f->length && f->exps[j] > k)
+                {
+                    j++;
+                }
+                if (j >= f->length || f->exps[j] != k)
+                {
+                    w->image_status[i] = _GCDS_FORM_WRONG;
+                    break;
+                }
+                w->W[w->l*j + i] = ck;
+            }
+        }
+    }
+
+    nmod_mpolyu_clear(Aevalski, ctx);
+    nmod_mpolyu_clear(Bevalski, ctx);
+    nmod_mpolyu_clear(fevalski, ctx);
+    nmod_mpolyu_clear(Astep, ctx);
+    nmod_mpolyu_clear(Bstep, ctx);
+    nmod_mpolyu_clear(fstep, ctx);
+    nmod_poly_clear(Aeval);
+    nmod_poly_clear(Beval);
+    nmod_poly_clear(Geval);
+}
+
+
+static void _worker_solve(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * w = arg->base;
+    const nmod_mpoly_ctx_struct * ctx = w->ctx;
+    nmod_mpolyu_struct * f = w->f;
+    nmod_mpolyu_struct * G = w->G;
+    slong i, j, s;
+    mp_limb_t * b;
+
+    b = (mp_limb_t *) flint_malloc(w->l*sizeof(mp_limb_t));
+
+    for (s = arg->idx; s < f->length; s += w->num_threads)
+    {
+        mp_limb_t pp0, pp1, ac0, ac1, ac2, u, v;
+
+        FLINT_ASSERT((f->coeffs + s)->length <= w->l);
+        for (j = 0; j < (f->coeffs + s)->length; j++)
+        {
+            b[j] = nmod_mul(w->W[w->l*s + j],
+                          nmod_mat_get_entry(w->Msol, j, 0), ctx->ffinfo->mod);
+        }
+
+        if (!nmod_vandsolve((G->coeffs + s)->coeffs,
+                            (w->fevalsk1->coeffs + s)->coeffs, b,
+                                    (f->coeffs + s)->length, ctx->ffinfo->mod))
+        {
+            w->solve_status[s] = _GCDS_SINGULAR;
+            continue;
+        }
+
+        w->solve_status[s] = _GCDS_OK;
+        for (i = 0; i < w->l; i++)
+        {
+            ac0 = ac1 = ac2 = 0;
+            for (j = 0; j < (f->coeffs + s)->length; j++)
+            {
+                umul_ppmm(pp1, pp0, (w->M + s)->rows[i][j],
+                                    (G->coeffs + s)->coeffs[j]);
+                add_sssaaaaaa(ac2, ac1, ac0, ac2, ac1, ac0, WORD(0), pp1, pp0);
+            }
+
+            NMOD_RED3(v, ac2, ac1, ac0, ctx->ffinfo->mod);
+            u = nmod_mul(w->W[w->l*s + i], nmod_mat_get_entry(w->Msol, i, 0),
+                                                             ctx->ffinfo->mod);
+            if (v != u)
+            {
+                w->solve_status[s] = _GCDS_NO_SOLUTION;
+                break;
+            }
+        }
+    }
+
+    flint_free(b);
+}
+
+
+/*
+    Try to set G to the gcd of A and B given the form f of G.
+    Same return codes as nmod_mpolyu_gcds_zippel.
+*/
+nmod_gcds_ret_t nmod_mpolyu_gcds_zippel_threaded(nmod_mpolyu_t G,
+               nmod_mpolyu_t A, nmod_mpolyu_t B, nmod_mpolyu_t f, slong var,
+          const nmod_mpoly_ctx_t ctx, flint_rand_t randstate, slong * degbound,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    int eval_points_tried;
+    nmod_gcds_ret_t success;
+    nmod_mpolyu_t Aevalsk1, Bevalsk1, fevalsk1;
+    mp_limb_t * alpha;
+    nmod_mat_struct * M, * ML;
+    nmod_mat_t MF, Msol;
+    int underdeterminedcount = 0;
+    int exceededcount = 0;
+    int * ML_is_initialized;
+    slong i, j, s, S, nullity;
+    slong * d;
+    slong l;
+    mp_limb_t * W;
+    slong entries;
+    slong * offs;
+    ulong * masks;
+    mp_limb_t * powers;
+    _base_t base;
+    _worker_arg_struct * args;
+    TMP_INIT;
+
+    FLINT_ASSERT(A->length > 0);
+    FLINT_ASSERT(B->length > 0);
+    FLINT_ASSERT(f->length > 0);
+
+    FLINT_ASSERT(A->bits == B->bits);
+    FLINT_ASSERT(A->bits == G->bits);
+    FLINT_ASSERT(A->bits == f->bits);
+    FLINT_ASSERT(var > 0);
+
+    FLINT_ASSERT(*degbound == f->exps[0]);
+
+    if (num_handles < 1 || f->length == 1)
+    {
+        return nmod_mpolyu_gcds_zippel(G, A, B, f, var, ctx,
+                                                          randstate, degbound);
+    }
+
+    TMP_START;
+
+    nmod_mpolyu_init(Aevalsk1, f->bits, ctx);
+    nmod_mpolyu_init(Bevalsk1, f->bits, ctx);
+    nmod_mpolyu_init(fevalsk1, f->bits, ctx);
+
+    d = (slong *) TMP_ALLOC(f->length*sizeof(slong));
+    for (i = 0; i < f->length; i++)
+    {
+        d[i] = i;
+    }
+
+    /* sort as in the serial version */
+    for (i = 1; i < f->length; i++)
+    {
+        for (j = i; j > 0 && (f->coeffs + d[j-1])->length
+                           > (f->coeffs + d[j-0])->length; j--)
+        {
+            slong temp = d[j-1];
+            d[j-1] = d[j-0];
+            d[j-0] = temp;
+        }
+    }
+
+    /* l is the number of images we will try to construct */
+    l = f->length - 3;
+    for (i = 0; i < f->length; i++)
+    {
+        l += (f->coeffs + i)->length;
+    }
+    l = l / (f->length - 1);
+    l = FLINT_MAX(l, (f->coeffs + d[f->length - 1])->length);
+    /* one extra test image */
+    l += 1;
+
+    alpha = (mp_limb_t *) TMP_ALLOC(var*sizeof(mp_limb_t));
+    ML = (nmod_mat_struct *) TMP_ALLOC(f->length*sizeof(nmod_mat_struct));
+
+    nmod_mat_init(MF, 0, l, ctx->ffinfo->mod.n);
+
+    M = (nmod_mat_struct *) TMP_ALLOC(f->length*sizeof(nmod_mat_struct));
+    ML_is_initialized = (int *) TMP_ALLOC(f->length*sizeof(int));
+    for (i = 0; i < f->length; i++)
+    {
+        nmod_mat_init(M + i, l, (f->coeffs + i)->length, ctx->ffinfo->mod.n);
+        ML_is_initialized[i] = 0;
+    }
+
+    W = (mp_limb_t *) flint_malloc(l*f->length*sizeof(mp_limb_t));
+
+    nmod_mat_init(Msol, l, 1, ctx->ffinfo->mod.n);
+
+    entries = f->bits * var;
+    offs = (slong *) TMP_ALLOC(entries*sizeof(slong));
+    masks = (ulong *) TMP_ALLOC(entries*sizeof(slong));
+    powers = (mp_limb_t *) TMP_ALLOC(entries*sizeof(mp_limb_t));
+
+    base->A = A;
+    base->B = B;
+    base->f = f;
+    base->G = G;
+    base->Aevalsk1 = Aevalsk1;
+    base->Bevalsk1 = Bevalsk1;
+    base->fevalsk1 = fevalsk1;
+    base->M = M;
+    base->Msol = Msol;
+    base->W = W;
+    base->l = l;
+    base->num_threads = num_handles + 1;
+    base->image_status = (int *) flint_malloc(l*sizeof(int));
+    base->image_degree = (slong *) flint_malloc(l*sizeof(slong));
+    base->solve_status = (int *) flint_malloc(f->length*sizeof(int));
+    base->ctx = ctx;
+
+    args = (_worker_arg_struct *) flint_malloc(base->num_threads
+                                                 *sizeof(_worker_arg_struct));
+    for (i = 0; i < base->num_threads; i++)
+    {
+        args[i].base = base;
+        args[i].idx = i;
+    }
+
+    /***** evaluation loop head *******/
+    eval_points_tried = 0;
+pick_evaluation_point:
+
+    if (++eval_points_tried > 10)
+    {
+        success = nmod_gcds_eval_point_not_found;
+        goto finished;
+    }
+
+    /* avoid 0, 1 and -1 for the evaluation points */
+    FLINT_ASSERT(ctx->ffinfo->mod.n > UWORD(3));
+    for (i = 0; i < var; i++)
+        alpha[i] = UWORD(2) + n_randint(randstate,
+                                              ctx->ffinfo->mod.n - UWORD(3));
+
+    /* store bit masks for each power of two of the non-main variables */
+    for (i = 0; i < var; i++)
+    {
+        slong shift, off;
+        mpoly_gen_offset_shift_sp(&off, &shift, i, f->bits, ctx->minfo);
+        for (j = 0; j < f->bits; j++)
+        {
+            offs[f->bits*i + j] = off;
+            masks[f->bits*i + j] = UWORD(1) << (j + shift);
+            if (j == 0)
+                powers[f->bits*i + j] = alpha[i];
+            else
+                powers[f->bits*i + j] = nmod_mul(powers[f->bits*i + j-1],
+                                                 powers[f->bits*i + j-1],
+                                                             ctx->ffinfo->mod);
+        }
+    }
+
+    nmod_mpolyu_evalsk(Aevalsk1, A, entries, offs, masks, powers, ctx);
+    nmod_mpolyu_evalsk(Bevalsk1, B, entries, offs, masks, powers, ctx);
+    nmod_mpolyu_evalsk(fevalsk1, f, entries, offs, masks, powers, ctx);
+
+    for (i = 0; i < l*f->length; i++)
+    {
+        W[i] = 0;
+    }
+
+    /* compute the l images in parallel */
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                  _worker_images, args + i + 1);
+    }
+    _worker_images(args + 0);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    /* act on the first bad image exactly as the serial version would */
+    for (i = 0; i < l; i++)
+    {
+        switch (base->image_status[i])
+        {
+            case _GCDS_LC_VANISHED:
+                goto pick_evaluation_point;
+
+            case _GCDS_DEG_TOO_HIGH:
+                ++exceededcount;
+                if (exceededcount < 2)
+                    goto pick_evaluation_point;
+                success = nmod_gcds_eval_gcd_deg_too_high;
+                goto finished;
+
+            case _GCDS_DEG_TOO_LOW:
+                success = nmod_gcds_form_main_degree_too_high;
+                *degbound = base->image_degree[i];
+                goto finished;
+
+            case _GCDS_FORM_WRONG:
+                success = nmod_gcds_form_wrong;
+                goto finished;
+
+            default:
+                FLINT_ASSERT(base->image_status[i] == _GCDS_OK);
+        }
+    }
+
+    nullity = -1;
+    nmod_mat_clear(MF);
+    nmod_mat_init(MF, 0, l, ctx->ffinfo->mod.n);
+
+    for (S = 0; S < f->length; S++)
+    {
+        s = d[S];
+
+        if (!ML_is_initialized[s])
+        {
+            nmod_mat_init(ML + s, l, (f->coeffs + s)->length + l,
+                                                           ctx->ffinfo->mod.n);
+            ML_is_initialized[s] = 1;
+            for (i = 0; i < l; i++)
+            {
+                for (j = 0; j < (f->coeffs + s)->length; j++)
+                {
+                    (ML + s)->rows[i][j] = (M + s)->rows[i][j];
+                }
+                (ML + s)->rows[i][(f->coeffs + s)->length + i] = W[l*s + i];
+            }
+        }
+        else
+        {
+            for (i = 0; i < l; i++)
+            {
+                for (j = 0; j < (f->coeffs + s)->length; j++)
+                {
+                    (ML + s)->rows[i][j] = (M + s)->rows[i][j];
+                }
+                for (j = 0; j < l; j++)
+                {
+                    (ML + s)->rows[i][(f->coeffs + s)->length + j]
+                                             = (j==i ? W[l*s + i] : UWORD(0));
+                }
+            }
+        }
+        nmod_mat_rref(ML + s);
+
+        for (i = 0; i < (f->coeffs + s)->length; i++)
+        {
+            if ((ML + s)->rows[i][i] != UWORD(1))
+            {
+                /* evaluation points produced a singular vandermonde matrix */
+                goto pick_evaluation_point;
+            }
+        }
+
+        {
+            /* appends rows to MF */
+            nmod_mat_t MFtemp;
+            nmod_mat_t Mwindow;
+
+            nmod_mat_window_init(Mwindow, ML + s,
+                    (f->coeffs + s)->length, (f->coeffs + s)->length,
+                     l, (f->coeffs + s)->length + l);
+            nmod_mat_init(MFtemp,
+                             nmod_mat_nrows(MF) + l - (f->coeffs + s)->length,
+                             l, ctx->ffinfo->mod.n);
+            nmod_mat_concat_vertical(MFtemp, MF, Mwindow);
+            nmod_mat_swap(MFtemp, MF);
+            nmod_mat_clear(MFtemp);
+            nmod_mat_window_clear(Mwindow);
+        }
+
+        nullity = l - nmod_mat_rref(MF);
+
+        if (nullity == 0)
+        {
+            /* There is no solution for scale factors. Form f must be wrong */
+            success = nmod_gcds_form_wrong;
+            goto finished;
+        }
+        if (nullity == 1)
+        {
+            /*
+                There is one solution for scale factors based on equations
+                considered thus far. Accept this as a solution and perform
+                checks of the remaining equations at the end.
+            */
+            break;
+        }
+    }
+
+    if (nullity != 1)
+    {
+        ++underdeterminedcount;
+        if (underdeterminedcount < 2)
+            goto pick_evaluation_point;
+
+        success = nmod_gcds_scales_not_found;
+        goto finished;
+    }
+
+    nullity = nmod_mat_nullspace(Msol, MF);
+    FLINT_ASSERT(nullity == 1);
+
+    nmod_mpolyu_set(G, f, ctx);
+
+    /* solve and check the vandermonde systems in parallel */
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                   _worker_solve, args + i + 1);
+    }
+    _worker_solve(args + 0);
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    for (s = 0; s < f->length; s++)
+    {
+        if (base->solve_status[s] == _GCDS_SINGULAR)
+        {
+            /* evaluation points produced a singular vandermonde matrix */
+            goto pick_evaluation_point;
+        }
+    }
+
+    for (s = 0; s < f->length; s++)
+    {
+        if (base->solve_status[s] == _GCDS_NO_SOLUTION)
+        {
+            success = nmod_gcds_no_solution;
+            goto finished;
+        }
+    }
+
+    success = nmod_gcds_success;
+
+finished:
+
+    flint_free(args);
+    flint_free(base->image_status);
+    flint_free(base->image_degree);
+    flint_free(base->solve_status);
+
+    flint_free(W);
+    nmod_mat_clear(MF);
+    nmod_mat_clear(Msol);
+    for (i = 0; i < f->length; i++)
+    {
+        nmod_mat_clear(M + i);
+        if (ML_is_initialized[i])
+        {
+            nmod_mat_clear(ML + i);
+        }
+    }
+    nmod_mpolyu_clear(Aevalsk1, ctx);
+    nmod_mpolyu_clear(Bevalsk1, ctx);
+    nmod_mpolyu_clear(fevalsk1, ctx);
+
+    TMP_END;
+    return success;
+}
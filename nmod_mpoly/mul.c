@@ -12,7 +12,7 @@
 #include "nmod_mpoly.h"
 
 static int _try_dense(int try_array, slong * Bdegs, slong * Cdegs,
-                                           slong Blen, slong Clen, slong nvars)
+                       slong Blen, slong Clen, slong nvars, slong num_handles)
 {
     slong i, product_count, dense_size;
     ulong hi;
@@ -29,7 +29,11 @@ static int _try_dense(int try_array, slong * Bdegs, slong * Cdegs,
             return 0;
     }
 
-    if (dense_size > WORD(5000000))
+    /*
+        The threaded dense method splits the product along the outermost
+        variable, so each thread sees only its share of the dense size.
+    */
+    if (dense_size/(num_handles + 1) > WORD(5000000))
         return 0;
 
     umul_ppmm(hi, product_count, Blen, Clen);
@@ -51,6 +55,36 @@ static int _try_dense(int try_array, slong * Bdegs, slong * Cdegs,
 }
 
 
+/*
+    The dense size bounds the number of terms in the product. If each term
+    is on average the sum of many products, then the hash table stays small
+    relative to the amount of work and accumulation beats merging.
+*/
+static int _try_hash(slong * Bdegs, slong * Cdegs,
+                                           slong Blen, slong Clen, slong nvars)
+{
+    slong i, product_count, dense_size;
+    ulong hi;
+
+    FLINT_ASSERT(Blen > 0);
+    FLINT_ASSERT(Clen > 0);
+
+    dense_size = WORD(1);
+    for (i = 0; i < nvars; i++)
+    {
+        umul_ppmm(hi, dense_size, dense_size, Bdegs[i] + Cdegs[i] + 1);
+        if (hi != 0 || dense_size <= 0)
+            return 0;
+    }
+
+    umul_ppmm(hi, product_count, Blen, Clen);
+    if (hi != 0 || product_count < 0)
+        return 1;
+
+    return dense_size < product_count/16;
+}
+
+
 static int _try_array_LEX(slong * Bdegs, slong * Cdegs,
                                            slong Blen, slong Clen, slong nvars)
 {
@@ -214,9 +248,14 @@ void nmod_mpoly_mul_threaded(
     }
 
     success = 0;
-    if (_try_dense(try_array, Bdegs, Cdegs, B->length, C->length, nvars))
+    if (_try_dense(try_array, Bdegs, Cdegs, B->length, C->length, nvars,
+                                                                  num_handles))
     {
-        success = _nmod_mpoly_mul_dense(A, B, maxBfields, C, maxCfields, ctx);
+        success = (num_handles > 0)
+                ? _nmod_mpoly_mul_dense_threaded(
+                                    A, B, maxBfields, C, maxCfields, ctx,
+                                                         handles, num_handles)
+                : _nmod_mpoly_mul_dense(A, B, maxBfields, C, maxCfields, ctx);
         if (success)
         {
             goto done;
@@ -225,7 +264,7 @@ void nmod_mpoly_mul_threaded(
 
     if (!try_array)
     {
-        goto do_heap;
+        goto do_hash;
     }
 
     if (ctx->minfo->ord == ORD_LEX)
@@ -252,6 +291,22 @@ void nmod_mpoly_mul_threaded(
         goto done;
     }
 
+do_hash:
+
+    if (_try_hash(Bdegs, Cdegs, B->length, C->length, nvars))
+    {
+        if (num_handles > 0)
+        {
+            _nmod_mpoly_mul_hash_threaded_maxfields(A,
+                      B, maxBfields, C, maxCfields, ctx, handles, num_handles);
+        }
+        else
+        {
+            _nmod_mpoly_mul_hash_maxfields(A, B, maxBfields, C, maxCfields, ctx);
+        }
+        goto done;
+    }
+
 do_heap:
 
     if (num_handles > 0)
@@ -9,16 +9,187 @@
     (at your option) any later version.  See <http://www.gnu.org/licenses/>.
 */
 
+#include "thread_pool.h"
 #include "nmod_poly.h"
 #include "nmod_mpoly.h"
 
-int _nmod_mpoly_mul_dense(nmod_mpoly_t P,
+/*
+    The Kronecker substitution of the dense product is split along the
+    outermost variable: the longer factor is cut into one run of consecutive
+    outer slices (each of length "stride") per thread and each run is
+    multiplied by the full other factor. The partial products overlap, so in
+    a second pass each thread sums the pieces landing in its own disjoint
+    slab of the output.
+*/
+typedef struct
+{
+    nmod_poly_struct * P;
+    const nmod_poly_struct * A;
+    const nmod_poly_struct * B;
+    nmod_poly_struct * T;
+    slong * Toff;
+    slong num_chunks;
+    slong num_slices;
+    slong stride;
+}
+_chunked_base_struct;
+
+typedef _chunked_base_struct _chunked_base_t[1];
+
+typedef struct
+{
+    _chunked_base_struct * base;
+    slong idx;
+}
+_chunked_arg_struct;
+
+static void _chunked_mul_worker(void * varg)
+{
+    _chunked_arg_struct * arg = (_chunked_arg_struct *) varg;
+    _chunked_base_struct * base = arg->base;
+    slong i = arg->idx, K = base->num_chunks;
+    slong start, stop;
+    mp_srcptr Acoeffs = base->A->coeffs;
+    nmod_poly_struct a[1];
+
+    start = base->stride*(base->num_slices*i/K);
+    stop = base->stride*(base->num_slices*(i + 1)/K);
+    stop = FLINT_MIN(stop, base->A->length);
+
+    while (start < stop && Acoeffs[start] == 0)
+        start++;
+    while (stop > start && Acoeffs[stop - 1] == 0)
+        stop--;
+
+    base->Toff[i] = start;
+    if (start >= stop)
+    {
+        nmod_poly_zero(base->T + i);
+        return;
+    }
+
+    /* let a borrow the run of A */
+    a->coeffs = (mp_ptr) Acoeffs + start;
+    a->alloc = stop - start;
+    a->length = stop - start;
+    a->mod = base->A->mod;
+
+    nmod_poly_mul(base->T + i, a, base->B);
+}
+
+static void _chunked_merge_worker(void * varg)
+{
+    _chunked_arg_struct * arg = (_chunked_arg_struct *) varg;
+    _chunked_base_struct * base = arg->base;
+    slong i, j = arg->idx, K = base->num_chunks;
+    slong lo, hi, s, e, Plen = base->P->length;
+    mp_ptr Pcoeffs = base->P->coeffs;
+
+    lo = Plen*j/K;
+    hi = Plen*(j + 1)/K;
+
+    _nmod_vec_zero(Pcoeffs + lo, hi - lo);
+
+    for (i = 0; i < K; i++)
+    {
+        s = FLINT_MAX(lo, base->Toff[i]);
+        e = FLINT_MIN(hi, base->Toff[i] + base->T[i].length);
+        if (s < e)
+            _nmod_vec_add(Pcoeffs + s, Pcoeffs + s,
+                    base->T[i].coeffs + s - base->Toff[i], e - s, base->P->mod);
+    }
+}
+
+/* P = A*B where A and B are Kronecker substitutions with outer slices of
+   length stride; P should not alias A or B */
+static void _nmod_poly_mul_chunked(nmod_poly_t P,
+                            const nmod_poly_t A, const nmod_poly_t B,
+     slong stride, const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, K;
+    _chunked_base_t base;
+    _chunked_arg_struct * args;
+
+    if (A->length == 0 || B->length == 0)
+    {
+        nmod_poly_zero(P);
+        return;
+    }
+
+    /* cut the longer factor */
+    if (A->length < B->length)
+    {
+        const nmod_poly_struct * t = A;
+        A = B;
+        B = t;
+    }
+
+    base->num_slices = (A->length + stride - 1)/stride;
+    K = FLINT_MIN(num_handles + 1, base->num_slices);
+    if (K < 2)
+    {
+        nmod_poly_mul(P, A, B);
+        return;
+    }
+
+    base->P = P;
+    base->A = A;
+    base->B = B;
+    base->num_chunks = K;
+    base->stride = stride;
+    base->Toff = (slong *) flint_malloc(K*sizeof(slong));
+    base->T = (nmod_poly_struct *) flint_malloc(K*sizeof(nmod_poly_struct));
+    args = (_chunked_arg_struct *) flint_malloc(K*sizeof(_chunked_arg_struct));
+    for (i = 0; i < K; i++)
+    {
+        nmod_poly_init_mod(base->T + i, A->mod);
+        args[i].base = base;
+        args[i].idx = i;
+    }
+
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                                _chunked_mul_worker, &args[i]);
+    }
+    _chunked_mul_worker(&args[K - 1]);
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    nmod_poly_fit_length(P, A->length + B->length - 1);
+    P->length = A->length + B->length - 1;
+
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wake(global_thread_pool, handles[i],
+                                              _chunked_merge_worker, &args[i]);
+    }
+    _chunked_merge_worker(&args[K - 1]);
+    for (i = 0; i + 1 < K; i++)
+    {
+        thread_pool_wait(global_thread_pool, handles[i]);
+    }
+
+    _nmod_poly_normalise(P);
+
+    for (i = 0; i < K; i++)
+        nmod_poly_clear(base->T + i);
+    flint_free(base->T);
+    flint_free(base->Toff);
+    flint_free(args);
+}
+
+
+int _nmod_mpoly_mul_dense_threaded(nmod_mpoly_t P,
                                  const nmod_mpoly_t A, fmpz * maxAfields,
                                  const nmod_mpoly_t B, fmpz * maxBfields,
-                                                    const nmod_mpoly_ctx_t ctx)
+                                                    const nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
 {
     int success = 1;
-    slong i;
+    slong i, stride;
     slong nvars = ctx->minfo->nvars;
     nmod_mpolyd_ctx_t dctx;
     nmod_mpolyd_t Ad, Bd, Pd;
@@ -102,7 +273,13 @@ int _nmod_mpoly_mul_dense(nmod_mpoly_t P,
     Pu->mod.ninv = ctx->ffinfo->mod.ninv;
     Pu->mod.norm = ctx->ffinfo->mod.norm;
 
-    nmod_poly_mul(Pu, Au, Bu);
+    /* length of a slice of the outermost variable */
+    stride = 1;
+    for (i = 0; i < nvars; i++)
+        if (i != dctx->perm[0])
+            stride *= Pbounds[i];
+
+    _nmod_poly_mul_chunked(Pu, Au, Bu, stride, handles, num_handles);
 
     /* manually move Pu to P */
     Pd->coeff_alloc = Pu->alloc;
@@ -133,12 +310,23 @@ failed_stage1:
 }
 
 
-int nmod_mpoly_mul_dense(nmod_mpoly_t A, const nmod_mpoly_t B,
-                              const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx)
+int _nmod_mpoly_mul_dense(nmod_mpoly_t P,
+                                 const nmod_mpoly_t A, fmpz * maxAfields,
+                                 const nmod_mpoly_t B, fmpz * maxBfields,
+                                                    const nmod_mpoly_ctx_t ctx)
+{
+    return _nmod_mpoly_mul_dense_threaded(P, A, maxAfields, B, maxBfields,
+                                                                  ctx, NULL, 0);
+}
+
+int nmod_mpoly_mul_dense_threaded(nmod_mpoly_t A, const nmod_mpoly_t B,
+       const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx, slong thread_limit)
 {
     slong i;
     int success;
     fmpz * maxBfields, * maxCfields;
+    thread_pool_handle * handles;
+    slong num_handles;
     TMP_INIT;
 
     if (B->length == 0 || C->length == 0)
@@ -164,7 +352,33 @@ int nmod_mpoly_mul_dense(nmod_mpoly_t A, const nmod_mpoly_t B,
     mpoly_max_fields_fmpz(maxBfields, B->exps, B->length, B->bits, ctx->minfo);
     mpoly_max_fields_fmpz(maxCfields, C->exps, C->length, C->bits, ctx->minfo);
 
-    success = _nmod_mpoly_mul_dense(A, B, maxBfields, C, maxCfields, ctx);
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    success = _nmod_mpoly_mul_dense_threaded(A, B, maxBfields, C, maxCfields,
+                                                    ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
 
     for (i = 0; i < ctx->minfo->nfields; i++)
     {
@@ -175,3 +389,9 @@ int nmod_mpoly_mul_dense(nmod_mpoly_t A, const nmod_mpoly_t B,
     TMP_END;
     return success;
 }
+
+int nmod_mpoly_mul_dense(nmod_mpoly_t A, const nmod_mpoly_t B,
+                              const nmod_mpoly_t C, const nmod_mpoly_ctx_t ctx)
+{
+    return nmod_mpoly_mul_dense_threaded(A, B, C, ctx, 1);
+}
@@ -293,6 +293,57 @@ slong _nmod_mpoly_mul_johnson(mp_limb_t ** coeff1, ulong ** exp1, slong * alloc,
     return len1;
 }
 
+/*
+    Set A to B*C using the packing V for the computation. The output is
+    packed into Abits.
+*/
+static void _mul_johnson_varbits(nmod_mpoly_t A, const nmod_mpoly_t B,
+                     const nmod_mpoly_t C, flint_bitcnt_t Abits,
+                           const mpoly_varbits_t V, const nmod_mpoly_ctx_t ctx)
+{
+    slong Talloc;
+    slong N = mpoly_words_per_exp_sp(Abits, ctx->minfo);
+    ulong * Bexp, * Cexp, * Texp;
+    nmod_mpoly_t T;
+
+    Bexp = (ulong *) flint_malloc(V->N*B->length*sizeof(ulong));
+    Cexp = (ulong *) flint_malloc(V->N*C->length*sizeof(ulong));
+    mpoly_varbits_pack(Bexp, B->exps, B->bits, B->length, V, ctx->minfo);
+    mpoly_varbits_pack(Cexp, C->exps, C->bits, C->length, V, ctx->minfo);
+
+    nmod_mpoly_init3(T, 0, Abits, ctx);
+
+    Talloc = B->length + C->length - 1;
+    T->coeffs = (mp_limb_t *) flint_malloc(Talloc*sizeof(mp_limb_t));
+    Texp = (ulong *) flint_malloc(Talloc*V->N*sizeof(ulong));
+
+    if (B->length > C->length)
+    {
+        T->length = _nmod_mpoly_mul_johnson(&T->coeffs, &Texp, &Talloc,
+                                      C->coeffs, Cexp, C->length,
+                                      B->coeffs, Bexp, B->length,
+                                     FLINT_BITS, V->N, V->cmpmask, ctx->ffinfo);
+    }
+    else
+    {
+        T->length = _nmod_mpoly_mul_johnson(&T->coeffs, &Texp, &Talloc,
+                                      B->coeffs, Bexp, B->length,
+                                      C->coeffs, Cexp, C->length,
+                                     FLINT_BITS, V->N, V->cmpmask, ctx->ffinfo);
+    }
+
+    flint_free(Bexp);
+    flint_free(Cexp);
+
+    T->alloc = Talloc;
+    T->exps = (ulong *) flint_malloc(Talloc*N*sizeof(ulong));
+    mpoly_varbits_unpack(T->exps, Abits, Texp, T->length, V, ctx->minfo);
+    flint_free(Texp);
+
+    nmod_mpoly_swap(T, A, ctx);
+    nmod_mpoly_clear(T, ctx);
+}
+
 /* maxBfields gets clobbered */
 void _nmod_mpoly_mul_johnson_maxfields(
     nmod_mpoly_t A,
@@ -318,6 +369,25 @@ void _nmod_mpoly_mul_johnson_maxfields(
     Abits = mpoly_fix_bits(Abits, ctx->minfo);
 
     N = mpoly_words_per_exp(Abits, ctx->minfo);
+
+    /*
+        If the fields have very different sizes, a packing with a width
+        for each field may need fewer words than Abits for every field.
+    */
+    if (Abits <= FLINT_BITS)
+    {
+        mpoly_varbits_t V;
+        mpoly_varbits_init(V, maxBfields, ctx->minfo);
+        if (V->N < N)
+        {
+            _mul_johnson_varbits(A, B, C, Abits, V, ctx);
+            mpoly_varbits_clear(V);
+            TMP_END;
+            return;
+        }
+        mpoly_varbits_clear(V);
+    }
+
     cmpmask = (ulong*) TMP_ALLOC(N*sizeof(ulong));
     mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
 
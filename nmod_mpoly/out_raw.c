@@ -0,0 +1,38 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+
+size_t nmod_mpoly_out_raw(FILE * file, const nmod_mpoly_t A,
+                                                    const nmod_mpoly_ctx_t ctx)
+{
+    slong N;
+    size_t r;
+    ulong header[MPOLY_RAW_HEADER_LENGTH];
+
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+
+    mpoly_raw_header_set(header, A->bits, A->length,
+                                               ctx->ffinfo->mod.n, ctx->minfo);
+    r = fwrite(header, sizeof(ulong), MPOLY_RAW_HEADER_LENGTH, file);
+    if (r != MPOLY_RAW_HEADER_LENGTH)
+        return 0;
+
+    r = fwrite(A->exps, sizeof(ulong), N*A->length, file);
+    if (r != (size_t) (N*A->length))
+        return 0;
+
+    r = fwrite(A->coeffs, sizeof(mp_limb_t), A->length, file);
+    if (r != (size_t) A->length)
+        return 0;
+
+    return (MPOLY_RAW_HEADER_LENGTH + (N + 1)*A->length)*sizeof(ulong);
+}
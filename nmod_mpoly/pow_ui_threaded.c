@@ -0,0 +1,132 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+/*
+    Repeated multiplication by B does about k/(nvars + 1) times the work of
+    FPS on sparse input, so it only pays off with a few threads.
+*/
+#define POW_THREADED_MIN_THREADS 4
+
+/*
+    If B fills at least half of its degree box, so do its powers, and the
+    multiplication switches to the dense method once they are large enough.
+    Squaring is then much cheaper than multiplying by B repeatedly.
+*/
+static int _pow_is_dense(const nmod_mpoly_t B, const nmod_mpoly_ctx_t ctx)
+{
+    int dense;
+    slong i, box, nvars = ctx->minfo->nvars;
+    slong * degs;
+    ulong hi;
+    TMP_INIT;
+
+    if (B->bits > FLINT_BITS)
+        return 0;
+
+    TMP_START;
+
+    degs = (slong *) TMP_ALLOC(nvars*sizeof(slong));
+    mpoly_degrees_si(degs, B->exps, B->length, B->bits, ctx->minfo);
+
+    dense = 1;
+    box = 1;
+    for (i = 0; i < nvars; i++)
+    {
+        umul_ppmm(hi, box, box, degs[i] + 1);
+        if (hi != 0 || box < 0 || box/2 > B->length)
+        {
+            dense = 0;
+            break;
+        }
+    }
+
+    TMP_END;
+    return dense;
+}
+
+void nmod_mpoly_pow_ui_threaded(nmod_mpoly_t A, const nmod_mpoly_t B,
+                       ulong k, const nmod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    slong num_threads;
+    ulong e;
+    nmod_mpoly_t T;
+
+    if (A == B)
+    {
+        nmod_mpoly_init(T, ctx);
+        nmod_mpoly_pow_ui_threaded(T, B, k, ctx, thread_limit);
+        nmod_mpoly_swap(A, T, ctx);
+        nmod_mpoly_clear(T, ctx);
+        return;
+    }
+
+    if (k <= 2 || B->length < 2)
+    {
+        if (k == 2)
+            nmod_mpoly_mul_threaded(A, B, B, ctx, thread_limit);
+        else
+            nmod_mpoly_pow_ui(A, B, k, ctx);
+        return;
+    }
+
+    num_threads = 1;
+    if (global_thread_pool_initialized)
+        num_threads += thread_pool_get_size(global_thread_pool);
+    num_threads = FLINT_MIN(num_threads, thread_limit);
+
+    if (num_threads < 2)
+    {
+        nmod_mpoly_pow_ui(A, B, k, ctx);
+        return;
+    }
+
+    if (_pow_is_dense(B, ctx))
+    {
+        /* left to right binary powering */
+        nmod_mpoly_init(T, ctx);
+        nmod_mpoly_set(T, B, ctx);
+
+        e = UWORD(1) << (FLINT_BIT_COUNT(k) - 1);
+        while ((e >>= 1) != 0)
+        {
+            nmod_mpoly_mul_threaded(A, T, T, ctx, thread_limit);
+            if ((k & e) != 0)
+                nmod_mpoly_mul_threaded(T, A, B, ctx, thread_limit);
+            else
+                nmod_mpoly_swap(T, A, ctx);
+        }
+
+        nmod_mpoly_swap(A, T, ctx);
+        nmod_mpoly_clear(T, ctx);
+    }
+    else if (num_threads >= POW_THREADED_MIN_THREADS)
+    {
+        /* repeated multiplication by B */
+        nmod_mpoly_init(T, ctx);
+        nmod_mpoly_mul_threaded(T, B, B, ctx, thread_limit);
+
+        for (e = 2; e < k; e++)
+        {
+            nmod_mpoly_mul_threaded(A, T, B, ctx, thread_limit);
+            nmod_mpoly_swap(T, A, ctx);
+        }
+
+        nmod_mpoly_swap(A, T, ctx);
+        nmod_mpoly_clear(T, ctx);
+    }
+    else
+    {
+        nmod_mpoly_pow_ui(A, B, k, ctx);
+    }
+}
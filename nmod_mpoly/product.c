@@ -0,0 +1,154 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+/*
+    The product is computed with a balanced tree: at the level with stride s
+    the node at index i (a multiple of 2s) is replaced by its product with the
+    node at index i + s. The pairs at one level are independent, so they are
+    shared between threads while there are enough of them. Once fewer pairs
+    than threads remain, each multiplication is threaded itself.
+*/
+
+typedef struct
+{
+    volatile slong next_pair;
+    slong num_pairs;
+    slong stride;
+    pthread_mutex_t mutex;
+    nmod_mpoly_struct * const * B;
+    nmod_mpoly_struct * T;
+    const nmod_mpoly_ctx_struct * ctx;
+}
+_product_base_struct;
+
+typedef _product_base_struct _product_base_t[1];
+
+/* T[i] = node i times node i + s, where the nodes of the bottom level are B */
+static void _product_pair(_product_base_struct * base, slong i,
+                                                            slong thread_limit)
+{
+    slong s = base->stride;
+    nmod_mpoly_struct * T = base->T;
+    const nmod_mpoly_struct * left, * right;
+
+    left  = (s == 1) ? base->B[i]     : T + i;
+    right = (s == 1) ? base->B[i + s] : T + i + s;
+
+    nmod_mpoly_mul_threaded(T + i, left, right, base->ctx, thread_limit);
+}
+
+static void _product_worker(void * varg)
+{
+    _product_base_struct * base = (_product_base_struct *) varg;
+    slong j;
+
+    while (1)
+    {
+        pthread_mutex_lock(&base->mutex);
+        j = base->next_pair;
+        base->next_pair = j + 1;
+        pthread_mutex_unlock(&base->mutex);
+
+        if (j >= base->num_pairs)
+            return;
+
+        _product_pair(base, 2*base->stride*j, 1);
+    }
+}
+
+void nmod_mpoly_product_threaded(nmod_mpoly_t A,
+                                 nmod_mpoly_struct * const * B, slong n,
+                                 const nmod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    slong i, s, num_threads, num_handles;
+    thread_pool_handle * handles;
+    _product_base_t base;
+
+    if (n < 3)
+    {
+        if (n == 2)
+            nmod_mpoly_mul_threaded(A, B[0], B[1], ctx, thread_limit);
+        else if (n == 1)
+            nmod_mpoly_set(A, B[0], ctx);
+        else
+            nmod_mpoly_one(A, ctx);
+        return;
+    }
+
+    base->T = (nmod_mpoly_struct *) flint_malloc(n*sizeof(nmod_mpoly_struct));
+    for (i = 0; i < n; i++)
+        nmod_mpoly_init(base->T + i, ctx);
+    base->B = B;
+    base->ctx = ctx;
+    pthread_mutex_init(&base->mutex, NULL);
+
+    num_threads = 1;
+    if (global_thread_pool_initialized)
+        num_threads += thread_pool_get_size(global_thread_pool);
+    num_threads = FLINT_MIN(num_threads, thread_limit);
+
+    /* an odd node at the end of the bottom level moves up unchanged */
+    if (n % 2 != 0)
+        nmod_mpoly_set(base->T + n - 1, B[n - 1], ctx);
+
+    for (s = 1; s < n; s = 2*s)
+    {
+        base->stride = s;
+        base->num_pairs = 0;
+        for (i = 0; i + s < n; i += 2*s)
+            base->num_pairs++;
+        base->next_pair = 0;
+
+        num_handles = 0;
+        if (num_threads > 1 && base->num_pairs >= num_threads)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                 (num_threads - 1)*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, num_threads - 1);
+            for (i = 0; i < num_handles; i++)
+            {
+                thread_pool_wake(global_thread_pool, handles[i],
+                                                      _product_worker, base);
+            }
+            _product_worker(base);
+            for (i = 0; i < num_handles; i++)
+            {
+                thread_pool_wait(global_thread_pool, handles[i]);
+                thread_pool_give_back(global_thread_pool, handles[i]);
+            }
+            flint_free(handles);
+        }
+        else
+        {
+            /* too few pairs to go around: thread each multiplication */
+            for (i = 0; i + s < n; i += 2*s)
+                _product_pair(base, i, thread_limit);
+        }
+    }
+
+    pthread_mutex_destroy(&base->mutex);
+
+    nmod_mpoly_swap(A, base->T + 0, ctx);
+
+    for (i = 0; i < n; i++)
+        nmod_mpoly_clear(base->T + i, ctx);
+    flint_free(base->T);
+}
+
+void nmod_mpoly_product(nmod_mpoly_t A, nmod_mpoly_struct * const * B,
+                                          slong n, const nmod_mpoly_ctx_t ctx)
+{
+    nmod_mpoly_product_threaded(A, B, n, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+}
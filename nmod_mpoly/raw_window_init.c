@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+
+/*
+    Point A at a polynomial in the raw format held in buf, typically a file
+    written by nmod_mpoly_out_raw and mapped into memory with mmap. The
+    exponent and coefficient arrays of A are the ones in buf, and A->alloc
+    is zero so that A never frees or grows them. The contents of buf are
+    not checked beyond the header.
+*/
+size_t nmod_mpoly_raw_window_init(nmod_mpoly_t A, const void * buf,
+                                       size_t size, const nmod_mpoly_ctx_t ctx)
+{
+    slong N, length;
+    flint_bitcnt_t bits;
+    const ulong * header = (const ulong *) buf;
+
+    A->coeffs = NULL;
+    A->exps = NULL;
+    A->alloc = 0;
+    A->length = 0;
+    A->bits = MPOLY_MIN_BITS;
+
+    if (((size_t) buf) % sizeof(ulong) != 0)
+        return 0;
+
+    if (size < MPOLY_RAW_HEADER_LENGTH*sizeof(ulong))
+        return 0;
+    if (!mpoly_raw_header_get(&bits, &length, header,
+                                              ctx->ffinfo->mod.n, ctx->minfo))
+        return 0;
+
+    N = mpoly_words_per_exp(bits, ctx->minfo);
+
+    if ((size/sizeof(ulong) - MPOLY_RAW_HEADER_LENGTH)/(N + 1) < (ulong) length)
+        return 0;
+
+    A->exps = (ulong *) (header + MPOLY_RAW_HEADER_LENGTH);
+    A->coeffs = (mp_limb_t *) (A->exps + N*length);
+    A->length = length;
+    A->bits = bits;
+
+    return (MPOLY_RAW_HEADER_LENGTH + (N + 1)*length)*sizeof(ulong);
+}
@@ -0,0 +1,271 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <pthread.h>
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+/* polynomials with fewer terms per thread are sorted by one thread */
+#define SORT_TERMS_THREADED_CUTOFF 4096
+
+typedef struct
+{
+    slong nthreads;
+    slong N;
+    slong length;
+    const ulong * cmpmask;
+    const slong * digits;
+    slong ndigits;
+    mp_limb_t * Acoeff;
+    ulong * Aexp;
+    mp_limb_t * Tcoeff;
+    ulong * Texp;
+    slong bucket_ends[256];
+    volatile slong next_bucket;
+    pthread_mutex_t mutex;
+}
+_base_struct;
+
+typedef _base_struct _base_t[1];
+
+typedef struct
+{
+    slong idx;
+    _base_struct * base;
+    ulong * vary;
+    slong counts[256];
+}
+_worker_arg_struct;
+
+static void _run(void (* fn)(void *), _worker_arg_struct * args,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    slong i;
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wake(global_thread_pool, handles[i], fn, &args[i]);
+    fn(&args[num_handles]);
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wait(global_thread_pool, handles[i]);
+}
+
+/* the bits in which the exponents of this thread's chunk vary */
+static void _vary_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong N = base->N;
+    slong start = base->length*arg->idx/base->nthreads;
+    slong stop = base->length*(arg->idx + 1)/base->nthreads;
+
+    mpoly_monomial_zero(arg->vary, N);
+    mpoly_monomials_varying_bits(arg->vary, base->Aexp + N*start,
+                                                 stop - start, base->Aexp, N);
+}
+
+/* count the leading digits of this thread's chunk */
+static void _count_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong i, N = base->N, pos = base->digits[0];
+    slong start = base->length*arg->idx/base->nthreads;
+    slong stop = base->length*(arg->idx + 1)/base->nthreads;
+
+    for (i = 0; i < 256; i++)
+        arg->counts[i] = 0;
+
+    for (i = start; i < stop; i++)
+        arg->counts[mpoly_radix_sort_digit(base->Aexp + N*i, pos,
+                                                          base->cmpmask)]++;
+}
+
+/* move this thread's chunk into the buckets in T */
+static void _scatter_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong i, j, N = base->N, pos = base->digits[0];
+    slong start = base->length*arg->idx/base->nthreads;
+    slong stop = base->length*(arg->idx + 1)/base->nthreads;
+
+    for (i = start; i < stop; i++)
+    {
+        j = arg->counts[mpoly_radix_sort_digit(base->Aexp + N*i, pos,
+                                                          base->cmpmask)]++;
+        base->Tcoeff[j] = base->Acoeff[i];
+        mpoly_monomial_set(base->Texp + N*j, base->Aexp + N*i, N);
+    }
+}
+
+/* sort the buckets of T one at a time until there are none left */
+static void _sort_worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _base_struct * base = arg->base;
+    slong b, start, stop;
+    slong * stack;
+
+    if (base->ndigits < 2)
+        return;
+
+    stack = (slong *) flint_malloc(256*(base->ndigits + 1)*sizeof(slong));
+
+    while (1)
+    {
+        pthread_mutex_lock(&base->mutex);
+        b = base->next_bucket;
+        base->next_bucket = b + 1;
+        pthread_mutex_unlock(&base->mutex);
+
+        if (b >= 256)
+            break;
+
+        start = (b == 0) ? 0 : base->bucket_ends[b - 1];
+        stop = base->bucket_ends[b];
+        if (stop - start > 1)
+            _nmod_mpoly_radix_sort_bytes(base->Tcoeff, base->Texp, start, stop,
+                    base->digits, 1, base->ndigits, base->N, base->cmpmask,
+                                                                        stack);
+    }
+
+    flint_free(stack);
+}
+
+/*
+    Sort the terms of A. The leading digit is distributed into buckets in
+    parallel, after which the threads take the buckets one at a time.
+*/
+void _nmod_mpoly_sort_terms_threaded(nmod_mpoly_t A,
+                                const nmod_mpoly_ctx_t ctx,
+                         const thread_pool_handle * handles, slong num_handles)
+{
+    slong i, j, b, N;
+    slong * digits;
+    ulong * cmpmask;
+    _base_t base;
+    _worker_arg_struct * args;
+    TMP_INIT;
+
+    if (num_handles < 1 ||
+                 A->length < (num_handles + 1)*SORT_TERMS_THREADED_CUTOFF)
+    {
+        nmod_mpoly_sort_terms(A, ctx);
+        return;
+    }
+
+    TMP_START;
+
+    N = mpoly_words_per_exp(A->bits, ctx->minfo);
+    cmpmask = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    digits = (slong *) TMP_ALLOC(N*(FLINT_BITS/8)*sizeof(slong));
+    mpoly_get_cmpmask(cmpmask, N, A->bits, ctx->minfo);
+
+    base->nthreads = num_handles + 1;
+    base->N = N;
+    base->length = A->length;
+    base->cmpmask = cmpmask;
+    base->digits = digits;
+    base->Acoeff = A->coeffs;
+    base->Aexp = A->exps;
+
+    args = (_worker_arg_struct *) flint_malloc(base->nthreads
+                                                  *sizeof(_worker_arg_struct));
+    for (i = 0; i < base->nthreads; i++)
+    {
+        args[i].idx = i;
+        args[i].base = base;
+        args[i].vary = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    }
+
+    _run(_vary_worker, args, handles, num_handles);
+
+    for (i = 1; i < base->nthreads; i++)
+        for (j = 0; j < N; j++)
+            args[0].vary[j] |= args[i].vary[j];
+
+    base->ndigits = mpoly_radix_sort_digits(digits, args[0].vary, N);
+    if (base->ndigits < 1)
+        goto cleanup;
+
+    _run(_count_worker, args, handles, num_handles);
+
+    /* each thread writes its part of a bucket after those of earlier threads */
+    j = 0;
+    for (b = 0; b < 256; b++)
+    {
+        for (i = 0; i < base->nthreads; i++)
+        {
+            slong c = args[i].counts[b];
+            args[i].counts[b] = j;
+            j += c;
+        }
+        base->bucket_ends[b] = j;
+    }
+
+    base->Tcoeff = (mp_limb_t *) flint_malloc(A->alloc*sizeof(mp_limb_t));
+    base->Texp = (ulong *) flint_malloc(N*A->alloc*sizeof(ulong));
+
+    _run(_scatter_worker, args, handles, num_handles);
+
+    flint_free(A->coeffs);
+    flint_free(A->exps);
+    A->coeffs = base->Tcoeff;
+    A->exps = base->Texp;
+
+    base->next_bucket = 0;
+    pthread_mutex_init(&base->mutex, NULL);
+    _run(_sort_worker, args, handles, num_handles);
+    pthread_mutex_destroy(&base->mutex);
+
+cleanup:
+
+    flint_free(args);
+
+    TMP_END;
+}
+
+
+void nmod_mpoly_sort_terms_threaded(nmod_mpoly_t A,
+                               const nmod_mpoly_ctx_t ctx, slong thread_limit)
+{
+    slong i;
+    thread_pool_handle * handles;
+    slong num_handles;
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    _nmod_mpoly_sort_terms_threaded(A, ctx, handles, num_handles);
+
+    for (i = 0; i < num_handles; i++)
+    {
+        thread_pool_give_back(global_thread_pool, handles[i]);
+    }
+    if (handles)
+    {
+        flint_free(handles);
+    }
+}
@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, v, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("compose_nmod_mpoly_threaded....");
+    fflush(stdout);
+
+    /* Check against compose_nmod_mpoly */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        ordering_t ord1, ord2;
+        nmod_mpoly_ctx_t ctx1, ctx2;
+        nmod_mpoly_t f, g, h;
+        nmod_mpoly_struct ** vals1;
+        slong nvars1, nvars2;
+        slong len1, len2;
+        slong exp_bound1, exp_bound2;
+        mp_limb_t modulus;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = FLINT_MAX(modulus, 2);
+
+        ord1 = mpoly_ordering_randtest(state);
+        ord2 = mpoly_ordering_randtest(state);
+        nvars1 = n_randint(state, 10) + 1;
+        nvars2 = n_randint(state, 10) + 1;
+        nmod_mpoly_ctx_init(ctx1, nvars1, ord1, modulus);
+        nmod_mpoly_ctx_init(ctx2, nvars2, ord2, modulus);
+
+        nmod_mpoly_init(f, ctx1);
+        nmod_mpoly_init(g, ctx2);
+        nmod_mpoly_init(h, ctx2);
+
+        len1 = n_randint(state, 80/nvars1 + 1);
+        len2 = n_randint(state, 30/nvars2 + 1);
+        exp_bound1 = n_randint(state, 15/nvars1 + 2) + 1;
+        exp_bound2 = n_randint(state, 15/nvars2 + 2) + 1;
+
+        vals1 = (nmod_mpoly_struct **) flint_malloc(nvars1
+                                                * sizeof(nmod_mpoly_struct *));
+        for (v = 0; v < nvars1; v++)
+        {
+            vals1[v] = (nmod_mpoly_struct *) flint_malloc(
+                                                    sizeof(nmod_mpoly_struct));
+            nmod_mpoly_init(vals1[v], ctx2);
+        }
+
+        for (j = 0; j < 4; j++)
+        {
+            for (v = 0; v < nvars1; v++)
+                nmod_mpoly_randtest_bound(vals1[v], state, len2,
+                                                             exp_bound2, ctx2);
+
+            nmod_mpoly_randtest_bound(f, state, len1, exp_bound1, ctx1);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            nmod_mpoly_compose_nmod_mpoly(g, f, vals1, ctx1, ctx2);
+            nmod_mpoly_compose_nmod_mpoly_threaded(h, f, vals1, ctx1, ctx2,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(h, ctx2);
+
+            if (!nmod_mpoly_equal(g, h, ctx2))
+            {
+                printf("FAIL\n");
+                flint_printf("Check against compose_nmod_mpoly\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            /* the output may alias a substituted polynomial */
+            nmod_mpoly_compose_nmod_mpoly_threaded(vals1[0], f, vals1,
+                                      ctx1, ctx2, MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(vals1[0], ctx2);
+
+            if (!nmod_mpoly_equal(g, vals1[0], ctx2))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        for (v = 0; v < nvars1; v++)
+        {
+            nmod_mpoly_clear(vals1[v], ctx2);
+            flint_free(vals1[v]);
+        }
+        flint_free(vals1);
+
+        nmod_mpoly_clear(f, ctx1);
+        nmod_mpoly_clear(g, ctx2);
+        nmod_mpoly_clear(h, ctx2);
+        nmod_mpoly_ctx_clear(ctx1);
+        nmod_mpoly_ctx_clear(ctx2);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
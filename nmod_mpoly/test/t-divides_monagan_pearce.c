@@ -16,7 +16,7 @@
 int
 main(void)
 {
-    int i, j, result, ok1, ok2;
+    int i, j, v, result, ok1, ok2;
     FLINT_TEST_INIT(state);
 
     flint_printf("divides_monagan_pearce....");
@@ -80,6 +80,87 @@ main(void)
         nmod_mpoly_ctx_clear(ctx);
     }
 
+    /* Check f*g/g = f with one variable of much larger degree */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h, k, l;
+        slong len1, len2, nvars;
+        ulong * bounds;
+
+        mp_limb_t modulus;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+        nvars = ctx->minfo->nvars;
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+        nmod_mpoly_init(k, ctx);
+        nmod_mpoly_init(l, ctx);
+
+        bounds = (ulong *) flint_malloc(nvars*sizeof(ulong));
+
+        len1 = n_randint(state, 20);
+        len2 = n_randint(state, 20) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            for (v = 0; v < nvars; v++)
+                bounds[v] = n_randint(state, 8) + 1;
+            bounds[n_randint(state, nvars)] = UWORD(1) << n_randint(state, 40);
+
+            nmod_mpoly_randtest_bounds(f, state, len1, bounds, ctx);
+            do {
+                nmod_mpoly_randtest_bounds(g, state, len2, bounds, ctx);
+            } while (g->length == 0);
+
+            nmod_mpoly_mul_johnson(h, f, g, ctx);
+            nmod_mpoly_assert_canonical(h, ctx);
+            nmod_mpoly_mul_heap_threaded(k, f, g, ctx, 1);
+            if (!nmod_mpoly_equal(h, k, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f with one variable of much "
+                          "larger degree\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+
+            ok1 = nmod_mpoly_divides_monagan_pearce(k, h, g, ctx);
+            nmod_mpoly_assert_canonical(k, ctx);
+            result = (ok1 && nmod_mpoly_equal(f, k, ctx));
+
+            /* h + f is divisible by g iff f is */
+            nmod_mpoly_add(h, h, f, ctx);
+            ok1 = nmod_mpoly_divides_monagan_pearce(k, h, g, ctx);
+            nmod_mpoly_assert_canonical(k, ctx);
+            ok2 = nmod_mpoly_divides_heap_threaded(l, h, g, ctx, 1);
+            result = result && (ok1 == ok2) &&
+                               (ok1 == 0 || nmod_mpoly_equal(k, l, ctx));
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f with one variable of much "
+                          "larger degree\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        flint_free(bounds);
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+        nmod_mpoly_clear(k, ctx);
+        nmod_mpoly_clear(l, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
     /* Check random polys don't divide */
     for (i = 0; i < 10 * flint_test_multiplier(); i++)
     {
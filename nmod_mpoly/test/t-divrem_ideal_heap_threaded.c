@@ -0,0 +1,262 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, w, max_threads = 5, tmul = 15;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("divrem_ideal_heap_threaded....");
+    fflush(stdout);
+
+    /* Check f*g/g = f with zero remainder */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h, k, r;
+        slong len1, len2;
+        flint_bitcnt_t exp_bits1, exp_bits2;
+        mp_limb_t modulus;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+        nmod_mpoly_init(k, ctx);
+        nmod_mpoly_init(r, ctx);
+
+        len1 = n_randint(state, 50);
+        len2 = n_randint(state, 50) + 1;
+
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            do {
+                nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            } while (g->length == 0);
+            nmod_mpoly_randtest_bits(k, state, len1, exp_bits1, ctx);
+            nmod_mpoly_randtest_bits(r, state, len1, exp_bits1, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            nmod_mpoly_mul(h, f, g, ctx);
+            nmod_mpoly_divrem_heap_threaded(k, r, h, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(k, ctx);
+            nmod_mpoly_assert_canonical(r, ctx);
+
+            if (!nmod_mpoly_equal(f, k, ctx) || !nmod_mpoly_is_zero(r, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check f*g/g = f with zero remainder\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+        nmod_mpoly_clear(k, ctx);
+        nmod_mpoly_clear(r, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check against monagan_pearce */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, r1, r2, s, t;
+        nmod_mpoly_struct * g, * q1, * q2;
+        nmod_mpoly_struct * q1arr[5], * q2arr[5], * darr[5];
+        slong len, len1, num;
+        slong nvars, exp_bound, exp_bound1;
+        mp_limb_t modulus;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+        nvars = ctx->minfo->nvars;
+
+        num = n_randint(state, 5) + 1;
+        g = (nmod_mpoly_struct *) flint_malloc(num*sizeof(nmod_mpoly_struct));
+        q1 = (nmod_mpoly_struct *) flint_malloc(num*sizeof(nmod_mpoly_struct));
+        q2 = (nmod_mpoly_struct *) flint_malloc(num*sizeof(nmod_mpoly_struct));
+        for (w = 0; w < num; w++)
+        {
+            nmod_mpoly_init(g + w, ctx);
+            darr[w] = g + w;
+            nmod_mpoly_init(q1 + w, ctx);
+            q1arr[w] = q1 + w;
+            nmod_mpoly_init(q2 + w, ctx);
+            q2arr[w] = q2 + w;
+        }
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(r1, ctx);
+        nmod_mpoly_init(r2, ctx);
+        nmod_mpoly_init(s, ctx);
+        nmod_mpoly_init(t, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 10) + 1;
+
+        exp_bound = n_randint(state, 2 + 175/nvars/nvars) + 1;
+        exp_bound1 = n_randint(state, 2 + 175/nvars/nvars) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            for (w = 0; w < num; w++)
+            {
+                do {
+                    nmod_mpoly_randtest_bound(darr[w], state, len1,
+                                                             exp_bound1, ctx);
+                } while (darr[w]->length == 0);
+            }
+            nmod_mpoly_randtest_bound(f, state, len, exp_bound, ctx);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            nmod_mpoly_divrem_ideal_monagan_pearce(q1arr, r1, f, darr, num,
+                                                                         ctx);
+            nmod_mpoly_divrem_ideal_heap_threaded(q2arr, r2, f, darr, num,
+                                              ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(r2, ctx);
+
+            nmod_mpoly_set(s, r2, ctx);
+            for (w = 0; w < num; w++)
+            {
+                nmod_mpoly_assert_canonical(q2arr[w], ctx);
+                if (!nmod_mpoly_equal(q1arr[w], q2arr[w], ctx))
+                    break;
+                nmod_mpoly_mul(t, q2arr[w], darr[w], ctx);
+                nmod_mpoly_add(s, s, t, ctx);
+            }
+
+            if (w < num || !nmod_mpoly_equal(r1, r2, ctx)
+                        || !nmod_mpoly_equal(s, f, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check against monagan_pearce\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        for (w = 0; w < num; w++)
+        {
+            nmod_mpoly_clear(q1 + w, ctx);
+            nmod_mpoly_clear(q2 + w, ctx);
+            nmod_mpoly_clear(g + w, ctx);
+        }
+        flint_free(g);
+        flint_free(q1);
+        flint_free(q2);
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(r1, ctx);
+        nmod_mpoly_clear(r2, ctx);
+        nmod_mpoly_clear(s, ctx);
+        nmod_mpoly_clear(t, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check aliasing of quotient and remainder with the dividend */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h, q1, r1;
+        slong len, len1;
+        slong nvars, exp_bound, exp_bound1;
+        mp_limb_t modulus;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+        nvars = ctx->minfo->nvars;
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+        nmod_mpoly_init(q1, ctx);
+        nmod_mpoly_init(r1, ctx);
+
+        len = n_randint(state, 50);
+        len1 = n_randint(state, 10) + 1;
+
+        exp_bound = n_randint(state, 2 + 175/nvars/nvars) + 1;
+        exp_bound1 = n_randint(state, 2 + 175/nvars/nvars) + 1;
+
+        for (j = 0; j < 4; j++)
+        {
+            nmod_mpoly_randtest_bound(f, state, len, exp_bound, ctx);
+            do {
+                nmod_mpoly_randtest_bound(g, state, len1, exp_bound1, ctx);
+            } while (g->length == 0);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            nmod_mpoly_divrem_heap_threaded(q1, r1, f, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+
+            nmod_mpoly_set(h, f, ctx);
+            nmod_mpoly_divrem_heap_threaded(h, r1, h, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(h, ctx);
+            if (!nmod_mpoly_equal(h, q1, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing of quotient with dividend\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+
+            nmod_mpoly_set(h, f, ctx);
+            nmod_mpoly_divrem_heap_threaded(q1, h, h, g, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(h, ctx);
+            if (!nmod_mpoly_equal(h, r1, ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing of remainder with dividend\n"
+                                                 "i = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+        nmod_mpoly_clear(q1, ctx);
+        nmod_mpoly_clear(r1, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
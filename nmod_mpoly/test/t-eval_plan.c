@@ -0,0 +1,144 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, k, max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("eval_plan....");
+    fflush(stdout);
+
+    /* Check plan evaluation matches evaluate_all */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f;
+        nmod_mpoly_eval_plan_t P;
+        mp_limb_t modulus, e;
+        mp_limb_t * ev1, * ev2;
+        ulong * vals;
+        slong nvars, len, num;
+        flint_bitcnt_t exp_bits;
+
+        modulus = n_randint(state, FLINT_BITS) + 1;
+        modulus = n_randbits(state, modulus);
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+        nvars = ctx->minfo->nvars;
+
+        nmod_mpoly_init(f, ctx);
+
+        len = n_randint(state, 100);
+        num = n_randint(state, 3*NMOD_MPOLY_EVAL_PLAN_BLOCK);
+        exp_bits = n_randint(state, 2) ? n_randint(state, 200) + 1
+                                       : n_randint(state, 20) + 1;
+
+        vals = (ulong *) flint_malloc((nvars*num + 1)*sizeof(ulong));
+        ev1 = (mp_limb_t *) flint_malloc((num + 1)*sizeof(mp_limb_t));
+        ev2 = (mp_limb_t *) flint_malloc((num + 1)*sizeof(mp_limb_t));
+
+        for (j = 0; j < 4; j++)
+        {
+            nmod_mpoly_randtest_bits(f, state, len, exp_bits, ctx);
+
+            for (k = 0; k < nvars*num; k++)
+                vals[k] = n_randlimb(state);
+
+            flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+            nmod_mpoly_eval_plan_init(P, f, ctx);
+            nmod_mpoly_eval_plan_evaluate_vec_ui(ev1, P, vals, num, ctx);
+            nmod_mpoly_eval_plan_evaluate_vec_ui_threaded(ev2, P, vals, num,
+                                             ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+
+            for (k = 0; k < num; k++)
+            {
+                e = nmod_mpoly_evaluate_all_ui(f, vals + nvars*k, ctx);
+
+                if (e != ev1[k] || e != ev2[k] ||
+                    e != nmod_mpoly_eval_plan_evaluate_ui(P, vals + nvars*k,
+                                                                         ctx))
+                {
+                    printf("FAIL\n");
+                    flint_printf("Check plan evaluation matches "
+                         "evaluate_all\ni = %wd, j = %wd, k = %wd\n", i, j, k);
+                    flint_abort();
+                }
+            }
+
+            nmod_mpoly_eval_plan_clear(P, ctx);
+        }
+
+        flint_free(vals);
+        flint_free(ev1);
+        flint_free(ev2);
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check a plan survives changes to its polynomial */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g;
+        nmod_mpoly_eval_plan_t P;
+        mp_limb_t modulus;
+        ulong * vals;
+        slong nvars, len;
+
+        modulus = n_randint(state, FLINT_BITS) + 1;
+        modulus = n_randbits(state, modulus);
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+        nvars = ctx->minfo->nvars;
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+
+        len = n_randint(state, 100);
+        nmod_mpoly_randtest_bits(f, state, len, n_randint(state, 20) + 1, ctx);
+        nmod_mpoly_set(g, f, ctx);
+
+        vals = (ulong *) flint_malloc((nvars + 1)*sizeof(ulong));
+        for (j = 0; j < nvars; j++)
+            vals[j] = n_randlimb(state);
+
+        nmod_mpoly_eval_plan_init(P, f, ctx);
+        nmod_mpoly_randtest_bits(f, state, len, n_randint(state, 20) + 1, ctx);
+
+        if (nmod_mpoly_eval_plan_evaluate_ui(P, vals, ctx) !=
+                                        nmod_mpoly_evaluate_all_ui(g, vals, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check a plan survives changes to its polynomial\n"
+                                                              "i = %wd\n", i);
+            flint_abort();
+        }
+
+        nmod_mpoly_eval_plan_clear(P, ctx);
+        flint_free(vals);
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
+
@@ -0,0 +1,248 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+
+/*
+    The Kronecker substitution used by the algorithm needs p - 1 to be large
+    and smooth, so only primes of the form c*2^k + 1 are required to succeed.
+*/
+const mp_limb_t smooth_primes[] = {65537, 7340033, 998244353};
+
+void gcd_check(
+    nmod_mpoly_t g,
+    nmod_mpoly_t a,
+    nmod_mpoly_t b,
+    nmod_mpoly_ctx_t ctx,
+    slong thread_limit,
+    int must_succeed,
+    slong i,
+    slong j,
+    const char * name)
+{
+    int res;
+    nmod_mpoly_t ca, cb, cg;
+
+    nmod_mpoly_init(ca, ctx);
+    nmod_mpoly_init(cb, ctx);
+    nmod_mpoly_init(cg, ctx);
+
+    res = nmod_mpoly_gcd_berlekamp_massey_threaded(g, a, b, ctx, thread_limit);
+    nmod_mpoly_assert_canonical(g, ctx);
+
+    if (!res)
+    {
+        if (!must_succeed)
+            goto cleanup;
+
+        printf("FAIL\n");
+        flint_printf("Check gcd can be computed\n"
+                                         "i = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+    if (nmod_mpoly_is_zero(g, ctx))
+    {
+        if (!nmod_mpoly_is_zero(a, ctx) || !nmod_mpoly_is_zero(b, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check zero gcd only results from zero inputs\n"
+                                         "i = %wd, j = %wd, %s\n", i, j, name);
+            flint_abort();
+        }
+        goto cleanup;
+    }
+
+    if (g->coeffs[0] != UWORD(1))
+    {
+        printf("FAIL\n");
+        flint_printf("Check gcd is monic\n"
+                                         "i = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+    res = 1;
+    res = res && nmod_mpoly_divides(ca, a, g, ctx);
+    res = res && nmod_mpoly_divides(cb, b, g, ctx);
+    if (!res)
+    {
+        printf("FAIL\n");
+        flint_printf("Check divisibility\n"
+                                         "i = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+    res = nmod_mpoly_gcd_berlekamp_massey_threaded(cg, ca, cb, ctx,
+                                                                 thread_limit);
+    nmod_mpoly_assert_canonical(cg, ctx);
+
+    if (!res)
+    {
+        if (!must_succeed)
+            goto cleanup;
+
+        printf("FAIL\n");
+        flint_printf("Check gcd of cofactors can be computed\n"
+                                         "i = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+    if (!nmod_mpoly_equal_ui(cg, 1, ctx))
+    {
+        printf("FAIL\n");
+        flint_printf("Check gcd of cofactors is one\n"
+                                         "i = %wd, j = %wd, %s\n", i, j, name);
+        flint_abort();
+    }
+
+cleanup:
+
+    nmod_mpoly_clear(ca, ctx);
+    nmod_mpoly_clear(cb, ctx);
+    nmod_mpoly_clear(cg, ctx);
+}
+
+
+int
+main(void)
+{
+    slong i, j;
+    slong tmul = 5;
+    slong max_threads = 5;
+    FLINT_TEST_INIT(state);
+#ifdef _WIN32
+    tmul = 1;
+#endif
+
+    flint_printf("gcd_berlekamp_massey....");
+    fflush(stdout);
+
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t g, a, b;
+        const char * vars[] = {"x", "y", "z", "w"};
+
+        nmod_mpoly_ctx_init(ctx, 4, ORD_DEGREVLEX, 65537);
+        nmod_mpoly_init(a, ctx);
+        nmod_mpoly_init(b, ctx);
+        nmod_mpoly_init(g, ctx);
+
+        nmod_mpoly_set_str_pretty(a, "x^9*y+z^20*w^3+x*y*z*w+1", vars, ctx);
+        nmod_mpoly_set_str_pretty(b, "x^2*w^17+y^15+3*z^2", vars, ctx);
+        nmod_mpoly_set_str_pretty(g, "x^13*z^2+y^7*w^11+x*y^2+z^19", vars, ctx);
+        nmod_mpoly_mul(a, a, g, ctx);
+        nmod_mpoly_mul(b, b, g, ctx);
+
+        gcd_check(g, a, b, ctx, 1, 1, 0, 0, "example");
+
+        nmod_mpoly_clear(a, ctx);
+        nmod_mpoly_clear(b, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t a, b, g;
+        slong len, len1, len2;
+        slong degbound;
+        mp_limb_t p;
+
+        p = smooth_primes[n_randint(state, 3)];
+
+        nmod_mpoly_ctx_init_rand(ctx, state, 5, p);
+
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(a, ctx);
+        nmod_mpoly_init(b, ctx);
+
+        len = n_randint(state, 20) + 1;
+        len1 = n_randint(state, 20);
+        len2 = n_randint(state, 20);
+
+        degbound = 1 + 30/ctx->minfo->nvars;
+
+        for (j = 0; j < 4; j++)
+        {
+            do {
+                nmod_mpoly_randtest_bound(g, state, len, degbound, ctx);
+            } while (g->length == 0);
+            nmod_mpoly_randtest_bound(a, state, len1, degbound, ctx);
+            nmod_mpoly_randtest_bound(b, state, len2, degbound, ctx);
+            nmod_mpoly_mul(a, a, g, ctx);
+            nmod_mpoly_mul(b, b, g, ctx);
+            nmod_mpoly_randtest_bits(g, state, len, FLINT_BITS, ctx);
+
+            gcd_check(g, a, b, ctx, n_randint(state, max_threads + 3),
+                                                     1, i, j, "random sparse");
+        }
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(a, ctx);
+        nmod_mpoly_clear(b, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t a, b, g;
+        slong len, len1, len2;
+        slong degbound;
+        mp_limb_t p;
+
+        p = n_randint(state, FLINT_BITS - 1) + 1;
+        p = n_randbits(state, p);
+        p = n_nextprime(p, 1);
+
+        nmod_mpoly_ctx_init_rand(ctx, state, 4, p);
+
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(a, ctx);
+        nmod_mpoly_init(b, ctx);
+
+        len = n_randint(state, 15) + 1;
+        len1 = n_randint(state, 15);
+        len2 = n_randint(state, 15);
+
+        degbound = 1 + 20/ctx->minfo->nvars;
+
+        for (j = 0; j < 4; j++)
+        {
+            do {
+                nmod_mpoly_randtest_bound(g, state, len, degbound, ctx);
+            } while (g->length == 0);
+            nmod_mpoly_randtest_bound(a, state, len1, degbound, ctx);
+            nmod_mpoly_randtest_bound(b, state, len2, degbound, ctx);
+            nmod_mpoly_mul(a, a, g, ctx);
+            nmod_mpoly_mul(b, b, g, ctx);
+            nmod_mpoly_randtest_bits(g, state, len, FLINT_BITS, ctx);
+
+            gcd_check(g, a, b, ctx, n_randint(state, max_threads + 3),
+                                                     0, i, j, "random prime");
+        }
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(a, ctx);
+        nmod_mpoly_clear(b, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    printf("PASS\n");
+    FLINT_TEST_CLEANUP(state);
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j;
+    slong max_threads = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("gcd_zippel_threaded....");
+    fflush(stdout);
+
+    for (i = 0; i < 30 * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t a, b, g, ca, cb, cg, t;
+        slong len, len1, len2;
+        ulong degbound;
+        ulong * degbounds, * degbounds1, * degbounds2;
+        mp_limb_t modulus;
+        int res;
+        slong thread_limit;
+
+        modulus = n_randint(state, (i % 10 == 0) ? 4: FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+
+        nmod_mpoly_ctx_init_rand(ctx, state, WORD(10), modulus);
+
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(a, ctx);
+        nmod_mpoly_init(b, ctx);
+        nmod_mpoly_init(ca, ctx);
+        nmod_mpoly_init(cb, ctx);
+        nmod_mpoly_init(cg, ctx);
+        nmod_mpoly_init(t, ctx);
+
+        len = n_randint(state, 16) + 1;
+        len1 = n_randint(state, 16);
+        len2 = n_randint(state, 16);
+
+        degbound = 100/(2*ctx->minfo->nvars - 1);
+        degbounds = (ulong * ) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+        degbounds1 = (ulong * ) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+        degbounds2 = (ulong * ) flint_malloc(ctx->minfo->nvars*sizeof(ulong));
+        for (j = 0; j < ctx->minfo->nvars; j++)
+        {
+            degbounds[j] = n_randint(state, degbound + UWORD(1)) + UWORD(1);
+            degbounds1[j] = n_randint(state, degbound + UWORD(1)) + UWORD(1);
+            degbounds2[j] = n_randint(state, degbound + UWORD(1)) + UWORD(1);
+        }
+
+        for (j = 0; j < 4; j++)
+        {
+            thread_limit = n_randint(state, max_threads + 3);
+
+            do {
+                nmod_mpoly_randtest_bounds(t, state, len, degbounds, ctx);
+            } while (t->length == 0);
+            nmod_mpoly_randtest_bounds(a, state, len1, degbounds1, ctx);
+            nmod_mpoly_randtest_bounds(b, state, len2, degbounds2, ctx);
+
+            nmod_mpoly_mul_johnson(a, a, t, ctx);
+            nmod_mpoly_mul_johnson(b, b, t, ctx);
+
+            nmod_mpoly_randtest_bits(g, state, len, FLINT_BITS, ctx);
+
+            res = nmod_mpoly_gcd_zippel_threaded(g, a, b, ctx, thread_limit);
+            if (!res)
+            {
+                printf("FAIL\n");
+                flint_printf("Check that gcd could be computed\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+            nmod_mpoly_assert_canonical(g, ctx);
+
+            if (nmod_mpoly_is_zero(g, ctx))
+            {
+                if (!nmod_mpoly_is_zero(a, ctx) || !nmod_mpoly_is_zero(b, ctx))
+                {
+                    printf("FAIL\n");
+                    flint_printf("Check zero gcd only results from zero inputs\ni = %wd, j = %wd\n", i ,j);
+                    flint_abort();
+                }
+                continue;
+            }
+
+            if (g->coeffs[0] != UWORD(1))
+            {
+                printf("FAIL\n");
+                flint_printf("Check gcd is monic\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+
+            res = 1;
+            res = res && nmod_mpoly_divides_monagan_pearce(ca, a, g, ctx);
+            res = res && nmod_mpoly_divides_monagan_pearce(cb, b, g, ctx);
+            if (!res)
+            {
+                printf("FAIL\n");
+                flint_printf("Check divisibility\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+
+            res = nmod_mpoly_gcd_zippel_threaded(cg, ca, cb, ctx, thread_limit);
+            if (!res)
+            {
+                printf("FAIL\n");
+                flint_printf("Check that cofactor gcd could be computed\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+
+            if (!nmod_mpoly_equal_ui(cg, UWORD(1), ctx))
+            {
+                printf("FAIL\n");
+                flint_printf("Check cofactors are relatively prime\ni = %wd, j = %wd\n", i ,j);                
+                flint_abort();
+            }
+        }
+
+        flint_free(degbounds);
+        flint_free(degbounds1);
+        flint_free(degbounds2);
+
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(a, ctx);
+        nmod_mpoly_clear(b, ctx);
+        nmod_mpoly_clear(ca, ctx);
+        nmod_mpoly_clear(cb, ctx);
+        nmod_mpoly_clear(cg, ctx);
+        nmod_mpoly_clear(t, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+    }
+
+    printf("PASS\n");
+    FLINT_TEST_CLEANUP(state);
+
+    return 0;
+}
+
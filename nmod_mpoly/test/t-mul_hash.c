@@ -0,0 +1,231 @@
+/*
+    Copyright (C) 2017 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, result;
+    slong tmul = 10;
+    FLINT_TEST_INIT(state);
+#ifdef _WIN32
+    tmul = 2;
+#endif
+
+    flint_printf("mul_hash....");
+    fflush(stdout);
+
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h1, h2;
+        const char * vars[] = {"x","y","z","t","u"};
+
+        nmod_mpoly_ctx_init(ctx, 5, ORD_LEX, -UWORD(1));
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h1, ctx);
+        nmod_mpoly_init(h2, ctx);
+
+        nmod_mpoly_set_str_pretty(f, "(1+x+y+2*z^2+3*t^3+5*u^5)^6", vars, ctx);
+        nmod_mpoly_set_str_pretty(g, "(1+u+t+2*z^2+3*y^3+5*x^5)^6", vars, ctx);
+
+        nmod_mpoly_mul_johnson(h1, f, g, ctx);
+        nmod_mpoly_mul_hash(h2, f, g, ctx);
+
+        if (!nmod_mpoly_equal(h1, h2, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check simple example\n");
+            flint_abort();
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h1, ctx);
+        nmod_mpoly_clear(h2, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check mul_hash matches mul_johnson */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h, k;
+        mp_limb_t modulus;
+        slong len, len1, len2;
+        flint_bitcnt_t exp_bits, exp_bits1, exp_bits2;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 10, modulus);
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+        nmod_mpoly_init(k, ctx);
+
+        len = n_randint(state, 100);
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits = n_randint(state, 200) + 2;
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            nmod_mpoly_randtest_bits(h, state, len, exp_bits, ctx);
+            nmod_mpoly_randtest_bits(k, state, len, exp_bits, ctx);
+
+
+            nmod_mpoly_mul_johnson(h, f, g, ctx);
+            nmod_mpoly_assert_canonical(h, ctx);
+            nmod_mpoly_mul_hash(k, f, g, ctx);
+            nmod_mpoly_assert_canonical(k, ctx);
+            result = nmod_mpoly_equal(h, k, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check mul_hash matches mul_johnson\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+        nmod_mpoly_clear(k, ctx);
+
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+
+    /* Check aliasing first argument */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h;
+        mp_limb_t modulus;
+        slong len, len1, len2;
+        slong exp_bits, exp_bits1, exp_bits2;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 10, modulus);
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+
+        len = n_randint(state, 100);
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits = n_randint(state, 200) + 2;
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            nmod_mpoly_randtest_bits(h, state, len, exp_bits, ctx);
+
+
+            nmod_mpoly_mul_johnson(h, f, g, ctx);
+            nmod_mpoly_assert_canonical(h, ctx);
+            nmod_mpoly_mul_hash(f, f, g, ctx);
+            nmod_mpoly_assert_canonical(f, ctx);
+            result = nmod_mpoly_equal(h, f, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing first argument\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check aliasing second argument */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h;
+        mp_limb_t modulus;
+        slong len, len1, len2;
+        slong exp_bits, exp_bits1, exp_bits2;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 10, modulus);
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+
+        len = n_randint(state, 100);
+        len1 = n_randint(state, 100);
+        len2 = n_randint(state, 100);
+
+        exp_bits = n_randint(state, 200) + 2;
+        exp_bits1 = n_randint(state, 200) + 2;
+        exp_bits2 = n_randint(state, 200) + 2;
+
+        for (j = 0; j < 4; j++)
+        {
+            nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            nmod_mpoly_randtest_bits(h, state, len, exp_bits, ctx);
+
+
+            nmod_mpoly_mul_johnson(h, f, g, ctx);
+            nmod_mpoly_assert_canonical(h, ctx);
+            nmod_mpoly_mul_hash(g, f, g, ctx);
+            nmod_mpoly_assert_canonical(g, ctx);
+            result = nmod_mpoly_equal(h, g, ctx);
+
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check aliasing first argument\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+    
+    flint_printf("PASS\n");
+    return 0;
+}
+
@@ -0,0 +1,181 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, k, n = 5;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("out_raw/inp_raw....");
+    fflush(stdout);
+
+    /* Check a sequence of polynomials survives a round trip */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx, ctx2;
+        nmod_mpoly_struct a[5];
+        nmod_mpoly_t b;
+        slong len;
+        flint_bitcnt_t exp_bits;
+        mp_limb_t modulus;
+        size_t r, total;
+        FILE * file;
+        ulong * buf;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 20, modulus);
+        nmod_mpoly_ctx_init(ctx2, ctx->minfo->nvars, ctx->minfo->ord,
+                                                   n_nextprime(modulus, 1));
+
+        for (j = 0; j < n; j++)
+        {
+            nmod_mpoly_init(a + j, ctx);
+            len = n_randint(state, 100);
+            exp_bits = n_randint(state, 200) + 1;
+            nmod_mpoly_randtest_bits(a + j, state, len, exp_bits, ctx);
+        }
+        nmod_mpoly_init(b, ctx);
+
+        file = tmpfile();
+        if (file == NULL)
+        {
+            printf("FAIL\n");
+            flint_printf("Could not open temporary file\n");
+            flint_abort();
+        }
+
+        total = 0;
+        for (j = 0; j < n; j++)
+        {
+            r = nmod_mpoly_out_raw(file, a + j, ctx);
+            if (r == 0)
+            {
+                printf("FAIL\n");
+                flint_printf("Write error\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+            total += r;
+        }
+
+        if ((size_t) ftell(file) != total)
+        {
+            printf("FAIL\n");
+            flint_printf("Check size written\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        rewind(file);
+        for (j = 0; j < n; j++)
+        {
+            r = nmod_mpoly_inp_raw(b, file, ctx);
+            nmod_mpoly_assert_canonical(b, ctx);
+            if (r == 0 || !nmod_mpoly_equal(b, a + j, ctx)
+                       || b->bits != a[j].bits)
+            {
+                printf("FAIL\n");
+                flint_printf("Check round trip\ni = %wd, j = %wd\n", i, j);
+                flint_abort();
+            }
+        }
+
+        if (nmod_mpoly_inp_raw(b, file, ctx) != 0
+                                                || !nmod_mpoly_is_zero(b, ctx))
+        {
+            printf("FAIL\n");
+            flint_printf("Check read past end\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        rewind(file);
+        {
+            nmod_mpoly_t c;
+            nmod_mpoly_init(c, ctx2);
+            if (nmod_mpoly_inp_raw(c, file, ctx2) != 0
+                                               || !nmod_mpoly_is_zero(c, ctx2))
+            {
+                printf("FAIL\n");
+                flint_printf("Check modulus mismatch\ni = %wd\n", i);
+                flint_abort();
+            }
+            nmod_mpoly_clear(c, ctx2);
+        }
+
+        /* read the whole file into memory and view it in place */
+        rewind(file);
+        buf = (ulong *) flint_malloc(total + sizeof(ulong));
+        if (fread(buf, 1, total, file) != total)
+        {
+            printf("FAIL\n");
+            flint_printf("Read error\ni = %wd\n", i);
+            flint_abort();
+        }
+
+        {
+            nmod_mpoly_t v;
+            const char * p = (const char *) buf;
+            size_t left = total, first = 0;
+
+            for (j = 0; j < n; j++)
+            {
+                r = nmod_mpoly_raw_window_init(v, p, left, ctx);
+                if (r == 0 || !nmod_mpoly_equal(v, a + j, ctx)
+                           || v->bits != a[j].bits)
+                {
+                    printf("FAIL\n");
+                    flint_printf("Check window\ni = %wd, j = %wd\n", i, j);
+                    flint_abort();
+                }
+                nmod_mpoly_raw_window_clear(v, ctx);
+                if (j == 0)
+                    first = r;
+                p += r;
+                left -= r;
+            }
+
+            if (left != 0 || nmod_mpoly_raw_window_init(v, p, left, ctx) != 0)
+            {
+                printf("FAIL\n");
+                flint_printf("Check window past end\ni = %wd\n", i);
+                flint_abort();
+            }
+            nmod_mpoly_raw_window_clear(v, ctx);
+
+            if (nmod_mpoly_raw_window_init(v, buf, first - 1, ctx) != 0)
+            {
+                printf("FAIL\n");
+                flint_printf("Check truncated window\ni = %wd\n", i);
+                flint_abort();
+            }
+            nmod_mpoly_raw_window_clear(v, ctx);
+        }
+
+        flint_free(buf);
+        fclose(file);
+
+        for (k = 0; k < n; k++)
+            nmod_mpoly_clear(a + k, ctx);
+        nmod_mpoly_clear(b, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+        nmod_mpoly_ctx_clear(ctx2);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
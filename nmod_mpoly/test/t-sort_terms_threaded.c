@@ -0,0 +1,194 @@
+/*
+    Copyright (C) 2019 Daniel Schultz
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_mpoly.h"
+
+int
+main(void)
+{
+    slong i, j, result, max_threads = 5;
+    slong tmul = 10;
+    FLINT_TEST_INIT(state);
+#ifdef _WIN32
+    tmul = 2;
+#endif
+
+    flint_printf("sort_terms_threaded....");
+    fflush(stdout);
+
+    /* Check scramble and sort */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g;
+        mp_limb_t modulus;
+        slong len;
+        flint_bitcnt_t exp_bits;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 10, modulus);
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+
+        len = n_randint(state, 2) ? n_randint(state, 200)
+                                  : n_randint(state, 40000);
+        exp_bits = n_randint(state, 200) + 1;
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        for (j = 0; j < 2; j++)
+        {
+            slong N, k;
+
+            nmod_mpoly_randtest_bits(f, state, len, exp_bits, ctx);
+            nmod_mpoly_set(g, f, ctx);
+
+            N = mpoly_words_per_exp(f->bits, ctx->minfo);
+            for (k = WORD(0); k < f->length; k++)
+            {
+                ulong a, b;
+                a = n_randint(state, f->length);
+                b = n_randint(state, f->length);
+                {
+                    mp_limb_t c = f->coeffs[a];
+                    f->coeffs[a] = f->coeffs[b];
+                    f->coeffs[b] = c;
+                }
+                mpoly_monomial_swap(f->exps + N*a, f->exps + N*b, N);
+            }
+
+            nmod_mpoly_sort_terms_threaded(f, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(f, ctx);
+            result = nmod_mpoly_equal(f, g, ctx);
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check scramble and sort\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    /* Check sort and combine of f, -f, f, g matches f + g */
+    for (i = 0; i < tmul * flint_test_multiplier(); i++)
+    {
+        nmod_mpoly_ctx_t ctx;
+        nmod_mpoly_t f, g, h, k;
+        mp_limb_t modulus;
+        slong len1, len2;
+        flint_bitcnt_t exp_bits1, exp_bits2;
+
+        modulus = n_randint(state, FLINT_BITS - 1) + 1;
+        modulus = n_randbits(state, modulus);
+        modulus = n_nextprime(modulus, 1);
+        nmod_mpoly_ctx_init_rand(ctx, state, 10, modulus);
+
+        nmod_mpoly_init(f, ctx);
+        nmod_mpoly_init(g, ctx);
+        nmod_mpoly_init(h, ctx);
+        nmod_mpoly_init(k, ctx);
+
+        len1 = n_randint(state, 2) ? n_randint(state, 200)
+                                   : n_randint(state, 20000);
+        len2 = n_randint(state, 2) ? n_randint(state, 200)
+                                   : n_randint(state, 20000);
+        exp_bits1 = n_randint(state, 200) + 1;
+        exp_bits2 = n_randint(state, 200) + 1;
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        for (j = 0; j < 2; j++)
+        {
+            slong N, l, t;
+            flint_bitcnt_t bits;
+
+            nmod_mpoly_randtest_bits(f, state, len1, exp_bits1, ctx);
+            nmod_mpoly_randtest_bits(g, state, len2, exp_bits2, ctx);
+            nmod_mpoly_add(h, f, g, ctx);
+
+            bits = FLINT_MAX(f->bits, g->bits);
+            nmod_mpoly_repack_bits(f, f, bits, ctx);
+            nmod_mpoly_repack_bits(g, g, bits, ctx);
+            N = mpoly_words_per_exp(bits, ctx->minfo);
+
+            nmod_mpoly_fit_length(k, 3*f->length + g->length, ctx);
+            nmod_mpoly_fit_bits(k, bits, ctx);
+            k->bits = bits;
+            l = 0;
+            for (t = 0; t < f->length; t++, l++)
+            {
+                k->coeffs[l] = f->coeffs[t];
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < f->length; t++, l++)
+            {
+                k->coeffs[l] = nmod_neg(f->coeffs[t], ctx->ffinfo->mod);
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < f->length; t++, l++)
+            {
+                k->coeffs[l] = f->coeffs[t];
+                mpoly_monomial_set(k->exps + N*l, f->exps + N*t, N);
+            }
+            for (t = 0; t < g->length; t++, l++)
+            {
+                k->coeffs[l] = g->coeffs[t];
+                mpoly_monomial_set(k->exps + N*l, g->exps + N*t, N);
+            }
+            _nmod_mpoly_set_length(k, l, ctx);
+
+            for (t = 0; t < k->length; t++)
+            {
+                ulong a, b;
+                a = n_randint(state, k->length);
+                b = n_randint(state, k->length);
+                {
+                    mp_limb_t c = k->coeffs[a];
+                    k->coeffs[a] = k->coeffs[b];
+                    k->coeffs[b] = c;
+                }
+                mpoly_monomial_swap(k->exps + N*a, k->exps + N*b, N);
+            }
+
+            nmod_mpoly_sort_terms_threaded(k, ctx, MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_combine_like_terms_threaded(k, ctx,
+                                                   MPOLY_DEFAULT_THREAD_LIMIT);
+            nmod_mpoly_assert_canonical(k, ctx);
+            result = nmod_mpoly_equal(k, h, ctx);
+            if (!result)
+            {
+                printf("FAIL\n");
+                flint_printf("Check sort and combine\ni = %wd, j = %wd\n", i ,j);
+                flint_abort();
+            }
+        }
+
+        nmod_mpoly_clear(f, ctx);
+        nmod_mpoly_clear(g, ctx);
+        nmod_mpoly_clear(h, ctx);
+        nmod_mpoly_clear(k, ctx);
+        nmod_mpoly_ctx_clear(ctx);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
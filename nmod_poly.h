@@ -1343,22 +1343,37 @@ FLINT_DLL void nmod_poly_inflate(nmod_poly_t result, const nmod_poly_t input,
 
 /* Characteristic polynomial and minimal polynomial */
 
+#define NMOD_MAT_CHARPOLY_KRYLOV_CUTOFF 100
+#define NMOD_MAT_CHARPOLY_KRYLOV_SUBMUL_CUTOFF 8
+#define NMOD_MAT_MINPOLY_KRYLOV_CUTOFF 200
+
+FLINT_DLL slong _nmod_mat_minpoly_vec(nmod_poly_t f, nmod_mat_t K,
+                                            const nmod_mat_t A, mp_srcptr v);
+
 FLINT_DLL void nmod_mat_charpoly_danilevsky(nmod_poly_t p, const nmod_mat_t M);
 
+FLINT_DLL void nmod_mat_charpoly_krylov(nmod_poly_t p, const nmod_mat_t M);
+
 NMOD_POLY_INLINE
 void nmod_mat_charpoly(nmod_poly_t p, const nmod_mat_t M)
 {
    nmod_mat_t A;
 
-   nmod_mat_init(A, M->r, M->c, p->mod.n);
-   nmod_mat_set(A, M);
-
-   if (A->r != A->c)
+   if (M->r != M->c)
    {
        flint_printf("Exception (nmod_mat_charpoly).  Non-square matrix.\n");
        flint_abort();
    }
 
+   if (M->r >= NMOD_MAT_CHARPOLY_KRYLOV_CUTOFF)
+   {
+      nmod_mat_charpoly_krylov(p, M);
+      return;
+   }
+
+   nmod_mat_init(A, M->r, M->c, p->mod.n);
+   nmod_mat_set(A, M);
+
    nmod_mat_charpoly_danilevsky(p, A);
 
    nmod_mat_clear(A);
@@ -0,0 +1,245 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NMOD_SPARSE_MAT_H
+#define NMOD_SPARSE_MAT_H
+
+#ifdef NMOD_SPARSE_MAT_INLINES_C
+#define NMOD_SPARSE_MAT_INLINE FLINT_DLL
+#else
+#define NMOD_SPARSE_MAT_INLINE static __inline__
+#endif
+
+#undef ulong
+#define ulong ulongxx /* interferes with system includes */
+#include <stdlib.h>
+#undef ulong
+#include <gmp.h>
+#define ulong mp_limb_t
+
+#include "flint.h"
+#include "longlong.h"
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "nmod_poly.h"
+#include "thread_pool.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+    Compressed sparse row storage. The nonzero entries of row i are
+    entries[k] in column cols[k] for row_starts[i] <= k < row_starts[i + 1].
+    Within a row the column indices are strictly increasing and no stored
+    entry is zero. row_starts has length r + 1.
+*/
+typedef struct
+{
+    mp_limb_t * entries;
+    slong * cols;
+    slong * row_starts;
+    slong r;
+    slong c;
+    slong alloc;
+    nmod_t mod;
+}
+nmod_sparse_mat_struct;
+
+typedef nmod_sparse_mat_struct nmod_sparse_mat_t[1];
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_nrows(const nmod_sparse_mat_t A)
+{
+    return A->r;
+}
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_ncols(const nmod_sparse_mat_t A)
+{
+    return A->c;
+}
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_nnz(const nmod_sparse_mat_t A)
+{
+    return A->row_starts[A->r];
+}
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_row_length(const nmod_sparse_mat_t A, slong i)
+{
+    return A->row_starts[i + 1] - A->row_starts[i];
+}
+
+/* Memory management */
+
+FLINT_DLL void nmod_sparse_mat_init(nmod_sparse_mat_t A,
+                                        slong rows, slong cols, mp_limb_t n);
+
+FLINT_DLL void nmod_sparse_mat_clear(nmod_sparse_mat_t A);
+
+FLINT_DLL void nmod_sparse_mat_fit_length(nmod_sparse_mat_t A, slong len);
+
+FLINT_DLL void nmod_sparse_mat_zero(nmod_sparse_mat_t A);
+
+FLINT_DLL void nmod_sparse_mat_set(nmod_sparse_mat_t B,
+                                                   const nmod_sparse_mat_t A);
+
+NMOD_SPARSE_MAT_INLINE
+void nmod_sparse_mat_swap(nmod_sparse_mat_t A, nmod_sparse_mat_t B)
+{
+    nmod_sparse_mat_struct t = *A;
+    *A = *B;
+    *B = t;
+}
+
+/* Basic properties and conversion */
+
+FLINT_DLL int nmod_sparse_mat_equal(const nmod_sparse_mat_t A,
+                                                   const nmod_sparse_mat_t B);
+
+FLINT_DLL int nmod_sparse_mat_is_canonical(const nmod_sparse_mat_t A);
+
+FLINT_DLL mp_limb_t nmod_sparse_mat_get_entry(const nmod_sparse_mat_t A,
+                                                           slong i, slong j);
+
+FLINT_DLL void nmod_sparse_mat_set_entries(nmod_sparse_mat_t A,
+                   const slong * rows, const slong * cols,
+                                        const mp_limb_t * vals, slong nnz);
+
+FLINT_DLL void nmod_sparse_mat_set_nmod_mat(nmod_sparse_mat_t A,
+                                                        const nmod_mat_t B);
+
+FLINT_DLL void nmod_sparse_mat_get_nmod_mat(nmod_mat_t B,
+                                                  const nmod_sparse_mat_t A);
+
+FLINT_DLL void nmod_sparse_mat_transpose(nmod_sparse_mat_t B,
+                                                   const nmod_sparse_mat_t A);
+
+/* Random generation */
+
+FLINT_DLL void nmod_sparse_mat_randtest(nmod_sparse_mat_t A,
+                           flint_rand_t state, slong min_nnz, slong max_nnz);
+
+/* Input and output */
+
+FLINT_DLL void nmod_sparse_mat_print_pretty(const nmod_sparse_mat_t A);
+
+/* Matrix-vector and matrix-matrix products */
+
+FLINT_DLL void _nmod_sparse_mat_mul_vec_rows(mp_ptr y,
+                 const nmod_sparse_mat_t A, mp_srcptr x, slong r1, slong r2);
+
+FLINT_DLL void nmod_sparse_mat_mul_vec(mp_ptr y, const nmod_sparse_mat_t A,
+                                                                 mp_srcptr x);
+
+FLINT_DLL void nmod_sparse_mat_mul_vec_threaded(mp_ptr y,
+              const nmod_sparse_mat_t A, mp_srcptr x, slong thread_limit);
+
+FLINT_DLL void nmod_sparse_mat_mul_mat(nmod_mat_t Y,
+                               const nmod_sparse_mat_t A, const nmod_mat_t X);
+
+FLINT_DLL void nmod_sparse_mat_mul_mat_threaded(nmod_mat_t Y,
+           const nmod_sparse_mat_t A, const nmod_mat_t X, slong thread_limit);
+
+/* Structured Gaussian elimination */
+
+FLINT_DLL slong _nmod_sparse_mat_rref(nmod_sparse_mat_t A, slong * pivots,
+                                                        slong pivot_cols);
+
+FLINT_DLL slong nmod_sparse_mat_rref(nmod_sparse_mat_t A, slong * pivots);
+
+FLINT_DLL slong nmod_sparse_mat_rank(const nmod_sparse_mat_t A);
+
+FLINT_DLL slong nmod_sparse_mat_nullspace_rref(nmod_mat_t X,
+                                                   const nmod_sparse_mat_t A);
+
+FLINT_DLL int nmod_sparse_mat_solve_rref(mp_ptr x,
+                                   const nmod_sparse_mat_t A, mp_srcptr b);
+
+/* Wiedemann and block Wiedemann */
+
+/*
+    Square black box operator of size n = A->c used by the Wiedemann
+    algorithms: B = A if A is square, A padded with zero rows if A is wide,
+    and A^T*A if A is tall.
+*/
+typedef struct
+{
+    const nmod_sparse_mat_struct * A;
+    nmod_sparse_mat_struct AT[1];
+    mp_ptr t;
+    slong n;
+}
+_nmod_sparse_mat_op_struct;
+
+typedef _nmod_sparse_mat_op_struct _nmod_sparse_mat_op_t[1];
+
+FLINT_DLL void _nmod_sparse_mat_op_init(_nmod_sparse_mat_op_t B,
+                                                   const nmod_sparse_mat_t A);
+
+FLINT_DLL void _nmod_sparse_mat_op_clear(_nmod_sparse_mat_op_t B);
+
+FLINT_DLL void _nmod_sparse_mat_op_apply(mp_ptr y,
+                                 _nmod_sparse_mat_op_t B, mp_srcptr x);
+
+FLINT_DLL void _nmod_sparse_mat_op_apply_block(nmod_mat_t Y,
+                                 _nmod_sparse_mat_op_t B, const nmod_mat_t X);
+
+FLINT_DLL int _nmod_sparse_mat_nullvector_wiedemann(mp_ptr x,
+                                 _nmod_sparse_mat_op_t B, flint_rand_t state);
+
+FLINT_DLL int _nmod_sparse_mat_generalized_nullvector_block_wiedemann(
+                      mp_ptr x, _nmod_sparse_mat_op_t B, slong block_size,
+                                                          flint_rand_t state);
+
+FLINT_DLL int _nmod_sparse_mat_nullvector_block_wiedemann(mp_ptr x,
+              _nmod_sparse_mat_op_t B, slong block_size, flint_rand_t state);
+
+FLINT_DLL slong _nmod_sparse_mat_nullspace_block_wiedemann(nmod_mat_t X,
+                const nmod_sparse_mat_t A, slong block_size, slong max_iters,
+                                           int want_last, flint_rand_t state);
+
+FLINT_DLL int nmod_sparse_mat_solve_wiedemann(mp_ptr x,
+               const nmod_sparse_mat_t A, mp_srcptr b, flint_rand_t state);
+
+FLINT_DLL int nmod_sparse_mat_nullvector_wiedemann(mp_ptr x,
+                             const nmod_sparse_mat_t A, flint_rand_t state);
+
+FLINT_DLL int nmod_sparse_mat_solve_block_wiedemann(mp_ptr x,
+                           const nmod_sparse_mat_t A, mp_srcptr b,
+                                       slong block_size, flint_rand_t state);
+
+FLINT_DLL int nmod_sparse_mat_nullvector_block_wiedemann(mp_ptr x,
+         const nmod_sparse_mat_t A, slong block_size, flint_rand_t state);
+
+FLINT_DLL slong nmod_sparse_mat_nullspace_block_wiedemann(nmod_mat_t X,
+                     const nmod_sparse_mat_t A, slong block_size,
+                                           slong max_iters, flint_rand_t state);
+
+/* Tuning parameters *********************************************************/
+
+/* Minimum number of stored entries handled by each thread in products */
+#define NMOD_SPARSE_MAT_MUL_THREADED_CUTOFF 4096
+
+/* Default block size in the block Wiedemann algorithm */
+#define NMOD_SPARSE_MAT_WIEDEMANN_BLOCK_SIZE 8
+
+/* Number of extra sequence terms computed beyond the expected bound */
+#define NMOD_SPARSE_MAT_WIEDEMANN_EXTRA 8
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_fit_length(nmod_sparse_mat_t A, slong len)
+{
+    slong new_alloc;
+
+    if (len <= A->alloc)
+        return;
+
+    new_alloc = FLINT_MAX(len, 2*A->alloc);
+
+    if (A->alloc > 0)
+    {
+        A->entries = (mp_limb_t *) flint_realloc(A->entries,
+                                                 new_alloc*sizeof(mp_limb_t));
+        A->cols = (slong *) flint_realloc(A->cols, new_alloc*sizeof(slong));
+    }
+    else
+    {
+        A->entries = (mp_limb_t *) flint_malloc(new_alloc*sizeof(mp_limb_t));
+        A->cols = (slong *) flint_malloc(new_alloc*sizeof(slong));
+    }
+
+    A->alloc = new_alloc;
+}
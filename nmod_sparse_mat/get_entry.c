@@ -0,0 +1,33 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_sparse_mat.h"
+
+mp_limb_t nmod_sparse_mat_get_entry(const nmod_sparse_mat_t A,
+                                                            slong i, slong j)
+{
+    slong lo = A->row_starts[i], hi = A->row_starts[i + 1], mid;
+
+    /* binary search for column j in row i */
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo)/2;
+
+        if (A->cols[mid] == j)
+            return A->entries[mid];
+        else if (A->cols[mid] < j)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_get_nmod_mat(nmod_mat_t B, const nmod_sparse_mat_t A)
+{
+    slong i, k;
+
+    FLINT_ASSERT(B->r == A->r && B->c == A->c);
+
+    nmod_mat_zero(B);
+
+    for (i = 0; i < A->r; i++)
+        for (k = A->row_starts[i]; k < A->row_starts[i + 1]; k++)
+            nmod_mat_entry(B, i, A->cols[k]) = A->entries[k];
+}
@@ -0,0 +1,24 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_init(nmod_sparse_mat_t A,
+                                         slong rows, slong cols, mp_limb_t n)
+{
+    A->entries = NULL;
+    A->cols = NULL;
+    A->row_starts = (slong *) flint_calloc(rows + 1, sizeof(slong));
+    A->r = rows;
+    A->c = cols;
+    A->alloc = 0;
+    nmod_init(&A->mod, n);
+}
@@ -0,0 +1,40 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_sparse_mat.h"
+
+int nmod_sparse_mat_is_canonical(const nmod_sparse_mat_t A)
+{
+    slong i, k;
+
+    if (A->row_starts[0] != 0)
+        return 0;
+
+    for (i = 0; i < A->r; i++)
+    {
+        if (A->row_starts[i + 1] < A->row_starts[i])
+            return 0;
+
+        for (k = A->row_starts[i]; k < A->row_starts[i + 1]; k++)
+        {
+            if (A->cols[k] < 0 || A->cols[k] >= A->c)
+                return 0;
+
+            if (k > A->row_starts[i] && A->cols[k] <= A->cols[k - 1])
+                return 0;
+
+            if (A->entries[k] == 0 || A->entries[k] >= A->mod.n)
+                return 0;
+        }
+    }
+
+    return A->row_starts[A->r] <= A->alloc;
+}
@@ -0,0 +1,153 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+static void _mul_mat_rows(nmod_mat_t Y, const nmod_sparse_mat_t A,
+                                         const nmod_mat_t X, slong r1, slong r2)
+{
+    slong i, j, k, len, maxlen;
+    int nlimbs;
+    const mp_limb_t * Aentries;
+    const slong * Acols;
+    mp_limb_t ** Xrows = X->rows;
+
+    maxlen = 0;
+    for (i = r1; i < r2; i++)
+        maxlen = FLINT_MAX(maxlen, nmod_sparse_mat_row_length(A, i));
+
+    nlimbs = _nmod_vec_dot_bound_limbs(maxlen, A->mod);
+
+    for (i = r1; i < r2; i++)
+    {
+        Aentries = A->entries + A->row_starts[i];
+        Acols = A->cols + A->row_starts[i];
+        len = A->row_starts[i + 1] - A->row_starts[i];
+
+        for (j = 0; j < X->c; j++)
+        {
+            NMOD_VEC_DOT(nmod_mat_entry(Y, i, j), k, len,
+                          Aentries[k], Xrows[Acols[k]][j], A->mod, nlimbs);
+        }
+    }
+}
+
+typedef struct
+{
+    nmod_mat_struct * Y;
+    const nmod_sparse_mat_struct * A;
+    const nmod_mat_struct * X;
+    slong r1, r2;
+}
+_worker_arg_struct;
+
+static void _worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _mul_mat_rows(arg->Y, arg->A, arg->X, arg->r1, arg->r2);
+}
+
+void nmod_sparse_mat_mul_mat_threaded(nmod_mat_t Y, const nmod_sparse_mat_t A,
+                                       const nmod_mat_t X, slong thread_limit)
+{
+    slong i, j, num_handles, nnz;
+    thread_pool_handle * handles;
+    _worker_arg_struct * args;
+
+    FLINT_ASSERT(Y != X);
+    FLINT_ASSERT(Y->r == A->r && X->r == A->c && Y->c == X->c);
+
+    if (X->c == 0)
+        return;
+
+    nnz = nmod_sparse_mat_nnz(A);
+    thread_limit = FLINT_MIN(thread_limit,
+                           nnz*X->c/NMOD_SPARSE_MAT_MUL_THREADED_CUTOFF);
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized && thread_limit > 1)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    if (num_handles < 1)
+    {
+        _mul_mat_rows(Y, A, X, 0, A->r);
+        goto cleanup;
+    }
+
+    args = (_worker_arg_struct *) flint_malloc((num_handles + 1)
+                                                 *sizeof(_worker_arg_struct));
+
+    /* give each thread about the same number of stored entries */
+    j = 0;
+    for (i = 0; i <= num_handles; i++)
+    {
+        args[i].Y = Y;
+        args[i].A = A;
+        args[i].X = X;
+        args[i].r1 = j;
+        if (i == num_handles)
+        {
+            j = A->r;
+        }
+        else
+        {
+            slong target = (nnz/(num_handles + 1))*(i + 1);
+            while (j < A->r && A->row_starts[j] < target)
+                j++;
+        }
+        args[i].r2 = j;
+    }
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wake(global_thread_pool, handles[i], _worker, &args[i]);
+
+    _worker(&args[num_handles]);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wait(global_thread_pool, handles[i]);
+
+    flint_free(args);
+
+cleanup:
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles)
+        flint_free(handles);
+}
+
+void nmod_sparse_mat_mul_mat(nmod_mat_t Y, const nmod_sparse_mat_t A,
+                                                           const nmod_mat_t X)
+{
+    if (Y == X)
+    {
+        nmod_mat_t T;
+        nmod_mat_init(T, Y->r, Y->c, Y->mod.n);
+        nmod_sparse_mat_mul_mat_threaded(T, A, X, flint_get_num_threads());
+        nmod_mat_swap(Y, T);
+        nmod_mat_clear(T);
+        return;
+    }
+
+    nmod_sparse_mat_mul_mat_threaded(Y, A, X, flint_get_num_threads());
+}
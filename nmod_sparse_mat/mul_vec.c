@@ -0,0 +1,157 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+/* set y[i] = (A*x)[i] for r1 <= i < r2 */
+void _nmod_sparse_mat_mul_vec_rows(mp_ptr y, const nmod_sparse_mat_t A,
+                                           mp_srcptr x, slong r1, slong r2)
+{
+    slong i, k, len, maxlen;
+    int nlimbs;
+    const mp_limb_t * Aentries;
+    const slong * Acols;
+
+    maxlen = 0;
+    for (i = r1; i < r2; i++)
+        maxlen = FLINT_MAX(maxlen, nmod_sparse_mat_row_length(A, i));
+
+    nlimbs = _nmod_vec_dot_bound_limbs(maxlen, A->mod);
+
+    for (i = r1; i < r2; i++)
+    {
+        Aentries = A->entries + A->row_starts[i];
+        Acols = A->cols + A->row_starts[i];
+        len = A->row_starts[i + 1] - A->row_starts[i];
+
+        NMOD_VEC_DOT(y[i], k, len, Aentries[k], x[Acols[k]], A->mod, nlimbs);
+    }
+}
+
+typedef struct
+{
+    mp_ptr y;
+    const nmod_sparse_mat_struct * A;
+    mp_srcptr x;
+    slong r1, r2;
+}
+_worker_arg_struct;
+
+static void _worker(void * varg)
+{
+    _worker_arg_struct * arg = (_worker_arg_struct *) varg;
+    _nmod_sparse_mat_mul_vec_rows(arg->y, arg->A, arg->x, arg->r1, arg->r2);
+}
+
+/*
+    Split the rows of A into nparts ranges holding roughly the same number of
+    stored entries. bounds has length nparts + 1.
+*/
+static void _split_rows(slong * bounds, const nmod_sparse_mat_t A,
+                                                                slong nparts)
+{
+    slong i, j, nnz = nmod_sparse_mat_nnz(A);
+
+    bounds[0] = 0;
+    i = 0;
+    for (j = 1; j < nparts; j++)
+    {
+        slong target = (nnz/nparts)*j;
+        while (i < A->r && A->row_starts[i] < target)
+            i++;
+        bounds[j] = i;
+    }
+    bounds[nparts] = A->r;
+}
+
+void nmod_sparse_mat_mul_vec_threaded(mp_ptr y, const nmod_sparse_mat_t A,
+                                           mp_srcptr x, slong thread_limit)
+{
+    slong i, num_handles;
+    thread_pool_handle * handles;
+    _worker_arg_struct * args;
+    slong * bounds;
+
+    FLINT_ASSERT(y != x);
+
+    thread_limit = FLINT_MIN(thread_limit,
+                   nmod_sparse_mat_nnz(A)/NMOD_SPARSE_MAT_MUL_THREADED_CUTOFF);
+
+    handles = NULL;
+    num_handles = 0;
+    if (global_thread_pool_initialized && thread_limit > 1)
+    {
+        slong max_num_handles;
+        max_num_handles = thread_pool_get_size(global_thread_pool);
+        max_num_handles = FLINT_MIN(thread_limit - 1, max_num_handles);
+        if (max_num_handles > 0)
+        {
+            handles = (thread_pool_handle *) flint_malloc(
+                                   max_num_handles*sizeof(thread_pool_handle));
+            num_handles = thread_pool_request(global_thread_pool,
+                                                     handles, max_num_handles);
+        }
+    }
+
+    if (num_handles < 1)
+    {
+        _nmod_sparse_mat_mul_vec_rows(y, A, x, 0, A->r);
+        goto cleanup;
+    }
+
+    args = (_worker_arg_struct *) flint_malloc((num_handles + 1)
+                                                 *sizeof(_worker_arg_struct));
+    bounds = (slong *) flint_malloc((num_handles + 2)*sizeof(slong));
+
+    _split_rows(bounds, A, num_handles + 1);
+
+    for (i = 0; i <= num_handles; i++)
+    {
+        args[i].y = y;
+        args[i].A = A;
+        args[i].x = x;
+        args[i].r1 = bounds[i];
+        args[i].r2 = bounds[i + 1];
+    }
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wake(global_thread_pool, handles[i], _worker, &args[i]);
+
+    _worker(&args[num_handles]);
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wait(global_thread_pool, handles[i]);
+
+    flint_free(bounds);
+    flint_free(args);
+
+cleanup:
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles)
+        flint_free(handles);
+}
+
+void nmod_sparse_mat_mul_vec(mp_ptr y, const nmod_sparse_mat_t A,
+                                                                  mp_srcptr x)
+{
+    if (y == x)
+    {
+        mp_ptr t = _nmod_vec_init(A->r);
+        nmod_sparse_mat_mul_vec_threaded(t, A, x, flint_get_num_threads());
+        _nmod_vec_set(y, t, A->r);
+        _nmod_vec_clear(t);
+        return;
+    }
+
+    nmod_sparse_mat_mul_vec_threaded(y, A, x, flint_get_num_threads());
+}
@@ -0,0 +1,164 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+/* kernel of A restricted to the span of the first s rows of V */
+static void _kernel_in_span(nmod_mat_t X, const nmod_sparse_mat_t A,
+                                                 const nmod_mat_t V, slong s)
+{
+    slong i, j, k;
+    nmod_mat_t VT, T, N;
+
+    nmod_mat_clear(X);
+
+    if (s == 0)
+    {
+        nmod_mat_init(X, A->c, 0, A->mod.n);
+        return;
+    }
+
+    nmod_mat_init(VT, A->c, s, A->mod.n);
+    nmod_mat_init(T, A->r, s, A->mod.n);
+    nmod_mat_init(N, s, s, A->mod.n);
+
+    for (i = 0; i < s; i++)
+        for (j = 0; j < A->c; j++)
+            nmod_mat_entry(VT, j, i) = nmod_mat_entry(V, i, j);
+
+    nmod_sparse_mat_mul_mat(T, A, VT);
+    k = nmod_mat_nullspace(N, T);
+
+    nmod_mat_init(X, A->c, k, A->mod.n);
+
+    if (k > 0)
+    {
+        nmod_mat_t Nk;
+        nmod_mat_window_init(Nk, N, 0, 0, s, k);
+        nmod_mat_mul(X, VT, Nk);
+        nmod_mat_window_clear(Nk);
+    }
+
+    nmod_mat_clear(VT);
+    nmod_mat_clear(T);
+    nmod_mat_clear(N);
+}
+
+/*
+    The vectors x, B*x, B^2*x, ... for random vectors x in the generalized
+    kernel of the Wiedemann operator B span the generalized kernel, which
+    contains the kernel of A. Its basis V is grown until max_iters
+    consecutive samples fail to enlarge it, and the kernel of A is then
+    found by dense elimination on A*V^T. If want_last is set, the function
+    returns as soon as the kernel contains a vector with nonzero last
+    coordinate.
+*/
+slong _nmod_sparse_mat_nullspace_block_wiedemann(nmod_mat_t X,
+                const nmod_sparse_mat_t A, slong block_size, slong max_iters,
+                                            int want_last, flint_rand_t state)
+{
+    slong i, j, n = A->c, s, fails;
+    mp_ptr x, z, w;
+    nmod_mat_t V, R;
+    _nmod_sparse_mat_op_t B;
+
+    nmod_mat_clear(X);
+    nmod_mat_init(X, n, 0, A->mod.n);
+
+    if (n == 0)
+        return 0;
+
+    if (block_size <= 0)
+        block_size = NMOD_SPARSE_MAT_WIEDEMANN_BLOCK_SIZE;
+
+    _nmod_sparse_mat_op_init(B, A);
+    nmod_mat_init(V, 0, n, A->mod.n);
+    x = _nmod_vec_init(n);
+    z = _nmod_vec_init(n);
+    w = _nmod_vec_init(n);
+
+    s = 0;
+    fails = 0;
+    while (fails < max_iters && s < n)
+    {
+        slong len, rank;
+
+        if (!_nmod_sparse_mat_generalized_nullvector_block_wiedemann(x, B,
+                                                           block_size, state))
+        {
+            fails++;
+            continue;
+        }
+
+        /* R = [V ; x ; B*x ; ... ] up to the last nonzero vector */
+        _nmod_vec_set(z, x, n);
+        for (len = 1; len < n; len++)
+        {
+            _nmod_sparse_mat_op_apply(w, B, z);
+            if (_nmod_vec_is_zero(w, n))
+                break;
+            _nmod_vec_set(z, w, n);
+        }
+
+        nmod_mat_init(R, s + len, n, A->mod.n);
+        for (i = 0; i < s; i++)
+            _nmod_vec_set(R->rows[i], V->rows[i], n);
+        _nmod_vec_set(R->rows[s], x, n);
+        for (i = s + 1; i < s + len; i++)
+            _nmod_sparse_mat_op_apply(R->rows[i], B, R->rows[i - 1]);
+
+        rank = nmod_mat_rref(R);
+        if (rank > s)
+        {
+            nmod_mat_clear(V);
+            nmod_mat_init(V, rank, n, A->mod.n);
+            for (i = 0; i < rank; i++)
+                _nmod_vec_set(V->rows[i], R->rows[i], n);
+            s = rank;
+            fails = 0;
+        }
+        else
+        {
+            fails++;
+        }
+
+        nmod_mat_clear(R);
+
+        if (want_last && fails == 0)
+        {
+            _kernel_in_span(X, A, V, s);
+            for (j = 0; j < X->c; j++)
+                if (nmod_mat_entry(X, n - 1, j) != 0)
+                    break;
+            if (j < X->c)
+                goto cleanup;
+        }
+    }
+
+    _kernel_in_span(X, A, V, s);
+
+cleanup:
+
+    _nmod_vec_clear(x);
+    _nmod_vec_clear(z);
+    _nmod_vec_clear(w);
+    nmod_mat_clear(V);
+    _nmod_sparse_mat_op_clear(B);
+
+    return X->c;
+}
+
+slong nmod_sparse_mat_nullspace_block_wiedemann(nmod_mat_t X,
+                      const nmod_sparse_mat_t A, slong block_size,
+                                          slong max_iters, flint_rand_t state)
+{
+    return _nmod_sparse_mat_nullspace_block_wiedemann(X, A, block_size,
+                                                     max_iters, 0, state);
+}
@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+slong nmod_sparse_mat_nullspace_rref(nmod_mat_t X, const nmod_sparse_mat_t A)
+{
+    slong i, j, k, rank, nullity;
+    slong * pivots, * colidx;
+    nmod_sparse_mat_t B;
+
+    nmod_sparse_mat_init(B, A->r, A->c, A->mod.n);
+    nmod_sparse_mat_set(B, A);
+
+    pivots = (slong *) flint_malloc((A->r + 1)*sizeof(slong));
+    colidx = (slong *) flint_malloc((A->c + 1)*sizeof(slong));
+
+    rank = nmod_sparse_mat_rref(B, pivots);
+    nullity = A->c - rank;
+
+    nmod_mat_clear(X);
+    nmod_mat_init(X, A->c, nullity, A->mod.n);
+
+    /* number the free columns */
+    for (j = 0; j < A->c; j++)
+        colidx[j] = 0;
+    for (i = 0; i < rank; i++)
+        colidx[pivots[i]] = -WORD(1);
+    for (j = 0, k = 0; j < A->c; j++)
+    {
+        if (colidx[j] == 0)
+        {
+            colidx[j] = k;
+            nmod_mat_entry(X, j, k) = 1;
+            k++;
+        }
+    }
+
+    for (i = 0; i < rank; i++)
+    {
+        for (k = B->row_starts[i]; k < B->row_starts[i + 1]; k++)
+        {
+            j = B->cols[k];
+            if (colidx[j] >= 0)
+                nmod_mat_entry(X, pivots[i], colidx[j]) =
+                                          nmod_neg(B->entries[k], B->mod);
+        }
+    }
+
+    flint_free(colidx);
+    flint_free(pivots);
+    nmod_sparse_mat_clear(B);
+
+    return nullity;
+}
@@ -0,0 +1,359 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "nmod_sparse_mat.h"
+
+static void _randmat(nmod_mat_t X, flint_rand_t state)
+{
+    slong i, j;
+    for (i = 0; i < X->r; i++)
+        for (j = 0; j < X->c; j++)
+            nmod_mat_entry(X, i, j) = n_randint(state, X->mod.n);
+}
+
+/* stable sort of 0, ..., m - 1 by shift */
+static void _sort_by_shift(slong * order, const slong * shift, slong m)
+{
+    slong r, t;
+
+    for (r = 0; r < m; r++)
+    {
+        t = r;
+        while (t > 0 && shift[order[t - 1]] > shift[r])
+        {
+            order[t] = order[t - 1];
+            t--;
+        }
+        order[t] = r;
+    }
+}
+
+/*
+    Minimal approximant basis (the iterative "mbasis" algorithm of
+    Beckermann and Labahn) of the 2b x b matrix power series
+    G = [S^T ; -I] to order N, where S = sum_i S_i z^i. Row r of the basis
+    is stored in P as 2b polynomials of length L = N + 2 each, and E holds
+    the truncated residual series P*G. Rows 0 <= r < b start with shift 0
+    and rows b <= r < 2b with shift 1, so that a row [g, h] of shifted
+    degree s satisfies deg(g) <= s and deg(h) < s.
+*/
+static void _mbasis(mp_ptr P, slong * shift, const nmod_mat_struct * S,
+                                              slong b, slong N, nmod_t mod)
+{
+    slong i, j, k, l, r, t, m = 2*b, L = N + 2;
+    slong * order, * pivrow, * pivcol, npiv;
+    mp_ptr E;
+
+#define PP(r, t) (P + ((r)*m + (t))*L)
+#define EE(r, j) (E + ((r)*b + (j))*N)
+
+    E = (mp_ptr) flint_calloc(m*b*N, sizeof(mp_limb_t));
+    order = (slong *) flint_malloc(m*sizeof(slong));
+    pivrow = (slong *) flint_malloc(m*sizeof(slong));
+    pivcol = (slong *) flint_malloc(m*sizeof(slong));
+
+    memset(P, 0, m*m*L*sizeof(mp_limb_t));
+
+    for (r = 0; r < m; r++)
+    {
+        PP(r, r)[0] = 1;
+        shift[r] = (r >= b);
+    }
+
+    for (r = 0; r < b; r++)
+        for (j = 0; j < b; j++)
+            for (i = 0; i < N; i++)
+                EE(r, j)[i] = nmod_mat_entry(S + i, j, r);
+
+    for (j = 0; j < b; j++)
+        EE(b + j, j)[0] = nmod_neg(1, mod);
+
+    for (k = 0; k < N; k++)
+    {
+        _sort_by_shift(order, shift, m);
+
+        /*
+            Gaussian elimination on the coefficients of z^k of the residual,
+            only ever subtracting rows of smaller or equal shift
+        */
+        npiv = 0;
+        for (i = 0; i < m; i++)
+        {
+            r = order[i];
+
+            for (l = 0; l < npiv; l++)
+            {
+                slong q = pivrow[l];
+                mp_limb_t c = EE(r, pivcol[l])[k];
+
+                if (c == 0)
+                    continue;
+
+                c = nmod_neg(nmod_mul(c, nmod_inv(EE(q, pivcol[l])[k], mod),
+                                                                  mod), mod);
+
+                for (j = 0; j < b; j++)
+                    _nmod_vec_scalar_addmul_nmod(EE(r, j) + k, EE(q, j) + k,
+                                                               N - k, c, mod);
+                for (t = 0; t < m; t++)
+                    _nmod_vec_scalar_addmul_nmod(PP(r, t), PP(q, t),
+                                                      shift[q] + 1, c, mod);
+            }
+
+            for (j = 0; j < b; j++)
+            {
+                if (EE(r, j)[k] != 0)
+                {
+                    pivrow[npiv] = r;
+                    pivcol[npiv] = j;
+                    npiv++;
+                    break;
+                }
+            }
+        }
+
+        /* multiply the pivot rows by z */
+        for (l = 0; l < npiv; l++)
+        {
+            r = pivrow[l];
+
+            for (j = 0; j < b; j++)
+            {
+                memmove(EE(r, j) + 1, EE(r, j), (N - 1)*sizeof(mp_limb_t));
+                EE(r, j)[0] = 0;
+            }
+
+            for (t = 0; t < m; t++)
+            {
+                memmove(PP(r, t) + 1, PP(r, t), (L - 1)*sizeof(mp_limb_t));
+                PP(r, t)[0] = 0;
+            }
+
+            shift[r]++;
+        }
+    }
+
+#undef PP
+#undef EE
+
+    flint_free(E);
+    flint_free(order);
+    flint_free(pivrow);
+    flint_free(pivcol);
+}
+
+/*
+    The sequence S_i = U*B^i*V with V = B*Y for random U and Y has a matrix
+    generator of degree about n/b, which is read off from the rows of small
+    shifted degree delta of the approximant basis: a row [g, h] gives the
+    relation sum_j B^j*V*f_j = 0 with f_j = coeff(g, delta - j). If l is the
+    least index with f_l != 0, then x = sum_{j>=l} B^(j-l)*Y*f_j is killed by
+    B^(l+1), i.e. it lies in the generalized kernel of B.
+*/
+int _nmod_sparse_mat_generalized_nullvector_block_wiedemann(mp_ptr x,
+               _nmod_sparse_mat_op_t B, slong block_size, flint_rand_t state)
+{
+    slong i, j, k, l, r, n = B->n, b, d, N, L, m;
+    int success = 0, nlimbs;
+    nmod_mat_t Y, U, V, W;
+    nmod_mat_struct * S;
+    mp_ptr P, F, w, z;
+    slong * shift, * order;
+    nmod_t mod = B->A->mod;
+
+    b = FLINT_MAX(block_size, 1);
+    b = FLINT_MIN(b, n);
+    m = 2*b;
+    d = (n + b - 1)/b;
+    N = 2*d + NMOD_SPARSE_MAT_WIEDEMANN_EXTRA;
+    L = N + 2;
+
+    nmod_mat_init(Y, n, b, mod.n);
+    nmod_mat_init(U, b, n, mod.n);
+    nmod_mat_init(V, n, b, mod.n);
+    nmod_mat_init(W, n, b, mod.n);
+    S = (nmod_mat_struct *) flint_malloc(N*sizeof(nmod_mat_struct));
+
+    _randmat(Y, state);
+    _randmat(U, state);
+
+    _nmod_sparse_mat_op_apply_block(V, B, Y);
+    for (i = 0; i < N; i++)
+    {
+        nmod_mat_init(S + i, b, b, mod.n);
+        nmod_mat_mul(S + i, U, V);
+        _nmod_sparse_mat_op_apply_block(W, B, V);
+        nmod_mat_swap(V, W);
+    }
+
+    P = (mp_ptr) flint_malloc(m*m*L*sizeof(mp_limb_t));
+    shift = (slong *) flint_malloc(m*sizeof(slong));
+    order = (slong *) flint_malloc(m*sizeof(slong));
+
+    _mbasis(P, shift, S, b, N, mod);
+    _sort_by_shift(order, shift, m);
+
+    F = _nmod_vec_init(b);
+    w = _nmod_vec_init(n);
+    z = _nmod_vec_init(n);
+    nlimbs = _nmod_vec_dot_bound_limbs(b, mod);
+
+    for (i = 0; i < m && !success; i++)
+    {
+        slong delta;
+
+        r = order[i];
+        delta = shift[r];
+
+        if (delta >= N)
+            break;
+
+        for (l = 0; l <= delta; l++)
+        {
+            for (j = 0; j < b; j++)
+                if (P[(r*m + j)*L + delta - l] != 0)
+                    break;
+            if (j < b)
+                break;
+        }
+
+        if (l > delta)
+            continue;
+
+        /* Horner's rule */
+        _nmod_vec_zero(w, n);
+        for (k = delta; k >= l; k--)
+        {
+            for (j = 0; j < b; j++)
+                F[j] = P[(r*m + j)*L + delta - k];
+
+            if (k < delta)
+                _nmod_sparse_mat_op_apply(z, B, w);
+            else
+                _nmod_vec_zero(z, n);
+
+            for (j = 0; j < n; j++)
+                z[j] = nmod_add(z[j],
+                          _nmod_vec_dot(Y->rows[j], F, b, mod, nlimbs), mod);
+
+            _nmod_vec_set(w, z, n);
+        }
+
+        if (!_nmod_vec_is_zero(w, n))
+        {
+            _nmod_vec_set(x, w, n);
+            success = 1;
+        }
+    }
+
+    _nmod_vec_clear(F);
+    _nmod_vec_clear(w);
+    _nmod_vec_clear(z);
+    flint_free(P);
+    flint_free(shift);
+    flint_free(order);
+
+    for (i = 0; i < N; i++)
+        nmod_mat_clear(S + i);
+    flint_free(S);
+
+    nmod_mat_clear(Y);
+    nmod_mat_clear(U);
+    nmod_mat_clear(V);
+    nmod_mat_clear(W);
+
+    return success;
+}
+
+/* the last nonzero vector among x, B*x, B^2*x, ... is a nullvector */
+int _nmod_sparse_mat_nullvector_block_wiedemann(mp_ptr x,
+               _nmod_sparse_mat_op_t B, slong block_size, flint_rand_t state)
+{
+    slong k, n = B->n;
+    int success = 0;
+    mp_ptr z;
+
+    if (!_nmod_sparse_mat_generalized_nullvector_block_wiedemann(x, B,
+                                                           block_size, state))
+        return 0;
+
+    z = _nmod_vec_init(n);
+
+    for (k = 0; k <= n; k++)
+    {
+        _nmod_sparse_mat_op_apply(z, B, x);
+
+        if (_nmod_vec_is_zero(z, n))
+        {
+            success = 1;
+            break;
+        }
+
+        _nmod_vec_set(x, z, n);
+    }
+
+    _nmod_vec_clear(z);
+
+    return success;
+}
+
+int nmod_sparse_mat_nullvector_block_wiedemann(mp_ptr x,
+          const nmod_sparse_mat_t A, slong block_size, flint_rand_t state)
+{
+    slong iter;
+    int success = 0;
+    mp_ptr t;
+    _nmod_sparse_mat_op_t B;
+
+    if (A->c == 0)
+        return 0;
+
+    if (block_size <= 0)
+        block_size = NMOD_SPARSE_MAT_WIEDEMANN_BLOCK_SIZE;
+
+    _nmod_sparse_mat_op_init(B, A);
+    t = _nmod_vec_init(A->r);
+
+    for (iter = 0; iter < 4 && !success; iter++)
+    {
+        success = _nmod_sparse_mat_nullvector_block_wiedemann(x, B,
+                                                           block_size, state);
+
+        /* the kernel of A^T*A may be larger than that of A */
+        if (success && A->r > A->c)
+        {
+            nmod_sparse_mat_mul_vec(t, A, x);
+            success = _nmod_vec_is_zero(t, A->r);
+        }
+    }
+
+    /* over small fields the kernel of A^T*A is often too large */
+    if (!success && A->r > A->c)
+    {
+        nmod_mat_t X;
+        slong i;
+
+        nmod_mat_init(X, A->c, 0, A->mod.n);
+        if (_nmod_sparse_mat_nullspace_block_wiedemann(X, A, block_size, 4, 0,
+                                                                  state) > 0)
+        {
+            for (i = 0; i < A->c; i++)
+                x[i] = nmod_mat_entry(X, i, 0);
+            success = 1;
+        }
+        nmod_mat_clear(X);
+    }
+
+    _nmod_vec_clear(t);
+    _nmod_sparse_mat_op_clear(B);
+
+    return success;
+}
@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+static void _randvec(mp_ptr v, slong len, flint_rand_t state, nmod_t mod)
+{
+    slong i;
+    for (i = 0; i < len; i++)
+        v[i] = n_randint(state, mod.n);
+}
+
+/*
+    Look for a nonzero vector x with B*x = 0 using the minimal polynomial f
+    of the sequence u.B^i.v for v = B*y and random u, y, computed by the
+    Berlekamp-Massey algorithm. Writing f = z^l*g with g(0) != 0, we have
+    B^(l+1)*g(B)*y = 0, so the last nonzero vector in w, B*w, ..., B^(l+1)*w
+    with w = g(B)*y lies in the kernel of B.
+*/
+int _nmod_sparse_mat_nullvector_wiedemann(mp_ptr x, _nmod_sparse_mat_op_t B,
+                                                           flint_rand_t state)
+{
+    slong i, k, l, n = B->n;
+    int success = 0, nlimbs;
+    mp_ptr y, u, w, z;
+    nmod_berlekamp_massey_t BM;
+    const nmod_poly_struct * f;
+    nmod_t mod = B->A->mod;
+
+    y = _nmod_vec_init(n);
+    u = _nmod_vec_init(n);
+    w = _nmod_vec_init(n);
+    z = _nmod_vec_init(n);
+    nmod_berlekamp_massey_init(BM, mod.n);
+    nlimbs = _nmod_vec_dot_bound_limbs(n, mod);
+
+    _randvec(y, n, state, mod);
+    _randvec(u, n, state, mod);
+
+    _nmod_sparse_mat_op_apply(w, B, y);
+    for (i = 0; i < 2*n + NMOD_SPARSE_MAT_WIEDEMANN_EXTRA; i++)
+    {
+        nmod_berlekamp_massey_add_point(BM,
+                                         _nmod_vec_dot(u, w, n, mod, nlimbs));
+        _nmod_sparse_mat_op_apply(z, B, w);
+        _nmod_vec_set(w, z, n);
+    }
+
+    nmod_berlekamp_massey_reduce(BM);
+    f = nmod_berlekamp_massey_V_poly(BM);
+
+    for (l = 0; l < f->length && f->coeffs[l] == 0; l++) ;
+
+    if (l >= f->length)
+        goto cleanup;
+
+    /* w = g(B)*y by Horner's rule */
+    _nmod_vec_zero(w, n);
+    for (i = f->length - 1; i >= l; i--)
+    {
+        _nmod_sparse_mat_op_apply(z, B, w);
+        _nmod_vec_scalar_addmul_nmod(z, y, n, f->coeffs[i], mod);
+        _nmod_vec_set(w, z, n);
+    }
+
+    if (_nmod_vec_is_zero(w, n))
+        goto cleanup;
+
+    for (k = 0; k <= l + 1; k++)
+    {
+        _nmod_sparse_mat_op_apply(z, B, w);
+
+        if (_nmod_vec_is_zero(z, n))
+        {
+            _nmod_vec_set(x, w, n);
+            success = 1;
+            break;
+        }
+
+        _nmod_vec_set(w, z, n);
+    }
+
+cleanup:
+
+    nmod_berlekamp_massey_clear(BM);
+    _nmod_vec_clear(y);
+    _nmod_vec_clear(u);
+    _nmod_vec_clear(w);
+    _nmod_vec_clear(z);
+
+    return success;
+}
+
+int nmod_sparse_mat_nullvector_wiedemann(mp_ptr x, const nmod_sparse_mat_t A,
+                                                          flint_rand_t state)
+{
+    slong iter;
+    int success = 0;
+    mp_ptr t;
+    _nmod_sparse_mat_op_t B;
+
+    if (A->c == 0)
+        return 0;
+
+    _nmod_sparse_mat_op_init(B, A);
+    t = _nmod_vec_init(A->r);
+
+    for (iter = 0; iter < 4 && !success; iter++)
+    {
+        success = _nmod_sparse_mat_nullvector_wiedemann(x, B, state);
+
+        /* the kernel of A^T*A may be larger than that of A */
+        if (success && A->r > A->c)
+        {
+            nmod_sparse_mat_mul_vec(t, A, x);
+            success = _nmod_vec_is_zero(t, A->r);
+        }
+    }
+
+    /* over small fields the kernel of A^T*A is often too large */
+    if (!success && A->r > A->c)
+    {
+        nmod_mat_t X;
+        slong i;
+
+        nmod_mat_init(X, A->c, 0, A->mod.n);
+        if (_nmod_sparse_mat_nullspace_block_wiedemann(X, A, 1, 4, 0,
+                                                                  state) > 0)
+        {
+            for (i = 0; i < A->c; i++)
+                x[i] = nmod_mat_entry(X, i, 0);
+            success = 1;
+        }
+        nmod_mat_clear(X);
+    }
+
+    _nmod_vec_clear(t);
+    _nmod_sparse_mat_op_clear(B);
+
+    return success;
+}
@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+void _nmod_sparse_mat_op_init(_nmod_sparse_mat_op_t B,
+                                                    const nmod_sparse_mat_t A)
+{
+    B->A = A;
+    B->n = A->c;
+    B->t = _nmod_vec_init(A->r);
+
+    nmod_sparse_mat_init(B->AT, A->c, A->r, A->mod.n);
+    if (A->r > A->c)
+        nmod_sparse_mat_transpose(B->AT, A);
+}
+
+void _nmod_sparse_mat_op_clear(_nmod_sparse_mat_op_t B)
+{
+    _nmod_vec_clear(B->t);
+    nmod_sparse_mat_clear(B->AT);
+}
+
+void _nmod_sparse_mat_op_apply(mp_ptr y, _nmod_sparse_mat_op_t B,
+                                                                  mp_srcptr x)
+{
+    const nmod_sparse_mat_struct * A = B->A;
+
+    if (A->r == A->c)
+    {
+        nmod_sparse_mat_mul_vec(y, A, x);
+    }
+    else if (A->r < A->c)
+    {
+        nmod_sparse_mat_mul_vec(y, A, x);
+        _nmod_vec_zero(y + A->r, A->c - A->r);
+    }
+    else
+    {
+        nmod_sparse_mat_mul_vec(B->t, A, x);
+        nmod_sparse_mat_mul_vec(y, B->AT, B->t);
+    }
+}
+
+void _nmod_sparse_mat_op_apply_block(nmod_mat_t Y, _nmod_sparse_mat_op_t B,
+                                                            const nmod_mat_t X)
+{
+    slong i;
+    const nmod_sparse_mat_struct * A = B->A;
+
+    if (A->r == A->c)
+    {
+        nmod_sparse_mat_mul_mat(Y, A, X);
+    }
+    else if (A->r < A->c)
+    {
+        nmod_mat_t W;
+        nmod_mat_window_init(W, Y, 0, 0, A->r, Y->c);
+        nmod_sparse_mat_mul_mat(W, A, X);
+        nmod_mat_window_clear(W);
+        for (i = A->r; i < A->c; i++)
+            _nmod_vec_zero(Y->rows[i], Y->c);
+    }
+    else
+    {
+        nmod_mat_t T;
+        nmod_mat_init(T, A->r, X->c, A->mod.n);
+        nmod_sparse_mat_mul_mat(T, A, X);
+        nmod_sparse_mat_mul_mat(Y, B->AT, T);
+        nmod_mat_clear(T);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+/*
+    Each row receives between min_nnz and max_nnz nonzero entries (capped at
+    the number of columns) in uniformly random distinct columns.
+*/
+void nmod_sparse_mat_randtest(nmod_sparse_mat_t A, flint_rand_t state,
+                                                  slong min_nnz, slong max_nnz)
+{
+    slong i, j, k, len, rlen;
+    slong * perm;
+
+    min_nnz = FLINT_MAX(min_nnz, 0);
+    max_nnz = FLINT_MIN(max_nnz, A->c);
+    min_nnz = FLINT_MIN(min_nnz, max_nnz);
+
+    perm = (slong *) flint_malloc(FLINT_MAX(A->c, 1)*sizeof(slong));
+    for (j = 0; j < A->c; j++)
+        perm[j] = j;
+
+    nmod_sparse_mat_fit_length(A, A->r*max_nnz);
+
+    len = 0;
+    for (i = 0; i < A->r; i++)
+    {
+        A->row_starts[i] = len;
+
+        if (A->mod.n == 1)
+            continue;
+
+        rlen = min_nnz + n_randint(state, max_nnz - min_nnz + 1);
+
+        /* partial Fisher-Yates shuffle picks the columns */
+        for (k = 0; k < rlen; k++)
+        {
+            slong t;
+            j = k + n_randint(state, A->c - k);
+            t = perm[k]; perm[k] = perm[j]; perm[j] = t;
+        }
+
+        for (k = 0; k < rlen; k++)
+        {
+            slong t = len + k;
+            slong v = perm[k];
+
+            /* insertion sort of the chosen columns */
+            while (t > len && A->cols[t - 1] > v)
+            {
+                A->cols[t] = A->cols[t - 1];
+                t--;
+            }
+            A->cols[t] = v;
+        }
+
+        for (k = 0; k < rlen; k++)
+            A->entries[len + k] = 1 + n_randint(state, A->mod.n - 1);
+
+        len += rlen;
+    }
+    A->row_starts[A->r] = len;
+
+    flint_free(perm);
+}
@@ -0,0 +1,28 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+slong nmod_sparse_mat_rank(const nmod_sparse_mat_t A)
+{
+    slong rank, * pivots;
+    nmod_sparse_mat_t B;
+
+    nmod_sparse_mat_init(B, A->r, A->c, A->mod.n);
+    nmod_sparse_mat_set(B, A);
+
+    pivots = (slong *) flint_malloc((A->r + 1)*sizeof(slong));
+    rank = nmod_sparse_mat_rref(B, pivots);
+
+    flint_free(pivots);
+    nmod_sparse_mat_clear(B);
+
+    return rank;
+}
@@ -0,0 +1,409 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+/* growable sparse row used during the elimination */
+typedef struct
+{
+    slong * cols;
+    mp_limb_t * vals;
+    slong len;
+    slong alloc;
+}
+_srow_struct;
+
+/* growable list of row indices */
+typedef struct
+{
+    slong * idx;
+    slong len;
+    slong alloc;
+}
+_slist_struct;
+
+static void _srow_fit_length(_srow_struct * v, slong len)
+{
+    if (len > v->alloc)
+    {
+        slong new_alloc = FLINT_MAX(len, 2*v->alloc);
+        v->cols = (slong *) flint_realloc(v->cols, new_alloc*sizeof(slong));
+        v->vals = (mp_limb_t *) flint_realloc(v->vals,
+                                                 new_alloc*sizeof(mp_limb_t));
+        v->alloc = new_alloc;
+    }
+}
+
+static void _slist_push(_slist_struct * L, slong i)
+{
+    if (L->len >= L->alloc)
+    {
+        L->alloc = FLINT_MAX(L->len + 1, 2*L->alloc);
+        L->idx = (slong *) flint_realloc(L->idx, L->alloc*sizeof(slong));
+    }
+    L->idx[L->len++] = i;
+}
+
+static slong _srow_find(const _srow_struct * v, slong j)
+{
+    slong lo = 0, hi = v->len, mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo)/2;
+        if (v->cols[mid] == j)
+            return mid;
+        else if (v->cols[mid] < j)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return -WORD(1);
+}
+
+/*
+    w = w - c*v as sparse rows, recording in colrows every column that w
+    gains. The entry in column p of w is known to cancel.
+*/
+static void _srow_submul(_srow_struct * w, slong widx,
+                const _srow_struct * v, mp_limb_t c, _srow_struct * t,
+                                        _slist_struct * colrows, nmod_t mod)
+{
+    slong i = 0, j = 0, k = 0;
+    mp_limb_t nc = nmod_neg(c, mod);
+
+    _srow_fit_length(t, w->len + v->len);
+
+    while (i < w->len && j < v->len)
+    {
+        if (w->cols[i] < v->cols[j])
+        {
+            t->cols[k] = w->cols[i];
+            t->vals[k] = w->vals[i];
+            i++; k++;
+        }
+        else if (w->cols[i] > v->cols[j])
+        {
+            t->cols[k] = v->cols[j];
+            t->vals[k] = nmod_mul(nc, v->vals[j], mod);
+            _slist_push(colrows + v->cols[j], widx);
+            j++; k++;
+        }
+        else
+        {
+            t->cols[k] = w->cols[i];
+            t->vals[k] = nmod_add(w->vals[i],
+                                       nmod_mul(nc, v->vals[j], mod), mod);
+            k += (t->vals[k] != 0);
+            i++; j++;
+        }
+    }
+
+    while (i < w->len)
+    {
+        t->cols[k] = w->cols[i];
+        t->vals[k] = w->vals[i];
+        i++; k++;
+    }
+
+    while (j < v->len)
+    {
+        t->cols[k] = v->cols[j];
+        t->vals[k] = nmod_mul(nc, v->vals[j], mod);
+        _slist_push(colrows + v->cols[j], widx);
+        j++; k++;
+    }
+
+    t->len = k;
+
+    {
+        _srow_struct s = *w;
+        *w = *t;
+        *t = s;
+    }
+}
+
+typedef struct
+{
+    slong len;
+    slong row;
+}
+_order_struct;
+
+static int _order_cmp(const void * a, const void * b)
+{
+    const _order_struct * x = (const _order_struct *) a;
+    const _order_struct * y = (const _order_struct *) b;
+
+    if (x->len != y->len)
+        return (x->len > y->len) - (x->len < y->len);
+
+    return (x->row > y->row) - (x->row < y->row);
+}
+
+static int _pivot_cmp(const void * a, const void * b)
+{
+    const slong * x = (const slong *) a;
+    const slong * y = (const slong *) b;
+    return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+static int _slong_cmp(const void * a, const void * b)
+{
+    slong x = *(const slong *) a;
+    slong y = *(const slong *) b;
+    return (x > y) - (x < y);
+}
+
+/*
+    Sparse Gauss-Jordan elimination of A over Z/pZ with only the first
+    pivot_cols columns eligible as pivots. The rows of A are inserted in
+    order of increasing weight. Each incoming row is reduced against the
+    current pivot rows using a dense accumulator, and its pivot is chosen in
+    the column that occurs in the fewest pivot rows (a Markowitz-type
+    criterion), which limits the fill-in caused by the back elimination.
+
+    On return the first rank rows of A have a 1 in column pivots[i] and every
+    other row is zero in that column; these rows are sorted by pivot column.
+    They are followed by the remaining nonzero rows, which are supported on
+    the columns >= pivot_cols, and then by zero rows. The rank is returned.
+*/
+slong _nmod_sparse_mat_rref(nmod_sparse_mat_t A, slong * pivots,
+                                                             slong pivot_cols)
+{
+    slong i, j, k, r = A->r, c = A->c, rank, nextra, len;
+    _srow_struct * rows, * extra, tmp[1];
+    _slist_struct * colrows;
+    _order_struct * order;
+    slong * pivrow, * touched, * pivlist;
+    mp_limb_t * acc;
+    char * mark;
+    nmod_t mod = A->mod;
+
+    pivot_cols = FLINT_MIN(pivot_cols, c);
+
+    rows = (_srow_struct *) flint_calloc(r + 1, sizeof(_srow_struct));
+    extra = (_srow_struct *) flint_calloc(r + 1, sizeof(_srow_struct));
+    colrows = (_slist_struct *) flint_calloc(c + 1, sizeof(_slist_struct));
+    order = (_order_struct *) flint_malloc((r + 1)*sizeof(_order_struct));
+    pivrow = (slong *) flint_malloc((c + 1)*sizeof(slong));
+    touched = (slong *) flint_malloc((c + 1)*sizeof(slong));
+    acc = (mp_limb_t *) flint_calloc(c + 1, sizeof(mp_limb_t));
+    mark = (char *) flint_calloc(c + 1, sizeof(char));
+    tmp->cols = NULL;
+    tmp->vals = NULL;
+    tmp->alloc = 0;
+    tmp->len = 0;
+
+    for (j = 0; j < c; j++)
+        pivrow[j] = -WORD(1);
+
+    for (i = 0; i < r; i++)
+    {
+        order[i].len = nmod_sparse_mat_row_length(A, i);
+        order[i].row = i;
+    }
+
+    qsort(order, r, sizeof(_order_struct), _order_cmp);
+
+    rank = 0;
+    nextra = 0;
+
+    for (i = 0; i < r; i++)
+    {
+        slong ai = order[i].row, ntouched = 0, best;
+        _srow_struct * v;
+
+        if (order[i].len == 0)
+            continue;
+
+        /* scatter row ai into the accumulator */
+        for (k = A->row_starts[ai]; k < A->row_starts[ai + 1]; k++)
+        {
+            j = A->cols[k];
+            acc[j] = A->entries[k];
+            mark[j] = 1;
+            touched[ntouched++] = j;
+        }
+
+        /*
+            Eliminate the pivot columns. Pivot rows vanish on all other
+            pivot columns, so only the original entries need to be checked.
+        */
+        for (k = A->row_starts[ai]; k < A->row_starts[ai + 1]; k++)
+        {
+            slong p = pivrow[A->cols[k]], l;
+            mp_limb_t a;
+
+            if (p < 0)
+                continue;
+
+            a = nmod_neg(acc[A->cols[k]], mod);
+            if (a == 0)
+                continue;
+
+            for (l = 0; l < rows[p].len; l++)
+            {
+                j = rows[p].cols[l];
+                if (!mark[j])
+                {
+                    mark[j] = 1;
+                    acc[j] = 0;
+                    touched[ntouched++] = j;
+                }
+                acc[j] = nmod_add(acc[j], nmod_mul(a, rows[p].vals[l], mod),
+                                                                         mod);
+            }
+        }
+
+        qsort(touched, ntouched, sizeof(slong), _slong_cmp);
+
+        /* gather the reduced row and look for the sparsest pivot column */
+        v = rows + rank;
+        _srow_fit_length(v, ntouched);
+        len = 0;
+        best = -WORD(1);
+        for (k = 0; k < ntouched; k++)
+        {
+            j = touched[k];
+            mark[j] = 0;
+
+            if (acc[j] == 0)
+                continue;
+
+            v->cols[len] = j;
+            v->vals[len] = acc[j];
+            len++;
+
+            if (j < pivot_cols && (best < 0
+                                  || colrows[j].len < colrows[best].len))
+            {
+                best = j;
+            }
+        }
+        v->len = len;
+
+        if (len == 0)
+            continue;
+
+        if (best < 0)
+        {
+            /* no admissible pivot: keep the row aside */
+            _srow_struct s = extra[nextra];
+            extra[nextra] = *v;
+            *v = s;
+            nextra++;
+            continue;
+        }
+
+        /* normalise the pivot to 1 */
+        {
+            mp_limb_t inv = nmod_inv(v->vals[_srow_find(v, best)], mod);
+            for (k = 0; k < v->len; k++)
+                v->vals[k] = nmod_mul(v->vals[k], inv, mod);
+        }
+
+        /* back eliminate the new pivot column from the older pivot rows */
+        for (k = 0; k < colrows[best].len; k++)
+        {
+            slong w = colrows[best].idx[k], l;
+
+            if (w == rank)
+                continue;
+
+            l = _srow_find(rows + w, best);
+            if (l < 0)
+                continue;
+
+            _srow_submul(rows + w, w, v, rows[w].vals[l], tmp, colrows, mod);
+        }
+
+        colrows[best].len = 0;
+
+        for (k = 0; k < v->len; k++)
+            _slist_push(colrows + v->cols[k], rank);
+
+        pivrow[best] = rank;
+        pivots[rank] = best;
+        rank++;
+    }
+
+    /* sort the pivot rows by pivot column and write back */
+    pivlist = (slong *) flint_malloc((2*rank + 1)*sizeof(slong));
+    for (i = 0; i < rank; i++)
+    {
+        pivlist[2*i + 0] = pivots[i];
+        pivlist[2*i + 1] = i;
+    }
+
+    qsort(pivlist, rank, 2*sizeof(slong), _pivot_cmp);
+
+    len = 0;
+    for (i = 0; i < rank; i++)
+        len += rows[i].len;
+    for (i = 0; i < nextra; i++)
+        len += extra[i].len;
+
+    nmod_sparse_mat_fit_length(A, len);
+
+    len = 0;
+    for (i = 0; i < r; i++)
+    {
+        _srow_struct * v = (i < rank) ? rows + pivlist[2*i + 1]
+                         : (i < rank + nextra) ? extra + i - rank : NULL;
+
+        A->row_starts[i] = len;
+
+        if (v == NULL)
+            continue;
+
+        for (k = 0; k < v->len; k++)
+        {
+            A->cols[len + k] = v->cols[k];
+            A->entries[len + k] = v->vals[k];
+        }
+        len += v->len;
+
+        if (i < rank)
+            pivots[i] = pivlist[2*i + 0];
+    }
+    A->row_starts[r] = len;
+
+    for (i = 0; i <= r; i++)
+    {
+        flint_free(rows[i].cols);
+        flint_free(rows[i].vals);
+        flint_free(extra[i].cols);
+        flint_free(extra[i].vals);
+    }
+
+    for (j = 0; j <= c; j++)
+        flint_free(colrows[j].idx);
+
+    flint_free(tmp->cols);
+    flint_free(tmp->vals);
+    flint_free(pivlist);
+    flint_free(rows);
+    flint_free(extra);
+    flint_free(colrows);
+    flint_free(order);
+    flint_free(pivrow);
+    flint_free(touched);
+    flint_free(acc);
+    flint_free(mark);
+
+    return rank;
+}
+
+slong nmod_sparse_mat_rref(nmod_sparse_mat_t A, slong * pivots)
+{
+    return _nmod_sparse_mat_rref(A, pivots, A->c);
+}
@@ -0,0 +1,38 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_set(nmod_sparse_mat_t B, const nmod_sparse_mat_t A)
+{
+    slong nnz;
+
+    if (B == A)
+        return;
+
+    if (B->r != A->r)
+    {
+        B->row_starts = (slong *) flint_realloc(B->row_starts,
+                                                    (A->r + 1)*sizeof(slong));
+        B->r = A->r;
+    }
+
+    B->c = A->c;
+    B->mod = A->mod;
+
+    nnz = nmod_sparse_mat_nnz(A);
+    nmod_sparse_mat_fit_length(B, nnz);
+
+    flint_mpn_copyi(B->entries, A->entries, nnz);
+    memcpy(B->cols, A->cols, nnz*sizeof(slong));
+    memcpy(B->row_starts, A->row_starts, (A->r + 1)*sizeof(slong));
+}
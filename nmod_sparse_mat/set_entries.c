@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+typedef struct
+{
+    slong col;
+    mp_limb_t val;
+} _entry_struct;
+
+static int _entry_cmp(const void * a, const void * b)
+{
+    slong x = ((const _entry_struct *) a)->col;
+    slong y = ((const _entry_struct *) b)->col;
+    return (x > y) - (x < y);
+}
+
+/*
+    Set A to the matrix whose entry (rows[k], cols[k]) is vals[k]. The
+    triples may be given in any order; values at repeated positions are
+    added together and zero sums are not stored.
+*/
+void nmod_sparse_mat_set_entries(nmod_sparse_mat_t A, const slong * rows,
+                  const slong * cols, const mp_limb_t * vals, slong nnz)
+{
+    slong i, k, start, end, len;
+    slong * pos;
+    _entry_struct * T;
+
+    pos = (slong *) flint_calloc(A->r + 1, sizeof(slong));
+    T = (_entry_struct *) flint_malloc(FLINT_MAX(nnz, 1)*sizeof(_entry_struct));
+
+    /* bucket the triples by row */
+    for (k = 0; k < nnz; k++)
+    {
+        FLINT_ASSERT(0 <= rows[k] && rows[k] < A->r);
+        FLINT_ASSERT(0 <= cols[k] && cols[k] < A->c);
+        pos[rows[k] + 1]++;
+    }
+
+    for (i = 0; i < A->r; i++)
+        pos[i + 1] += pos[i];
+
+    for (k = 0; k < nnz; k++)
+    {
+        slong j = pos[rows[k]]++;
+        T[j].col = cols[k];
+        NMOD_RED(T[j].val, vals[k], A->mod);
+    }
+
+    /* pos[i] is now the end of row i */
+    nmod_sparse_mat_fit_length(A, nnz);
+
+    len = 0;
+    start = 0;
+    for (i = 0; i < A->r; i++)
+    {
+        A->row_starts[i] = len;
+        end = pos[i];
+
+        qsort(T + start, end - start, sizeof(_entry_struct), _entry_cmp);
+
+        for (k = start; k < end; k++)
+        {
+            if (len > A->row_starts[i] && A->cols[len - 1] == T[k].col)
+            {
+                A->entries[len - 1] = nmod_add(A->entries[len - 1],
+                                                          T[k].val, A->mod);
+                len -= (A->entries[len - 1] == 0);
+            }
+            else if (T[k].val != 0)
+            {
+                A->cols[len] = T[k].col;
+                A->entries[len] = T[k].val;
+                len++;
+            }
+        }
+
+        start = end;
+    }
+    A->row_starts[A->r] = len;
+
+    flint_free(T);
+    flint_free(pos);
+}
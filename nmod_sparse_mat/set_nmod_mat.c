@@ -0,0 +1,50 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_set_nmod_mat(nmod_sparse_mat_t A, const nmod_mat_t B)
+{
+    slong i, j, len;
+
+    if (A->r != B->r)
+    {
+        A->row_starts = (slong *) flint_realloc(A->row_starts,
+                                                    (B->r + 1)*sizeof(slong));
+        A->r = B->r;
+    }
+
+    A->c = B->c;
+    A->mod = B->mod;
+
+    len = 0;
+    for (i = 0; i < B->r; i++)
+        for (j = 0; j < B->c; j++)
+            len += (nmod_mat_entry(B, i, j) != 0);
+
+    nmod_sparse_mat_fit_length(A, len);
+
+    len = 0;
+    for (i = 0; i < B->r; i++)
+    {
+        A->row_starts[i] = len;
+
+        for (j = 0; j < B->c; j++)
+        {
+            if (nmod_mat_entry(B, i, j) != 0)
+            {
+                A->cols[len] = j;
+                A->entries[len] = nmod_mat_entry(B, i, j);
+                len++;
+            }
+        }
+    }
+    A->row_starts[B->r] = len;
+}
@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+/*
+    Solutions of A*x = b correspond to kernel vectors of [A | -b] with last
+    coordinate 1. These are found in the span of the generalized kernel of
+    the Wiedemann operator attached to [A | -b], which handles singular and
+    rectangular systems alike.
+*/
+int nmod_sparse_mat_solve_block_wiedemann(mp_ptr x, const nmod_sparse_mat_t A,
+                     mp_srcptr b, slong block_size, flint_rand_t state)
+{
+    slong i, j, k, n = A->c;
+    int success = 0;
+    nmod_sparse_mat_t Ab;
+    nmod_mat_t X;
+    mp_limb_t d;
+
+    if (_nmod_vec_is_zero(b, A->r))
+    {
+        _nmod_vec_zero(x, n);
+        return 1;
+    }
+
+    /* Ab = [A | -b] */
+    nmod_sparse_mat_init(Ab, A->r, n + 1, A->mod.n);
+    nmod_sparse_mat_fit_length(Ab, nmod_sparse_mat_nnz(A) + A->r);
+
+    k = 0;
+    for (i = 0; i < A->r; i++)
+    {
+        Ab->row_starts[i] = k;
+        for (j = A->row_starts[i]; j < A->row_starts[i + 1]; j++)
+        {
+            Ab->entries[k] = A->entries[j];
+            Ab->cols[k] = A->cols[j];
+            k++;
+        }
+
+        if (b[i] != 0)
+        {
+            Ab->entries[k] = nmod_neg(b[i], A->mod);
+            Ab->cols[k] = n;
+            k++;
+        }
+    }
+    Ab->row_starts[A->r] = k;
+
+    nmod_mat_init(X, n + 1, 0, A->mod.n);
+    _nmod_sparse_mat_nullspace_block_wiedemann(X, Ab, block_size, 4, 1, state);
+
+    for (j = 0; j < X->c; j++)
+    {
+        d = nmod_mat_entry(X, n, j);
+
+        if (d != 0)
+        {
+            d = nmod_inv(d, A->mod);
+            for (i = 0; i < n; i++)
+                x[i] = nmod_mul(nmod_mat_entry(X, i, j), d, A->mod);
+            success = 1;
+            break;
+        }
+    }
+
+    nmod_mat_clear(X);
+    nmod_sparse_mat_clear(Ab);
+
+    return success;
+}
@@ -0,0 +1,67 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+int nmod_sparse_mat_solve_rref(mp_ptr x, const nmod_sparse_mat_t A,
+                                                                 mp_srcptr b)
+{
+    slong i, k, len, rank;
+    slong * pivots;
+    int success;
+    nmod_sparse_mat_t B;
+
+    /* B = [A | b] */
+    nmod_sparse_mat_init(B, A->r, A->c + 1, A->mod.n);
+    nmod_sparse_mat_fit_length(B, nmod_sparse_mat_nnz(A) + A->r);
+
+    len = 0;
+    for (i = 0; i < A->r; i++)
+    {
+        B->row_starts[i] = len;
+        for (k = A->row_starts[i]; k < A->row_starts[i + 1]; k++)
+        {
+            B->cols[len] = A->cols[k];
+            B->entries[len] = A->entries[k];
+            len++;
+        }
+
+        if (b[i] != 0)
+        {
+            B->cols[len] = A->c;
+            B->entries[len] = b[i];
+            len++;
+        }
+    }
+    B->row_starts[A->r] = len;
+
+    pivots = (slong *) flint_malloc((A->r + 1)*sizeof(slong));
+    rank = _nmod_sparse_mat_rref(B, pivots, A->c);
+
+    /* a nonzero row beyond the pivot rows reads 0 = nonzero */
+    success = (rank == A->r) || (nmod_sparse_mat_row_length(B, rank) == 0);
+
+    if (success)
+    {
+        _nmod_vec_zero(x, A->c);
+
+        for (i = 0; i < rank; i++)
+        {
+            k = B->row_starts[i + 1] - 1;
+            if (k >= B->row_starts[i] && B->cols[k] == A->c)
+                x[pivots[i]] = B->entries[k];
+        }
+    }
+
+    flint_free(pivots);
+    nmod_sparse_mat_clear(B);
+
+    return success;
+}
@@ -0,0 +1,110 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+/*
+    Let B be the square operator attached to A and c the matching right hand
+    side (b padded with zeros if A is wide and A^T*b if A is tall). If B is
+    nonsingular, the minimal polynomial f of the sequence u.B^i.c satisfies
+    f(0) != 0 and x = -f(0)^-1 ((f(z) - f(0))/z)(B)*c solves B*x = c.
+    Otherwise we fall back to the kernel of [A | -b], computed by the block
+    algorithm with block size one.
+*/
+int nmod_sparse_mat_solve_wiedemann(mp_ptr x, const nmod_sparse_mat_t A,
+                                          mp_srcptr b, flint_rand_t state)
+{
+    slong i, iter, n = A->c;
+    int success = 0, nlimbs;
+    mp_ptr c, u, w, z, t;
+    _nmod_sparse_mat_op_t B;
+    nmod_berlekamp_massey_t BM;
+    nmod_t mod = A->mod;
+
+    if (_nmod_vec_is_zero(b, A->r))
+    {
+        _nmod_vec_zero(x, n);
+        return 1;
+    }
+
+    if (n == 0)
+        return 0;
+
+    _nmod_sparse_mat_op_init(B, A);
+    nmod_berlekamp_massey_init(BM, mod.n);
+    c = _nmod_vec_init(n);
+    u = _nmod_vec_init(n);
+    w = _nmod_vec_init(n);
+    z = _nmod_vec_init(n);
+    t = _nmod_vec_init(A->r);
+    nlimbs = _nmod_vec_dot_bound_limbs(n, mod);
+
+    if (A->r > n)
+    {
+        nmod_sparse_mat_mul_vec(c, B->AT, b);
+    }
+    else
+    {
+        _nmod_vec_set(c, b, A->r);
+        _nmod_vec_zero(c + A->r, n - A->r);
+    }
+
+    for (iter = 0; iter < 2 && !success; iter++)
+    {
+        const nmod_poly_struct * f;
+        mp_limb_t f0;
+
+        for (i = 0; i < n; i++)
+            u[i] = n_randint(state, mod.n);
+
+        nmod_berlekamp_massey_start_over(BM);
+        _nmod_vec_set(w, c, n);
+        for (i = 0; i < 2*n + NMOD_SPARSE_MAT_WIEDEMANN_EXTRA; i++)
+        {
+            nmod_berlekamp_massey_add_point(BM,
+                                         _nmod_vec_dot(u, w, n, mod, nlimbs));
+            _nmod_sparse_mat_op_apply(z, B, w);
+            _nmod_vec_set(w, z, n);
+        }
+
+        nmod_berlekamp_massey_reduce(BM);
+        f = nmod_berlekamp_massey_V_poly(BM);
+
+        if (f->length < 2 || f->coeffs[0] == 0)
+            continue;
+
+        _nmod_vec_zero(x, n);
+        for (i = f->length - 1; i >= 1; i--)
+        {
+            _nmod_sparse_mat_op_apply(z, B, x);
+            _nmod_vec_scalar_addmul_nmod(z, c, n, f->coeffs[i], mod);
+            _nmod_vec_set(x, z, n);
+        }
+
+        f0 = nmod_neg(nmod_inv(f->coeffs[0], mod), mod);
+        _nmod_vec_scalar_mul_nmod(x, x, n, f0, mod);
+
+        nmod_sparse_mat_mul_vec(t, A, x);
+        success = _nmod_vec_equal(t, b, A->r);
+    }
+
+    if (!success)
+        success = nmod_sparse_mat_solve_block_wiedemann(x, A, b, 1, state);
+
+    nmod_berlekamp_massey_clear(BM);
+    _nmod_vec_clear(c);
+    _nmod_vec_clear(u);
+    _nmod_vec_clear(w);
+    _nmod_vec_clear(z);
+    _nmod_vec_clear(t);
+    _nmod_sparse_mat_op_clear(B);
+
+    return success;
+}
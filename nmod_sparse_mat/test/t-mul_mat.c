@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_mat....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 500 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D, X, Y1, Y2;
+        slong m, n, k;
+        mp_limb_t mod;
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        m = n_randint(state, 100);
+        n = n_randint(state, 100);
+        k = n_randint(state, 10);
+        mod = n_randtest_not_zero(state);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+        nmod_mat_init(X, n, k, mod);
+        nmod_mat_init(Y1, m, k, mod);
+        nmod_mat_init(Y2, m, k, mod);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 50));
+        nmod_sparse_mat_get_nmod_mat(D, A);
+        nmod_mat_randtest(X, state);
+
+        nmod_mat_mul(Y1, D, X);
+        nmod_sparse_mat_mul_mat_threaded(Y2, A, X, n_randint(state, 5) + 1);
+
+        if (!nmod_mat_equal(Y1, Y2))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check threaded product\n");
+            abort();
+        }
+
+        nmod_mat_zero(Y2);
+        nmod_sparse_mat_mul_mat(Y2, A, X);
+
+        if (!nmod_mat_equal(Y1, Y2))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check product\n");
+            abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        nmod_mat_clear(X);
+        nmod_mat_clear(Y1);
+        nmod_mat_clear(Y2);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
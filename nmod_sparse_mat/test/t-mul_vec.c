@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_vec....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D, X, Y1, Y2;
+        slong i, m, n;
+        mp_limb_t mod;
+        mp_ptr x, y;
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        m = n_randint(state, 200);
+        n = n_randint(state, 200);
+        mod = n_randtest_not_zero(state);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+        nmod_mat_init(X, n, 1, mod);
+        nmod_mat_init(Y1, m, 1, mod);
+        nmod_mat_init(Y2, m, 1, mod);
+        x = _nmod_vec_init(n);
+        y = _nmod_vec_init(m);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 100));
+        nmod_sparse_mat_get_nmod_mat(D, A);
+        nmod_mat_randtest(X, state);
+
+        for (i = 0; i < n; i++)
+            x[i] = nmod_mat_entry(X, i, 0);
+
+        nmod_sparse_mat_mul_vec_threaded(y, A, x, n_randint(state, 5) + 1);
+        nmod_mat_mul(Y1, D, X);
+
+        for (i = 0; i < m; i++)
+            nmod_mat_entry(Y2, i, 0) = y[i];
+
+        if (!nmod_mat_equal(Y1, Y2))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check threaded product\n");
+            abort();
+        }
+
+        nmod_sparse_mat_mul_vec(y, A, x);
+
+        for (i = 0; i < m; i++)
+            nmod_mat_entry(Y2, i, 0) = y[i];
+
+        if (!nmod_mat_equal(Y1, Y2))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check product\n");
+            abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        nmod_mat_clear(X);
+        nmod_mat_clear(Y1);
+        nmod_mat_clear(Y2);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(y);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
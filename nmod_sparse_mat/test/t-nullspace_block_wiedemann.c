@@ -0,0 +1,73 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("nullspace_block_wiedemann....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 100 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D, X, Y;
+        slong m, n, rank, nullity;
+        mp_limb_t mod;
+
+        m = n_randint(state, 30);
+        n = n_randint(state, 30);
+        mod = n_randprime(state, 20 + n_randint(state, FLINT_BITS - 20), 1);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+        nmod_mat_init(X, 0, 0, mod);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 5));
+        nmod_sparse_mat_get_nmod_mat(D, A);
+        rank = nmod_mat_rank(D);
+
+        nullity = nmod_sparse_mat_nullspace_block_wiedemann(X, A,
+                                            n_randint(state, 6) + 1, 5, state);
+
+        if (nullity + rank != n || nmod_mat_rank(X) != nullity)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("nullity + rank != n\n");
+            abort();
+        }
+
+        nmod_mat_init(Y, m, nullity, mod);
+        nmod_sparse_mat_mul_mat(Y, A, X);
+
+        if (!nmod_mat_is_zero(Y))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("A * X != 0\n");
+            abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        nmod_mat_clear(X);
+        nmod_mat_clear(Y);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
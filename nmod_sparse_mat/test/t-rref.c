@@ -0,0 +1,115 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("rref....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A, B;
+        nmod_mat_t D, E;
+        slong i, j, m, n, rank1, rank2;
+        slong * pivots;
+        mp_limb_t mod;
+
+        m = n_randint(state, 40);
+        n = n_randint(state, 40);
+        mod = n_randtest_prime(state, 0);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_sparse_mat_init(B, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+        nmod_mat_init(E, m, n, mod);
+        pivots = (slong *) flint_malloc((m + 1)*sizeof(slong));
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 5));
+        nmod_sparse_mat_set(B, A);
+        nmod_sparse_mat_get_nmod_mat(D, A);
+
+        rank1 = nmod_mat_rank(D);
+        rank2 = nmod_sparse_mat_rref(B, pivots);
+
+        if (rank1 != rank2 || nmod_sparse_mat_rank(A) != rank1
+                           || !nmod_sparse_mat_is_canonical(B))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("rank mismatch: %wd %wd\n", rank1, rank2);
+            abort();
+        }
+
+        /* pivot rows, sorted by pivot, unit at the pivot, zero elsewhere */
+        for (i = 0; i < rank2; i++)
+        {
+            if ((i > 0 && pivots[i] <= pivots[i - 1])
+                  || nmod_sparse_mat_get_entry(B, i, pivots[i]) != 1)
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("bad pivot row %wd\n", i);
+                abort();
+            }
+
+            for (j = 0; j < m; j++)
+            {
+                if (j != i && nmod_sparse_mat_get_entry(B, j, pivots[i]) != 0)
+                {
+                    flint_printf("FAIL:\n");
+                    flint_printf("pivot column %wd not cleared\n", pivots[i]);
+                    abort();
+                }
+            }
+        }
+
+        for (i = rank2; i < m; i++)
+        {
+            if (nmod_sparse_mat_row_length(B, i) != 0)
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("nonzero row beyond the rank\n");
+                abort();
+            }
+        }
+
+        /* same row space: the stacked matrix does not grow in rank */
+        {
+            nmod_mat_t S;
+            nmod_mat_init(S, 2*m, n, mod);
+            nmod_sparse_mat_get_nmod_mat(E, B);
+            nmod_mat_concat_vertical(S, D, E);
+            if (nmod_mat_rank(S) != rank1)
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("row space changed\n");
+                abort();
+            }
+            nmod_mat_clear(S);
+        }
+
+        flint_free(pivots);
+        nmod_sparse_mat_clear(A);
+        nmod_sparse_mat_clear(B);
+        nmod_mat_clear(D);
+        nmod_mat_clear(E);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("set_entries....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A, B;
+        nmod_mat_t D, E;
+        slong i, m, n, nnz;
+        slong * rows, * cols;
+        mp_limb_t * vals, mod, t;
+
+        m = n_randint(state, 20);
+        n = n_randint(state, 20);
+        nnz = n_randint(state, 2*m*n + 1);
+        mod = n_randtest_not_zero(state);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_sparse_mat_init(B, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+        nmod_mat_init(E, m, n, mod);
+
+        rows = (slong *) flint_malloc((nnz + 1)*sizeof(slong));
+        cols = (slong *) flint_malloc((nnz + 1)*sizeof(slong));
+        vals = (mp_limb_t *) flint_malloc((nnz + 1)*sizeof(mp_limb_t));
+
+        for (i = 0; i < nnz; i++)
+        {
+            rows[i] = n_randint(state, m);
+            cols[i] = n_randint(state, n);
+            vals[i] = n_randtest(state);
+            NMOD_RED(t, vals[i], A->mod);
+            nmod_mat_entry(D, rows[i], cols[i]) =
+                    nmod_add(nmod_mat_entry(D, rows[i], cols[i]), t, A->mod);
+        }
+
+        nmod_sparse_mat_set_entries(A, rows, cols, vals, nnz);
+        nmod_sparse_mat_get_nmod_mat(E, A);
+
+        if (!nmod_sparse_mat_is_canonical(A) || !nmod_mat_equal(D, E))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check set_entries\n");
+            nmod_mat_print_pretty(D);
+            nmod_sparse_mat_print_pretty(A);
+            abort();
+        }
+
+        nmod_sparse_mat_set_nmod_mat(B, D);
+
+        if (!nmod_sparse_mat_is_canonical(B) || !nmod_sparse_mat_equal(A, B))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check set_nmod_mat\n");
+            nmod_sparse_mat_print_pretty(A);
+            nmod_sparse_mat_print_pretty(B);
+            abort();
+        }
+
+        for (i = 0; i < 10 && m > 0 && n > 0; i++)
+        {
+            slong r = n_randint(state, m), c = n_randint(state, n);
+
+            if (nmod_sparse_mat_get_entry(A, r, c) != nmod_mat_entry(D, r, c))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("check get_entry\n");
+                abort();
+            }
+        }
+
+        flint_free(rows);
+        flint_free(cols);
+        flint_free(vals);
+        nmod_sparse_mat_clear(A);
+        nmod_sparse_mat_clear(B);
+        nmod_mat_clear(D);
+        nmod_mat_clear(E);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
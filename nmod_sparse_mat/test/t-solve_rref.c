@@ -0,0 +1,83 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("solve_rref....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        slong m, n;
+        mp_limb_t mod;
+        mp_ptr x, x0, b, c;
+        int consistent;
+
+        m = n_randint(state, 40);
+        n = n_randint(state, 40);
+        mod = n_randtest_prime(state, 0);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        x = _nmod_vec_init(n);
+        x0 = _nmod_vec_init(n);
+        b = _nmod_vec_init(m);
+        c = _nmod_vec_init(m);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 5));
+
+        consistent = n_randint(state, 2);
+        if (consistent)
+        {
+            _nmod_vec_randtest(x0, state, n, A->mod);
+            nmod_sparse_mat_mul_vec(b, A, x0);
+        }
+        else
+        {
+            _nmod_vec_randtest(b, state, m, A->mod);
+        }
+
+        if (nmod_sparse_mat_solve_rref(x, A, b))
+        {
+            nmod_sparse_mat_mul_vec(c, A, x);
+            if (!_nmod_vec_equal(b, c, m))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("A * x != b\n");
+                abort();
+            }
+        }
+        else if (consistent)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("consistent system reported inconsistent\n");
+            abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(x0);
+        _nmod_vec_clear(b);
+        _nmod_vec_clear(c);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
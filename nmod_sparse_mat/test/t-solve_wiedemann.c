@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("solve_wiedemann....");
+    fflush(stdout);
+
+    /* consistent systems */
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        slong m, n;
+        mp_limb_t mod;
+        mp_ptr x, x0, b, c;
+
+        m = n_randint(state, 40);
+        n = n_randint(state, 40);
+        if (n_randint(state, 2))
+            m = n;
+        mod = n_randprime(state, 10 + n_randint(state, FLINT_BITS - 10), 1);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        x = _nmod_vec_init(n);
+        x0 = _nmod_vec_init(n);
+        b = _nmod_vec_init(m);
+        c = _nmod_vec_init(m);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 6));
+        _nmod_vec_randtest(x0, state, n, A->mod);
+        nmod_sparse_mat_mul_vec(b, A, x0);
+
+        if (!nmod_sparse_mat_solve_wiedemann(x, A, b, state))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("solving failed\n");
+            nmod_sparse_mat_print_pretty(A);
+            abort();
+        }
+
+        nmod_sparse_mat_mul_vec(c, A, x);
+        if (!_nmod_vec_equal(b, c, m))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("A * x != b\n");
+            abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(x0);
+        _nmod_vec_clear(b);
+        _nmod_vec_clear(c);
+    }
+
+    /* nullvectors of matrices with nontrivial kernel */
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D;
+        slong m, n;
+        mp_limb_t mod;
+        mp_ptr x, c;
+
+        m = n_randint(state, 40);
+        n = n_randint(state, 40) + 1;
+        mod = n_randprime(state, 10 + n_randint(state, FLINT_BITS - 10), 1);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+        x = _nmod_vec_init(n);
+        c = _nmod_vec_init(m);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 6));
+        nmod_sparse_mat_get_nmod_mat(D, A);
+
+        if (nmod_mat_rank(D) < n)
+        {
+            if (!nmod_sparse_mat_nullvector_wiedemann(x, A, state))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("no nullvector found\n");
+                nmod_sparse_mat_print_pretty(A);
+                abort();
+            }
+
+            nmod_sparse_mat_mul_vec(c, A, x);
+            if (_nmod_vec_is_zero(x, n) || !_nmod_vec_is_zero(c, m))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("bad nullvector\n");
+                abort();
+            }
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(c);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("transpose....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A, B, C;
+        nmod_mat_t D, DT, E;
+        slong m, n;
+        mp_limb_t mod;
+
+        m = n_randint(state, 30);
+        n = n_randint(state, 30);
+        mod = n_randtest_not_zero(state);
+
+        nmod_sparse_mat_init(A, m, n, mod);
+        nmod_sparse_mat_init(B, 0, 0, mod);
+        nmod_sparse_mat_init(C, 0, 0, mod);
+        nmod_mat_init(D, m, n, mod);
+        nmod_mat_init(DT, n, m, mod);
+        nmod_mat_init(E, n, m, mod);
+
+        nmod_sparse_mat_randtest(A, state, 0, n_randint(state, 6));
+        nmod_sparse_mat_transpose(B, A);
+        nmod_sparse_mat_get_nmod_mat(D, A);
+        nmod_mat_transpose(DT, D);
+        nmod_sparse_mat_get_nmod_mat(E, B);
+
+        if (!nmod_sparse_mat_is_canonical(B) || !nmod_mat_equal(DT, E))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check transpose\n");
+            abort();
+        }
+
+        nmod_sparse_mat_set(C, A);
+        nmod_sparse_mat_transpose(C, C);
+        nmod_sparse_mat_transpose(C, C);
+
+        if (!nmod_sparse_mat_equal(A, C))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("check aliasing\n");
+            abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_sparse_mat_clear(B);
+        nmod_sparse_mat_clear(C);
+        nmod_mat_clear(D);
+        nmod_mat_clear(DT);
+        nmod_mat_clear(E);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
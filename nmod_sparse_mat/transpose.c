@@ -0,0 +1,66 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_transpose(nmod_sparse_mat_t B, const nmod_sparse_mat_t A)
+{
+    slong i, k, nnz;
+    slong * pos;
+    nmod_sparse_mat_t T;
+
+    if (B == A)
+    {
+        nmod_sparse_mat_init(T, A->c, A->r, A->mod.n);
+        nmod_sparse_mat_transpose(T, A);
+        nmod_sparse_mat_swap(B, T);
+        nmod_sparse_mat_clear(T);
+        return;
+    }
+
+    if (B->r != A->c)
+    {
+        B->row_starts = (slong *) flint_realloc(B->row_starts,
+                                                    (A->c + 1)*sizeof(slong));
+        B->r = A->c;
+    }
+
+    B->c = A->r;
+    B->mod = A->mod;
+
+    nnz = nmod_sparse_mat_nnz(A);
+    nmod_sparse_mat_fit_length(B, nnz);
+
+    /* counting sort by column; rows of A are visited in order */
+    for (i = 0; i <= B->r; i++)
+        B->row_starts[i] = 0;
+
+    for (k = 0; k < nnz; k++)
+        B->row_starts[A->cols[k] + 1]++;
+
+    for (i = 0; i < B->r; i++)
+        B->row_starts[i + 1] += B->row_starts[i];
+
+    pos = (slong *) flint_malloc(FLINT_MAX(B->r, 1)*sizeof(slong));
+    for (i = 0; i < B->r; i++)
+        pos[i] = B->row_starts[i];
+
+    for (i = 0; i < A->r; i++)
+    {
+        for (k = A->row_starts[i]; k < A->row_starts[i + 1]; k++)
+        {
+            slong j = pos[A->cols[k]]++;
+            B->cols[j] = i;
+            B->entries[j] = A->entries[k];
+        }
+    }
+
+    flint_free(pos);
+}
@@ -0,0 +1,20 @@
+/*
+    Copyright (C) 2020 The FLINT developers
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <http://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_sparse_mat.h"
+
+void nmod_sparse_mat_zero(nmod_sparse_mat_t A)
+{
+    slong i;
+
+    for (i = 0; i <= A->r; i++)
+        A->row_starts[i] = 0;
+}